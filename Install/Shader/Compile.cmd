@@ -1,15 +1,24 @@
 : StaticMesh Culling Shader.
 %~dp0/../Tool/glslc.exe -fshader-stage=comp --target-env=vulkan1.3 Source/StaticMeshCulling.glsl -O -o Spirv/StaticMeshCulling.comp.spv
+%~dp0/../Tool/glslc.exe -fshader-stage=comp --target-env=vulkan1.3 -DINSTANCED_DRAW Source/StaticMeshCulling.glsl -O -o Spirv/StaticMeshInstanceCulling.comp.spv
 
 : StaticMesh GBuffer Vertex Shader.
 %~dp0/../Tool/glslc.exe -fshader-stage=vert --target-env=vulkan1.3 -DVERTEX_SHADER Source/StaticMeshGBuffer.glsl -O -o Spirv/StaticMeshGBuffer.vert.spv
+%~dp0/../Tool/glslc.exe -fshader-stage=vert --target-env=vulkan1.3 -DVERTEX_SHADER -DINSTANCED_DRAW Source/StaticMeshGBuffer.glsl -O -o Spirv/StaticMeshGBufferInstanced.vert.spv
 
 : StaticMesh GBuffer Pixel Shader.
 %~dp0/../Tool/glslc.exe -fshader-stage=frag --target-env=vulkan1.3 -DPIXEL_SHADER Source/StaticMeshGBuffer.glsl -O -o Spirv/StaticMeshGBuffer.frag.spv
 
+: Landscape GBuffer Shader.
+%~dp0/../Tool/glslc.exe -fshader-stage=vert --target-env=vulkan1.3 -DVERTEX_SHADER Source/Landscape.glsl -O -o Spirv/Landscape.vert.spv
+%~dp0/../Tool/glslc.exe -fshader-stage=frag --target-env=vulkan1.3 -DPIXEL_SHADER Source/Landscape.glsl -O -o Spirv/Landscape.frag.spv
+
 : Tonemapper Compute Shader.
 %~dp0/../Tool/glslc.exe -fshader-stage=comp --target-env=vulkan1.3 Source/Tonemapper.glsl -O -o Spirv/Tonemapper.comp.spv
 
+: ClusteredLightCulling Compute Shader.
+%~dp0/../Tool/glslc.exe -fshader-stage=comp --target-env=vulkan1.3 Source/ClusteredLightCulling.glsl -O -o Spirv/ClusteredLightCulling.comp.spv
+
 : BasicLighting Compute Shader.
 %~dp0/../Tool/glslc.exe -fshader-stage=comp --target-env=vulkan1.3 Source/BasicLighting.glsl -O -o Spirv/BasicLighting.comp.spv
 
@@ -20,6 +29,7 @@ call CompileIBL.cmd
 
 : Hiz build compute Shader.
 %~dp0/../Tool/glslc.exe -fshader-stage=comp --target-env=vulkan1.3 Source/SceneHizBuild.glsl -O -o Spirv/SceneHizBuild.comp.spv
+%~dp0/../Tool/glslc.exe -fshader-stage=comp --target-env=vulkan1.3 Source/SPDHiz.glsl -O -o Spirv/SPDHiz.comp.spv
 
 : Histogram lum
 %~dp0/../Tool/glslc.exe -fshader-stage=comp --target-env=vulkan1.3 Source/AdaptiveExposureHistogramLumiance.glsl -O -o Spirv/AdaptiveExposureHistogramLumiance.comp.spv
@@ -31,6 +41,7 @@ call CompileGTAO.cmd
 : Bloom build compute shader.
 %~dp0/../Tool/glslc.exe -fshader-stage=comp --target-env=vulkan1.3 Source/BasicBloomDownsample.glsl -O -o Spirv/BasicBloomDownsample.comp.spv
 %~dp0/../Tool/glslc.exe -fshader-stage=comp --target-env=vulkan1.3 Source/BasicBloomUpscale.glsl -O -o Spirv/BasicBloomUpscale.comp.spv
+%~dp0/../Tool/glslc.exe -fshader-stage=comp --target-env=vulkan1.3 Source/SPDBloom.glsl -O -o Spirv/SPDBloom.comp.spv
 
 : Volumetric cloud.
 call CompileVolumetricCloud.cmd
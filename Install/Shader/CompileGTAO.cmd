@@ -1,3 +1,4 @@
 %~dp0/../Tool/glslc.exe -fshader-stage=comp --target-env=vulkan1.3 Source/GTAOEvaluate.glsl -O -o Spirv/GTAOEvaluate.comp.spv
 %~dp0/../Tool/glslc.exe -fshader-stage=comp --target-env=vulkan1.3 Source/GTAOSpatial.glsl -O -o Spirv/GTAOSpatialFilter.comp.spv
-%~dp0/../Tool/glslc.exe -fshader-stage=comp --target-env=vulkan1.3 Source/GTAOTemporal.glsl -O -o Spirv/GTAOTemporalFilter.comp.spv
\ No newline at end of file
+%~dp0/../Tool/glslc.exe -fshader-stage=comp --target-env=vulkan1.3 Source/GTAOTemporal.glsl -O -o Spirv/GTAOTemporalFilter.comp.spv
+%~dp0/../Tool/glslc.exe -fshader-stage=comp --target-env=vulkan1.3 Source/GTAOUpsample.glsl -O -o Spirv/GTAOUpsample.comp.spv
\ No newline at end of file
@@ -3,6 +3,7 @@
 #extension GL_GOOGLE_include_directive : enable
 
 #include "AMD_SSRCommon.glsl"
+#include "DenoiseCommon.glsl"
 
 // AMD SSSR looks good but still pool on performances, current implement it here.
 
@@ -20,6 +21,47 @@ vec3 getIBLContribution(float perceptualRoughness, vec3 specularColor, vec3 spec
     return specular;
 }
 
+// Joint bilateral upsample ssr work result to render resolution.
+// Tap depth and normal fetch from same gbuffer pixel the tap traced.
+vec4 upsampleSSR(vec2 uv, float centerLinearZ, vec3 centerNormal)
+{
+    const ivec2 lowSize = textureSize(inSSRIntersection, 0);
+
+    ivec2 basePos;
+    vec4 bilinearWeights;
+    bilinearFootprint(uv, lowSize, basePos, bilinearWeights);
+
+    vec4 sumResult = vec4(0.0);
+    float sumWeight = 0.0;
+
+    // Fallback to closest depth tap when all tap reject.
+    vec4 closestResult = vec4(0.0);
+    float closestDiff = 3.402823466e+38;
+
+    for(int i = 0; i < 4; i++)
+    {
+        const ivec2 tapPos = clamp(basePos + kBilinearOffsets[i], ivec2(0), lowSize - ivec2(1));
+        const ivec2 tapGbufferCoord = getGbufferCoord(tapPos);
+
+        const vec4 tapResult = texelFetch(inSSRIntersection, tapPos, 0);
+        const float tapLinearZ = linearizeDepth(texelFetch(inDepth, tapGbufferCoord, 0).r, viewData);
+        const vec3 tapNormal = normalize(texelFetch(inGbufferB, tapGbufferCoord, 0).xyz);
+
+        const float weight = bilinearWeights[i] * bilateralUpsampleWeight(centerLinearZ, centerNormal, tapLinearZ, tapNormal);
+        sumResult += tapResult * weight;
+        sumWeight += weight;
+
+        const float diff = abs(tapLinearZ - centerLinearZ);
+        if(diff < closestDiff)
+        {
+            closestDiff = diff;
+            closestResult = tapResult;
+        }
+    }
+
+    return (sumWeight > 1e-4) ? (sumResult / sumWeight) : closestResult;
+}
+
 // Only for reference.
 
 layout (local_size_x = 8, local_size_y = 8) in;
@@ -51,7 +93,15 @@ void main()
     vec3 worldPos = getWorldPos(uv, deviceZ, viewData);
     vec3 v = normalize(viewData.camWorldPos.xyz - worldPos);
     
-    vec4 ssrResult = texelFetch(inSSRIntersection, workPos, 0);
+    vec4 ssrResult;
+    if(SSRPush.resolutionMode == kSSRResolutionFull)
+    {
+        ssrResult = texelFetch(inSSRIntersection, workPos, 0);
+    }
+    else
+    {
+        ssrResult = upsampleSSR(uv, linearizeDepth(deviceZ, viewData), n);
+    }
     ssrResult.xyz =  getIBLContribution(perceptualRoughness, specularColor, ssrResult.xyz, n, v);
 
     vec4 resultColor;
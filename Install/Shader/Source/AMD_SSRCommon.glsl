@@ -130,8 +130,32 @@ layout(push_constant) uniform PushConsts
 
     float roughnessThreshold; // Max roughness stop to reflection sample.
     float temporalVarianceThreshold;
+    uint resolutionMode;
 } SSRPush;
 
+// Same with EScreenSpaceResolution.
+const uint kSSRResolutionFull = 0;
+const uint kSSRResolutionHalf = 1;
+const uint kSSRResolutionCheckerboard = 2;
+
+// Ssr work images follow resolution tier, gbuffer and depth always render resolution.
+// Half: one pixel of each 2x2. Checkerboard: half width, pick pixel alternate by row and frame.
+// Work uv still compute from work pixel center, sample position offset at most half render pixel.
+ivec2 getGbufferCoord(ivec2 workCoord)
+{
+    ivec2 coord = workCoord;
+    if(SSRPush.resolutionMode == kSSRResolutionHalf)
+    {
+        coord = workCoord * 2;
+    }
+    else if(SSRPush.resolutionMode == kSSRResolutionCheckerboard)
+    {
+        coord = ivec2(workCoord.x * 2 + int((uint(workCoord.y) + frameData.frameIndex.x) & 1u), workCoord.y);
+    }
+
+    return clamp(coord, ivec2(0), textureSize(inDepth, 0) - ivec2(1));
+}
+
 bool isGlossyReflection(float roughness) 
 {
     return roughness < SSRPush.roughnessThreshold;
@@ -187,8 +211,9 @@ void addDenoiserTile(uint index, uvec2 tileCoord)
 
 vec3 envIBLReflectionCallback(uvec2 dispatchId, vec2 uv, float roughness)
 {
-    vec3 n = normalize(texelFetch(inGbufferB, ivec2(dispatchId), 0).xyz); 
-    float deviceZ = texelFetch(inDepth, ivec2(dispatchId), 0).r;
+    const ivec2 gbufferCoord = getGbufferCoord(ivec2(dispatchId));
+    vec3 n = normalize(texelFetch(inGbufferB, gbufferCoord, 0).xyz); 
+    float deviceZ = texelFetch(inDepth, gbufferCoord, 0).r;
     vec3 worldPos = getWorldPos(uv, deviceZ, viewData);
     vec3 v = normalize(viewData.camWorldPos.xyz - worldPos);
 
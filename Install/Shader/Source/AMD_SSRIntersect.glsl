@@ -226,15 +226,16 @@ void main()
     const vec2 screenSizeInv = 1.0 / vec2(screenSize);
     const vec2 uv = (rayCoord + 0.5) * screenSizeInv;
 
-    const vec3 worldNormal = normalize(texelFetch(inGbufferB, ivec2(rayCoord), 0).xyz); 
+    const vec3 worldNormal = normalize(texelFetch(inGbufferB, getGbufferCoord(ivec2(rayCoord)), 0).xyz); 
     const float roughness = texelFetch(inSSRExtractRoughness, ivec2(rayCoord), 0).r;
 
+    // Hiz is render resolution, trace and hit validate in render resolution.
     const uvec2 hizSize = textureSize(inHiz, 0);
     const bool bMirrorPlane = isMirrorReflection(roughness);
     const int mostDetailedMip = bMirrorPlane ? 0 : int(SSRPush.mostDetailedMip); 
     const vec2 mipResolution = getHizMipResolution(mostDetailedMip);
 
-    const float z = loadDepth(ivec2(rayCoord), mostDetailedMip);
+    const float z = loadDepth(getGbufferCoord(ivec2(rayCoord)), mostDetailedMip);
     const vec3 screenSpaceUVzStart = vec3(uv, z);
 
     const vec3 viewPos = getViewPos(uv, z, viewData);
@@ -255,7 +256,7 @@ void main()
             screenSpaceUVzStart, 
             screenSpaceUVz, 
             bMirrorPlane, 
-            vec2(screenSize),
+            vec2(hizSize),
             mostDetailedMip,
             kMinTraversalOccupancy,
             kMaxTraversalIterations,
@@ -273,14 +274,14 @@ void main()
     vec3 worldHit = getWorldPos(hit.xy, hit.z, viewData);
     vec3 worldRay = worldHit - worldOrigin;
 
-    float confidence = bValidHit ? validateHit(hit, uv, worldRay, vec2(screenSize), kDepthBufferThickness) : 0;
+    float confidence = bValidHit ? validateHit(hit, uv, worldRay, vec2(hizSize), kDepthBufferThickness) : 0;
     float worldRayLength = max(0, length(worldRay));
 
     vec3 reflectionRadiance = vec3(0);
     if (confidence > 0) 
     {
         // Found an intersection with the depth buffer -> We can lookup the color from lit scene.
-        reflectionRadiance = texelFetch(inHDRSceneColor, ivec2(screenSize * hit.xy), 0).rgb;
+        reflectionRadiance = texelFetch(inHDRSceneColor, ivec2(hizSize * hit.xy), 0).rgb;
     }
 
     vec3 worldSpaceReflectedDir = (viewData.camInvertView * vec4(viewReflectedDir, 0.0)).xyz;
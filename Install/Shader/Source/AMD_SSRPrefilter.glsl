@@ -43,9 +43,10 @@ void loadNeighborhood(
 {
     radiance = texelFetch(inSSRIntersection, coord, 0).xyz;
     variance = texelFetch(inSSRVariance, coord, 0).x;
-    normal = texelFetch(inGbufferB, coord, 0).xyz;
+    const ivec2 gbufferCoord = getGbufferCoord(coord);
+    normal = texelFetch(inGbufferB, gbufferCoord, 0).xyz;
 
-    float deviceZ = texelFetch(inDepth, coord, 0).r;
+    float deviceZ = texelFetch(inDepth, gbufferCoord, 0).r;
     depth = linearizeDepth(deviceZ, viewData);
 }
 
@@ -206,6 +207,6 @@ void main()
     uvec2 remappedGroupThreadId = remap8x8(gl_LocalInvocationIndex);
     uvec2 remappedDispatchThreadId = dispatchGroupId * 8 + remappedGroupThreadId;
 
-    uvec2 screenSize = textureSize(inDepth, 0);
+    uvec2 screenSize = imageSize(SSRPrefilterRadiance);
     prefilter(ivec2(remappedDispatchThreadId), ivec2(remappedGroupThreadId), screenSize);
 }
\ No newline at end of file
@@ -13,7 +13,7 @@ vec3 loadRadiance(ivec2 coords)
 
 float loadDepth(ivec2 coords) 
 {
-    return texelFetch(inDepth, coords, 0).x;
+    return texelFetch(inDepth, getGbufferCoord(coords), 0).x;
 }
 
 float sampleDepthHistory(vec2 uv) 
@@ -23,7 +23,7 @@ float sampleDepthHistory(vec2 uv)
 
 float loadDepthHistory(ivec2 coords) 
 { 
-    return texelFetch(inPrevDepth, coords, 0).x;
+    return texelFetch(inPrevDepth, getGbufferCoord(coords), 0).x;
 }
 
 vec3 sampleRadianceHistory(vec2 uv)
@@ -44,7 +44,7 @@ vec3 sampleWorldSpaceNormalHistory(vec2 uv)
 
 vec3 loadWorldSpaceNormalHistory(ivec2 coords) 
 {
-    return vec3(texelFetch(inPrevGbufferB, coords, 0).rgb); 
+    return vec3(texelFetch(inPrevGbufferB, getGbufferCoord(coords), 0).rgb); 
 }
 
 float sampleVarianceHistory(vec2 uv)
@@ -232,12 +232,12 @@ void pickReprojection(
     Moments localNeighborhood = estimateLocalNeighborhoodInGroup(groupThreadId);
     vec2 uv = vec2(dispatchThreadId.x + 0.5, dispatchThreadId.y + 0.5) / screenSize;
 
-    vec3 normal = texelFetch(inGbufferB, dispatchThreadId, 0).rgb;
+    vec3 normal = texelFetch(inGbufferB, getGbufferCoord(dispatchThreadId), 0).rgb;
 
     vec3 historyNormal;
     float historyLinearDepth;
     {
-        const vec2 motionVector = texelFetch(inGbufferV, dispatchThreadId, 0).rg; 
+        const vec2 motionVector = texelFetch(inGbufferV, getGbufferCoord(dispatchThreadId), 0).rg; 
 
         // Then get surface prev-frame uv.
         const vec2 surfaceReprojectionUV = getSurfaceReprojection(uv, motionVector);
@@ -411,7 +411,7 @@ void reproject(ivec2 dispatchThreadId, ivec2 groupThreadId, uvec2 screenSize, fl
     float numSamples = 0.0;
     float roughness  = float(texelFetch(inSSRExtractRoughness, dispatchThreadId, 0).r);
     
-    vec3 normal = texelFetch(inGbufferB, dispatchThreadId, 0).rgb;
+    vec3 normal = texelFetch(inGbufferB, getGbufferCoord(dispatchThreadId), 0).rgb;
 
     vec4 intersectResult = texelFetch(inSSRIntersection, dispatchThreadId, 0);
     vec3 radiance = vec3(intersectResult.xyz);
@@ -535,6 +535,6 @@ void main()
     uvec2 remappedGroupThreadId = remap8x8(gl_LocalInvocationIndex);
     uvec2 remappedDispatchThreadId = dispatchGroupId * 8 + remappedGroupThreadId;
 
-    uvec2 screenSize = textureSize(inDepth, 0);
+    uvec2 screenSize = imageSize(SSRReprojectedRadiance);
     reproject(ivec2(remappedDispatchThreadId), ivec2(remappedGroupThreadId), screenSize, kTemporalStableReprojectFactor, kTemporalPeriod);
 }
\ No newline at end of file
@@ -219,6 +219,6 @@ void main()
     uvec2 remappedGroupThreadId = remap8x8(gl_LocalInvocationIndex);
     uvec2 remappedDispatchThreadId = dispatchGroupId * 8 + remappedGroupThreadId;
 
-    uvec2 screenSize = textureSize(inDepth, 0);
+    uvec2 screenSize = imageSize(SSRTemporalFilterRadiance);
     resolveTemporal(ivec2(remappedDispatchThreadId), ivec2(remappedGroupThreadId), screenSize, kTemporalStableFactor);
 }
\ No newline at end of file
@@ -26,12 +26,12 @@ void classifyTiles(uvec2 dispatchThreadId, uvec2 groupThreadId, float roughness)
 {
     // Shared tile count clear.
     sharedTileCount = 0;
-    const uvec2 workSize = textureSize(inGbufferS, 0);
+    const uvec2 workSize = imageSize(SSRIntersection);
 
     const uint samplesPerQuad = SSRPush.samplesPerQuad;
 
     const bool bAllInScreen = (dispatchThreadId.x < workSize.x) && (dispatchThreadId.y < workSize.y);
-    const bool bCanReflective = isShadingModelValid(texelFetch(inGbufferA, ivec2(dispatchThreadId), 0).a);
+    const bool bCanReflective = isShadingModelValid(texelFetch(inGbufferA, getGbufferCoord(ivec2(dispatchThreadId)), 0).a);
     const bool bGlossyReflection = isGlossyReflection(roughness);
     const bool bMirrorPlane = isMirrorReflection(roughness);
     const bool bBaseRay = IsBaseRay(dispatchThreadId, samplesPerQuad);
@@ -144,7 +144,7 @@ void main()
     uvec2 dispatchId = groupThreadId + gl_WorkGroupID.xy * 8;
     ivec2 workPos = ivec2(dispatchId);
 
-    float perceptualRoughness = texelFetch(inGbufferS, workPos, 0).g;
+    float perceptualRoughness = texelFetch(inGbufferS, getGbufferCoord(workPos), 0).g;
     classifyTiles(dispatchId, groupThreadId, perceptualRoughness);
 
     // Also store roughness.
@@ -8,6 +8,7 @@
 #include "Common.glsl"
 
 #include "LightingCommon.glsl"
+#include "ClusteredLightCommon.glsl"
 
 layout (set = 0, binding = 0, rgba16f)  uniform image2D hdrSceneColor;
 layout (set = 0, binding = 1)  uniform texture2D inDepth;
@@ -23,6 +24,9 @@ layout (set = 0, binding = 10) uniform textureCube inCubeEnv;
 layout (set = 0, binding = 11) uniform textureCube inCubeGlobalIrradiance;
 layout (set = 0, binding = 12) uniform textureCube inCubeGlobalPrefilter;
 layout (set = 0, binding = 13)  uniform texture2D inGTAO;
+layout (set = 0, binding = 14) readonly buffer SSBOLocalLights { LocalLightInfo localLights[]; };
+layout (set = 0, binding = 15) readonly buffer SSBOClusterLightCounts { uint clusterLightCounts[]; };
+layout (set = 0, binding = 16) readonly buffer SSBOClusterLightIndices { uint clusterLightIndices[]; };
 
 layout (set = 1, binding = 0) uniform UniformView { ViewData viewData; };
 layout (set = 2, binding = 0) uniform UniformFrame { FrameData frameData; };
@@ -32,6 +36,7 @@ layout (set = 2, binding = 0) uniform UniformFrame { FrameData frameData; };
 
 layout(push_constant) uniform PushConsts
 {   
+    ClusterGrid clusterGrid;
     uint directionalLightShadowValid; // 0 is unvalid.
 };
 
@@ -197,8 +202,20 @@ void main()
         directColor += atmosphereTransmittance * shadowFactor * evaluateDirectionalLight(evaluateLight, material, normal, view);
     }
 
-    // Other type light shading.
-    // TODO....
+    // Point and spot light shading, only loop lights in pixel's cluster.
+    if((frameData.pointLightCount + frameData.spotLightCount) > 0 && isShadingModelValid(inGbufferAValue.a))
+    {
+        const uvec3 cluster = getPixelCluster(clusterGrid, uvec2(workPos), linearizeDepth(deviceZ, viewData));
+        const uint clusterIndex = getClusterIndex(clusterGrid, cluster);
+        const uint slotBase = clusterIndex * clusterGrid.maxLightsPerCluster;
+        const uint clusterLightCount = clusterLightCounts[clusterIndex];
+
+        for(uint i = 0; i < clusterLightCount; i ++)
+        {
+            const LocalLightInfo evaluateLight = localLights[clusterLightIndices[slotBase + i]];
+            directColor += evaluateLocalLight(evaluateLight, worldPos, material, normal, view);
+        }
+    }
 
     color += directColor;
 
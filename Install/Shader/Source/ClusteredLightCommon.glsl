@@ -0,0 +1,56 @@
+#ifndef CLUSTERED_LIGHT_COMMON_GLSL
+#define CLUSTERED_LIGHT_COMMON_GLSL
+
+// Froxel clustered local lights.
+// pass #0. assign point and spot lights to cluster light lists. See ClusteredLightCulling.glsl file.
+// pass #1. lighting loop over pixel's cluster lights. See BasicLighting.glsl file.
+//
+// Cpu reference in ClusteredLighting.cpp, keep math sync.
+
+#include "Common.glsl"
+
+// See GPUClusterGrid in Parameters.h
+struct ClusterGrid
+{
+    uint dimX;
+    uint dimY;
+    uint dimZ;
+    uint tileSize;
+
+    float zNear; // first slice begin linear depth.
+    float zFar; // exponential slice end linear depth.
+    float zCameraFar; // last slice extend to camera far.
+    uint maxLightsPerCluster;
+
+    uint width;
+    uint height;
+    uint pad0;
+    uint pad1;
+};
+
+uint getClusterIndex(in const ClusterGrid grid, uvec3 cluster)
+{
+    return cluster.x + grid.dimX * (cluster.y + grid.dimY * cluster.z);
+}
+
+uint getClusterSlice(in const ClusterGrid grid, float linearDepth)
+{
+    float slice = log(max(linearDepth, grid.zNear) / grid.zNear) / log(grid.zFar / grid.zNear) * float(grid.dimZ);
+    return min(uint(slice), grid.dimZ - 1);
+}
+
+float getClusterSliceDepth(in const ClusterGrid grid, uint slice)
+{
+    if(slice >= grid.dimZ)
+    {
+        return grid.zCameraFar;
+    }
+    return grid.zNear * pow(grid.zFar / grid.zNear, float(slice) / float(grid.dimZ));
+}
+
+uvec3 getPixelCluster(in const ClusterGrid grid, uvec2 pixelPos, float linearDepth)
+{
+    return uvec3(pixelPos / grid.tileSize, getClusterSlice(grid, linearDepth));
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,112 @@
+#version 460
+
+#extension GL_GOOGLE_include_directive : enable
+
+// One thread one cluster, group share light bounding sphere batch.
+// Cluster light list keep light index ascending, count clamp to max lights per cluster.
+
+#include "ClusteredLightCommon.glsl"
+
+layout (set = 0, binding = 0) readonly buffer SSBOLocalLights { LocalLightInfo localLights[]; };
+layout (set = 0, binding = 1) writeonly buffer SSBOClusterLightCounts { uint clusterLightCounts[]; };
+layout (set = 0, binding = 2) writeonly buffer SSBOClusterLightIndices { uint clusterLightIndices[]; };
+
+layout (set = 1, binding = 0) uniform UniformView { ViewData viewData; };
+layout (set = 2, binding = 0) uniform UniformFrame { FrameData frameData; };
+
+layout(push_constant) uniform PushConsts
+{
+    ClusterGrid grid;
+};
+
+const uint kThreadCount = 64;
+
+// View space light bounding sphere.
+shared vec4 sharedLightSpheres[kThreadCount];
+
+// View space aabb of cluster, same with ClusteredLighting::getClusterAABB.
+void getClusterAABB(uvec3 cluster, out vec3 aabbMin, out vec3 aabbMax)
+{
+    const vec2 gridSize = vec2(grid.width, grid.height);
+    const vec2 uvMin = vec2(cluster.xy * grid.tileSize) / gridSize;
+    const vec2 uvMax = min(vec2((cluster.xy + 1) * grid.tileSize) / gridSize, vec2(1.0));
+
+    const float depthBegin = getClusterSliceDepth(grid, cluster.z);
+    const float depthEnd = getClusterSliceDepth(grid, cluster.z + 1);
+
+    aabbMin = vec3( 3.402823466e+38);
+    aabbMax = vec3(-3.402823466e+38);
+    for(uint i = 0; i < 4; i ++)
+    {
+        const vec2 uv = vec2(((i & 1) != 0) ? uvMax.x : uvMin.x, ((i & 2) != 0) ? uvMax.y : uvMin.y);
+
+        // Reverse z, device z 1 is near plane.
+        const vec3 ray = getViewPos(uv, 1.0, viewData);
+        const vec3 rayUnit = ray / -ray.z;
+
+        aabbMin = min(aabbMin, min(rayUnit * depthBegin, rayUnit * depthEnd));
+        aabbMax = max(aabbMax, max(rayUnit * depthBegin, rayUnit * depthEnd));
+    }
+}
+
+bool sphereIntersectAABB(vec4 sphere, vec3 aabbMin, vec3 aabbMax)
+{
+    const vec3 d = clamp(sphere.xyz, aabbMin, aabbMax) - sphere.xyz;
+    return dot(d, d) <= sphere.w * sphere.w;
+}
+
+layout(local_size_x = 64) in;
+void main()
+{
+    const uint clusterCount = grid.dimX * grid.dimY * grid.dimZ;
+    const uint clusterIndex = gl_GlobalInvocationID.x;
+
+    // Out of range thread still help batch loading.
+    const bool bValidCluster = clusterIndex < clusterCount;
+
+    vec3 aabbMin = vec3(0.0);
+    vec3 aabbMax = vec3(0.0);
+    if(bValidCluster)
+    {
+        const uvec3 cluster = uvec3(
+            clusterIndex % grid.dimX,
+            (clusterIndex / grid.dimX) % grid.dimY,
+            clusterIndex / (grid.dimX * grid.dimY));
+
+        getClusterAABB(cluster, aabbMin, aabbMax);
+    }
+
+    const uint lightCount = frameData.pointLightCount + frameData.spotLightCount;
+    const uint slotBase = clusterIndex * grid.maxLightsPerCluster;
+
+    uint count = 0;
+    for(uint batch = 0; batch < lightCount; batch += kThreadCount)
+    {
+        const uint loadIndex = batch + gl_LocalInvocationIndex;
+        if(loadIndex < lightCount)
+        {
+            const vec4 sphere = localLights[loadIndex].boundingSphere;
+            sharedLightSpheres[gl_LocalInvocationIndex] = vec4((viewData.camView * vec4(sphere.xyz, 1.0)).xyz, sphere.w);
+        }
+        barrier();
+
+        if(bValidCluster)
+        {
+            const uint batchCount = min(kThreadCount, lightCount - batch);
+            for(uint i = 0; i < batchCount && count < grid.maxLightsPerCluster; i ++)
+            {
+                if(sphereIntersectAABB(sharedLightSpheres[i], aabbMin, aabbMax))
+                {
+                    clusterLightIndices[slotBase + count] = batch + i;
+                    count ++;
+                }
+            }
+        }
+        barrier();
+    }
+
+    if(bValidCluster)
+    {
+        clusterLightCounts[clusterIndex] = count;
+    }
+}
\ No newline at end of file
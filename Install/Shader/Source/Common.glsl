@@ -180,6 +180,27 @@ struct DirectionalLightInfo
     float pad2;
 };
 
+// Point and spot light, see GPULocalLightInfo in Parameters.h
+struct LocalLightInfo
+{
+    vec3  color; // color spec rec 2020.
+    float intensity;
+
+    vec3  position;
+    float range;
+
+    vec3  direction; // spot light forward.
+    uint  type; // 0 is point, 1 is spot.
+
+    // Cone attenuation is saturate(dot(-L, direction) * spotScale + spotOffset), point light scale 0 offset 1.
+    float spotScale;
+    float spotOffset;
+    float pad0;
+    float pad1;
+
+    vec4 boundingSphere; // world space, .w is radius.
+};
+
 struct TonemapperParam
 {
     float tonemapper_P;  // Max brightness.
@@ -1,5 +1,30 @@
 #ifndef DENOISE_COMMON_GLSL
 #define DENOISE_COMMON_GLSL
 
+// Low resolution 2x2 bilinear footprint of full resolution uv.
+const ivec2 kBilinearOffsets[4] = { ivec2(0, 0), ivec2(1, 0), ivec2(0, 1), ivec2(1, 1) };
 
-#endif
\ No newline at end of file
+void bilinearFootprint(vec2 uv, ivec2 lowSize, out ivec2 basePos, out vec4 weights)
+{
+    vec2 lowPos = uv * vec2(lowSize) - 0.5;
+    vec2 floorPos = floor(lowPos);
+    vec2 f = lowPos - floorPos;
+
+    basePos = ivec2(floorPos);
+    weights = vec4((1.0 - f.x) * (1.0 - f.y), f.x * (1.0 - f.y), (1.0 - f.x) * f.y, f.x * f.y);
+}
+
+// Joint bilateral upsample weight of low resolution tap against full resolution center.
+// Depth compare relative linear depth, normal compare cosine power.
+float bilateralUpsampleWeight(float centerLinearZ, vec3 centerNormal, float tapLinearZ, vec3 tapNormal)
+{
+    const float kDepthSigma = 32.0;
+    const float kNormalPower = 8.0;
+
+    float depthWeight = exp(-abs(tapLinearZ - centerLinearZ) / max(centerLinearZ, 1e-4) * kDepthSigma);
+    float normalWeight = pow(clamp(dot(tapNormal, centerNormal), 0.0, 1.0), kNormalPower);
+
+    return depthWeight * normalWeight;
+}
+
+#endif
@@ -39,6 +39,7 @@ layout (set = 0, binding = 12) uniform texture2D inGTAOTemporalHistory; //
 layout (set = 0, binding = 13)  uniform texture2D inGbufferV;
 layout (set = 0, binding = 14)  uniform texture2D inPrevDepth;
 layout (set = 0, binding = 15)  uniform texture2D inPrevGbufferB;
+layout (set = 0, binding = 16, r8) uniform image2D GTAOUpsampleImage; // full resolution result when evaluate at half resolution.
 
 layout (set = 1, binding = 0) uniform UniformView { ViewData viewData; };
 layout (set = 2, binding = 0) uniform UniformFrame { FrameData frameData; };
@@ -54,8 +55,26 @@ layout(push_constant) uniform PushConsts
     float thickness;
     float power;
     float intensity;
+    uint resolutionMode;
 } GTAOPush;
 
+// Same with EScreenSpaceResolution.
+const uint kGTAOResolutionFull = 0;
+const uint kGTAOResolutionHalf = 1;
+const uint kGTAOResolutionCheckerboard = 2;
+
+// Checkerboard evaluate half pixels each frame, pattern flip every frame.
+bool isCheckerboardPixel(ivec2 pos)
+{
+    return ((uint(pos.x + pos.y) + frameData.frameIndex.x) & 1u) == 0u;
+}
+
+// Map half width dispatch pos to full resolution pixel evaluate this frame.
+ivec2 checkerboardPixel(ivec2 pos)
+{
+    return ivec2(pos.x * 2 + int((uint(pos.y) + frameData.frameIndex.x) & 1u), pos.y);
+}
+
 #include "FastMath.glsl"
 
 #endif
\ No newline at end of file
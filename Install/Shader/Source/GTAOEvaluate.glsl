@@ -61,6 +61,12 @@ void main()
     uvec2 dispatchId = groupThreadId + gl_WorkGroupID.xy * 8;
     ivec2 workPos = ivec2(dispatchId);
 
+    // Checkerboard dispatch half width.
+    if(GTAOPush.resolutionMode == kGTAOResolutionCheckerboard)
+    {
+        workPos = checkerboardPixel(workPos);
+    }
+
     if(workPos.x >= gtaoSize.x || workPos.y >= gtaoSize.y)
     {
         return;
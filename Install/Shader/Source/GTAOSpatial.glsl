@@ -19,7 +19,7 @@ const uint kSampleCountY = kThreadCountY + kBorderSize * 2;
 const uint kSampleCount = kSampleCountX * kSampleCountY;
 
 shared float sharedDeviceZ[kSampleCount];
-shared float sharedAo[kSampleCount];
+shared float sharedAo[kSampleCount]; // Negative when checkerboard pixel no evaluate this frame.
 
 vec2 getDeviceZandAO(ivec2 threadIdPos)
 {
@@ -46,8 +46,15 @@ void main()
         ivec2 samplePos = basicSamplePos + ivec2(fillID % kSampleCountX, fillID / kSampleCountX);
         samplePos = clamp(samplePos, ivec2(0), gtaoSize - ivec2(1));
         
-        float deviceZ = texelFetch(inDepth, samplePos, 0).r;
-        float ao = texelFetch(inGTAO, samplePos, 0).r;
+        // Depth may be higher resolution than gtao.
+        const vec2 sampleUV = (vec2(samplePos) + vec2(0.5f)) / vec2(gtaoSize);
+        float deviceZ = textureLod(sampler2D(inDepth, pointClampEdgeSampler), sampleUV, 0.0).r;
+
+        float ao = -1.0;
+        if(GTAOPush.resolutionMode != kGTAOResolutionCheckerboard || isCheckerboardPixel(samplePos))
+        {
+            ao = texelFetch(inGTAO, samplePos, 0).r;
+        }
 
         sharedDeviceZ[fillID] = deviceZ;
         sharedAo[fillID] = ao;
@@ -122,6 +129,10 @@ void main()
         float sumAO = 0;
         float sumWeight = 0;
 
+        // Fallback when all valid samples reject by depth.
+        float sumValidAO = 0;
+        float validCount = 0;
+
         int x, y;
 
         // Get the Z Value to compare against 
@@ -148,6 +159,18 @@ void main()
                     Weight = 1.0f - saturate(SampleZDiff * SpatialFilterWeight);
                 }
 
+                // Checkerboard hole, fill by neighbors.
+                if(SampleZAndAO.y < 0.0)
+                {
+                    Weight = 0.0f;
+                    SampleZAndAO.y = 0.0f;
+                }
+                else
+                {
+                    sumValidAO += SampleZAndAO.y;
+                    validCount += 1.0f;
+                }
+
                 sumAO += SampleZAndAO.y * Weight;
                 sumWeight += Weight;
 
@@ -157,7 +180,7 @@ void main()
         }
 
         // Weight normalize.
-        sumAO /= sumWeight;
+        sumAO = (sumWeight > 0.0) ? (sumAO / sumWeight) : (sumValidAO / max(validCount, 1.0));
         sumAO *= (kPI * 0.5f);
 
         // Style ao.
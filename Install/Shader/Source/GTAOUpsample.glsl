@@ -0,0 +1,71 @@
+#version 460
+
+#extension GL_GOOGLE_include_directive : enable
+
+#include "GTAOCommon.glsl"
+#include "DenoiseCommon.glsl"
+#include "Schedule.glsl"
+
+// Joint bilateral upsample half resolution temporal filter result to full resolution.
+// Low resolution tap depth and normal fetch at tap center, same as evaluate used.
+
+layout (local_size_x = 8, local_size_y = 8) in;
+void main()
+{
+    uvec2 groupThreadId = remap8x8(gl_LocalInvocationIndex);
+    uvec2 dispatchId = groupThreadId + gl_WorkGroupID.xy * 8;
+    ivec2 workPos = ivec2(dispatchId);
+
+    ivec2 workSize = imageSize(GTAOUpsampleImage);
+    if(workPos.x >= workSize.x || workPos.y >= workSize.y)
+    {
+        return;
+    }
+
+    if(!isShadingModelValid(texelFetch(inGbufferA, workPos, 0).a))
+    {
+        imageStore(GTAOUpsampleImage, workPos, vec4(1.0));
+        return;
+    }
+
+    const vec2 uv = (vec2(workPos) + vec2(0.5f)) / vec2(workSize);
+    const float centerLinearZ = linearizeDepth(texelFetch(inDepth, workPos, 0).r, viewData);
+    const vec3 centerNormal = normalize(texelFetch(inGbufferB, workPos, 0).rgb);
+
+    const ivec2 lowSize = textureSize(inGTAOTempFilter, 0);
+
+    ivec2 basePos;
+    vec4 bilinearWeights;
+    bilinearFootprint(uv, lowSize, basePos, bilinearWeights);
+
+    float sumAO = 0.0;
+    float sumWeight = 0.0;
+
+    // Fallback to closest depth tap when all tap reject.
+    float closestAO = 1.0;
+    float closestDiff = 3.402823466e+38;
+
+    for(int i = 0; i < 4; i++)
+    {
+        const ivec2 tapPos = clamp(basePos + kBilinearOffsets[i], ivec2(0), lowSize - ivec2(1));
+        const vec2 tapUV = (vec2(tapPos) + vec2(0.5f)) / vec2(lowSize);
+
+        const float tapAO = texelFetch(inGTAOTempFilter, tapPos, 0).r;
+        const float tapLinearZ = linearizeDepth(textureLod(sampler2D(inHiz, pointClampEdgeSampler), tapUV, 0.0).r, viewData);
+        const vec3 tapNormal = normalize(textureLod(sampler2D(inGbufferB, pointClampEdgeSampler), tapUV, 0.0).rgb);
+
+        const float weight = bilinearWeights[i] * bilateralUpsampleWeight(centerLinearZ, centerNormal, tapLinearZ, tapNormal);
+        sumAO += tapAO * weight;
+        sumWeight += weight;
+
+        const float diff = abs(tapLinearZ - centerLinearZ);
+        if(diff < closestDiff)
+        {
+            closestDiff = diff;
+            closestAO = tapAO;
+        }
+    }
+
+    const float ao = (sumWeight > 1e-4) ? (sumAO / sumWeight) : closestAO;
+    imageStore(GTAOUpsampleImage, workPos, vec4(ao, 0.0, 0.0, 0.0));
+}
@@ -0,0 +1,215 @@
+#version 460
+#extension GL_EXT_nonuniform_qualifier : enable
+#extension GL_GOOGLE_include_directive : enable
+#extension GL_EXT_samplerless_texture_functions : enable
+
+// CDLOD landscape gbuffer, see LandscapeQuadtree.h.
+// Node grid build from gl_VertexIndex, vertex morph to coarser lod grid near lod range end.
+
+#include "Common.glsl"
+#include "ColorSpace.glsl"
+
+struct LandscapeNode
+{
+    vec2 origin;
+    float size;
+    uint lod;
+};
+
+struct LandscapeData
+{
+    vec3 origin;
+    float sampleSpacing;
+
+    vec3 originPrev;
+    float heightScale;
+
+    uint width;
+    uint height;
+    uint tileSize;
+    uint tileCountX;
+
+    uint tileCountY;
+    uint coarseTextureId;
+    uint coarseStep;
+    uint coarseWidth;
+
+    uint coarseHeight;
+    float heightDistance;
+    uint pad0;
+    uint pad1;
+
+    vec4 morphRanges[16];
+};
+
+struct VS2PS
+{
+    vec3 normal;
+    vec3 worldPos;
+    float height01;
+    vec4 posNDCPrevNoJitter;
+    vec4 posNDCCurNoJitter;
+};
+
+layout (set = 0, binding = 0) uniform UniformView{  ViewData viewData; };
+layout (set = 1, binding = 0) uniform UniformFrame{ FrameData frameData; };
+layout (set = 2, binding = 0) uniform UniformLandscape{ LandscapeData landscape; };
+layout (set = 3, binding = 0) readonly buffer SSBONodes{ LandscapeNode nodes[]; }; // Index by gl_InstanceIndex.
+layout (set = 4, binding = 0) readonly buffer SSBOPageTable{ uint pageTable[]; }; // Tile bindless id, ~0 use coarse.
+layout (set = 5, binding = 0) uniform texture2D bindlessTexture2D[];
+
+#ifdef VERTEX_SHADER ///////////// vertex shader start
+
+layout(push_constant) uniform PushConsts
+{
+    uint gridDim;
+};
+
+float loadCoarse(ivec2 coarsePos)
+{
+    coarsePos = clamp(coarsePos, ivec2(0), ivec2(landscape.coarseWidth - 1, landscape.coarseHeight - 1));
+    return texelFetch(bindlessTexture2D[nonuniformEXT(landscape.coarseTextureId)], coarsePos, 0).r;
+}
+
+// Normalized height of one heightfield sample, resident tile first, coarse heightfield fallback.
+float loadSample(ivec2 samplePos)
+{
+    samplePos = clamp(samplePos, ivec2(0), ivec2(landscape.width - 1, landscape.height - 1));
+
+    // Tile store one more sample each side, last sample of tile x is first sample of tile x + 1.
+    const ivec2 tile = min(samplePos / int(landscape.tileSize), ivec2(landscape.tileCountX - 1, landscape.tileCountY - 1));
+    const uint texId = pageTable[uint(tile.y) * landscape.tileCountX + uint(tile.x)];
+    if (texId != ~0u)
+    {
+        return texelFetch(bindlessTexture2D[nonuniformEXT(texId)], samplePos - tile * int(landscape.tileSize), 0).r;
+    }
+
+    // Last coarse sample clamp to heightfield edge, approximate with uniform step.
+    const vec2 coarsePos = vec2(samplePos) / float(landscape.coarseStep);
+    const ivec2 p0 = ivec2(floor(coarsePos));
+    const vec2 f = coarsePos - vec2(p0);
+    return mix(
+        mix(loadCoarse(p0), loadCoarse(p0 + ivec2(1, 0)), f.x),
+        mix(loadCoarse(p0 + ivec2(0, 1)), loadCoarse(p0 + ivec2(1, 1)), f.x), f.y);
+}
+
+// Bilinear height, sample position only fractional when morph.
+float sampleHeight(vec2 samplePos)
+{
+    const ivec2 p0 = ivec2(floor(samplePos));
+    const vec2 f = samplePos - vec2(p0);
+    if (all(equal(f, vec2(0.0))))
+    {
+        return loadSample(p0);
+    }
+
+    return mix(
+        mix(loadSample(p0), loadSample(p0 + ivec2(1, 0)), f.x),
+        mix(loadSample(p0 + ivec2(0, 1)), loadSample(p0 + ivec2(1, 1)), f.x), f.y);
+}
+
+layout(location = 0) out VS2PS vsOut;
+
+void main()
+{
+    const LandscapeNode node = nodes[gl_InstanceIndex];
+
+    // Two ccw triangles per quad view from top.
+    const uvec2 kQuadCorners[6] = uvec2[](uvec2(0, 0), uvec2(0, 1), uvec2(1, 0), uvec2(1, 0), uvec2(0, 1), uvec2(1, 1));
+    const uint quadId = gl_VertexIndex / 6;
+    const uvec2 gridPos = uvec2(quadId % gridDim, quadId / gridDim) + kQuadCorners[gl_VertexIndex % 6];
+
+    // Work in sample space, vertex shared by nodes get exact same position.
+    const float lodStep = float(1u << node.lod);
+    const vec2 nodeSampleOrigin = round((node.origin - landscape.origin.xz) / landscape.sampleSpacing);
+    vec2 samplePos = nodeSampleOrigin + vec2(gridPos) * lodStep;
+
+    // Same view distance with LandscapeQuadtree, xz distance with camera height out of heightfield.
+    const vec2 camDelta = landscape.origin.xz + samplePos * landscape.sampleSpacing - viewData.camWorldPos.xz;
+    const float viewDistance = sqrt(dot(camDelta, camDelta) + landscape.heightDistance * landscape.heightDistance);
+    const vec2 morphRange = landscape.morphRanges[node.lod].xy;
+    const float morphK = clamp((viewDistance - morphRange.x) / max(morphRange.y - morphRange.x, 1e-4f), 0.0, 1.0);
+
+    // Odd vertex slide to even neighbour, full morph match lod + 1 grid.
+    const vec2 morphOffset = fract(vec2(gridPos) * 0.5) * 2.0;
+    samplePos -= morphOffset * lodStep * morphK;
+
+    // Edge node out of heightfield collapse to edge.
+    samplePos = clamp(samplePos, vec2(0.0), vec2(landscape.width - 1, landscape.height - 1));
+
+    const float height01 = sampleHeight(samplePos);
+    const vec3 localPosition = vec3(samplePos.x * landscape.sampleSpacing, height01 * landscape.heightScale, samplePos.y * landscape.sampleSpacing);
+    const vec4 worldPosition = vec4(landscape.origin + localPosition, 1.0);
+
+    // Central difference with lod step.
+    const ivec2 centerPos = ivec2(round(samplePos));
+    const int normalStep = int(lodStep);
+    const float hL = loadSample(centerPos - ivec2(normalStep, 0));
+    const float hR = loadSample(centerPos + ivec2(normalStep, 0));
+    const float hD = loadSample(centerPos - ivec2(0, normalStep));
+    const float hU = loadSample(centerPos + ivec2(0, normalStep));
+    vsOut.normal = normalize(vec3((hL - hR) * landscape.heightScale, 2.0 * lodStep * landscape.sampleSpacing, (hD - hU) * landscape.heightScale));
+
+    vsOut.worldPos = worldPosition.xyz;
+    vsOut.height01 = height01;
+
+    gl_Position = viewData.camViewProj * worldPosition;
+
+    vsOut.posNDCPrevNoJitter = viewData.camViewProjPrevNoJitter * vec4(landscape.originPrev + localPosition, 1.0);
+    vsOut.posNDCCurNoJitter = viewData.camViewProjNoJitter * worldPosition;
+}
+
+#endif /////////////////////////// vertex shader end
+
+#ifdef PIXEL_SHADER ////////////// pixel shader start
+
+layout(location = 0) in VS2PS vsIn;
+
+// Scene hdr color. .rgb store emissive color.
+layout(location = 0) out vec4 outHDRSceneColor;
+
+// GBuffer A: r8g8b8a8 unorm, .rgb store base color, .a is shading model id.
+layout(location = 1) out vec4 outGBufferA;
+
+// GBuffer B: r16g16b16a16 sfloat, .rgb store worldspace normal, .a is mesh id.
+layout(location = 2) out vec4 outGBufferB;
+
+// GBuffer S: r8g8b8a8 unorm, .r is metal, .g is roughness, .b is mesh ao.
+layout(location = 3) out vec4 outGBufferS;
+
+// GBuffer V: r16g16 sfloat, store velocity.
+layout(location = 4) out vec2 outGBufferV;
+
+void main()
+{
+    const vec3 worldNormal = normalize(vsIn.normal);
+
+    // Slope and height base color, grass on flat, rock on steep, snow on top.
+    const vec3 kGrassColor = vec3(0.22, 0.30, 0.12);
+    const vec3 kRockColor  = vec3(0.38, 0.35, 0.32);
+    const vec3 kSnowColor  = vec3(0.90, 0.92, 0.95);
+
+    const float rockWeight = 1.0 - smoothstep(0.55, 0.75, worldNormal.y);
+    const float snowWeight = smoothstep(0.75, 0.85, vsIn.height01) * smoothstep(0.5, 0.8, worldNormal.y);
+    const vec3 baseColor = mix(mix(kGrassColor, kRockColor, rockWeight), kSnowColor, snowWeight);
+
+    outGBufferA.rgb = inputColorPrepare(baseColor);
+    outGBufferA.a = kShadingModelStandardPBR;
+
+    outHDRSceneColor.rgb = vec3(0.0);
+
+    outGBufferB.rgb = worldNormal;
+    outGBufferB.a = 0.0;
+
+    outGBufferS.r = 0.0; // metal
+    outGBufferS.g = mix(0.9, 0.6, snowWeight); // roughness
+    outGBufferS.b = 1.0; // mesh ao
+
+    // Velocity output.
+    outGBufferV = (vsIn.posNDCPrevNoJitter.xy / vsIn.posNDCPrevNoJitter.w) - (vsIn.posNDCCurNoJitter.xy / vsIn.posNDCCurNoJitter.w);
+
+    // Transform motion vector from NDC space to UV space (+Y is top-down).
+    outGBufferV *= vec2(0.5f, -0.5f);
+}
+
+#endif //////////////////////////// pixel shader end
@@ -186,6 +186,35 @@ vec3 evaluateDirectionalLight(DirectionalLightInfo light, PBRMaterial materialIn
     return light.intensity * light.color * shade;
 }
 
+// Inverse square falloff with smooth window to zero at range.
+// Real Shading in Unreal Engine 4, equation (9).
+float getDistanceAttenuation(vec3 unormalizedLightVector, float range)
+{
+    float sqrDist = dot(unormalizedLightVector, unormalizedLightVector);
+    float factor = sqrDist / (range * range);
+    float smoothFactor = saturate(1.0 - factor * factor);
+    return (smoothFactor * smoothFactor) / max(sqrDist, 1e-4);
+}
+
+// Point and spot light direct lighting evaluate.
+vec3 evaluateLocalLight(LocalLightInfo light, vec3 worldPos, PBRMaterial materialInfo, vec3 normal, vec3 view)
+{
+    vec3 pointToLight = light.position - worldPos;
+    float attenuation = getDistanceAttenuation(pointToLight, light.range);
+
+    pointToLight = normalize(pointToLight);
+    float spotAttenuation = saturate(dot(-pointToLight, light.direction) * light.spotScale + light.spotOffset);
+    attenuation *= spotAttenuation * spotAttenuation;
+
+    if(attenuation <= 0.0)
+    {
+        return vec3(0.0);
+    }
+
+    vec3 shade = getPointShade(pointToLight, materialInfo, normal, view);
+    return attenuation * light.intensity * light.color * shade;
+}
+
 float specularAOLagarde(float NoV, float visibility, float roughness) 
 {
     // Lagarde and de Rousiers 2014, "Moving Frostbite to PBR"
@@ -13,6 +13,7 @@ layout (push_constant) uniform PushConsts
 {  
     uint cullCountPercascade;
     uint cascadeCount; 
+    uint objectOffset; // First object id to cull.
 };
 
 void visibileCulling(uint idx, uint cascadeId)
@@ -68,6 +69,6 @@ void main()
         // Object id fetech.
 		uint objectId = idx % cullCountPercascade;
 
-        visibileCulling(objectId, cascadeIndex);
+        visibileCulling(objectId + objectOffset, cascadeIndex);
     }
 }
\ No newline at end of file
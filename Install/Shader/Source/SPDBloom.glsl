@@ -0,0 +1,47 @@
+#version 460
+
+#extension GL_GOOGLE_include_directive : enable
+#extension GL_EXT_samplerless_texture_functions : enable
+
+// Single pass bloom downsample of chain mip 1 and after, box average.
+// Chain mip 0 build by BasicBloomDownsample.glsl with prefilter, 13 tap and karis average.
+
+layout(set = 0, binding = 0) uniform texture2D inputTexture; // Chain mip 0.
+layout(set = 0, binding = 1, rgba16f) uniform image2D hdrDownSamples[5]; // Chain mip 1 to 5.
+
+layout (push_constant) uniform PushConsts
+{
+    uint mips;
+};
+
+#define SPD_TYPE vec3
+#define SPD_MAX_MIPS 5
+
+SPD_TYPE spdLoad(ivec2 pos, uint level)
+{
+    // Bloom chain no more than 6 levels, only load source.
+    const ivec2 srcSize = textureSize(inputTexture, 0);
+    return texelFetch(inputTexture, min(pos, srcSize - 1), 0).rgb;
+}
+
+SPD_TYPE spdReduce4(SPD_TYPE v0, SPD_TYPE v1, SPD_TYPE v2, SPD_TYPE v3, uint level)
+{
+    return (v0 + v1 + v2 + v3) * 0.25;
+}
+
+void spdStore(ivec2 pos, SPD_TYPE v, uint level)
+{
+    // Chain mip 1 is level 1.
+    if(all(lessThan(pos, imageSize(hdrDownSamples[level - 1]))))
+    {
+        imageStore(hdrDownSamples[level - 1], pos, vec4(v, 1.0f));
+    }
+}
+
+#include "SPDCommon.glsl"
+
+layout (local_size_x = 256) in;
+void main()
+{
+    spdDownsample(gl_WorkGroupID.xy, gl_LocalInvocationIndex, mips, 1);
+}
@@ -0,0 +1,141 @@
+#ifndef SPD_COMMON_GLSL
+#define SPD_COMMON_GLSL
+
+// Single pass downsampler, generate up to 12 levels of 2x2 reduction chain in one dispatch.
+// Dispatch one 256 threads workgroup per 64x64 source tile, each workgroup reduce its tile to 6 levels in shared memory.
+// Last finish workgroup (global atomic counter) continue reduce level 6 to remain levels.
+//
+// Level k texel p cover source block [p * 2^k, (p + 1) * 2^k), source load clamp to edge.
+// Mip size floor to half, so texel in range only depend on source texel in range.
+//
+// Include shader must define before include:
+//   SPD_TYPE:     reduce value type.
+//   SPD_MAX_MIPS: max output levels, global atomic path only compile when bigger than 6.
+//   SPD_TYPE spdLoad(ivec2 pos, uint level):  level 0 is source, level 6 for last workgroup.
+//   SPD_TYPE spdReduce4(SPD_TYPE v0, SPD_TYPE v1, SPD_TYPE v2, SPD_TYPE v3, uint level): level is output level.
+//   void spdStore(ivec2 pos, SPD_TYPE v, uint level): need bound check.
+//   uint spdIncreaseAtomicCounter(): only when SPD_MAX_MIPS bigger than 6, return value before increase.
+//
+// Cpu emulation of same schedule see SinglePassDownsample.cpp, keep both in sync.
+
+const uint kSPDTileMips = 6;
+
+shared SPD_TYPE spdIntermediate[16][16];
+shared uint spdCounter;
+
+SPD_TYPE spdReduceIntermediate(uvec2 pos, uint level)
+{
+    return spdReduce4(
+        spdIntermediate[pos.x * 2 + 0][pos.y * 2 + 0],
+        spdIntermediate[pos.x * 2 + 1][pos.y * 2 + 0],
+        spdIntermediate[pos.x * 2 + 0][pos.y * 2 + 1],
+        spdIntermediate[pos.x * 2 + 1][pos.y * 2 + 1],
+        level);
+}
+
+// Reduce one 64x64 tile of base level to level base + 1 ... base + 6.
+void spdDownsampleTile(uvec2 tileId, uint localIndex, uint baseLevel, uint mips)
+{
+    const uint levelCount = min(mips - baseLevel, kSPDTileMips);
+    const uvec2 threadPos = uvec2(localIndex % 16, localIndex / 16);
+
+    // Level base + 1, each thread reduce four 2x2 quad of base level.
+    SPD_TYPE v[4];
+    for(uint i = 0; i < 4; i ++)
+    {
+        const uvec2 pos = threadPos + uvec2(16 * (i & 1), 16 * (i >> 1));
+        const ivec2 srcPos = ivec2(tileId * 64 + pos * 2);
+
+        v[i] = spdReduce4(
+            spdLoad(srcPos + ivec2(0, 0), baseLevel),
+            spdLoad(srcPos + ivec2(1, 0), baseLevel),
+            spdLoad(srcPos + ivec2(0, 1), baseLevel),
+            spdLoad(srcPos + ivec2(1, 1), baseLevel),
+            baseLevel + 1);
+        spdStore(ivec2(tileId * 32 + pos), v[i], baseLevel + 1);
+    }
+
+    if(levelCount <= 1)
+    {
+        return;
+    }
+
+    // Level base + 2, four round of 16x16 to 8x8.
+    const bool bQuarter = all(lessThan(threadPos, uvec2(8)));
+    for(uint i = 0; i < 4; i ++)
+    {
+        spdIntermediate[threadPos.x][threadPos.y] = v[i];
+        barrier();
+
+        if(bQuarter)
+        {
+            v[i] = spdReduceIntermediate(threadPos, baseLevel + 2);
+            spdStore(ivec2(tileId * 16 + threadPos + uvec2(8 * (i & 1), 8 * (i >> 1))), v[i], baseLevel + 2);
+        }
+        barrier();
+    }
+
+    if(bQuarter)
+    {
+        for(uint i = 0; i < 4; i ++)
+        {
+            spdIntermediate[threadPos.x + 8 * (i & 1)][threadPos.y + 8 * (i >> 1)] = v[i];
+        }
+    }
+    barrier();
+
+    // Remain levels all in shared memory.
+    for(uint level = 3; level <= levelCount; level ++)
+    {
+        const uint levelSize = 64 >> level;
+        const uvec2 pos = uvec2(localIndex % levelSize, localIndex / levelSize);
+        const bool bActive = localIndex < levelSize * levelSize;
+
+        SPD_TYPE result;
+        if(bActive)
+        {
+            result = spdReduceIntermediate(pos, baseLevel + level);
+        }
+        barrier();
+
+        if(bActive)
+        {
+            spdIntermediate[pos.x][pos.y] = result;
+            spdStore(ivec2(tileId * levelSize + pos), result, baseLevel + level);
+        }
+        barrier();
+    }
+}
+
+void spdDownsample(uvec2 workGroupId, uint localIndex, uint mips, uint numWorkGroups)
+{
+    spdDownsampleTile(workGroupId, localIndex, 0, mips);
+
+#if SPD_MAX_MIPS > 6
+    if(mips <= kSPDTileMips)
+    {
+        return;
+    }
+
+    // Level 6 visible to other workgroups before count.
+    memoryBarrierImage();
+    memoryBarrierBuffer();
+    barrier();
+
+    if(localIndex == 0)
+    {
+        spdCounter = spdIncreaseAtomicCounter();
+    }
+    barrier();
+
+    if(spdCounter != numWorkGroups - 1)
+    {
+        return;
+    }
+
+    // Last workgroup, level 6 at most 64x64 so one tile.
+    spdDownsampleTile(uvec2(0), localIndex, kSPDTileMips, mips);
+#endif
+}
+
+#endif
@@ -0,0 +1,80 @@
+#version 460
+
+#extension GL_GOOGLE_include_directive : enable
+#extension GL_EXT_samplerless_texture_functions : require
+
+// Single pass hiz build, mip 0 copy from depth, mip 1 ... mips reduce by SPD.
+
+layout(push_constant) uniform PushConsts
+{
+    uint mips; // Output levels, not include mip 0.
+    uint numWorkGroups;
+};
+
+const uint kHizMaxMipCount = 13;
+
+// Level 6 read back by last workgroup, so coherent.
+layout (set = 0, binding = 0, r32f) uniform coherent image2D hizClosestImages[kHizMaxMipCount];
+layout (set = 0, binding = 1, r32f) uniform coherent image2D hizFurthestImages[kHizMaxMipCount];
+layout (set = 0, binding = 2) uniform texture2D inDepth;
+layout (set = 0, binding = 3) coherent buffer SPDCounterSSBO
+{
+    uint counter;
+} ssboSPDCounter;
+
+#define SPD_TYPE vec2 // x is closest, y is furthest.
+#define SPD_MAX_MIPS 12
+
+SPD_TYPE spdLoad(ivec2 pos, uint level)
+{
+    if(level == 0)
+    {
+        const ivec2 depthSize = textureSize(inDepth, 0);
+        const bool bInRange = all(lessThan(pos, depthSize));
+
+        float z = texelFetch(inDepth, min(pos, depthSize - 1), 0).r;
+
+        // Each source texel load once, copy to mip 0 here.
+        if(bInRange)
+        {
+            imageStore(hizClosestImages[0],  pos, vec4(z, 0.0f, 0.0f, 0.0f));
+            imageStore(hizFurthestImages[0], pos, vec4(z, 0.0f, 0.0f, 0.0f));
+        }
+        return vec2(z);
+    }
+
+    const ivec2 levelPos = min(pos, imageSize(hizClosestImages[level]) - 1);
+    return vec2(
+        imageLoad(hizClosestImages[level], levelPos).r,
+        imageLoad(hizFurthestImages[level], levelPos).r);
+}
+
+SPD_TYPE spdReduce4(SPD_TYPE v0, SPD_TYPE v1, SPD_TYPE v2, SPD_TYPE v3, uint level)
+{
+    // Reverse z, so max value is closest and min value is furthest.
+    return vec2(
+        max(max(v0.x, v1.x), max(v2.x, v3.x)),
+        min(min(v0.y, v1.y), min(v2.y, v3.y)));
+}
+
+void spdStore(ivec2 pos, SPD_TYPE v, uint level)
+{
+    if(all(lessThan(pos, imageSize(hizClosestImages[level]))))
+    {
+        imageStore(hizClosestImages[level],  pos, vec4(v.x, 0.0f, 0.0f, 0.0f));
+        imageStore(hizFurthestImages[level], pos, vec4(v.y, 0.0f, 0.0f, 0.0f));
+    }
+}
+
+uint spdIncreaseAtomicCounter()
+{
+    return atomicAdd(ssboSPDCounter.counter, 1);
+}
+
+#include "SPDCommon.glsl"
+
+layout (local_size_x = 256) in;
+void main()
+{
+    spdDownsample(gl_WorkGroupID.xy, gl_LocalInvocationIndex, mips, numWorkGroups);
+}
@@ -72,6 +72,11 @@ struct PerObjectData
     vec3 extents;    
     uint bObjectMove; // object move state, = 1 when modelMatrix != modelMatrixPrev;
 
+    // Lod index ranges, .x is lod0, zero index count lod no exist.
+    uvec4 lodIndexStart;
+    uvec4 lodIndexCount;
+    vec4 lodError; // Lod object space error, .x is lod0 always zero.
+
     StaticMeshStandardPBR material;
 };
 
@@ -110,6 +115,16 @@ struct DrawIndirectCommand
     uint objectId;
 };
 
+// Instance of static mesh instance batch, see StaticMeshInstancing.h.
+struct InstanceData
+{
+    uint objectId; // Object id for PerObjectData array indexing.
+    uint batchId;
+};
+
+// Draw command count per instance batch, one per lod.
+#define kInstanceBatchLodCount 4
+
 DrawIndirectCommand buildDefaultCommand()
 {
     DrawIndirectCommand result;
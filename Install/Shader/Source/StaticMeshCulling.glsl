@@ -6,15 +6,55 @@
 
 layout (set = 0, binding = 0) readonly buffer SSBOPerObject { PerObjectData objectDatas[]; };
 layout (set = 1, binding = 0) buffer SSBOIndirectDraws { DrawIndirectCommand indirectCommands[]; };
+#ifdef INSTANCED_DRAW
+layout (set = 2, binding = 0) writeonly buffer SSBOVisibleInstances{ uint visibleInstances[]; };
+#else
 layout (set = 2, binding = 0) buffer SSBODrawCount{ DrawIndirectCount drawCount; };
+#endif
 layout (set = 3, binding = 0) uniform UniformViewData{ ViewData viewData; };
+#ifdef INSTANCED_DRAW
+layout (set = 4, binding = 0) readonly buffer SSBOInstances{ InstanceData instances[]; };
+#endif
 
 layout (push_constant) uniform PushConsts 
 {  
     uint cullCount; 
+    float lodErrorScale; // Object space error to pixel error scale at unit distance, zero disable lod.
 };
 
-void visibileCulling(uint idx)
+// Select coarsest lod whose projected error no more than one pixel error.
+uint selectLod(PerObjectData objectData, vec3 worldCenter)
+{
+    if(lodErrorScale <= 0.0f)
+    {
+        return 0;
+    }
+
+    // Lod error is object space, scale with max model axis scale.
+    const float maxScale = sqrt(max(max(
+        dot(objectData.modelMatrix[0].xyz, objectData.modelMatrix[0].xyz), 
+        dot(objectData.modelMatrix[1].xyz, objectData.modelMatrix[1].xyz)), 
+        dot(objectData.modelMatrix[2].xyz, objectData.modelMatrix[2].xyz)));
+
+    // Use closest distance of bounding sphere, conservative.
+    const float radius = objectData.sphereBounds.w * maxScale;
+    const float dist = max(distance(worldCenter, viewData.camWorldPos.xyz) - radius, viewData.camInfo.z);
+    const float errorScale = maxScale * lodErrorScale / dist;
+
+    uint lod = 0;
+    for(uint i = 1; i < 4; i++)
+    {
+        if(objectData.lodIndexCount[i] == 0 || objectData.lodError[i] * errorScale > 1.0f)
+        {
+            break;
+        }
+        lod = i;
+    }
+    return lod;
+}
+
+// Return lod when visible, ~0u when culled.
+uint visibileCulling(uint idx)
 {
     PerObjectData objectData = objectDatas[idx];
 
@@ -37,23 +77,58 @@ void visibileCulling(uint idx)
 		float absDiff = dot(abs(localNormal), objectData.extents.xyz);
 		if (castDistance + absDiff + viewData.frustumPlanes[i].w < 0.0)
 		{
-            return; // no visibile
+            return ~0u; // no visibile
 		}
 	}
+
+    return selectLod(objectData, worldPos.xyz);
+}
+
+#ifdef INSTANCED_DRAW
+
+// Command template already fill by cpu, append visible object to command of batch lod.
+void instanceCulling(uint idx)
+{
+    const InstanceData instance = instances[idx];
+
+    const uint lod = visibileCulling(instance.objectId);
+    if(lod == ~0u)
+    {
+        return;
+    }
+
+    const uint drawId = instance.batchId * kInstanceBatchLodCount + lod;
+    const uint slot = atomicAdd(indirectCommands[drawId].instanceCount, 1);
+    visibleInstances[indirectCommands[drawId].firstInstance + slot] = instance.objectId;
+}
+
+#else
+
+void objectCulling(uint idx)
+{
+    const uint lod = visibileCulling(idx);
+    if(lod == ~0u)
+    {
+        return;
+    }
+
+    PerObjectData objectData = objectDatas[idx];
     
     // Build draw command if visible.
     uint drawId = atomicAdd(drawCount.count, 1);
     indirectCommands[drawId].objectId = idx;
 
     // We fetech vertex by index, so vertex count is index count.
-    indirectCommands[drawId].vertexCount = objectData.indexCount;
-    indirectCommands[drawId].firstVertex = objectData.indexStartPosition;
+    indirectCommands[drawId].vertexCount = objectData.lodIndexCount[lod];
+    indirectCommands[drawId].firstVertex = objectData.lodIndexStart[lod];
 
     // We fetch vertex in vertex shader, so instancing is unused when rendering.
     indirectCommands[drawId].instanceCount = 1;
     indirectCommands[drawId].firstInstance = 0; 
 }
 
+#endif
+
 layout (local_size_x = 64) in;
 void main()
 {
@@ -61,6 +136,10 @@ void main()
 
     if(idx < cullCount)
     {
-        visibileCulling(idx);
+    #ifdef INSTANCED_DRAW
+        instanceCulling(idx);
+    #else
+        objectCulling(idx);
+    #endif
     }
 }
\ No newline at end of file
@@ -23,7 +23,12 @@ layout (set = 3, binding = 0) buffer BindlessSSBOIndices{ uint data[]; } indices
 layout (set = 4, binding = 0) uniform texture2D bindlessTexture2D[];
 layout (set = 5, binding = 0) uniform sampler bindlessSampler[];
 layout (set = 6, binding = 0) readonly buffer SSBOPerObject{PerObjectData objectDatas[];};
+#ifdef INSTANCED_DRAW
+layout (set = 7, binding = 0) readonly buffer SSBOVisibleInstances{ uint visibleInstances[]; }; // Index by gl_InstanceIndex.
+#else
 layout (set = 7, binding = 0) readonly buffer SSBOIndirectDraws{DrawIndirectCommand indirectCommands[]; };
+#endif
+layout (set = 8, binding = 0) buffer SSBOTextureFeedback{ uint textureFeedback[]; }; // Index by bindless texture id.
 
 #ifdef VERTEX_SHADER ///////////// vertex shader start 
 
@@ -34,7 +39,11 @@ layout(location = 2) out VS2PS vsOut;
 void main()
 {
     // Load object data.
+#ifdef INSTANCED_DRAW
+    outObjectId = visibleInstances[gl_InstanceIndex];
+#else
     outObjectId = indirectCommands[gl_DrawID].objectId;
+#endif
     const PerObjectData objectData = objectDatas[outObjectId];
 
     // We get bindless array id first.
@@ -97,6 +106,19 @@ void main()
 
 vec4 tex(uint texId,uint samplerId,vec2 uv)
 {
+    // Texture streaming feedback, finest mip relative to resident base mip.
+    // Lod query outside branch keep derivatives valid, only one pixel per 4x4 tile write per frame.
+    const float lod = textureQueryLod(sampler2D(bindlessTexture2D[nonuniformEXT(texId)], bindlessSampler[nonuniformEXT(samplerId)]), uv).y + frameData.basicTextureLODBias;
+    const uvec2 feedbackPos = uvec2(gl_FragCoord.xy) & 3u;
+    if(feedbackPos.y * 4u + feedbackPos.x == frameData.frameIndex.z)
+    {
+        const uint feedbackMip = uint(max(lod, 0.0));
+        if(feedbackMip < textureFeedback[texId])
+        {
+            atomicMin(textureFeedback[texId], feedbackMip);
+        }
+    }
+
     return texture(sampler2D(bindlessTexture2D[nonuniformEXT(texId)], bindlessSampler[nonuniformEXT(samplerId)]), uv, frameData.basicTextureLODBias);
 }
 
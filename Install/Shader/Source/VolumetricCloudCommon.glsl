@@ -10,6 +10,7 @@
 layout (set = 0, binding = 0, rgba16f) uniform image2D imageHdrSceneColor;
 layout (set = 0, binding = 1) uniform texture2D inHdrSceneColor;
 
+// Quarter resolution trace result, rgb is scatter light, a is transmittance.
 layout (set = 0, binding = 2, rgba16f) uniform image2D imageCloudRenderTexture;
 layout (set = 0, binding = 3) uniform texture2D inCloudRenderTexture;
 
@@ -22,7 +23,21 @@ layout (set = 0, binding = 7) uniform texture3D inWorleyNoise;
 layout (set = 0, binding = 8) uniform texture2D inWeatherTexture;
 layout (set = 0, binding = 9) uniform texture2D inGradientTexture;
 
-layout (set = 0, binding = 10, r8) uniform image2D imageTranslucentMask;
+// Quarter resolution transmittance weighted cloud distance (km), zero when no cloud hit.
+layout (set = 0, binding = 10, r32f) uniform image2D imageCloudDistance;
+layout (set = 0, binding = 11) uniform texture2D inCloudDistance;
+
+// Full resolution reconstruct result, keep as next frame history.
+layout (set = 0, binding = 12, rgba16f) uniform image2D imageCloudReconstruct;
+layout (set = 0, binding = 13) uniform texture2D inCloudHistory;
+layout (set = 0, binding = 14) uniform texture2D inPrevDepth;
+
+layout (push_constant) uniform PushConsts
+{
+    uint maxStepCount;
+    uint shadowStepCount;
+    uint bHistoryValid;
+} cloudPush;
 
 // Other common set.
 layout (set = 1, binding = 0) uniform UniformView  { ViewData  viewData;  };
@@ -37,4 +52,26 @@ layout (set = 2, binding = 0) uniform UniformFrame { FrameData frameData; };
 #include "Sample.glsl"
 #include "Phase.glsl"
 
+// Each frame trace one pixel of every 4x4 block, 16 frames cover all pixels in bayer order.
+const ivec2 kCloudBayerOffsets[16] =
+{
+    ivec2(0, 0), ivec2(2, 2), ivec2(2, 0), ivec2(0, 2),
+    ivec2(1, 1), ivec2(3, 3), ivec2(3, 1), ivec2(1, 3),
+    ivec2(1, 0), ivec2(3, 2), ivec2(3, 0), ivec2(1, 2),
+    ivec2(0, 1), ivec2(2, 3), ivec2(2, 1), ivec2(0, 3),
+};
+
+// Full resolution pixel traced this frame for trace texel.
+ivec2 getCloudTracePixel(ivec2 tracePos)
+{
+    const ivec2 renderSize = textureSize(inDepth, 0);
+    return min(tracePos * 4 + kCloudBayerOffsets[frameData.frameIndex.z], renderSize - 1);
+}
+
+// Camera unit distance per atmosphere unit (km).
+float getCloudCameraUnitScale()
+{
+    return 1.0 / (0.001f * viewData.cameraAtmosphereMoveScale);
+}
+
 #endif
\ No newline at end of file
@@ -7,7 +7,6 @@
 const float kTracingMaxDistance = 50.0f; // TODO: Configable.
 const float kTracingStartMaxDistance = 350.0f; // TODO: Configable.
 const uint kSampleCountMin = 2;
-const uint kSampleCountMax = 96;
 const float kCloudDistanceToSampleMaxCount = 15.0f;
 const float kCloudDistanceToSampleMaxCountInv = 1.0f / kCloudDistanceToSampleMaxCount;
 
@@ -20,11 +19,14 @@ const float kErosionStrength = 0.08;
 const float kNoiseHeightRange = 1.5f;
 const float kNoiseHeightExp = 2.0f;
 
-// #define CLOUD_SELF_SHADOW_STEPS 6
+// Reference shadow step count, shadow march distance keep same when push step count differ.
 #define CLOUD_SELF_SHADOW_STEPS 20
 #define CLOUDS_SHADOW_MARGE_STEP_SIZE (50)
 #define CLOUDS_SHADOW_MARGE_STEP_MULTIPLY (1.3)
 
+// Remain light contribution too small, stop marching.
+const float kTransmittanceEarlyOut = 0.01;
+
 const float kBeersScale = 1000.0;
 const float kBeersScaleShadow = 1000.0;
 
@@ -95,12 +97,13 @@ float getCloudDensity(vec3 pos, float normalizeHeight)
 
 float volumetricShadow(in vec3 from, in float sundotrd, in AtmosphereParameters atmosphere) 
 {
-    float dd = CLOUDS_SHADOW_MARGE_STEP_SIZE * 0.001f; // km
+    // Keep total shadow march distance when step count change.
+    float dd = CLOUDS_SHADOW_MARGE_STEP_SIZE * 0.001f * float(CLOUD_SELF_SHADOW_STEPS) / float(max(cloudPush.shadowStepCount, 1)); // km
     vec3 rd = normalize(frameData.directionalLight.direction);
     float d = dd * .5;
     float shadow = 1.0;
 
-    for(int s=0; s < CLOUD_SELF_SHADOW_STEPS; s++) 
+    for(uint s = 0; s < cloudPush.shadowStepCount; s++) 
     {
         vec3 pos = from + rd * d; // km
         float norY = (length(pos) - atmosphere.cloudAreaStartHeight) / atmosphere.cloudAreaThickness;
@@ -120,8 +123,10 @@ float volumetricShadow(in vec3 from, in float sundotrd, in AtmosphereParameters
     return shadow;
 }
 
-vec4 cloudColorCompute(vec2 uv, ivec2 workPos, ivec2 texSize)
+vec4 cloudColorCompute(vec2 uv, ivec2 pixelPos, out float cloudDistance)
 {
+    cloudDistance = 0.0;
+
     AtmosphereParameters atmosphere = getAtmosphereParameters(frameData);
 
     // We are revert z.
@@ -145,7 +150,7 @@ vec4 cloudColorCompute(vec2 uv, ivec2 workPos, ivec2 texSize)
     if(viewHeight < radiusCloudStart)
     {
         // Eye under cloud area.
-        float shadingModelId = texture(sampler2D(inGBufferA, pointClampEdgeSampler), uv).a;
+        float shadingModelId = texelFetch(inGBufferA, pixelPos, 0).a;
         if(isShadingModelValid(shadingModelId))
         {
             // Intersect with earth, pre-return.
@@ -211,11 +216,24 @@ vec4 cloudColorCompute(vec2 uv, ivec2 workPos, ivec2 texSize)
         return vec4(0.0, 0.0, 0.0, 1.0);
     }
 
+    // Stop at scene depth, so cloud in front of geometry composite correct.
+    const float deviceZ = texelFetch(inDepth, pixelPos, 0).r;
+    if(deviceZ > 0.0)
+    {
+        const float sceneDistance = length(getWorldPos(uv, deviceZ, viewData) - viewData.camWorldPos.xyz) / getCloudCameraUnitScale();
+        tMax = min(tMax, sceneDistance);
+        if(tMax <= tMin)
+        {
+            return vec4(0.0, 0.0, 0.0, 1.0);
+        }
+    }
+
     // Clamp marching distance by setting.    
     const float marchingDistance = min(kTracingMaxDistance, tMax - tMin);
 	tMax = tMin + marchingDistance;
 
-    const uint stepCountUnit =  uint(max(kSampleCountMin, kSampleCountMax * saturate((tMax - tMin) * kCloudDistanceToSampleMaxCountInv)));
+    // Step count scale with view ray length in cloud area.
+    const uint stepCountUnit =  uint(max(kSampleCountMin, cloudPush.maxStepCount * saturate((tMax - tMin) * kCloudDistanceToSampleMaxCountInv)));
     const float stepCount = float(stepCountUnit);
     const float stepT = (tMax - tMin) / stepCount; // Per step lenght.
 
@@ -230,13 +248,21 @@ vec4 cloudColorCompute(vec2 uv, ivec2 workPos, ivec2 texSize)
     float sundotrd = dot(worldDir, -normalize(frameData.directionalLight.direction));
     vec3 sunColor = frameData.directionalLight.color * frameData.directionalLight.intensity;
 
+    // Jitter start per pixel and frame, temporal reconstruct resolve banding to noise.
+    const float jitter = interleavedGradientNoise(vec2(pixelPos), float(frameData.frameIndex.x % 8));
+
+    // Transmittance weighted distance use for history reprojection.
+    float distanceSum = 0.0;
+    float distanceWeight = 0.0;
+
     float scattering =  mix(
         henyeyGreenstein(sundotrd, CLOUDS_FORWARD_SCATTERING_G),
         henyeyGreenstein(sundotrd, CLOUDS_BACKWARD_SCATTERING_G), CLOUDS_SCATTERING_LERP);
 
     for(uint i = 0; i < stepCountUnit; i ++)
     {
-        vec3 samplePos = (i * stepT + tMin) * worldDir + worldPos;
+        const float sampleT = (float(i) + jitter) * stepT + tMin;
+        vec3 samplePos = sampleT * worldDir + worldPos;
         float normalizeHeight = clamp((length(samplePos) - atmosphere.cloudAreaStartHeight)  / atmosphere.cloudAreaThickness, 0., 1.);
 
         float cloudDensity = getCloudDensity(samplePos, normalizeHeight);
@@ -251,18 +277,25 @@ vec4 cloudColorCompute(vec2 uv, ivec2 workPos, ivec2 texSize)
             vec3 curS = (curL - curL * dTrans) / cloudDensityClamp;
 
             scatteredLight += transmittance * curS * cloudDensity * scattering; 
+
+            const float extinction = transmittance * (1.0 - dTrans);
+            distanceSum += extinction * sampleT;
+            distanceWeight += extinction;
+
             transmittance *= dTrans;
         }
 
-        if(transmittance <= 0.001) 
+        if(transmittance <= kTransmittanceEarlyOut) 
         {
             break;
         }
     }
 
+    cloudDistance = distanceWeight > 0.0 ? distanceSum / distanceWeight : 0.0;
     return vec4(scatteredLight, transmittance);
 }
 
+// Dispatch at quarter resolution, each texel trace one full resolution pixel of its 4x4 block.
 layout (local_size_x = 8, local_size_y = 8) in;
 void main()
 {
@@ -274,8 +307,12 @@ void main()
         return;
     }
 
-    const vec2 uv = (vec2(workPos) + vec2(0.5f)) / vec2(texSize);
-    vec4 cloudColor = cloudColorCompute(uv, workPos, texSize);
+    const ivec2 pixelPos = getCloudTracePixel(workPos);
+    const vec2 uv = (vec2(pixelPos) + vec2(0.5f)) / vec2(textureSize(inDepth, 0));
+
+    float cloudDistance;
+    vec4 cloudColor = cloudColorCompute(uv, pixelPos, cloudDistance);
 
 	imageStore(imageCloudRenderTexture, workPos, cloudColor);
+    imageStore(imageCloudDistance, workPos, vec4(cloudDistance, 0.0, 0.0, 0.0));
 }
\ No newline at end of file
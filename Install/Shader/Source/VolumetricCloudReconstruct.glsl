@@ -0,0 +1,139 @@
+#version 460
+
+#extension GL_GOOGLE_include_directive : enable
+#extension GL_EXT_samplerless_texture_functions : enable
+
+// Reconstruct full resolution cloud from quarter resolution trace and reprojected history, then composite to scene color.
+
+#include "VolumetricCloudCommon.glsl"
+
+// Neighbor trace weight falloff by full resolution pixel distance.
+const float kSpatialSigma = 2.0;
+
+// Neighbor trace weight falloff by relative linear depth difference.
+const float kDepthWeightScale = 8.0;
+
+// History reject when relative linear depth difference bigger than this.
+const float kDisocclusionDepthThreshold = 0.1;
+
+// Fresh trace pixel still blend some history, trade a little lag for less noise.
+const float kFreshTraceWeight = 0.5;
+
+layout (local_size_x = 8, local_size_y = 8) in;
+void main()
+{
+    const ivec2 renderSize = imageSize(imageCloudReconstruct);
+    const ivec2 workPos = ivec2(gl_GlobalInvocationID.xy);
+
+    if(workPos.x >= renderSize.x || workPos.y >= renderSize.y)
+    {
+        return;
+    }
+
+    const vec2 uv = (vec2(workPos) + vec2(0.5f)) / vec2(renderSize);
+
+    // Reverse z, zero is sky.
+    const float deviceZ = texelFetch(inDepth, workPos, 0).r;
+    const bool bSky = deviceZ <= 0.0;
+    const float linearZ = bSky ? 0.0 : linearizeDepth(deviceZ, viewData);
+
+    const ivec2 traceSize = textureSize(inCloudRenderTexture, 0);
+    const ivec2 tracePos = min(workPos / 4, traceSize - 1);
+    const vec4 ownTrace = texelFetch(inCloudRenderTexture, tracePos, 0);
+
+    // Depth aware upsample from 3x3 trace neighbors, also collect color box for history clamp.
+    vec4 upsampled = vec4(0.0);
+    float weightSum = 0.0;
+
+    vec4 boxMin = ownTrace;
+    vec4 boxMax = ownTrace;
+    bool bBoxValid = false;
+
+    for(int y = -1; y <= 1; y ++)
+    {
+        for(int x = -1; x <= 1; x ++)
+        {
+            const ivec2 samplePos = clamp(tracePos + ivec2(x, y), ivec2(0), traceSize - 1);
+            const ivec2 samplePixel = getCloudTracePixel(samplePos);
+            const vec4 sampleCloud = texelFetch(inCloudRenderTexture, samplePos, 0);
+
+            // Sky only match sky, geometry weight by relative linear depth.
+            const float sampleDeviceZ = texelFetch(inDepth, samplePixel, 0).r;
+            const bool bSampleSky = sampleDeviceZ <= 0.0;
+
+            float depthWeight = (bSky == bSampleSky) ? 1.0 : 0.0;
+            if(!bSky && !bSampleSky)
+            {
+                const float sampleLinearZ = linearizeDepth(sampleDeviceZ, viewData);
+                depthWeight = exp(-kDepthWeightScale * abs(sampleLinearZ - linearZ) / max(linearZ, 1e-4f));
+            }
+
+            const vec2 pixelOffset = vec2(samplePixel - workPos);
+            const float weight = depthWeight * exp(-dot(pixelOffset, pixelOffset) / (2.0 * kSpatialSigma * kSpatialSigma));
+
+            upsampled += sampleCloud * weight;
+            weightSum += weight;
+
+            if(depthWeight > 0.5)
+            {
+                boxMin = bBoxValid ? min(boxMin, sampleCloud) : sampleCloud;
+                boxMax = bBoxValid ? max(boxMax, sampleCloud) : sampleCloud;
+                bBoxValid = true;
+            }
+        }
+    }
+    upsampled = weightSum > 1e-4f ? upsampled / weightSum : ownTrace;
+
+    const bool bFreshTrace = all(equal(workPos, getCloudTracePixel(tracePos)));
+    const vec4 current = bFreshTrace ? ownTrace : upsampled;
+
+    // Reproject cloud position with previous view projection, no cloud hit reproject as infinite far.
+    vec4 clipSpace = vec4(uv.x * 2.0f - 1.0f, 1.0f - uv.y * 2.0f, 0.0, 1.0);
+    vec4 viewPosH = viewData.camInvertProj * clipSpace;
+    vec3 worldDir = normalize((viewData.camInvertView * vec4(viewPosH.xyz / viewPosH.w, 0.0)).xyz);
+
+    const float cloudDistance = texelFetch(inCloudDistance, tracePos, 0).r;
+    const vec4 prevClip = (cloudDistance > 0.0)
+        ? viewData.camViewProjPrev * vec4(viewData.camWorldPos.xyz + worldDir * cloudDistance * getCloudCameraUnitScale(), 1.0)
+        : viewData.camViewProjPrev * vec4(worldDir, 0.0);
+
+    const vec2 prevUv = (prevClip.xy / prevClip.w) * vec2(0.5, -0.5) + 0.5;
+
+    bool bHistoryValid = (cloudPush.bHistoryValid != 0) && (prevClip.w > 0.0)
+        && all(greaterThanEqual(prevUv, vec2(0.0))) && all(lessThanEqual(prevUv, vec2(1.0)));
+
+    // Disocclusion, sky and geometry change or geometry depth change.
+    if(bHistoryValid)
+    {
+        const float prevDeviceZ = texture(sampler2D(inPrevDepth, pointClampEdgeSampler), prevUv).r;
+        const bool bPrevSky = prevDeviceZ <= 0.0;
+
+        if(bPrevSky != bSky)
+        {
+            bHistoryValid = false;
+        }
+        else if(!bSky)
+        {
+            const float prevLinearZ = linearizeDepthPrev(prevDeviceZ, viewData);
+            bHistoryValid = abs(prevLinearZ - linearZ) < kDisocclusionDepthThreshold * linearZ;
+        }
+    }
+
+    vec4 result = current;
+    if(bHistoryValid)
+    {
+        vec4 history = texture(sampler2D(inCloudHistory, linearClampEdgeSampler), prevUv);
+        if(bBoxValid)
+        {
+            history = clamp(history, boxMin, boxMax);
+        }
+
+        result = bFreshTrace ? mix(history, current, kFreshTraceWeight) : history;
+    }
+
+    imageStore(imageCloudReconstruct, workPos, result);
+
+    // Composite, trace already stop at scene depth.
+    const vec4 sceneColor = imageLoad(imageHdrSceneColor, workPos);
+    imageStore(imageHdrSceneColor, workPos, vec4(sceneColor.rgb * result.a + result.rgb, sceneColor.a));
+}
@@ -58,6 +58,11 @@ void Editor::preInit(const LauncherInfo& info)
 		m_renderSetting = newWidget.get();
 		m_widgets.push_back(std::move(newWidget));
 	}
+	{
+		auto newWidget = std::make_unique<std::remove_pointer_t<decltype(m_profiler)>>();
+		m_profiler = newWidget.get();
+		m_widgets.push_back(std::move(newWidget));
+	}
 }
 
 void Editor::init()
@@ -114,7 +119,10 @@ bool Editor::setProjectPath(const std::filesystem::path& in)
 		projectName.c_str(),
 		GEngine->getRuntimeModule<SceneManager>()->getScenes()->getName().c_str());
 
-	GEditor->getContentViewer()->markContentSnapshotDirty();
+	if (GEditor->getContentViewer())
+	{
+		GEditor->getContentViewer()->markContentSnapshotDirty();
+	}
 
 	return true;
 }
@@ -132,3 +140,76 @@ void Editor::run()
 	Launcher::guardedMain();
 	Launcher::release();
 }
+
+void Editor::headlessPreInit(const LauncherInfo& info)
+{
+	GEngine->registerRuntimeModule<AssetSystem>();
+	GEngine->registerRuntimeModule<SceneManager>();
+	GEngine->registerRuntimeModule<Renderer>();
+}
+
+void Editor::headlessInit()
+{
+	if (!m_benchmarkConfig.projectPath.empty())
+	{
+		std::filesystem::path fp{ m_benchmarkConfig.projectPath };
+		if (std::filesystem::exists(fp))
+		{
+			// Load project info.
+			std::ifstream is(fp, std::ios::binary);
+			cereal::JSONInputArchive archive(is);
+			archive(ProjectContext::get()->project);
+
+			if (!setProjectPath(fp))
+			{
+				LOG_ERROR("Benchmark project {0} is invalid, run with empty scene.", fp.string());
+			}
+		}
+		else
+		{
+			LOG_ERROR("Benchmark project {0} no exist, run with empty scene.", fp.string());
+		}
+	}
+
+	if (!m_benchmarkConfig.scenePath.empty())
+	{
+		if (!GEngine->getRuntimeModule<SceneManager>()->loadScene(m_benchmarkConfig.scenePath))
+		{
+			LOG_ERROR("Benchmark scene {0} load fail, run with empty scene.", m_benchmarkConfig.scenePath);
+		}
+	}
+
+	m_benchmark = std::make_unique<HeadlessBenchmark>();
+	m_benchmark->init(m_benchmarkConfig);
+}
+
+void Editor::headlessRelease()
+{
+	m_benchmark->release();
+	m_benchmark.reset();
+}
+
+bool Editor::runHeadless(const std::filesystem::path& configPath)
+{
+	if (!HeadlessBenchmark::Config::load(configPath, m_benchmarkConfig))
+	{
+		return false;
+	}
+
+	Launcher::preInitHookFunction.addRaw(this, &Editor::headlessPreInit);
+	Launcher::initHookFunction.addRaw(this, &Editor::headlessInit);
+	Launcher::releaseHookFunction.addRaw(this, &Editor::headlessRelease);
+
+	LauncherInfo info{};
+	info.bHeadless = true;
+	info.initWidth = m_benchmarkConfig.width;
+	info.initHeight = m_benchmarkConfig.height;
+
+	CHECK(Launcher::preInit(info));
+	CHECK(Launcher::init());
+
+	Launcher::guardedMain();
+	Launcher::release();
+
+	return true;
+}
@@ -9,18 +9,27 @@ private:
 	std::vector<std::unique_ptr<Widget>> m_widgets;
 
 	// Widgets.
-	DockSpace*      m_dockSpace;
-	WidgetDownbar*  m_downbar;
-	WidgetConsole*  m_console;
-	WidgetViewport* m_viewport;
-	WidgetSceneOutliner* m_outliner;
-	WidgetDetail*  m_detail;
-	WidgetProjectSelect* m_projectSelect;
-	WidgetContentViewer* m_contentViewer;
-	WidgetRenderSetting* m_renderSetting;
+	DockSpace*      m_dockSpace = nullptr;
+	WidgetDownbar*  m_downbar = nullptr;
+	WidgetConsole*  m_console = nullptr;
+	WidgetViewport* m_viewport = nullptr;
+	WidgetSceneOutliner* m_outliner = nullptr;
+	WidgetDetail*  m_detail = nullptr;
+	WidgetProjectSelect* m_projectSelect = nullptr;
+	WidgetContentViewer* m_contentViewer = nullptr;
+	WidgetRenderSetting* m_renderSetting = nullptr;
+	WidgetProfiler* m_profiler = nullptr;
+
+	// Headless benchmark, only valid when run headless.
+	std::unique_ptr<Flower::HeadlessBenchmark> m_benchmark = nullptr;
+	Flower::HeadlessBenchmark::Config m_benchmarkConfig;
+
 public:
 	void run();
 
+	// Run benchmark without window, return false if config invalid.
+	bool runHeadless(const std::filesystem::path& configPath);
+
 	auto* getDockSpace() { return m_dockSpace; }
 	auto* getWidgetDownbar() { return m_downbar; }
 	auto* getWidgetConsole() { return m_console; }
@@ -31,12 +40,17 @@ public:
 	auto* getContentViewer() { return m_contentViewer; }
 
 	auto* getRenderSetting() { return m_renderSetting; }
+	auto* getProfiler() { return m_profiler; }
 private:
 	void preInit(const Flower::LauncherInfo& info);
 	void init();
 	void tick(const Flower::EngineTickData& tickData);
 	void release();
 
+	void headlessPreInit(const Flower::LauncherInfo& info);
+	void headlessInit();
+	void headlessRelease();
+
 public:
 	bool setProjectPath(const std::filesystem::path& in);
 };
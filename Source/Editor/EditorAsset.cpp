@@ -57,6 +57,25 @@ VkDescriptorSet EditorAsset::getSetByAssetAsSnapShot(GPUImageAsset* imageAsset)
 	return m_cacheSnapShotSet.at(identify);
 }
 
+VkDescriptorSet EditorAsset::getSetByThumbnailPage(uint32_t page)
+{
+	if (m_cacheThumbnailPageSet.empty())
+	{
+		m_cacheThumbnailPageSet.resize(ThumbnailAtlasContext::kPageCount, VK_NULL_HANDLE);
+	}
+
+	if (m_cacheThumbnailPageSet.at(page) == VK_NULL_HANDLE)
+	{
+		m_cacheThumbnailPageSet[page] = ImGui_ImplVulkan_AddTexture(
+			RHI::SamplerManager->createSampler(SamplerFactory::buildBasic()),
+			ThumbnailAtlas::get()->getPageView(page),
+			VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
+		);
+	}
+
+	return m_cacheThumbnailPageSet[page];
+}
+
 
 struct RegisteredStructForEditorAsset
 {
@@ -85,4 +104,12 @@ RegisteredStructForEditorAsset registerStaticMesh(
 	std::string("  ") + ICON_FA_BUILDING + std::string("    StaticMesh"),
 	"obj;gltf",
 	EAssetType::StaticMesh
+);
+
+RegisteredStructForEditorAsset registerHeightmap(
+	"Heightmap",
+	ICON_FA_MOUNTAIN_SUN,
+	std::string("  ") + ICON_FA_MOUNTAIN_SUN + std::string("    Heightmap"),
+	"png,r16,raw;png;r16;raw",
+	EAssetType::Heightmap
 );
\ No newline at end of file
@@ -26,6 +26,9 @@ private:
 	// Cache set for snapshot image.
 	std::unordered_map<Flower::UUID, VkDescriptorSet> m_cacheSnapShotSet;
 
+	// Cache set for thumbnail atlas page.
+	std::vector<VkDescriptorSet> m_cacheThumbnailPageSet;
+
 public:
 	EditorAsset() = default;
 
@@ -48,6 +51,7 @@ public:
 	}
 
 	VkDescriptorSet getSetByAssetAsSnapShot(Flower::GPUImageAsset* imageAsset);
+	VkDescriptorSet getSetByThumbnailPage(uint32_t page);
 
 	const static std::string DragDropName;
 };
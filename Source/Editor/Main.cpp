@@ -1,8 +1,17 @@
 #include "Pch.h"
 #include "Editor.h"
 
-int main()
+int main(int argc, char** argv)
 {
+	// Editor.exe --headless benchmark.json
+	for (int i = 1; i < argc - 1; i++)
+	{
+		if (std::string(argv[i]) == "--headless")
+		{
+			return GEditor->runHeadless(argv[i + 1]) ? 0 : 1;
+		}
+	}
+
 	GEditor->run();
 	return 0;
 }
\ No newline at end of file
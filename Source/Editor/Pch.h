@@ -11,6 +11,7 @@
 #include "../Engine/WindowData.h"
 #include "../Engine/Scene/SceneManager.h"
 #include "../Engine/UI/UIHelper.h"
+#include "../Engine/UI/UIRetain.h"
 #include "../Engine/Scene/SceneNode.h"
 #include "../Engine/Scene/Scene.h"
 #include "../Engine/AssetSystem/AssetSystem.h"
@@ -18,14 +19,18 @@
 #include "../Engine/AssetSystem/AssetRegistry.h"
 #include "../Engine/Project.h"
 #include "../Engine/AssetSystem/TextureManager.h"
+#include "../Engine/AssetSystem/ThumbnailAtlas.h"
 #include "../Engine/Scene/Component/Landscape.h"
 #include "../Engine/Scene/Component/StaticMesh.h"
 #include "../Engine/Scene/CameraInterface.h"
 #include "../Engine/MeshTool/MeshToolCommon.h"
 #include "../Engine/AssetSystem/MeshManager.h"
 #include "../Engine/Renderer/DeferredRenderer/DeferredRenderer.h"
+#include "../Engine/Renderer/HeadlessBenchmark.h"
 #include "../Engine/Scene/Component/PMXComponent.h"
 #include "../Engine/Scene/Component/DirectionalLight.h"
 #include "../Engine/Scene/Component/SpotLight.h"
+#include "../Engine/Scene/Component/PointLight.h"
+#include "../Engine/Scene/SceneArchive.h"
 
 #include "../Engine/Renderer/RenderSettingContext.h"
\ No newline at end of file
@@ -39,8 +39,15 @@ void WidgetConsole::onVisibleTick(const RuntimeModuleTickData& tickData)
     m_console->draw();
 }
 
+bool WidgetConsole::getContentGeneration(uint64_t& outGeneration) const
+{
+    outGeneration = m_console->getLogGeneration();
+    return true;
+}
+
 void Console::clearLog()
 {
+    m_logGeneration++;
     m_logItems.clear();
     for (auto& i : m_logTypeCount)
     {
@@ -50,6 +57,7 @@ void Console::clearLog()
 
 void Console::addLog(std::string info, ELogType type)
 {
+    m_logGeneration++;
     m_logTypeCount[size_t(type)] ++;
     m_logItems.push_back({ info, type });
 
@@ -523,81 +531,84 @@ void Console::draw()
     // Tighten spacing
     ImGui::PushStyleVar(ImGuiStyleVar_ItemSpacing, ImVec2(4, 1));
 
-    for (int i = 0; i < m_logItems.size(); i++)
+    // Rebuild visible items only when log, filter or type visibility change.
+    size_t visibleItemsKey = hashCombine(m_logGeneration, std::hash<std::string_view>{}(m_filter.InputBuf));
+    for (size_t type = 0; type < size_t(ELogType::Max); type++)
     {
-        const char* item = m_logItems[i].first.c_str();
-        if (!m_filter.PassFilter(item))
-            continue;
-
-        ImVec4 color;
-        bool bHasColor = false;
-        bool bOutSeparate = false;
-        if (m_logItems[i].second == ELogType::Error)
-        {
-            if (!m_logVisible[size_t(ELogType::Error)])
-                continue;
+        visibleItemsKey = hashCombine(visibleItemsKey, m_logVisible[type] ? type + 1 : 0);
+    }
 
-            color = ImVec4(1.0f, 0.08f, 0.08f, 1.0f);
-            bHasColor = true;
-        }
-        else if (m_logItems[i].second == ELogType::Warn)
-        {
-            if (!m_logVisible[size_t(ELogType::Warn)])
-                continue;
+    if (visibleItemsKey != m_visibleItemsKey)
+    {
+        m_visibleItemsKey = visibleItemsKey;
+        m_visibleItems.clear();
 
-            color = ImVec4(1.0f, 1.0f, 0.1f, 1.0f);
-            bHasColor = true;
-        }
-        else if (m_logItems[i].second == ELogType::Trace)
+        for (int i = 0; i < m_logItems.size(); i++)
         {
-            if (!m_logVisible[size_t(ELogType::Trace)])
-                continue;
-        }
-        else if (m_logItems[i].second == ELogType::Info)
-        {
-            if (!m_logVisible[size_t(ELogType::Info)])
-                continue;
-        }
-        else if (strncmp(item, "# ", 2) == 0)
-        {
-            if (!m_logVisible[size_t(ELogType::Other)])
-                continue;
-            bOutSeparate = true;
-            color = ImVec4(1.0f, 0.8f, 0.6f, 1.0f);
-            bHasColor = true;
+            if (m_logVisible[size_t(m_logItems[i].second)] && m_filter.PassFilter(m_logItems[i].first.c_str()))
+            {
+                m_visibleItems.push_back(i);
+            }
         }
-        else if (strncmp(item, "Help: ", 5) == 0)
-        {
-            if (!m_logVisible[size_t(ELogType::Other)])
-                continue;
+    }
 
-            color = ImVec4(1.0f, 0.6f, 0.0f, 1.0f);
-            bHasColor = true;
-        }
-        else
+    // Only submit items in scroll view.
+    ImGuiListClipper clipper;
+    clipper.Begin(int(m_visibleItems.size()));
+    while (clipper.Step())
+    {
+        for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; row++)
         {
-            if (!m_logVisible[size_t(ELogType::Other)])
-                continue;
-        }
+            const int i = m_visibleItems[row];
+            const char* item = m_logItems[i].first.c_str();
+            const ELogType type = m_logItems[i].second;
 
-        
-        if (bOutSeparate)
-        {
-            ImGui::Separator();
-        }
+            ImVec4 color;
+            bool bHasColor = false;
+            bool bOutSeparate = false;
+            if (type == ELogType::Error)
+            {
+                color = ImVec4(1.0f, 0.08f, 0.08f, 1.0f);
+                bHasColor = true;
+            }
+            else if (type == ELogType::Warn)
+            {
+                color = ImVec4(1.0f, 1.0f, 0.1f, 1.0f);
+                bHasColor = true;
+            }
+            else if (type == ELogType::Other && strncmp(item, "# ", 2) == 0)
+            {
+                bOutSeparate = true;
+                color = ImVec4(1.0f, 0.8f, 0.6f, 1.0f);
+                bHasColor = true;
+            }
+            else if (type == ELogType::Other && strncmp(item, "Help: ", 5) == 0)
+            {
+                color = ImVec4(1.0f, 0.6f, 0.0f, 1.0f);
+                bHasColor = true;
+            }
 
-        if (bHasColor)
-            ImGui::PushStyleColor(ImGuiCol_Text, color);
-        ImGui::Selectable(item, m_hoverItem == i);
-        if (bHasColor)
-            ImGui::PopStyleColor();
+            // Draw separate line without layout, keep clipper item height same.
+            if (bOutSeparate)
+            {
+                const ImVec2 linePos = ImGui::GetCursorScreenPos();
+                ImGui::GetWindowDrawList()->AddLine(
+                    linePos, 
+                    ImVec2(linePos.x + ImGui::GetContentRegionAvail().x, linePos.y), 
+                    ImGui::GetColorU32(ImGuiCol_Separator));
+            }
 
-        if (ImGui::IsItemHovered(ImGuiHoveredFlags_RectOnly) && !m_bLogItemMenuPopup)
-        {
-            m_hoverItem = i;
-        }
+            if (bHasColor)
+                ImGui::PushStyleColor(ImGuiCol_Text, color);
+            ImGui::Selectable(item, m_hoverItem == i);
+            if (bHasColor)
+                ImGui::PopStyleColor();
 
-        
+            if (ImGui::IsItemHovered(ImGuiHoveredFlags_RectOnly) && !m_bLogItemMenuPopup)
+            {
+                m_hoverItem = i;
+            }
+        }
     }
 
     if (ImGui::BeginPopupContextWindow())
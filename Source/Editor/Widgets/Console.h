@@ -23,6 +23,8 @@ protected:
 	// event when widget visible tick.
 	virtual void onVisibleTick(const Flower::RuntimeModuleTickData& tickData) override;
 
+	virtual bool getContentGeneration(uint64_t& outGeneration) const override;
+
 private:
 	std::unique_ptr<Console> m_console;
 };
@@ -55,6 +57,11 @@ private:
 
 	// log items deque.
 	std::deque<std::pair<std::string, Flower::ELogType>> m_logItems;
+	uint64_t m_logGeneration = 0;
+
+	// Log item index pass filter and type visibility, cache until key change.
+	std::vector<int32_t> m_visibleItems;
+	size_t m_visibleItemsKey = ~0;
 	static const uint32_t MAX_LOG_ITEMS_COUNT = 200;
 	int32_t m_hoverItem = -1;
 	bool m_bLogItemMenuPopup = false;
@@ -92,5 +99,7 @@ public:
 	void draw();
 	void release();
 
+	uint64_t getLogGeneration() const { return m_logGeneration; }
+
 	int32_t textEditCallback(ImGuiInputTextCallbackData* data);
 };
\ No newline at end of file
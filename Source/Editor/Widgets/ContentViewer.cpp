@@ -50,10 +50,17 @@ void WidgetContentViewer::onInit()
 
 		GpuUploader::get()->flushTask();
 	}
+
+	m_renderer = GEngine->getRuntimeModule<Renderer>();
+	m_rendererDelegate = m_renderer->rendererTickHooks.addLambda([](const RuntimeModuleTickData& tickData, VkCommandBuffer graphicsCmd)
+	{
+		ThumbnailAtlas::get()->flushUploads(graphicsCmd);
+	});
 }
 
 void WidgetContentViewer::onRelease()
 {
+	m_renderer->rendererTickHooks.remove(m_rendererDelegate);
 	m_snapshotDrawers.clear();
 }
 
@@ -66,6 +73,7 @@ void WidgetContentViewer::onTick(const RuntimeModuleTickData& tickData)
 	{
 		m_bCacheSnapShotDirty = false;
 		m_snapshotDrawers.clear();
+		m_snapshotGeneration++;
 
 		if (!m_workingEntry.lock())
 		{
@@ -85,6 +93,19 @@ void WidgetContentViewer::onTick(const RuntimeModuleTickData& tickData)
 	}
 }
 
+bool WidgetContentViewer::getContentGeneration(uint64_t& outGeneration) const
+{
+	if (m_bSnapshotLoading)
+	{
+		return false;
+	}
+
+	// Atlas slot evict may reuse slot of retained thumbnail.
+	outGeneration = hashCombine(m_snapshotGeneration, AssetRegistryManager::get()->isDirty() ? 1 : 0);
+	outGeneration = hashCombine(outGeneration, ThumbnailAtlas::get()->getEvictGeneration());
+	outGeneration = hashCombine(outGeneration, ProjectContext::get()->isValid() ? 1 : 0);
+	return true;
+}
 
 void WidgetContentViewer::onVisibleTick(const RuntimeModuleTickData& tickData)
 {
@@ -155,7 +176,7 @@ void WidgetContentViewer::drawContentTreeView(const std::shared_ptr<Flower::Regi
 	ImGuiTreeNodeFlags nodeFlags = ImGuiTreeNodeFlags_AllowItemOverlap | ImGuiTreeNodeFlags_SpanFullWidth;
 	nodeFlags |= bTreeNode ? ImGuiTreeNodeFlags_OpenOnArrow : ImGuiTreeNodeFlags_Leaf;
 
-	std::string name = bTreeNode ? entry->getName() : entry->getHeader()->getName();
+	std::string name = bTreeNode ? entry->getName() : AssetRegistryManager::get()->getAssetName(entry->getAssetHeaderID());
 
 	if (const auto selectedEntry = m_selectedEntryInTreeView.lock())
 	{
@@ -202,14 +223,15 @@ void WidgetContentViewer::drawContentTreeView(const std::shared_ptr<Flower::Regi
 void WidgetContentViewer::drawContentSnapshot()
 {
 	const size_t inspectItemNum = m_snapshotDrawers.size();
+	m_bSnapshotLoading = false;
 
 	const auto availRegion = ImGui::GetContentRegionAvail();
 	const float itemDimSize = ImGui::GetTextLineHeightWithSpacing() * m_inspectorItemIconSize;
 
-	const uint32_t drawItemPerRow = uint32_t(glm::max(1.0f, glm::ceil(availRegion.x / itemDimSize - 0.25f) - 1.0f));
+	const auto layout = ThumbnailGridLayout::build(availRegion.x, availRegion.y, itemDimSize, inspectItemNum);
 
-	const size_t minDrawRowNum = size_t(glm::max(1.0f, glm::ceil(availRegion.y / itemDimSize)));
-	const uint32_t drawRowNum = uint32_t(glm::max(minDrawRowNum, inspectItemNum / drawItemPerRow + 1));
+	// Rows after view prefetch thumbnail.
+	static const uint32_t kPrefetchRows = 2;
 
 	static ImGuiTableFlags flags =
 		ImGuiTableFlags_ScrollY |
@@ -217,36 +239,52 @@ void WidgetContentViewer::drawContentSnapshot()
 		ImGuiTableFlags_NoClip |
 		ImGuiTableFlags_NoBordersInBody;
 
-	if (ImGui::BeginTable("table_scrolly_snapshot", drawItemPerRow, flags, availRegion))
+	if (ImGui::BeginTable("table_scrolly_snapshot", int(layout.itemsPerRow + 1), flags, availRegion))
 	{
 		ImGui::TableSetupColumn("", ImGuiTableColumnFlags_WidthFixed, 1.0f);
-		for (size_t i = 1; i < drawItemPerRow; i++)
+		for (uint32_t i = 0; i < layout.itemsPerRow; i++)
 		{
 			ImGui::TableSetupColumn("", ImGuiTableColumnFlags_WidthFixed, itemDimSize);
 		}
 
+		// Only clipper visible rows draw, so only they request thumbnail.
+		uint32_t drawRowEnd = 0;
 		ImGuiListClipper clipper;
-		clipper.Begin(int(drawRowNum));
+		clipper.Begin(int(layout.rowCount));
 		while (clipper.Step())
 		{
-			for (size_t row = clipper.DisplayStart; row < clipper.DisplayEnd; row++)
+			for (uint32_t row = uint32_t(clipper.DisplayStart); row < uint32_t(clipper.DisplayEnd); row++)
 			{
 				ImGui::TableNextRow();
 				ImGui::PushID(int(row));
 
-				for (size_t colum = 1; colum < drawItemPerRow; colum++)
+				for (uint32_t colum = 0; colum < layout.itemsPerRow; colum++)
 				{
-					size_t drawId = row * (drawItemPerRow - 1) + (colum - 1);
-
+					const size_t drawId = layout.getItemIndex(row, colum);
 					if (drawId < inspectItemNum)
 					{
-						ImGui::TableSetColumnIndex(int(colum));
+						ImGui::TableSetColumnIndex(int(colum + 1));
 						m_snapshotDrawers[drawId].draw(itemDimSize);
 					}
 				}
 
 				ImGui::PopID();
 			}
+			drawRowEnd = glm::max(drawRowEnd, uint32_t(clipper.DisplayEnd));
+		}
+
+		const glm::uvec2 prefetchRows = ThumbnailGridLayout::computeVisibleRows(
+			ImGui::GetScrollY(), ImGui::GetWindowHeight(), clipper.ItemsHeight, layout.rowCount, kPrefetchRows);
+		for (uint32_t row = glm::max(drawRowEnd, prefetchRows.x); row < prefetchRows.y; row++)
+		{
+			for (uint32_t colum = 0; colum < layout.itemsPerRow; colum++)
+			{
+				const size_t drawId = layout.getItemIndex(row, colum);
+				if (drawId < inspectItemNum)
+				{
+					m_snapshotDrawers[drawId].prefetch();
+				}
+			}
 		}
 
 		ImGui::EndTable();
@@ -440,6 +478,21 @@ void AssetTypeDrawer::flushLazyCallFunctions()
 	m_counter++;
 }
 
+void AssetSnapShotDrawer::prefetch()
+{
+	auto entryPtr = AssetRegistryManager::get()->getEntryMap().at(entry).lock();
+	if (!entryPtr->isLeaf())
+	{
+		return;
+	}
+
+	auto assetHeader = AssetRegistryManager::get()->getHeader(entryPtr->getAssetHeaderID());
+	if (assetHeader->getType() == EAssetType::Texture)
+	{
+		ThumbnailAtlas::get()->request(std::dynamic_pointer_cast<ImageAssetHeader>(assetHeader));
+	}
+}
+
 void AssetSnapShotDrawer::draw(float drawDimSize)
 {
 	auto entryPtr = AssetRegistryManager::get()->getEntryMap().at(entry).lock();
@@ -501,6 +554,7 @@ void AssetSnapShotDrawer::draw(float drawDimSize)
 	ImVec2 uv0{ 0.0f, 0.0f };
 	ImVec2 uv1{ 1.0f, 1.0f };
 	static const float uvScale = 0.02f;
+	bool bImageDrawn = false;
 
 	
 	set = EditorAssetSystem::get()->getSetByAssetAsSnapShot(TextureManager::get()->getImage(EngineTextures::GWhiteTextureUUID).get());
@@ -508,37 +562,33 @@ void AssetSnapShotDrawer::draw(float drawDimSize)
 	if (entryPtr->isLeaf())
 	{
 		
-		auto assetHeader = AssetRegistryManager::get()->getHeaderMap().at(entryPtr->getAssetHeaderID());
+		auto assetHeader = AssetRegistryManager::get()->getHeader(entryPtr->getAssetHeaderID());
 		if (assetHeader->getType() == EAssetType::Texture)
 		{
 			auto imageAsset = std::dynamic_pointer_cast<ImageAssetHeader>(assetHeader);
 
-			if (!cacheAsset)
+			// Only visible row drawer reach here, so only visible thumbnail hold atlas slot this frame.
+			const auto tile = ThumbnailAtlas::get()->request(imageAsset);
+			if (tile.bReady)
 			{
-				cacheAsset = TextureManager::get()->getOrCreateLRUSnapShot(imageAsset);
+				set = EditorAssetSystem::get()->getSetByThumbnailPage(tile.page);
+				uv0 = { tile.uv0.x, tile.uv0.y };
+				uv1 = { tile.uv1.x, tile.uv1.y };
+
+				// Atlas slot can't sample out of snapshot region, letterbox by draw rect instead of uv.
+				const float fitSize = drawDimSize / (1.0f + 2.0f * uvScale);
+				const float maxDim = float(glm::max(1u, glm::max(tile.width, tile.height)));
+				const ImVec2 imageSize = { fitSize * tile.width / maxDim, fitSize * tile.height / maxDim };
+				const ImVec2 imageMin = {
+					ImGui::GetCursorScreenPos().x + (drawDimSize - imageSize.x) * 0.5f,
+					ImGui::GetCursorScreenPos().y + (drawDimSize - imageSize.y) * 0.5f };
+
+				ImGui::GetWindowDrawList()->AddImage(set, imageMin, { imageMin.x + imageSize.x, imageMin.y + imageSize.y }, uv0, uv1);
+				bImageDrawn = true;
 			}
-
-			set = EditorAssetSystem::get()->getSetByAssetAsSnapShot(cacheAsset->getReadyAsset());
-
-			const auto w = imageAsset->getSnapShotWidth();
-			const auto h = imageAsset->getSnapShotHeight();
-
-			if (w < h)
-			{
-				uv0.x = 0.0f - (1.0f - float(w) / float(h)) * 0.5f;
-				uv1.x = 1.0f + (1.0f - float(w) / float(h)) * 0.5f;
-
-				uv0.y = -uvScale;
-				uv1.y = 1.0f + uvScale;
-
-			}
-			else if (w > h)
+			else
 			{
-				uv0.y = 0.0f - (1.0f - float(h) / float(w)) * 0.5f;
-				uv1.y = 1.0f + (1.0f - float(h) / float(w)) * 0.5f;
-
-				uv0.x = -uvScale;
-				uv1.x = 1.0f + uvScale;
+				viewer->m_bSnapshotLoading = true;
 			}
 		}
 		else
@@ -562,7 +612,14 @@ void AssetSnapShotDrawer::draw(float drawDimSize)
 	}
 	
 
-	ImGui::Image(set, { drawDimSize , drawDimSize }, uv0, uv1 );
+	if (bImageDrawn)
+	{
+		ImGui::Dummy({ drawDimSize , drawDimSize });
+	}
+	else
+	{
+		ImGui::Image(set, { drawDimSize , drawDimSize }, uv0, uv1);
+	}
 
 	const float indentSize = 4.0f;
 	ImGui::Indent(indentSize);
@@ -594,12 +651,12 @@ void AssetSnapShotDrawer::draw(float drawDimSize)
 		for (const auto& id : viewer->m_dragDropObjects->selectAssets)
 		{
 			auto loopEntryPtr = AssetRegistryManager::get()->getEntryMap().at(id).lock();
-			auto loopassetHeader = AssetRegistryManager::get()->getHeaderMap().at(loopEntryPtr->getAssetHeaderID());
-			const std::string& typeName = typeMaps.at(loopassetHeader->getType());
+			const auto& loopAssetId = loopEntryPtr->getAssetHeaderID();
+			const std::string& typeName = typeMaps.at(AssetRegistryManager::get()->getAssetType(loopAssetId));
 
 			ImGui::Text(filterMaps.at(typeName).iconName.c_str());
 			ImGui::SameLine();
-			ImGui::Text(loopassetHeader->getName().c_str());
+			ImGui::Text(AssetRegistryManager::get()->getAssetName(loopAssetId).c_str());
 		}
 
 		ImGui::EndDragDropSource();
@@ -31,8 +31,6 @@ struct AssetSnapShotDrawer
 	class WidgetContentViewer* viewer;
 	Flower::RegistryUUID entry;
 
-	std::shared_ptr<Flower::GPUImageAsset> cacheAsset = nullptr;
-
 	explicit AssetSnapShotDrawer(WidgetContentViewer* viewerIn)
 		: viewer(viewerIn)
 	{
@@ -40,6 +38,9 @@ struct AssetSnapShotDrawer
 	}
 
 	void draw(float drawDimSize);
+
+	// Request thumbnail of rows just after view, ready before scroll into view.
+	void prefetch();
 };
 
 
@@ -79,6 +80,8 @@ protected:
 	// event when widget visible tick.
 	virtual void onVisibleTick(const Flower::RuntimeModuleTickData&) override;
 
+	virtual bool getContentGeneration(uint64_t& outGeneration) const override;
+
 	void drawMenu();
 
 	void drawContent();
@@ -93,6 +96,12 @@ private:
 	std::weak_ptr<Flower::RegistryEntry> m_selectedEntryInTreeView;
 
 	bool m_bCacheSnapShotDirty = true;
+
+	// Increase when snapshot drawers rebuild.
+	uint64_t m_snapshotGeneration = 0;
+
+	// Some snapshot still async loading when last draw, draw output will change.
+	bool m_bSnapshotLoading = false;
 	float m_inspectorItemIconSize = 5.0f;
 	std::vector<AssetSnapShotDrawer> m_snapshotDrawers;
 	std::unique_ptr<struct DragAndDropAssets> m_dragDropObjects;
@@ -101,4 +110,7 @@ private:
 
 	std::weak_ptr<Flower::RegistryEntry> m_workingEntry;
 
+	// Record thumbnail atlas upload on frame graphics command buffer.
+	Flower::DelegateHandle m_rendererDelegate;
+	Flower::Renderer* m_renderer = nullptr;
 };
\ No newline at end of file
@@ -175,6 +175,7 @@ void WidgetDetail::drawComponent(std::shared_ptr<SceneNode> node)
 			drawAddNode.template operator()<LandscapeComponent>(GIconLandscape);
 			drawAddNode.template operator()<DirectionalLightComponent>(GIconDirectionalLight);
 			drawAddNode.template operator()<SpotLightComponent>(GIconSpotLight);
+			drawAddNode.template operator()<PointLightComponent>(GIconPointLight);
 
 			if (!bExistOneNewComponent)
 			{
@@ -56,6 +56,15 @@ void WidgetDownbar::onTick(const RuntimeModuleTickData& tickData)
 		std::stringstream ss;
 		ss << std::setw(4) << std::left << std::setfill(' ') << std::fixed << std::setprecision(0) << fps;
 		fpsText = "Editor Ticking  " + ss.str() + "FPS";
+
+		// Frame time percentiles and input latency, latency end with * when only measure to present call.
+		std::stringstream pacing;
+		pacing << std::fixed << std::setprecision(1)
+			<< "  p50 " << tickData.frameTimeP50
+			<< " p95 " << tickData.frameTimeP95
+			<< " p99 " << tickData.frameTimeP99 << "ms"
+			<< "  Latency " << tickData.latency << "ms" << (tickData.bLatencyToDisplay ? "" : "*");
+		fpsText += pacing.str();
 	}
 
 	if (ImGui::BeginDownBar(1.1f))
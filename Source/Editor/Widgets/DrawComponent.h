@@ -4,6 +4,7 @@
 extern const std::string GIconLandscape;
 extern const std::string GIconDirectionalLight;
 extern const std::string GIconSpotLight;
+extern const std::string GIconPointLight;
 extern const std::string GIconStaticMesh;
 extern const std::string GIconPMX;
 
@@ -17,7 +18,9 @@ struct ComponentDrawer
 	static void drawLight(std::shared_ptr<Flower::LightComponent> comp);
 	static void drawDirectionalLight(std::shared_ptr<Flower::SceneNode> node);
 	static void drawSpotLight(std::shared_ptr<Flower::SceneNode> node);
+	static void drawPointLight(std::shared_ptr<Flower::SceneNode> node);
 	static void drawPMX(std::shared_ptr<Flower::SceneNode> node);
+	static void drawLandscape(std::shared_ptr<Flower::SceneNode> node);
 
 };
 
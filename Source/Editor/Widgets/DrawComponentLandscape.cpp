@@ -0,0 +1,65 @@
+#include "Pch.h"
+#include "Detail.h"
+#include "DrawComponent.h"
+
+using namespace Flower;
+using namespace Flower::UI;
+
+void drawHeightmapSelect(std::shared_ptr<SceneNode> node, std::shared_ptr<LandscapeComponent> comp)
+{
+	const auto& map = AssetRegistryManager::get()->getTypeAssetSetMap();
+	if (!map.contains(size_t(EAssetType::Heightmap)))
+	{
+		ImGui::TextDisabled("No heightmap asset in project.");
+		return;
+	}
+
+	const auto& heightmapMap = map.at(size_t(EAssetType::Heightmap));
+	for (const auto& heightmapId : heightmapMap)
+	{
+		if (ImGui::MenuItem(AssetRegistryManager::get()->getAssetName(heightmapId).c_str()))
+		{
+			comp->setHeightmapUUID(heightmapId);
+		}
+	}
+}
+
+void ComponentDrawer::drawLandscape(std::shared_ptr<SceneNode> node)
+{
+	std::shared_ptr<LandscapeComponent> comp = node->getComponent<LandscapeComponent>();
+
+	if (comp->isHeightmapAlreadySet())
+	{
+		ImGui::TextDisabled("Heightmap asset: %s aleady set for this component.", comp->getHeightmapAssetName().c_str());
+		ImGui::TextDisabled("Asset uuid: %s.", comp->getHeightmapUUID().c_str());
+	}
+	else
+	{
+		ImGui::TextDisabled("Non-heightmap set on the landscape component.");
+		ImGui::TextDisabled("Please select one heightmap asset for this component.");
+	}
+
+	static const std::string selectButtonName = GIconLandscape + "  Select...";
+	if (ImGui::Button(selectButtonName.c_str()))
+		ImGui::OpenPopup("HeightmapSelectPopUp");
+	if (ImGui::BeginPopup("HeightmapSelectPopUp"))
+	{
+		drawHeightmapSelect(node, comp);
+		ImGui::EndPopup();
+	}
+
+	ImGui::PushItemWidth(100.0f);
+
+	float sampleSpacing = comp->getSampleSpacing();
+	ImGui::DragFloat("Sample Spacing", &sampleSpacing, 0.01f, 0.01f, 100.0f);
+	comp->setSampleSpacing(sampleSpacing);
+
+	float heightScale = comp->getHeightScale();
+	ImGui::DragFloat("Height Scale", &heightScale, 1.0f, 0.0f, 10000.0f);
+	comp->setHeightScale(heightScale);
+
+	ImGui::PopItemWidth();
+
+	ImGui::TextDisabled("Lod count: %d.", comp->getLodCount());
+	ImGui::TextDisabled("Resident tiles: %d / %d.", comp->getResidentTileCount(), comp->getTileCount());
+}
@@ -0,0 +1,21 @@
+#include "Pch.h"
+#include "Detail.h"
+#include "DrawComponent.h"
+
+using namespace Flower;
+using namespace Flower::UI;
+
+void ComponentDrawer::drawPointLight(std::shared_ptr<SceneNode> node)
+{
+	std::shared_ptr<PointLightComponent> comp = node->getComponent<PointLightComponent>();
+
+	drawLight(comp);
+
+	ImGui::PushItemWidth(100.0f);
+
+	float range = comp->getRange();
+	ImGui::DragFloat("Range", &range, 0.1f, 0.01f, 1000.0f);
+	comp->setRange(range);
+
+	ImGui::PopItemWidth();
+}
\ No newline at end of file
@@ -10,4 +10,20 @@ void ComponentDrawer::drawSpotLight(std::shared_ptr<SceneNode> node)
 	std::shared_ptr<SpotLightComponent> comp = node->getComponent<SpotLightComponent>();
 
 	drawLight(comp);
+
+	ImGui::PushItemWidth(100.0f);
+
+	float range = comp->getRange();
+	ImGui::DragFloat("Range", &range, 0.1f, 0.01f, 1000.0f);
+	comp->setRange(range);
+
+	float outerConeAngle = comp->getOuterConeAngle();
+	ImGui::SliderAngle("Outer Cone Angle", &outerConeAngle, 1.0f, 89.0f);
+	comp->setOuterConeAngle(outerConeAngle);
+
+	float innerConeAngle = comp->getInnerConeAngle();
+	ImGui::SliderAngle("Inner Cone Angle", &innerConeAngle, 0.0f, glm::degrees(comp->getOuterConeAngle()));
+	comp->setInnerConeAngle(innerConeAngle);
+
+	ImGui::PopItemWidth();
 }
\ No newline at end of file
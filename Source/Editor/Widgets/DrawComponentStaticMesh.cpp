@@ -31,7 +31,7 @@ void drawStaticMeshSelect(std::shared_ptr<SceneNode> node, std::shared_ptr<Stati
 			const auto& meshMap = map.at(size_t(EAssetType::StaticMesh));
 			for (const auto& meshId : meshMap)
 			{
-				if (ImGui::MenuItem(AssetRegistryManager::get()->getHeaderMap().at(meshId)->getName().c_str()))
+				if (ImGui::MenuItem(AssetRegistryManager::get()->getAssetName(meshId).c_str()))
 				{
 					comp->setMeshUUID(meshId);
 				}
@@ -55,6 +55,36 @@ void MainMenu::buildFilesCommand()
 
     ImGui::Separator();
 
+    static const std::string sOpenSceneName = MAINMENU_GNoneIcon + "    Open  Scene ";
+    if (ImGui::MenuItem(sOpenSceneName.c_str(), NULL, false, true))
+    {
+        nfdchar_t* readPath = NULL;
+        if (NFD_OpenDialog("scene", NULL, &readPath) == NFD_OKAY)
+        {
+            GEngine->getRuntimeModule<SceneManager>()->loadScene(readPath);
+            free(readPath);
+        }
+    }
+
+    static const std::string sSaveSceneName = MAINMENU_GNoneIcon + "    Save  Scene ";
+    if (ImGui::MenuItem(sSaveSceneName.c_str(), NULL, false, true))
+    {
+        nfdchar_t* savePath = NULL;
+        if (NFD_SaveDialog("scene", NULL, &savePath) == NFD_OKAY)
+        {
+            std::filesystem::path fp{ savePath };
+            free(savePath);
+
+            if (fp.extension() != SceneArchive::kFileExtension)
+            {
+                fp += SceneArchive::kFileExtension;
+            }
+            GEngine->getRuntimeModule<SceneManager>()->saveScene(fp);
+        }
+    }
+
+    ImGui::Separator();
+
     static const std::string sExitName = MAINMENU_GCloseIcon + "    Exit  ";
     if (ImGui::MenuItem(sExitName.c_str(), NULL, false, true))
     {
@@ -0,0 +1,180 @@
+#include "Pch.h"
+#include "Profiler.h"
+#include "../Editor.h"
+
+using namespace Flower;
+using namespace Flower::UI;
+
+static const std::string PROFILER_Icon = ICON_FA_CHART_BAR;
+
+WidgetProfiler::WidgetProfiler()
+	: Widget("  " + PROFILER_Icon + "  Profiler")
+{
+
+}
+
+WidgetProfiler::~WidgetProfiler() noexcept
+{
+
+}
+
+void WidgetProfiler::onInit()
+{
+
+}
+
+void WidgetProfiler::onRelease()
+{
+
+}
+
+void WidgetProfiler::onTick(const RuntimeModuleTickData& tickData)
+{
+
+}
+
+void WidgetProfiler::onVisibleTick(const RuntimeModuleTickData& tickData)
+{
+	auto* profiler = GFrameProfiler::get();
+	const auto& history = profiler->getHistory();
+
+	bool bPause = profiler->isPause();
+	if (ImGui::Checkbox("Pause", &bPause))
+	{
+		profiler->setPause(bPause);
+	}
+	ImGui::SameLine();
+	if (ImGui::Button("Export Trace"))
+	{
+		profiler->exportChromeTrace("profile.json");
+	}
+	ImGui::SameLine();
+	ImGui::TextDisabled("Dropped events: %llu", (unsigned long long)profiler->getDroppedCount());
+
+	if (!profiler->isEnable())
+	{
+		ImGui::TextDisabled("Profiler disabled, set r.Profiler.Enable to 1.");
+		return;
+	}
+
+	if (history.empty())
+	{
+		return;
+	}
+
+	const int32_t maxOffset = int32_t(history.size()) - 1;
+	m_frameOffset = glm::clamp(m_frameOffset, 0, maxOffset);
+
+	ImGui::PushItemWidth(200.0f);
+	ImGui::SliderInt("Frame Offset", &m_frameOffset, 0, maxOffset);
+	ImGui::SameLine();
+	ImGui::SliderFloat("Zoom", &m_zoom, 1.0f, 32.0f, "%.1f", ImGuiSliderFlags_Logarithmic);
+	ImGui::PopItemWidth();
+
+	const auto& frame = history[history.size() - 1 - m_frameOffset];
+	ImGui::Text("Frame %llu : %.3f ms, %u cpu events.",
+		(unsigned long long)frame.frameIndex,
+		double(frame.endNs - frame.startNs) * 1e-6,
+		(uint32_t)frame.cpuEvents.size());
+
+	ImGui::Separator();
+	drawTimeline(frame);
+}
+
+void WidgetProfiler::drawTimeline(const ProfileFrame& frame)
+{
+	auto* profiler = GFrameProfiler::get();
+	const auto& history = profiler->getHistory();
+
+	const float rowHeight = ImGui::GetTextLineHeight() + 4.0f;
+	const float labelWidth = 160.0f;
+
+	// Gpu events resolve some frames late, collect all events overlap this frame window.
+	std::map<std::string, std::vector<const GPUProfileEvent*>> gpuTracks;
+	for (const auto& historyFrame : history)
+	{
+		for (const auto& event : historyFrame.gpuEvents)
+		{
+			if (event.endNs > frame.startNs && event.startNs < frame.endNs)
+			{
+				gpuTracks[event.track].push_back(&event);
+			}
+		}
+	}
+
+	std::map<uint32_t, std::vector<const ProfileEvent*>> cpuThreads;
+	for (const auto& event : frame.cpuEvents)
+	{
+		cpuThreads[event.threadId].push_back(&event);
+	}
+
+	ImGui::BeginChild("ProfilerTimeline", ImVec2(0, 0), false, ImGuiWindowFlags_HorizontalScrollbar);
+
+	const float timelineWidth = std::max(100.0f, (ImGui::GetContentRegionAvail().x - labelWidth) * m_zoom);
+	const double frameDurationNs = double(std::max(frame.endNs - frame.startNs, uint64_t(1)));
+
+	ImDrawList* drawList = ImGui::GetWindowDrawList();
+	ImVec2 cursor = ImGui::GetCursorScreenPos();
+
+	auto drawEvent = [&](const char* name, uint64_t startNs, uint64_t endNs, float rowY, ImU32 color)
+	{
+		const double startT = (double(startNs) - double(frame.startNs)) / frameDurationNs;
+		const double endT = (double(endNs) - double(frame.startNs)) / frameDurationNs;
+
+		const float x0 = cursor.x + labelWidth + float(glm::clamp(startT, 0.0, 1.0)) * timelineWidth;
+		const float x1 = cursor.x + labelWidth + float(glm::clamp(endT, 0.0, 1.0)) * timelineWidth;
+		const ImVec2 minPos(x0, rowY);
+		const ImVec2 maxPos(std::max(x1, x0 + 1.0f), rowY + rowHeight - 1.0f);
+
+		drawList->AddRectFilled(minPos, maxPos, color, 2.0f);
+		if (maxPos.x - minPos.x > ImGui::CalcTextSize(name).x + 4.0f)
+		{
+			drawList->AddText(ImVec2(minPos.x + 2.0f, minPos.y + 1.0f), IM_COL32(255, 255, 255, 255), name);
+		}
+
+		if (ImGui::IsMouseHoveringRect(minPos, maxPos))
+		{
+			ImGui::SetTooltip("%s : %.3f ms", name, double(endNs - startNs) * 1e-6);
+		}
+	};
+
+	auto labelColor = [](const char* name, bool bGPU)
+	{
+		// Stable color per name.
+		const size_t hash = std::hash<std::string_view>{}(name);
+		const uint8_t r = uint8_t(60 + (hash & 0x7F));
+		const uint8_t g = uint8_t(60 + ((hash >> 8) & 0x7F));
+		const uint8_t b = uint8_t(60 + ((hash >> 16) & 0x7F));
+		return bGPU ? IM_COL32(r / 2 + 60, g / 2 + 40, b / 3, 255) : IM_COL32(r, g, b, 255);
+	};
+
+	float rowY = cursor.y;
+	for (const auto& [threadId, events] : cpuThreads)
+	{
+		uint32_t threadDepth = 0;
+		for (const auto* event : events)
+		{
+			drawEvent(event->name, event->startNs, event->endNs, rowY + event->depth * rowHeight, labelColor(event->name, false));
+			threadDepth = std::max(threadDepth, event->depth);
+		}
+
+		drawList->AddText(ImVec2(cursor.x, rowY), ImGui::GetColorU32(ImGuiCol_Text), profiler->getThreadName(threadId).c_str());
+		rowY += (threadDepth + 1) * rowHeight + 4.0f;
+	}
+
+	for (const auto& [track, events] : gpuTracks)
+	{
+		for (const auto* event : events)
+		{
+			drawEvent(event->name.c_str(), event->startNs, event->endNs, rowY, labelColor(event->name.c_str(), true));
+		}
+
+		const std::string trackName = "GPU " + track;
+		drawList->AddText(ImVec2(cursor.x, rowY), ImGui::GetColorU32(ImGuiCol_Text), trackName.c_str());
+		rowY += rowHeight + 4.0f;
+	}
+
+	// Reserve space for scroll.
+	ImGui::Dummy(ImVec2(labelWidth + timelineWidth, rowY - cursor.y));
+	ImGui::EndChild();
+}
@@ -0,0 +1,31 @@
+#pragma once
+#include "Pch.h"
+#include "Widget.h"
+
+class WidgetProfiler : public Widget
+{
+public:
+	WidgetProfiler();
+	virtual ~WidgetProfiler() noexcept;
+
+protected:
+	// event init.
+	virtual void onInit() override;
+
+	// event always tick.
+	virtual void onTick(const Flower::RuntimeModuleTickData& tickData) override;
+
+	// event release.
+	virtual void onRelease() override;
+
+	// event when widget visible tick.
+	virtual void onVisibleTick(const Flower::RuntimeModuleTickData& tickData) override;
+
+private:
+	void drawTimeline(const Flower::ProfileFrame& frame);
+
+private:
+	// Frame offset from latest history frame.
+	int32_t m_frameOffset = 0;
+	float m_zoom = 1.0f;
+};
@@ -117,7 +117,7 @@ void WidgetRenderSetting::onVisibleTick(const RuntimeModuleTickData& tickData)
 				const auto& texMap = map.at(size_t(EAssetType::Texture));
 				for (const auto& texId : texMap)
 				{
-					std::shared_ptr<ImageAssetHeader> tex = std::dynamic_pointer_cast<ImageAssetHeader>(AssetRegistryManager::get()->getHeaderMap().at(texId));
+					std::shared_ptr<ImageAssetHeader> tex = AssetRegistryManager::get()->getHeader<ImageAssetHeader>(texId);
 					if (tex->isHdr())
 					{
 						if (ImGui::MenuItem(tex->getName().c_str()))
@@ -210,6 +210,20 @@ void WidgetSceneOutliner::setSelectedNode(std::weak_ptr<Flower::SceneNode> node)
 {
 	m_bExpandToSelection = true;
 	m_selectedNode = node;
+	m_selectionGeneration++;
+}
+
+bool WidgetSceneOutliner::getContentGeneration(uint64_t& outGeneration) const
+{
+	if (m_scene == nullptr || m_bRenameing || m_bExpandToSelection)
+	{
+		return false;
+	}
+
+	// Hover, click and drag only happen when window no idle, so only scene edit and outside select matter.
+	outGeneration = hashCombine(size_t(m_scene), m_scene->getEditGeneration());
+	outGeneration = hashCombine(outGeneration, m_selectionGeneration);
+	return true;
 }
 
 void WidgetSceneOutliner::handleEvent()
@@ -330,6 +344,11 @@ void WidgetSceneOutliner::popupMenu()
 			newNode->getTransform()->setRotation(glm::quat(glm::radians(glm::vec3(45, 45, 0))));
 			newNode->getScene()->addComponent<SpotLightComponent>(std::make_shared<SpotLightComponent>(), newNode);
 		}
+		if (ImGui::MenuItem(GIconPointLight.c_str()))
+		{
+			auto newNode = m_scene->createNode("PointLight", node);
+			newNode->getScene()->addComponent<PointLightComponent>(std::make_shared<PointLightComponent>(), newNode);
+		}
 
 		ImGui::EndPopup();
 	}
@@ -9,6 +9,8 @@ public:
 	WidgetSceneOutliner();
 	virtual ~WidgetSceneOutliner() noexcept;
 
+	void setSelectedNode(std::weak_ptr<Flower::SceneNode> node);
+
 protected:
 	// event init.
 	virtual void onInit() override;
@@ -22,9 +24,9 @@ protected:
 	// event when widget visible tick.
 	virtual void onVisibleTick(const Flower::RuntimeModuleTickData&) override;
 
-	void drawSceneNode(std::shared_ptr<Flower::SceneNode> node);
+	virtual bool getContentGeneration(uint64_t& outGeneration) const override;
 
-	void setSelectedNode(std::weak_ptr<Flower::SceneNode> node);
+	void drawSceneNode(std::shared_ptr<Flower::SceneNode> node);
 
 	void handleEvent();
 
@@ -58,6 +60,7 @@ private:
 
 	// Scene outliner select node.
 	std::weak_ptr<Flower::SceneNode> m_selectedNode;
+	uint64_t m_selectionGeneration = 0;
 
 	// Rename input buffer.
 	char m_inputBuffer[32];
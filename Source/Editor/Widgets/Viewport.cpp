@@ -1,5 +1,6 @@
 #include "Pch.h"
 #include "Viewport.h"
+#include "../Editor.h"
 
 using namespace Flower;
 using namespace Flower::UI;
@@ -22,6 +23,14 @@ static AutoCVarInt32 cVarEnableStatFrameGraph(
 	CVarFlags::ReadAndWrite
 );
 
+static AutoCVarInt32 cVarEnableStatMemory(
+	"stat.memory",
+	"Enable stat gpu memory budget.",
+	"stat",
+	0,
+	CVarFlags::ReadAndWrite
+);
+
 WidgetViewport::WidgetViewport()
 	: Widget("  " + VIERPORT_GViewportTileIcon + "  Viewport")
 {
@@ -92,6 +101,14 @@ void WidgetViewport::onVisibleTick(const RuntimeModuleTickData& tickData)
 	ImVec2 startPos = ImGui::GetCursorPos();
 	ImGui::Image(m_descriptorSet, ImVec2(width, height));
 	m_bMouseInViewport = ImGui::IsItemHovered();
+
+	// Camera move use right button, left click free for pick.
+	if (m_bMouseInViewport && ImGui::IsMouseClicked(ImGuiMouseButton_Left))
+	{
+		const ImVec2 itemMin = ImGui::GetItemRectMin();
+		const ImVec2 mousePos = ImGui::GetMousePos();
+		pickNode(glm::vec2((mousePos.x - itemMin.x) / width, (mousePos.y - itemMin.y) / height));
+	}
 	m_camera->tick(tickData);
 
 
@@ -128,6 +145,25 @@ void WidgetViewport::onVisibleTick(const RuntimeModuleTickData& tickData)
 				ImGui::Text("Resolution : %ix%i", (int32_t)width, (int32_t)height);
 				ImGui::Text("FPS : %d (%.2f ms)", fps, frameTime_ms);
 
+				const auto& recordTimings = m_renderer->getRecordTimings();
+				ImGui::Text("CPU Record : World %.2f ms, UI %.2f ms%s", 
+					recordTimings.worldMicroseconds * 0.001f, 
+					recordTimings.uiMicroseconds * 0.001f,
+					recordTimings.bParallel ? " (Parallel)" : "");
+
+				const auto* renderScene = m_renderer->getRenderScene();
+				const uint32_t staticMeshCount = uint32_t(renderScene->getCollectStaticMeshes().size());
+				if (renderScene->isInstancingEnable())
+				{
+					const auto& instanceBatches = renderScene->getInstanceBatches();
+					ImGui::Text("Static Mesh : %u objects, %u batches, %u draw commands", 
+						staticMeshCount, uint32_t(instanceBatches.batches.size()), instanceBatches.getDrawCommandCount());
+				}
+				else
+				{
+					ImGui::Text("Static Mesh : %u objects, %u draw commands", staticMeshCount, staticMeshCount);
+				}
+
 				for (uint32_t i = 0; i < timeStamps.size(); i++)
 				{
 					float value = m_profileViewer.bShowMilliseconds ? timeStamps[i].microseconds / 1000.0f : timeStamps[i].microseconds;
@@ -196,6 +232,45 @@ void WidgetViewport::onVisibleTick(const RuntimeModuleTickData& tickData)
 		ImGui::SetCursorPos(srcPos);
 		frameGraphView();
 	}
+
+	if (cVarEnableStatMemory.get() > 0)
+	{
+		const auto& stats = MemoryBudget::get()->getStats();
+		auto toMB = [](uint64_t size) { return float(double(size) / (1024.0 * 1024.0)); };
+
+		auto memoryView = [&]()
+		{
+			ImGui::BeginGroupPanel("Memory Budget");
+			{
+				ImGui::Text("Device : %.1f / %.1f MB", toMB(stats.deviceUsage), toMB(stats.deviceBudget));
+				ImGui::Text("Engine Budget : %.1f MB", toMB(stats.engineBudget));
+				ImGui::Text("Untracked : %.1f MB", toMB(stats.untrackedUsage));
+
+				for (size_t i = 0; i < stats.categories.size(); i++)
+				{
+					const auto& category = stats.categories[i];
+					ImGui::Text("%s : %.1f / %.1f MB", getMemoryBudgetCategoryName(EMemoryBudgetCategory(i)), toMB(category.usage), toMB(category.budget));
+					if (category.evictCount > 0)
+					{
+						ImGui::SameLine();
+						ImGui::TextColored(ImVec4(1.0f, 0.5f, 0.2f, 1.0f), "evict %u (%.1f MB)", category.evictCount, toMB(category.evictSize));
+					}
+				}
+			}
+			ImGui::Spacing();
+			ImGui::EndGroupPanel();
+		};
+
+		const auto srcPos = ImGui::GetCursorPos();
+		ImGui::PushStyleVar(ImGuiStyleVar_Alpha, 0.0f);
+		ImGui::BeginDisabled();
+		memoryView();
+		ImGui::EndDisabled();
+		ImGui::PopStyleVar();
+		ImGui::GetWindowDrawList()->AddRectFilled(ImGui::GetItemRectMin(), ImGui::GetItemRectMax(), IM_COL32(0, 0, 0, 139), 2.0f);
+		ImGui::SetCursorPos(srcPos);
+		memoryView();
+	}
 	
 	ImGui::Unindent();
 }
@@ -221,4 +296,32 @@ void WidgetViewport::tryReleaseDescriptorSet(uint64_t tickTime)
 			++it;
 		}
 	}
-}
\ No newline at end of file
+}
+
+void WidgetViewport::pickNode(const glm::vec2& uv)
+{
+	auto* scene = GEngine->getRuntimeModule<SceneManager>()->getScenes();
+
+	const glm::mat4 invViewProj = glm::inverse(m_camera->getProjectMatrix() * m_camera->getViewMatrix());
+	const glm::vec2 ndc = glm::vec2(uv.x * 2.0f - 1.0f, 1.0f - uv.y * 2.0f);
+	auto unproject = [&](float deviceZ)
+	{
+		const glm::vec4 pos = invViewProj * glm::vec4(ndc, deviceZ, 1.0f);
+		return glm::vec3(pos) / pos.w;
+	};
+
+	// Reverse z, device z 1 is near plane.
+	const glm::vec3 nearPos = unproject(1.0f);
+	const glm::vec3 farPos = unproject(0.0f);
+
+	BVHRay ray;
+	ray.origin = nearPos;
+	ray.direction = glm::normalize(farPos - nearPos);
+	ray.tMax = glm::length(farPos - nearPos);
+
+	SceneBVH::RayHit hit;
+	if (scene->getBVH()->raycast(ray, hit))
+	{
+		GEditor->getSceneOutliner()->setSelectedNode(hit.node);
+	}
+}
@@ -91,6 +91,9 @@ private:
 
 	void tryReleaseDescriptorSet(uint64_t tickTime);
 
+	// Pick static mesh node under viewport uv.
+	void pickNode(const glm::vec2& uv);
+
 
 	ProfilerViewer m_profileViewer;
 
@@ -48,9 +48,23 @@ void Widget::tick(const RuntimeModuleTickData& tickData)
 		ImGui::SetNextWindowSize(ImVec2(520, 600), ImGuiCond_FirstUseEver);
 		if (ImGui::Begin(getTile().c_str(), &m_bShow))
 		{
-			ImGui::PushID(getTile().c_str());
-			onVisibleTick(tickData);
-			ImGui::PopID();
+			uint64_t contentGeneration = 0;
+			const bool bRetainable = getContentGeneration(contentGeneration);
+
+			if (!bRetainable || !m_retainedWindow.tryReplay(contentGeneration))
+			{
+				m_retainedWindow.beginCapture(bRetainable, contentGeneration);
+
+				ImGui::PushID(getTile().c_str());
+				onVisibleTick(tickData);
+				ImGui::PopID();
+
+				m_retainedWindow.endCapture();
+			}
+		}
+		else
+		{
+			m_retainedWindow.invalidate();
 		}
 
 		ImGui::End();
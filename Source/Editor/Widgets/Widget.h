@@ -8,6 +8,9 @@ private:
 	bool m_bLastShow;
 	Flower::DelegateHandle m_tickFunctionHandle;
 
+	// Cache visible tick draw output, replay when widget idle.
+	Flower::RetainedWindow m_retainedWindow;
+
 protected:
 	bool m_bShow;
 	Flower::Renderer* m_renderer;
@@ -59,4 +62,8 @@ protected:
 
 	// event when widget visible tick.
 	virtual void onVisibleTick(const Flower::RuntimeModuleTickData& tickData) {  }
+
+	// event query content generation, return false if widget content can't retain.
+	// When window idle and generation no change, skip visible tick and replay last draw output.
+	virtual bool getContentGeneration(uint64_t& outGeneration) const { return false; }
 };
\ No newline at end of file
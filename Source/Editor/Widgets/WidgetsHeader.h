@@ -9,4 +9,5 @@
 #include "Detail.h"
 #include "ProjectSelect.h"
 #include "ContentViewer.h"
-#include "RenderSetting.h"
\ No newline at end of file
+#include "RenderSetting.h"
+#include "Profiler.h"
\ No newline at end of file
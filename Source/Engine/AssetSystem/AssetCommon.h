@@ -14,6 +14,7 @@ namespace Flower
 		StaticMesh = 0,
 		Texture,
 		Material,
+		Heightmap,
 		Max
 	};
 
@@ -129,6 +130,12 @@ namespace Flower
 
 		}
 
+		// Header uuids this asset reference, store in project index.
+		virtual void getDependencies(std::vector<AssetHeaderUUID>& outDependencies) const
+		{
+
+		}
+
 		void freeBinData()
 		{
 			m_cacheBinData = nullptr;
@@ -0,0 +1,248 @@
+#include "Pch.h"
+#include "AssetIndex.h"
+#include "../Core/MappedFile.h"
+
+namespace Flower
+{
+	using namespace AssetIndexFile;
+
+	namespace
+	{
+		constexpr uint64_t kSectionAlignment = 16;
+
+		inline uint64_t alignSection(uint64_t offset)
+		{
+			return (offset + kSectionAlignment - 1) & ~(kSectionAlignment - 1);
+		}
+
+		// Record may no align in file, copy out.
+		template<typename T>
+		inline T readRecord(const uint8_t* base, uint64_t index)
+		{
+			T result;
+			std::memcpy(&result, base + sizeof(T) * index, sizeof(T));
+			return result;
+		}
+	}
+
+	void AssetIndexEntry::fill(const AssetHeaderInterface& inHeader)
+	{
+		type = inHeader.getType();
+		name = inHeader.getName();
+		binUUID = inHeader.getBinUUID();
+
+		dependencies.clear();
+		inHeader.getDependencies(dependencies);
+	}
+
+	bool AssetIndex::getFileState(const std::filesystem::path& path, uint64_t& outFileSize, int64_t& outWriteTime)
+	{
+		std::error_code ec;
+		const auto fileSize = std::filesystem::file_size(path, ec);
+		if (ec)
+		{
+			return false;
+		}
+
+		const auto writeTime = std::filesystem::last_write_time(path, ec);
+		if (ec)
+		{
+			return false;
+		}
+
+		outFileSize = uint64_t(fileSize);
+		outWriteTime = int64_t(writeTime.time_since_epoch().count());
+		return true;
+	}
+
+	bool AssetIndex::getFileState(const std::filesystem::directory_entry& entry, uint64_t& outFileSize, int64_t& outWriteTime)
+	{
+		// Directory entry cache state when iterate on windows, no extra file system call.
+		std::error_code ec;
+		const auto fileSize = entry.file_size(ec);
+		if (ec)
+		{
+			return false;
+		}
+
+		const auto writeTime = entry.last_write_time(ec);
+		if (ec)
+		{
+			return false;
+		}
+
+		outFileSize = uint64_t(fileSize);
+		outWriteTime = int64_t(writeTime.time_since_epoch().count());
+		return true;
+	}
+
+	bool AssetIndex::save(const AssetIndexMap& entries, const std::filesystem::path& path)
+	{
+		std::vector<Record> records;
+		std::vector<StringRef> dependencies;
+		std::string strings;
+
+		records.reserve(entries.size());
+
+		auto addString = [&](const std::string& str)
+		{
+			StringRef ref{ uint32_t(strings.size()), uint32_t(str.size()) };
+			strings += str;
+			return ref;
+		};
+
+		for (const auto& [uuid, entry] : entries)
+		{
+			Record record{};
+			record.headerUUID = addString(uuid);
+			record.binUUID = addString(entry.binUUID);
+			record.name = addString(entry.name);
+			record.type = uint32_t(entry.type);
+			record.dependencyStart = uint32_t(dependencies.size());
+			record.dependencyCount = uint32_t(entry.dependencies.size());
+			record.headerFileSize = entry.headerFileSize;
+			record.headerWriteTime = entry.headerWriteTime;
+
+			for (const auto& dependency : entry.dependencies)
+			{
+				dependencies.push_back(addString(dependency));
+			}
+
+			records.push_back(record);
+		}
+
+		// Layout: header | records | dependencies | strings.
+		Header header{};
+		header.magic = kMagic;
+		header.version = kVersion;
+		header.recordCount = uint32_t(records.size());
+		header.dependencyCount = uint32_t(dependencies.size());
+		header.recordOffset = alignSection(sizeof(Header));
+		header.dependencyOffset = alignSection(header.recordOffset + records.size() * sizeof(Record));
+		header.stringOffset = alignSection(header.dependencyOffset + dependencies.size() * sizeof(StringRef));
+		header.stringSize = strings.size();
+
+		std::vector<uint8_t> fileData(header.stringOffset + header.stringSize, 0);
+		auto writeBytes = [&](uint64_t dest, const void* src, size_t size)
+		{
+			if (size > 0)
+			{
+				std::memcpy(fileData.data() + dest, src, size);
+			}
+		};
+
+		writeBytes(0, &header, sizeof(Header));
+		writeBytes(header.recordOffset, records.data(), records.size() * sizeof(Record));
+		writeBytes(header.dependencyOffset, dependencies.data(), dependencies.size() * sizeof(StringRef));
+		writeBytes(header.stringOffset, strings.data(), strings.size());
+
+		std::ofstream os(path, std::ios::binary | std::ios::trunc);
+		if (!os.is_open())
+		{
+			LOG_ERROR("Can't open asset index file {0} to save.", path.string());
+			return false;
+		}
+		os.write(reinterpret_cast<const char*>(fileData.data()), std::streamsize(fileData.size()));
+		if (!os)
+		{
+			LOG_ERROR("Write asset index file {0} fail.", path.string());
+			return false;
+		}
+
+		return true;
+	}
+
+	bool AssetIndex::load(const std::filesystem::path& path, AssetIndexMap& outEntries)
+	{
+		if (!std::filesystem::exists(path))
+		{
+			return false;
+		}
+
+		MappedFile file;
+		if (!file.open(path))
+		{
+			return false;
+		}
+
+		const uint8_t* data = file.data();
+		const uint64_t fileSize = file.size();
+
+		auto inRange = [&](uint64_t offset, uint64_t size)
+		{
+			return offset <= fileSize && size <= fileSize - offset;
+		};
+
+		if (!inRange(0, sizeof(Header)))
+		{
+			LOG_WARN("Asset index file {0} too small, fallback to scan headers.", path.string());
+			return false;
+		}
+
+		const Header header = readRecord<Header>(data, 0);
+		if (header.magic != kMagic || header.version != kVersion)
+		{
+			LOG_WARN("Asset index file {0} magic or version mismatch, fallback to scan headers.", path.string());
+			return false;
+		}
+		if (!inRange(header.recordOffset, uint64_t(header.recordCount) * sizeof(Record))
+			|| !inRange(header.dependencyOffset, uint64_t(header.dependencyCount) * sizeof(StringRef))
+			|| !inRange(header.stringOffset, header.stringSize))
+		{
+			LOG_WARN("Asset index file {0} section out of range, fallback to scan headers.", path.string());
+			return false;
+		}
+
+		const uint8_t* recordData = data + header.recordOffset;
+		const uint8_t* dependencyData = data + header.dependencyOffset;
+		const char* strings = reinterpret_cast<const char*>(data + header.stringOffset);
+
+		bool bValid = true;
+		auto readString = [&](const StringRef& ref)
+		{
+			if (uint64_t(ref.offset) + ref.size > header.stringSize)
+			{
+				bValid = false;
+				return std::string{};
+			}
+			return std::string(strings + ref.offset, ref.size);
+		};
+
+		AssetIndexMap entries;
+		entries.reserve(header.recordCount);
+		for (uint32_t i = 0; i < header.recordCount && bValid; i++)
+		{
+			const Record record = readRecord<Record>(recordData, i);
+			if (record.type >= uint32_t(EAssetType::Max)
+				|| uint64_t(record.dependencyStart) + record.dependencyCount > header.dependencyCount)
+			{
+				bValid = false;
+				break;
+			}
+
+			AssetIndexEntry entry{};
+			entry.type = EAssetType(record.type);
+			entry.name = readString(record.name);
+			entry.binUUID = readString(record.binUUID);
+			entry.headerFileSize = record.headerFileSize;
+			entry.headerWriteTime = record.headerWriteTime;
+
+			entry.dependencies.reserve(record.dependencyCount);
+			for (uint32_t j = 0; j < record.dependencyCount; j++)
+			{
+				entry.dependencies.push_back(readString(readRecord<StringRef>(dependencyData, record.dependencyStart + j)));
+			}
+
+			entries.emplace(readString(record.headerUUID), std::move(entry));
+		}
+
+		if (!bValid)
+		{
+			LOG_WARN("Asset index file {0} record invalid, fallback to scan headers.", path.string());
+			return false;
+		}
+
+		outEntries = std::move(entries);
+		return true;
+	}
+}
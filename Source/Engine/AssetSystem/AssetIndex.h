@@ -0,0 +1,94 @@
+#pragma once
+#include "AssetCommon.h"
+
+namespace Flower
+{
+	// Project index file layout, all section offsets relate to file begin.
+	// One fixed size record per asset, so project open read whole table in place without deserialize any header.
+	namespace AssetIndexFile
+	{
+		constexpr uint32_t kMagic = 0x58444946; // "FIDX"
+		constexpr uint32_t kVersion = 1;
+
+		struct Header
+		{
+			uint32_t magic;
+			uint32_t version;
+			uint32_t recordCount;
+			uint32_t dependencyCount;
+
+			uint64_t recordOffset;
+			uint64_t dependencyOffset;
+			uint64_t stringOffset;
+			uint64_t stringSize;
+		};
+		static_assert(sizeof(Header) == 48);
+
+		// String in string table, no null terminate.
+		struct StringRef
+		{
+			uint32_t offset;
+			uint32_t size;
+		};
+
+		struct Record
+		{
+			StringRef headerUUID;
+			StringRef binUUID;
+			StringRef name;
+
+			uint32_t type;
+
+			// Range in dependency table, each dependency is one StringRef of header uuid.
+			uint32_t dependencyStart;
+			uint32_t dependencyCount;
+			uint32_t pad;
+
+			// Header file state when record write, differ from disk meaning record stale.
+			uint64_t headerFileSize;
+			int64_t headerWriteTime;
+		};
+		static_assert(sizeof(Record) == 56);
+	}
+
+	// Light asset info resident for every asset after project open.
+	// Full header deserialize lazy on first access.
+	struct AssetIndexEntry
+	{
+		EAssetType type = EAssetType::Max;
+		std::string name;
+		AssetBinUUID binUUID;
+		std::vector<AssetHeaderUUID> dependencies;
+
+		uint64_t headerFileSize = 0;
+		int64_t headerWriteTime = 0;
+
+		// Nullptr until first access.
+		std::shared_ptr<AssetHeaderInterface> header = nullptr;
+
+		// Refresh info from header.
+		void fill(const AssetHeaderInterface& inHeader);
+
+		bool sameFileState(uint64_t fileSize, int64_t writeTime) const
+		{
+			return headerFileSize == fileSize && headerWriteTime == writeTime;
+		}
+	};
+
+	using AssetIndexMap = std::unordered_map<AssetHeaderUUID, AssetIndexEntry>;
+
+	class AssetIndex
+	{
+	public:
+		static constexpr const char* kFileName = "Registry.index";
+
+		static bool save(const AssetIndexMap& entries, const std::filesystem::path& path);
+
+		// Return false if file no exist or invalid, out map only change when success.
+		static bool load(const std::filesystem::path& path, AssetIndexMap& outEntries);
+
+		// Size and last write time of header file, return false if file no exist.
+		static bool getFileState(const std::filesystem::path& path, uint64_t& outFileSize, int64_t& outWriteTime);
+		static bool getFileState(const std::filesystem::directory_entry& entry, uint64_t& outFileSize, int64_t& outWriteTime);
+	};
+}
@@ -3,6 +3,8 @@
 #include "TextureManager.h"
 #include "AssetSystem.h"
 #include "MeshManager.h"
+#include "MaterialManager.h"
+#include "LandscapeManager.h"
 
 
 namespace Flower
@@ -24,8 +26,109 @@ namespace Flower
 	void AssetRegistry::registerAssetMap(std::shared_ptr<AssetHeaderInterface> asset, EAssetType type)
 	{
 		std::unique_lock lock(m_assetMapMutex);
-		m_assetMap[asset->getHeaderUUID()] = asset;
+
+		auto& entry = m_assetMap[asset->getHeaderUUID()];
+		entry.fill(*asset);
+		entry.header = asset;
+
 		m_assetTypeSet[size_t(type)].insert(asset->getHeaderUUID());
+		m_bIndexDirty = true;
+	}
+
+	std::shared_ptr<AssetHeaderInterface> AssetRegistry::loadHeaderFile(const std::filesystem::path& path)
+	{
+		std::shared_ptr<AssetHeaderInterface> header = nullptr;
+		try
+		{
+			std::ifstream is(path, std::ios::binary);
+			cereal::BinaryInputArchive archive(is);
+			archive(header);
+		}
+		catch (const cereal::Exception& e)
+		{
+			LOG_WARN("Header file {0} deserialize fail: {1}.", path.string(), e.what());
+			return nullptr;
+		}
+
+		// Same as disk, no need to save again.
+		if (header)
+		{
+			header->setDirty(false);
+		}
+		return header;
+	}
+
+	std::shared_ptr<AssetHeaderInterface> AssetRegistry::getHeader(const AssetHeaderUUID& uuid)
+	{
+		{
+			std::unique_lock lock(m_assetMapMutex);
+			auto it = m_assetMap.find(uuid);
+			if (it == m_assetMap.end())
+			{
+				return nullptr;
+			}
+			else if (it->second.header)
+			{
+				return it->second.header;
+			}
+		}
+
+		// Deserialize out of lock, when other thread load same header at the same time first one win.
+		auto header = loadHeaderFile(m_headerFolderPath / uuid);
+
+		std::unique_lock lock(m_assetMapMutex);
+		auto it = m_assetMap.find(uuid);
+		if (it == m_assetMap.end())
+		{
+			return nullptr;
+		}
+
+		if (!it->second.header)
+		{
+			if (header && header->getHeaderUUID() == uuid)
+			{
+				it->second.header = header;
+			}
+			else
+			{
+				LOG_ERROR("Asset {0} header file missing or broken.", uuid);
+			}
+		}
+		return it->second.header;
+	}
+
+	bool AssetRegistry::containsAsset(const AssetHeaderUUID& uuid)
+	{
+		std::unique_lock lock(m_assetMapMutex);
+		return m_assetMap.contains(uuid);
+	}
+
+	std::string AssetRegistry::getAssetName(const AssetHeaderUUID& uuid)
+	{
+		std::unique_lock lock(m_assetMapMutex);
+		auto it = m_assetMap.find(uuid);
+		return it != m_assetMap.end() ? it->second.name : std::string{};
+	}
+
+	EAssetType AssetRegistry::getAssetType(const AssetHeaderUUID& uuid)
+	{
+		std::unique_lock lock(m_assetMapMutex);
+		auto it = m_assetMap.find(uuid);
+		return it != m_assetMap.end() ? it->second.type : EAssetType::Max;
+	}
+
+	void AssetRegistry::saveIndex()
+	{
+		if (m_indexPath.empty())
+		{
+			return;
+		}
+
+		std::unique_lock lock(m_assetMapMutex);
+		if (AssetIndex::save(m_assetMap, m_indexPath))
+		{
+			m_bIndexDirty = false;
+		}
 	}
 
 	void AssetRegistry::save()
@@ -43,46 +146,205 @@ namespace Flower
 		const auto& binFolderPath = GEngine->getRuntimeModule<AssetSystem>()->getProjectBinFolderPath();
 		const auto& headerFolderPath = GEngine->getRuntimeModule<AssetSystem>()->getProjectHeaderFolderPath();
 
-		// Save all dirty asset header.
-		std::vector<std::future<void>> scanFutures;
-		for (auto& pair : m_assetMap)
+		// Save all dirty asset header, header no load never dirty.
+		// Snapshot under lock, map may edit by import or background check while tasks archive.
+		struct SaveItem
+		{
+			AssetHeaderUUID uuid;
+			std::shared_ptr<AssetHeaderInterface> header;
+			uint64_t headerFileSize = 0;
+			int64_t headerWriteTime = 0;
+		};
+		std::vector<SaveItem> saveItems;
 		{
-			auto& asset = pair.second;
-			if (asset->isDirty())
+			std::unique_lock lock(m_assetMapMutex);
+			for (const auto& pair : m_assetMap)
 			{
-				scanFutures.push_back(GThreadPool::get()->submit([&]()
+				if (pair.second.header && pair.second.header->isDirty())
 				{
-					if (auto binData = asset->getBinData())
-					{
-						// Archive bin file.
-						std::ofstream os(binFolderPath / binData->getBinUUID(), std::ios::binary);
-						cereal::BinaryOutputArchive archive(os);
-						archive(binData);
+					saveItems.push_back({ pair.first, pair.second.header });
+				}
+			}
+		}
 
-						asset->saveCallback();
+		TaskGroup saveTasks;
+		for (auto& item : saveItems)
+		{
+			saveTasks.run([&]()
+			{
+				auto& asset = item.header;
+				if (auto binData = asset->getBinData())
+				{
+					// Archive bin file.
+					std::ofstream os(binFolderPath / binData->getBinUUID(), std::ios::binary);
+					cereal::BinaryOutputArchive archive(os);
+					archive(binData);
 
-						// Release owner bin file after archive.
-						asset->freeBinData();
-					}
+					asset->saveCallback();
 
-					{
-						// Archive header file.
-						std::ofstream os(headerFolderPath / asset->getHeaderUUID(), std::ios::binary);
-						cereal::BinaryOutputArchive archive(os);
-						archive(asset);
-					}
+					// Release owner bin file after archive.
+					asset->freeBinData();
+				}
 
-					// After self archive, mark undirty.
-					asset->setDirty(false);
-				}));
-			}
+				const auto headerPath = headerFolderPath / asset->getHeaderUUID();
+				{
+					// Archive header file.
+					std::ofstream os(headerPath, std::ios::binary);
+					cereal::BinaryOutputArchive archive(os);
+					archive(asset);
+				}
+
+				// After self archive, mark undirty.
+				asset->setDirty(false);
+				AssetIndex::getFileState(headerPath, item.headerFileSize, item.headerWriteTime);
+			});
 		}
+		saveTasks.wait();
 
-		for (auto& future : scanFutures)
+		// Refresh index info of entries still own the saved header.
+		const bool bAnyHeaderSave = !saveItems.empty();
+		if (bAnyHeaderSave)
 		{
-			future.wait();
+			std::unique_lock lock(m_assetMapMutex);
+			for (const auto& item : saveItems)
+			{
+				auto it = m_assetMap.find(item.uuid);
+				if (it != m_assetMap.end() && it->second.header == item.header)
+				{
+					it->second.fill(*item.header);
+					it->second.headerFileSize = item.headerFileSize;
+					it->second.headerWriteTime = item.headerWriteTime;
+				}
+			}
 		}
+
 		m_bDirty = false;
+
+		if (bAnyHeaderSave || m_bIndexDirty)
+		{
+			saveIndex();
+		}
+	}
+
+	bool AssetRegistry::loadProject(
+		const std::filesystem::path& registryPath,
+		const std::filesystem::path& headerFolderPath,
+		bool bUseIndex,
+		std::vector<std::filesystem::path>& outInvalidPaths)
+	{
+		m_headerFolderPath = headerFolderPath;
+		m_indexPath = registryPath.parent_path() / AssetIndex::kFileName;
+
+		// Build asset entry tree.
+		{
+			std::ifstream is(registryPath, std::ios::binary);
+			cereal::BinaryInputArchive archive(is);
+			archive(m_registryEntryRoot);
+		}
+
+		if (bUseIndex && AssetIndex::load(m_indexPath, m_assetMap))
+		{
+			return true;
+		}
+
+		// No index, scan whole header folder. And fill asset map.
+		std::vector<std::filesystem::directory_entry> dirEntries;
+		for (auto const& dirEntry : std::filesystem::directory_iterator{ headerFolderPath })
+		{
+			dirEntries.push_back(dirEntry);
+		}
+
+		// Each task only write self slot, no lock.
+		std::vector<std::shared_ptr<AssetHeaderInterface>> headers(dirEntries.size());
+		GThreadPool::get()->parallelFor(0, dirEntries.size(), [&](size_t begin, size_t end)
+		{
+			for (size_t i = begin; i < end; i++)
+			{
+				auto newHeader = loadHeaderFile(dirEntries[i].path());
+				if (newHeader && newHeader->getHeaderUUID() == dirEntries[i].path().stem().string())
+				{
+					headers[i] = newHeader;
+				}
+			}
+		});
+
+		m_assetMap.clear();
+		m_assetMap.reserve(dirEntries.size());
+		for (size_t i = 0; i < dirEntries.size(); i++)
+		{
+			if (!headers[i])
+			{
+				outInvalidPaths.push_back(dirEntries[i].path());
+				continue;
+			}
+
+			auto& entry = m_assetMap[headers[i]->getHeaderUUID()];
+			entry.fill(*headers[i]);
+			entry.header = headers[i];
+			AssetIndex::getFileState(dirEntries[i], entry.headerFileSize, entry.headerWriteTime);
+		}
+
+		return false;
+	}
+
+	void AssetRegistry::pruneRegistry()
+	{
+		std::unordered_set<AssetHeaderUUID> usedAssets;
+		usedAssets.reserve(m_assetMap.size());
+
+		std::function<void(std::shared_ptr<RegistryEntry>)> loopEntry = [&](std::shared_ptr<RegistryEntry> entry)
+		{
+			// Reverse loop because remove child swap with last one.
+			auto& children = entry->getChildren();
+			for (size_t i = children.size(); i > 0; i--)
+			{
+				loopEntry(children[i - 1]);
+			}
+
+			if (entry->isLeaf())
+			{
+				// Unvalid leaf entry which store unvalid asset header id.
+				// We need to remove it.
+				if (!m_assetMap.contains(entry->getAssetHeaderID()))
+				{
+					if (auto parent = entry->getParent().lock())
+					{
+						removeChild(parent, entry, false);
+						return;
+					}
+				}
+				usedAssets.insert(entry->getAssetHeaderID());
+			}
+
+			// Also cache uuid map.
+			addEntry(entry);
+		};
+		loopEntry(m_registryEntryRoot);
+
+		// Erase unused header asset.
+		std::erase_if(m_assetMap, [&](const auto& pair)
+		{
+			if (usedAssets.contains(pair.first))
+			{
+				return false;
+			}
+
+			// Remove disk unused header file.
+			std::filesystem::remove(m_headerFolderPath / pair.first);
+
+			// Also try remove disk unused bin file.
+			if (!pair.second.binUUID.empty())
+			{
+				const auto binFilePath = m_binFolderPath / pair.second.binUUID;
+				if (std::filesystem::exists(binFilePath))
+				{
+					std::filesystem::remove(binFilePath);
+				}
+			}
+
+			m_bIndexDirty = true;
+			return true;
+		});
 	}
 
 	void AssetRegistry::setupProject(
@@ -90,123 +352,322 @@ namespace Flower
 		const std::filesystem::path& headerFolderPath,
 		const std::filesystem::path& binFolderPath)
 	{
+		const auto startTime = std::chrono::steady_clock::now();
+
+		m_headerFolderPath = headerFolderPath;
+		m_binFolderPath = binFolderPath;
+		m_indexPath = registryPath.parent_path() / AssetIndex::kFileName;
+
 		if (!std::filesystem::exists(registryPath))
 		{
 			m_registryEntryRoot = std::make_shared<RegistryEntry>();
 			std::filesystem::remove_all(headerFolderPath);
 			std::filesystem::remove_all(binFolderPath);
+			std::filesystem::remove(m_indexPath);
 			std::filesystem::create_directory(headerFolderPath);
 			std::filesystem::create_directory(binFolderPath);
 			return;
 		}
-		
-		// Build asset entry tree.
+
+		std::vector<std::filesystem::path> unvalidPaths;
+		const bool bLoadFromIndex = loadProject(registryPath, headerFolderPath, true, unvalidPaths);
+
+		for (const auto& pathFileNeedDelete : unvalidPaths)
 		{
-			std::ifstream is(registryPath, std::ios::binary);
-			cereal::BinaryInputArchive archive(is);
-			archive(m_registryEntryRoot);
+			std::filesystem::remove(pathFileNeedDelete);
+			LOG_WARN("Path {0} unvalid header cache so delete already.", pathFileNeedDelete.string());
 		}
-		
-		// Scan whole header folder. And fill asset map.
+
+		// Loop asset entry tree ensure all entry header is valid.
+		pruneRegistry();
+
+		// Prepare asset type map
+		for(auto& assetPair : m_assetMap)
 		{
-			std::unordered_set<std::filesystem::path> unvalidPathSet{ };
-			std::vector<std::future<void>> scanFutures;
+			m_assetTypeSet[(size_t)assetPair.second.type].insert(assetPair.first);
+		}
+
+		if (bLoadFromIndex)
+		{
+			// Index may stale when header folder change outside engine, check in background.
+			launchConsistencyCheck();
+		}
+		else
+		{
+			m_bIndexDirty = true;
+		}
+
+		if (m_bIndexDirty)
+		{
+			saveIndex();
+		}
+
+		LOG_INFO("Open project with {0} assets {1}, cost {2:.2f} ms.",
+			m_assetMap.size(),
+			bLoadFromIndex ? "from index" : "by scan header folder",
+			std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count());
+	}
+
+	void AssetRegistry::launchConsistencyCheck()
+	{
+		// Snapshot file state, worker never touch asset map.
+		std::unordered_map<AssetHeaderUUID, std::pair<uint64_t, int64_t>> fileStates;
+		fileStates.reserve(m_assetMap.size());
+		for (const auto& [uuid, entry] : m_assetMap)
+		{
+			fileStates[uuid] = { entry.headerFileSize, entry.headerWriteTime };
+		}
+
+		m_consistencyCheck = GThreadPool::get()->submit([headerFolderPath = m_headerFolderPath, fileStates = std::move(fileStates)]()
+		{
+			ConsistencyCheckResult result{};
+			std::unordered_set<AssetHeaderUUID> existHeaders;
+			existHeaders.reserve(fileStates.size());
 
 			for (auto const& dirEntry : std::filesystem::directory_iterator{ headerFolderPath })
 			{
-				scanFutures.push_back(GThreadPool::get()->submit([dirEntry, this, &unvalidPathSet]()
+				const auto& path = dirEntry.path();
+				const AssetHeaderUUID uuid = path.stem().string();
+				existHeaders.insert(uuid);
+
+				uint64_t fileSize = 0;
+				int64_t writeTime = 0;
+				AssetIndex::getFileState(dirEntry, fileSize, writeTime);
+
+				auto it = fileStates.find(uuid);
+				if (it != fileStates.end() && it->second == std::make_pair(fileSize, writeTime))
 				{
-					const auto& path = dirEntry.path();
-					auto newHeader = std::make_shared<AssetHeaderInterface>();
-					{
-						std::ifstream is(path, std::ios::binary);
-						cereal::BinaryInputArchive archive(is);
-						archive(newHeader);
-					}
+					continue;
+				}
 
-					if (newHeader->getHeaderUUID() == path.stem().string())
-					{
-						std::unique_lock lock(m_assetMapMutex);
+				auto header = loadHeaderFile(path);
+				if (header && header->getHeaderUUID() == uuid)
+				{
+					result.changedHeaders.push_back({ header, fileSize, writeTime });
+				}
+				else
+				{
+					result.invalidPaths.push_back(path);
+				}
+			}
 
-						// Store in asset map.
-						m_assetMap[newHeader->getHeaderUUID()] = newHeader;
-					}
-					else
-					{
-						unvalidPathSet.insert(path);
-					}
-				}));
+			for (const auto& [uuid, state] : fileStates)
+			{
+				if (!existHeaders.contains(uuid))
+				{
+					result.missingHeaders.push_back(uuid);
+				}
 			}
-			for (auto& future : scanFutures)
+
+			return result;
+		});
+	}
+
+	void AssetRegistry::tick()
+	{
+		if (m_consistencyCheck.valid() && m_consistencyCheck.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+		{
+			applyConsistencyCheck(m_consistencyCheck.get());
+		}
+	}
+
+	void AssetRegistry::applyConsistencyCheck(ConsistencyCheckResult&& result)
+	{
+		// Asset may save while check running, file state same as entry meaning already consistent.
+		auto isEntryConsistent = [this](const AssetHeaderUUID& uuid)
+		{
+			auto it = m_assetMap.find(uuid);
+			if (it == m_assetMap.end())
+			{
+				return false;
+			}
+
+			// Unsaved change win.
+			if (it->second.header && it->second.header->isDirty())
 			{
-				future.wait();
+				return true;
 			}
 
-			for (const auto& pathFileNeedDelete : unvalidPathSet)
+			uint64_t fileSize = 0;
+			int64_t writeTime = 0;
+			return AssetIndex::getFileState(m_headerFolderPath / uuid, fileSize, writeTime) && it->second.sameFileState(fileSize, writeTime);
+		};
+
+		for (const auto& path : result.invalidPaths)
+		{
+			if (!isEntryConsistent(path.stem().string()))
 			{
-				std::filesystem::remove(pathFileNeedDelete);
-				LOG_WARN("Path {0} unvalid header cache so delete already.", pathFileNeedDelete.string());
+				std::filesystem::remove(path);
+				LOG_WARN("Path {0} unvalid header cache so delete already.", path.string());
 			}
 		}
 
-		// Loop asset entry tree ensure all entry header is valid.
+		size_t changedCount = 0;
+		for (auto& changed : result.changedHeaders)
 		{
-			loopNodeDownToTop([this](std::shared_ptr<RegistryEntry> entry)
+			const auto& uuid = changed.header->getHeaderUUID();
+			if (isEntryConsistent(uuid))
 			{
-				// Unvalid leaf entry which store unvalid asset header id.
-				// We need to remove it.
-				if (entry->isLeaf() && !m_assetMap.contains(entry->getAssetHeaderID()))
+				continue;
+			}
+
+			if (!m_registryHeaderMap.contains(uuid))
+			{
+				// No entry reference, same as open prune.
+				std::filesystem::remove(m_headerFolderPath / uuid);
+				if (!changed.header->getBinUUID().empty())
 				{
-					if (auto parent = entry->getParent().lock())
-					{
-						AssetRegistryManager::get()->removeChild(parent, entry, false);
-					}
+					std::filesystem::remove(m_binFolderPath / changed.header->getBinUUID());
 				}
-			}, m_registryEntryRoot);
+				continue;
+			}
 
-			// Copy asset map to erase.
-			std::unordered_map<UUID, std::shared_ptr<AssetHeaderInterface>> entryAssetSet = m_assetMap;
-			loopNodeTopToDown([this, &entryAssetSet](std::shared_ptr<RegistryEntry> entry)
+			std::unique_lock lock(m_assetMapMutex);
+			auto& entry = m_assetMap[uuid];
+			if (entry.type != changed.header->getType())
 			{
-				// Also cache uuid map.
-				addEntry(entry);
+				m_assetTypeSet[size_t(entry.type)].erase(uuid);
+			}
+
+			entry.fill(*changed.header);
+			entry.header = changed.header;
+			entry.headerFileSize = changed.fileSize;
+			entry.headerWriteTime = changed.writeTime;
+			m_assetTypeSet[size_t(entry.type)].insert(uuid);
 
-				if (entry->isLeaf())
+			m_bIndexDirty = true;
+			changedCount++;
+		}
+
+		size_t missingCount = 0;
+		for (const auto& uuid : result.missingHeaders)
+		{
+			auto it = m_assetMap.find(uuid);
+			if (it == m_assetMap.end() || (it->second.header && it->second.header->isDirty()) || std::filesystem::exists(m_headerFolderPath / uuid))
+			{
+				continue;
+			}
+
+			LOG_WARN("Asset {0} header file missing, remove from registry.", it->second.name);
+			{
+				std::unique_lock lock(m_assetMapMutex);
+				m_assetTypeSet[size_t(it->second.type)].erase(uuid);
+				m_assetMap.erase(it);
+			}
+
+			if (auto registryIt = m_registryHeaderMap.find(uuid); registryIt != m_registryHeaderMap.end() && m_registryMap.contains(registryIt->second))
+			{
+				if (auto entry = m_registryMap.at(registryIt->second).lock())
 				{
-					entryAssetSet.erase(entry->getAssetHeaderID());
+					if (auto parent = entry->getParent().lock())
+					{
+						removeChild(parent, entry, true);
+					}
 				}
-			}, m_registryEntryRoot);
+			}
+
+			m_bIndexDirty = true;
+			missingCount++;
+		}
+
+		if (m_bIndexDirty)
+		{
+			saveIndex();
+		}
+
+		LOG_INFO("Asset header consistency check finish, {0} changed, {1} missing, {2} invalid.",
+			changedCount, missingCount, result.invalidPaths.size());
+	}
+
+	void AssetRegistry::benchmarkProjectOpen(uint32_t assetCount)
+	{
+		const auto folder = std::filesystem::temp_directory_path() / "FlowerProjectOpenBenchmark";
+		const auto registryPath = folder / "Registry.tree";
+		const auto headerFolderPath = folder / "Header";
+
+		std::filesystem::remove_all(folder);
+		std::filesystem::create_directories(headerFolderPath);
 
-			// Erase unused header asset.
-			for(auto& unusedAsset : entryAssetSet)
+		// Synthetic project, material header is small and no bin.
+		{
+			auto root = std::make_shared<RegistryEntry>();
+			std::vector<std::shared_ptr<StandardPBRMaterialHeader>> headers(assetCount);
+			for (uint32_t i = 0; i < assetCount; i++)
 			{
-				auto& asset = unusedAsset.second;
-				
-				// Remove disk unused header file.
-				std::filesystem::remove(headerFolderPath / asset->getHeaderUUID());
+				headers[i] = std::make_shared<StandardPBRMaterialHeader>("BenchmarkMaterial_" + std::to_string(i));
 
-				// Also try remove disk unused bin file.
-				const auto binFilePath = binFolderPath / asset->getBinUUID();
-				if (std::filesystem::exists(binFilePath))
+				auto entry = std::make_shared<RegistryEntry>(headers[i]->getHeaderUUID(), headers[i]->getName());
+				entry->m_parent = root;
+				root->m_children.push_back(entry);
+			}
+
+			GThreadPool::get()->parallelFor(0, assetCount, [&](size_t begin, size_t end)
+			{
+				for (size_t i = begin; i < end; i++)
 				{
-					std::filesystem::remove(binFilePath);
+					std::shared_ptr<AssetHeaderInterface> header = headers[i];
+					std::ofstream os(headerFolderPath / header->getHeaderUUID(), std::ios::binary);
+					cereal::BinaryOutputArchive archive(os);
+					archive(header);
 				}
+			});
 
-				// Remove cache map unused header.
-				m_assetMap.erase(asset->getHeaderUUID());
-			}
+			std::ofstream os(registryPath, std::ios::binary);
+			cereal::BinaryOutputArchive archive(os);
+			archive(root);
 		}
 
-		// Prepare asset type map
-		for(auto& assetPair : m_assetMap)
+		auto timeMs = [](auto&& func)
+		{
+			const auto startTime = std::chrono::steady_clock::now();
+			func();
+			return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+		};
+
+		// Cold open: no index, deserialize every header. Then write index same as real open.
+		std::vector<std::filesystem::path> invalidPaths;
+		const double coldMs = timeMs([&]()
+		{
+			AssetRegistry registry;
+			registry.loadProject(registryPath, headerFolderPath, false, invalidPaths);
+			AssetIndex::save(registry.m_assetMap, registry.m_indexPath);
+		});
+
+		// Warm open: only read index table.
+		AssetRegistry warmRegistry;
+		bool bLoadFromIndex = false;
+		const double warmMs = timeMs([&]()
+		{
+			bLoadFromIndex = warmRegistry.loadProject(registryPath, headerFolderPath, true, invalidPaths);
+		});
+
+		// First access deserialize header lazily.
+		const uint32_t accessCount = std::min(assetCount, 1000u);
+		uint32_t loadedCount = 0;
+		const double accessMs = timeMs([&]()
+		{
+			const auto& children = warmRegistry.getRoot()->getChildren();
+			for (uint32_t i = 0; i < accessCount; i++)
+			{
+				loadedCount += warmRegistry.getHeader(children[i]->getAssetHeaderID()) ? 1 : 0;
+			}
+		});
+
+		if (!bLoadFromIndex || loadedCount != accessCount || !invalidPaths.empty())
 		{
-			m_assetTypeSet[(size_t)assetPair.second->getType()].insert(assetPair.first);
+			LOG_ERROR("Project open benchmark fail, index load {0}, lazy header {1}/{2}, invalid header {3}.",
+				bLoadFromIndex, loadedCount, accessCount, invalidPaths.size());
 		}
+
+		LOG_INFO("Project open benchmark with {0} assets: cold (scan headers) {1:.2f} ms, warm (index) {2:.2f} ms, lazy header first access {3:.2f} us per asset.",
+			assetCount, coldMs, warmMs, accessCount > 0 ? accessMs * 1000.0 / accessCount : 0.0);
+
+		std::filesystem::remove_all(folder);
 	}
 
 	std::shared_ptr<AssetHeaderInterface> RegistryEntry::getHeader()
 	{
-		return AssetRegistryManager::get()->getHeaderMap().at(m_assetHeader);
+		return AssetRegistryManager::get()->getHeader(m_assetHeader);
 	}
 
 	void AssetRegistry::loopNodeDownToTop(
@@ -294,6 +755,24 @@ namespace Flower
 		return newAssetMesh->getHeaderUUID();
 	}
 
+	AssetHeaderUUID AssetRegistry::importHeightmap(const std::filesystem::path& inPath, std::shared_ptr<RegistryEntry> entry)
+	{
+		CHECK(!entry->isValid());
+
+		LOG_INFO("Importing asset {0} from disk...", inPath.string());
+
+		std::shared_ptr<HeightmapAssetHeader> newAssetHeightmap = std::make_shared<HeightmapAssetHeader>(inPath.stem().string());
+		if (!newAssetHeightmap->initFromRaw(inPath))
+		{
+			return {};
+		}
+
+		registerAssetMap(newAssetHeightmap, EAssetType::Heightmap);
+
+		markDirty();
+		return newAssetHeightmap->getHeaderUUID();
+	}
+
 	void AssetRegistry::removeChild(
 		std::shared_ptr<RegistryEntry> inParent,
 		std::shared_ptr<RegistryEntry> inChild,
@@ -344,6 +823,6 @@ namespace Flower
 
 	bool RegistryEntry::isValid() const
 	{
-		return AssetRegistryManager::get()->getHeaderMap().contains(m_assetHeader);
+		return AssetRegistryManager::get()->containsAsset(m_assetHeader);
 	}
 }
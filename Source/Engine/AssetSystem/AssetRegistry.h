@@ -1,6 +1,7 @@
 #pragma once
 #include "AssetCommon.h"
 #include "AssetSystem.h"
+#include "AssetIndex.h"
 
 namespace Flower
 {
@@ -96,13 +97,58 @@ namespace Flower
 
 		// asset misc.
 		std::mutex m_assetMapMutex;
-		std::unordered_map<AssetHeaderUUID, std::shared_ptr<AssetHeaderInterface>> m_assetMap;
+		AssetIndexMap m_assetMap;
 		std::unordered_map<AssetTypeKey, std::unordered_set<AssetHeaderUUID>> m_assetTypeSet;
 
+		std::filesystem::path m_headerFolderPath;
+		std::filesystem::path m_binFolderPath;
+		std::filesystem::path m_indexPath;
+
+		// Index need rewrite when asset info change.
+		bool m_bIndexDirty = false;
+
+		// Header folder differ from index, found by background check after open with index.
+		struct ConsistencyCheckResult
+		{
+			struct ChangedHeader
+			{
+				std::shared_ptr<AssetHeaderInterface> header;
+				uint64_t fileSize;
+				int64_t writeTime;
+			};
+
+			// Header file no in index or file state change.
+			std::vector<ChangedHeader> changedHeaders;
+
+			// Index record without header file.
+			std::vector<AssetHeaderUUID> missingHeaders;
+
+			// Header file can't deserialize or uuid mismatch file name.
+			std::vector<std::filesystem::path> invalidPaths;
+		};
+		std::future<ConsistencyCheckResult> m_consistencyCheck;
 
 		void addEntry(std::shared_ptr<RegistryEntry>);
 		void removeEntry(std::shared_ptr<RegistryEntry>);
 
+		// Return nullptr if file broken.
+		static std::shared_ptr<AssetHeaderInterface> loadHeaderFile(const std::filesystem::path& path);
+
+		// Deserialize registry tree and fill asset map from index, fallback to parallel scan whole header folder.
+		// No disk write, return true if load from index.
+		bool loadProject(
+			const std::filesystem::path& registryPath, 
+			const std::filesystem::path& headerFolderPath,
+			bool bUseIndex,
+			std::vector<std::filesystem::path>& outInvalidPaths);
+
+		// One post-order walk remove leaf entries without asset, cache entry maps and erase unused assets.
+		void pruneRegistry();
+
+		void launchConsistencyCheck();
+		void applyConsistencyCheck(ConsistencyCheckResult&& result);
+
+		void saveIndex();
 		
 	public:
 		AssetRegistry() = default;
@@ -134,16 +180,28 @@ namespace Flower
 			const std::filesystem::path& headerFolderPath,
 			const std::filesystem::path& binFolderPath);
 
+		// Apply background consistency check result when ready.
+		void tick();
+
 		std::shared_ptr<RegistryEntry> getRoot() const
 		{
 			return m_registryEntryRoot;
 		}
 
-		const auto& getHeaderMap() const
+		// Deserialize header on first access, return nullptr if asset no exist.
+		std::shared_ptr<AssetHeaderInterface> getHeader(const AssetHeaderUUID& uuid);
+
+		template<typename T>
+		std::shared_ptr<T> getHeader(const AssetHeaderUUID& uuid)
 		{
-			return m_assetMap;
+			return std::dynamic_pointer_cast<T>(getHeader(uuid));
 		}
 
+		// Index info query, never deserialize header.
+		bool containsAsset(const AssetHeaderUUID& uuid);
+		std::string getAssetName(const AssetHeaderUUID& uuid);
+		EAssetType getAssetType(const AssetHeaderUUID& uuid);
+
 		const auto& getEntryMap() const
 		{
 			return m_registryMap;
@@ -162,9 +220,17 @@ namespace Flower
 
 		void release()
 		{
+			if (m_consistencyCheck.valid())
+			{
+				m_consistencyCheck.wait();
+			}
 			m_registryEntryRoot.reset();
 		}
 
+		// Generate synthetic project in temp folder, log open time without index (full header scan) and with index,
+		// and first header lazy access time.
+		static void benchmarkProjectOpen(uint32_t assetCount);
+
 		// Add child without relationship check.
 		void addChild(
 			std::shared_ptr<RegistryEntry> inParent,
@@ -191,6 +257,8 @@ namespace Flower
 
 		AssetHeaderUUID importStaticMesh(const std::filesystem::path& inPath, std::shared_ptr<RegistryEntry> entry);
 
+		AssetHeaderUUID importHeightmap(const std::filesystem::path& inPath, std::shared_ptr<RegistryEntry> entry);
+
 		void registerAssetMap(std::shared_ptr<AssetHeaderInterface> asset, EAssetType type);
 
 	};
@@ -2,13 +2,33 @@
 #include "AssetSystem.h"
 #include "AssetRegistry.h"
 #include "TextureManager.h"
+#include "ThumbnailAtlas.h"
+#include "MaterialManager.h"
 #include "MeshManager.h"
 #include "AsyncUploader.h"
+#include "LandscapeManager.h"
 #include "MeshManager.h"
 #include "../MeshTool/MeshToolCommon.h"
+#include "../MeshTool/MeshSimplifier.h"
 
 namespace Flower
 {
+	static AutoCVarCmd cVarMeshSDFValidate("cmd.MeshSDF.Validate", "Bake test meshes distance field, compare with brute force and log bake throughput.");
+
+	static AutoCVarCmd cVarMeshSimplifierValidate("cmd.MeshSimplifier.Validate", "Build lods of test meshes, check error bound, surface distance and triangle flip.");
+
+	static AutoCVarCmd cVarThumbnailAtlasValidate("cmd.ThumbnailAtlas.Validate", "Drive thumbnail slot allocator and grid visibility math without gpu, compare with brute force.");
+
+	static AutoCVarCmd cVarAssetBenchmarkProjectOpen("cmd.Asset.BenchmarkProjectOpen", "Generate synthetic project in temp folder, log cold and warm project open time.");
+
+	static AutoCVarInt32 cVarAssetBenchmarkProjectOpenCount(
+		"r.Asset.BenchmarkProjectOpenCount",
+		"Synthetic asset count of project open benchmark.",
+		"Asset",
+		50000,
+		CVarFlags::ReadAndWrite
+	);
+
 	AssetSystem::AssetSystem(ModuleManager* in, std::string name)
 		: IRuntimeModule(in, name)
 	{
@@ -18,6 +38,8 @@ namespace Flower
 	bool AssetSystem::init()
 	{
 		TextureManager::get()->init();
+		ThumbnailAtlas::get()->init();
+		MaterialManager::get()->init();
 		MeshManager::get()->init();
 		engineAssetInit();
 
@@ -133,6 +155,31 @@ namespace Flower
 	void AssetSystem::tick(const RuntimeModuleTickData& tickData)
 	{
 		GpuUploader::get()->tick();
+		TextureManager::get()->tick();
+		LandscapeManager::get()->tick();
+		MaterialManager::get()->tick();
+		ThumbnailAtlas::get()->beginFrame();
+		AssetRegistryManager::get()->tick();
+
+		CVarCmdHandle(cVarMeshSDFValidate, []()
+		{
+			MeshSDFBaker::validateAndBenchmark();
+		});
+
+		CVarCmdHandle(cVarMeshSimplifierValidate, []()
+		{
+			MeshSimplifier::validate();
+		});
+
+		CVarCmdHandle(cVarThumbnailAtlasValidate, []()
+		{
+			ThumbnailAtlasContext::validate();
+		});
+
+		CVarCmdHandle(cVarAssetBenchmarkProjectOpen, []()
+		{
+			AssetRegistry::benchmarkProjectOpen(uint32_t(glm::max(1, cVarAssetBenchmarkProjectOpenCount.get())));
+		});
 	}
 
 	void AssetSystem::release()
@@ -140,6 +187,9 @@ namespace Flower
 		GpuUploader::get()->release();
 
 		MeshManager::get()->release();
+		MaterialManager::get()->release();
+		ThumbnailAtlas::get()->release();
+		LandscapeManager::get()->release();
 		TextureManager::get()->release();
 
 		AssetRegistryManager::get()->release();
@@ -182,6 +232,11 @@ namespace Flower
 			assetUUID = AssetRegistryManager::get()->importStaticMesh(inPath, entry);
 		}
 		break;
+		case EAssetType::Heightmap:
+		{
+			assetUUID = AssetRegistryManager::get()->importHeightmap(inPath, entry);
+		}
+		break;
 		default:
 		{
 			CHECK(false && "Non-entry implement.");
@@ -191,7 +246,7 @@ namespace Flower
 
 		CHECK(!assetUUID.empty());
 		CHECK(AssetRegistryManager::get()->getTypeAssetSetMap().at(size_t(type)).contains(assetUUID));
-		CHECK(AssetRegistryManager::get()->getHeaderMap().contains(assetUUID));
+		CHECK(AssetRegistryManager::get()->containsAsset(assetUUID));
 
 		std::shared_ptr<RegistryEntry> newRegistry = std::make_shared<RegistryEntry>(
 			assetUUID,
@@ -35,7 +35,7 @@ namespace Flower
 		submitInfo.commandBufferCount = 1;
 		submitInfo.pCommandBuffers = &m_commandBuffer;
 
-		vkQueueSubmit(m_queue, 1, &submitInfo, m_fence);
+		RHI::get()->queueSubmit(m_queue, 1, &submitInfo, m_fence);
 	}
 
 	AsyncUploaderBase::AsyncUploaderBase(const std::string& name, AsyncUploaderManager& in, VkQueue inQueue, uint32_t inFamily)
@@ -60,7 +60,8 @@ namespace Flower
 			allocInfo.commandPool = m_pool;
 			allocInfo.commandBufferCount = 1;
 			RHICheck(vkAllocateCommandBuffers(RHI::Device, &allocInfo, &m_commandBuffer));
-			 
+
+			PROFILE_THREAD_NAME(m_name);
 			threadFunction();
 
 			vkFreeCommandBuffers(RHI::Device, m_pool, 1, &m_commandBuffer);
@@ -164,6 +165,7 @@ namespace Flower
 		{
 			if (!m_manager.dynamicLoadAssetTaskEmpty() || m_bProcessing.load())
 			{
+				PROFILE_SCOPE("Dynamic Upload Tick");
 				loadTick();
 			}
 			else
@@ -275,6 +277,7 @@ namespace Flower
 		{
 			if (!m_manager.staticLoadAssetTaskEmpty() || m_bProcessing.load())
 			{
+				PROFILE_SCOPE("Static Upload Tick");
 				loadTick();
 			}
 			else
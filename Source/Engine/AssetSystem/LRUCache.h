@@ -1,6 +1,7 @@
 #pragma once
 #include "../Core/Core.h"
 #include "../Core/UUID.h"
+#include "../RHI/MemoryBudget.h"
 
 namespace Flower
 {
@@ -52,12 +53,24 @@ namespace Flower
 	};
 
 	template<typename ValueType = LRUAssetInterface, typename KeyType = UUID>
-	class LRUAssetCache : NonCopyable
+	class LRUAssetCache : public MemoryBudgetConsumer, NonCopyable
 	{
 	protected:
 		static_assert(std::is_base_of_v<LRUAssetInterface, ValueType>, "Value type must derived from LRUAssetInterface");
 
-		using LRUList = std::list<std::pair<KeyType, std::shared_ptr<ValueType>>>;
+		struct LRUEntry
+		{
+			KeyType key;
+			std::shared_ptr<ValueType> value;
+
+			// Memory budget frame of last insert or get.
+			uint64_t lastUseFrame;
+		};
+
+		// Max entries scan from list back when search evict candidate.
+		static constexpr uint32_t kMaxEvictScanCount = 32;
+
+		using LRUList = std::list<LRUEntry>;
 		using LRUListNode = LRUList::iterator;
 
 		// LRU data struct.
@@ -193,15 +206,16 @@ namespace Flower
 			if (iter != m_lruMap.end())
 			{
 				// Key exist, update map value, and update list.
-				m_usedSize -= iter->second->second->getSize();
-				iter->second->second = value;
+				m_usedSize -= iter->second->value->getSize();
+				iter->second->value = value;
+				iter->second->lastUseFrame = MemoryBudget::get()->getFrame();
 
 				m_lruList.splice(m_lruList.begin(), m_lruList, iter->second);
 				return;
 			}
 
 			// Key no exist, emplace to list front, and update map key-value.
-			m_lruList.emplace_front(key, std::move(value));
+			m_lruList.push_front({ key, std::move(value), MemoryBudget::get()->getFrame() });
 			m_lruMap[key] = m_lruList.begin();
 
 			// May oversize, need reduce.
@@ -241,11 +255,68 @@ namespace Flower
 
 			// Still exist in lru map, set as first guy.
 			m_lruList.splice(m_lruList.begin(), m_lruList, iter->second);
-			return iter->second->second;
+			iter->second->lastUseFrame = MemoryBudget::get()->getFrame();
+			return iter->second->value;
+		}
+
+		virtual uint64_t getBudgetUsage() override
+		{
+			return m_usedSize.load() + m_persistentAssetSize.load();
+		}
+
+		virtual bool getEvictCandidate(uint64_t& outLastUseFrame, uint64_t& outSize) override
+		{
+			std::lock_guard<std::mutex> lockGuard(m_lock);
+
+			auto iter = findEvictCandidate();
+			if (iter == m_lruList.end())
+			{
+				return false;
+			}
+
+			outLastUseFrame = iter->lastUseFrame;
+			outSize = iter->value->getSize();
+			return true;
+		}
+
+		virtual void evictCandidate() override
+		{
+			std::lock_guard<std::mutex> lockGuard(m_lock);
+
+			auto iter = findEvictCandidate();
+			if (iter != m_lruList.end())
+			{
+				m_usedSize -= iter->value->getSize();
+				m_lruMap.erase(iter->key);
+				m_lruList.erase(iter);
+			}
+		}
+
+		virtual void onBudgetChange(uint64_t budget) override
+		{
+			std::lock_guard<std::mutex> lockGuard(m_lock);
+
+			// Keep same capacity and elasticity ratio as default config.
+			m_capacity = size_t(budget * 2 / 3);
+			m_elasticity = size_t(budget - budget * 2 / 3);
 		}
 
 	protected:
 
+		// Least recently used entry no reference by others, evict it really free memory.
+		LRUListNode findEvictCandidate()
+		{
+			uint32_t scanCount = 0;
+			for (auto iter = m_lruList.rbegin(); iter != m_lruList.rend() && scanCount < kMaxEvictScanCount; ++iter, ++scanCount)
+			{
+				if (iter->value.use_count() == 1)
+				{
+					return std::prev(iter.base());
+				}
+			}
+			return m_lruList.end();
+		}
+
 		// Prune lru map.
 		size_t prune()
 		{
@@ -259,8 +330,8 @@ namespace Flower
 			size_t reduceSize = 0;
 			while (m_usedSize > m_capacity)
 			{
-				size_t eleSize = m_lruList.back().second->getSize();
-				m_lruMap.erase(m_lruList.back().first);
+				size_t eleSize = m_lruList.back().value->getSize();
+				m_lruMap.erase(m_lruList.back().key);
 				m_lruList.pop_back();
 
 				m_usedSize -= eleSize;
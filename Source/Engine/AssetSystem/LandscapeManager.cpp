@@ -0,0 +1,240 @@
+#include "Pch.h"
+#include "LandscapeManager.h"
+#include "TextureManager.h"
+#include "../Renderer/LandscapeQuadtree.h"
+
+#include <stb/stb_image.h>
+
+namespace Flower
+{
+	static AutoCVarCmd cVarLandscapeValidate("cmd.Landscape.Validate", "Check landscape quadtree selection cover, lod range and neighbour lod difference on random heightfields.");
+	static AutoCVarCmd cVarLandscapeBenchmark("cmd.Landscape.Benchmark", "Build 4097x4097 samples landscape quadtree, log build and node selection cpu time.");
+
+	static bool loadHeightSamples(const std::filesystem::path& rawPath, uint32_t& outWidth, uint32_t& outHeight, std::vector<uint16_t>& outSamples)
+	{
+		const auto extension = rawPath.extension();
+		if (extension == ".r16" || extension == ".raw")
+		{
+			std::ifstream file(rawPath, std::ios::binary | std::ios::ate);
+			if (!file.is_open())
+			{
+				LOG_ERROR("Fail to open heightmap {0}.", rawPath.string());
+				return false;
+			}
+
+			// Raw heightmap no store dimension, must be square.
+			const size_t sampleCount = size_t(file.tellg()) / sizeof(uint16_t);
+			const uint32_t dim = uint32_t(std::sqrt(double(sampleCount)) + 0.5);
+			if (dim < 2 || size_t(dim) * dim != sampleCount)
+			{
+				LOG_ERROR("Raw heightmap {0} is not square 16 bit samples.", rawPath.string());
+				return false;
+			}
+
+			outWidth = dim;
+			outHeight = dim;
+			outSamples.resize(sampleCount);
+
+			file.seekg(0);
+			file.read((char*)outSamples.data(), sampleCount * sizeof(uint16_t));
+			return true;
+		}
+
+		int32_t texWidth, texHeight, texChannels;
+		stbi_us* pixels = stbi_load_16(rawPath.string().c_str(), &texWidth, &texHeight, &texChannels, 1);
+		if (!pixels)
+		{
+			LOG_ERROR("Fail to load heightmap {0}.", rawPath.string());
+			return false;
+		}
+
+		if (texWidth < 2 || texHeight < 2)
+		{
+			LOG_ERROR("Heightmap {0} too small.", rawPath.string());
+			stbi_image_free(pixels);
+			return false;
+		}
+
+		outWidth = texWidth;
+		outHeight = texHeight;
+		outSamples.assign(pixels, pixels + size_t(texWidth) * texHeight);
+
+		stbi_image_free(pixels);
+		return true;
+	}
+
+	bool HeightmapAssetHeader::initFromRaw(const std::filesystem::path& rawPath)
+	{
+		std::vector<uint16_t> samples;
+		if (!loadHeightSamples(rawPath, m_width, m_height, samples))
+		{
+			return false;
+		}
+
+		setCacheBinData(std::make_shared<HeightmapAssetBin>(rawPath.filename().string()));
+		auto processingBin = getBinData<HeightmapAssetBin>();
+
+		m_tileSize = GHeightmapTileSize;
+		m_tileCountX = LandscapeQuadtree::getChunkCount(m_width, m_tileSize);
+		m_tileCountY = LandscapeQuadtree::getChunkCount(m_height, m_tileSize);
+
+		// Tile copy with shared edge, samples out of heightfield clamp to edge.
+		const uint32_t tileDim = getTileDim();
+		processingBin->m_tileSamples.resize(size_t(getTileCount()) * tileDim * tileDim);
+		GThreadPool::get()->parallelFor(0, size_t(getTileCount()), [&](size_t begin, size_t end)
+		{
+			for (size_t tileId = begin; tileId < end; tileId++)
+			{
+				const uint32_t tileX = uint32_t(tileId % m_tileCountX) * m_tileSize;
+				const uint32_t tileY = uint32_t(tileId / m_tileCountX) * m_tileSize;
+
+				uint16_t* dest = processingBin->m_tileSamples.data() + tileId * tileDim * tileDim;
+				for (uint32_t y = 0; y < tileDim; y++)
+				{
+					const uint32_t srcY = std::min(tileY + y, m_height - 1);
+					for (uint32_t x = 0; x < tileDim; x++)
+					{
+						const uint32_t srcX = std::min(tileX + x, m_width - 1);
+						dest[y * tileDim + x] = samples[size_t(srcY) * m_width + srcX];
+					}
+				}
+			}
+		}, 1);
+
+		m_coarseStep = std::max(divideRoundingUp(std::max(m_width, m_height) - 1, GHeightmapCoarseMaxDim - 1), 1u);
+		m_coarseWidth = divideRoundingUp(m_width - 1, m_coarseStep) + 1;
+		m_coarseHeight = divideRoundingUp(m_height - 1, m_coarseStep) + 1;
+
+		processingBin->m_coarseSamples.resize(size_t(m_coarseWidth) * m_coarseHeight);
+		for (uint32_t y = 0; y < m_coarseHeight; y++)
+		{
+			const uint32_t srcY = std::min(y * m_coarseStep, m_height - 1);
+			for (uint32_t x = 0; x < m_coarseWidth; x++)
+			{
+				const uint32_t srcX = std::min(x * m_coarseStep, m_width - 1);
+				processingBin->m_coarseSamples[size_t(y) * m_coarseWidth + x] = samples[size_t(srcY) * m_width + srcX];
+			}
+		}
+
+		LandscapeQuadtree::buildChunkMinMax(samples.data(), m_width, m_height, LandscapeQuadtree::kGridDim, m_chunkMinMax);
+
+		LOG_INFO("Heightmap {0} import: {1}x{2} samples, {3}x{4} tiles.", getName(), m_width, m_height, m_tileCountX, m_tileCountY);
+		return true;
+	}
+
+	GPUHeightmapTexture::GPUHeightmapTexture(const std::string& name, uint32_t width, uint32_t height)
+	{
+		m_image = GPUImageAsset::createImage(VK_FORMAT_R16_UNORM, name, 1, width, height, 1);
+	}
+
+	GPUHeightmapTexture::~GPUHeightmapTexture()
+	{
+		LandscapeManager::get()->retireTexture(std::move(m_image), m_bindlessIndex);
+	}
+
+	void HeightmapTextureLoadTask::uploadFunction(
+		uint32_t stageBufferOffset,
+		RHICommandBufferBase& commandBuffer,
+		VulkanBuffer& stageBuffer)
+	{
+		stageBuffer.map();
+		memcpy((void*)((char*)stageBuffer.mapped + stageBufferOffset), samples, size_t(width) * height * sizeof(uint16_t));
+		stageBuffer.unmap();
+
+		auto& image = *texture->m_image;
+		image.transitionLayout(commandBuffer, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, buildBasicImageSubresource());
+
+		VkBufferImageCopy region{};
+		region.bufferOffset = stageBufferOffset;
+		region.bufferRowLength = 0;
+		region.bufferImageHeight = 0;
+		region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		region.imageSubresource.mipLevel = 0;
+		region.imageSubresource.baseArrayLayer = 0;
+		region.imageSubresource.layerCount = 1;
+		region.imageOffset = { 0, 0, 0 };
+		region.imageExtent = image.getExtent();
+
+		vkCmdCopyBufferToImage(commandBuffer.cmd, stageBuffer, image.getImage(), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+
+		image.transitionLayout(commandBuffer, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, buildBasicImageSubresource());
+		texture->m_bindlessIndex = Bindless::Texture->updateTextureToBindlessDescriptorSet(image.getView(buildBasicImageSubresource()));
+
+		CHECK(texture->m_bindlessIndex != ~0);
+	}
+
+	std::shared_ptr<HeightmapTextureLoadTask> HeightmapTextureLoadTask::buildTile(
+		std::shared_ptr<HeightmapAssetHeader> header,
+		std::shared_ptr<HeightmapAssetBin> bin,
+		uint32_t tileId)
+	{
+		const uint32_t tileDim = header->getTileDim();
+
+		auto newTask = std::make_shared<HeightmapTextureLoadTask>();
+		newTask->cacheBin = bin;
+		newTask->samples = bin->getTileSamples(tileId, tileDim);
+		newTask->width = tileDim;
+		newTask->height = tileDim;
+		newTask->texture = std::make_shared<GPUHeightmapTexture>(header->getName() + "_Tile" + std::to_string(tileId), tileDim, tileDim);
+
+		return newTask;
+	}
+
+	std::shared_ptr<HeightmapTextureLoadTask> HeightmapTextureLoadTask::buildCoarse(
+		std::shared_ptr<HeightmapAssetHeader> header,
+		std::shared_ptr<HeightmapAssetBin> bin)
+	{
+		auto newTask = std::make_shared<HeightmapTextureLoadTask>();
+		newTask->cacheBin = bin;
+		newTask->samples = bin->getCoarseSamples().data();
+		newTask->width = header->getCoarseWidth();
+		newTask->height = header->getCoarseHeight();
+		newTask->texture = std::make_shared<GPUHeightmapTexture>(header->getName() + "_Coarse", newTask->width, newTask->height);
+
+		return newTask;
+	}
+
+	void LandscapeContext::release()
+	{
+		std::lock_guard lock(m_retiredMutex);
+		for (auto& retired : m_retiredTextures)
+		{
+			if (retired.bindlessIndex != ~0)
+			{
+				Bindless::Texture->freeBindless(retired.bindlessIndex);
+			}
+		}
+		m_retiredTextures.clear();
+	}
+
+	void LandscapeContext::tick()
+	{
+		CVarCmdHandle(cVarLandscapeValidate, []()
+		{
+			LandscapeQuadtree::validate();
+		});
+		CVarCmdHandle(cVarLandscapeBenchmark, []()
+		{
+			LandscapeQuadtree::benchmark(4096);
+		});
+
+		std::lock_guard lock(m_retiredMutex);
+		m_tickCount++;
+
+		// Release textures no longer used by frames in flight.
+		while (!m_retiredTextures.empty() && m_retiredTextures.front().tickCount + RHI::GMaxSwapchainCount < m_tickCount)
+		{
+			if (m_retiredTextures.front().bindlessIndex != ~0)
+			{
+				Bindless::Texture->freeBindless(m_retiredTextures.front().bindlessIndex);
+			}
+			m_retiredTextures.pop_front();
+		}
+	}
+
+	void LandscapeContext::retireTexture(std::shared_ptr<VulkanImage> image, uint32_t bindlessIndex)
+	{
+		std::lock_guard lock(m_retiredMutex);
+		m_retiredTextures.push_back({ std::move(image), bindlessIndex, m_tickCount });
+	}
+}
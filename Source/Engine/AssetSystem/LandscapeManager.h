@@ -0,0 +1,231 @@
+#pragma once
+#include "AssetCommon.h"
+#include "AsyncUploader.h"
+
+namespace Flower
+{
+	// Quads per height tile side, tile texture store one more sample each side for shared edge.
+	constexpr uint32_t GHeightmapTileSize = 256;
+
+	// Max coarse heightfield dimension, coarse texture always resident and use when tile no ready.
+	constexpr uint32_t GHeightmapCoarseMaxDim = 512;
+
+	class HeightmapAssetBin;
+	class HeightmapAssetHeader : public AssetHeaderInterface
+	{
+	private:
+		// Heightfield sample count.
+		uint32_t m_width;
+		uint32_t m_height;
+
+		uint32_t m_tileSize;
+		uint32_t m_tileCountX;
+		uint32_t m_tileCountY;
+
+		// Coarse sample i is heightfield sample min(i * step, dim - 1).
+		uint32_t m_coarseStep;
+		uint32_t m_coarseWidth;
+		uint32_t m_coarseHeight;
+
+		// Min max per LandscapeQuadtree::kGridDim chunk, quadtree build without bin data.
+		std::vector<uint16_t> m_chunkMinMax;
+
+	private:
+		friend class cereal::access;
+
+		template<class Archive>
+		void serialize(Archive& archive)
+		{
+			archive(
+				cereal::base_class<AssetHeaderInterface>(this),
+				m_width, m_height,
+				m_tileSize, m_tileCountX, m_tileCountY,
+				m_coarseStep, m_coarseWidth, m_coarseHeight,
+				m_chunkMinMax
+			);
+		}
+
+	public:
+		HeightmapAssetHeader() = default;
+		HeightmapAssetHeader(const std::string& name)
+			: AssetHeaderInterface(buildUUID(), name)
+		{
+
+		}
+
+		virtual EAssetType getType() const override
+		{
+			return EAssetType::Heightmap;
+		}
+
+		uint32_t getWidth() const { return m_width; }
+		uint32_t getHeight() const { return m_height; }
+
+		uint32_t getTileSize() const { return m_tileSize; }
+		uint32_t getTileCountX() const { return m_tileCountX; }
+		uint32_t getTileCountY() const { return m_tileCountY; }
+		uint32_t getTileCount() const { return m_tileCountX * m_tileCountY; }
+
+		// Tile texture dimension.
+		uint32_t getTileDim() const { return m_tileSize + 1; }
+
+		uint32_t getCoarseStep() const { return m_coarseStep; }
+		uint32_t getCoarseWidth() const { return m_coarseWidth; }
+		uint32_t getCoarseHeight() const { return m_coarseHeight; }
+
+		const std::vector<uint16_t>& getChunkMinMax() const { return m_chunkMinMax; }
+
+	public:
+		// 16 bit grey png, or square little endian 16 bit raw with .r16 or .raw extension.
+		bool initFromRaw(const std::filesystem::path& rawPath);
+	};
+
+	class HeightmapAssetBin : public AssetBinInterface
+	{
+	private:
+		friend HeightmapAssetHeader;
+
+		// Tile major, (tileSize + 1)^2 samples per tile, samples out of heightfield clamp to edge.
+		std::vector<uint16_t> m_tileSamples;
+
+		// Point sample of heightfield, see HeightmapAssetHeader::m_coarseStep.
+		std::vector<uint16_t> m_coarseSamples;
+
+	private:
+		friend class cereal::access;
+
+		template<class Archive>
+		void serialize(Archive& archive)
+		{
+			archive(cereal::base_class<AssetBinInterface>(this));
+			archive(m_tileSamples);
+			archive(m_coarseSamples);
+		}
+
+	public:
+		HeightmapAssetBin() = default;
+		HeightmapAssetBin(const std::string& name)
+			: AssetBinInterface(buildUUID(), name)
+		{
+
+		}
+
+		virtual EAssetType getType() const override
+		{
+			return EAssetType::Heightmap;
+		}
+
+		const uint16_t* getTileSamples(uint32_t tileId, uint32_t tileDim) const
+		{
+			return m_tileSamples.data() + size_t(tileId) * tileDim * tileDim;
+		}
+
+		const std::vector<uint16_t>& getCoarseSamples() const
+		{
+			return m_coarseSamples;
+		}
+	};
+
+	// One r16 height texture, tile or coarse heightfield.
+	// Release delay to LandscapeContext when destroy, frames in flight may still sample it.
+	class GPUHeightmapTexture : NonCopyable
+	{
+		friend struct HeightmapTextureLoadTask;
+
+	private:
+		std::shared_ptr<VulkanImage> m_image;
+		uint32_t m_bindlessIndex = ~0;
+
+		// Set on uploader thread when upload finish.
+		std::atomic<bool> m_bReady = false;
+
+	public:
+		GPUHeightmapTexture(const std::string& name, uint32_t width, uint32_t height);
+		~GPUHeightmapTexture();
+
+		bool isReady() const
+		{
+			return m_bReady.load();
+		}
+
+		uint32_t getBindlessIndex() const
+		{
+			return m_bindlessIndex;
+		}
+
+		size_t getSize() const
+		{
+			return m_image->getMemorySize();
+		}
+	};
+
+	struct HeightmapTextureLoadTask : public AssetLoadTask
+	{
+		// Bin keep alive until upload finish.
+		std::shared_ptr<HeightmapAssetBin> cacheBin;
+		const uint16_t* samples = nullptr;
+
+		std::shared_ptr<GPUHeightmapTexture> texture;
+		uint32_t width = 0;
+		uint32_t height = 0;
+
+		virtual void finishCallback() override
+		{
+			texture->m_bReady.store(true);
+		}
+
+		virtual uint32_t uploadSize() const override
+		{
+			// Stage offset keep 4 bytes align.
+			return uint32_t(divideRoundingUp(size_t(width) * height * sizeof(uint16_t), size_t(4)) * 4);
+		}
+
+		virtual void uploadFunction(
+			uint32_t stageBufferOffset,
+			RHICommandBufferBase& commandBuffer,
+			VulkanBuffer& stageBuffer) override;
+
+		static std::shared_ptr<HeightmapTextureLoadTask> buildTile(
+			std::shared_ptr<HeightmapAssetHeader> header,
+			std::shared_ptr<HeightmapAssetBin> bin,
+			uint32_t tileId);
+
+		static std::shared_ptr<HeightmapTextureLoadTask> buildCoarse(
+			std::shared_ptr<HeightmapAssetHeader> header,
+			std::shared_ptr<HeightmapAssetBin> bin);
+	};
+
+	class LandscapeContext : NonCopyable
+	{
+	private:
+		// Destroyed textures may still used by frames in flight, release delay.
+		struct RetiredTexture
+		{
+			std::shared_ptr<VulkanImage> image;
+			uint32_t bindlessIndex;
+			uint64_t tickCount;
+		};
+
+		// Texture may destroy on uploader thread.
+		std::mutex m_retiredMutex;
+		std::deque<RetiredTexture> m_retiredTextures;
+		uint64_t m_tickCount = 0;
+
+	public:
+		LandscapeContext() = default;
+
+		void release();
+		void tick();
+
+		// Thread safe.
+		void retireTexture(std::shared_ptr<VulkanImage> image, uint32_t bindlessIndex);
+	};
+
+	using LandscapeManager = Singleton<LandscapeContext>;
+}
+
+CEREAL_REGISTER_TYPE(Flower::HeightmapAssetHeader)
+CEREAL_REGISTER_POLYMORPHIC_RELATION(Flower::AssetHeaderInterface, Flower::HeightmapAssetHeader)
+
+CEREAL_REGISTER_TYPE(Flower::HeightmapAssetBin)
+CEREAL_REGISTER_POLYMORPHIC_RELATION(Flower::AssetBinInterface, Flower::HeightmapAssetBin)
@@ -3,5 +3,186 @@
 
 namespace Flower
 {
+	static AutoCVarCmd cVarMaterialValidate("cmd.Material.Validate", "Simulate submeshes acquire shared materials over frames, log allocations per frame.");
 
-}
\ No newline at end of file
+	void MaterialContext::init()
+	{
+		m_imageReadyHandle = TextureManager::get()->onImageReady.addRaw(this, &MaterialContext::onImageReady);
+	}
+
+	void MaterialContext::tick()
+	{
+		if (m_standardPBRInstances.size() >= m_pruneThreshold)
+		{
+			pruneExpired();
+		}
+
+		CVarCmdHandle(cVarMaterialValidate, [this]()
+		{
+			validate();
+		});
+	}
+
+	void MaterialContext::release()
+	{
+		TextureManager::get()->onImageReady.remove(m_imageReadyHandle);
+
+		m_textureUsers.clear();
+		m_standardPBRInstances.clear();
+		m_pruneThreshold = kMinPruneThreshold;
+	}
+
+	void MaterialContext::pruneExpired()
+	{
+		std::erase_if(m_standardPBRInstances, [](const auto& pair) { return pair.second.expired(); });
+
+		for (auto it = m_textureUsers.begin(); it != m_textureUsers.end();)
+		{
+			std::erase_if(it->second, [](const auto& weakInstance) { return weakInstance.expired(); });
+			it = it->second.empty() ? m_textureUsers.erase(it) : std::next(it);
+		}
+
+		m_pruneThreshold = std::max(kMinPruneThreshold, m_standardPBRInstances.size() * 2);
+	}
+
+	std::shared_ptr<StandardPBRMaterialInstance> MaterialContext::getOrCreateStandardPBR(const UUID& materialUUID)
+	{
+		auto& cacheInstance = m_standardPBRInstances[materialUUID];
+		if (auto instance = cacheInstance.lock())
+		{
+			return instance;
+		}
+
+		auto instance = std::make_shared<StandardPBRMaterialInstance>(materialUUID);
+		cacheInstance = instance;
+		m_instanceCreateCount++;
+
+		// Registry lookup and texture request only happen once per material.
+		const bool bAllTextureReady = instance->m_cpuMaterial.buildWithMaterialUUID(materialUUID);
+
+		const std::shared_ptr<GPUImageAsset> textures[] =
+		{
+			instance->m_cpuMaterial.baseColor,
+			instance->m_cpuMaterial.normal,
+			instance->m_cpuMaterial.specular,
+			instance->m_cpuMaterial.occlusion,
+			instance->m_cpuMaterial.emissive,
+		};
+
+		// Track all used textures, streaming texture change bindless index when resident mips change.
+		std::unordered_set<const GPUImageAsset*> usedTextures;
+		for (const auto& texture : textures)
+		{
+			if (texture && usedTextures.insert(texture.get()).second)
+			{
+				m_textureUsers[texture.get()].push_back(instance);
+
+				if (!bAllTextureReady && texture->isAssetLoading())
+				{
+					instance->m_pendingTextures.insert(texture.get());
+				}
+			}
+		}
+
+		instance->m_gpuMaterial = instance->m_cpuMaterial.buildGPU();
+		m_gpuBuildCount++;
+		return instance;
+	}
+
+	void MaterialContext::onImageReady(std::shared_ptr<GPUImageAsset> image)
+	{
+		auto it = m_textureUsers.find(image.get());
+		if (it == m_textureUsers.end())
+		{
+			return;
+		}
+
+		// Prune released instances.
+		auto& users = it->second;
+		users.erase(std::remove_if(users.begin(), users.end(), [](const auto& weakInstance)
+		{
+			return weakInstance.expired();
+		}), users.end());
+
+		// Copy first, broadcast may create new instances.
+		std::vector<std::shared_ptr<StandardPBRMaterialInstance>> instances;
+		for (auto& weakInstance : users)
+		{
+			instances.push_back(weakInstance.lock());
+		}
+
+		if (users.empty())
+		{
+			m_textureUsers.erase(it);
+		}
+
+		for (auto& instance : instances)
+		{
+			instance->m_pendingTextures.erase(image.get());
+
+			instance->m_gpuMaterial = instance->m_cpuMaterial.buildGPU();
+			m_gpuBuildCount++;
+			instance->onChanged.broadcast();
+		}
+	}
+
+	bool MaterialContext::validate()
+	{
+		constexpr uint32_t kMaterialCount = 64;
+		constexpr uint32_t kSubmeshCount = 4096;
+		constexpr uint32_t kFrameCount = 8;
+
+		// Uuids no in registry, build fallback material without texture request.
+		std::vector<UUID> materials(kMaterialCount);
+		for (auto& material : materials)
+		{
+			material = buildUUID();
+		}
+
+		const size_t cacheSizeBegin = m_standardPBRInstances.size();
+		ValidateReport report("Material");
+		{
+			// Old path rebuild material per submesh every frame while loading, shared cache must only allocate at first acquire.
+			std::vector<std::shared_ptr<StandardPBRMaterialInstance>> submeshMaterials(kSubmeshCount);
+			for (uint32_t frame = 0; frame < kFrameCount; frame++)
+			{
+				const uint64_t createCountBegin = m_instanceCreateCount;
+				const uint64_t buildCountBegin = m_gpuBuildCount;
+
+				for (uint32_t i = 0; i < kSubmeshCount; i++)
+				{
+					submeshMaterials[i] = getOrCreateStandardPBR(materials[i % kMaterialCount]);
+				}
+
+				const uint64_t createCount = m_instanceCreateCount - createCountBegin;
+				const uint64_t buildCount = m_gpuBuildCount - buildCountBegin;
+				const uint64_t expectCount = (frame == 0) ? kMaterialCount : 0;
+
+				LOG_INFO("Material validate: frame {0}, {1} submeshes, {2} instance allocations, {3} gpu material builds.",
+					frame, kSubmeshCount, createCount, buildCount);
+
+				report.expect(createCount == expectCount && buildCount == expectCount,
+					"frame " + std::to_string(frame) + " expect " + std::to_string(expectCount) + " allocations");
+			}
+
+			for (uint32_t i = 0; i < kMaterialCount; i++)
+			{
+				if (!report.expect(submeshMaterials[i] == submeshMaterials[i + kMaterialCount], "submeshes use same material " + materials[i] + " get different instances"))
+				{
+					break;
+				}
+			}
+		}
+
+		// All submeshes release, prune must drop expired entries.
+		pruneExpired();
+		const size_t leakCount = std::count_if(materials.begin(), materials.end(), [&](const UUID& material)
+		{
+			return m_standardPBRInstances.contains(material);
+		});
+		report.expect(leakCount == 0, std::to_string(leakCount) + " expired entries still in cache after prune");
+
+		LOG_INFO("Material validate: cache {0} entries before and {1} after.", cacheSizeBegin, m_standardPBRInstances.size());
+		return report.finish();
+	}
+}
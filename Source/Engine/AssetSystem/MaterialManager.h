@@ -3,6 +3,7 @@
 #include "LRUCache.h"
 #include "AsyncUploader.h"
 #include "TextureManager.h"
+#include "../Renderer/Parameters.h"
 
 namespace Flower
 {
@@ -68,7 +69,83 @@ namespace Flower
 		{
 
 		}
+
+		virtual void getDependencies(std::vector<AssetHeaderUUID>& outDependencies) const override
+		{
+			outDependencies.insert(outDependencies.end(), { baseColorTexture, normalTexture, specularTexture, emissiveTexture, aoTexture });
+		}
+	};
+
+	// Standard pbr material shared by all submeshes use same material uuid.
+	// Packed gpu material only rebuild when one of its textures finish upload or change resident mips.
+	class StandardPBRMaterialInstance : NonCopyable
+	{
+		friend class MaterialContext;
+
+	private:
+		UUID m_materialUUID;
+
+		// Keep texture reference avoid release.
+		CPUStaticMeshStandardPBRMaterial m_cpuMaterial;
+		GPUStaticMeshStandardPBRMaterial m_gpuMaterial;
+
+		// Unique textures still uploading.
+		std::unordered_set<const GPUImageAsset*> m_pendingTextures;
+
+	public:
+		explicit StandardPBRMaterialInstance(const UUID& materialUUID)
+			: m_materialUUID(materialUUID)
+		{
+
+		}
+
+		// Broadcast on main thread when packed gpu material change.
+		MulticastDelegate<> onChanged;
+
+		const UUID& getUUID() const { return m_materialUUID; }
+		bool isReady() const { return m_pendingTextures.empty(); }
+		const GPUStaticMeshStandardPBRMaterial& getGPUMaterial() const { return m_gpuMaterial; }
 	};
+
+	class MaterialContext : NonCopyable
+	{
+	private:
+		std::unordered_map<UUID, std::weak_ptr<StandardPBRMaterialInstance>> m_standardPBRInstances;
+
+		// Instances use image, image keep alive by instance so pointer key is safe while instance alive.
+		std::unordered_map<const GPUImageAsset*, std::vector<std::weak_ptr<StandardPBRMaterialInstance>>> m_textureUsers;
+
+		DelegateHandle m_imageReadyHandle;
+
+		// Expired entries sweep when cache grow over threshold, amortized O(1) per new material.
+		static constexpr size_t kMinPruneThreshold = 256;
+		size_t m_pruneThreshold = kMinPruneThreshold;
+
+		// Lifetime counters, validate use them to count allocation per frame.
+		uint64_t m_instanceCreateCount = 0;
+		uint64_t m_gpuBuildCount = 0;
+
+	private:
+		void onImageReady(std::shared_ptr<GPUImageAsset> image);
+
+		// Remove released instances from cache and texture users.
+		void pruneExpired();
+
+	public:
+		MaterialContext() = default;
+
+		void init();
+		void tick();
+		void release();
+
+		// Simulate many submeshes acquire shared materials over frames, check no allocation after first acquire and cache prune.
+		bool validate();
+
+		// Call on main thread.
+		std::shared_ptr<StandardPBRMaterialInstance> getOrCreateStandardPBR(const UUID& materialUUID);
+	};
+
+	using MaterialManager = Singleton<MaterialContext>;
 }
 
 
@@ -4,6 +4,7 @@
 #include "MaterialManager.h"
 #include "AssetSystem.h"
 #include "AssetRegistry.h"
+#include "../MeshTool/MeshSimplifier.h"
 
 #include <nlohmann/json.hpp>
 #include <stb/stb_image_write.h>
@@ -19,6 +20,14 @@
 
 namespace Flower
 {
+	static AutoCVarInt32 cVarMeshSDFBakeResolution(
+		"r.MeshSDF.BakeResolution",
+		"Mesh distance field sample count along longest axis when import, 0 disable bake.",
+		"MeshSDF",
+		64,
+		CVarFlags::ReadAndWrite
+	);
+
 	const UUID EngineMeshes::GBoxUUID = "12a68c4e-8352-4d97-a914-a0f4f4d1fd28";
 	struct AssimpModelProcess
 	{
@@ -230,6 +239,45 @@ namespace Flower
 				processNode(node->mChildren[i], scene, materialFolderEntry, texFolderEntry);
 			}
 		}
+
+		// Build lod chain of all submeshes, lod indices append after all lod0 indices.
+		void buildLods()
+		{
+			std::vector<std::vector<MeshSimplifier::Lod>> subMeshLods(m_subMeshInfos.size());
+			GThreadPool::get()->parallelFor(0, m_subMeshInfos.size(), [&](size_t begin, size_t end)
+			{
+				for (size_t i = begin; i < end; i++)
+				{
+					const auto& subMesh = m_subMeshInfos[i];
+
+					// Error bound relative to submesh size.
+					const float radius = subMesh.renderBounds.radius;
+					const std::vector<MeshSimplifier::LodTarget> targets =
+					{
+						{ 0.500f, 0.01f * radius },
+						{ 0.250f, 0.03f * radius },
+						{ 0.125f, 0.08f * radius },
+					};
+					static_assert(GMaxStaticMeshLodCount == 4);
+
+					subMeshLods[i] = MeshSimplifier::buildLodChain(m_vertices, m_indices.data() + subMesh.indexStartPosition, subMesh.indexCount, targets);
+				}
+			});
+
+			for (size_t i = 0; i < m_subMeshInfos.size(); i++)
+			{
+				for (auto& lod : subMeshLods[i])
+				{
+					StaticMeshSubMeshLod lodInfo{};
+					lodInfo.indexStartPosition = (uint32_t)m_indices.size();
+					lodInfo.indexCount = (uint32_t)lod.indices.size();
+					lodInfo.error = lod.error;
+
+					m_indices.insert(m_indices.end(), lod.indices.begin(), lod.indices.end());
+					m_subMeshInfos[i].lods.push_back(lodInfo);
+				}
+			}
+		}
 	};
 
 	bool StaticMeshAssetHeader::initFromRawStaticMesh(const std::filesystem::path& rawPath, std::shared_ptr<RegistryEntry> parentEntry)
@@ -263,6 +311,21 @@ namespace Flower
 
 		AssimpModelProcess processor(rawPath.parent_path());
 		processor.processNode(scene->mRootNode, scene, materialFolderRegistry, texFolderRegistry);
+		processor.buildLods();
+
+		// Lod0 indices of all submeshes lay before lod indices.
+		if (cVarMeshSDFBakeResolution.get() > 0)
+		{
+			size_t lod0IndexCount = 0;
+			for (const auto& subMesh : processor.m_subMeshInfos)
+			{
+				lod0IndexCount += subMesh.indexCount;
+			}
+
+			MeshSDFBakeConfig bakeConfig{};
+			bakeConfig.resolution = uint32_t(cVarMeshSDFBakeResolution.get());
+			processingMeshBin->m_distanceField = MeshSDFBaker::bake(processor.m_vertices, processor.m_indices.data(), lod0IndexCount, bakeConfig);
+		}
 
 		m_subMeshes = processor.m_subMeshInfos;
 		processingMeshBin->m_vertices = processor.m_vertices;
@@ -270,6 +333,7 @@ namespace Flower
 
 		m_indicesCount = processor.m_indices.size();
 		m_verticesCount = processor.m_vertices.size();
+		m_distanceFieldGPUSize = processingMeshBin->m_distanceField.isValid() ? processingMeshBin->m_distanceField.getGPUSize() : 0;
 
 		return true;
 	}
@@ -301,7 +365,8 @@ namespace Flower
 		VkDeviceSize vertexSize,
 		size_t singleVertexSize,
 		VkDeviceSize indexSize,
-		VkIndexType indexType)
+		VkIndexType indexType,
+		VkDeviceSize distanceFieldSize)
 		: LRUAssetInterface(fallback, bPersistent)
 		, m_name(name)
 	{
@@ -324,6 +389,16 @@ namespace Flower
 			indexSize
 		);
 
+		if (distanceFieldSize > 0)
+		{
+			m_distanceFieldBuffer = VulkanBuffer::create(
+				getRuntimeUniqueMeshAssetName(name).c_str(),
+				VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+				VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+				EVMAUsageFlags::GPUOnly,
+				distanceFieldSize
+			);
+		}
 
 		m_indexType = indexType;
 		m_singleIndexSize = sizeof(uint32_t);
@@ -352,12 +427,17 @@ namespace Flower
 		{
 			MeshManager::get()->getBindlessIndexBuffers()->freeBindless(m_indexBufferBindlessIndex);
 		}
+		if (m_distanceFieldBufferBindlessIndex != ~0)
+		{
+			MeshManager::get()->getBindlessDistanceFieldBuffers()->freeBindless(m_distanceFieldBufferBindlessIndex);
+		}
 	}
 
 	void GPUMeshAsset::prepareToUpload()
 	{
 		CHECK(m_vertexBufferBindlessIndex == ~0);
 		CHECK(m_indexBufferBindlessIndex == ~0);
+		CHECK(m_distanceFieldBufferBindlessIndex == ~0);
 	}
 
 	void GPUMeshAsset::finishUpload()
@@ -372,26 +452,39 @@ namespace Flower
 
 		CHECK(m_vertexBufferBindlessIndex != ~0);
 		CHECK(m_indexBufferBindlessIndex != ~0);
+
+		if (m_distanceFieldBuffer)
+		{
+			m_distanceFieldBufferBindlessIndex =
+				MeshManager::get()->getBindlessDistanceFieldBuffers()->updateBufferToBindlessDescriptorSet(
+					m_distanceFieldBuffer->getVkBuffer(), 0, m_distanceFieldBuffer->getSize());
+			CHECK(m_distanceFieldBufferBindlessIndex != ~0);
+		}
 	}
 
 	void MeshContext::init()
 	{
 		// 1 GB ~ 1.5 GB Mesh
 		m_lruCache = std::make_unique<LRUAssetCache<GPUMeshAsset>>(1024, 1024 + 512);
+		MemoryBudget::get()->registerConsumer(m_lruCache.get(), EMemoryBudgetCategory::Mesh, 2);
 
 		m_vertexBindlessBuffer = std::make_unique<BindlessStorageBuffer>();
 		m_indexBindlessBuffer = std::make_unique<BindlessStorageBuffer>();
+		m_distanceFieldBindlessBuffer = std::make_unique<BindlessStorageBuffer>();
 
 		m_vertexBindlessBuffer->init();
 		m_indexBindlessBuffer->init();
+		m_distanceFieldBindlessBuffer->init();
 	}
 
 	void MeshContext::release()
 	{
+		MemoryBudget::get()->unregisterConsumer(m_lruCache.get());
 		m_lruCache.reset();
 
 		m_vertexBindlessBuffer->release();
 		m_indexBindlessBuffer->release();
+		m_distanceFieldBindlessBuffer->release();
 	}
 
 	void StaticMeshRawDataLoadTask::finishCallback()
@@ -506,14 +599,20 @@ namespace Flower
 
 		const auto verticesSize = meshBin->getVertices().size() * sizeof(meshBin->getVertices()[0]);
 		const auto indicesSize = meshBin->getIndices().size() * sizeof(meshBin->getIndices()[0]);
+		const auto distanceFieldSize = meshAssetGPU->getDistanceFieldBuffer() ? meshBin->getDistanceField().getGPUSize() : 0;
 
-		CHECK(uploadSize() == uint32_t(indicesSize + verticesSize));
+		CHECK(uploadSize() == uint32_t(indicesSize + verticesSize + distanceFieldSize));
 		uint32_t indexOffsetInSrcBuffer = stageBufferOffset;
 		uint32_t vertexOffsetInSrcBuffer = indexOffsetInSrcBuffer + uint32_t(indicesSize);
+		uint32_t distanceFieldOffsetInSrcBuffer = vertexOffsetInSrcBuffer + uint32_t(verticesSize);
 
 		stageBuffer.map();
 		memcpy((void*)((char*)stageBuffer.mapped + indexOffsetInSrcBuffer), meshBin->getIndices().data(), indicesSize);
 		memcpy((void*)((char*)stageBuffer.mapped + vertexOffsetInSrcBuffer), meshBin->getVertices().data(), verticesSize);
+		if (distanceFieldSize > 0)
+		{
+			meshBin->getDistanceField().packGPUData((uint8_t*)stageBuffer.mapped + distanceFieldOffsetInSrcBuffer);
+		}
 		stageBuffer.unmap();
 
 		meshAssetGPU->prepareToUpload();
@@ -544,6 +643,20 @@ namespace Flower
 				&regionVertex);
 		}
 
+		if (distanceFieldSize > 0)
+		{
+			VkBufferCopy regionDistanceField{};
+			regionDistanceField.size = VkDeviceSize(distanceFieldSize);
+			regionDistanceField.srcOffset = distanceFieldOffsetInSrcBuffer;
+			regionDistanceField.dstOffset = 0;
+			vkCmdCopyBuffer(
+				commandBuffer.cmd,
+				stageBuffer,
+				meshAssetGPU->getDistanceFieldBuffer()->getVkBuffer(),
+				1,
+				&regionDistanceField);
+		}
+
 		meshAssetGPU->finishUpload();
 	}
 
@@ -578,7 +691,8 @@ namespace Flower
 			verticesSize,
 			sizeof(StaticMeshVertex),
 			indicesSize,
-			VK_INDEX_TYPE_UINT32));
+			VK_INDEX_TYPE_UINT32,
+			meshHeader->getDistanceFieldGPUSize()));
 
 		MeshManager::get()->insertGPUAsset(meshHeader->getHeaderUUID(), newAsset);
 		newTask->meshAssetGPU = newAsset;
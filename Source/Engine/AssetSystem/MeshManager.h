@@ -5,6 +5,7 @@
 #include "LRUCache.h"
 #include "AsyncUploader.h"
 #include "../Renderer/MeshMisc.h"
+#include "../MeshTool/MeshSDFBaker.h"
 
 namespace Flower
 {
@@ -22,13 +23,21 @@ namespace Flower
 		size_t m_indicesCount;
 		size_t m_verticesCount;
 
+		// Zero when mesh no distance field.
+		size_t m_distanceFieldGPUSize = 0;
+
 		template<class Archive>
-		void serialize(Archive& archive)
+		void serialize(Archive& archive, std::uint32_t const version)
 		{
 			archive(cereal::base_class<AssetHeaderInterface>(this));
 			archive(m_subMeshes);
 			archive(m_indicesCount);
 			archive(m_verticesCount);
+
+			if (version > 0)
+			{
+				archive(m_distanceFieldGPUSize);
+			}
 		}
 
 	public:
@@ -40,6 +49,17 @@ namespace Flower
 		}
 		virtual EAssetType getType() const { return EAssetType::StaticMesh; }
 
+		virtual void getDependencies(std::vector<AssetHeaderUUID>& outDependencies) const override
+		{
+			for (const auto& subMesh : m_subMeshes)
+			{
+				if (!subMesh.material.empty())
+				{
+					outDependencies.push_back(subMesh.material);
+				}
+			}
+		}
+
 		const std::vector<StaticMeshSubMesh>& getSubMeshes() const
 		{
 			return m_subMeshes;
@@ -55,6 +75,11 @@ namespace Flower
 			return m_indicesCount;
 		}
 
+		size_t getDistanceFieldGPUSize() const
+		{
+			return m_distanceFieldGPUSize;
+		}
+
 		bool initFromRawStaticMesh(const std::filesystem::path& rawPath, std::shared_ptr<RegistryEntry> parentEntry);
 	};
 
@@ -65,15 +90,23 @@ namespace Flower
 		std::vector<StaticMeshVertex> m_vertices;
 		std::vector<VertexIndexType> m_indices{ };
 
+		// Bake from lod0 when import.
+		MeshDistanceField m_distanceField{ };
+
 	private:
 		friend class cereal::access;
 
 		template<class Archive>
-		void serialize(Archive& archive)
+		void serialize(Archive& archive, std::uint32_t const version)
 		{
 			archive(cereal::base_class<AssetBinInterface>(this));
 			archive(m_indices);
 			archive(m_vertices);
+
+			if (version > 0)
+			{
+				archive(m_distanceField);
+			}
 		}
 
 	public:
@@ -97,6 +130,11 @@ namespace Flower
 		{
 			return m_vertices;
 		}
+
+		const MeshDistanceField& getDistanceField() const
+		{
+			return m_distanceField;
+		}
 	};
 
 	class GPUMeshAsset : public LRUAssetInterface
@@ -119,6 +157,10 @@ namespace Flower
 		uint32_t m_vertexBufferBindlessIndex = ~0;
 		uint32_t m_indexBufferBindlessIndex = ~0;
 
+		// Optional, packed MeshDistanceField gpu data.
+		std::shared_ptr<VulkanBuffer> m_distanceFieldBuffer = nullptr;
+		uint32_t m_distanceFieldBufferBindlessIndex = ~0;
+
 	public:
 		// Immediate build GPU Mesh asset.
 		GPUMeshAsset(
@@ -128,7 +170,8 @@ namespace Flower
 			VkDeviceSize vertexSize,
 			size_t singleVertexSize,
 			VkDeviceSize indexSize,
-			VkIndexType indexType
+			VkIndexType indexType,
+			VkDeviceSize distanceFieldSize = 0
 		);
 
 		// Lazy buid GPU asset.
@@ -143,7 +186,8 @@ namespace Flower
 		virtual size_t getSize() const override
 		{
 			return m_vertexBuffer->getSize() + 
-			       m_indexBuffer->getSize();
+			       m_indexBuffer->getSize() +
+			       (m_distanceFieldBuffer ? m_distanceFieldBuffer->getSize() : 0);
 		}
 
 		void prepareToUpload();
@@ -170,6 +214,11 @@ namespace Flower
 			return *m_indexBuffer;
 		}
 
+		VulkanBuffer* getDistanceFieldBuffer()
+		{
+			return m_distanceFieldBuffer.get();
+		}
+
 		GPUMeshAsset* getReadyAsset()
 		{
 			if (isAssetLoading())
@@ -189,6 +238,12 @@ namespace Flower
 		{
 			return getReadyAsset()->m_vertexBufferBindlessIndex;
 		}
+
+		// ~0 when loading or mesh no distance field, fallback mesh never has one.
+		uint32_t getDistanceFieldBindlessIndex()
+		{
+			return getReadyAsset()->m_distanceFieldBufferBindlessIndex;
+		}
 	};
 
 	class MeshContext
@@ -197,6 +252,7 @@ namespace Flower
 		std::unique_ptr<LRUAssetCache<GPUMeshAsset>> m_lruCache;
 		std::unique_ptr<BindlessStorageBuffer> m_vertexBindlessBuffer;
 		std::unique_ptr<BindlessStorageBuffer> m_indexBindlessBuffer;
+		std::unique_ptr<BindlessStorageBuffer> m_distanceFieldBindlessBuffer;
 
 	public:
 		MeshContext() = default;
@@ -214,6 +270,11 @@ namespace Flower
 			return m_vertexBindlessBuffer.get();
 		}
 
+		BindlessStorageBuffer* getBindlessDistanceFieldBuffers() const
+		{
+			return m_distanceFieldBindlessBuffer.get();
+		}
+
 		bool isAssetExist(const UUID& id)
 		{
 			return m_lruCache->contain(id);
@@ -297,6 +358,9 @@ namespace Flower
 
 }
 
+CEREAL_CLASS_VERSION(Flower::StaticMeshAssetHeader, 1);
+CEREAL_CLASS_VERSION(Flower::StaticMeshAssetBin, 1);
+
 CEREAL_REGISTER_TYPE(Flower::StaticMeshAssetHeader);
 CEREAL_REGISTER_POLYMORPHIC_RELATION(Flower::AssetHeaderInterface, Flower::StaticMeshAssetHeader)
 
@@ -8,6 +8,32 @@
 
 namespace Flower
 {
+	static AutoCVarInt32 cVarTextureStreamingEnable(
+		"r.TextureStreaming.Enable",
+		"Enable texture mip streaming. 0 is off, 1 is on.",
+		"TextureStreaming",
+		1,
+		CVarFlags::ReadAndWrite
+	);
+
+	static AutoCVarInt32 cVarTextureStreamingBudget(
+		"r.TextureStreaming.BudgetMB",
+		"Streaming texture memory budget in MB.",
+		"TextureStreaming",
+		1024,
+		CVarFlags::ReadAndWrite
+	);
+
+	static AutoCVarInt32 cVarTextureStreamingUploadPerFrame(
+		"r.TextureStreaming.UploadMBPerFrame",
+		"Max streaming texture upload size per frame in MB.",
+		"TextureStreaming",
+		32,
+		CVarFlags::ReadAndWrite
+	);
+
+	static AutoCVarCmd cVarTextureResidencyValidate("cmd.TextureResidency.Validate", "Run texture residency scenarios without device, check budget, upload limit and size accounting.");
+
 	const UUID EngineTextures::GWhiteTextureUUID = "0d6e103f-138a-482a-8a28-5116631a2e32";
 	const UUID EngineTextures::GGreyTextureUUID = "6caa6c06-3c71-4b36-bb88-e0c577a06c60";
 	const UUID EngineTextures::GBlackTextureUUID = "c11cc2f7-3c5d-458d-a2b4-68ebf7612948";
@@ -331,7 +357,8 @@ namespace Flower
 			}
 		}
 
-		m_mipmapCount = mipCount;
+		// No mipmap data when not build, keep count match bin.
+		m_mipmapCount = bBuildMipmap ? mipCount : 1;
 
 		if (bBuildMipmap)
 		{
@@ -433,11 +460,24 @@ namespace Flower
 		uint32_t mipmapCount,
 		uint32_t width,
 		uint32_t height,
-		uint32_t depth)
-		: LRUAssetInterface(fallback, bPersistent)
+		uint32_t depth,
+		uint32_t residentMip)
+		: LRUAssetInterface(fallback, bPersistent), m_residentMip(residentMip)
 	{
 		CHECK(m_image == nullptr && "You must ensure image asset only init once.");
 
+		m_image = createImage(format, name, mipmapCount, width, height, depth);
+		m_lruSize = m_image->getMemorySize();
+	}
+
+	std::shared_ptr<VulkanImage> GPUImageAsset::createImage(
+		VkFormat format,
+		const std::string& name,
+		uint32_t mipmapCount,
+		uint32_t width,
+		uint32_t height,
+		uint32_t depth)
+	{
 		VkImageCreateInfo info{};
 		info.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
 		info.flags = {};
@@ -454,7 +494,7 @@ namespace Flower
 		info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 		info.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
 
-		m_image = VulkanImage::create(
+		return VulkanImage::create(
 			getRuntimeUniqueImageAssetName(name).c_str(),
 			info,
 			VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
@@ -486,24 +526,199 @@ namespace Flower
 	{
 		// 2 GB ~ 3 GB Texture
 		m_lruCache = std::make_unique<LRUAssetCache<GPUImageAsset>>(2048, 2048 + 1024);
+
+		// Capacity follow texture budget when device report heap budget.
+		MemoryBudget::get()->registerConsumer(m_lruCache.get(), EMemoryBudgetCategory::Texture, 1);
+
+		m_bindlessOwners.resize(MAX_BINDLESS_COUNT);
 	}
 
 	void TextureContext::release()
 	{
+		{
+			std::lock_guard lock(m_readyImagesMutex);
+			m_readyImages.clear();
+		}
+		{
+			std::lock_guard lock(m_streamingReadyMutex);
+			for (auto& task : m_streamingReadyTasks)
+			{
+				Bindless::Texture->freeBindless(task->newBindlessIndex);
+			}
+			m_streamingReadyTasks.clear();
+		}
+
+		for (auto& retired : m_retiredResidencies)
+		{
+			Bindless::Texture->freeBindless(retired.bindlessIndex);
+		}
+		m_retiredResidencies.clear();
+		m_streamingTextures.clear();
+		m_bindlessOwners.clear();
+
+		MemoryBudget::get()->unregisterConsumer(m_lruCache.get());
 		m_lruCache.reset();
 	}
 
-	std::shared_ptr<GPUImageAsset> TextureContext::getOrCreateLRUSnapShot(std::shared_ptr<ImageAssetHeader> asset)
+	void TextureContext::tick()
 	{
-		const auto& snapShotUUID = asset->getSnapShotUUID();
-		if (!m_lruCache->contain(snapShotUUID))
+		m_tickCount++;
+
+		// Release residency no longer used by frames in flight.
+		while (!m_retiredResidencies.empty() && m_retiredResidencies.front().tickCount + RHI::GMaxSwapchainCount < m_tickCount)
 		{
-			auto newTask = SnapshotAssetTextureLoadTask::build(asset);
-			GpuUploader::get()->addTask(newTask);
+			Bindless::Texture->freeBindless(m_retiredResidencies.front().bindlessIndex);
+			m_retiredResidencies.pop_front();
 		}
 
-		CHECK(m_lruCache->contain(snapShotUUID));
-		return m_lruCache->tryGet(snapShotUUID);
+		// Remove streaming state of released images.
+		for (auto it = m_streamingTextures.begin(); it != m_streamingTextures.end();)
+		{
+			if (it->second.image.expired())
+			{
+				if (it->second.bindlessIndex != ~0 && m_bindlessOwners[it->second.bindlessIndex].streamingId == it->first)
+				{
+					m_bindlessOwners[it->second.bindlessIndex] = {};
+				}
+
+				m_residency.unregisterTexture(it->first);
+				it = m_streamingTextures.erase(it);
+			}
+			else
+			{
+				++it;
+			}
+		}
+
+		std::vector<std::shared_ptr<GPUImageAsset>> readyImages;
+		{
+			std::lock_guard lock(m_readyImagesMutex);
+			readyImages.swap(m_readyImages);
+		}
+
+		for (auto& image : readyImages)
+		{
+			if (image->isStreaming())
+			{
+				m_streamingTextures.at(image->m_streamingId).bindlessIndex = image->m_bindlessIndex;
+				m_bindlessOwners[image->m_bindlessIndex] = { image->m_streamingId, image->m_residentMip };
+			}
+
+			onImageReady.broadcast(image);
+		}
+
+		tickStreaming();
+
+		CVarCmdHandle(cVarTextureResidencyValidate, []()
+		{
+			TextureResidencyManager::validate();
+		});
+	}
+
+	void TextureContext::retireResidency(std::shared_ptr<VulkanImage> image, uint32_t bindlessIndex)
+	{
+		if (bindlessIndex != ~0)
+		{
+			m_bindlessOwners[bindlessIndex] = {};
+		}
+		m_retiredResidencies.push_back({ std::move(image), bindlessIndex, m_tickCount });
+	}
+
+	void TextureContext::tickStreaming()
+	{
+		std::vector<std::shared_ptr<ImageAssetStreamingTask>> readyTasks;
+		{
+			std::lock_guard lock(m_streamingReadyMutex);
+			readyTasks.swap(m_streamingReadyTasks);
+		}
+
+		// Swap new residency in, material rebuild with new bindless index when broadcast.
+		for (auto& task : readyTasks)
+		{
+			auto image = task->imageAssetGPU;
+			const uint32_t streamingId = image->m_streamingId;
+
+			retireResidency(image->m_image, image->m_bindlessIndex);
+
+			image->m_image = task->newImage;
+			image->m_bindlessIndex = task->newBindlessIndex;
+			image->m_residentMip = task->residentMip;
+
+			m_streamingTextures.at(streamingId).bindlessIndex = image->m_bindlessIndex;
+			m_bindlessOwners[image->m_bindlessIndex] = { streamingId, image->m_residentMip };
+			m_residency.commit(streamingId, image->m_residentMip);
+
+			onImageReady.broadcast(image);
+		}
+
+		if (cVarTextureStreamingEnable.get() == 0)
+		{
+			return;
+		}
+
+		TextureResidencyManager::Config config = m_residency.getConfig();
+		config.budgetSize = uint64_t(std::max(cVarTextureStreamingBudget.get(), 1)) * 1024ull * 1024ull;
+
+		// Streaming residency never over texture category budget.
+		if (const uint64_t textureBudget = MemoryBudget::get()->getCategoryBudget(EMemoryBudgetCategory::Texture); textureBudget > 0)
+		{
+			config.budgetSize = std::min(config.budgetSize, textureBudget);
+		}
+		config.maxUploadSizePerFrame = uint64_t(std::max(cVarTextureStreamingUploadPerFrame.get(), 1)) * 1024ull * 1024ull;
+		m_residency.setConfig(config);
+
+		for (const auto& request : m_residency.update())
+		{
+			const auto& streamingTexture = m_streamingTextures.at(request.id);
+			auto image = streamingTexture.image.lock();
+			CHECK(image);
+
+			GpuUploader::get()->addTask(std::make_shared<ImageAssetStreamingTask>(streamingTexture.header, image, request.residentMip));
+		}
+	}
+
+	void TextureContext::markStreamingReady(std::shared_ptr<ImageAssetStreamingTask> task)
+	{
+		std::lock_guard lock(m_streamingReadyMutex);
+		m_streamingReadyTasks.push_back(std::move(task));
+	}
+
+	void TextureContext::registerStreaming(std::shared_ptr<ImageAssetHeader> header, std::shared_ptr<GPUImageAsset> image, uint32_t tailMip)
+	{
+		CHECK(!image->isStreaming() && image->m_residentMip == tailMip);
+
+		std::vector<uint64_t> mipSizes(header->getMipmapCount());
+		for (uint32_t mip = 0; mip < mipSizes.size(); mip++)
+		{
+			const uint64_t mipWidth = std::max<uint32_t>(header->getWidth() >> mip, 1);
+			const uint64_t mipHeight = std::max<uint32_t>(header->getHeight() >> mip, 1);
+			mipSizes[mip] = mipWidth * mipHeight * GAssetTextureChannels;
+		}
+
+		image->m_streamingId = m_residency.registerTexture(mipSizes, tailMip);
+		m_streamingTextures[image->m_streamingId] = { image, header, ~0u };
+	}
+
+	void TextureContext::consumeFeedback(const uint32_t* feedback, uint32_t count)
+	{
+		count = std::min(count, uint32_t(m_bindlessOwners.size()));
+		for (uint32_t i = 0; i < count; i++)
+		{
+			const auto& owner = m_bindlessOwners[i];
+			if (feedback[i] != ~0u && owner.streamingId != TextureResidencyManager::kInvalidId)
+			{
+				m_residency.request(owner.streamingId, owner.residentMip + feedback[i]);
+			}
+		}
+	}
+
+	void TextureContext::markImageReady(std::shared_ptr<GPUImageAsset> image)
+	{
+		// Set state before push, so main thread never miss one ready image.
+		image->setAsyncLoadState(false);
+
+		std::lock_guard lock(m_readyImagesMutex);
+		m_readyImages.push_back(std::move(image));
 	}
 
 	std::shared_ptr<GPUImageAsset> TextureContext::getOrCreateImage(std::shared_ptr<ImageAssetHeader> asset)
@@ -615,71 +830,16 @@ namespace Flower
 		return newTask;
 	}
 
-	void SnapshotAssetTextureLoadTask::uploadFunction(
-		uint32_t stageBufferOffset,
-		RHICommandBufferBase& commandBuffer,
-		VulkanBuffer& stageBuffer)
-	{
-		stageBuffer.map();
-		memcpy((void*)((char*)stageBuffer.mapped + stageBufferOffset), cacheHeader->getSnapShotData().data(), uploadSize());
-		stageBuffer.unmap();
-
-		imageAssetGPU->prepareToUpload(commandBuffer, buildBasicImageSubresource());
-
-		VkBufferImageCopy region{};
-		region.bufferOffset = stageBufferOffset;
-		region.bufferRowLength = 0;
-		region.bufferImageHeight = 0;
-		region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-		region.imageSubresource.mipLevel = 0;
-		region.imageSubresource.baseArrayLayer = 0;
-		region.imageSubresource.layerCount = 1;
-		region.imageOffset = { 0, 0, 0 };
-		region.imageExtent = imageAssetGPU->getImage().getExtent();
-
-		vkCmdCopyBufferToImage(commandBuffer.cmd, stageBuffer, imageAssetGPU->getImage().getImage(), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
-
-		imageAssetGPU->finishUpload(commandBuffer, buildBasicImageSubresource());
-	}
-
-	std::shared_ptr<SnapshotAssetTextureLoadTask> SnapshotAssetTextureLoadTask::build(std::shared_ptr<ImageAssetHeader> inHeader)
-	{
-		auto* fallbackWhite = TextureManager::get()->getImage(EngineTextures::GWhiteTextureUUID).get();
-		CHECK(fallbackWhite && "Fallback texture must be valid, you forget init engine texture before init.");
-
-		std::shared_ptr<GPUImageAsset> newAsset = std::shared_ptr<GPUImageAsset>(new GPUImageAsset(
-			false,
-			fallbackWhite,
-			inHeader->getFormat(),
-			inHeader->getName(),
-			1,
-			inHeader->getSnapShotWidth(),
-			inHeader->getSnapShotHeight(),
-			1
-		));
-
-		// Register on LRU cache.
-		TextureManager::get()->insertGPUAsset(inHeader->getSnapShotUUID(), newAsset);
-
-		auto newTask = std::make_shared<SnapshotAssetTextureLoadTask>(inHeader);
-		newTask->imageAssetGPU = newAsset;
-		return newTask;
-	}
-
-
-	void ImageAssetTextureLoadTask::uploadFunction(
+	// Copy mips start from resident mip to image, image mip 0 is resident mip.
+	static void uploadImageAssetMips(
+		const ImageAssetHeader& header,
+		const ImageAssetBin& bin,
+		VulkanImage& image,
+		uint32_t residentMip,
 		uint32_t stageBufferOffset,
 		RHICommandBufferBase& commandBuffer,
 		VulkanBuffer& stageBuffer)
 	{
-		auto texBin = std::dynamic_pointer_cast<ImageAssetBin>(cacheHeader->loadBinData());
-		CHECK(texBin != nullptr);
-
-		VkImageSubresourceRange rangeAllMips = buildBasicImageSubresource();
-		rangeAllMips.levelCount = cacheHeader->getMipmapCount();
-
-		imageAssetGPU->prepareToUpload(commandBuffer, rangeAllMips);
-
 		stageBuffer.map();
 		uint32_t bufferOffset = stageBufferOffset;
 		uint32_t bufferSize = 0;
@@ -695,15 +855,54 @@ namespace Flower
 
 		std::vector<VkBufferImageCopy> copyRegions{};
 
-		if (texBin->getMipmapDatas().empty())
+		if (bin.getMipmapDatas().empty() && residentMip > 0)
+		{
+			// Old asset record mipmap count without mipmap data, resize from src for resident mips.
+			const auto& srcpDatas = bin.getRawDatas();
+			std::vector<uint8_t> mipData;
+			for (uint32_t level = residentMip; level < header.getMipmapCount(); level++)
+			{
+				uint32_t mipWidth = std::max<uint32_t>(header.getWidth() >> level, 1);
+				uint32_t mipHeight = std::max<uint32_t>(header.getHeight() >> level, 1);
+
+				mipData.resize(mipWidth * mipHeight * GAssetTextureChannels);
+				if (header.isSRGB())
+				{
+					stbir_resize_uint8_srgb(
+						srcpDatas.data(), header.getWidth(), header.getHeight(), 0,
+						mipData.data(), mipWidth, mipHeight, 0,
+						GAssetTextureChannels, GAssetTextureChannels - 1, 0);
+				}
+				else
+				{
+					stbir_resize_uint8(
+						srcpDatas.data(), header.getWidth(), header.getHeight(), 0,
+						mipData.data(), mipWidth, mipHeight, 0,
+						GAssetTextureChannels);
+				}
+
+				const uint32_t currentMipSize = (uint32_t)mipData.size();
+				memcpy((void*)((char*)stageBuffer.mapped + bufferOffset), mipData.data(), currentMipSize);
+
+				region.bufferOffset = bufferOffset;
+				region.imageSubresource.mipLevel = level - residentMip;
+				region.imageExtent = { mipWidth, mipHeight, 1 };
+
+				copyRegions.push_back(region);
+
+				bufferOffset += currentMipSize;
+				bufferSize += currentMipSize;
+			}
+		}
+		else if (bin.getMipmapDatas().empty())
 		{
 			// No mipmap, load from src.
-			const auto& srcpDatas = texBin->getRawDatas();
+			const auto& srcpDatas = bin.getRawDatas();
 
 			const uint32_t currentMipSize = (uint32_t)srcpDatas.size();
 
-			uint32_t mipWidth = cacheHeader->getWidth();
-			uint32_t mipHeight = cacheHeader->getHeight();
+			uint32_t mipWidth = header.getWidth();
+			uint32_t mipHeight = header.getHeight();
 
 			memcpy((void*)((char*)stageBuffer.mapped + bufferOffset), srcpDatas.data(), currentMipSize);
 
@@ -718,19 +917,19 @@ namespace Flower
 		}
 		else
 		{
-			const auto& mipmapDatas = texBin->getMipmapDatas();
-			for (uint32_t level = 0; level < cacheHeader->getMipmapCount(); level++)
+			const auto& mipmapDatas = bin.getMipmapDatas();
+			for (uint32_t level = residentMip; level < header.getMipmapCount(); level++)
 			{
 				const auto& currentMip = mipmapDatas.at(level);
 				const uint32_t currentMipSize = (uint32_t)currentMip.size();
 
-				uint32_t mipWidth = std::max<uint32_t>(cacheHeader->getWidth() >> level, 1);
-				uint32_t mipHeight = std::max<uint32_t>(cacheHeader->getHeight() >> level, 1);
+				uint32_t mipWidth = std::max<uint32_t>(header.getWidth() >> level, 1);
+				uint32_t mipHeight = std::max<uint32_t>(header.getHeight() >> level, 1);
 
 				memcpy((void*)((char*)stageBuffer.mapped + bufferOffset), currentMip.data(), currentMipSize);
 
 				region.bufferOffset = bufferOffset;
-				region.imageSubresource.mipLevel = level;
+				region.imageSubresource.mipLevel = level - residentMip;
 				region.imageExtent = { mipWidth, mipHeight, 1 };
 
 				copyRegions.push_back(region);
@@ -739,13 +938,28 @@ namespace Flower
 				bufferSize += currentMipSize;
 			}
 		}
-		
 
-		CHECK(uploadSize() >= bufferSize);
+		CHECK(image.getMemorySize() >= bufferSize);
 
-		vkCmdCopyBufferToImage(commandBuffer.cmd, stageBuffer, imageAssetGPU->getImage().getImage(), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, (uint32_t)copyRegions.size(), copyRegions.data());
+		vkCmdCopyBufferToImage(commandBuffer.cmd, stageBuffer, image.getImage(), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, (uint32_t)copyRegions.size(), copyRegions.data());
 
 		stageBuffer.unmap();
+	}
+
+	void ImageAssetTextureLoadTask::uploadFunction(
+		uint32_t stageBufferOffset,
+		RHICommandBufferBase& commandBuffer,
+		VulkanBuffer& stageBuffer)
+	{
+		auto texBin = std::dynamic_pointer_cast<ImageAssetBin>(cacheHeader->loadBinData());
+		CHECK(texBin != nullptr);
+
+		VkImageSubresourceRange rangeAllMips = buildBasicImageSubresource();
+		rangeAllMips.levelCount = cacheHeader->getMipmapCount() - imageAssetGPU->getResidentMip();
+
+		imageAssetGPU->prepareToUpload(commandBuffer, rangeAllMips);
+
+		uploadImageAssetMips(*cacheHeader, *texBin, imageAssetGPU->getImage(), imageAssetGPU->getResidentMip(), stageBufferOffset, commandBuffer, stageBuffer);
 
 		imageAssetGPU->finishUpload(commandBuffer, rangeAllMips);
 	}
@@ -756,17 +970,34 @@ namespace Flower
 		auto* fallbackWhite = TextureManager::get()->getImage(EngineTextures::GWhiteTextureUUID).get();
 		CHECK(fallbackWhite && "Fallback texture must be valid, you forget init engine texture before init.");
 
+		// Only mipmapped ldr texture stream, first upload tail mips and wait feedback request.
+		uint32_t tailMip = 0;
+		if (cVarTextureStreamingEnable.get() != 0 && !inHeader->isHdr() && inHeader->getMipmapCount() > 1)
+		{
+			while (tailMip + 1 < inHeader->getMipmapCount()
+				&& std::max(inHeader->getWidth() >> tailMip, inHeader->getHeight() >> tailMip) > GTextureStreamingTailDim)
+			{
+				tailMip++;
+			}
+		}
+
 		std::shared_ptr<GPUImageAsset> newAsset = std::shared_ptr<GPUImageAsset>(new GPUImageAsset(
 			false,
 			fallbackWhite,
 			inHeader->getFormat(),
 			inHeader->getName(),
-			inHeader->getMipmapCount(),
-			inHeader->getWidth(),
-			inHeader->getHeight(),
-			1
+			inHeader->getMipmapCount() - tailMip,
+			std::max<uint32_t>(inHeader->getWidth() >> tailMip, 1),
+			std::max<uint32_t>(inHeader->getHeight() >> tailMip, 1),
+			1,
+			tailMip
 		));
 
+		if (tailMip > 0)
+		{
+			TextureManager::get()->registerStreaming(inHeader, newAsset, tailMip);
+		}
+
 		// Register on LRU cache.
 		TextureManager::get()->insertGPUAsset(inHeader->getHeaderUUID(), newAsset);
 
@@ -775,5 +1006,42 @@ namespace Flower
 		return newTask;
 	}
 
+	ImageAssetStreamingTask::ImageAssetStreamingTask(
+		std::shared_ptr<ImageAssetHeader> inHeader,
+		std::shared_ptr<GPUImageAsset> inImage,
+		uint32_t inResidentMip)
+		: cacheHeader(inHeader), imageAssetGPU(inImage), residentMip(inResidentMip)
+	{
+		newImage = GPUImageAsset::createImage(
+			inHeader->getFormat(),
+			inHeader->getName(),
+			inHeader->getMipmapCount() - residentMip,
+			std::max<uint32_t>(inHeader->getWidth() >> residentMip, 1),
+			std::max<uint32_t>(inHeader->getHeight() >> residentMip, 1),
+			1);
+	}
+
+	void ImageAssetStreamingTask::uploadFunction(
+		uint32_t stageBufferOffset,
+		RHICommandBufferBase& commandBuffer,
+		VulkanBuffer& stageBuffer)
+	{
+		// Bin data reload from disk when no other user keep it, streaming never cache full chain on cpu.
+		auto texBin = std::dynamic_pointer_cast<ImageAssetBin>(cacheHeader->loadBinData());
+		CHECK(texBin != nullptr);
+
+		VkImageSubresourceRange rangeAllMips = buildBasicImageSubresource();
+		rangeAllMips.levelCount = cacheHeader->getMipmapCount() - residentMip;
+
+		newImage->transitionLayout(commandBuffer, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, rangeAllMips);
+
+		uploadImageAssetMips(*cacheHeader, *texBin, *newImage, residentMip, stageBufferOffset, commandBuffer, stageBuffer);
+
+		newImage->transitionLayout(commandBuffer, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, rangeAllMips);
+		newBindlessIndex = Bindless::Texture->updateTextureToBindlessDescriptorSet(newImage->getView(buildBasicImageSubresource()));
+
+		CHECK(newBindlessIndex != ~0);
+	}
+
 
 }
\ No newline at end of file
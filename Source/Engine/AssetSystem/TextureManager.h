@@ -2,6 +2,7 @@
 #include "AssetCommon.h"
 #include "LRUCache.h"
 #include "AsyncUploader.h"
+#include "TextureResidency.h"
 
 
 namespace Flower
@@ -193,12 +194,24 @@ namespace Flower
 		}
 	};
 
+	// Texture mip chain start streaming when its tail mip dimension no bigger than this.
+	constexpr uint32_t GTextureStreamingTailDim = 128;
+
 	class GPUImageAsset : public LRUAssetInterface
 	{
+		friend class TextureContext;
+
 	private:
 		std::shared_ptr<VulkanImage> m_image = nullptr;
 		uint32_t m_bindlessIndex = ~0;
 
+		// Streaming image only keep mips start from resident mip, image mip 0 is resident mip of full chain.
+		uint32_t m_residentMip = 0;
+		uint32_t m_streamingId = TextureResidencyManager::kInvalidId;
+
+		// Lru cache size fix when create, streamed mips count in residency budget.
+		size_t m_lruSize = 0;
+
 	public:
 		GPUImageAsset(
 			bool bPersistent,
@@ -208,16 +221,35 @@ namespace Flower
 			uint32_t mipmapCount,
 			uint32_t width,
 			uint32_t height,
-			uint32_t depth
+			uint32_t depth,
+			uint32_t residentMip = 0
 		);
 
 		virtual ~GPUImageAsset();
 
+		static std::shared_ptr<VulkanImage> createImage(
+			VkFormat format,
+			const std::string& name,
+			uint32_t mipmapCount,
+			uint32_t width,
+			uint32_t height,
+			uint32_t depth);
+
 		uint32_t getBindlessIndex()
 		{
 			return getReadyAsset()->m_bindlessIndex;
 		}
 
+		uint32_t getResidentMip() const
+		{
+			return m_residentMip;
+		}
+
+		bool isStreaming() const
+		{
+			return m_streamingId != TextureResidencyManager::kInvalidId;
+		}
+
 		// Prepare image layout when start to upload.
 		void prepareToUpload(RHICommandBufferBase& cmd, VkImageSubresourceRange range);
 
@@ -226,7 +258,7 @@ namespace Flower
 
 		virtual size_t getSize() const override
 		{
-			return m_image->getMemorySize();
+			return m_lruSize;
 		}
 
 		auto& getImage()
@@ -245,16 +277,79 @@ namespace Flower
 		}
 	};
 
+	struct ImageAssetStreamingTask;
+
 	class TextureContext : NonCopyable
 	{
 	private:
 		std::unique_ptr<LRUAssetCache<GPUImageAsset>> m_lruCache;
 
+		// Images finish upload on uploader threads, wait main thread tick to broadcast.
+		std::mutex m_readyImagesMutex;
+		std::vector<std::shared_ptr<GPUImageAsset>> m_readyImages;
+
+		// Mip streaming state, all edit on main thread.
+		struct StreamingTexture
+		{
+			std::weak_ptr<GPUImageAsset> image;
+			std::shared_ptr<ImageAssetHeader> header;
+			uint32_t bindlessIndex = ~0;
+		};
+		TextureResidencyManager m_residency;
+		std::unordered_map<uint32_t, StreamingTexture> m_streamingTextures;
+
+		// Feedback buffer index by bindless index, map back to residency id and resident mip of that view.
+		struct BindlessOwner
+		{
+			uint32_t streamingId = TextureResidencyManager::kInvalidId;
+			uint32_t residentMip = 0;
+		};
+		std::vector<BindlessOwner> m_bindlessOwners;
+
+		// Streaming uploads finish on uploader threads, swap on main thread tick.
+		std::mutex m_streamingReadyMutex;
+		std::vector<std::shared_ptr<ImageAssetStreamingTask>> m_streamingReadyTasks;
+
+		// Replaced residency may still used by frames in flight, release delay.
+		struct RetiredResidency
+		{
+			std::shared_ptr<VulkanImage> image;
+			uint32_t bindlessIndex;
+			uint64_t tickCount;
+		};
+		std::deque<RetiredResidency> m_retiredResidencies;
+		uint64_t m_tickCount = 0;
+
+	private:
+		void retireResidency(std::shared_ptr<VulkanImage> image, uint32_t bindlessIndex);
+		void tickStreaming();
+
 	public:
 		TextureContext() = default;
 
+		// Broadcast on main thread when one image finish upload, or streaming image resident mips change.
+		MulticastDelegate<std::shared_ptr<GPUImageAsset>> onImageReady;
+
 		void init();
 		void release();
+		void tick();
+
+		// Thread safe, call by load task when image upload finish.
+		void markImageReady(std::shared_ptr<GPUImageAsset> image);
+
+		// Thread safe, call by streaming task when new resident mips upload finish.
+		void markStreamingReady(std::shared_ptr<ImageAssetStreamingTask> task);
+
+		// Call on main thread when new streaming image create, image start with tail mips only.
+		void registerStreaming(std::shared_ptr<ImageAssetHeader> header, std::shared_ptr<GPUImageAsset> image, uint32_t tailMip);
+
+		// Gpu feedback, finest mip sampled per bindless texture relative to view base mip, ~0 is unused.
+		void consumeFeedback(const uint32_t* feedback, uint32_t count);
+
+		const TextureResidencyManager& getResidency() const
+		{
+			return m_residency;
+		}
 
 		bool isAssetExist(const UUID& id)
 		{
@@ -271,7 +366,6 @@ namespace Flower
 			return m_lruCache->tryGet(id);
 		}
 
-		std::shared_ptr<GPUImageAsset> getOrCreateLRUSnapShot(std::shared_ptr<ImageAssetHeader> asset);
 		std::shared_ptr<GPUImageAsset> getOrCreateImage(std::shared_ptr<ImageAssetHeader> asset);
 	};
 
@@ -286,7 +380,7 @@ namespace Flower
 
 		virtual uint32_t uploadSize() const override
 		{
-			return uint32_t(imageAssetGPU->getSize());
+			return uint32_t(imageAssetGPU->getImage().getMemorySize());
 		}
 	};
 
@@ -299,7 +393,7 @@ namespace Flower
 
 		virtual void finishCallback() override
 		{
-			imageAssetGPU->setAsyncLoadState(false);
+			TextureManager::get()->markImageReady(imageAssetGPU);
 		}
 
 		virtual void uploadFunction(
@@ -323,10 +417,9 @@ namespace Flower
 			VkFormat format = VK_FORMAT_R8G8B8A8_UNORM);
 	};
 
-	// Load from asset header snapshot data, no compress, cache in lru map.
-	struct SnapshotAssetTextureLoadTask : public AssetTextureLoadTask
+	struct ImageAssetTextureLoadTask : public AssetTextureLoadTask
 	{
-		explicit SnapshotAssetTextureLoadTask(std::shared_ptr<ImageAssetHeader> inHeader)
+		explicit ImageAssetTextureLoadTask(std::shared_ptr<ImageAssetHeader> inHeader)
 			: cacheHeader(inHeader)
 		{
 
@@ -336,7 +429,7 @@ namespace Flower
 
 		virtual void finishCallback() override
 		{
-			imageAssetGPU->setAsyncLoadState(false);
+			TextureManager::get()->markImageReady(imageAssetGPU);
 		}
 
 		virtual void uploadFunction(
@@ -344,30 +437,40 @@ namespace Flower
 			RHICommandBufferBase& commandBuffer,
 			VulkanBuffer& stageBuffer) override;
 
-		static std::shared_ptr<SnapshotAssetTextureLoadTask> build(std::shared_ptr<ImageAssetHeader> inHeader);
+		static std::shared_ptr<ImageAssetTextureLoadTask> build(std::shared_ptr<ImageAssetHeader> inHeader);
 	};
 
-	struct ImageAssetTextureLoadTask : public AssetTextureLoadTask
+	// Reupload mips start from new resident mip into one new image, swap on main thread when finish.
+	struct ImageAssetStreamingTask : public AssetLoadTask, public std::enable_shared_from_this<ImageAssetStreamingTask>
 	{
-		explicit ImageAssetTextureLoadTask(std::shared_ptr<ImageAssetHeader> inHeader)
-			: cacheHeader(inHeader)
-		{
-
-		}
+		ImageAssetStreamingTask(
+			std::shared_ptr<ImageAssetHeader> inHeader,
+			std::shared_ptr<GPUImageAsset> inImage,
+			uint32_t inResidentMip);
 
 		std::shared_ptr<ImageAssetHeader> cacheHeader;
 
+		// Streaming image, only read on uploader thread.
+		std::shared_ptr<GPUImageAsset> imageAssetGPU;
+
+		uint32_t residentMip;
+		std::shared_ptr<VulkanImage> newImage;
+		uint32_t newBindlessIndex = ~0;
+
 		virtual void finishCallback() override
 		{
-			imageAssetGPU->setAsyncLoadState(false);
+			TextureManager::get()->markStreamingReady(shared_from_this());
+		}
+
+		virtual uint32_t uploadSize() const override
+		{
+			return uint32_t(newImage->getMemorySize());
 		}
 
 		virtual void uploadFunction(
 			uint32_t stageBufferOffset,
 			RHICommandBufferBase& commandBuffer,
 			VulkanBuffer& stageBuffer) override;
-
-		static std::shared_ptr<ImageAssetTextureLoadTask> build(std::shared_ptr<ImageAssetHeader> inHeader);
 	};
 }
 
@@ -0,0 +1,465 @@
+#include "Pch.h"
+#include "TextureResidency.h"
+
+namespace Flower
+{
+	uint64_t TextureResidencyManager::getChainSize(const TextureState& state, uint32_t firstMip) const
+	{
+		uint64_t size = 0;
+		for (uint32_t mip = firstMip; mip < state.mipSizes.size(); mip++)
+		{
+			size += state.mipSizes[mip];
+		}
+		return size;
+	}
+
+	uint32_t TextureResidencyManager::getDesireMip(const TextureState& state) const
+	{
+		for (uint32_t mip = 0; mip < state.tailMip; mip++)
+		{
+			const uint64_t requestFrame = state.mipRequestFrames[mip];
+			if (requestFrame != 0 && requestFrame + m_config.dropDelayFrames >= m_frame)
+			{
+				return mip;
+			}
+		}
+		return state.tailMip;
+	}
+
+	uint64_t TextureResidencyManager::getResidentRequestFrame(const TextureState& state) const
+	{
+		// Coarser mip request no need current finest resident mip, so only care finer part.
+		uint64_t requestFrame = 0;
+		for (uint32_t mip = 0; mip <= state.residentMip; mip++)
+		{
+			requestFrame = std::max(requestFrame, state.mipRequestFrames[mip]);
+		}
+		return requestFrame;
+	}
+
+	void TextureResidencyManager::issue(uint32_t id, uint32_t residentMip, std::vector<Request>& outRequests)
+	{
+		auto& state = m_textures[id];
+		CHECK(state.pendingMip == state.residentMip);
+
+		m_residentSize -= getChainSize(state, state.residentMip);
+		m_residentSize += getChainSize(state, residentMip);
+
+		state.pendingMip = residentMip;
+		outRequests.push_back({ id, residentMip });
+	}
+
+	uint32_t TextureResidencyManager::registerTexture(const std::vector<uint64_t>& mipSizes, uint32_t tailMip)
+	{
+		CHECK(tailMip < mipSizes.size());
+
+		uint32_t id;
+		if (!m_freeIds.empty())
+		{
+			id = m_freeIds.back();
+			m_freeIds.pop_back();
+		}
+		else
+		{
+			id = uint32_t(m_textures.size());
+			m_textures.emplace_back();
+		}
+
+		auto& state = m_textures[id];
+		state.bValid = true;
+		state.mipSizes = mipSizes;
+		state.mipRequestFrames.assign(mipSizes.size(), 0);
+		state.tailMip = tailMip;
+		state.residentMip = tailMip;
+		state.pendingMip = tailMip;
+
+		m_residentSize += getChainSize(state, tailMip);
+		return id;
+	}
+
+	void TextureResidencyManager::unregisterTexture(uint32_t id)
+	{
+		if (!isValid(id))
+		{
+			return;
+		}
+
+		auto& state = m_textures[id];
+		m_residentSize -= getChainSize(state, state.pendingMip);
+
+		state = {};
+		m_freeIds.push_back(id);
+	}
+
+	void TextureResidencyManager::request(uint32_t id, uint32_t mip)
+	{
+		if (!isValid(id))
+		{
+			return;
+		}
+
+		auto& state = m_textures[id];
+		state.mipRequestFrames[std::min(mip, state.tailMip)] = m_frame;
+	}
+
+	void TextureResidencyManager::commit(uint32_t id, uint32_t residentMip)
+	{
+		if (!isValid(id))
+		{
+			return;
+		}
+
+		auto& state = m_textures[id];
+
+		// Cancel request, size already count with pending mip.
+		if (residentMip != state.pendingMip)
+		{
+			m_residentSize -= getChainSize(state, state.pendingMip);
+			m_residentSize += getChainSize(state, residentMip);
+		}
+
+		state.residentMip = residentMip;
+		state.pendingMip = residentMip;
+	}
+
+	std::vector<TextureResidencyManager::Request> TextureResidencyManager::update()
+	{
+		std::vector<Request> requests;
+
+		struct Upgrade
+		{
+			uint32_t id;
+			uint32_t desireMip;
+		};
+		std::vector<Upgrade> upgrades;
+
+		// Drop first, free space for upgrade.
+		for (uint32_t id = 0; id < m_textures.size(); id++)
+		{
+			const auto& state = m_textures[id];
+			if (!state.bValid || state.pendingMip != state.residentMip)
+			{
+				continue;
+			}
+
+			const uint32_t desireMip = getDesireMip(state);
+			if (desireMip > state.residentMip)
+			{
+				issue(id, desireMip, requests);
+			}
+			else if (desireMip < state.residentMip)
+			{
+				upgrades.push_back({ id, desireMip });
+			}
+		}
+
+		// Most blurry texture first.
+		std::sort(upgrades.begin(), upgrades.end(), [&](const Upgrade& a, const Upgrade& b)
+		{
+			const uint32_t gapA = m_textures[a.id].residentMip - a.desireMip;
+			const uint32_t gapB = m_textures[b.id].residentMip - b.desireMip;
+			return gapA != gapB ? gapA > gapB : a.id < b.id;
+		});
+
+		// Evict candidates build lazy, only when over budget.
+		std::vector<uint32_t> evictCandidates;
+		size_t evictPos = 0;
+		bool bEvictCandidatesBuilt = false;
+
+		auto buildEvictCandidates = [&]()
+		{
+			bEvictCandidatesBuilt = true;
+			for (uint32_t id = 0; id < m_textures.size(); id++)
+			{
+				const auto& state = m_textures[id];
+				if (state.bValid
+					&& state.pendingMip == state.residentMip
+					&& state.residentMip < state.tailMip
+					&& getResidentRequestFrame(state) < m_frame)
+				{
+					evictCandidates.push_back(id);
+				}
+			}
+
+			// Least recently used first.
+			std::sort(evictCandidates.begin(), evictCandidates.end(), [&](uint32_t a, uint32_t b)
+			{
+				return getResidentRequestFrame(m_textures[a]) < getResidentRequestFrame(m_textures[b]);
+			});
+		};
+
+		uint64_t uploadSize = 0;
+		bool bAnyUpload = false;
+		for (const auto& upgrade : upgrades)
+		{
+			const auto& state = m_textures[upgrade.id];
+			if (state.pendingMip != state.residentMip)
+			{
+				continue; // Evicted by previous upgrade.
+			}
+
+			// Upgrade reupload whole new chain.
+			const uint64_t newSize = getChainSize(state, upgrade.desireMip);
+			const uint64_t growSize = newSize - getChainSize(state, state.residentMip);
+
+			if (bAnyUpload && uploadSize + newSize > m_config.maxUploadSizePerFrame)
+			{
+				break;
+			}
+
+			// Evict one mip of least recently used texture until fit budget.
+			while (m_residentSize + growSize > m_config.budgetSize)
+			{
+				if (!bEvictCandidatesBuilt)
+				{
+					buildEvictCandidates();
+				}
+
+				if (evictPos >= evictCandidates.size())
+				{
+					break;
+				}
+
+				const uint32_t evictId = evictCandidates[evictPos++];
+				const auto& evictState = m_textures[evictId];
+				if (evictId == upgrade.id || evictState.pendingMip != evictState.residentMip)
+				{
+					continue;
+				}
+				issue(evictId, evictState.residentMip + 1, requests);
+			}
+
+			if (m_residentSize + growSize > m_config.budgetSize)
+			{
+				continue;
+			}
+
+			issue(upgrade.id, upgrade.desireMip, requests);
+			uploadSize += newSize;
+			bAnyUpload = true;
+		}
+
+		m_frame++;
+		return requests;
+	}
+
+	bool TextureResidencyManager::validate()
+	{
+		ValidateReport report("TextureResidency");
+
+		// Size must always equal sum of valid texture chains at pending mip.
+		auto checkResidentSize = [&](const TextureResidencyManager& manager)
+		{
+			uint64_t size = 0;
+			for (const auto& state : manager.m_textures)
+			{
+				if (state.bValid)
+				{
+					size += manager.getChainSize(state, state.pendingMip);
+				}
+			}
+			report.expect(size == manager.getResidentSize(), "resident size accounting mismatch");
+		};
+
+		// Each mip quarter of previous, tail start from mip 3.
+		const std::vector<uint64_t> mipSizes = { 4096, 1024, 256, 64, 16, 4 };
+		constexpr uint32_t kTailMip = 3;
+		constexpr uint64_t kTailSize = 64 + 16 + 4;
+		constexpr uint64_t kFullSize = 4096 + 1024 + 256 + kTailSize;
+
+		// Upgrade, drop after delay, cancel and id reuse.
+		{
+			TextureResidencyManager manager;
+			Config config;
+			config.budgetSize = 1 << 20;
+			config.maxUploadSizePerFrame = 1 << 20;
+			config.dropDelayFrames = 4;
+			manager.setConfig(config);
+
+			const uint32_t id = manager.registerTexture(mipSizes, kTailMip);
+			report.expect(manager.getResidentSize() == kTailSize, "register only count tail mips");
+
+			manager.request(id, 0);
+			auto requests = manager.update();
+			report.expect(requests.size() == 1 && requests[0].id == id && requests[0].residentMip == 0, "requested mip not issue");
+			report.expect(manager.getResidentSize() == kFullSize, "in flight upgrade not count");
+			report.expect(manager.update().empty(), "in flight texture issue again");
+			manager.commit(id, 0);
+			report.expect(manager.getResidentMip(id) == 0, "commit not apply");
+
+			// Request happen two frames ago now, one frame already past the delay window.
+			for (uint32_t frame = 1; frame < config.dropDelayFrames; frame++)
+			{
+				report.expect(manager.update().empty(), "drop before delay frames");
+			}
+			requests = manager.update();
+			report.expect(requests.size() == 1 && requests[0].residentMip == kTailMip, "no drop after delay frames");
+			manager.commit(id, kTailMip);
+			report.expect(manager.getResidentSize() == kTailSize, "drop not release size");
+
+			// Cancel restore old mip and size.
+			manager.request(id, 1);
+			requests = manager.update();
+			report.expect(requests.size() == 1 && requests[0].residentMip == 1, "coarse request not issue");
+			manager.commit(id, kTailMip);
+			report.expect(manager.getResidentMip(id) == kTailMip && manager.getResidentSize() == kTailSize, "cancel not restore");
+
+			manager.unregisterTexture(id);
+			report.expect(manager.getResidentSize() == 0 && !manager.isValid(id), "unregister not release");
+			report.expect(manager.registerTexture(mipSizes, kTailMip) == id, "free id not reuse");
+			checkResidentSize(manager);
+		}
+
+		// Over budget evict least recently used texture, recently requested texture keep.
+		{
+			TextureResidencyManager manager;
+			Config config;
+			config.budgetSize = 2 * kFullSize + kTailSize;
+			config.maxUploadSizePerFrame = 1 << 20;
+			config.dropDelayFrames = 1000;
+			manager.setConfig(config);
+
+			const uint32_t old = manager.registerTexture(mipSizes, kTailMip);
+			const uint32_t keep = manager.registerTexture(mipSizes, kTailMip);
+			const uint32_t fresh = manager.registerTexture(mipSizes, kTailMip);
+
+			auto commitAll = [&](const std::vector<Request>& requests)
+			{
+				for (const auto& request : requests)
+				{
+					manager.commit(request.id, request.residentMip);
+				}
+			};
+
+			manager.request(old, 0);
+			manager.request(keep, 0);
+			commitAll(manager.update());
+
+			for (uint32_t frame = 0; frame < 8; frame++)
+			{
+				manager.request(keep, 0);
+				manager.request(fresh, 0);
+				commitAll(manager.update());
+				report.expect(manager.getResidentSize() <= config.budgetSize, "budget exceed");
+			}
+
+			report.expect(manager.getResidentMip(keep) == 0, "recently used texture evicted");
+			report.expect(manager.getResidentMip(fresh) == 0, "requested texture no upgrade after evict");
+			report.expect(manager.getResidentMip(old) > 0, "least recently used texture no evict");
+			checkResidentSize(manager);
+		}
+
+		// Random feedback with upload latency, cancel and texture churn.
+		{
+			std::mt19937 rng(1234u);
+
+			TextureResidencyManager manager;
+			Config config;
+			config.dropDelayFrames = 30;
+
+			constexpr uint32_t kTextureCount = 128;
+			constexpr uint32_t kFrameCount = 1000;
+			constexpr uint32_t kUploadLatency = 3;
+
+			auto buildMipSizes = [&]()
+			{
+				const uint32_t mipCount = 8 + rng() % 5;
+				std::vector<uint64_t> sizes(mipCount);
+				for (uint32_t mip = 0; mip < mipCount; mip++)
+				{
+					sizes[mip] = std::max<uint64_t>(16, (1ull << (2 * (mipCount - mip))) * 4);
+				}
+				return sizes;
+			};
+
+			std::vector<uint32_t> ids(kTextureCount);
+			uint64_t fullSize = 0;
+			for (auto& id : ids)
+			{
+				const auto sizes = buildMipSizes();
+				id = manager.registerTexture(sizes, uint32_t(sizes.size()) - 4);
+				fullSize += std::accumulate(sizes.begin(), sizes.end(), uint64_t(0));
+			}
+
+			config.budgetSize = fullSize / 4;
+			config.maxUploadSizePerFrame = config.budgetSize / 16;
+			manager.setConfig(config);
+
+			struct InFlight
+			{
+				Request request;
+				uint64_t commitFrame;
+			};
+			std::deque<InFlight> inFlights;
+
+			for (uint64_t frame = 0; frame < kFrameCount + config.dropDelayFrames + 2 * kUploadLatency + 4; frame++)
+			{
+				// Camera see a moving window of textures, stop at end so all drop to tail.
+				if (frame < kFrameCount)
+				{
+					const uint32_t windowBegin = uint32_t((frame / 50) * 16 % kTextureCount);
+					for (uint32_t i = 0; i < 32; i++)
+					{
+						const uint32_t id = ids[(windowBegin + i) % kTextureCount];
+						manager.request(id, rng() % 4);
+					}
+
+					// Texture release and new one load.
+					if (rng() % 20 == 0)
+					{
+						auto& id = ids[rng() % kTextureCount];
+						std::erase_if(inFlights, [&](const InFlight& inFlight) { return inFlight.request.id == id; });
+						manager.unregisterTexture(id);
+
+						const auto sizes = buildMipSizes();
+						id = manager.registerTexture(sizes, uint32_t(sizes.size()) - 4);
+					}
+				}
+
+				const uint64_t sizeBefore = manager.getResidentSize();
+				const auto requests = manager.update();
+
+				uint64_t upgradeSize = 0;
+				uint32_t upgradeCount = 0;
+				for (const auto& request : requests)
+				{
+					const auto& state = manager.m_textures[request.id];
+					if (request.residentMip < state.residentMip)
+					{
+						upgradeSize += manager.getChainSize(state, request.residentMip);
+						upgradeCount++;
+					}
+					inFlights.push_back({ request, frame + kUploadLatency });
+				}
+
+				report.expect(upgradeCount <= 1 || upgradeSize <= config.maxUploadSizePerFrame, "upload size exceed per frame limit");
+				report.expect(manager.getResidentSize() <= std::max(config.budgetSize, sizeBefore), "upgrade exceed budget");
+				checkResidentSize(manager);
+
+				while (!inFlights.empty() && inFlights.front().commitFrame <= frame)
+				{
+					const Request request = inFlights.front().request;
+					inFlights.pop_front();
+
+					// One of ten upload fail while camera move, commit old resident mip cancel it.
+					const bool bCancel = (frame < kFrameCount) && (rng() % 10 == 0);
+					manager.commit(request.id, bCancel ? manager.getResidentMip(request.id) : request.residentMip);
+				}
+				checkResidentSize(manager);
+			}
+
+			uint64_t tailSize = 0;
+			for (const auto& state : manager.m_textures)
+			{
+				if (state.bValid)
+				{
+					report.expect(state.residentMip == state.tailMip, "no requested texture keep finer mip");
+					tailSize += manager.getChainSize(state, state.tailMip);
+				}
+			}
+			report.expect(manager.getResidentSize() == tailSize, "resident size not back to tail size");
+		}
+
+		return report.finish();
+	}
+}
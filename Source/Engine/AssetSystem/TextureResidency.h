@@ -0,0 +1,108 @@
+#pragma once
+#include "../Core/Core.h"
+
+namespace Flower
+{
+	// Cpu side texture mip residency decision, no vulkan object inside.
+	// Input is per texture mip size and per frame feedback request, output is which texture should
+	// change its first resident mip. Caller own the gpu work and commit result back when upload finish.
+	//
+	// Mip 0 is finest, tail mip is coarsest first resident mip and always keep resident.
+	class TextureResidencyManager : NonCopyable
+	{
+	public:
+		static constexpr uint32_t kInvalidId = ~0u;
+
+		struct Config
+		{
+			// Streamed texture memory budget, tail mips also count in.
+			uint64_t budgetSize = 1024ull * 1024ull * 1024ull;
+
+			// Max upload size of new residency per frame, at least one request always issue.
+			uint64_t maxUploadSizePerFrame = 32ull * 1024ull * 1024ull;
+
+			// Mip no requested after this frames will drop.
+			uint32_t dropDelayFrames = 120;
+		};
+
+		struct Request
+		{
+			uint32_t id;
+			uint32_t residentMip; // New first resident mip.
+		};
+
+	private:
+		struct TextureState
+		{
+			bool bValid = false;
+
+			// Per mip size in bytes.
+			std::vector<uint64_t> mipSizes;
+
+			// Last frame one mip requested.
+			std::vector<uint64_t> mipRequestFrames;
+
+			uint32_t tailMip = 0;
+			uint32_t residentMip = 0;
+
+			// Equal to resident mip when no request in flight.
+			uint32_t pendingMip = 0;
+		};
+
+		Config m_config { };
+
+		std::vector<TextureState> m_textures;
+		std::vector<uint32_t> m_freeIds;
+
+		uint64_t m_frame = 1;
+
+		// Size of all texture resident mips, in flight request use target mip size.
+		uint64_t m_residentSize = 0;
+
+	private:
+		uint64_t getChainSize(const TextureState& state, uint32_t firstMip) const;
+
+		// Finest mip requested in drop delay frames.
+		uint32_t getDesireMip(const TextureState& state) const;
+
+		// Frame when current resident mip last requested, use for lru evict.
+		uint64_t getResidentRequestFrame(const TextureState& state) const;
+
+		void issue(uint32_t id, uint32_t residentMip, std::vector<Request>& outRequests);
+
+	public:
+		TextureResidencyManager() = default;
+
+		void setConfig(const Config& config) { m_config = config; }
+		const Config& getConfig() const { return m_config; }
+
+		uint64_t getResidentSize() const { return m_residentSize; }
+		uint64_t getFrame() const { return m_frame; }
+
+		// Texture init with tail mip resident.
+		uint32_t registerTexture(const std::vector<uint64_t>& mipSizes, uint32_t tailMip);
+		void unregisterTexture(uint32_t id);
+
+		bool isValid(uint32_t id) const
+		{
+			return id < m_textures.size() && m_textures[id].bValid;
+		}
+
+		uint32_t getResidentMip(uint32_t id) const
+		{
+			return m_textures.at(id).residentMip;
+		}
+
+		// Feedback input, mip is absolute mip level.
+		void request(uint32_t id, uint32_t mip);
+
+		// Call when request upload finish, or with old resident mip when request cancel.
+		void commit(uint32_t id, uint32_t residentMip);
+
+		// Tick once per frame after all feedback input, return new residency requests.
+		std::vector<Request> update();
+
+		// Run scripted and random residency scenarios on local managers, check budget, upload limit and size accounting.
+		static bool validate();
+	};
+}
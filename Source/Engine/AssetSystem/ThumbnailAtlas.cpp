@@ -0,0 +1,543 @@
+#include "Pch.h"
+#include "ThumbnailAtlas.h"
+#include "TextureManager.h"
+
+namespace Flower
+{
+	ThumbnailSlotAllocator::ThumbnailSlotAllocator(uint32_t slotCount)
+	{
+		m_slots.resize(slotCount);
+
+		// Pop back, so slot 0 allocate first.
+		m_freeSlots.reserve(slotCount);
+		for (uint32_t i = slotCount; i > 0; i--)
+		{
+			m_freeSlots.push_back(i - 1);
+		}
+	}
+
+	void ThumbnailSlotAllocator::unlink(uint32_t slot)
+	{
+		auto& state = m_slots[slot];
+
+		if (state.prev != kInvalidSlot) { m_slots[state.prev].next = state.next; }
+		else { m_lruHead = state.next; }
+
+		if (state.next != kInvalidSlot) { m_slots[state.next].prev = state.prev; }
+		else { m_lruTail = state.prev; }
+
+		state.prev = kInvalidSlot;
+		state.next = kInvalidSlot;
+	}
+
+	void ThumbnailSlotAllocator::pushFront(uint32_t slot)
+	{
+		auto& state = m_slots[slot];
+
+		state.prev = kInvalidSlot;
+		state.next = m_lruHead;
+
+		if (m_lruHead != kInvalidSlot)
+		{
+			m_slots[m_lruHead].prev = slot;
+		}
+		m_lruHead = slot;
+
+		if (m_lruTail == kInvalidSlot)
+		{
+			m_lruTail = slot;
+		}
+	}
+
+	uint32_t ThumbnailSlotAllocator::find(const UUID& owner)
+	{
+		auto it = m_ownerMap.find(owner);
+		if (it == m_ownerMap.end())
+		{
+			return kInvalidSlot;
+		}
+
+		const uint32_t slot = it->second;
+		m_slots[slot].lastUseFrame = m_frame;
+		if (m_lruHead != slot)
+		{
+			unlink(slot);
+			pushFront(slot);
+		}
+		return slot;
+	}
+
+	uint32_t ThumbnailSlotAllocator::acquire(const UUID& owner, bool& bNewSlot, UUID* evictedOwner)
+	{
+		bNewSlot = false;
+
+		uint32_t slot = find(owner);
+		if (slot != kInvalidSlot)
+		{
+			return slot;
+		}
+
+		if (!m_freeSlots.empty())
+		{
+			slot = m_freeSlots.back();
+			m_freeSlots.pop_back();
+		}
+		else
+		{
+			// Tail is least recently used, if it used in this frame all slot used in this frame.
+			if (m_lruTail == kInvalidSlot || m_slots[m_lruTail].lastUseFrame == m_frame)
+			{
+				return kInvalidSlot;
+			}
+
+			slot = m_lruTail;
+			unlink(slot);
+
+			if (evictedOwner)
+			{
+				*evictedOwner = m_slots[slot].owner;
+			}
+			m_ownerMap.erase(m_slots[slot].owner);
+			m_evictCount++;
+		}
+
+		auto& state = m_slots[slot];
+		state.owner = owner;
+		state.bUsed = true;
+		state.lastUseFrame = m_frame;
+
+		pushFront(slot);
+		m_ownerMap[owner] = slot;
+
+		bNewSlot = true;
+		return slot;
+	}
+
+	void ThumbnailSlotAllocator::release(const UUID& owner)
+	{
+		auto it = m_ownerMap.find(owner);
+		if (it == m_ownerMap.end())
+		{
+			return;
+		}
+
+		const uint32_t slot = it->second;
+		m_ownerMap.erase(it);
+
+		unlink(slot);
+		m_slots[slot] = SlotState{};
+		m_freeSlots.push_back(slot);
+	}
+
+	ThumbnailGridLayout ThumbnailGridLayout::build(float availWidth, float availHeight, float itemDimSize, size_t itemCount)
+	{
+		ThumbnailGridLayout layout{};
+		layout.itemCount = itemCount;
+
+		// Keep same column count as before, one padding column and rest item columns.
+		const uint32_t columnCount = uint32_t(glm::max(1.0f, glm::ceil(availWidth / itemDimSize - 0.25f) - 1.0f));
+		layout.itemsPerRow = glm::max(1u, columnCount - 1);
+
+		// Fill view with empty rows and keep one empty row at the end.
+		const uint32_t minRowCount = uint32_t(glm::max(1.0f, glm::ceil(availHeight / itemDimSize)));
+		layout.rowCount = glm::max(minRowCount, uint32_t(itemCount / layout.itemsPerRow + 1));
+
+		return layout;
+	}
+
+	size_t ThumbnailGridLayout::getItemIndex(uint32_t row, uint32_t itemColumn) const
+	{
+		if (itemColumn >= itemsPerRow)
+		{
+			return itemCount;
+		}
+
+		const size_t index = size_t(row) * itemsPerRow + itemColumn;
+		return glm::min(index, itemCount);
+	}
+
+	glm::uvec2 ThumbnailGridLayout::computeVisibleRows(float scrollY, float viewHeight, float rowHeight, uint32_t rowCount, uint32_t extraRows)
+	{
+		if (rowCount == 0 || rowHeight <= 0.0f || viewHeight <= 0.0f)
+		{
+			return glm::uvec2(0);
+		}
+
+		scrollY = glm::max(0.0f, scrollY);
+
+		// Row i cover [i * rowHeight, (i + 1) * rowHeight), overlap view when start before view end and end after view start.
+		const uint32_t first = glm::min(rowCount, uint32_t(glm::floor(scrollY / rowHeight)));
+		const uint32_t last = uint32_t(glm::ceil((scrollY + viewHeight) / rowHeight));
+
+		return glm::uvec2(first, glm::min(rowCount, glm::max(first, last) + extraRows));
+	}
+
+	void ThumbnailAtlasContext::init()
+	{
+		m_allocator = std::make_unique<ThumbnailSlotAllocator>(kSlotsPerPage * kPageCount);
+		m_slotInfos.resize(kSlotsPerPage * kPageCount);
+	}
+
+	void ThumbnailAtlasContext::release()
+	{
+		m_pendingUploads.clear();
+		m_stageBuffers.clear();
+		m_image.reset();
+
+		m_allocator.reset();
+		m_slotInfos.clear();
+	}
+
+	void ThumbnailAtlasContext::createResources()
+	{
+		VkImageCreateInfo info{};
+		info.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+		info.flags = {};
+		info.imageType = VK_IMAGE_TYPE_2D;
+		info.format = kFormat;
+		info.extent.width = kPageDim;
+		info.extent.height = kPageDim;
+		info.extent.depth = 1;
+		info.arrayLayers = kPageCount;
+		info.mipLevels = 1;
+		info.samples = VK_SAMPLE_COUNT_1_BIT;
+		info.tiling = VK_IMAGE_TILING_OPTIMAL;
+		info.usage = VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+		info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+		info.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+		m_image = VulkanImage::create("ThumbnailAtlas", info, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+		const VkDeviceSize stageSize = VkDeviceSize(kMaxUploadsPerFrame) * kSlotDim * kSlotDim * GAssetTextureChannels;
+		m_stageBuffers.resize(RHI::GMaxSwapchainCount);
+		for (size_t i = 0; i < m_stageBuffers.size(); i++)
+		{
+			m_stageBuffers[i] = VulkanBuffer::create(
+				("ThumbnailAtlasStage" + std::to_string(i)).c_str(),
+				VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+				VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+				EVMAUsageFlags::StageCopyForUpload,
+				stageSize,
+				nullptr
+			);
+		}
+	}
+
+	VkImageView ThumbnailAtlasContext::getPageView(uint32_t page)
+	{
+		CHECK(m_image && page < kPageCount);
+
+		VkImageSubresourceRange range = buildBasicImageSubresource();
+		range.baseArrayLayer = page;
+		range.layerCount = 1;
+
+		return m_image->getView(range, VK_IMAGE_VIEW_TYPE_2D);
+	}
+
+	void ThumbnailAtlasContext::beginFrame()
+	{
+		if (!m_allocator)
+		{
+			return;
+		}
+
+		m_allocator->beginFrame();
+
+		m_lastFrameStats = m_frameStats;
+		m_frameStats = {};
+	}
+
+	ThumbnailAtlasContext::Tile ThumbnailAtlasContext::buildTile(uint32_t slot) const
+	{
+		const auto& slotInfo = m_slotInfos[slot];
+
+		const uint32_t pageSlot = slot % kSlotsPerPage;
+		const glm::vec2 origin = glm::vec2(pageSlot % kSlotsPerRow, pageSlot / kSlotsPerRow) * float(kSlotDim);
+
+		// Atlas sample with nearest filter, no neighbor slot bleed.
+		Tile tile{};
+		tile.bReady = true;
+		tile.page = slot / kSlotsPerPage;
+		tile.width = slotInfo.width;
+		tile.height = slotInfo.height;
+		tile.uv0 = origin / float(kPageDim);
+		tile.uv1 = (origin + glm::vec2(slotInfo.width, slotInfo.height)) / float(kPageDim);
+
+		return tile;
+	}
+
+	ThumbnailAtlasContext::Tile ThumbnailAtlasContext::request(std::shared_ptr<ImageAssetHeader> header)
+	{
+		CHECK(m_allocator && "Thumbnail atlas must init before request.");
+		m_frameStats.requestCount++;
+
+		const auto& uuid = header->getSnapShotUUID();
+
+		uint32_t slot = m_allocator->find(uuid);
+		if (slot != ThumbnailSlotAllocator::kInvalidSlot)
+		{
+			return buildTile(slot);
+		}
+
+		// Upload budget of this frame run out, try again next frame.
+		if (m_pendingUploads.size() >= kMaxUploadsPerFrame)
+		{
+			m_frameStats.deferCount++;
+			return Tile{};
+		}
+
+		bool bNewSlot;
+		UUID evictedOwner;
+		slot = m_allocator->acquire(uuid, bNewSlot, &evictedOwner);
+		if (slot == ThumbnailSlotAllocator::kInvalidSlot)
+		{
+			m_frameStats.deferCount++;
+			return Tile{};
+		}
+		CHECK(bNewSlot);
+
+		if (!evictedOwner.empty())
+		{
+			m_evictGeneration++;
+
+			// Evicted owner upload no record yet, drop it.
+			std::erase_if(m_pendingUploads, [slot](const PendingUpload& upload) { return upload.slot == slot; });
+		}
+
+		if (!m_image)
+		{
+			createResources();
+		}
+
+		m_slotInfos[slot].width = glm::min(header->getSnapShotWidth(), kSlotDim);
+		m_slotInfos[slot].height = glm::min(header->getSnapShotHeight(), kSlotDim);
+		m_pendingUploads.push_back({ slot, header });
+
+		// Upload record on graphics command buffer of this frame, before ui pass sample it.
+		return buildTile(slot);
+	}
+
+	void ThumbnailAtlasContext::writeSlotPixels(const ImageAssetHeader& header, uint8_t* dest)
+	{
+		const uint32_t width = glm::min(header.getSnapShotWidth(), kSlotDim);
+		const uint32_t height = glm::min(header.getSnapShotHeight(), kSlotDim);
+		const uint32_t srcRowPixels = header.getSnapShotWidth();
+		const auto& data = header.getSnapShotData();
+
+		// Atlas is srgb format, keep same sample result as snapshot image with its own format.
+		for (uint32_t y = 0; y < height; y++)
+		{
+			uint8_t* destRow = dest + size_t(y) * width * GAssetTextureChannels;
+
+			if (header.isHdr())
+			{
+				const float* srcRow = (const float*)data.data() + size_t(y) * srcRowPixels * GAssetTextureChannels;
+				for (uint32_t x = 0; x < width * GAssetTextureChannels; x++)
+				{
+					const uint8_t v = uint8_t(glm::clamp(srcRow[x], 0.0f, 1.0f) * 255.0f);
+					destRow[x] = ((x % GAssetTextureChannels) == 3) ? v : linearToSrgb(v);
+				}
+			}
+			else
+			{
+				const uint8_t* srcRow = data.data() + size_t(y) * srcRowPixels * GAssetTextureChannels;
+				if (header.isSRGB())
+				{
+					memcpy(destRow, srcRow, width * GAssetTextureChannels);
+				}
+				else
+				{
+					for (uint32_t x = 0; x < width * GAssetTextureChannels; x++)
+					{
+						destRow[x] = ((x % GAssetTextureChannels) == 3) ? srcRow[x] : linearToSrgb(srcRow[x]);
+					}
+				}
+			}
+		}
+	}
+
+	void ThumbnailAtlasContext::flushUploads(VkCommandBuffer graphicsCmd)
+	{
+		if (m_pendingUploads.empty())
+		{
+			return;
+		}
+
+		// Current frame fence already wait in acquire, its stage buffer free to reuse.
+		auto& stageBuffer = *m_stageBuffers.at(RHI::get()->getCurrentFrameIndex());
+		const VkDeviceSize slotStageSize = VkDeviceSize(kSlotDim) * kSlotDim * GAssetTextureChannels;
+
+		std::vector<VkBufferImageCopy> regions;
+		regions.reserve(m_pendingUploads.size());
+
+		stageBuffer.map();
+		for (size_t i = 0; i < m_pendingUploads.size(); i++)
+		{
+			const auto& upload = m_pendingUploads[i];
+			const Tile tile = buildTile(upload.slot);
+			const VkDeviceSize offset = slotStageSize * i;
+
+			writeSlotPixels(*upload.header, (uint8_t*)stageBuffer.mapped + offset);
+
+			const uint32_t pageSlot = upload.slot % kSlotsPerPage;
+
+			VkBufferImageCopy region{};
+			region.bufferOffset = offset;
+			region.bufferRowLength = 0;
+			region.bufferImageHeight = 0;
+			region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+			region.imageSubresource.mipLevel = 0;
+			region.imageSubresource.baseArrayLayer = tile.page;
+			region.imageSubresource.layerCount = 1;
+			region.imageOffset = { int32_t((pageSlot % kSlotsPerRow) * kSlotDim), int32_t((pageSlot / kSlotsPerRow) * kSlotDim), 0 };
+			region.imageExtent = { tile.width, tile.height, 1 };
+
+			regions.push_back(region);
+		}
+		stageBuffer.unmap();
+
+		// Image layout track per mip only, transition all pages.
+		// Barrier also wait previous frames ui pass which may still sample evicted slot.
+		VkImageSubresourceRange range = buildBasicImageSubresource();
+		range.layerCount = kPageCount;
+
+		m_image->transitionLayout(graphicsCmd, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, range);
+		vkCmdCopyBufferToImage(graphicsCmd, stageBuffer, m_image->getImage(), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, uint32_t(regions.size()), regions.data());
+		m_image->transitionLayout(graphicsCmd, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, range);
+
+		m_frameStats.uploadCount += uint32_t(m_pendingUploads.size());
+		m_pendingUploads.clear();
+	}
+
+	void ThumbnailAtlasContext::validate()
+	{
+		ValidateReport report("Thumbnail atlas");
+
+		// Slot allocator.
+		{
+			ThumbnailSlotAllocator allocator(4);
+			bool bNew;
+			UUID evicted;
+
+			for (uint32_t i = 0; i < 4; i++)
+			{
+				report.expect(allocator.acquire("a" + std::to_string(i), bNew) == i && bNew, "fill free slots in order");
+			}
+			report.expect(allocator.acquire("a1", bNew) == 1 && !bNew, "hit keep slot");
+			report.expect(allocator.acquire("b0", bNew) == ThumbnailSlotAllocator::kInvalidSlot, "no evict slot used in current frame");
+
+			// Frame 2 touch a0 and a2, lru order from old is a3, a1, a0, a2.
+			allocator.beginFrame();
+			allocator.find("a0");
+			allocator.find("a2");
+
+			report.expect(allocator.acquire("b0", bNew, &evicted) == 3 && bNew && evicted == "a3", "evict least recently used");
+			report.expect(allocator.acquire("b1", bNew, &evicted) == 1 && evicted == "a1", "evict next least recently used");
+			report.expect(allocator.acquire("b2", bNew) == ThumbnailSlotAllocator::kInvalidSlot, "full when all used this frame");
+			report.expect(allocator.find("a3") == ThumbnailSlotAllocator::kInvalidSlot, "evicted owner miss");
+			report.expect(allocator.getEvictCount() == 2 && allocator.getUsedCount() == 4, "evict count");
+
+			allocator.release("a2");
+			report.expect(allocator.acquire("b2", bNew) == 2 && bNew, "released slot reuse");
+
+			// Random stress, compare with brute force lru.
+			ThumbnailSlotAllocator stress(64);
+			std::unordered_map<UUID, uint64_t> referenceUse;
+			std::unordered_map<UUID, uint32_t> referenceSlot;
+			std::mt19937 random(47);
+			std::uniform_int_distribution<uint32_t> ownerDist(0, 255);
+
+			uint32_t mismatch = 0;
+			uint64_t tick = 0;
+			for (uint32_t frame = 0; frame < 200; frame++)
+			{
+				stress.beginFrame();
+				std::unordered_set<UUID> usedThisFrame;
+
+				for (uint32_t i = 0; i < 48; i++)
+				{
+					const UUID owner = std::to_string(ownerDist(random));
+					tick++;
+
+					// Reference victim is oldest use not in this frame.
+					UUID victim;
+					if (!referenceSlot.contains(owner) && referenceSlot.size() == 64)
+					{
+						uint64_t oldest = ~0ull;
+						for (const auto& pair : referenceUse)
+						{
+							if (pair.second < oldest) { oldest = pair.second; victim = pair.first; }
+						}
+						if (usedThisFrame.contains(victim))
+						{
+							victim.clear();
+						}
+					}
+
+					UUID evictedOwner;
+					const uint32_t slot = stress.acquire(owner, bNew, &evictedOwner);
+					if (slot == ThumbnailSlotAllocator::kInvalidSlot)
+					{
+						mismatch += victim.empty() ? 0 : 1;
+						continue;
+					}
+
+					mismatch += (evictedOwner != victim) ? 1 : 0;
+					if (!victim.empty())
+					{
+						referenceUse.erase(victim);
+						referenceSlot.erase(victim);
+					}
+
+					referenceUse[owner] = tick;
+					referenceSlot[owner] = slot;
+					usedThisFrame.insert(owner);
+				}
+			}
+			report.expect(mismatch == 0, "random lru match reference");
+		}
+
+		// Grid visibility.
+		{
+			const auto layout = ThumbnailGridLayout::build(1000.0f, 300.0f, 100.0f, 95);
+			report.expect(layout.itemsPerRow == 8 && layout.rowCount == 12, "grid layout");
+			report.expect(layout.getItemIndex(11, 7) == 95 && layout.getItemIndex(11, 6) == 94, "grid tail item");
+
+			std::mt19937 random(53);
+			std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+			uint32_t mismatch = 0;
+			for (uint32_t i = 0; i < 1000; i++)
+			{
+				const uint32_t rowCount = 1 + uint32_t(unit(random) * 500.0f);
+				const float rowHeight = 20.0f + unit(random) * 200.0f;
+				const float viewHeight = unit(random) * 2000.0f;
+				const float scrollY = unit(random) * rowCount * rowHeight;
+
+				const glm::uvec2 range = ThumbnailGridLayout::computeVisibleRows(scrollY, viewHeight, rowHeight, rowCount, 0);
+
+				// Brute force overlap test of every row rect.
+				for (uint32_t row = 0; row < rowCount; row++)
+				{
+					const float rowMin = row * rowHeight;
+					const float rowMax = rowMin + rowHeight;
+					const bool bOverlap = viewHeight > 0.0f && rowMin < scrollY + viewHeight && rowMax > scrollY;
+					const bool bInRange = row >= range.x && row < range.y;
+
+					// Range may include one row touch view end exactly.
+					if (bOverlap && !bInRange)
+					{
+						mismatch++;
+					}
+					else if (!bOverlap && bInRange && !(row + 1 == range.y && rowMin <= scrollY + viewHeight))
+					{
+						mismatch++;
+					}
+				}
+			}
+			report.expect(mismatch == 0, "visible rows match brute force");
+		}
+
+		report.finish();
+	}
+}
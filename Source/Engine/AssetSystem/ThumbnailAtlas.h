@@ -0,0 +1,175 @@
+#pragma once
+#include "AssetCommon.h"
+
+namespace Flower
+{
+	class ImageAssetHeader;
+
+	// Cpu side thumbnail slot management, no vulkan object inside.
+	// Slot use by owner uuid, least recently used slot evict when full, slot used in current frame never evict.
+	class ThumbnailSlotAllocator : NonCopyable
+	{
+	public:
+		static constexpr uint32_t kInvalidSlot = ~0u;
+
+	private:
+		struct SlotState
+		{
+			UUID owner;
+			bool bUsed = false;
+			uint64_t lastUseFrame = 0;
+
+			// Lru double linked list, head is most recently used.
+			uint32_t prev = kInvalidSlot;
+			uint32_t next = kInvalidSlot;
+		};
+
+		std::vector<SlotState> m_slots;
+		std::vector<uint32_t> m_freeSlots;
+		std::unordered_map<UUID, uint32_t> m_ownerMap;
+
+		uint32_t m_lruHead = kInvalidSlot;
+		uint32_t m_lruTail = kInvalidSlot;
+
+		uint64_t m_frame = 1;
+		uint64_t m_evictCount = 0;
+
+	private:
+		void unlink(uint32_t slot);
+		void pushFront(uint32_t slot);
+
+	public:
+		explicit ThumbnailSlotAllocator(uint32_t slotCount);
+
+		void beginFrame() { m_frame++; }
+		uint64_t getFrame() const { return m_frame; }
+
+		uint32_t getSlotCount() const { return uint32_t(m_slots.size()); }
+		uint32_t getUsedCount() const { return uint32_t(m_ownerMap.size()); }
+		uint64_t getEvictCount() const { return m_evictCount; }
+
+		// Return slot of owner and mark used in current frame, kInvalidSlot if no exist.
+		uint32_t find(const UUID& owner);
+
+		// Find or allocate slot for owner, bNewSlot true when slot content need upload.
+		// Return kInvalidSlot when all slot used in current frame.
+		// When evict, evictedOwner is old owner of slot.
+		uint32_t acquire(const UUID& owner, bool& bNewSlot, UUID* evictedOwner = nullptr);
+
+		void release(const UUID& owner);
+	};
+
+	// Thumbnail grid virtualization math, only rows overlap view request thumbnail.
+	struct ThumbnailGridLayout
+	{
+		// Item columns, grid first column is padding column.
+		uint32_t itemsPerRow = 1;
+		uint32_t rowCount = 0;
+		size_t itemCount = 0;
+
+		static ThumbnailGridLayout build(float availWidth, float availHeight, float itemDimSize, size_t itemCount);
+
+		// Item index of row and item column, return itemCount if no item.
+		size_t getItemIndex(uint32_t row, uint32_t itemColumn) const;
+
+		// Rows [first, end) overlap [scrollY, scrollY + viewHeight), extend extraRows after view for prefetch.
+		static glm::uvec2 computeVisibleRows(float scrollY, float viewHeight, float rowHeight, uint32_t rowCount, uint32_t extraRows);
+	};
+
+	// Fixed size array texture atlas for 128x128 asset snapshot, one layer is one page with many slots.
+	// Upload record on frame graphics command buffer before ui pass, so slot request this frame can draw this frame.
+	class ThumbnailAtlasContext : NonCopyable
+	{
+	public:
+		static constexpr uint32_t kSlotDim = uint32_t(GAssetSnapshotMaxDim);
+		static constexpr uint32_t kPageDim = 1024;
+		static constexpr uint32_t kPageCount = 8;
+		static constexpr uint32_t kSlotsPerRow = kPageDim / kSlotDim;
+		static constexpr uint32_t kSlotsPerPage = kSlotsPerRow * kSlotsPerRow;
+
+		// Max upload slot count per frame, stage buffer size fix by it.
+		static constexpr uint32_t kMaxUploadsPerFrame = 32;
+		static constexpr VkFormat kFormat = VK_FORMAT_R8G8B8A8_SRGB;
+
+		struct Tile
+		{
+			bool bReady = false;
+			uint32_t page = 0;
+
+			// Valid snapshot region in page, no include empty slot border.
+			glm::vec2 uv0 = glm::vec2(0.0f);
+			glm::vec2 uv1 = glm::vec2(1.0f);
+
+			uint32_t width = 0;
+			uint32_t height = 0;
+		};
+
+		struct Stats
+		{
+			uint32_t requestCount = 0;
+			uint32_t uploadCount = 0;
+			uint32_t deferCount = 0;
+		};
+
+	private:
+		struct PendingUpload
+		{
+			uint32_t slot;
+			std::shared_ptr<ImageAssetHeader> header;
+		};
+
+		struct SlotInfo
+		{
+			uint32_t width = 0;
+			uint32_t height = 0;
+		};
+
+		std::unique_ptr<ThumbnailSlotAllocator> m_allocator;
+		std::vector<SlotInfo> m_slotInfos;
+		std::vector<PendingUpload> m_pendingUploads;
+
+		// Atlas and stage buffers create when first request, runtime without editor never pay it.
+		std::shared_ptr<VulkanImage> m_image;
+		std::vector<std::shared_ptr<VulkanBuffer>> m_stageBuffers;
+
+		// Increase when slot content change owner, retained ui must rebuild.
+		uint64_t m_evictGeneration = 0;
+
+		Stats m_frameStats;
+		Stats m_lastFrameStats;
+
+	private:
+		void createResources();
+		Tile buildTile(uint32_t slot) const;
+
+		// Convert snapshot pixels to atlas format in slot layout.
+		static void writeSlotPixels(const ImageAssetHeader& header, uint8_t* dest);
+
+	public:
+		void init();
+		void release();
+
+		// Call once per frame before ui build.
+		void beginFrame();
+
+		// Request thumbnail of image asset, tile no ready if upload budget of this frame run out.
+		Tile request(std::shared_ptr<ImageAssetHeader> header);
+
+		// Record pending slot upload, call on frame graphics command buffer.
+		void flushUploads(VkCommandBuffer graphicsCmd);
+
+		bool isCreated() const { return m_image != nullptr; }
+		VkImageView getPageView(uint32_t page);
+
+		uint64_t getEvictGeneration() const { return m_evictGeneration; }
+		const Stats& getLastFrameStats() const { return m_lastFrameStats; }
+
+		uint32_t getSlotCount() const { return m_allocator ? m_allocator->getSlotCount() : 0; }
+		uint32_t getUsedSlotCount() const { return m_allocator ? m_allocator->getUsedCount() : 0; }
+
+		// Drive slot allocator and grid visibility math without gpu, log result.
+		static void validate();
+	};
+
+	using ThumbnailAtlas = Singleton<ThumbnailAtlasContext>;
+}
@@ -0,0 +1,209 @@
+#include "Pch.h"
+#include "CVar.h"
+
+namespace Flower
+{
+	static AutoCVarCmd cVarCVarValidate("cmd.CVar.Validate", "Validate cvar concurrent set and get, subscription coalesce and order, log result.");
+
+	uint32_t CVarSystem::getGeneration(CVarType type, int32_t arrayIndex)
+	{
+		switch (type)
+		{
+		case CVarType::Int32:  return m_int32CVars.getCurrentStorage(arrayIndex)->getGeneration();
+		case CVarType::Float:  return m_floatCVars.getCurrentStorage(arrayIndex)->getGeneration();
+		case CVarType::Double: return m_doubleCVars.getCurrentStorage(arrayIndex)->getGeneration();
+		case CVarType::String: return m_stringCVars.getCurrentStorage(arrayIndex)->getGeneration();
+		default:               CHECK_ENTRY();
+		}
+		return 0;
+	}
+
+	CVarSubscription CVarSystem::subscribe(const CVarParameter* param, std::function<void()>&& callback)
+	{
+		CHECK(param && callback);
+
+		std::lock_guard lock(m_subscriptionMutex);
+
+		Subscription subscription{};
+		subscription.id = ++m_lastSubscriptionId;
+		subscription.type = param->type;
+		subscription.arrayIndex = param->arrayIndex;
+		subscription.lastGeneration = getGeneration(param->type, param->arrayIndex);
+		subscription.callback = std::move(callback);
+
+		m_subscriptions.push_back(std::move(subscription));
+		return m_lastSubscriptionId;
+	}
+
+	void CVarSystem::unsubscribe(CVarSubscription& id)
+	{
+		std::lock_guard lock(m_subscriptionMutex);
+		std::erase_if(m_subscriptions, [&](const Subscription& subscription) { return subscription.id == id; });
+		id = 0;
+	}
+
+	void CVarSystem::tick()
+	{
+		CVarCmdHandle(cVarCVarValidate, []()
+		{
+			CVarSystem::validate();
+		});
+
+		// Collect changed subscriptions first, callback may subscribe or unsubscribe.
+		struct Pending
+		{
+			CVarSubscription id;
+			uint32_t generation;
+		};
+		std::vector<Pending> pendings;
+		{
+			std::lock_guard lock(m_subscriptionMutex);
+			for (const auto& subscription : m_subscriptions)
+			{
+				const uint32_t generation = getGeneration(subscription.type, subscription.arrayIndex);
+				if (generation != subscription.lastGeneration)
+				{
+					pendings.push_back({ subscription.id, generation });
+				}
+			}
+		}
+
+		for (const auto& pending : pendings)
+		{
+			// Skip when unsubscribe by previous callback.
+			std::function<void()> callback;
+			{
+				std::lock_guard lock(m_subscriptionMutex);
+				auto it = std::find_if(m_subscriptions.begin(), m_subscriptions.end(), [&](const Subscription& subscription)
+				{
+					return subscription.id == pending.id;
+				});
+
+				if (it == m_subscriptions.end())
+				{
+					continue;
+				}
+
+				it->lastGeneration = pending.generation;
+				callback = it->callback;
+			}
+			callback();
+		}
+	}
+
+	void CVarSystem::validate()
+	{
+		static AutoCVarInt32 cVarValidateInt32("r.CVarValidate.Int32", "Cvar validate int32 value.", "CVarValidate", 0, CVarFlags::ReadAndWrite);
+		static AutoCVarFloat cVarValidateFloat("r.CVarValidate.Float", "Cvar validate float value.", "CVarValidate", 0.0f, CVarFlags::ReadAndWrite);
+		static AutoCVarString cVarValidateString("r.CVarValidate.String", "Cvar validate string value.", "CVarValidate", "", CVarFlags::ReadAndWrite);
+
+		auto* system = CVarSystem::get();
+		ValidateReport report("CVar");
+
+		// Concurrent set and get, writers write self encoded values, readers check value never torn and generation never go back.
+		{
+			constexpr uint32_t kWriterCount = 4;
+			constexpr uint32_t kReaderCount = 4;
+			constexpr uint32_t kWriteCount = 20000;
+			constexpr uint32_t kStringLength = 64;
+
+			cVarValidateInt32.set(0);
+			cVarValidateFloat.set(0.0f);
+			cVarValidateString.set(std::string(kStringLength, 'a'));
+
+			std::atomic<uint32_t> writerFinishCount = 0;
+			std::atomic<uint32_t> errorCount = 0;
+			std::atomic<uint64_t> readCount = 0;
+
+			std::vector<std::thread> threads;
+			for (uint32_t writer = 0; writer < kWriterCount; writer++)
+			{
+				threads.emplace_back([&, writer]()
+				{
+					for (uint32_t i = 0; i < kWriteCount; i++)
+					{
+						cVarValidateInt32.set(int32_t(writer * kWriteCount + i));
+						cVarValidateFloat.set(float(writer) + 0.5f);
+						if (i % 16 == 0)
+						{
+							cVarValidateString.set(std::string(kStringLength, char('a' + writer)));
+						}
+					}
+					writerFinishCount++;
+				});
+			}
+
+			for (uint32_t reader = 0; reader < kReaderCount; reader++)
+			{
+				threads.emplace_back([&]()
+				{
+					uint32_t lastGeneration = 0;
+					while (writerFinishCount.load() < kWriterCount)
+					{
+						const uint32_t generation = cVarValidateInt32.getGeneration();
+						const int32_t intValue = cVarValidateInt32.get();
+						const float floatValue = cVarValidateFloat.get();
+						const std::string stringValue = cVarValidateString.get();
+
+						const bool bIntValid = intValue >= 0 && intValue < int32_t(kWriterCount * kWriteCount);
+						const bool bFloatValid = floatValue == 0.0f || (floatValue - glm::floor(floatValue) == 0.5f && floatValue < float(kWriterCount));
+						const bool bStringValid = stringValue.size() == kStringLength && std::all_of(stringValue.begin(), stringValue.end(), [&](char c) { return c == stringValue[0]; });
+						const bool bGenerationValid = generation >= lastGeneration;
+
+						if (!bIntValid || !bFloatValid || !bStringValid || !bGenerationValid)
+						{
+							errorCount++;
+						}
+						lastGeneration = generation;
+						readCount++;
+					}
+				});
+			}
+
+			for (auto& thread : threads)
+			{
+				thread.join();
+			}
+
+			report.expect(errorCount.load() == 0, "concurrent read see torn value or generation go back");
+			LOG_INFO("CVar validate concurrent: {0} threads, {1} writes, {2} reads, {3} errors.",
+				kWriterCount + kReaderCount, kWriterCount * kWriteCount, readCount.load(), errorCount.load());
+		}
+
+		// Subscription: call in subscribe order, many change in one frame call once, same value not call, unsubscribe in callback skip later one.
+		{
+			std::vector<int32_t> calls;
+			CVarSubscription subscriptionC = 0;
+
+			CVarSubscription subscriptionA = cVarValidateInt32.subscribe([&]() { calls.push_back(0); });
+			CVarSubscription subscriptionB = cVarValidateFloat.subscribe([&]() { calls.push_back(1); system->unsubscribe(subscriptionC); });
+			subscriptionC = cVarValidateInt32.subscribe([&]() { calls.push_back(2); });
+			CVarSubscription subscriptionD = cVarValidateString.subscribe([&]() { calls.push_back(3); });
+
+			cVarValidateString.set("validate");
+			cVarValidateInt32.set(1);
+			cVarValidateInt32.set(2);
+			cVarValidateInt32.set(3);
+			system->tick();
+			report.expect(calls == std::vector<int32_t>({ 0, 2, 3 }), "changed subscriptions should call once in subscribe order");
+
+			calls.clear();
+			cVarValidateInt32.set(3);
+			cVarValidateString.set("validate");
+			system->tick();
+			report.expect(calls.empty(), "set same value should not call subscription");
+
+			calls.clear();
+			cVarValidateInt32.set(4);
+			cVarValidateFloat.set(1.0f);
+			system->tick();
+			report.expect(calls == std::vector<int32_t>({ 0, 1 }), "subscription unsubscribe by earlier callback should skip");
+
+			system->unsubscribe(subscriptionA);
+			system->unsubscribe(subscriptionB);
+			system->unsubscribe(subscriptionD);
+		}
+
+		report.finish();
+	}
+}
@@ -2,6 +2,9 @@
 
 #include "Core.h"
 
+#include <optional>
+#include <string_view>
+
 namespace Flower
 {
 	// Threadsafe cVar system.
@@ -61,12 +64,79 @@ namespace Flower
 		const char* description;
 	};
 
+	// Arithmetic value read with one relaxed atomic load.
+	template<typename T>
+	struct CVarValue
+	{
+		static_assert(std::atomic<T>::is_always_lock_free);
+
+		std::atomic<T> value{ };
+
+		inline T load() const
+		{
+			return value.load(std::memory_order_relaxed);
+		}
+
+		// Return true when value change.
+		inline bool store(const T& in)
+		{
+			return value.exchange(in, std::memory_order_relaxed) != in;
+		}
+	};
+
+	// String not hot path, guard by mutex.
+	template<>
+	struct CVarValue<std::string>
+	{
+		mutable std::mutex mutex;
+		std::string value;
+
+		inline std::string load() const
+		{
+			std::lock_guard lock(mutex);
+			return value;
+		}
+
+		inline bool store(const std::string& in)
+		{
+			std::lock_guard lock(mutex);
+			if (value == in)
+			{
+				return false;
+			}
+			value = in;
+			return true;
+		}
+	};
+
 	template<typename T>
 	struct CVarStorage
 	{
 		T initVal;
-		T currentVal;
+		CVarValue<T> currentVal;
+
+		// Increase when current value change, subscription and poller compare it.
+		std::atomic<uint32_t> generation = 0;
+
 		CVarParameter* parameter = nullptr;
+
+		inline T load() const
+		{
+			return currentVal.load();
+		}
+
+		inline void store(const T& val)
+		{
+			if (currentVal.store(val))
+			{
+				generation.fetch_add(1, std::memory_order_release);
+			}
+		}
+
+		inline uint32_t getGeneration() const
+		{
+			return generation.load(std::memory_order_acquire);
+		}
 	};
 
 	template<typename T>
@@ -119,14 +189,9 @@ namespace Flower
 			return &cvars[index];
 		}
 
-		inline T* getCurrentPtr(int32_t index)
-		{
-			return &cvars[index].currentVal;
-		}
-
 		inline T getCurrent(int32_t index)
 		{
-			return cvars[index].currentVal;
+			return cvars[index].load();
 		};
 
 		inline void setCurrent(const T& val, int32_t index)
@@ -135,14 +200,14 @@ namespace Flower
 			{
 				return;
 			}
-			cvars[index].currentVal = val;
+			cvars[index].store(val);
 		}
 
 		inline int32_t add(const T& value, CVarParameter* param)
 		{
 			int32_t index = lastCVar;
 
-			cvars[index].currentVal = value;
+			cvars[index].currentVal.store(value);
 			cvars[index].initVal = value;
 			cvars[index].parameter = param;
 			param->arrayIndex = index;
@@ -157,7 +222,7 @@ namespace Flower
 		{
 			int32_t index = lastCVar;
 
-			cvars[index].currentVal = currentValue;
+			cvars[index].currentVal.store(currentValue);
 			cvars[index].initVal = initialValue;
 			cvars[index].parameter = param;
 			param->arrayIndex = index;
@@ -169,6 +234,9 @@ namespace Flower
 		}
 	};
 
+	// Subscription id, zero is invalid.
+	using CVarSubscription = uint64_t;
+
 	class CVarSystem : private NonCopyable
 	{
 	public:
@@ -178,6 +246,17 @@ namespace Flower
 			return &cVarSystem;
 		}
 
+		// Case insensitive name hash, no allocation, constexpr so caller can precompute hash of literal name.
+		static constexpr size_t hash(std::string_view str)
+		{
+			size_t result = 0;
+			for (const char c : str)
+			{
+				result = (result * 131) + size_t((c >= 'A' && c <= 'Z') ? (c - 'A' + 'a') : c);
+			}
+			return result;
+		}
+
 		// Getter functions.
 		template<typename T> CVarArray<T>& getArray();
 		template<> CVarArray<std::string>& getArray() { return m_stringCVars; }
@@ -186,19 +265,6 @@ namespace Flower
 		template<> CVarArray<double>&      getArray() { return m_doubleCVars; }
 
 	private:
-		// Simple hash by cVar name.
-		inline size_t hash(std::string str)
-		{
-			std::transform(str.begin(), str.end(), str.begin(), ::tolower);
-			size_t result = 0;
-			for (auto it = str.cbegin(); it != str.cend(); ++it)
-			{
-				result = (result * 131) + *it;
-			}
-
-			return result;
-		}
-
 		template <typename T>
 		inline std::string toString(T v)
 		{
@@ -221,6 +287,22 @@ namespace Flower
 		std::shared_mutex m_lockMutex;
 		std::unordered_map<size_t, CVarParameter> m_cacheCVars;
 
+		struct Subscription
+		{
+			CVarSubscription id;
+			CVarType type;
+			int32_t arrayIndex;
+			uint32_t lastGeneration;
+			std::function<void()> callback;
+		};
+
+		// Dispatch in subscribe order.
+		std::mutex m_subscriptionMutex;
+		std::vector<Subscription> m_subscriptions;
+		CVarSubscription m_lastSubscriptionId = 0;
+
+		uint32_t getGeneration(CVarType type, int32_t arrayIndex);
+
 		inline CVarParameter* initCVar(const char* name, const char* description)
 		{
 			size_t hashId = hash(name);
@@ -238,16 +320,16 @@ namespace Flower
 		template<> CVarArray<std::string>* getCVarArray() { return &m_stringCVars;}
 
 		template<typename T>
-		inline T* getCVarCurrent(const char* name)
+		inline std::optional<T> getCVarCurrent(const char* name)
 		{
 			CVarParameter* par = getCVarParameter(name);
 			if (!par)
 			{
-				return nullptr;
+				return std::nullopt;
 			}
 			else
 			{
-				return getCVarArray<T>()->getCurrentPtr(par->arrayIndex);
+				return getCVarArray<T>()->getCurrent(par->arrayIndex);
 			}
 		}
 
@@ -263,10 +345,9 @@ namespace Flower
 		}
 
 	public:
-		CVarParameter* getCVarParameter(const char* name)
+		CVarParameter* getCVarParameter(size_t hashKey)
 		{
 			std::shared_lock<std::shared_mutex> lock(m_lockMutex);
-			size_t hashKey = hash(name);
 			auto it = m_cacheCVars.find(hashKey);
 			if (it != m_cacheCVars.end())
 			{
@@ -276,8 +357,13 @@ namespace Flower
 			return nullptr;
 		}
 
+		CVarParameter* getCVarParameter(const char* name)
+		{
+			return getCVarParameter(hash(name));
+		}
+
 		template<typename T>
-		T* getCVar(const char* name)
+		std::optional<T> getCVar(const char* name)
 		{
 			return getCVarCurrent<T>(name);
 		}
@@ -288,6 +374,17 @@ namespace Flower
 			setCVarCurrent<T>(name, value);
 		}
 
+		// Callback run in tick when cvar value change since last tick, many change in one frame only call once.
+		// Callbacks call in subscribe order, on tick thread.
+		[[nodiscard]] CVarSubscription subscribe(const CVarParameter* param, std::function<void()>&& callback);
+		void unsubscribe(CVarSubscription& id);
+
+		// Dispatch subscriptions of changed cvars, call once per frame on main thread.
+		void tick();
+
+		// Concurrent set and get from several threads, subscription coalesce and order, log result.
+		static void validate();
+
 	private:
 		template<typename BaseType>
 		inline CVarParameter* addCVarTypeParam(
@@ -383,8 +480,6 @@ namespace Flower
 		template<typename Ty>
 		friend Ty   getCVarCurrentByIndex(int32_t);
 		template<typename Ty>
-		friend Ty* ptrGetCVarCurrentByIndex(int32_t);
-		template<typename Ty>
 		friend void setCVarCurrentByIndex(int32_t, const Ty&);
 	};
 
@@ -394,6 +489,41 @@ namespace Flower
 	protected:
 		int32_t index;
 		using CVarType = T;
+
+		// Cache storage, get only one atomic load.
+		CVarStorage<T>* storage = nullptr;
+
+		void initStorage(CVarParameter* cvar, uint32_t flags)
+		{
+			cvar->flag = flags;
+			index = cvar->arrayIndex;
+			storage = CVarSystem::get()->getArray<T>().getCurrentStorage(index);
+		}
+
+	public:
+		inline T get() const
+		{
+			return storage->load();
+		}
+
+		inline void set(const T& val)
+		{
+			if (storage->parameter->flag & InitOnce)
+			{
+				return;
+			}
+			storage->store(val);
+		}
+
+		inline uint32_t getGeneration() const
+		{
+			return storage->getGeneration();
+		}
+
+		[[nodiscard]] CVarSubscription subscribe(std::function<void()>&& callback)
+		{
+			return CVarSystem::get()->subscribe(storage->parameter, std::move(callback));
+		}
 	};
 
 	struct AutoCVarFloat : AutoCVar<float>
@@ -413,13 +543,8 @@ namespace Flower
 				defaultValue
 			);
 
-			cvar->flag = flags;
-			index = cvar->arrayIndex;
+			initStorage(cvar, flags);
 		}
-
-		inline float  get();
-		inline float* getPtr();
-		inline void   set(float val);
 	};
 
 	struct AutoCVarDouble : AutoCVar<double>
@@ -439,13 +564,8 @@ namespace Flower
 				defaultValue
 			);
 
-			cvar->flag = flags;
-			index = cvar->arrayIndex;
+			initStorage(cvar, flags);
 		}
-
-		inline double  get();
-		inline double* getPtr();
-		inline void    set(double val);
 	};
 	
 	struct AutoCVarInt32;
@@ -468,8 +588,7 @@ namespace Flower
 				defaultValue
 			);
 
-			cvar->flag = flags;
-			index = cvar->arrayIndex;
+			initStorage(cvar, flags);
 		}
 
 		// Auto Cmd.
@@ -487,21 +606,26 @@ namespace Flower
 				defaultValue
 			);
 
-			cvar->flag = uint32_t(CVarFlags::ReadAndWrite);
-			index = cvar->arrayIndex;
+			initStorage(cvar, uint32_t(CVarFlags::ReadAndWrite));
 		}
 
-		inline int32_t  get();
-		inline int32_t* getPtr();
-		inline void     set(int32_t val);
+		// Atomic take value and set new, cmd issue from any thread handle exactly once.
+		inline int32_t exchange(int32_t val)
+		{
+			const int32_t old = storage->currentVal.value.exchange(val, std::memory_order_relaxed);
+			if (old != val)
+			{
+				storage->generation.fetch_add(1, std::memory_order_release);
+			}
+			return old;
+		}
 	};
 
 	// Handle cvar cmd.
 	inline void CVarCmdHandle(AutoCVarCmd& in, std::function<void()>&& func)
 	{
-		if (in.get() > 0)
+		if (in.exchange(0) > 0)
 		{
-			in.set(0);
 			func();
 		}
 	}
@@ -523,13 +647,8 @@ namespace Flower
 				defaultValue
 			);
 
-			cvar->flag = flags;
-			index = cvar->arrayIndex;
+			initStorage(cvar, flags);
 		}
-
-		inline std::string get();
-		inline std::string* getPtr();
-		inline void        set(const std::string& val);
 	};
 
 	template<typename T>
@@ -538,75 +657,9 @@ namespace Flower
 		return CVarSystem::get()->getCVarArray<T>()->getCurrent(index);
 	}
 
-	template<typename T>
-	inline T* ptrGetCVarCurrentByIndex(int32_t index)
-	{
-		return CVarSystem::get()->getCVarArray<T>()->getCurrentPtr(index);
-	}
-
 	template<typename T>
 	inline void setCVarCurrentByIndex(int32_t index, const T& data)
 	{
 		CVarSystem::get()->getCVarArray<T>()->setCurrent(data, index);
 	}
-
-	inline float AutoCVarFloat::get()
-	{
-		return getCVarCurrentByIndex<CVarType>(index);
-	}
-
-	inline double AutoCVarDouble::get()
-	{
-		return getCVarCurrentByIndex<CVarType>(index);
-	}
-
-	inline int32_t AutoCVarInt32::get()
-	{
-		return getCVarCurrentByIndex<CVarType>(index);
-	}
-
-	inline std::string AutoCVarString::get()
-	{
-		return getCVarCurrentByIndex<CVarType>(index);
-	}
-
-	inline void AutoCVarFloat::set(float f)
-	{
-		setCVarCurrentByIndex<CVarType>(index, f);
-	}
-
-	inline void AutoCVarDouble::set(double f)
-	{
-		setCVarCurrentByIndex<CVarType>(index, f);
-	}
-
-	inline void AutoCVarInt32::set(int32_t f)
-	{
-		setCVarCurrentByIndex<CVarType>(index, f);
-	}
-
-	inline void AutoCVarString::set(const std::string& f)
-	{
-		setCVarCurrentByIndex<CVarType>(index, f);
-	}
-
-	inline float* AutoCVarFloat::getPtr()
-	{
-		return ptrGetCVarCurrentByIndex<CVarType>(index);
-	}
-
-	inline double* AutoCVarDouble::getPtr()
-	{
-		return ptrGetCVarCurrentByIndex<CVarType>(index);
-	}
-
-	inline int32_t* AutoCVarInt32::getPtr()
-	{
-		return ptrGetCVarCurrentByIndex<CVarType>(index);
-	}
-
-	inline std::string* AutoCVarString::getPtr()
-	{
-		return ptrGetCVarCurrentByIndex<CVarType>(index);
-	}
 }
\ No newline at end of file
@@ -38,5 +38,7 @@
 #include "NonCopyable.h"
 #include "Singleton.h"
 #include "Delegates.h"
+#include "Profiler.h"
 #include "ThreadPool.h"
-#include "UUID.h"
\ No newline at end of file
+#include "UUID.h"
+#include "Validate.h"
\ No newline at end of file
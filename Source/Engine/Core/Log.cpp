@@ -14,6 +14,32 @@ namespace Flower
 		CVarFlags::ReadOnly
 	);
 
+	static AutoCVarInt32 cVarLogAsync(
+		"r.Log.Async",
+		"Write log on dedicated flush thread, log call only copy message to lock free ring. 0 is off, 1 is on.",
+		"Log",
+		1,
+		CVarFlags::ReadOnly
+	);
+
+	static AutoCVarInt32 cVarLogAsyncOverflow(
+		"r.Log.AsyncOverflow",
+		"Async log ring full policy, 0 drop message and count, 1 wait flush thread. Error and fatal always wait.",
+		"Log",
+		0,
+		CVarFlags::ReadAndWrite
+	);
+
+	static AutoCVarInt32 cVarLogConsoleCacheSize(
+		"r.Log.ConsoleCacheSize",
+		"Max cached console messages between two tick, overflow messages drop and count.",
+		"Log",
+		4096,
+		CVarFlags::ReadAndWrite
+	);
+
+	static AutoCVarCmd cVarLogBenchmark("cmd.Log.Benchmark", "Benchmark sync and async log throughput on 16 threads and uploader like thread latency.");
+
 	// Custom log cache sink, use for editor/hub/custom console output. etc.
 	template<typename Mutex>
 	class LogCacheSink : public spdlog::sinks::base_sink <Mutex>
@@ -22,6 +48,10 @@ namespace Flower
 	private:
 		MulticastDelegate<std::string, ELogType> m_callbacks;
 
+		// Formatted messages wait for tick, guard by sink mutex.
+		std::vector<std::pair<std::string, ELogType>> m_pending;
+		std::atomic<uint64_t> m_droppedCount = 0;
+
 		static ELogType toLogType(spdlog::level::level_enum level)
 		{
 			switch (level)
@@ -43,16 +73,274 @@ namespace Flower
 	protected:
 		void sink_it_(const spdlog::details::log_msg& msg) override
 		{
+			if (m_pending.size() >= size_t(glm::max(cVarLogConsoleCacheSize.get(), 1)))
+			{
+				m_droppedCount.fetch_add(1, std::memory_order_relaxed);
+				return;
+			}
+
 			spdlog::memory_buf_t formatted;
 			spdlog::sinks::base_sink<Mutex>::formatter_->format(msg, formatted);
 
-			m_callbacks.broadcast(fmt::to_string(formatted), toLogType(msg.level));
+			m_pending.emplace_back(fmt::to_string(formatted), toLogType(msg.level));
 		}
 
 		void flush_() override
 		{
 
 		}
+
+	public:
+		void takePending(std::vector<std::pair<std::string, ELogType>>& out)
+		{
+			std::lock_guard<Mutex> lock(spdlog::sinks::base_sink<Mutex>::mutex_);
+			out.swap(m_pending);
+		}
+
+		uint64_t getDroppedCount() const
+		{
+			return m_droppedCount.load(std::memory_order_relaxed);
+		}
+	};
+
+	// Sink only format message and discard, stand for stdout and file sink cost in benchmark.
+	template<typename Mutex>
+	class FormatOnlySink : public spdlog::sinks::base_sink <Mutex>
+	{
+	protected:
+		void sink_it_(const spdlog::details::log_msg& msg) override
+		{
+			spdlog::memory_buf_t formatted;
+			spdlog::sinks::base_sink<Mutex>::formatter_->format(msg, formatted);
+		}
+
+		void flush_() override
+		{
+
+		}
+	};
+
+	// Log record copy in ring slot, payload already format by logger, pattern format defer to flush thread.
+	struct AsyncLogRecord
+	{
+		static constexpr size_t kInlinePayloadSize = 256;
+
+		spdlog::log_clock::time_point time;
+		spdlog::level::level_enum level;
+		size_t threadId;
+
+		// Point to registered logger name, loggers alive until process exit.
+		spdlog::string_view_t loggerName;
+
+		uint32_t payloadSize;
+		char payload[kInlinePayloadSize];
+
+		// Only use when payload longer than inline size.
+		std::string longPayload;
+	};
+
+	class AsyncLogSink : public spdlog::sinks::sink
+	{
+	public:
+		static constexpr size_t kRingCapacity = 8192;
+
+	private:
+		MPSCRingBuffer<AsyncLogRecord, kRingCapacity> m_ring;
+		std::vector<spdlog::sink_ptr> m_targets;
+
+		std::thread m_thread;
+		std::atomic<bool> m_bRun = true;
+
+		// Flush thread sleep at most wait time when idle, notify when ring fill up.
+		std::mutex m_wakeMutex;
+		std::condition_variable m_wakeCondition;
+
+		std::atomic<size_t> m_processedCount = 0;
+		std::atomic<uint64_t> m_droppedCount = 0;
+		uint64_t m_reportedDroppedCount = 0;
+
+		// Overflow policy, < 0 read r.Log.AsyncOverflow.
+		int32_t m_overflowPolicy;
+
+	private:
+		void writeTargets(const spdlog::details::log_msg& msg)
+		{
+			for (auto& target : m_targets)
+			{
+				if (target->should_log(msg.level))
+				{
+					target->log(msg);
+				}
+			}
+		}
+
+		size_t drain()
+		{
+			size_t count = 0;
+			while (m_ring.tryPop([&](AsyncLogRecord& record)
+			{
+				const spdlog::string_view_t payload = record.payloadSize <= AsyncLogRecord::kInlinePayloadSize
+					? spdlog::string_view_t(record.payload, record.payloadSize)
+					: spdlog::string_view_t(record.longPayload);
+
+				spdlog::details::log_msg msg(record.time, spdlog::source_loc{}, record.loggerName, record.level, payload);
+				msg.thread_id = record.threadId;
+				writeTargets(msg);
+
+				record.longPayload.clear();
+			}))
+			{
+				count++;
+			}
+
+			// Report drop as one warn record, drop happen when ring full so report after drain.
+			const uint64_t droppedCount = m_droppedCount.load(std::memory_order_relaxed);
+			if (droppedCount != m_reportedDroppedCount)
+			{
+				const std::string info = "Async log ring overflow, drop " + std::to_string(droppedCount - m_reportedDroppedCount) + " messages.";
+				writeTargets(spdlog::details::log_msg(spdlog::source_loc{}, "Log", spdlog::level::warn, info));
+				m_reportedDroppedCount = droppedCount;
+			}
+
+			if (count > 0)
+			{
+				for (auto& target : m_targets)
+				{
+					target->flush();
+				}
+				m_processedCount.fetch_add(count, std::memory_order_release);
+			}
+			return count;
+		}
+
+		void threadFunction()
+		{
+			while (true)
+			{
+				const bool bRun = m_bRun.load(std::memory_order_acquire);
+				if (drain() == 0)
+				{
+					if (!bRun)
+					{
+						break;
+					}
+
+					std::unique_lock lock(m_wakeMutex);
+					m_wakeCondition.wait_for(lock, std::chrono::milliseconds(2));
+				}
+			}
+		}
+
+	public:
+		AsyncLogSink(std::vector<spdlog::sink_ptr> targets, int32_t overflowPolicy = -1)
+			: m_targets(std::move(targets))
+			, m_overflowPolicy(overflowPolicy)
+		{
+			m_thread = std::thread([this]() { threadFunction(); });
+		}
+
+		virtual ~AsyncLogSink()
+		{
+			stop();
+		}
+
+		// Join flush thread, later log write targets on calling thread.
+		void stop()
+		{
+			if (m_thread.joinable())
+			{
+				m_bRun.store(false, std::memory_order_release);
+				m_wakeCondition.notify_one();
+				m_thread.join();
+
+				// Producer may push between flush thread last drain and exit.
+				drain();
+			}
+		}
+
+		void log(const spdlog::details::log_msg& msg) override
+		{
+			if (!m_bRun.load(std::memory_order_acquire))
+			{
+				std::lock_guard lock(m_wakeMutex);
+				writeTargets(msg);
+				return;
+			}
+
+			auto fill = [&](AsyncLogRecord& record)
+			{
+				record.time = msg.time;
+				record.level = msg.level;
+				record.threadId = msg.thread_id;
+				record.loggerName = msg.logger_name;
+				record.payloadSize = uint32_t(msg.payload.size());
+				if (msg.payload.size() <= AsyncLogRecord::kInlinePayloadSize)
+				{
+					memcpy(record.payload, msg.payload.data(), msg.payload.size());
+				}
+				else
+				{
+					record.longPayload.assign(msg.payload.data(), msg.payload.size());
+				}
+			};
+
+			const bool bMustWrite = msg.level >= spdlog::level::err;
+			while (!m_ring.tryPush(fill))
+			{
+				m_wakeCondition.notify_one();
+
+				const int32_t policy = m_overflowPolicy >= 0 ? m_overflowPolicy : cVarLogAsyncOverflow.get();
+				if (!bMustWrite && policy == 0)
+				{
+					m_droppedCount.fetch_add(1, std::memory_order_relaxed);
+					return;
+				}
+				std::this_thread::yield();
+			}
+
+			// Fatal log throw after return, make sure it write out.
+			if (msg.level == spdlog::level::critical)
+			{
+				waitFlush();
+			}
+		}
+
+		// Per message flush by logger flush_on, targets already flush after each drain.
+		void flush() override
+		{
+
+		}
+
+		void waitFlush()
+		{
+			const size_t target = m_ring.getEnqueueCount();
+			m_wakeCondition.notify_one();
+			while (m_processedCount.load(std::memory_order_acquire) < target)
+			{
+				std::this_thread::yield();
+			}
+		}
+
+		void set_pattern(const std::string& pattern) override
+		{
+			for (auto& target : m_targets)
+			{
+				target->set_pattern(pattern);
+			}
+		}
+
+		void set_formatter(std::unique_ptr<spdlog::formatter> formatter) override
+		{
+			for (auto& target : m_targets)
+			{
+				target->set_formatter(formatter->clone());
+			}
+		}
+
+		uint64_t getDroppedCount() const
+		{
+			return m_droppedCount.load(std::memory_order_relaxed);
+		}
 	};
 
 	DelegateHandle Logger::pushCallback(std::function<void(std::string, ELogType)>&& callback)
@@ -103,12 +391,64 @@ namespace Flower
 			logSinks[logSinks.size() - 1]->set_pattern(s_logFileFormat);
 		}
 
+		if (cVarLogAsync.get() != 0)
+		{
+			m_asyncSink = std::make_shared<AsyncLogSink>(logSinks);
+		}
+
 		m_logger = registerLogger("Utils");
 	}
 
+	Logger::~Logger()
+	{
+		// Registered loggers still hold async sink, stop explicit to join flush thread and write remaining records.
+		if (m_asyncSink)
+		{
+			m_asyncSink->stop();
+		}
+	}
+
+	void Logger::tick()
+	{
+		static std::vector<std::pair<std::string, ELogType>> batch;
+
+		batch.clear();
+		m_loggerCache->takePending(batch);
+		for (auto& item : batch)
+		{
+			m_loggerCache->m_callbacks.broadcast(std::move(item.first), item.second);
+		}
+
+		CVarCmdHandle(cVarLogBenchmark, []()
+		{
+			Logger::benchmark();
+		});
+	}
+
+	void Logger::flush()
+	{
+		if (m_asyncSink)
+		{
+			m_asyncSink->waitFlush();
+		}
+	}
+
+	uint64_t Logger::getDroppedCount() const
+	{
+		return m_loggerCache->getDroppedCount() + (m_asyncSink ? m_asyncSink->getDroppedCount() : 0);
+	}
+
 	std::shared_ptr<spdlog::logger> Logger::registerLogger(const char* name)
 	{
-		auto logger = std::make_shared<spdlog::logger>(name, begin(logSinks), end(logSinks));
+		std::shared_ptr<spdlog::logger> logger;
+		if (m_asyncSink)
+		{
+			logger = std::make_shared<spdlog::logger>(name, m_asyncSink);
+		}
+		else
+		{
+			logger = std::make_shared<spdlog::logger>(name, begin(logSinks), end(logSinks));
+		}
 		spdlog::register_logger(logger);
 
 		logger->set_level(spdlog::level::trace);
@@ -116,4 +456,118 @@ namespace Flower
 
 		return logger;
 	}
+
+	void Logger::benchmark()
+	{
+		using Clock = std::chrono::high_resolution_clock;
+		auto elapsedUs = [](Clock::time_point start)
+		{
+			return std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+		};
+
+		constexpr uint32_t kThreadCount = 16;
+		constexpr uint32_t kMessagePerThread = 20000;
+		constexpr size_t kUploadSize = 256 * 1024;
+
+		// Stand for uploader copy one task to stage buffer then log.
+		std::vector<uint8_t> uploadSrc(kUploadSize, 1);
+		std::vector<uint8_t> uploadDest(kUploadSize, 0);
+		auto uploaderTask = [&](spdlog::logger& logger)
+		{
+			const auto start = Clock::now();
+			memcpy(uploadDest.data(), uploadSrc.data(), kUploadSize);
+			logger.info("Upload task finish, size {0} bytes.", kUploadSize);
+			return elapsedUs(start);
+		};
+
+		auto percentile = [](std::vector<double>& times, double p)
+		{
+			if (times.empty())
+			{
+				return 0.0;
+			}
+			std::sort(times.begin(), times.end());
+			return times[std::min(times.size() - 1, size_t(p * double(times.size())))];
+		};
+
+		auto formatSink = std::make_shared<FormatOnlySink<std::mutex>>();
+		formatSink->set_pattern(s_logFileFormat);
+
+		auto run = [&](const char* name, std::shared_ptr<spdlog::sinks::sink> sink, AsyncLogSink* asyncSink)
+		{
+			auto logger = std::make_shared<spdlog::logger>(name, sink);
+			logger->set_level(spdlog::level::trace);
+
+			// Uploader alone.
+			std::vector<double> idleTimes;
+			for (uint32_t i = 0; i < 256; i++)
+			{
+				idleTimes.push_back(uploaderTask(*logger));
+			}
+			if (asyncSink)
+			{
+				asyncSink->waitFlush();
+			}
+
+			std::atomic<bool> bStart = false;
+			std::atomic<uint32_t> finishedCount = 0;
+			std::vector<double> busyTimes;
+
+			std::thread uploader([&]()
+			{
+				while (!bStart.load()) { std::this_thread::yield(); }
+				while (finishedCount.load() < kThreadCount)
+				{
+					busyTimes.push_back(uploaderTask(*logger));
+				}
+			});
+
+			std::vector<std::thread> producers;
+			for (uint32_t threadId = 0; threadId < kThreadCount; threadId++)
+			{
+				producers.emplace_back([&, threadId]()
+				{
+					while (!bStart.load()) { std::this_thread::yield(); }
+					for (uint32_t i = 0; i < kMessagePerThread; i++)
+					{
+						logger->info("Benchmark thread {0} message {1} value {2:.3f}.", threadId, i, float(i) * 0.5f);
+					}
+					finishedCount++;
+				});
+			}
+
+			const auto start = Clock::now();
+			bStart.store(true);
+			for (auto& producer : producers)
+			{
+				producer.join();
+			}
+			const double producerUs = elapsedUs(start);
+			if (asyncSink)
+			{
+				asyncSink->waitFlush();
+			}
+			const double totalUs = elapsedUs(start);
+			uploader.join();
+
+			const double messageCount = double(kThreadCount) * kMessagePerThread;
+			LOG_INFO("Log benchmark {0}: producer {1:.2f} M msg/s, write out {2:.2f} M msg/s, dropped {3}. Uploader task p50/p99 {4:.1f}/{5:.1f} us, idle {6:.1f}/{7:.1f} us.",
+				name,
+				messageCount / producerUs,
+				messageCount / totalUs,
+				asyncSink ? asyncSink->getDroppedCount() : 0,
+				percentile(busyTimes, 0.5), percentile(busyTimes, 0.99),
+				percentile(idleTimes, 0.5), percentile(idleTimes, 0.99));
+		};
+
+		run("Sync", formatSink, nullptr);
+		{
+			auto asyncSink = std::make_shared<AsyncLogSink>(std::vector<spdlog::sink_ptr>{ formatSink }, 1);
+			run("AsyncWait", asyncSink, asyncSink.get());
+		}
+		{
+			auto asyncSink = std::make_shared<AsyncLogSink>(std::vector<spdlog::sink_ptr>{ formatSink }, 0);
+			run("AsyncDrop", asyncSink, asyncSink.get());
+		}
+	}
 }
@@ -13,6 +13,9 @@ namespace Flower
 	// Custom log cache sink.
 	template<typename Mutex> class LogCacheSink;
 
+	// Async sink, push log record to ring and flush thread write to real sinks.
+	class AsyncLogSink;
+
 	class DelegateHandle;
 
 	enum class ELogType : uint8_t
@@ -26,6 +29,89 @@ namespace Flower
 		Max,
 	};
 
+	// Bounded lock free multi producer single consumer ring, each slot own a sequence number (vyukov bounded queue).
+	// Producer claim slot by cas on enqueue position, consumer own dequeue position, no lock on both side.
+	template<typename T, size_t Capacity>
+	class MPSCRingBuffer : private NonCopyable
+	{
+		static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be power of two.");
+
+	private:
+		struct Slot
+		{
+			std::atomic<size_t> sequence;
+			T data;
+		};
+
+		std::unique_ptr<Slot[]> m_slots;
+
+		alignas(64) std::atomic<size_t> m_enqueuePos = 0;
+		alignas(64) size_t m_dequeuePos = 0;
+
+	public:
+		MPSCRingBuffer()
+			: m_slots(std::make_unique<Slot[]>(Capacity))
+		{
+			for (size_t i = 0; i < Capacity; i++)
+			{
+				m_slots[i].sequence.store(i, std::memory_order_relaxed);
+			}
+		}
+
+		// fill(T&) write slot data, return false when ring full.
+		template<typename F>
+		bool tryPush(F&& fill)
+		{
+			size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+			while (true)
+			{
+				Slot& slot = m_slots[pos & (Capacity - 1)];
+				const size_t sequence = slot.sequence.load(std::memory_order_acquire);
+				const intptr_t diff = intptr_t(sequence) - intptr_t(pos);
+
+				if (diff == 0)
+				{
+					if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+					{
+						fill(slot.data);
+						slot.sequence.store(pos + 1, std::memory_order_release);
+						return true;
+					}
+				}
+				else if (diff < 0)
+				{
+					return false;
+				}
+				else
+				{
+					pos = m_enqueuePos.load(std::memory_order_relaxed);
+				}
+			}
+		}
+
+		// Only call from consumer thread, consume(T&) read slot data.
+		template<typename F>
+		bool tryPop(F&& consume)
+		{
+			Slot& slot = m_slots[m_dequeuePos & (Capacity - 1)];
+			if (slot.sequence.load(std::memory_order_acquire) != m_dequeuePos + 1)
+			{
+				return false;
+			}
+
+			consume(slot.data);
+			slot.sequence.store(m_dequeuePos + Capacity, std::memory_order_release);
+			m_dequeuePos++;
+			return true;
+		}
+
+		// Count of claimed slots, include slot still writing.
+		size_t getEnqueueCount() const
+		{
+			return m_enqueuePos.load(std::memory_order_acquire);
+		}
+	};
+
 	class Logger : private NonCopyable
 	{
 	private:
@@ -37,12 +123,28 @@ namespace Flower
 		// Logger cache for custom logger.
 		std::shared_ptr<LogCacheSink<std::mutex>> m_loggerCache;
 
+		// Null when r.Log.Async is 0, all loggers write sinks on calling thread.
+		std::shared_ptr<AsyncLogSink> m_asyncSink;
+
 	public:
 		Logger();
+		~Logger();
 
 		inline auto& getLogger() { return m_logger; }
 
-		// push callback to logger sink.
+		// Deliver cached log batch to callbacks on calling thread, call once per frame on main thread.
+		void tick();
+
+		// Block until all pushed log records write to sinks.
+		void flush();
+
+		// Messages drop by async ring overflow and console cache overflow.
+		uint64_t getDroppedCount() const;
+
+		// Log throughput of 16 threads and latency of one uploader like thread, sync vs async, all write to format only sink.
+		static void benchmark();
+
+		// push callback to logger sink, callback broadcast in tick.
 		[[nodiscard]] DelegateHandle pushCallback(std::function<void(std::string, ELogType)>&& callback);
 
 		// pop callback from logger sink.
@@ -0,0 +1,95 @@
+#include "Pch.h"
+#include "MappedFile.h"
+#include "Core.h"
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#endif
+
+namespace Flower
+{
+	MappedFile::~MappedFile()
+	{
+		close();
+	}
+
+	bool MappedFile::open(const std::filesystem::path& path)
+	{
+		close();
+
+		std::error_code ec;
+		const auto fileSize = std::filesystem::file_size(path, ec);
+		if (ec || fileSize == 0)
+		{
+			LOG_ERROR("Can't map file {0}, file no exist or empty.", path.string());
+			return false;
+		}
+
+#ifdef _WIN32
+		HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (file != INVALID_HANDLE_VALUE)
+		{
+			HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+			if (mapping != nullptr)
+			{
+				if (const void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0))
+				{
+					m_fileHandle = file;
+					m_mappingHandle = mapping;
+					m_data = static_cast<const uint8_t*>(view);
+					m_size = size_t(fileSize);
+					return true;
+				}
+				CloseHandle(mapping);
+			}
+			CloseHandle(file);
+		}
+		LOG_WARN("Map file {0} fail, fallback to read whole file.", path.string());
+#endif
+
+		std::ifstream is(path, std::ios::binary);
+		if (!is.is_open())
+		{
+			LOG_ERROR("Can't open file {0}.", path.string());
+			return false;
+		}
+
+		m_fallback.resize(size_t(fileSize));
+		is.read(reinterpret_cast<char*>(m_fallback.data()), std::streamsize(fileSize));
+		if (!is)
+		{
+			LOG_ERROR("Read file {0} fail.", path.string());
+			m_fallback.clear();
+			return false;
+		}
+
+		m_data = m_fallback.data();
+		m_size = m_fallback.size();
+		return true;
+	}
+
+	void MappedFile::close()
+	{
+#ifdef _WIN32
+		if (m_mappingHandle)
+		{
+			UnmapViewOfFile(m_data);
+			CloseHandle(m_mappingHandle);
+			CloseHandle(m_fileHandle);
+		}
+#endif
+		m_mappingHandle = nullptr;
+		m_fileHandle = nullptr;
+		m_data = nullptr;
+		m_size = 0;
+
+		m_fallback.clear();
+		m_fallback.shrink_to_fit();
+	}
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "../Pch.h"
+#include "NonCopyable.h"
+
+namespace Flower
+{
+	// Read only memory mapped file, fallback to read whole file when map fail.
+	class MappedFile : NonCopyable
+	{
+	private:
+		const uint8_t* m_data = nullptr;
+		size_t m_size = 0;
+
+		// Native handles, only valid when map success.
+		void* m_fileHandle = nullptr;
+		void* m_mappingHandle = nullptr;
+
+		// Fallback storage.
+		std::vector<uint8_t> m_fallback;
+
+	public:
+		MappedFile() = default;
+		~MappedFile();
+
+		bool open(const std::filesystem::path& path);
+		void close();
+
+		bool isOpen() const { return m_data != nullptr; }
+		bool isMapped() const { return m_mappingHandle != nullptr; }
+
+		const uint8_t* data() const { return m_data; }
+		size_t size() const { return m_size; }
+	};
+}
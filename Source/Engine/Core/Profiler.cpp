@@ -0,0 +1,257 @@
+#include "Pch.h"
+#include "Core.h"
+
+namespace Flower
+{
+	static AutoCVarInt32 cVarProfilerEnable(
+		"r.Profiler.Enable",
+		"Enable cpu scope profiler. 0 is off, 1 is on.",
+		"Profiler",
+		1,
+		CVarFlags::ReadAndWrite
+	);
+
+	static AutoCVarCmd cVarProfilerExport("cmd.profiler.export", "Export profiler history as chrome trace json to profile.json.");
+
+	thread_local FrameProfiler::ThreadBuffer* FrameProfiler::s_threadBuffer = nullptr;
+
+	FrameProfiler::ThreadBuffer* FrameProfiler::registerThread()
+	{
+		std::lock_guard lock(m_threadMutex);
+
+		auto newBuffer = std::make_unique<ThreadBuffer>();
+		newBuffer->threadId = (uint32_t)m_threadBuffers.size();
+
+		m_threadNames.push_back("Thread " + std::to_string(newBuffer->threadId));
+		m_threadBuffers.push_back(std::move(newBuffer));
+
+		return m_threadBuffers.back().get();
+	}
+
+	uint32_t FrameProfiler::beginScope()
+	{
+		if (!s_threadBuffer)
+		{
+			s_threadBuffer = registerThread();
+		}
+		return s_threadBuffer->depth++;
+	}
+
+	void FrameProfiler::endScope(const char* name, uint64_t startNs)
+	{
+		const uint64_t endNs = now();
+
+		ThreadBuffer* buffer = s_threadBuffer;
+		CHECK(buffer && buffer->depth > 0);
+		buffer->depth--;
+
+		const uint64_t writeIndex = buffer->writeIndex.load(std::memory_order_relaxed);
+		const uint64_t readIndex = buffer->readIndex.load(std::memory_order_acquire);
+
+		// Full, consumer too slow, drop new event.
+		if (writeIndex - readIndex >= kThreadBufferCapacity)
+		{
+			buffer->droppedCount.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+
+		ProfileEvent& event = buffer->events[writeIndex % kThreadBufferCapacity];
+		event.name = name;
+		event.startNs = startNs;
+		event.endNs = endNs;
+		event.depth = buffer->depth;
+		event.threadId = buffer->threadId;
+
+		buffer->writeIndex.store(writeIndex + 1, std::memory_order_release);
+	}
+
+	uint32_t FrameProfiler::getThreadId()
+	{
+		if (!s_threadBuffer)
+		{
+			s_threadBuffer = registerThread();
+		}
+		return s_threadBuffer->threadId;
+	}
+
+	void FrameProfiler::setThreadName(const std::string& name)
+	{
+		if (!s_threadBuffer)
+		{
+			s_threadBuffer = registerThread();
+		}
+
+		std::lock_guard lock(m_threadMutex);
+		m_threadNames[s_threadBuffer->threadId] = name;
+	}
+
+	std::string FrameProfiler::getThreadName(uint32_t threadId) const
+	{
+		std::lock_guard lock(m_threadMutex);
+		return threadId < m_threadNames.size() ? m_threadNames[threadId] : "Unknown";
+	}
+
+	void FrameProfiler::addGPUEvents(std::vector<GPUProfileEvent>&& events)
+	{
+		if (!isEnable())
+		{
+			return;
+		}
+
+		std::lock_guard lock(m_gpuEventMutex);
+		m_pendingGPUEvents.insert(m_pendingGPUEvents.end(),
+			std::make_move_iterator(events.begin()), std::make_move_iterator(events.end()));
+	}
+
+	void FrameProfiler::newFrame(uint64_t frameIndex)
+	{
+		const uint64_t frameStartNs = now();
+
+		CVarCmdHandle(cVarProfilerExport, [&]()
+		{
+			exportChromeTrace("profile.json");
+		});
+
+		// Drain all thread buffers into closing frame.
+		{
+			std::lock_guard lock(m_threadMutex);
+			for (auto& buffer : m_threadBuffers)
+			{
+				const uint64_t readIndex = buffer->readIndex.load(std::memory_order_relaxed);
+				const uint64_t writeIndex = buffer->writeIndex.load(std::memory_order_acquire);
+				for (uint64_t i = readIndex; i < writeIndex; i++)
+				{
+					m_currentFrame.cpuEvents.push_back(buffer->events[i % kThreadBufferCapacity]);
+				}
+				buffer->readIndex.store(writeIndex, std::memory_order_release);
+
+				m_droppedCount += buffer->droppedCount.exchange(0, std::memory_order_relaxed);
+			}
+		}
+		{
+			std::lock_guard lock(m_gpuEventMutex);
+			m_currentFrame.gpuEvents = std::move(m_pendingGPUEvents);
+			m_pendingGPUEvents.clear();
+		}
+
+		// First frame has no start.
+		if (m_currentFrame.startNs != 0 && !isPause())
+		{
+			m_currentFrame.endNs = frameStartNs;
+			m_history.push_back(std::move(m_currentFrame));
+
+			while (m_history.size() > kMaxHistoryFrames)
+			{
+				m_history.pop_front();
+			}
+		}
+
+		m_currentFrame = {};
+		m_currentFrame.frameIndex = frameIndex;
+		m_currentFrame.startNs = std::max(frameStartNs, uint64_t(1));
+
+		m_bEnable.store(cVarProfilerEnable.get() != 0, std::memory_order_relaxed);
+	}
+
+	bool FrameProfiler::exportChromeTrace(const std::filesystem::path& path, uint32_t frameCount) const
+	{
+		std::ofstream os(path);
+		if (!os.is_open())
+		{
+			LOG_ERROR("Can't open profiler export path {0}.", path.string());
+			return false;
+		}
+
+		const size_t startFrame = m_history.size() > frameCount ? m_history.size() - frameCount : 0;
+
+		std::vector<const ProfileFrame*> frames;
+		for (size_t i = startFrame; i < m_history.size(); i++)
+		{
+			frames.push_back(&m_history[i]);
+		}
+		os << buildChromeTrace(frames).dump();
+
+		LOG_INFO("Export {0} profiler frames to {1}.", m_history.size() - startFrame, path.string());
+		return true;
+	}
+
+	nlohmann::json FrameProfiler::buildChromeTrace(const std::vector<const ProfileFrame*>& frames) const
+	{
+		// Gpu tracks use tid after all cpu threads.
+		std::vector<std::string> gpuTracks;
+		auto getGPUTrackId = [&](const std::string& track)
+		{
+			auto it = std::find(gpuTracks.begin(), gpuTracks.end(), track);
+			if (it == gpuTracks.end())
+			{
+				gpuTracks.push_back(track);
+				return gpuTracks.size() - 1;
+			}
+			return size_t(it - gpuTracks.begin());
+		};
+
+		size_t threadCount;
+		{
+			std::lock_guard lock(m_threadMutex);
+			threadCount = m_threadNames.size();
+		}
+
+		nlohmann::json traceEvents = nlohmann::json::array();
+
+		// Chrome trace time unit is microseconds.
+		auto pushEvent = [&](const std::string& name, const char* category, uint64_t startNs, uint64_t endNs, size_t tid)
+		{
+			nlohmann::json event;
+			event["name"] = name;
+			event["cat"] = category;
+			event["ph"] = "X";
+			event["ts"] = double(startNs) * 1e-3;
+			event["dur"] = double(endNs - std::min(startNs, endNs)) * 1e-3;
+			event["pid"] = 0;
+			event["tid"] = tid;
+			traceEvents.push_back(std::move(event));
+		};
+
+		for (const ProfileFrame* framePtr : frames)
+		{
+			const auto& frame = *framePtr;
+			pushEvent("Frame " + std::to_string(frame.frameIndex), "frame", frame.startNs, frame.endNs, threadCount + 1024);
+
+			for (const auto& event : frame.cpuEvents)
+			{
+				pushEvent(event.name, "cpu", event.startNs, event.endNs, event.threadId);
+			}
+
+			for (const auto& event : frame.gpuEvents)
+			{
+				pushEvent(event.name, "gpu", event.startNs, event.endNs, threadCount + getGPUTrackId(event.track));
+			}
+		}
+
+		// Track names.
+		auto pushThreadName = [&](const std::string& name, size_t tid)
+		{
+			nlohmann::json meta;
+			meta["name"] = "thread_name";
+			meta["ph"] = "M";
+			meta["pid"] = 0;
+			meta["tid"] = tid;
+			meta["args"]["name"] = name;
+			traceEvents.push_back(std::move(meta));
+		};
+		for (size_t i = 0; i < threadCount; i++)
+		{
+			pushThreadName(getThreadName(uint32_t(i)), i);
+		}
+		for (size_t i = 0; i < gpuTracks.size(); i++)
+		{
+			pushThreadName("GPU " + gpuTracks[i], threadCount + i);
+		}
+		pushThreadName("Frames", threadCount + 1024);
+
+		nlohmann::json trace;
+		trace["traceEvents"] = std::move(traceEvents);
+		trace["displayTimeUnit"] = "ms";
+		return trace;
+	}
+}
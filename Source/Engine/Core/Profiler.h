@@ -0,0 +1,171 @@
+#pragma once
+
+#include "../Pch.h"
+#include "NonCopyable.h"
+#include "Singleton.h"
+
+// Profiler scopes compile out when FLOWER_DISABLE_PROFILER defined.
+#ifndef FLOWER_DISABLE_PROFILER
+#define ENABLE_PROFILER
+#endif
+
+namespace Flower
+{
+	// Cpu scope event, name must keep alive while profiler keep history, so usually use string literal.
+	struct ProfileEvent
+	{
+		const char* name = nullptr;
+		uint64_t startNs = 0;
+		uint64_t endNs = 0;
+		uint32_t depth = 0;
+		uint32_t threadId = 0;
+	};
+
+	// Gpu event already convert to cpu timeline.
+	struct GPUProfileEvent
+	{
+		std::string track;
+		std::string name;
+		uint64_t startNs = 0;
+		uint64_t endNs = 0;
+	};
+
+	struct ProfileFrame
+	{
+		uint64_t frameIndex = 0;
+		uint64_t startNs = 0;
+		uint64_t endNs = 0;
+
+		std::vector<ProfileEvent> cpuEvents;
+		std::vector<GPUProfileEvent> gpuEvents;
+	};
+
+	class FrameProfiler : NonCopyable
+	{
+	public:
+		static constexpr uint32_t kThreadBufferCapacity = 1 << 13;
+		static constexpr uint32_t kMaxHistoryFrames = 300;
+
+	private:
+		// Single producer (owner thread), single consumer (frame end on main thread) ring.
+		struct ThreadBuffer
+		{
+			std::array<ProfileEvent, kThreadBufferCapacity> events;
+			std::atomic<uint64_t> writeIndex = 0;
+			std::atomic<uint64_t> readIndex = 0;
+			std::atomic<uint64_t> droppedCount = 0;
+
+			// Only touch by owner thread.
+			uint32_t depth = 0;
+			uint32_t threadId = 0;
+		};
+
+		static thread_local ThreadBuffer* s_threadBuffer;
+
+		std::atomic<bool> m_bEnable = true;
+		std::atomic<bool> m_bPause = false;
+		const std::chrono::steady_clock::time_point m_startPoint = std::chrono::steady_clock::now();
+
+		// Thread buffers register once per thread, never free until profiler destroy.
+		mutable std::mutex m_threadMutex;
+		std::vector<std::unique_ptr<ThreadBuffer>> m_threadBuffers;
+		std::vector<std::string> m_threadNames;
+
+		// Gpu events push when timestamps resolved, low frequency so just lock.
+		std::mutex m_gpuEventMutex;
+		std::vector<GPUProfileEvent> m_pendingGPUEvents;
+
+		// Closed frames, only touch on main thread.
+		std::deque<ProfileFrame> m_history;
+		ProfileFrame m_currentFrame;
+		uint64_t m_droppedCount = 0;
+
+	private:
+		ThreadBuffer* registerThread();
+
+		nlohmann::json buildChromeTrace(const std::vector<const ProfileFrame*>& frames) const;
+
+	public:
+		FrameProfiler() = default;
+
+		// Nanoseconds since profiler create.
+		uint64_t now() const
+		{
+			return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_startPoint).count();
+		}
+
+		uint64_t toProfilerTime(std::chrono::steady_clock::time_point point) const
+		{
+			return point > m_startPoint ? (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(point - m_startPoint).count() : 0;
+		}
+
+		bool isEnable() const { return m_bEnable.load(std::memory_order_relaxed); }
+		bool isPause() const { return m_bPause.load(std::memory_order_relaxed); }
+		void setPause(bool bPause) { m_bPause.store(bPause); }
+
+		// Scope begin and end on calling thread, return depth of the scope.
+		uint32_t beginScope();
+		void endScope(const char* name, uint64_t startNs);
+
+		// Id of calling thread in events and trace, register thread when first call.
+		uint32_t getThreadId();
+
+		// Name of calling thread, show in trace and frame view.
+		void setThreadName(const std::string& name);
+		std::string getThreadName(uint32_t threadId) const;
+
+		void addGPUEvents(std::vector<GPUProfileEvent>&& events);
+
+		// Close current frame and open next one, call on main thread at engine tick begin.
+		void newFrame(uint64_t frameIndex);
+
+		const std::deque<ProfileFrame>& getHistory() const { return m_history; }
+		uint64_t getDroppedCount() const { return m_droppedCount; }
+
+		// Export last frames as chrome trace json, open in chrome://tracing or perfetto.
+		bool exportChromeTrace(const std::filesystem::path& path, uint32_t frameCount = kMaxHistoryFrames) const;
+	};
+
+	using GFrameProfiler = Singleton<FrameProfiler>;
+
+	class ScopeProfile : NonCopyable
+	{
+	private:
+		const char* m_name;
+		uint64_t m_startNs;
+		bool m_bEnable;
+
+	public:
+		explicit ScopeProfile(const char* name)
+			: m_name(name)
+			, m_bEnable(GFrameProfiler::get()->isEnable())
+		{
+			if (m_bEnable)
+			{
+				GFrameProfiler::get()->beginScope();
+				m_startNs = GFrameProfiler::get()->now();
+			}
+		}
+
+		~ScopeProfile()
+		{
+			if (m_bEnable)
+			{
+				GFrameProfiler::get()->endScope(m_name, m_startNs);
+			}
+		}
+	};
+}
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+
+#ifdef ENABLE_PROFILER
+#define PROFILE_SCOPE(name) ::Flower::ScopeProfile PROFILE_CONCAT(profileScope_, __LINE__)(name)
+#define PROFILE_FUNCTION() PROFILE_SCOPE(__FUNCTION__)
+#define PROFILE_THREAD_NAME(name) ::Flower::GFrameProfiler::get()->setThreadName(name)
+#else
+#define PROFILE_SCOPE(name)
+#define PROFILE_FUNCTION()
+#define PROFILE_THREAD_NAME(name)
+#endif
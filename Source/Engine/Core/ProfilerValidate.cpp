@@ -0,0 +1,216 @@
+#include "Pch.h"
+#include "Core.h"
+#include "ProfilerValidate.h"
+
+namespace Flower
+{
+	static AutoCVarCmd cVarProfilerValidate("cmd.Profiler.Validate", "Record nested scopes on thread pool workers, check event depth, nesting, thread and chrome trace export.");
+
+	namespace
+	{
+		struct ValidateTask
+		{
+			uint32_t threadId = ~0;
+			uint64_t startNs = 0;
+			uint64_t endNs = 0;
+		};
+
+		// Tasks record last frame, wait check after that frame close.
+		std::vector<ValidateTask> s_pendingTasks;
+
+		// Names keep alive in history, only append, same index reuse same name.
+		const char* getValidateScopeName(uint32_t taskIndex, uint32_t level)
+		{
+			static std::mutex nameMutex;
+			static std::deque<std::string> names;
+			static const char* kLevelNames[3] = { " Outer", " Inner", " Leaf" };
+
+			std::lock_guard lock(nameMutex);
+			while (names.size() <= taskIndex * 3 + level)
+			{
+				const size_t id = names.size();
+				names.push_back("Profiler Validate " + std::to_string(id / 3) + kLevelNames[id % 3]);
+			}
+			return names[taskIndex * 3 + level].c_str();
+		}
+
+		std::vector<ValidateTask> validateRecord()
+		{
+#ifdef ENABLE_PROFILER
+			auto* profiler = GFrameProfiler::get();
+			if (!profiler->isEnable() || profiler->isPause())
+			{
+				LOG_WARN("Profiler disable or pause, skip profiler validate.");
+				return {};
+			}
+
+			auto* pool = GThreadPool::get();
+			const uint32_t taskCount = std::max(8u, pool->getThreadCount() * 4);
+
+			// Resolve names before dispatch, task body only record scopes.
+			std::vector<std::array<const char*, 3>> taskNames(taskCount);
+			for (uint32_t i = 0; i < taskCount; i++)
+			{
+				taskNames[i] = { getValidateScopeName(i, 0), getValidateScopeName(i, 1), getValidateScopeName(i, 2) };
+			}
+
+			std::vector<ValidateTask> tasks(taskCount);
+			{
+				TaskGroup group(*pool);
+				for (uint32_t i = 0; i < taskCount; i++)
+				{
+					group.run([profiler, &tasks, &taskNames, i]()
+					{
+						const auto& names = taskNames[i];
+
+						tasks[i].startNs = profiler->now();
+						{
+							PROFILE_SCOPE(names[0]);
+							{
+								PROFILE_SCOPE(names[1]);
+								{
+									PROFILE_SCOPE(names[2]);
+
+									// Hold worker a while, tasks spread to all workers.
+									std::this_thread::sleep_for(std::chrono::microseconds(500));
+								}
+							}
+						}
+						tasks[i].threadId = profiler->getThreadId();
+						tasks[i].endNs = profiler->now();
+					});
+				}
+				group.wait();
+			}
+			return tasks;
+#else
+			LOG_WARN("Profiler compile out, skip profiler validate.");
+			return {};
+#endif
+		}
+
+		void validateCheck(const std::vector<ValidateTask>& tasks)
+		{
+			auto* profiler = GFrameProfiler::get();
+			if (profiler->getHistory().empty())
+			{
+				LOG_WARN("Profiler pause when validate frame close, skip profiler validate.");
+				return;
+			}
+
+			ValidateReport report("Profiler");
+			auto check = [&](bool bPass, const char* what, uint32_t taskIndex, uint32_t level)
+			{
+				report.expect(bPass, "task " + std::to_string(taskIndex) + " level " + std::to_string(level) + " " + what);
+			};
+
+			// Name pointer unique per task and level.
+			std::unordered_map<const char*, const ProfileEvent*> eventMap;
+			for (const auto& event : profiler->getHistory().back().cpuEvents)
+			{
+				eventMap[event.name] = &event;
+			}
+
+			// Chrome trace go through export path.
+			const auto tracePath = std::filesystem::temp_directory_path() / "FlowerProfilerValidate.json";
+			nlohmann::json trace;
+			if (profiler->exportChromeTrace(tracePath, 1))
+			{
+				std::ifstream is(tracePath);
+				trace = nlohmann::json::parse(is, nullptr, false);
+			}
+			std::error_code ec;
+			std::filesystem::remove(tracePath, ec);
+
+			if (!report.expect(!trace.is_discarded() && trace.contains("traceEvents"), "chrome trace export"))
+			{
+				report.finish();
+				return;
+			}
+
+			std::unordered_map<std::string, const nlohmann::json*> traceMap;
+			std::unordered_set<size_t> namedTids;
+			for (const auto& event : trace["traceEvents"])
+			{
+				if (event["ph"] == "X")
+				{
+					traceMap[event["name"].get<std::string>()] = &event;
+				}
+				else if (event["ph"] == "M")
+				{
+					namedTids.insert(event["tid"].get<size_t>());
+				}
+			}
+
+			std::unordered_set<uint32_t> usedThreads;
+			for (uint32_t i = 0; i < uint32_t(tasks.size()); i++)
+			{
+				const auto& task = tasks[i];
+				usedThreads.insert(task.threadId);
+				check(namedTids.contains(task.threadId), "thread no name in trace", i, 0);
+
+				const ProfileEvent* events[3] = { };
+				const nlohmann::json* traceEvents[3] = { };
+				bool bFound = true;
+				for (uint32_t level = 0; level < 3; level++)
+				{
+					const char* name = getValidateScopeName(i, level);
+					events[level] = eventMap.contains(name) ? eventMap.at(name) : nullptr;
+					traceEvents[level] = traceMap.contains(name) ? traceMap.at(name) : nullptr;
+
+					check(events[level] != nullptr, "event missing", i, level);
+					check(traceEvents[level] != nullptr, "trace event missing", i, level);
+					bFound &= (events[level] != nullptr) && (traceEvents[level] != nullptr);
+				}
+
+				if (!bFound)
+				{
+					continue;
+				}
+
+				for (uint32_t level = 0; level < 3; level++)
+				{
+					const auto& event = *events[level];
+					const auto& traceEvent = *traceEvents[level];
+
+					check(event.threadId == task.threadId, "event on other thread", i, level);
+					check(event.depth == events[0]->depth + level, "depth mismatch", i, level);
+					check(event.startNs >= task.startNs && event.endNs <= task.endNs && event.startNs <= event.endNs, "event time out of task", i, level);
+					check(traceEvent["tid"].get<size_t>() == task.threadId, "trace tid mismatch", i, level);
+
+					if (level > 0)
+					{
+						const auto& parent = *events[level - 1];
+						check(parent.startNs <= event.startNs && event.endNs <= parent.endNs, "event not inside parent", i, level);
+
+						// Trace time in microseconds, allow float round error.
+						const auto& parentTrace = *traceEvents[level - 1];
+						const double ts = traceEvent["ts"].get<double>();
+						const double parentTs = parentTrace["ts"].get<double>();
+						check(ts + 1e-3 >= parentTs && ts + traceEvent["dur"].get<double>() <= parentTs + parentTrace["dur"].get<double>() + 1e-3,
+							"trace event not inside parent", i, level);
+					}
+				}
+			}
+
+			LOG_INFO("Profiler validate: {0} tasks record nested scopes on {1} threads, pool has {2} workers.",
+				tasks.size(), usedThreads.size(), GThreadPool::get()->getThreadCount());
+			report.finish();
+		}
+	}
+
+	void FrameProfilerValidate::tick()
+	{
+		// Frame of recorded scopes closed by newFrame just now.
+		if (!s_pendingTasks.empty())
+		{
+			validateCheck(s_pendingTasks);
+			s_pendingTasks.clear();
+		}
+
+		CVarCmdHandle(cVarProfilerValidate, []()
+		{
+			s_pendingTasks = validateRecord();
+		});
+	}
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+#include "../Pch.h"
+#include "NonCopyable.h"
+
+namespace Flower
+{
+	// cmd.Profiler.Validate, only use FrameProfiler public api.
+	// Record nested scopes on thread pool workers this frame, check closed frame events and chrome trace export next frame.
+	class FrameProfilerValidate : NonCopyable
+	{
+	public:
+		// Call on main thread after FrameProfiler::newFrame.
+		static void tick();
+	};
+}
@@ -0,0 +1,195 @@
+#include "Pch.h"
+#include "Core.h"
+
+namespace Flower
+{
+	// Global queue pool before work stealing, only keep for benchmark compare.
+	class LegacyThreadPool : NonCopyable
+	{
+	private:
+		bool m_bRuning = true;
+		size_t m_tasksQueueTotalNum = 0;
+
+		std::mutex m_taskQueueMutex;
+		std::condition_variable m_cvTaskAvailable;
+		std::condition_variable m_cvTaskDone;
+		std::queue<std::function<void()>> m_tasksQueue;
+
+		std::vector<std::thread> m_threads;
+
+		void worker()
+		{
+			std::unique_lock<std::mutex> lock(m_taskQueueMutex);
+			while (true)
+			{
+				m_cvTaskAvailable.wait(lock, [&] { return !m_tasksQueue.empty() || !m_bRuning; });
+				if (!m_bRuning)
+				{
+					return;
+				}
+
+				auto task = std::move(m_tasksQueue.front());
+				m_tasksQueue.pop();
+
+				lock.unlock();
+				task();
+				lock.lock();
+
+				--m_tasksQueueTotalNum;
+				m_cvTaskDone.notify_all();
+			}
+		}
+
+	public:
+		explicit LegacyThreadPool(uint32_t threadCount)
+		{
+			for (uint32_t i = 0; i < threadCount; i++)
+			{
+				m_threads.emplace_back(&LegacyThreadPool::worker, this);
+			}
+		}
+
+		~LegacyThreadPool()
+		{
+			waitForTasks();
+			{
+				std::lock_guard lock(m_taskQueueMutex);
+				m_bRuning = false;
+			}
+			m_cvTaskAvailable.notify_all();
+			for (auto& thread : m_threads)
+			{
+				thread.join();
+			}
+		}
+
+		void pushTask(std::function<void()>&& task)
+		{
+			{
+				std::lock_guard lock(m_taskQueueMutex);
+				m_tasksQueue.push(std::move(task));
+				++m_tasksQueueTotalNum;
+			}
+			m_cvTaskAvailable.notify_one();
+		}
+
+		std::future<void> submit(std::function<void()>&& task)
+		{
+			auto taskPromise = std::make_shared<std::promise<void>>();
+			pushTask([task = std::move(task), taskPromise]()
+			{
+				task();
+				taskPromise->set_value();
+			});
+			return taskPromise->get_future();
+		}
+
+		void waitForTasks()
+		{
+			std::unique_lock<std::mutex> lock(m_taskQueueMutex);
+			m_cvTaskDone.wait(lock, [&] { return m_tasksQueueTotalNum == 0; });
+		}
+	};
+
+	void ThreadPool::benchmark()
+	{
+		using Clock = std::chrono::high_resolution_clock;
+		auto elapsedMs = [](Clock::time_point start)
+		{
+			return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+		};
+
+		// Busy work, sleep granularity too coarse for 1us.
+		auto spinFor = [](uint32_t ns)
+		{
+			const auto end = Clock::now() + std::chrono::nanoseconds(ns);
+			while (Clock::now() < end) { }
+		};
+
+		ThreadPool& pool = *GThreadPool::get();
+		const uint32_t workerCount = pool.getThreadCount();
+		LegacyThreadPool legacyPool(workerCount);
+
+		// Flat 1us tasks push from main thread.
+		{
+			constexpr uint32_t kTaskCount = 100000;
+			constexpr uint32_t kTaskNs = 1000;
+
+			auto startPoint = Clock::now();
+			{
+				TaskGroup group(pool);
+				for (uint32_t i = 0; i < kTaskCount; i++)
+				{
+					group.run([&spinFor]() { spinFor(kTaskNs); });
+				}
+				group.wait();
+			}
+			const double workStealingMs = elapsedMs(startPoint);
+
+			startPoint = Clock::now();
+			{
+				for (uint32_t i = 0; i < kTaskCount; i++)
+				{
+					legacyPool.pushTask([&spinFor]() { spinFor(kTaskNs); });
+				}
+				legacyPool.waitForTasks();
+			}
+			const double globalQueueMs = elapsedMs(startPoint);
+
+			// Work stealing wait also run tasks on main thread, ideal count it as one more worker.
+			LOG_INFO("ThreadPool benchmark {0} x 1us tasks on {1} workers: work stealing {2:.2f} ms (ideal {3:.2f} ms), global queue {4:.2f} ms (ideal {5:.2f} ms).",
+				kTaskCount, workerCount,
+				workStealingMs, double(kTaskCount) * kTaskNs * 1e-6 / (workerCount + 1),
+				globalQueueMs, double(kTaskCount) * kTaskNs * 1e-6 / workerCount);
+		}
+
+		// Nested fork join: every outer task split to inner 1us tasks and wait them.
+		{
+			constexpr uint32_t kOuterCount = 256;
+			constexpr uint32_t kInnerCount = 64;
+			constexpr uint32_t kTaskNs = 1000;
+
+			auto startPoint = Clock::now();
+			{
+				TaskGroup outerGroup(pool);
+				for (uint32_t i = 0; i < kOuterCount; i++)
+				{
+					outerGroup.run([&pool, &spinFor]()
+					{
+						// Wait inside worker help run pending tasks, no worker block.
+						TaskGroup innerGroup(pool);
+						for (uint32_t j = 0; j < kInnerCount; j++)
+						{
+							innerGroup.run([&spinFor]() { spinFor(kTaskNs); });
+						}
+						innerGroup.wait();
+					});
+				}
+				outerGroup.wait();
+			}
+			const double workStealingMs = elapsedMs(startPoint);
+
+			// Blocking wait inside global queue worker deadlock once outer tasks occupy all workers,
+			// so outer level run on calling thread, only inner level parallel.
+			startPoint = Clock::now();
+			{
+				std::vector<std::future<void>> futures(kInnerCount);
+				for (uint32_t i = 0; i < kOuterCount; i++)
+				{
+					for (uint32_t j = 0; j < kInnerCount; j++)
+					{
+						futures[j] = legacyPool.submit([&spinFor]() { spinFor(kTaskNs); });
+					}
+					for (auto& future : futures)
+					{
+						future.wait();
+					}
+				}
+			}
+			const double globalQueueMs = elapsedMs(startPoint);
+
+			LOG_INFO("ThreadPool benchmark nested {0} x {1} x 1us tasks on {2} workers: work stealing {3:.2f} ms, global queue (outer serial) {4:.2f} ms.",
+				kOuterCount, kInnerCount, workerCount, workStealingMs, globalQueueMs);
+		}
+	}
+}
@@ -3,6 +3,7 @@
 #include "../Pch.h"
 #include "NonCopyable.h"
 #include "Singleton.h"
+#include "Profiler.h"
 
 namespace Flower
 {
@@ -36,78 +37,310 @@ namespace Flower
 		}
 	};
 
-	class ThreadPool : NonCopyable
+	// Move only void() callable, small lambda store inline without heap allocation.
+	class ThreadTask : NonCopyable
 	{
 	public:
-		std::atomic<bool> bPaused = false;
+		static constexpr size_t kInlineSize = 64;
+
+	private:
+		struct VTable
+		{
+			void (*invoke)(void*);
+			void (*destroy)(void*);
+			void (*move)(void* dest, void* src);
+		};
+
+		alignas(std::max_align_t) std::byte m_storage[kInlineSize];
+		const VTable* m_vtable = nullptr;
+
+		template<typename F>
+		static constexpr bool kStoreInline =
+			sizeof(F) <= kInlineSize &&
+			alignof(F) <= alignof(std::max_align_t) &&
+			std::is_nothrow_move_constructible_v<F>;
+
+		template<typename F>
+		static const VTable* getVTable()
+		{
+			if constexpr (kStoreInline<F>)
+			{
+				static const VTable vtable =
+				{
+					[](void* p) { (*static_cast<F*>(p))(); },
+					[](void* p) { static_cast<F*>(p)->~F(); },
+					[](void* dest, void* src) { new (dest) F(std::move(*static_cast<F*>(src))); static_cast<F*>(src)->~F(); },
+				};
+				return &vtable;
+			}
+			else
+			{
+				// Large callable fallback to heap, storage keep pointer.
+				static const VTable vtable =
+				{
+					[](void* p) { (**static_cast<F**>(p))(); },
+					[](void* p) { delete *static_cast<F**>(p); },
+					[](void* dest, void* src) { *static_cast<F**>(dest) = *static_cast<F**>(src); },
+				};
+				return &vtable;
+			}
+		}
+
+		void reset()
+		{
+			if (m_vtable)
+			{
+				m_vtable->destroy(m_storage);
+				m_vtable = nullptr;
+			}
+		}
+
+	public:
+		ThreadTask() = default;
+
+		template<typename F, typename = std::enable_if_t<!std::is_same_v<std::decay_t<F>, ThreadTask>>>
+		ThreadTask(F&& func)
+		{
+			using FuncType = std::decay_t<F>;
+			if constexpr (kStoreInline<FuncType>)
+			{
+				new (m_storage) FuncType(std::forward<F>(func));
+			}
+			else
+			{
+				*reinterpret_cast<FuncType**>(m_storage) = new FuncType(std::forward<F>(func));
+			}
+			m_vtable = getVTable<FuncType>();
+		}
+
+		ThreadTask(ThreadTask&& other) noexcept
+		{
+			*this = std::move(other);
+		}
 
+		ThreadTask& operator=(ThreadTask&& other) noexcept
+		{
+			if (this != &other)
+			{
+				reset();
+				if (other.m_vtable)
+				{
+					other.m_vtable->move(m_storage, other.m_storage);
+					m_vtable = other.m_vtable;
+					other.m_vtable = nullptr;
+				}
+			}
+			return *this;
+		}
+
+		~ThreadTask()
+		{
+			reset();
+		}
+
+		explicit operator bool() const { return m_vtable != nullptr; }
+
+		void operator()()
+		{
+			m_vtable->invoke(m_storage);
+		}
+	};
+
+	// Work stealing thread pool.
+	// Every worker own one deque, push and pop at back, other workers steal at front.
+	// Task push from non-worker thread go to one shared inject queue.
+	// Waiting thread (task group wait or waitForTasks) execute pending task instead of blocking.
+	class ThreadPool : NonCopyable
+	{
 	private:
+		struct alignas(64) WorkQueue
+		{
+			std::mutex mutex;
+			std::deque<ThreadTask> tasks;
+		};
+
 		std::atomic<bool> m_bRuning = false;
-		std::atomic<bool> m_bWaiting = false;
+		std::atomic<bool> m_bPaused = false;
+
+		// Queued tasks num, and queued + running tasks num.
+		std::atomic<size_t> m_tasksQueuedNum = 0;
+		std::atomic<size_t> m_tasksQueueTotalNum = 0;
 
+		// Worker sleep when no task found.
+		std::mutex m_sleepMutex;
 		std::condition_variable m_cvTaskAvailable;
-		std::condition_variable m_cvTaskDone;
+		std::atomic<uint32_t> m_sleepingNum = 0;
 
-		std::atomic<size_t> m_tasksQueueTotalNum = 0;
-		mutable std::mutex m_taskQueueMutex;
-		std::queue<std::function<void()>> m_tasksQueue;
+		WorkQueue m_injectQueue;
+		std::unique_ptr<WorkQueue[]> m_workerQueues = nullptr;
 
 		uint32_t m_threadCount = 0;
 		std::unique_ptr<std::thread[]> m_threads = nullptr;
 
+		// Calling thread's worker index in owner pool, -1 if not worker.
+		inline static thread_local ThreadPool* s_workerPool = nullptr;
+		inline static thread_local int32_t s_workerIndex = -1;
+
 	private:
-		void worker()
+		int32_t getCurrentWorkerIndex() const
 		{
-			while (m_bRuning)
+			return s_workerPool == this ? s_workerIndex : -1;
+		}
+
+		static bool popBack(WorkQueue& queue, ThreadTask& outTask)
+		{
+			std::lock_guard lock(queue.mutex);
+			if (queue.tasks.empty())
 			{
-				std::function<void()> task;
+				return false;
+			}
+			outTask = std::move(queue.tasks.back());
+			queue.tasks.pop_back();
+			return true;
+		}
 
-				std::unique_lock<std::mutex> lockTasksQueue(m_taskQueueMutex);
-				m_cvTaskAvailable.wait(lockTasksQueue, [&] 
-				{ 
-					// When task queue no empty, keep moving.
-					return !m_tasksQueue.empty() || !m_bRuning;
-				});
+		static bool popFront(WorkQueue& queue, ThreadTask& outTask)
+		{
+			std::lock_guard lock(queue.mutex);
+			if (queue.tasks.empty())
+			{
+				return false;
+			}
+			outTask = std::move(queue.tasks.front());
+			queue.tasks.pop_front();
+			return true;
+		}
+
+		bool tryPopTask(ThreadTask& outTask)
+		{
+			if (m_tasksQueuedNum.load() == 0)
+			{
+				return false;
+			}
+
+			if (tryPopTaskInner(outTask))
+			{
+				--m_tasksQueuedNum;
+				return true;
+			}
+			return false;
+		}
+
+		bool tryPopTaskInner(ThreadTask& outTask)
+		{
+			// Own queue first, lifo keep cache warm.
+			const int32_t workerIndex = getCurrentWorkerIndex();
+			if (workerIndex >= 0 && popBack(m_workerQueues[workerIndex], outTask))
+			{
+				return true;
+			}
 
-				if (m_bRuning && !bPaused)
+			if (popFront(m_injectQueue, outTask))
+			{
+				return true;
+			}
+
+			// Steal from other workers, start from neighbor to spread contention.
+			const uint32_t start = workerIndex >= 0 ? uint32_t(workerIndex) + 1 : 0;
+			for (uint32_t i = 0; i < m_threadCount; i++)
+			{
+				const uint32_t victim = (start + i) % m_threadCount;
+				if (int32_t(victim) != workerIndex && popFront(m_workerQueues[victim], outTask))
 				{
-					task = std::move(m_tasksQueue.front());
-					m_tasksQueue.pop();
+					return true;
+				}
+			}
+			return false;
+		}
 
-					// Unlock so other thread can find task from queue.
-					lockTasksQueue.unlock();
-					task();
+		void pushTaskInner(ThreadTask&& task)
+		{
+			++m_tasksQueueTotalNum;
 
-					lockTasksQueue.lock();
+			const int32_t workerIndex = getCurrentWorkerIndex();
+			WorkQueue& queue = workerIndex >= 0 ? m_workerQueues[workerIndex] : m_injectQueue;
+			{
+				// Count before push under queue lock, pop of this task always see it and counter never wrap.
+				std::lock_guard lock(queue.mutex);
+				++m_tasksQueuedNum;
+				queue.tasks.push_back(std::move(task));
+			}
 
-					// When task finish, we need lock again to minus queue num.
-					// Alway invoke new guy when waiting.
-					--m_tasksQueueTotalNum;
-					if (m_bWaiting)
-					{
-						m_cvTaskDone.notify_one();
-					}
+			if (m_sleepingNum.load() > 0)
+			{
+				std::lock_guard lock(m_sleepMutex);
+				m_cvTaskAvailable.notify_one();
+			}
+		}
+
+		void runTask(ThreadTask& task)
+		{
+			{
+				PROFILE_SCOPE("ThreadPool Task");
+				task();
+			}
+			--m_tasksQueueTotalNum;
+		}
+
+		void worker(uint32_t index)
+		{
+			s_workerPool = this;
+			s_workerIndex = int32_t(index);
+			PROFILE_THREAD_NAME("ThreadPool Worker " + std::to_string(index));
+
+			while (m_bRuning)
+			{
+				ThreadTask task;
+				if (!m_bPaused && tryPopTask(task))
+				{
+					runTask(task);
+					continue;
 				}
+
+				std::unique_lock<std::mutex> lock(m_sleepMutex);
+				++m_sleepingNum;
+				m_cvTaskAvailable.wait(lock, [&]
+				{
+					return (m_tasksQueuedNum.load() > 0 && !m_bPaused) || !m_bRuning;
+				});
+				--m_sleepingNum;
 			}
+
+			s_workerPool = nullptr;
+			s_workerIndex = -1;
 		}
 
 		void createThread()
 		{
 			m_bRuning = true;
+			m_workerQueues = std::make_unique<WorkQueue[]>(m_threadCount);
 			for (uint32_t i = 0; i < m_threadCount; i++)
 			{
-				m_threads[i] = std::thread(&ThreadPool::worker, this);
+				m_threads[i] = std::thread(&ThreadPool::worker, this, i);
 			}
 		}
 
 		void destroyThreads()
 		{
-			m_bRuning = false;
+			{
+				std::lock_guard lock(m_sleepMutex);
+				m_bRuning = false;
+			}
 			m_cvTaskAvailable.notify_all();
 			for (uint32_t i = 0; i < m_threadCount; i++)
 			{
 				m_threads[i].join();
 			}
+
+			// Tasks left in worker deques move to inject queue, queued counters keep match with real tasks.
+			for (uint32_t i = 0; i < m_threadCount; i++)
+			{
+				for (auto& task : m_workerQueues[i].tasks)
+				{
+					m_injectQueue.tasks.push_back(std::move(task));
+				}
+				m_workerQueues[i].tasks.clear();
+			}
 		}
 
 		inline uint32_t getThreadCount(bool bLeftOneFreeCore)
@@ -127,14 +360,12 @@ namespace Flower
 	public:
 		[[nodiscard]] size_t getTasksQueuedNum() const
 		{
-			const std::scoped_lock tasksLock(m_taskQueueMutex);
-			return m_tasksQueue.size();
+			return m_tasksQueuedNum;
 		}
 
 		[[nodiscard]] size_t getTasksRunningNum() const
 		{
-			const std::scoped_lock tasks_lock(m_taskQueueMutex);
-			return m_tasksQueueTotalNum - m_tasksQueue.size();
+			return m_tasksQueueTotalNum - m_tasksQueuedNum;
 		}
 
 		[[nodiscard]] size_t getTasksTotal() const
@@ -147,69 +378,116 @@ namespace Flower
 			return m_threadCount;
 		}
 
+		[[nodiscard]] bool isPaused() const
+		{
+			return m_bPaused;
+		}
+
+		// Workers stop pick new task, running tasks keep going.
+		void pause()
+		{
+			m_bPaused = true;
+		}
+
+		void unpause()
+		{
+			{
+				std::lock_guard lock(m_sleepMutex);
+				m_bPaused = false;
+			}
+
+			// Sleeping workers only wake by notify, wake all to drain tasks queued while paused.
+			m_cvTaskAvailable.notify_all();
+		}
+
+		// Run one pending task on calling thread, return false if no task found.
+		bool tryRunPendingTask()
+		{
+			if (m_bPaused)
+			{
+				return false;
+			}
+
+			ThreadTask task;
+			if (tryPopTask(task))
+			{
+				runTask(task);
+				return true;
+			}
+			return false;
+		}
+
+		// Help execute pending tasks until condition satisfied.
+		template<typename Pred>
+		void helpUntil(const Pred& pred)
+		{
+			while (!pred())
+			{
+				if (!tryRunPendingTask())
+				{
+					std::this_thread::yield();
+				}
+			}
+		}
+
 		// Wait for all task finish, if when pause, wait for all processing task finish.
+		// Calling thread help execute task when not pause.
 		void waitForTasks()
 		{
-			m_bWaiting = true;
-
-			std::unique_lock<std::mutex> tasksLock(m_taskQueueMutex);
-			m_cvTaskDone.wait(tasksLock, [this] 
-			{ 
-				return (m_tasksQueueTotalNum == (bPaused ? m_tasksQueue.size() : 0)); 
+			helpUntil([this]()
+			{
+				return m_tasksQueueTotalNum == (m_bPaused ? m_tasksQueuedNum.load() : 0);
 			});
-			m_bWaiting = false;
 		}
 
 		template <typename F, typename... A>
-		void pushTask(const F& task, const A&... args)
+		void pushTask(F&& task, A&&... args)
 		{
+			if constexpr (sizeof...(args) == 0)
 			{
-				const std::scoped_lock tasksLock(m_taskQueueMutex);
-				if constexpr (sizeof...(args) == 0)
-				{
-					m_tasksQueue.push(std::function<void()>(task));
-				}
-				else
-				{
-					m_tasksQueue.push(std::function<void()>([task, args...]{ task(args...); }));
-				}
+				pushTaskInner(ThreadTask(std::forward<F>(task)));
+			}
+			else
+			{
+				pushTaskInner(ThreadTask([task = std::forward<F>(task), ...args = std::forward<A>(args)]() mutable { task(args...); }));
 			}
-			++m_tasksQueueTotalNum;
-			m_cvTaskAvailable.notify_one();
 		}
 
 		template <typename F, typename... A, typename R = std::invoke_result_t<std::decay_t<F>, std::decay_t<A>...>>
-		[[nodiscard]] std::future<R> submit(const F& task, const A&... args)
+		[[nodiscard]] std::future<R> submit(F&& task, A&&... args)
 		{
-			std::shared_ptr<std::promise<R>> taskPromise = std::make_shared<std::promise<R>>();
-			
-			pushTask([task, args..., taskPromise]
+			// Promise move into task, no extra shared pointer.
+			std::promise<R> taskPromise;
+			std::future<R> future = taskPromise.get_future();
+
+			pushTask([task = std::forward<F>(task), ...args = std::forward<A>(args), taskPromise = std::move(taskPromise)]() mutable
 			{
 				if constexpr (std::is_void_v<R>)
 				{
 					task(args...);
-					taskPromise->set_value();
+					taskPromise.set_value();
 				}
 				else
 				{
-					taskPromise->set_value(task(args...));
+					taskPromise.set_value(task(args...));
 				}
 			});
-			return taskPromise->get_future();
+			return future;
 		}
 
+		// Recreate workers, queued tasks keep and run after reset.
 		void reset(bool bLeftOneFreeCore = true)
 		{
-			const bool wasPaused = bPaused;
+			const bool wasPaused = m_bPaused;
 
-			bPaused = true;
+			m_bPaused = true;
 			waitForTasks();
 			destroyThreads();
 
 			m_threadCount = getThreadCount(bLeftOneFreeCore);
 			m_threads = std::make_unique<std::thread[]>(m_threadCount);
 
-			bPaused = wasPaused;
+			m_bPaused = wasPaused;
 			createThread();
 		}
 
@@ -252,6 +530,61 @@ namespace Flower
 			return fc;
 		}
 
+		// Parallel for with guided chunking: loop(begin, end) on sub ranges.
+		// Every grab take max(minGrain, remain / (2 * threads)) items, big chunks first then smaller ones balance the tail.
+		// Calling thread join the loop, so nested call inside task is safe.
+		template <typename F>
+		void parallelFor(size_t first, size_t last, const F& loop, size_t minGrain = 1)
+		{
+			if (last <= first)
+			{
+				return;
+			}
+
+			const size_t total = last - first;
+			const size_t workerNum = size_t(m_threadCount) + 1;
+			minGrain = std::max(size_t(1), minGrain);
+
+			// Small loop no worth dispatch.
+			if (total <= minGrain)
+			{
+				loop(first, last);
+				return;
+			}
+
+			std::atomic<size_t> next = first;
+			std::atomic<size_t> activeNum = 0;
+
+			auto body = [&]()
+			{
+				size_t begin = next.load(std::memory_order_relaxed);
+				while (begin < last)
+				{
+					const size_t remain = last - begin;
+					const size_t chunk = std::min(remain, std::max(minGrain, remain / (2 * workerNum)));
+					if (next.compare_exchange_weak(begin, begin + chunk, std::memory_order_relaxed))
+					{
+						loop(begin, begin + chunk);
+						begin = next.load(std::memory_order_relaxed);
+					}
+				}
+			};
+
+			const size_t helperNum = std::min(size_t(m_threadCount), (total + minGrain - 1) / minGrain - 1);
+			activeNum = helperNum;
+			for (size_t i = 0; i < helperNum; i++)
+			{
+				pushTask([&]()
+				{
+					body();
+					activeNum.fetch_sub(1, std::memory_order_release);
+				});
+			}
+
+			body();
+			helpUntil([&]() { return activeNum.load(std::memory_order_acquire) == 0; });
+		}
+
 	public:
 		explicit ThreadPool(bool bLeftOneFreeCore = true)
 		{
@@ -265,7 +598,51 @@ namespace Flower
 			waitForTasks();
 			destroyThreads();
 		}
+
+		// 1us tasks and nested fork join on GThreadPool, compare with global queue pool of same worker count, log timings.
+		static void benchmark();
 	};
 
 	using GThreadPool = Singleton<ThreadPool>;
-}
\ No newline at end of file
+
+	// Fork join counter, task run on pool and wait() help execute pending tasks.
+	class TaskGroup : NonCopyable
+	{
+	private:
+		ThreadPool& m_pool;
+		std::atomic<uint32_t> m_counter = 0;
+
+	public:
+		explicit TaskGroup(ThreadPool& pool = *GThreadPool::get())
+			: m_pool(pool)
+		{
+
+		}
+
+		~TaskGroup()
+		{
+			wait();
+		}
+
+		template<typename F>
+		void run(F&& func)
+		{
+			m_counter.fetch_add(1, std::memory_order_relaxed);
+			m_pool.pushTask([this, func = std::forward<F>(func)]() mutable
+			{
+				func();
+				m_counter.fetch_sub(1, std::memory_order_release);
+			});
+		}
+
+		bool isFinish() const
+		{
+			return m_counter.load(std::memory_order_acquire) == 0;
+		}
+
+		void wait()
+		{
+			m_pool.helpUntil([this]() { return isFinish(); });
+		}
+	};
+}
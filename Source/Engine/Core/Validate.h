@@ -0,0 +1,55 @@
+#pragma once
+
+#include "../Pch.h"
+#include "NonCopyable.h"
+
+namespace Flower
+{
+	// Error collect of cmd.*.Validate console cmds.
+	// Random scenarios usually repeat same error every step, so only first errors log.
+	class ValidateReport : NonCopyable
+	{
+	private:
+		std::string m_name;
+		uint32_t m_errorCount = 0;
+		uint32_t m_maxLogCount;
+
+	public:
+		explicit ValidateReport(std::string name, uint32_t maxLogCount = 16)
+			: m_name(std::move(name))
+			, m_maxLogCount(maxLogCount)
+		{
+
+		}
+
+		// Return condition, caller can skip checks depend on it.
+		bool expect(bool bCondition, std::string_view what)
+		{
+			if (!bCondition)
+			{
+				if (m_errorCount < m_maxLogCount)
+				{
+					LOG_ERROR("{0} validate fail: {1}.", m_name, what);
+				}
+				m_errorCount++;
+			}
+			return bCondition;
+		}
+
+		uint32_t getErrorCount() const { return m_errorCount; }
+		bool isPass() const { return m_errorCount == 0; }
+
+		// Log pass or error count.
+		bool finish() const
+		{
+			if (m_errorCount > 0)
+			{
+				LOG_ERROR("{0} validate fail: {1} errors.", m_name, m_errorCount);
+				return false;
+			}
+
+			LOG_INFO("{0} validate pass.", m_name);
+			return true;
+		}
+	};
+}
@@ -1,15 +1,18 @@
 #include "Pch.h"
 #include "Engine.h"
 #include "RHI/RHI.h"
+#include "Core/ProfilerValidate.h"
 
 namespace Flower
 {
 	Engine* GEngine = Singleton<Engine>::get();
 
+	static AutoCVarCmd cVarThreadPoolBenchmark("cmd.ThreadPool.Benchmark", "Run 1us tasks and nested fork join on thread pool, compare with old global queue pool.");
+
 	void Engine::preInit(const EnginePreInitInfo& info)
 	{
-		CHECK(info.window && "Please pass a useful windows for engine init.");
-		RHI::get()->init(info.window);
+		CHECK((info.window || info.bHeadless) && "Please pass a useful windows for engine init.");
+		RHI::get()->init(info.bHeadless ? nullptr : info.window);
 
 		CHECK(m_moduleManager == nullptr && "Module manager is non empty, some memory leak happen.");
 		m_moduleManager = std::make_unique<ModuleManager>();
@@ -22,12 +25,39 @@ namespace Flower
 		CHECK(m_moduleManager->init());
 
 		m_timer.init();
+		m_framePacer.init();
+
+		PROFILE_THREAD_NAME("Main");
+	}
+
+	void Engine::waitForNextFrame()
+	{
+		m_framePacer.waitForNextFrame();
 	}
 
 	bool Engine::tick(const EngineTickData& data)
 	{
+		// Close last frame's profile events before any scope of this frame.
+		GFrameProfiler::get()->newFrame(m_timer.getTickCount());
+		PROFILE_SCOPE("Engine Tick");
+
 		const bool bSmoothFpsUpdate = m_timer.tick();
 
+		// Deliver last frame's log batch to console callbacks on main thread.
+		LogSystem::get()->tick();
+
+		// Dispatch cvar subscriptions changed since last frame.
+		CVarSystem::get()->tick();
+
+		// Check validate scopes closed by newFrame, record new ones on cmd.
+		FrameProfilerValidate::tick();
+
+		// Thread pool has no tick of its own.
+		CVarCmdHandle(cVarThreadPoolBenchmark, []()
+		{
+			ThreadPool::benchmark();
+		});
+
 		RuntimeModuleTickData tickData{};
 
 		tickData.windowWidth = data.windowWidth;
@@ -43,8 +73,18 @@ namespace Flower
 		tickData.bSmoothFpsUpdate = bSmoothFpsUpdate;
 		tickData.runTime = m_timer.getRuntime();
 
+		const auto& percentiles = m_timer.getFrameTimePercentiles();
+		tickData.frameTimeP50 = percentiles.p50;
+		tickData.frameTimeP95 = percentiles.p95;
+		tickData.frameTimeP99 = percentiles.p99;
+		tickData.latency = m_framePacer.getSmoothLatency();
+		tickData.bLatencyToDisplay = m_framePacer.isLatencyToDisplay();
+
 		m_moduleManager->tick(tickData);
 
+		// Present already finish in renderer tick.
+		m_framePacer.endFrame();
+
 		return true;
 	}
 
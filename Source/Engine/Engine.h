@@ -3,12 +3,16 @@
 #include "Core/Core.h"
 #include "RuntimeModule.h"
 #include "EngineTimer.h"
+#include "FramePacer.h"
 
 namespace Flower
 {
 	struct EnginePreInitInfo
 	{
-		GLFWwindow* window;
+		GLFWwindow* window = nullptr;
+
+		// Headless mode init without window, use for benchmark and ci.
+		bool bHeadless = false;
 	};
 
 	struct EngineTickData
@@ -26,6 +30,7 @@ namespace Flower
 		std::unique_ptr<ModuleManager> m_moduleManager{ nullptr };
 
 		EngineTimer m_timer;
+		FramePacer m_framePacer;
 
 	public:
 		template <typename T>
@@ -42,6 +47,10 @@ namespace Flower
 
 		void preInit(const EnginePreInitInfo& info);
 		void init();
+
+		// Frame pacing and limiter, call before input poll.
+		void waitForNextFrame();
+
 		bool tick(const EngineTickData& data);
 		void release();
 	};
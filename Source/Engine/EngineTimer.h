@@ -3,10 +3,20 @@
 
 namespace Flower
 {
+    // Frame time percentiles of recent frames, ms.
+    struct FrameTimePercentiles
+    {
+        float p50 = 0.0f;
+        float p95 = 0.0f;
+        float p99 = 0.0f;
+    };
+
     class EngineTimer
     {
         friend class Engine;
     private:
+        // Recent frame times ring, percentiles update with smooth fps.
+        static constexpr size_t kFrameTimeHistoryCount = 512;
         std::chrono::system_clock::time_point m_timePoint{ };
         std::chrono::system_clock::time_point m_startPoint{ };
         std::chrono::duration<float> m_deltaTime{ 0.0f };
@@ -22,6 +32,11 @@ namespace Flower
         uint32_t m_passFrameForSmoothFps = 0;
         float m_passTimeForSmoothFps = 0.0f;
 
+        std::array<float, kFrameTimeHistoryCount> m_frameTimeHistory{ };
+        size_t m_frameTimeHistoryCount = 0;
+        size_t m_frameTimeHistoryIndex = 0;
+        FrameTimePercentiles m_frameTimePercentiles{ };
+
     private:
         void init()
         {
@@ -41,6 +56,10 @@ namespace Flower
 
             m_tickCount ++;
 
+            m_frameTimeHistory[m_frameTimeHistoryIndex] = m_dt * 1000.0f;
+            m_frameTimeHistoryIndex = (m_frameTimeHistoryIndex + 1) % kFrameTimeHistoryCount;
+            m_frameTimeHistoryCount = std::min(m_frameTimeHistoryCount + 1, kFrameTimeHistoryCount);
+
             // Update smooth fps per-second.
             m_passFrameForSmoothFps++;
             m_passTimeForSmoothFps += m_dt;
@@ -51,6 +70,8 @@ namespace Flower
                 m_smoothFps = m_passFrameForSmoothFps / m_passTimeForSmoothFps;
                 m_passTimeForSmoothFps = 0;
                 m_passFrameForSmoothFps = 0;
+
+                updateFrameTimePercentiles();
             }
 
             // Update fps every frame.
@@ -59,6 +80,26 @@ namespace Flower
             return bSmoothFpsUpdate;
         }
 
+        void updateFrameTimePercentiles()
+        {
+            std::vector<float> sorted(m_frameTimeHistory.begin(), m_frameTimeHistory.begin() + m_frameTimeHistoryCount);
+            if (sorted.empty())
+            {
+                return;
+            }
+
+            auto percentile = [&](float p)
+            {
+                const size_t index = std::min(size_t(p * float(sorted.size())), sorted.size() - 1);
+                std::nth_element(sorted.begin(), sorted.begin() + index, sorted.end());
+                return sorted[index];
+            };
+
+            m_frameTimePercentiles.p50 = percentile(0.50f);
+            m_frameTimePercentiles.p95 = percentile(0.95f);
+            m_frameTimePercentiles.p99 = percentile(0.99f);
+        }
+
         // Use lerp function to get smooth time dt.
         float computeSmoothDt(float oldDt, float dt)
         {
@@ -85,6 +126,9 @@ namespace Flower
         // Get smooth dt, use lerp 5 frames dt to get smooth result.
         float getSmoothDt() const { return m_smoothDt; }
 
+        // Percentiles of last kFrameTimeHistoryCount frame times, update per-seconds.
+        const FrameTimePercentiles& getFrameTimePercentiles() const { return m_frameTimePercentiles; }
+
         // Get tick count.
         auto  getTickCount() const { return m_tickCount; }
 
@@ -0,0 +1,135 @@
+#include "Pch.h"
+#include "FramePacer.h"
+#include "RHI/RHI.h"
+
+namespace Flower
+{
+	static AutoCVarInt32 cVarMaxFps(
+		"r.Present.MaxFps",
+		"Frame limiter target fps, 0 is unlimited.",
+		"Present",
+		0,
+		CVarFlags::ReadAndWrite
+	);
+
+	static AutoCVarInt32 cVarLimiterSpinMicroseconds(
+		"r.Present.LimiterSpinMicroseconds",
+		"Frame limiter sleep until this time before target, then spin, cover os sleep granularity.",
+		"Present",
+		2000,
+		CVarFlags::ReadAndWrite
+	);
+
+	static AutoCVarInt32 cVarWaitForPresent(
+		"r.Present.WaitForPresent",
+		"Wait older frame show on screen before input poll, only work when present wait support. 0 is off, 1 is on.",
+		"Present",
+		1,
+		CVarFlags::ReadAndWrite
+	);
+
+	// Never block forever on present wait, when window hide present may not show.
+	constexpr uint64_t kPresentWaitTimeout = 100'000'000; // ns.
+
+	// Pending present no display result after these frames, drop.
+	constexpr size_t kMaxPendingPresents = 16;
+
+	void FramePacer::init()
+	{
+		m_frameStartPoint = Clock::now();
+		m_inputPoint = m_frameStartPoint;
+	}
+
+	void FramePacer::waitForNextFrame()
+	{
+		PROFILE_SCOPE("Frame Pacing");
+
+		const uint64_t lastPresentId = RHI::get()->getLastPresentId();
+		if (RHI::bSupportPresentWait && lastPresentId > 0)
+		{
+			// Keep max frames in flight - 1 presents queue, input sample after old frame show on screen.
+			const uint64_t framesInFlight = RHI::get()->getMaxFramesInFlight();
+			const uint64_t waitPresentId = lastPresentId + 1 > framesInFlight ? lastPresentId + 1 - framesInFlight : 0;
+
+			if (cVarWaitForPresent.get() != 0 && waitPresentId > 0)
+			{
+				RHI::get()->waitForPresent(waitPresentId, kPresentWaitTimeout);
+			}
+
+			// Oldest pending present show, zero timeout only poll.
+			while (!m_pendingPresents.empty() && RHI::get()->waitForPresent(m_pendingPresents.front().presentId, 0))
+			{
+				const auto& pending = m_pendingPresents.front();
+				updateLatency(std::chrono::duration<float, std::milli>(Clock::now() - pending.inputPoint).count(), true);
+				m_pendingPresents.pop_front();
+			}
+		}
+
+		limitFrameRate();
+
+		m_inputPoint = Clock::now();
+	}
+
+	void FramePacer::limitFrameRate()
+	{
+		const int32_t maxFps = cVarMaxFps.get();
+		if (maxFps <= 0)
+		{
+			m_frameStartPoint = Clock::now();
+			return;
+		}
+
+		const auto framePeriod = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / double(maxFps)));
+		const auto spinTime = std::chrono::microseconds(std::max(cVarLimiterSpinMicroseconds.get(), 0));
+		const auto targetPoint = m_frameStartPoint + framePeriod;
+
+		// Coarse sleep, os may wake up late so leave spin time.
+		if (Clock::now() + spinTime < targetPoint)
+		{
+			std::this_thread::sleep_for(targetPoint - spinTime - Clock::now());
+		}
+
+		// Spin remain time.
+		while (Clock::now() < targetPoint)
+		{
+			std::this_thread::yield();
+		}
+
+		// Keep steady cadence, but no catch up burst when already late more than one frame.
+		const auto now = Clock::now();
+		m_frameStartPoint = (now - targetPoint) > framePeriod ? now : targetPoint;
+	}
+
+	void FramePacer::endFrame()
+	{
+		if (!RHI::bSupportPresentWait)
+		{
+			// No display time, measure to present call return.
+			updateLatency(std::chrono::duration<float, std::milli>(Clock::now() - m_inputPoint).count(), false);
+			return;
+		}
+
+		// No present this frame when minimized.
+		const uint64_t presentId = RHI::get()->getLastPresentId();
+		if (presentId == m_lastPresentId)
+		{
+			return;
+		}
+		m_lastPresentId = presentId;
+
+		m_pendingPresents.push_back({ presentId, m_inputPoint });
+		while (m_pendingPresents.size() > kMaxPendingPresents)
+		{
+			m_pendingPresents.pop_front();
+		}
+	}
+
+	void FramePacer::updateLatency(float latency, bool bToDisplay)
+	{
+		constexpr float kSmoothFactor = 0.1f;
+
+		m_latency = latency;
+		m_smoothLatency = (m_bLatencyToDisplay == bToDisplay) ? glm::mix(m_smoothLatency, latency, kSmoothFactor) : latency;
+		m_bLatencyToDisplay = bToDisplay;
+	}
+}
@@ -0,0 +1,53 @@
+#pragma once
+#include "Core/Core.h"
+
+namespace Flower
+{
+	// Frame pacing before input poll: wait present show on screen when support, then sleep-then-spin frame limiter.
+	// Also measure input to present latency, use present wait to get display time when support.
+	class FramePacer
+	{
+		friend class Engine;
+	private:
+		using Clock = std::chrono::steady_clock;
+
+		// Frame limiter cadence point.
+		Clock::time_point m_frameStartPoint{ };
+
+		// Input sample point of current frame.
+		Clock::time_point m_inputPoint{ };
+
+		// Presents wait display measure.
+		struct PendingPresent
+		{
+			uint64_t presentId;
+			Clock::time_point inputPoint;
+		};
+		std::deque<PendingPresent> m_pendingPresents;
+		uint64_t m_lastPresentId = 0;
+
+		float m_latency = 0.0f; // ms.
+		float m_smoothLatency = 0.0f;
+		bool m_bLatencyToDisplay = false;
+
+	private:
+		void init();
+
+		// Call before input poll.
+		void waitForNextFrame();
+
+		// Call after frame present.
+		void endFrame();
+
+		void limitFrameRate();
+		void updateLatency(float latency, bool bToDisplay);
+
+	public:
+		// Latency from input sample to present, ms.
+		float getLatency() const { return m_latency; }
+		float getSmoothLatency() const { return m_smoothLatency; }
+
+		// True when latency measure to present show on screen, false is to present call return.
+		bool isLatencyToDisplay() const { return m_bLatencyToDisplay; }
+	};
+}
@@ -46,6 +46,8 @@ namespace Flower
     MulticastDelegate<const EngineTickData&> Launcher::tickFunction;
     MulticastDelegate<> Launcher::releaseHookFunction;
 
+    static bool GLauncherHeadless = false;
+
     enum class EWindowShowMode : int32_t
     {
         Min = -1,
@@ -189,12 +191,30 @@ namespace Flower
         glfwTerminate();
     }
 
+    static void headlessInit(const LauncherInfo& info)
+    {
+        const uint32_t width  = std::max(10u, info.initWidth.value_or(uint32_t(cVarWindowDefaultWidth.get())));
+        const uint32_t height = std::max(10u, info.initHeight.value_or(uint32_t(cVarWindowDefaultHeight.get())));
+
+        LOG_INFO("Headless mode, offscreen size: ({0},{1}).", width, height);
+        GLFWWindowData::get()->callbackOnResize(width, height);
+    }
+
     bool Launcher::preInit(const LauncherInfo& info)
     {
-        GLFWInit(info);
+        GLauncherHeadless = info.bHeadless;
 
         EnginePreInitInfo engineInitInfo{ };
-        engineInitInfo.window = GLFWWindowData::get()->getWindow();
+        if (GLauncherHeadless)
+        {
+            headlessInit(info);
+            engineInitInfo.bHeadless = true;
+        }
+        else
+        {
+            GLFWInit(info);
+            engineInitInfo.window = GLFWWindowData::get()->getWindow();
+        }
 
         GEngine->preInit(engineInitInfo);
 
@@ -211,8 +231,31 @@ namespace Flower
 
     void Launcher::guardedMain()
     {
+        if (GLauncherHeadless)
+        {
+            // No window events, run until someone require exit.
+            while (GLFWWindowData::get()->shouldRun())
+            {
+                GEngine->waitForNextFrame();
+
+                EngineTickData tickData{};
+
+                tickData.windowWidth = GLFWWindowData::get()->getWidth();
+                tickData.windowHeight = GLFWWindowData::get()->getHeight();
+                tickData.bLoseFocus = false;
+                tickData.bIsMinimized = false;
+
+                GLFWWindowData::get()->setShouldRun(GEngine->tick(tickData));
+
+                tickFunction.broadcast(tickData);
+            }
+            return;
+        }
+
         while (!glfwWindowShouldClose(GLFWWindowData::get()->getWindow()) && GLFWWindowData::get()->shouldRun())
         {
+            // Pace before poll, so input sample as late as possible.
+            GEngine->waitForNextFrame();
             glfwPollEvents();
 
             EngineTickData tickData{};
@@ -239,14 +282,27 @@ namespace Flower
         GEngine->release();
 
         // GLFW release.
-        GLFWRelease();
+        if (!GLauncherHeadless)
+        {
+            GLFWRelease();
+        }
 
         // Sleep 1s before close.
         std::this_thread::sleep_for(std::chrono::milliseconds(1000));
     }
 
+    bool Launcher::isHeadless()
+    {
+        return GLauncherHeadless;
+    }
+
     void Launcher::setWindowTileName(const char* projectName, const char* sceneName)
     {
+        if (GLauncherHeadless)
+        {
+            return;
+        }
+
         std::stringstream finalTileName;
         finalTileName << cVarTileName.get();
         finalTileName << " - ";
@@ -13,6 +13,9 @@ namespace Flower
 		std::optional<uint32_t> initHeight;
 
 		std::optional<std::string> titleName;
+
+		// Run without window and swapchain, initWidth & initHeight use as offscreen size.
+		bool bHeadless = false;
 	};
 
 	class Launcher
@@ -30,5 +33,7 @@ namespace Flower
 		static void release();
 
 		static void setWindowTileName(const char* projectName, const char* sceneName);
+
+		static bool isHeadless();
 	};
 }
\ No newline at end of file
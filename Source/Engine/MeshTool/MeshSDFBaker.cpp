@@ -0,0 +1,469 @@
+#include "Pch.h"
+#include "MeshSDFBaker.h"
+#include "MeshToolCommon.h"
+#include "../Scene/BVH.h"
+
+#include <array>
+
+namespace Flower
+{
+	float MeshDistanceField::fetch(const glm::uvec3& sample) const
+	{
+		const glm::uvec3 brick = glm::min(sample / (kBrickSize - 1), brickCount - 1u);
+		const glm::uvec3 local = sample - brick * (kBrickSize - 1);
+
+		const uint32_t brickData = brickTable[(brick.z * brickCount.y + brick.y) * brickCount.x + brick.x];
+		if (brickData == kBrickOutside)
+		{
+			return narrowBand;
+		}
+		else if (brickData == kBrickInside)
+		{
+			return -narrowBand;
+		}
+
+		const uint32_t sampleId = (local.z * kBrickSize + local.y) * kBrickSize + local.x;
+		return decode(this->brickData[size_t(brickData) * kBrickSampleCount + sampleId], narrowBand);
+	}
+
+	float MeshDistanceField::sample(const glm::vec3& localPosition) const
+	{
+		CHECK(isValid());
+
+		const glm::vec3 maxSample = glm::vec3(getSampleCount() - 1u);
+		const glm::vec3 grid = glm::clamp((localPosition - boundsMin) / voxelSize, glm::vec3(0.0f), maxSample);
+
+		const glm::uvec3 s0 = glm::min(glm::uvec3(grid), glm::uvec3(maxSample) - 1u);
+		const glm::vec3 f = grid - glm::vec3(s0);
+
+		auto fetchOffset = [&](uint32_t x, uint32_t y, uint32_t z)
+		{
+			return fetch(s0 + glm::uvec3(x, y, z));
+		};
+
+		const float x00 = glm::mix(fetchOffset(0, 0, 0), fetchOffset(1, 0, 0), f.x);
+		const float x10 = glm::mix(fetchOffset(0, 1, 0), fetchOffset(1, 1, 0), f.x);
+		const float x01 = glm::mix(fetchOffset(0, 0, 1), fetchOffset(1, 0, 1), f.x);
+		const float x11 = glm::mix(fetchOffset(0, 1, 1), fetchOffset(1, 1, 1), f.x);
+
+		return glm::mix(glm::mix(x00, x10, f.y), glm::mix(x01, x11, f.y), f.z);
+	}
+
+	size_t MeshDistanceField::getGPUSize() const
+	{
+		static_assert(kBrickSampleCount % sizeof(uint32_t) == 0);
+		return sizeof(glm::uvec4) + sizeof(glm::vec4) * 2 + brickTable.size() * sizeof(uint32_t) + brickData.size();
+	}
+
+	void MeshDistanceField::packGPUData(uint8_t* dest) const
+	{
+		const glm::uvec4 header0 = glm::uvec4(brickCount, getStoredBrickCount());
+		const glm::vec4 header1 = glm::vec4(boundsMin, voxelSize);
+		const glm::vec4 header2 = glm::vec4(narrowBand, 0.0f, 0.0f, 0.0f);
+
+		memcpy(dest, &header0, sizeof(header0)); dest += sizeof(header0);
+		memcpy(dest, &header1, sizeof(header1)); dest += sizeof(header1);
+		memcpy(dest, &header2, sizeof(header2)); dest += sizeof(header2);
+
+		memcpy(dest, brickTable.data(), brickTable.size() * sizeof(uint32_t));
+		dest += brickTable.size() * sizeof(uint32_t);
+
+		memcpy(dest, brickData.data(), brickData.size());
+	}
+
+	namespace MeshSDFBaker
+	{
+		// Non axis aligned, avoid ray graze along axis aligned faces and edges.
+		static const glm::vec3 kParityRayDirections[3] =
+		{
+			glm::normalize(glm::vec3( 1.00f,  0.23f,  0.41f)),
+			glm::normalize(glm::vec3(-0.31f,  1.00f,  0.17f)),
+			glm::normalize(glm::vec3( 0.19f, -0.37f, -1.00f)),
+		};
+
+		static bool isInside(const TriangleBVH& bvh, const glm::vec3& position)
+		{
+			uint32_t insideVote = 0;
+			uint32_t outsideVote = 0;
+			for (const auto& direction : kParityRayDirections)
+			{
+				BVHRay ray;
+				ray.origin = position;
+				ray.direction = direction;
+				if (bvh.countHits(ray) & 1)
+				{
+					insideVote++;
+				}
+				else
+				{
+					outsideVote++;
+				}
+
+				// Majority reach, skip last ray.
+				if (insideVote >= 2 || outsideVote >= 2)
+				{
+					break;
+				}
+			}
+			return insideVote >= 2;
+		}
+
+		MeshDistanceField bake(
+			const std::vector<StaticMeshVertex>& vertices,
+			const VertexIndexType* indices,
+			size_t indexCount,
+			const MeshSDFBakeConfig& config)
+		{
+			constexpr uint32_t kBrickSize = MeshDistanceField::kBrickSize;
+			constexpr uint32_t kBrickSampleCount = MeshDistanceField::kBrickSampleCount;
+
+			MeshDistanceField result{};
+			if (indexCount < 3 || config.resolution < 2)
+			{
+				return result;
+			}
+
+			BVHBounds meshBounds{};
+			for (size_t i = 0; i < indexCount; i++)
+			{
+				meshBounds.expand(vertices[indices[i]].position);
+			}
+
+			const glm::vec3 meshExtent = meshBounds.max - meshBounds.min;
+			const float maxExtent = glm::max(glm::max(meshExtent.x, meshExtent.y), meshExtent.z);
+			if (maxExtent <= 0.0f)
+			{
+				return result;
+			}
+
+			TriangleBVH bvh;
+			bvh.build(vertices, indices, indexCount);
+
+			result.voxelSize = maxExtent / float(config.resolution - 1);
+			result.narrowBand = config.narrowBandVoxels * result.voxelSize;
+
+			const float padding = config.paddingVoxels * result.voxelSize;
+			const float brickSpan = result.voxelSize * float(kBrickSize - 1);
+			result.boundsMin = meshBounds.min - padding;
+			result.brickCount = glm::max(glm::uvec3(glm::ceil((meshExtent + padding * 2.0f) / brickSpan)), glm::uvec3(1));
+
+			const uint32_t brickCount = result.brickCount.x * result.brickCount.y * result.brickCount.z;
+			result.brickTable.resize(brickCount);
+
+			// Brick samples bake parallel, then compact in brick order so result is deterministic.
+			std::vector<std::vector<uint8_t>> brickSamples(brickCount);
+			const float halfDiagonal = 0.5f * glm::sqrt(3.0f) * brickSpan;
+			const float narrowBandSquare = result.narrowBand * result.narrowBand;
+
+			GThreadPool::get()->parallelFor(0, brickCount, [&](size_t begin, size_t end)
+			{
+				for (size_t brickId = begin; brickId < end; brickId++)
+				{
+					const glm::uvec3 brick = glm::uvec3(
+						brickId % result.brickCount.x,
+						(brickId / result.brickCount.x) % result.brickCount.y,
+						brickId / (result.brickCount.x * result.brickCount.y));
+
+					const glm::vec3 brickMin = result.boundsMin + glm::vec3(brick) * brickSpan;
+					const glm::vec3 brickCenter = brickMin + brickSpan * 0.5f;
+
+					// No triangle near brick, all samples out of narrow band and share one sign.
+					float searchSquare = (result.narrowBand + halfDiagonal) * (result.narrowBand + halfDiagonal);
+					if (bvh.queryClosest(brickCenter, searchSquare) == GBVHInvalidIndex)
+					{
+						result.brickTable[brickId] = isInside(bvh, brickCenter) ? MeshDistanceField::kBrickInside : MeshDistanceField::kBrickOutside;
+						continue;
+					}
+
+					auto& samples = brickSamples[brickId];
+					samples.resize(kBrickSampleCount);
+
+					// Unsigned distance and sign of brick samples, for sign propagate.
+					std::array<float, kBrickSampleCount> distances;
+					std::array<bool, kBrickSampleCount> bInsides;
+
+					bool bAllOutside = true;
+					bool bAllInside = true;
+					for (uint32_t z = 0; z < kBrickSize; z++)
+					{
+						for (uint32_t y = 0; y < kBrickSize; y++)
+						{
+							for (uint32_t x = 0; x < kBrickSize; x++)
+							{
+								const uint32_t sampleId = (z * kBrickSize + y) * kBrickSize + x;
+								const glm::vec3 position = brickMin + glm::vec3(x, y, z) * result.voxelSize;
+
+								const uint32_t neighborId = x > 0 ? sampleId - 1 : (y > 0 ? sampleId - kBrickSize : (z > 0 ? sampleId - kBrickSize * kBrickSize : ~0u));
+
+								// Distance at most neighbor distance plus one voxel, start search with it, much less triangle visit.
+								float searchDistance = result.narrowBand;
+								if (neighborId != ~0u)
+								{
+									searchDistance = glm::min(searchDistance, distances[neighborId] + result.voxelSize * 1.001f);
+								}
+
+								float distanceSquare = searchDistance * searchDistance;
+								bool bNearSurface = bvh.queryClosest(position, distanceSquare) != GBVHInvalidIndex;
+								if (!bNearSurface && searchDistance < result.narrowBand)
+								{
+									distanceSquare = narrowBandSquare;
+									bNearSurface = bvh.queryClosest(position, distanceSquare) != GBVHInvalidIndex;
+								}
+								const float distance = bNearSurface ? glm::sqrt(distanceSquare) : result.narrowBand;
+
+								// Previous sample farther than one voxel from surface, segment between can't cross surface, so share sign.
+								// Only sample close to surface cast parity rays.
+								const bool bInside = (neighborId != ~0u && distances[neighborId] > result.voxelSize)
+									? bInsides[neighborId]
+									: isInside(bvh, position);
+
+								distances[sampleId] = distance;
+								bInsides[sampleId] = bInside;
+
+								bAllOutside &= !bNearSurface && !bInside;
+								bAllInside &= !bNearSurface && bInside;
+
+								samples[sampleId] = MeshDistanceField::encode(bInside ? -distance : distance, result.narrowBand);
+							}
+						}
+					}
+
+					if (bAllOutside || bAllInside)
+					{
+						result.brickTable[brickId] = bAllInside ? MeshDistanceField::kBrickInside : MeshDistanceField::kBrickOutside;
+						samples.clear();
+					}
+				}
+			});
+
+			uint32_t storedBrickCount = 0;
+			for (uint32_t brickId = 0; brickId < brickCount; brickId++)
+			{
+				if (!brickSamples[brickId].empty())
+				{
+					result.brickTable[brickId] = storedBrickCount++;
+				}
+			}
+
+			result.brickData.reserve(size_t(storedBrickCount) * kBrickSampleCount);
+			for (const auto& samples : brickSamples)
+			{
+				result.brickData.insert(result.brickData.end(), samples.begin(), samples.end());
+			}
+
+			return result;
+		}
+
+		float bruteForceDistance(
+			const std::vector<StaticMeshVertex>& vertices,
+			const VertexIndexType* indices,
+			size_t indexCount,
+			const glm::vec3& position)
+		{
+			// Closest point and generalized winding number of all triangles, sign independent of ray parity.
+			// Double precision, plane projection of sliver triangle is unstable in float.
+			const glm::dvec3 position64 = glm::dvec3(position);
+			double minDistanceSquare = std::numeric_limits<double>::max();
+			double solidAngle = 0.0;
+
+			for (size_t i = 0; i + 2 < indexCount; i += 3)
+			{
+				const glm::dvec3 p0 = glm::dvec3(vertices[indices[i + 0]].position);
+				const glm::dvec3 p1 = glm::dvec3(vertices[indices[i + 1]].position);
+				const glm::dvec3 p2 = glm::dvec3(vertices[indices[i + 2]].position);
+
+				// Project to plane, fallback to edges when outside.
+				const glm::dvec3 n = glm::cross(p1 - p0, p2 - p0);
+				const double nn = glm::dot(n, n);
+				if (nn > 0.0)
+				{
+					const glm::dvec3 projected = position64 - n * (glm::dot(position64 - p0, n) / nn);
+					const double b1 = glm::dot(glm::cross(p2 - p1, projected - p1), n);
+					const double b2 = glm::dot(glm::cross(p0 - p2, projected - p2), n);
+					const double b3 = glm::dot(glm::cross(p1 - p0, projected - p0), n);
+					if (b1 >= 0.0 && b2 >= 0.0 && b3 >= 0.0)
+					{
+						const glm::dvec3 d = projected - position64;
+						minDistanceSquare = glm::min(minDistanceSquare, glm::dot(d, d));
+					}
+				}
+
+				auto segmentDistanceSquare = [&](const glm::dvec3& a, const glm::dvec3& b)
+				{
+					const glm::dvec3 ab = b - a;
+					const double abab = glm::dot(ab, ab);
+					const double t = abab > 0.0 ? glm::clamp(glm::dot(position64 - a, ab) / abab, 0.0, 1.0) : 0.0;
+					const glm::dvec3 d = a + ab * t - position64;
+					return glm::dot(d, d);
+				};
+				minDistanceSquare = glm::min(minDistanceSquare, segmentDistanceSquare(p0, p1));
+				minDistanceSquare = glm::min(minDistanceSquare, segmentDistanceSquare(p1, p2));
+				minDistanceSquare = glm::min(minDistanceSquare, segmentDistanceSquare(p2, p0));
+
+				// Van oosterom strackee triangle solid angle.
+				const glm::dvec3 a = p0 - position64;
+				const glm::dvec3 b = p1 - position64;
+				const glm::dvec3 c = p2 - position64;
+				const double la = glm::length(a);
+				const double lb = glm::length(b);
+				const double lc = glm::length(c);
+				const double numerator = glm::dot(a, glm::cross(b, c));
+				const double denominator = la * lb * lc + glm::dot(a, b) * lc + glm::dot(b, c) * la + glm::dot(c, a) * lb;
+				solidAngle += 2.0 * std::atan2(numerator, denominator);
+			}
+
+			const double winding = solidAngle / (4.0 * glm::pi<double>());
+			const float distance = float(glm::sqrt(minDistanceSquare));
+			return glm::abs(winding) > 0.5 ? -distance : distance;
+		}
+
+		static MeshBuilder::MeshData buildSphere(uint32_t stacks, uint32_t slices, float radius)
+		{
+			MeshBuilder::MeshData mesh{};
+			for (uint32_t i = 0; i <= stacks; i++)
+			{
+				const float phi = glm::pi<float>() * float(i) / float(stacks);
+				for (uint32_t j = 0; j <= slices; j++)
+				{
+					const float theta = glm::two_pi<float>() * float(j) / float(slices);
+					const glm::vec3 n = glm::vec3(glm::sin(phi) * glm::cos(theta), glm::cos(phi), glm::sin(phi) * glm::sin(theta));
+
+					StaticMeshVertex vertex{};
+					vertex.position = n * radius;
+					vertex.normal = n;
+					mesh.vertices.push_back(vertex);
+				}
+			}
+
+			for (uint32_t i = 0; i < stacks; i++)
+			{
+				for (uint32_t j = 0; j < slices; j++)
+				{
+					const uint32_t v0 = i * (slices + 1) + j;
+					const uint32_t v1 = v0 + slices + 1;
+					mesh.indices.insert(mesh.indices.end(), { v0, v1, v0 + 1, v0 + 1, v1, v1 + 1 });
+				}
+			}
+			return mesh;
+		}
+
+		static MeshBuilder::MeshData buildTorus(uint32_t rings, uint32_t sides, float radius, float tubeRadius)
+		{
+			MeshBuilder::MeshData mesh{};
+			for (uint32_t i = 0; i < rings; i++)
+			{
+				const float u = glm::two_pi<float>() * float(i) / float(rings);
+				for (uint32_t j = 0; j < sides; j++)
+				{
+					const float v = glm::two_pi<float>() * float(j) / float(sides);
+					const glm::vec3 center = glm::vec3(glm::cos(u), 0.0f, glm::sin(u)) * radius;
+					const glm::vec3 n = glm::vec3(glm::cos(u) * glm::cos(v), glm::sin(v), glm::sin(u) * glm::cos(v));
+
+					StaticMeshVertex vertex{};
+					vertex.position = center + n * tubeRadius;
+					vertex.normal = n;
+					mesh.vertices.push_back(vertex);
+				}
+			}
+
+			for (uint32_t i = 0; i < rings; i++)
+			{
+				for (uint32_t j = 0; j < sides; j++)
+				{
+					const uint32_t v0 = i * sides + j;
+					const uint32_t v1 = ((i + 1) % rings) * sides + j;
+					const uint32_t v2 = i * sides + (j + 1) % sides;
+					const uint32_t v3 = ((i + 1) % rings) * sides + (j + 1) % sides;
+					mesh.indices.insert(mesh.indices.end(), { v0, v2, v1, v2, v3, v1 });
+				}
+			}
+			return mesh;
+		}
+
+		void validateAndBenchmark()
+		{
+			using Clock = std::chrono::high_resolution_clock;
+			auto elapsedMs = [](Clock::time_point start)
+			{
+				return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+			};
+
+			struct TestMesh
+			{
+				const char* name;
+				MeshBuilder::MeshData mesh;
+			};
+			std::vector<TestMesh> testMeshes =
+			{
+				{ "box",    MeshBuilder::buildBox() },
+				{ "sphere", buildSphere(16, 32, 1.0f) },
+				{ "torus",  buildTorus(32, 16, 1.0f, 0.35f) },
+			};
+
+			// Accuracy: every grid sample against brute force, clamp to narrow band. Quantize step is the expected error.
+			MeshSDFBakeConfig validateConfig{};
+			validateConfig.resolution = 32;
+			for (const auto& test : testMeshes)
+			{
+				const auto& mesh = test.mesh;
+				const auto field = bake(mesh.vertices, mesh.indices.data(), mesh.indices.size(), validateConfig);
+				CHECK(field.isValid());
+
+				const glm::uvec3 sampleCount = field.getSampleCount();
+				const uint32_t totalSampleCount = sampleCount.x * sampleCount.y * sampleCount.z;
+
+				std::atomic<uint32_t> signMismatchCount = 0;
+				std::vector<float> errors(totalSampleCount, 0.0f);
+				GThreadPool::get()->parallelFor(0, totalSampleCount, [&](size_t begin, size_t end)
+				{
+					for (size_t i = begin; i < end; i++)
+					{
+						const glm::uvec3 sample = glm::uvec3(i % sampleCount.x, (i / sampleCount.x) % sampleCount.y, i / (sampleCount.x * sampleCount.y));
+						const glm::vec3 position = field.boundsMin + glm::vec3(sample) * field.voxelSize;
+
+						const float reference = glm::clamp(bruteForceDistance(mesh.vertices, mesh.indices.data(), mesh.indices.size(), position), -field.narrowBand, field.narrowBand);
+						const float baked = field.fetch(sample);
+
+						// Sign only matter out of surface quantize step.
+						if (glm::abs(reference) > field.voxelSize * 0.5f && (reference < 0.0f) != (baked < 0.0f))
+						{
+							signMismatchCount++;
+						}
+						errors[i] = glm::abs(reference - baked);
+					}
+				}, 256);
+
+				const float maxError = *std::max_element(errors.begin(), errors.end());
+				const float quantizeStep = field.narrowBand / 127.5f;
+				const bool bPass = signMismatchCount == 0 && maxError <= quantizeStep * 0.5f + 1e-4f * field.narrowBand;
+
+				if (bPass)
+				{
+					LOG_INFO("Mesh sdf validate {0} pass: {1} samples, {2}/{3} bricks stored, max error {4:.4f} voxel.",
+						test.name, totalSampleCount, field.getStoredBrickCount(), field.brickTable.size(), maxError / field.voxelSize);
+				}
+				else
+				{
+					LOG_ERROR("Mesh sdf validate {0} fail: {1} samples, max error {2:.4f} voxel, sign mismatch {3}.",
+						test.name, totalSampleCount, maxError / field.voxelSize, signMismatchCount.load());
+				}
+			}
+
+			// Throughput: dense sphere, near surface samples dominate bake time.
+			{
+				const auto mesh = buildSphere(256, 512, 1.0f);
+				MeshSDFBakeConfig benchmarkConfig{};
+				benchmarkConfig.resolution = 128;
+
+				const auto start = Clock::now();
+				const auto field = bake(mesh.vertices, mesh.indices.data(), mesh.indices.size(), benchmarkConfig);
+				const double bakeMs = elapsedMs(start);
+
+				const double sampleCount = double(field.getStoredBrickCount()) * MeshDistanceField::kBrickSampleCount;
+				LOG_INFO("Mesh sdf bake {0} triangles at resolution {1}: {2:.2f} ms, {3}/{4} bricks stored, {5:.2f} M samples/s, {6} KB.",
+					mesh.indices.size() / 3, benchmarkConfig.resolution, bakeMs, field.getStoredBrickCount(), field.brickTable.size(),
+					sampleCount / bakeMs * 1e-3, field.getGPUSize() / 1024);
+			}
+		}
+	}
+}
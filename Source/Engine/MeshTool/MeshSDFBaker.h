@@ -0,0 +1,112 @@
+#pragma once
+
+#include "../Core/Core.h"
+#include "../Renderer/MeshMisc.h"
+
+namespace Flower
+{
+	// Sparse brick signed distance field of one mesh, mesh local space.
+	// Volume split into bricks of kBrickSize^3 samples, neighbor bricks share border samples so trilinear filter never cross brick.
+	// Only bricks near surface store samples, quantize to 8 bit in [-narrowBand, narrowBand].
+	// Other bricks only store sign in brick table, and decode as +-narrowBand.
+	struct MeshDistanceField
+	{
+		static constexpr uint32_t kBrickSize = 8;
+		static constexpr uint32_t kBrickSampleCount = kBrickSize * kBrickSize * kBrickSize;
+
+		// Brick table value of brick without samples.
+		static constexpr uint32_t kBrickOutside = ~0u;
+		static constexpr uint32_t kBrickInside = ~0u - 1;
+
+		// Position of sample (0, 0, 0).
+		glm::vec3 boundsMin = glm::vec3(0.0f);
+		float voxelSize = 0.0f;
+
+		glm::uvec3 brickCount = glm::uvec3(0);
+		float narrowBand = 0.0f;
+
+		// Brick data index per brick, x fastest.
+		std::vector<uint32_t> brickTable;
+
+		// kBrickSampleCount quantized samples per stored brick, x fastest.
+		std::vector<uint8_t> brickData;
+
+		template<class Archive>
+		void serialize(Archive& archive)
+		{
+			archive(boundsMin, voxelSize);
+			archive(brickCount, narrowBand);
+			archive(brickTable, brickData);
+		}
+
+		bool isValid() const
+		{
+			return !brickTable.empty();
+		}
+
+		glm::uvec3 getSampleCount() const
+		{
+			return brickCount * (kBrickSize - 1) + 1u;
+		}
+
+		uint32_t getStoredBrickCount() const
+		{
+			return uint32_t(brickData.size() / kBrickSampleCount);
+		}
+
+		static uint8_t encode(float distance, float narrowBand)
+		{
+			const float n = glm::clamp(distance / narrowBand, -1.0f, 1.0f);
+			return uint8_t(glm::round(n * 127.5f + 127.5f));
+		}
+
+		static float decode(uint8_t value, float narrowBand)
+		{
+			return (float(value) / 127.5f - 1.0f) * narrowBand;
+		}
+
+		// Decode sample on grid.
+		float fetch(const glm::uvec3& sample) const;
+
+		// Trilinear filter distance, position outside volume clamp to border.
+		float sample(const glm::vec3& localPosition) const;
+
+		// Gpu layout: uvec4(brickCount, storedBrickCount), vec4(boundsMin, voxelSize), vec4(narrowBand, 0, 0, 0),
+		// then brick table uint array, then brick data pack 4 samples per uint.
+		size_t getGPUSize() const;
+		void packGPUData(uint8_t* dest) const;
+	};
+
+	struct MeshSDFBakeConfig
+	{
+		// Sample count along longest bounds axis.
+		uint32_t resolution = 64;
+
+		// Narrow band half width in voxels.
+		float narrowBandVoxels = 4.0f;
+
+		// Bounds padding in voxels, keep surface inside volume.
+		float paddingVoxels = 2.0f;
+	};
+
+	// Bake signed distance with triangle bvh closest query, sign by ray parity majority of three rays,
+	// so small holes in non watertight mesh only affect nearby samples. Bricks bake parallel.
+	namespace MeshSDFBaker
+	{
+		MeshDistanceField bake(
+			const std::vector<StaticMeshVertex>& vertices,
+			const VertexIndexType* indices,
+			size_t indexCount,
+			const MeshSDFBakeConfig& config = {});
+
+		// Reference distance of all triangles, no acceleration, for validate.
+		float bruteForceDistance(
+			const std::vector<StaticMeshVertex>& vertices,
+			const VertexIndexType* indices,
+			size_t indexCount,
+			const glm::vec3& position);
+
+		// Bake small synthetic meshes, compare all samples with brute force and log error and bake throughput.
+		void validateAndBenchmark();
+	}
+}
@@ -0,0 +1,692 @@
+#include "Pch.h"
+#include "MeshSimplifier.h"
+#include "MeshToolCommon.h"
+#include "../Scene/BVH.h"
+
+namespace Flower
+{
+	namespace MeshSimplifier
+	{
+		// Collapse which turn triangle normal more than ~75 degree away from its source triangle reject,
+		// compare with source normal so small turns can't accumulate into fold.
+		constexpr double kMinNormalDot = 0.25;
+
+		// Border plane quadric weight, keep open border shape.
+		constexpr double kBorderWeight = 10.0;
+
+		// Lod which reduce less than this ratio of previous lod no worth store.
+		constexpr double kMinLodReduction = 0.9;
+
+		// Symmetric 4x4 plane quadric, only store upper part.
+		struct Quadric
+		{
+			double a00 = 0.0, a01 = 0.0, a02 = 0.0, a03 = 0.0;
+			double a11 = 0.0, a12 = 0.0, a13 = 0.0;
+			double a22 = 0.0, a23 = 0.0;
+			double a33 = 0.0;
+
+			static Quadric fromPlane(const glm::dvec3& n, double d, double weight)
+			{
+				Quadric q;
+				q.a00 = weight * n.x * n.x; q.a01 = weight * n.x * n.y; q.a02 = weight * n.x * n.z; q.a03 = weight * n.x * d;
+				q.a11 = weight * n.y * n.y; q.a12 = weight * n.y * n.z; q.a13 = weight * n.y * d;
+				q.a22 = weight * n.z * n.z; q.a23 = weight * n.z * d;
+				q.a33 = weight * d * d;
+				return q;
+			}
+
+			void add(const Quadric& q)
+			{
+				a00 += q.a00; a01 += q.a01; a02 += q.a02; a03 += q.a03;
+				a11 += q.a11; a12 += q.a12; a13 += q.a13;
+				a22 += q.a22; a23 += q.a23;
+				a33 += q.a33;
+			}
+
+			// Sum of weighted squared distance to planes.
+			double evaluate(const glm::dvec3& p) const
+			{
+				const double result =
+					p.x * p.x * a00 + 2.0 * p.x * p.y * a01 + 2.0 * p.x * p.z * a02 + 2.0 * p.x * a03 +
+					p.y * p.y * a11 + 2.0 * p.y * p.z * a12 + 2.0 * p.y * a13 +
+					p.z * p.z * a22 + 2.0 * p.z * a23 +
+					a33;
+
+				return glm::max(result, 0.0);
+			}
+		};
+
+		class Simplifier
+		{
+		private:
+			// Per welded vertex.
+			std::vector<glm::dvec3> m_positions;
+			std::vector<Quadric> m_quadrics;
+			std::vector<VertexIndexType> m_attributes; // First source vertex.
+			std::vector<uint8_t> m_bLocked;
+			std::vector<uint8_t> m_bBorder;
+			std::vector<std::vector<uint32_t>> m_vertexTriangles; // May contain dead triangles.
+
+			// Per triangle.
+			std::vector<glm::uvec3> m_triangles; // Welded vertex.
+			std::vector<glm::uvec3> m_corners;   // Source vertex.
+			std::vector<glm::dvec3> m_sourceNormals;
+			std::vector<uint8_t> m_bTriangleAlive;
+			size_t m_aliveTriangleCount = 0;
+
+			double m_maxCollapseCost = 0.0;
+
+			struct Collapse
+			{
+				double cost;
+				uint32_t from;
+				uint32_t to;
+			};
+
+			static uint64_t edgeKey(uint32_t a, uint32_t b)
+			{
+				return (uint64_t(glm::min(a, b)) << 32) | uint64_t(glm::max(a, b));
+			}
+
+			bool containVertex(uint32_t triangle, uint32_t vertex) const
+			{
+				const auto& t = m_triangles[triangle];
+				return t.x == vertex || t.y == vertex || t.z == vertex;
+			}
+
+			glm::dvec3 getNormal(const glm::dvec3& p0, const glm::dvec3& p1, const glm::dvec3& p2) const
+			{
+				return glm::cross(p1 - p0, p2 - p0);
+			}
+
+			void collectNeighbors(uint32_t vertex, std::vector<uint32_t>& outNeighbors) const
+			{
+				outNeighbors.clear();
+				for (uint32_t triangle : m_vertexTriangles[vertex])
+				{
+					if (!m_bTriangleAlive[triangle])
+					{
+						continue;
+					}
+
+					for (uint32_t k = 0; k < 3; k++)
+					{
+						const uint32_t neighbor = m_triangles[triangle][k];
+						if (neighbor != vertex && std::find(outNeighbors.begin(), outNeighbors.end(), neighbor) == outNeighbors.end())
+						{
+							outNeighbors.push_back(neighbor);
+						}
+					}
+				}
+			}
+
+			bool isCollapseValid(uint32_t from, uint32_t to)
+			{
+				uint32_t sharedCount = 0;
+				for (uint32_t triangle : m_vertexTriangles[from])
+				{
+					if (m_bTriangleAlive[triangle] && containVertex(triangle, to))
+					{
+						sharedCount++;
+					}
+				}
+
+				// Edge already gone, or border vertex leave border.
+				if (sharedCount == 0 || (m_bBorder[from] && sharedCount != 1))
+				{
+					return false;
+				}
+
+				// Link condition, common neighbors must be opposite vertices of shared triangles, keep topology.
+				static thread_local std::vector<uint32_t> fromNeighbors;
+				static thread_local std::vector<uint32_t> toNeighbors;
+				collectNeighbors(from, fromNeighbors);
+				collectNeighbors(to, toNeighbors);
+
+				uint32_t commonCount = 0;
+				for (uint32_t neighbor : fromNeighbors)
+				{
+					if (neighbor != to && std::find(toNeighbors.begin(), toNeighbors.end(), neighbor) != toNeighbors.end())
+					{
+						commonCount++;
+					}
+				}
+				if (commonCount != sharedCount)
+				{
+					return false;
+				}
+
+				// Flip check for triangles which keep alive after collapse.
+				for (uint32_t triangle : m_vertexTriangles[from])
+				{
+					if (!m_bTriangleAlive[triangle] || containVertex(triangle, to))
+					{
+						continue;
+					}
+
+					glm::dvec3 p[3];
+					glm::dvec3 q[3];
+					for (uint32_t k = 0; k < 3; k++)
+					{
+						const uint32_t vertex = m_triangles[triangle][k];
+						p[k] = m_positions[vertex];
+						q[k] = (vertex == from) ? m_positions[to] : p[k];
+					}
+
+					const glm::dvec3 oldNormal = getNormal(p[0], p[1], p[2]);
+					const glm::dvec3 newNormal = getNormal(q[0], q[1], q[2]);
+					const double newLength = glm::length(newNormal);
+					if (newLength <= 0.0 ||
+						glm::dot(oldNormal, newNormal) <= 0.0 ||
+						glm::dot(m_sourceNormals[triangle], newNormal) < kMinNormalDot * newLength)
+					{
+						return false;
+					}
+				}
+
+				return true;
+			}
+
+			void collapse(uint32_t from, uint32_t to, double cost)
+			{
+				// Attribute vertex of target on source side, source vertex no seam so all its triangles on same side.
+				VertexIndexType toAttribute = m_attributes[to];
+				for (uint32_t triangle : m_vertexTriangles[from])
+				{
+					if (m_bTriangleAlive[triangle] && containVertex(triangle, to))
+					{
+						for (uint32_t k = 0; k < 3; k++)
+						{
+							if (m_triangles[triangle][k] == to)
+							{
+								toAttribute = m_corners[triangle][k];
+							}
+						}
+						break;
+					}
+				}
+
+				for (uint32_t triangle : m_vertexTriangles[from])
+				{
+					if (!m_bTriangleAlive[triangle])
+					{
+						continue;
+					}
+
+					if (containVertex(triangle, to))
+					{
+						m_bTriangleAlive[triangle] = 0;
+						m_aliveTriangleCount--;
+						continue;
+					}
+
+					for (uint32_t k = 0; k < 3; k++)
+					{
+						if (m_triangles[triangle][k] == from)
+						{
+							m_triangles[triangle][k] = to;
+							m_corners[triangle][k] = toAttribute;
+						}
+					}
+					m_vertexTriangles[to].push_back(triangle);
+				}
+
+				m_vertexTriangles[from].clear();
+				m_quadrics[to].add(m_quadrics[from]);
+				m_maxCollapseCost = glm::max(m_maxCollapseCost, cost);
+			}
+
+		public:
+			Simplifier(const std::vector<StaticMeshVertex>& vertices, const VertexIndexType* indices, size_t indexCount)
+			{
+				// Weld by position, vertex which split by attributes lock.
+				std::unordered_map<glm::vec3, uint32_t> positionMap;
+				auto weld = [&](VertexIndexType index)
+				{
+					const glm::vec3& position = vertices[index].position;
+					auto [it, bInserted] = positionMap.try_emplace(position, uint32_t(m_positions.size()));
+					if (bInserted)
+					{
+						m_positions.push_back(glm::dvec3(position));
+						m_attributes.push_back(index);
+						m_bLocked.push_back(0);
+					}
+					else if (m_attributes[it->second] != index)
+					{
+						m_bLocked[it->second] = 1;
+					}
+					return it->second;
+				};
+
+				m_triangles.reserve(indexCount / 3);
+				m_corners.reserve(indexCount / 3);
+				for (size_t i = 0; i + 2 < indexCount; i += 3)
+				{
+					const glm::uvec3 corner = { indices[i + 0], indices[i + 1], indices[i + 2] };
+					const glm::uvec3 triangle = { weld(corner.x), weld(corner.y), weld(corner.z) };
+
+					// Degenerate triangle no contribute to lods.
+					if (triangle.x == triangle.y || triangle.y == triangle.z || triangle.z == triangle.x)
+					{
+						continue;
+					}
+
+					m_triangles.push_back(triangle);
+					m_corners.push_back(corner);
+				}
+
+				const size_t vertexCount = m_positions.size();
+				m_quadrics.resize(vertexCount);
+				m_bBorder.resize(vertexCount, 0);
+				m_vertexTriangles.resize(vertexCount);
+				m_bTriangleAlive.resize(m_triangles.size(), 1);
+				m_aliveTriangleCount = m_triangles.size();
+
+				std::unordered_map<uint64_t, uint32_t> edgeCounts;
+				for (uint32_t triangle = 0; triangle < m_triangles.size(); triangle++)
+				{
+					for (uint32_t k = 0; k < 3; k++)
+					{
+						m_vertexTriangles[m_triangles[triangle][k]].push_back(triangle);
+						edgeCounts[edgeKey(m_triangles[triangle][k], m_triangles[triangle][(k + 1) % 3])]++;
+					}
+				}
+
+				m_sourceNormals.resize(m_triangles.size(), glm::dvec3(0.0));
+				for (uint32_t triangle = 0; triangle < m_triangles.size(); triangle++)
+				{
+					const auto& t = m_triangles[triangle];
+					glm::dvec3 normal = getNormal(m_positions[t.x], m_positions[t.y], m_positions[t.z]);
+					const double normalLength = glm::length(normal);
+					if (normalLength <= 0.0)
+					{
+						continue;
+					}
+					normal /= normalLength;
+					m_sourceNormals[triangle] = normal;
+
+					const Quadric planeQuadric = Quadric::fromPlane(normal, -glm::dot(normal, m_positions[t.x]), 1.0);
+					for (uint32_t k = 0; k < 3; k++)
+					{
+						m_quadrics[t[k]].add(planeQuadric);
+					}
+
+					for (uint32_t k = 0; k < 3; k++)
+					{
+						const uint32_t a = t[k];
+						const uint32_t b = t[(k + 1) % 3];
+						const uint32_t edgeCount = edgeCounts[edgeKey(a, b)];
+
+						if (edgeCount == 1)
+						{
+							// Plane perpendicular to triangle through border edge.
+							m_bBorder[a] = 1;
+							m_bBorder[b] = 1;
+
+							const glm::dvec3 edgeDir = m_positions[b] - m_positions[a];
+							const double edgeLength = glm::length(edgeDir);
+							if (edgeLength > 0.0)
+							{
+								const glm::dvec3 borderNormal = glm::normalize(glm::cross(edgeDir / edgeLength, normal));
+								const Quadric borderQuadric = Quadric::fromPlane(borderNormal, -glm::dot(borderNormal, m_positions[a]), kBorderWeight);
+								m_quadrics[a].add(borderQuadric);
+								m_quadrics[b].add(borderQuadric);
+							}
+						}
+						else if (edgeCount > 2)
+						{
+							// Non-manifold edge.
+							m_bLocked[a] = 1;
+							m_bLocked[b] = 1;
+						}
+					}
+				}
+			}
+
+			size_t getAliveTriangleCount() const
+			{
+				return m_aliveTriangleCount;
+			}
+
+			float getError() const
+			{
+				return float(glm::sqrt(m_maxCollapseCost));
+			}
+
+			// Collapse until triangle count reach target or next collapse error over max error.
+			void simplify(size_t targetTriangleCount, float maxError)
+			{
+				const double maxCost = double(maxError) * double(maxError);
+
+				std::vector<Collapse> collapses;
+				std::vector<uint8_t> bTouched(m_positions.size(), 0);
+				while (m_aliveTriangleCount > targetTriangleCount)
+				{
+					collapses.clear();
+					for (uint32_t triangle = 0; triangle < m_triangles.size(); triangle++)
+					{
+						if (!m_bTriangleAlive[triangle])
+						{
+							continue;
+						}
+
+						for (uint32_t k = 0; k < 3; k++)
+						{
+							const uint32_t a = m_triangles[triangle][k];
+							const uint32_t b = m_triangles[triangle][(k + 1) % 3];
+
+							auto tryAdd = [&](uint32_t from, uint32_t to)
+							{
+								// Border vertex only move along border.
+								if (m_bLocked[from] || (m_bBorder[from] && !m_bBorder[to]))
+								{
+									return;
+								}
+
+								Quadric quadric = m_quadrics[from];
+								quadric.add(m_quadrics[to]);
+
+								const double cost = quadric.evaluate(m_positions[to]);
+								if (cost <= maxCost)
+								{
+									collapses.push_back({ cost, from, to });
+								}
+							};
+							tryAdd(a, b);
+							tryAdd(b, a);
+						}
+					}
+
+					if (collapses.empty())
+					{
+						break;
+					}
+					std::sort(collapses.begin(), collapses.end(), [](const Collapse& a, const Collapse& b) { return a.cost < b.cost; });
+
+					// Cost only depend on two vertices, so collapse with untouched vertices still valid in this pass.
+					std::fill(bTouched.begin(), bTouched.end(), 0);
+					bool bAnyCollapse = false;
+					for (const auto& candidate : collapses)
+					{
+						if (bTouched[candidate.from] || bTouched[candidate.to] || !isCollapseValid(candidate.from, candidate.to))
+						{
+							continue;
+						}
+
+						collapse(candidate.from, candidate.to, candidate.cost);
+						bTouched[candidate.from] = 1;
+						bTouched[candidate.to] = 1;
+						bAnyCollapse = true;
+
+						if (m_aliveTriangleCount <= targetTriangleCount)
+						{
+							break;
+						}
+					}
+
+					if (!bAnyCollapse)
+					{
+						break;
+					}
+				}
+			}
+
+			std::vector<VertexIndexType> buildIndices() const
+			{
+				std::vector<VertexIndexType> result;
+				result.reserve(m_aliveTriangleCount * 3);
+				for (uint32_t triangle = 0; triangle < m_triangles.size(); triangle++)
+				{
+					if (m_bTriangleAlive[triangle])
+					{
+						result.push_back(m_corners[triangle].x);
+						result.push_back(m_corners[triangle].y);
+						result.push_back(m_corners[triangle].z);
+					}
+				}
+				return result;
+			}
+		};
+
+		std::vector<Lod> buildLodChain(
+			const std::vector<StaticMeshVertex>& vertices,
+			const VertexIndexType* indices,
+			size_t indexCount,
+			const std::vector<LodTarget>& targets)
+		{
+			CHECK(indexCount % 3 == 0);
+
+			std::vector<Lod> lods;
+			if (indexCount == 0)
+			{
+				return lods;
+			}
+
+			// Each lod continue collapse from previous one, error only grow.
+			Simplifier simplifier(vertices, indices, indexCount);
+			size_t prevTriangleCount = indexCount / 3;
+			for (const auto& target : targets)
+			{
+				const size_t targetTriangleCount = size_t(double(indexCount / 3) * double(target.indexRatio));
+				simplifier.simplify(targetTriangleCount, target.maxError);
+
+				const size_t triangleCount = simplifier.getAliveTriangleCount();
+				if (triangleCount == 0 || double(triangleCount) > double(prevTriangleCount) * kMinLodReduction)
+				{
+					break;
+				}
+
+				lods.push_back({ simplifier.buildIndices(), simplifier.getError() });
+				prevTriangleCount = triangleCount;
+			}
+
+			return lods;
+		}
+	
+		bool validate()
+		{
+			struct TestMesh
+			{
+				const char* name;
+				MeshBuilder::MeshData mesh;
+				float radius;
+
+				// Analytic outward normal at surface point, triangle face against it is flip.
+				std::function<glm::vec3(const glm::vec3&)> outward;
+			};
+
+			std::vector<TestMesh> testMeshes;
+
+			// Open plane, border vertex only slide along border, error must stay zero.
+			{
+				constexpr uint32_t kGrid = 64;
+				MeshBuilder::MeshData mesh{};
+				for (uint32_t z = 0; z <= kGrid; z++)
+				{
+					for (uint32_t x = 0; x <= kGrid; x++)
+					{
+						StaticMeshVertex vertex{};
+						vertex.position = glm::vec3(float(x), 0.0f, float(z)) / float(kGrid);
+						vertex.uv0 = glm::vec2(float(x), float(z)) / float(kGrid);
+						mesh.vertices.push_back(vertex);
+					}
+				}
+				for (uint32_t z = 0; z < kGrid; z++)
+				{
+					for (uint32_t x = 0; x < kGrid; x++)
+					{
+						const uint32_t v0 = z * (kGrid + 1) + x;
+						const uint32_t v1 = v0 + kGrid + 1;
+						mesh.indices.insert(mesh.indices.end(), { v0, v1, v0 + 1, v0 + 1, v1, v1 + 1 });
+					}
+				}
+				testMeshes.push_back({ "plane", std::move(mesh), 0.7f, [](const glm::vec3&) { return glm::vec3(0.0f, 1.0f, 0.0f); } });
+			}
+
+			// Uv sphere, seam column split by uv so it keep locked.
+			{
+				constexpr uint32_t kStacks = 32;
+				constexpr uint32_t kSlices = 64;
+				MeshBuilder::MeshData mesh{};
+				for (uint32_t i = 0; i <= kStacks; i++)
+				{
+					const float phi = glm::pi<float>() * float(i) / float(kStacks);
+					for (uint32_t j = 0; j <= kSlices; j++)
+					{
+						const float theta = glm::two_pi<float>() * float(j % kSlices) / float(kSlices);
+
+						StaticMeshVertex vertex{};
+						vertex.position = (i == 0 || i == kStacks)
+							? glm::vec3(0.0f, glm::cos(phi), 0.0f)
+							: glm::vec3(glm::sin(phi) * glm::cos(theta), glm::cos(phi), glm::sin(phi) * glm::sin(theta));
+						vertex.normal = vertex.position;
+						vertex.uv0 = glm::vec2(float(j) / float(kSlices), float(i) / float(kStacks));
+						mesh.vertices.push_back(vertex);
+					}
+				}
+				for (uint32_t i = 0; i < kStacks; i++)
+				{
+					for (uint32_t j = 0; j < kSlices; j++)
+					{
+						const uint32_t v0 = i * (kSlices + 1) + j;
+						const uint32_t v1 = v0 + kSlices + 1;
+						if (i != 0)
+						{
+							mesh.indices.insert(mesh.indices.end(), { v0, v0 + 1, v1 });
+						}
+						if (i != kStacks - 1)
+						{
+							mesh.indices.insert(mesh.indices.end(), { v0 + 1, v1 + 1, v1 });
+						}
+					}
+				}
+				testMeshes.push_back({ "sphere", std::move(mesh), 1.0f, [](const glm::vec3& p) { return p; } });
+			}
+
+			// Closed torus, saddle region check flip on non convex surface.
+			{
+				constexpr uint32_t kRings = 64;
+				constexpr uint32_t kSides = 32;
+				constexpr float kRadius = 1.0f;
+				constexpr float kTubeRadius = 0.35f;
+				MeshBuilder::MeshData mesh{};
+				for (uint32_t i = 0; i < kRings; i++)
+				{
+					const float u = glm::two_pi<float>() * float(i) / float(kRings);
+					for (uint32_t j = 0; j < kSides; j++)
+					{
+						const float v = glm::two_pi<float>() * float(j) / float(kSides);
+						const glm::vec3 n = glm::vec3(glm::cos(u) * glm::cos(v), glm::sin(v), glm::sin(u) * glm::cos(v));
+
+						StaticMeshVertex vertex{};
+						vertex.position = glm::vec3(glm::cos(u), 0.0f, glm::sin(u)) * kRadius + n * kTubeRadius;
+						vertex.normal = n;
+						mesh.vertices.push_back(vertex);
+					}
+				}
+				for (uint32_t i = 0; i < kRings; i++)
+				{
+					for (uint32_t j = 0; j < kSides; j++)
+					{
+						const uint32_t v0 = i * kSides + j;
+						const uint32_t v1 = ((i + 1) % kRings) * kSides + j;
+						const uint32_t v2 = i * kSides + (j + 1) % kSides;
+						const uint32_t v3 = ((i + 1) % kRings) * kSides + (j + 1) % kSides;
+						mesh.indices.insert(mesh.indices.end(), { v0, v2, v1, v2, v3, v1 });
+					}
+				}
+				testMeshes.push_back({ "torus", std::move(mesh), kRadius + kTubeRadius, [](const glm::vec3& p)
+				{
+					return p - glm::normalize(glm::vec3(p.x, 0.0f, p.z)) * kRadius;
+				}});
+			}
+
+			// Barycentric samples per lod triangle for surface distance.
+			const glm::vec3 kSamples[] =
+			{
+				glm::vec3(1.0f / 3.0f),
+				glm::vec3(0.5f, 0.5f, 0.0f),
+				glm::vec3(0.0f, 0.5f, 0.5f),
+				glm::vec3(0.5f, 0.0f, 0.5f),
+			};
+
+			ValidateReport report("Mesh simplifier");
+			for (const auto& test : testMeshes)
+			{
+				const auto& mesh = test.mesh;
+				const std::vector<LodTarget> targets =
+				{
+					{ 0.5f,   0.01f * test.radius },
+					{ 0.25f,  0.03f * test.radius },
+					{ 0.125f, 0.08f * test.radius },
+				};
+
+				const auto lods = buildLodChain(mesh.vertices, mesh.indices.data(), mesh.indices.size(), targets);
+
+				TriangleBVH sourceBVH;
+				sourceBVH.build(mesh.vertices, mesh.indices.data(), mesh.indices.size());
+				if (!report.expect(!lods.empty(), std::string(test.name) + " no lod build"))
+				{
+					continue;
+				}
+
+				for (size_t lodIndex = 0; lodIndex < lods.size(); lodIndex++)
+				{
+					const auto& lod = lods[lodIndex];
+					const size_t triangleCount = lod.indices.size() / 3;
+
+					std::atomic<uint32_t> flipCount = 0;
+					std::atomic<uint32_t> degenerateCount = 0;
+					std::vector<float> distances(triangleCount, 0.0f);
+					GThreadPool::get()->parallelFor(0, triangleCount, [&](size_t begin, size_t end)
+					{
+						for (size_t i = begin; i < end; i++)
+						{
+							const VertexIndexType i0 = lod.indices[i * 3 + 0];
+							const VertexIndexType i1 = lod.indices[i * 3 + 1];
+							const VertexIndexType i2 = lod.indices[i * 3 + 2];
+							if (i0 == i1 || i1 == i2 || i0 == i2)
+							{
+								degenerateCount++;
+								continue;
+							}
+
+							const glm::vec3 p0 = mesh.vertices[i0].position;
+							const glm::vec3 p1 = mesh.vertices[i1].position;
+							const glm::vec3 p2 = mesh.vertices[i2].position;
+
+							const glm::vec3 centroid = (p0 + p1 + p2) / 3.0f;
+							if (glm::dot(glm::cross(p1 - p0, p2 - p0), test.outward(centroid)) <= 0.0f)
+							{
+								flipCount++;
+							}
+
+							// One sided hausdorff to source mesh, quadric error bound it.
+							for (const auto& weight : kSamples)
+							{
+								const glm::vec3 position = p0 * weight.x + p1 * weight.y + p2 * weight.z;
+								float distanceSquare = std::numeric_limits<float>::max();
+								sourceBVH.queryClosest(position, distanceSquare);
+								distances[i] = glm::max(distances[i], glm::sqrt(distanceSquare));
+							}
+						}
+					}, 64);
+
+					const float maxDistance = *std::max_element(distances.begin(), distances.end());
+					const float tolerance = 1e-5f * test.radius;
+					const std::string lodName = std::string(test.name) + " lod " + std::to_string(lodIndex + 1);
+
+					report.expect(flipCount == 0, lodName + " " + std::to_string(flipCount.load()) + " flipped triangles");
+					report.expect(degenerateCount == 0, lodName + " " + std::to_string(degenerateCount.load()) + " degenerate triangles");
+					report.expect(lod.error <= targets[lodIndex].maxError + tolerance, lodName + " error over bound");
+					report.expect(maxDistance <= lod.error + tolerance, lodName + " surface distance over error");
+
+					LOG_INFO("Mesh simplifier validate {0} lod {1}: {2}/{3} triangles, error {4:.5f} (bound {5:.5f}), surface distance {6:.5f}.",
+						test.name, lodIndex + 1, triangleCount, mesh.indices.size() / 3, lod.error, targets[lodIndex].maxError, maxDistance);
+				}
+			}
+
+			return report.finish();
+		}
+	}
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "../Core/Core.h"
+#include "../Renderer/MeshMisc.h"
+
+namespace Flower
+{
+	// Quadric error edge collapse simplifier, build lod chain over shared vertices.
+	// Lod indices reference input vertices, no new vertex create, so all lods can share one vertex buffer.
+	//
+	// Collapse only move one vertex onto its neighbor (half edge collapse). Vertex which split by attributes (uv seam),
+	// or on non-manifold edge keep locked, open border vertex only collapse along border. Collapse which flip triangle
+	// or change topology reject.
+	namespace MeshSimplifier
+	{
+		struct LodTarget
+		{
+			// Target index count relative to input index count.
+			float indexRatio;
+
+			// Max object space error of this lod.
+			float maxError;
+		};
+
+		struct Lod
+		{
+			std::vector<VertexIndexType> indices;
+
+			// Object space error, sqrt of max collapse quadric error, upper bound of vertex distance to source triangle planes.
+			float error = 0.0f;
+		};
+
+		// Lod chain stop when one lod can't reduce enough, so result lod count may less than target count.
+		std::vector<Lod> buildLodChain(
+			const std::vector<StaticMeshVertex>& vertices,
+			const VertexIndexType* indices,
+			size_t indexCount,
+			const std::vector<LodTarget>& targets);
+
+		// Simplify plane grid, uv sphere and torus, check error bound, surface distance and triangle flip.
+		bool validate();
+	}
+}
@@ -1,7 +1,98 @@
 #include "Pch.h"
 #include "CommandBuffer.h"
+#include "RHI.h"
 
 namespace Flower
 {
+	void ThreadCommandPools::init(uint32_t queueFamily, uint32_t frameCount)
+	{
+		CHECK(m_slots.empty() && "Thread command pools already init.");
 
-}
\ No newline at end of file
+		m_queueFamily = queueFamily;
+		m_frameCount = frameCount;
+		m_frameIndex = 0;
+	}
+
+	void ThreadCommandPools::release()
+	{
+		std::unique_lock<std::shared_mutex> lock(m_slotMutex);
+		for (auto& pair : m_slots)
+		{
+			for (auto& frame : pair.second->frames)
+			{
+				// Destroy pool will free all command buffers allocated from it.
+				vkDestroyCommandPool(RHI::Device, frame.pool, nullptr);
+			}
+		}
+		m_slots.clear();
+	}
+
+	ThreadCommandPools::ThreadSlot* ThreadCommandPools::getOrCreateThreadSlot()
+	{
+		const auto threadId = std::this_thread::get_id();
+		{
+			std::shared_lock<std::shared_mutex> lock(m_slotMutex);
+			auto it = m_slots.find(threadId);
+			if (it != m_slots.end())
+			{
+				return it->second.get();
+			}
+		}
+
+		auto newSlot = std::make_unique<ThreadSlot>();
+		newSlot->frames.resize(m_frameCount);
+
+		VkCommandPoolCreateInfo poolInfo{};
+		poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+		poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+		poolInfo.queueFamilyIndex = m_queueFamily;
+		for (auto& frame : newSlot->frames)
+		{
+			RHICheck(vkCreateCommandPool(RHI::Device, &poolInfo, nullptr, &frame.pool));
+		}
+
+		std::unique_lock<std::shared_mutex> lock(m_slotMutex);
+		ThreadSlot* result = newSlot.get();
+		m_slots[threadId] = std::move(newSlot);
+		return result;
+	}
+
+	void ThreadCommandPools::beginFrame(uint32_t frameIndex)
+	{
+		CHECK(frameIndex < m_frameCount);
+		m_frameIndex = frameIndex;
+
+		std::shared_lock<std::shared_mutex> lock(m_slotMutex);
+		for (auto& pair : m_slots)
+		{
+			auto& frame = pair.second->frames[m_frameIndex];
+			if (frame.usedCount > 0)
+			{
+				RHICheck(vkResetCommandPool(RHI::Device, frame.pool, 0));
+			}
+
+			frame.usedCount = 0;
+		}
+	}
+
+	VkCommandBuffer ThreadCommandPools::allocate()
+	{
+		ThreadSlot* slot = getOrCreateThreadSlot();
+		auto& frame = slot->frames[m_frameIndex];
+
+		if (frame.usedCount >= frame.buffers.size())
+		{
+			VkCommandBufferAllocateInfo info{};
+			info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+			info.commandBufferCount = 1;
+			info.commandPool = frame.pool;
+			info.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+
+			VkCommandBuffer newBuffer;
+			RHICheck(vkAllocateCommandBuffers(RHI::Device, &info, &newBuffer));
+			frame.buffers.push_back(newBuffer);
+		}
+
+		return frame.buffers[frame.usedCount++];
+	}
+}
@@ -10,4 +10,49 @@ namespace Flower
 		VkCommandPool pool;
 		uint32_t queueFamily;
 	};
-}
\ No newline at end of file
+
+	// Per-thread, per-frame command pools.
+	// Vulkan command pool is externally synchronized, so every recording thread own one pool per flighting frame.
+	// Recording threads can allocate command buffers without any lock once they get their slot.
+	class ThreadCommandPools : NonCopyable
+	{
+	private:
+		struct FramePool
+		{
+			VkCommandPool pool = VK_NULL_HANDLE;
+
+			// Primary command buffers allocated from pool, reuse across frames.
+			std::vector<VkCommandBuffer> buffers;
+			uint32_t usedCount = 0;
+		};
+
+		struct ThreadSlot
+		{
+			std::vector<FramePool> frames;
+		};
+
+		uint32_t m_queueFamily = ~0;
+		uint32_t m_frameCount = 0;
+		uint32_t m_frameIndex = 0;
+
+		// Thread slots, register once when one thread first allocate.
+		std::shared_mutex m_slotMutex;
+		std::unordered_map<std::thread::id, std::unique_ptr<ThreadSlot>> m_slots;
+
+	private:
+		ThreadSlot* getOrCreateThreadSlot();
+
+	public:
+		void init(uint32_t queueFamily, uint32_t frameCount);
+		void release();
+
+		// Reset all threads' pools of this frame, should call on main thread when frame's fence already signaled.
+		void beginFrame(uint32_t frameIndex);
+
+		// Allocate one primary command buffer from calling thread's pool of current frame.
+		// Command buffer keep valid until next beginFrame with same frame index.
+		VkCommandBuffer allocate();
+
+		uint32_t getFrameIndex() const { return m_frameIndex; }
+	};
+}
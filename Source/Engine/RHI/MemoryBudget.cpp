@@ -0,0 +1,409 @@
+#include "Pch.h"
+#include "MemoryBudget.h"
+#include "RHI.h"
+
+#include <vma/vk_mem_alloc.h>
+#include <deque>
+#include <random>
+
+namespace Flower
+{
+	static AutoCVarInt32 cVarMemoryBudgetEviction(
+		"r.MemoryBudget.Eviction",
+		"Enable evict cached gpu resources when over memory budget.",
+		"MemoryBudget",
+		1,
+		CVarFlags::ReadAndWrite
+	);
+
+	static AutoCVarFloat cVarMemoryBudgetScale(
+		"r.MemoryBudget.Scale",
+		"Fraction of device local heap budget engine can use.",
+		"MemoryBudget",
+		0.9f,
+		CVarFlags::ReadAndWrite
+	);
+
+	static AutoCVarCmd cVarMemoryBudgetValidate("cmd.MemoryBudget.Validate", "Drive memory budget split and eviction with mock heap budget, log result.");
+
+	const char* getMemoryBudgetCategoryName(EMemoryBudgetCategory category)
+	{
+		switch (category)
+		{
+		case EMemoryBudgetCategory::Texture: return "Texture";
+		case EMemoryBudgetCategory::Mesh: return "Mesh";
+		case EMemoryBudgetCategory::RenderTarget: return "RenderTarget";
+		case EMemoryBudgetCategory::Upload: return "Upload";
+		}
+		return "Unknown";
+	}
+
+	void VMAMemoryBudgetProvider::queryHeapBudgets(std::vector<MemoryHeapBudget>& outHeaps)
+	{
+		// Vma refresh VK_EXT_memory_budget value when frame index change.
+		static uint32_t frameIndex = 0;
+		vmaSetCurrentFrameIndex(RHI::VMA, ++frameIndex);
+
+		const VkPhysicalDeviceMemoryProperties* memoryProperties = nullptr;
+		vmaGetMemoryProperties(RHI::VMA, &memoryProperties);
+
+		std::vector<VmaBudget> budgets(memoryProperties->memoryHeapCount);
+		vmaGetHeapBudgets(RHI::VMA, budgets.data());
+
+		outHeaps.resize(memoryProperties->memoryHeapCount);
+		for (uint32_t i = 0; i < memoryProperties->memoryHeapCount; i++)
+		{
+			outHeaps[i].bDeviceLocal = (memoryProperties->memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) != 0;
+			outHeaps[i].usage = budgets[i].usage;
+			outHeaps[i].budget = budgets[i].budget;
+		}
+	}
+
+	void MemoryBudgetManager::registerConsumer(MemoryBudgetConsumer* consumer, EMemoryBudgetCategory category, uint32_t priority)
+	{
+		CHECK(consumer && category < EMemoryBudgetCategory::Max);
+		CHECK(std::find_if(m_consumers.begin(), m_consumers.end(), [consumer](const ConsumerInfo& info) { return info.consumer == consumer; }) == m_consumers.end());
+
+		m_consumers.push_back({ consumer, category, priority });
+	}
+
+	void MemoryBudgetManager::unregisterConsumer(MemoryBudgetConsumer* consumer)
+	{
+		std::erase_if(m_consumers, [consumer](const ConsumerInfo& info) { return info.consumer == consumer; });
+	}
+
+	MemoryBudgetManager::Config MemoryBudgetManager::buildRuntimeConfig()
+	{
+		Config config{};
+		config.bEviction = cVarMemoryBudgetEviction.get() != 0;
+		config.budgetScale = glm::clamp(cVarMemoryBudgetScale.get(), 0.1f, 1.0f);
+		config.minEvictAgeFrames = uint32_t(RHI::GMaxSwapchainCount) + 1;
+
+		return config;
+	}
+
+	void MemoryBudgetManager::tick()
+	{
+		CVarCmdHandle(cVarMemoryBudgetValidate, []()
+		{
+			MemoryBudgetManager::validate();
+		});
+
+		m_frame++;
+
+		if (!m_provider)
+		{
+			m_provider = std::make_unique<VMAMemoryBudgetProvider>();
+		}
+
+		updateBudgets();
+		evict();
+	}
+
+	void MemoryBudgetManager::updateBudgets()
+	{
+		m_provider->queryHeapBudgets(m_stats.heaps);
+
+		m_stats.deviceBudget = 0;
+		m_stats.deviceUsage = 0;
+		for (const auto& heap : m_stats.heaps)
+		{
+			if (heap.bDeviceLocal)
+			{
+				m_stats.deviceBudget += heap.budget;
+				m_stats.deviceUsage += heap.usage;
+			}
+		}
+		m_stats.engineBudget = uint64_t(double(m_stats.deviceBudget) * m_config.budgetScale);
+
+		for (auto& category : m_stats.categories)
+		{
+			category.usage = 0;
+		}
+
+		uint64_t trackedUsage = 0;
+		for (auto& info : m_consumers)
+		{
+			info.usage = info.consumer->getBudgetUsage();
+			m_stats.categories[size_t(info.category)].usage += info.usage;
+			trackedUsage += info.usage;
+		}
+
+		// Upload buffers mostly host visible, untracked usage is estimate only.
+		m_stats.untrackedUsage = m_stats.deviceUsage > trackedUsage ? m_stats.deviceUsage - trackedUsage : 0;
+		const uint64_t available = m_stats.engineBudget > m_stats.untrackedUsage ? m_stats.engineBudget - m_stats.untrackedUsage : 0;
+
+		float weightSum = 0.0f;
+		for (float weight : m_config.categoryWeights)
+		{
+			weightSum += weight;
+		}
+
+		std::array<uint32_t, size_t(EMemoryBudgetCategory::Max)> consumerCounts { };
+		for (const auto& info : m_consumers)
+		{
+			consumerCounts[size_t(info.category)]++;
+		}
+
+		for (size_t i = 0; i < m_stats.categories.size(); i++)
+		{
+			m_stats.categories[i].budget = weightSum > 0.0f ? uint64_t(double(available) * m_config.categoryWeights[i] / weightSum) : 0;
+		}
+
+		// No valid heap budget yet, keep consumer self capacity.
+		if (m_stats.deviceBudget == 0)
+		{
+			return;
+		}
+
+		for (const auto& info : m_consumers)
+		{
+			const size_t category = size_t(info.category);
+			info.consumer->onBudgetChange(m_stats.categories[category].budget / consumerCounts[category]);
+		}
+	}
+
+	void MemoryBudgetManager::evict()
+	{
+		for (auto& category : m_stats.categories)
+		{
+			category.evictCount = 0;
+			category.evictSize = 0;
+		}
+
+		if (!m_config.bEviction || m_stats.deviceBudget == 0)
+		{
+			return;
+		}
+
+		int64_t globalOver = int64_t(m_stats.deviceUsage) - int64_t(m_stats.engineBudget);
+
+		std::array<int64_t, size_t(EMemoryBudgetCategory::Max)> categoryOver;
+		for (size_t i = 0; i < categoryOver.size(); i++)
+		{
+			categoryOver[i] = int64_t(m_stats.categories[i].usage) - int64_t(m_stats.categories[i].budget);
+		}
+
+		// Over flags only decrease in loop, so evict order is stable by priority then last use frame.
+		for (uint32_t i = 0; i < m_config.maxEvictPerTick; i++)
+		{
+			ConsumerInfo* best = nullptr;
+			uint64_t bestFrame = 0;
+			uint64_t bestSize = 0;
+
+			for (auto& info : m_consumers)
+			{
+				if (globalOver <= 0 && categoryOver[size_t(info.category)] <= 0)
+				{
+					continue;
+				}
+
+				uint64_t lastUseFrame;
+				uint64_t size;
+				if (!info.consumer->getEvictCandidate(lastUseFrame, size))
+				{
+					continue;
+				}
+
+				// Gpu may still read recent used resource.
+				if (lastUseFrame + m_config.minEvictAgeFrames > m_frame)
+				{
+					continue;
+				}
+
+				if (!best || info.priority < best->priority || (info.priority == best->priority && lastUseFrame < bestFrame))
+				{
+					best = &info;
+					bestFrame = lastUseFrame;
+					bestSize = size;
+				}
+			}
+
+			if (!best)
+			{
+				break;
+			}
+
+			// Consumer candidate may change by other consumer query, query again before evict.
+			uint64_t lastUseFrame;
+			CHECK(best->consumer->getEvictCandidate(lastUseFrame, bestSize));
+			best->consumer->evictCandidate();
+
+			auto& category = m_stats.categories[size_t(best->category)];
+			category.evictCount++;
+			category.evictSize += bestSize;
+			category.usage -= glm::min(category.usage, bestSize);
+			best->usage -= glm::min(best->usage, bestSize);
+
+			globalOver -= int64_t(bestSize);
+			categoryOver[size_t(best->category)] -= int64_t(bestSize);
+		}
+	}
+
+	void MemoryBudgetManager::validate()
+	{
+		struct EvictRecord
+		{
+			uint32_t priority;
+			uint64_t frame;
+			uint64_t size;
+		};
+
+		class MockConsumer : public MemoryBudgetConsumer
+		{
+		public:
+			uint32_t priority;
+			std::vector<EvictRecord>* log;
+
+			// Sort by last use frame, front is oldest.
+			std::deque<std::pair<uint64_t, uint64_t>> items;
+			uint64_t budget = 0;
+
+			virtual uint64_t getBudgetUsage() override
+			{
+				uint64_t usage = 0;
+				for (const auto& item : items)
+				{
+					usage += item.second;
+				}
+				return usage;
+			}
+
+			virtual bool getEvictCandidate(uint64_t& outLastUseFrame, uint64_t& outSize) override
+			{
+				if (items.empty())
+				{
+					return false;
+				}
+
+				outLastUseFrame = items.front().first;
+				outSize = items.front().second;
+				return true;
+			}
+
+			virtual void evictCandidate() override
+			{
+				log->push_back({ priority, items.front().first, items.front().second });
+				items.pop_front();
+			}
+
+			virtual void onBudgetChange(uint64_t inBudget) override
+			{
+				budget = inBudget;
+			}
+		};
+
+		constexpr uint64_t kMB = 1024ull * 1024ull;
+
+		ValidateReport report("Memory budget");
+
+		std::mt19937 random(59);
+		std::uniform_int_distribution<uint32_t> countDist(0, 40);
+		std::uniform_int_distribution<uint32_t> sizeDist(1, 64);
+
+		const uint32_t kWarmupFrames = 100;
+		const uint64_t kRecentFrame = ~0ull >> 1;
+		for (uint32_t testCase = 0; testCase < 64; testCase++)
+		{
+			MemoryBudgetManager manager;
+
+			Config config{};
+			config.maxEvictPerTick = ~0u;
+			manager.setConfig(config);
+
+			auto provider = std::make_unique<MockMemoryBudgetProvider>();
+			auto* mockProvider = provider.get();
+			manager.setProvider(std::move(provider));
+
+			std::vector<EvictRecord> log;
+			std::vector<std::unique_ptr<MockConsumer>> consumers;
+
+			// Two consumer in texture category, check cross cache order by last use frame.
+			const std::vector<std::pair<EMemoryBudgetCategory, uint32_t>> consumerTypes =
+			{
+				{ EMemoryBudgetCategory::RenderTarget, 0 },
+				{ EMemoryBudgetCategory::Upload, 0 },
+				{ EMemoryBudgetCategory::Texture, 1 },
+				{ EMemoryBudgetCategory::Texture, 1 },
+				{ EMemoryBudgetCategory::Mesh, 2 },
+			};
+
+			uint64_t trackedUsage = 0;
+			for (const auto& type : consumerTypes)
+			{
+				auto consumer = std::make_unique<MockConsumer>();
+				consumer->priority = type.second;
+				consumer->log = &log;
+
+				// Tail items use in recent frames, must keep.
+				const uint32_t itemCount = countDist(random);
+				const uint32_t recentCount = itemCount / 5;
+				for (uint32_t i = 0; i < itemCount; i++)
+				{
+					const uint64_t frame = (i + recentCount < itemCount) ? 1 + kWarmupFrames / 2 * i / itemCount : kRecentFrame;
+					consumer->items.push_back({ frame, sizeDist(random) * kMB });
+				}
+
+				trackedUsage += consumer->getBudgetUsage();
+				manager.registerConsumer(consumer.get(), type.first, type.second);
+				consumers.push_back(std::move(consumer));
+			}
+
+			const uint64_t untracked = sizeDist(random) * 8 * kMB;
+			const uint64_t deviceBudget = (trackedUsage + untracked) * (50 + random() % 100) / 100;
+
+			MemoryHeapBudget deviceHeap{ .bDeviceLocal = true, .usage = trackedUsage + untracked, .budget = deviceBudget };
+			MemoryHeapBudget hostHeap{ .bDeviceLocal = false, .usage = 64 * kMB, .budget = 1024 * kMB };
+
+			// Warm up frame with huge budget, nothing evict.
+			mockProvider->heaps = { { true, deviceHeap.usage, deviceHeap.usage * 100 }, hostHeap };
+			for (uint32_t i = 0; i < kWarmupFrames; i++)
+			{
+				manager.tick();
+			}
+			report.expect(log.empty(), "no evict when under budget");
+
+			mockProvider->heaps = { deviceHeap, hostHeap };
+			manager.tick();
+
+			const auto& stats = manager.getStats();
+			report.expect(stats.untrackedUsage == untracked, "untracked usage");
+
+			// Budget split follow weights.
+			const uint64_t available = stats.engineBudget > untracked ? stats.engineBudget - untracked : 0;
+			uint64_t budgetSum = 0;
+			for (size_t i = 0; i < stats.categories.size(); i++)
+			{
+				budgetSum += stats.categories[i].budget;
+
+				const uint64_t expectBudget = uint64_t(double(available) * config.categoryWeights[i]);
+				report.expect(stats.categories[i].budget + kMB >= expectBudget && stats.categories[i].budget <= expectBudget + kMB, "category budget follow weight");
+			}
+			report.expect(budgetSum <= available, "category budget sum in available");
+			report.expect(consumers[2]->budget == stats.categories[size_t(EMemoryBudgetCategory::Texture)].budget / 2, "consumer share category budget");
+
+			// Evict order by priority then last use frame, recent frames never evict.
+			uint64_t evictSize = 0;
+			for (size_t i = 0; i < log.size(); i++)
+			{
+				if (i > 0)
+				{
+					const bool bOrder = log[i - 1].priority < log[i].priority ||
+						(log[i - 1].priority == log[i].priority && log[i - 1].frame <= log[i].frame);
+					report.expect(bOrder, "evict order");
+				}
+				report.expect(log[i].frame + config.minEvictAgeFrames <= manager.getFrame(), "recent use keep");
+				evictSize += log[i].size;
+			}
+
+			// Apply eviction to mock heap, next frame all over budget must be solved or blocked by recent use.
+			const size_t evictCount = log.size();
+			deviceHeap.usage -= evictSize;
+			mockProvider->heaps = { deviceHeap, hostHeap };
+			manager.tick();
+			report.expect(log.size() == evictCount, "over budget solved in one tick");
+		}
+
+		report.finish();
+	}
+}
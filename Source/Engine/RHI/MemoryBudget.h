@@ -0,0 +1,177 @@
+#pragma once
+#include "../Core/Core.h"
+
+#include <array>
+
+namespace Flower
+{
+	enum class EMemoryBudgetCategory : uint32_t
+	{
+		Texture = 0,
+		Mesh,
+		RenderTarget,
+		Upload,
+		Max
+	};
+
+	extern const char* getMemoryBudgetCategoryName(EMemoryBudgetCategory category);
+
+	struct MemoryHeapBudget
+	{
+		bool bDeviceLocal = false;
+
+		// Memory use by this process in heap.
+		uint64_t usage = 0;
+
+		// Memory this process can use in heap without oversubscribe.
+		uint64_t budget = 0;
+	};
+
+	// Heap budget source, vma with VK_EXT_memory_budget at runtime, mock one for validate.
+	class MemoryBudgetProvider
+	{
+	public:
+		virtual ~MemoryBudgetProvider() = default;
+		virtual void queryHeapBudgets(std::vector<MemoryHeapBudget>& outHeaps) = 0;
+	};
+
+	class VMAMemoryBudgetProvider : public MemoryBudgetProvider
+	{
+	public:
+		virtual void queryHeapBudgets(std::vector<MemoryHeapBudget>& outHeaps) override;
+	};
+
+	class MockMemoryBudgetProvider : public MemoryBudgetProvider
+	{
+	public:
+		std::vector<MemoryHeapBudget> heaps;
+
+		virtual void queryHeapBudgets(std::vector<MemoryHeapBudget>& outHeaps) override
+		{
+			outHeaps = heaps;
+		}
+	};
+
+	// Memory owner which budget manager can ask to release.
+	class MemoryBudgetConsumer
+	{
+	public:
+		virtual ~MemoryBudgetConsumer() = default;
+
+		// Memory size in bytes current hold.
+		virtual uint64_t getBudgetUsage() = 0;
+
+		// Least recently used item which free memory when evict, return false if no one.
+		virtual bool getEvictCandidate(uint64_t& outLastUseFrame, uint64_t& outSize) = 0;
+
+		// Evict candidate return by last getEvictCandidate.
+		virtual void evictCandidate() = 0;
+
+		// Budget of this consumer change, consumer with self capacity should follow it.
+		virtual void onBudgetChange(uint64_t budget) { }
+	};
+
+	// Central gpu memory budget, query heap budget every frame and split to categories.
+	// When over budget, evict across all consumers by priority first, then by last use frame.
+	class MemoryBudgetManager : NonCopyable
+	{
+	public:
+		struct CategoryStats
+		{
+			uint64_t budget = 0;
+			uint64_t usage = 0;
+
+			// Eviction of last tick.
+			uint32_t evictCount = 0;
+			uint64_t evictSize = 0;
+		};
+
+		struct Stats
+		{
+			std::vector<MemoryHeapBudget> heaps;
+
+			uint64_t deviceBudget = 0;
+			uint64_t deviceUsage = 0;
+
+			// Device budget scale down, engine never use over it.
+			uint64_t engineBudget = 0;
+
+			// Device usage no track by any consumer, swapchain, pipelines and raw allocation.
+			uint64_t untrackedUsage = 0;
+
+			std::array<CategoryStats, size_t(EMemoryBudgetCategory::Max)> categories;
+		};
+
+		struct Config
+		{
+			bool bEviction = true;
+
+			// Fraction of device local budget engine can use.
+			float budgetScale = 0.9f;
+
+			// Fraction of budget after untracked usage for each category.
+			std::array<float, size_t(EMemoryBudgetCategory::Max)> categoryWeights = { 0.55f, 0.2f, 0.2f, 0.05f };
+
+			// Item used in these frames never evict, gpu may still read it.
+			uint32_t minEvictAgeFrames = 4;
+
+			// Max evict count per tick, spread eviction to frames.
+			uint32_t maxEvictPerTick = 64;
+		};
+
+	private:
+		struct ConsumerInfo
+		{
+			MemoryBudgetConsumer* consumer;
+			EMemoryBudgetCategory category;
+
+			// Lower priority evict first.
+			uint32_t priority;
+
+			uint64_t usage = 0;
+		};
+
+		std::unique_ptr<MemoryBudgetProvider> m_provider;
+		std::vector<ConsumerInfo> m_consumers;
+
+		Config m_config { };
+		Stats m_stats { };
+
+		// Asset caches stamp last use frame from loader threads.
+		std::atomic<uint64_t> m_frame = 1;
+
+	private:
+		void updateBudgets();
+		void evict();
+
+	public:
+		MemoryBudgetManager() = default;
+
+		void setProvider(std::unique_ptr<MemoryBudgetProvider> provider) { m_provider = std::move(provider); }
+
+		void setConfig(const Config& config) { m_config = config; }
+		const Config& getConfig() const { return m_config; }
+
+		// Config from r.MemoryBudget cvars.
+		static Config buildRuntimeConfig();
+
+		void registerConsumer(MemoryBudgetConsumer* consumer, EMemoryBudgetCategory category, uint32_t priority);
+		void unregisterConsumer(MemoryBudgetConsumer* consumer);
+
+		// Tick once per frame, before frame allocation.
+		void tick();
+
+		uint64_t getFrame() const { return m_frame.load(); }
+		const Stats& getStats() const { return m_stats; }
+
+		uint64_t getCategoryBudget(EMemoryBudgetCategory category) const
+		{
+			return m_stats.categories[size_t(category)].budget;
+		}
+
+		// Drive budget split and eviction with mock heap provider and mock consumers, log result.
+		static void validate();
+	};
+
+	using MemoryBudget = Singleton<MemoryBudgetManager>;
+}
@@ -4,9 +4,10 @@
 
 namespace Flower
 {
-    void GPUTimestamps::init(uint32_t numberOfBackBuffers)
+    void GPUTimestamps::init(uint32_t numberOfBackBuffers, const std::string& trackName)
     {
         m_numberOfBackBuffers = numberOfBackBuffers;
+        m_trackName = trackName;
         m_frame = 0;
 
         const VkQueryPoolCreateInfo queryPoolCreateInfo =
@@ -61,6 +62,7 @@ namespace Flower
 
         // copy GPU timestamps
         uint32_t offset = m_frame * m_maxValuesPerFrame;
+        m_frameTotalMicroseconds = 0.0f;
 
         uint32_t measurements = (uint32_t)gpuLabels.size();
         if (measurements > 0)
@@ -100,6 +102,28 @@ namespace Flower
                     };
 
                     pTimestamps->push_back(ts);
+                    m_frameTotalMicroseconds = ts.microseconds;
+
+                    // Push to frame profiler, cpu/gpu clock no calibrate, so align gpu begin to record begin.
+                    // Offsets inside frame are exact, absolute start is approximate.
+                    if (GFrameProfiler::get()->isEnable() && m_recordBeginNs[m_frame] != 0)
+                    {
+                        std::vector<GPUProfileEvent> events;
+                        events.reserve(measurements - 1);
+
+                        const double nanosecondsPerTick = RHI::get()->getPhysicalDeviceProperties().limits.timestampPeriod;
+                        const uint64_t baseNs = m_recordBeginNs[m_frame];
+                        for (uint32_t i = 1; i < measurements; i++)
+                        {
+                            GPUProfileEvent event{};
+                            event.track = m_trackName;
+                            event.name = m_labels[m_frame][i];
+                            event.startNs = baseNs + uint64_t(nanosecondsPerTick * double(timingsInTicks[i - 1] - timingsInTicks[0]));
+                            event.endNs = baseNs + uint64_t(nanosecondsPerTick * double(timingsInTicks[i] - timingsInTicks[0]));
+                            events.push_back(std::move(event));
+                        }
+                        GFrameProfiler::get()->addGPUEvents(std::move(events));
+                    }
                 }
                 else
                 {
@@ -115,6 +139,7 @@ namespace Flower
         gpuLabels.clear();
 
         getTimeStamp(cmd, "Begin Frame");
+        m_recordBeginNs[m_frame] = GFrameProfiler::get()->now();
     }
 
     void GPUTimestamps::onEndFrame()
@@ -12,7 +12,8 @@ namespace Flower
     class GPUTimestamps
     {
     public:
-        void init(uint32_t numberOfBackBuffers);
+        // Track name use for frame profiler gpu timeline.
+        void init(uint32_t numberOfBackBuffers, const std::string& trackName = "GPU");
         void release();
 
         void getTimeStamp(VkCommandBuffer cmd, const char* label);
@@ -20,6 +21,9 @@ namespace Flower
         void onBeginFrame(VkCommandBuffer cmd, std::vector<TimeStamp>* pTimestamp);
         void onEndFrame();
 
+        // Total gpu time of frame read back in last onBeginFrame, zero when invalid.
+        float getFrameTotalMicroseconds() const { return m_frameTotalMicroseconds; }
+
     private:
         static const uint32_t m_maxValuesPerFrame = 128;
         VkQueryPool m_queryPool;
@@ -29,6 +33,41 @@ namespace Flower
 
         std::vector<std::string> m_labels[5];
         std::vector<TimeStamp> m_cpuTimeStamps[5];
+
+        // Profiler time when frame's "Begin Frame" recorded, gpu events align to it.
+        std::string m_trackName;
+        uint64_t m_recordBeginNs[5] = { };
+
+        float m_frameTotalMicroseconds = 0.0f;
+    };
+
+    // Measure cpu time of one scope and push it as user timestamp, used to profile pass record time.
+    class ScopeCPUTimeStamp : NonCopyable
+    {
+    public:
+        ScopeCPUTimeStamp(GPUTimestamps& timer, const char* label)
+            : m_timer(timer), m_label(label), m_startPoint(std::chrono::high_resolution_clock::now())
+#ifdef ENABLE_PROFILER
+            , m_profileScope(label)
+#endif
+        {
+
+        }
+
+        ~ScopeCPUTimeStamp()
+        {
+            const auto duration = std::chrono::high_resolution_clock::now() - m_startPoint;
+            m_timer.getTimeStampUser({ m_label, std::chrono::duration<float, std::micro>(duration).count() });
+        }
+
+    private:
+        GPUTimestamps& m_timer;
+        const char* m_label;
+        std::chrono::high_resolution_clock::time_point m_startPoint;
+
+#ifdef ENABLE_PROFILER
+        ScopeProfile m_profileScope;
+#endif
     };
 
     
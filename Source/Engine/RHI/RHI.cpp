@@ -6,8 +6,10 @@
 namespace Flower
 {
 	size_t RHI::GMaxSwapchainCount = ~0;
+	const size_t RHI::GHeadlessFrameCount = 3;
 
 	bool RHI::bSupportRayTrace = false;
+	bool RHI::bSupportPresentWait = false;
 
 	VkPhysicalDevice RHI::GPU    = VK_NULL_HANDLE;
 	VkDevice         RHI::Device = VK_NULL_HANDLE;
@@ -29,6 +31,14 @@ namespace Flower
 		return cVarVulkanOpenValidation.get() != 0;
 	}
 
+	static AutoCVarInt32 cVarMaxFramesInFlight(
+		"r.Present.MaxFramesInFlight",
+		"Max frame count cpu can record ahead of gpu, clamp to [1, swapchain image count], 0 use swapchain image count. Less frames less input latency but less cpu gpu overlap.",
+		"Present",
+		0,
+		CVarFlags::ReadAndWrite
+	);
+
 	static PFN_vkSetDebugUtilsObjectNameEXT GVkSetDebugUtilsObjectName = nullptr;
 	static PFN_vkCmdBeginDebugUtilsLabelEXT GVkCmdBeginDebugUtilsLabel = nullptr;
 	static PFN_vkCmdEndDebugUtilsLabelEXT   GVkCmdEndDebugUtilsLabel = nullptr;
@@ -42,6 +52,7 @@ namespace Flower
 
 	PFN_vkCmdPushDescriptorSetKHR RHI::PushDescriptorSetKHR = nullptr;
 	PFN_vkCmdPushDescriptorSetWithTemplateKHR RHI::PushDescriptorSetWithTemplateKHR = nullptr;
+	PFN_vkWaitForPresentKHR RHI::WaitForPresentKHR = nullptr;
 
 	// Functions for regular HDR ex: HDR10
 	RHI::DisplayMode RHI::eDisplayMode = RHI::DisplayMode::DISPLAYMODE_SDR;
@@ -79,6 +90,12 @@ namespace Flower
 
 		RHI::PushDescriptorSetWithTemplateKHR = (PFN_vkCmdPushDescriptorSetWithTemplateKHR)vkGetDeviceProcAddr(device, "vkCmdPushDescriptorSetWithTemplateKHR");
 
+		if (RHI::bSupportPresentWait)
+		{
+			RHI::WaitForPresentKHR = (PFN_vkWaitForPresentKHR)vkGetDeviceProcAddr(device, "vkWaitForPresentKHR");
+			RHI::bSupportPresentWait = (RHI::WaitForPresentKHR != nullptr);
+		}
+
 	}
 
 	void hdrInit()
@@ -452,8 +469,9 @@ namespace Flower
 
 		bool extensionsSupported = checkDeviceExtensionSupport(requestExtens, m_physicalDevice);
 
-		bool swapChainAdequate = false;
-		if (extensionsSupported)
+		// Headless mode no present, so don't care swapchain.
+		bool swapChainAdequate = m_bHeadless;
+		if (extensionsSupported && !m_bHeadless)
 		{
 			auto swapChainSupport = querySwapchainSupportDetail();
 			swapChainAdequate = !swapChainSupport.formats.empty() && !swapChainSupport.presentModes.empty();
@@ -518,8 +536,13 @@ namespace Flower
 			queueIndex++;
 		}
 
-		CHECK(graphicsQueueCounts > 2 && "We need more than one queue to do some async dispatch.");
-		CHECK(copyQueueCounts > 1 && "We need more than one queue to do some async dispatch.");
+		// Headless mode may run on software rasterizer which only expose one queue, alias queues when not enough.
+		if (!m_bHeadless)
+		{
+			CHECK(graphicsQueueCounts > 2 && "We need more than one queue to do some async dispatch.");
+			CHECK(copyQueueCounts > 1 && "We need more than one queue to do some async dispatch.");
+		}
+		CHECK(graphicsQueueCounts > 0 && "No graphics queue found.");
 
 		std::vector<VkDeviceQueueCreateInfo> queueCreateInfos;
 
@@ -601,6 +624,45 @@ namespace Flower
 		{
 			vkGetDeviceQueue(m_device, m_queues.copyFamily, id, &m_queues.copyQueues[id]);
 		}
+
+		if (m_bHeadless)
+		{
+			aliasMissingQueues();
+		}
+	}
+
+	void VulkanContext::aliasMissingQueues()
+	{
+		const VkQueue majorQueue = m_queues.graphcisQueues[0];
+		auto aliasQueues = [&](std::vector<VkQueue>& queues, uint32_t& family, size_t minCount)
+		{
+			if (queues.size() >= minCount)
+			{
+				return;
+			}
+
+			// Graphics family queue support compute and copy too.
+			if (queues.empty())
+			{
+				family = m_queues.graphicsFamily;
+			}
+
+			m_bQueueAliased = true;
+			while (queues.size() < minCount)
+			{
+				queues.push_back(family == m_queues.graphicsFamily ? majorQueue : queues[0]);
+			}
+		};
+
+		// Major queue + at least one async queue for graphics and compute, one copy queue.
+		aliasQueues(m_queues.graphcisQueues, m_queues.graphicsFamily, 2);
+		aliasQueues(m_queues.computeQueues, m_queues.computeFamily, 2);
+		aliasQueues(m_queues.copyQueues, m_queues.copyFamily, 1);
+
+		if (m_bQueueAliased)
+		{
+			LOG_RHI_WARN("Device queues not enough, some queues alias, submit will serialize by lock.");
+		}
 	}
 
 	VkFormat VulkanContext::findSupportedFormat(const std::vector<VkFormat>& candidates, VkImageTiling tiling, VkFormatFeatureFlags features)
@@ -666,10 +728,14 @@ namespace Flower
 			}
 		}
 
-		// Surface extensions.
-		enableExtensions.push_back(VK_KHR_SURFACE_EXTENSION_NAME);
+		// Surface extensions, headless mode no surface.
+		if (!m_bHeadless)
+		{
+			enableExtensions.push_back(VK_KHR_SURFACE_EXTENSION_NAME);
+		}
 
 		// GLFW extensions.
+		if (!m_bHeadless)
 		{
 			uint32_t glfwExtensionCount = 0;
 			const char** glfwExtensions;
@@ -837,8 +903,47 @@ namespace Flower
 			vkGetPhysicalDeviceProperties2KHR(m_physicalDevice, &deviceProperties);
 		}
 
+		// Present id and present wait are optional, only enable when gpu support.
+		std::vector<const char*> enableExtens = requestExtens;
+		VkPhysicalDevicePresentIdFeaturesKHR presentIdFeatures{ .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR };
+		VkPhysicalDevicePresentWaitFeaturesKHR presentWaitFeatures{ .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR };
+		if (!m_bHeadless)
+		{
+			uint32_t extensionCount;
+			vkEnumerateDeviceExtensionProperties(m_physicalDevice, nullptr, &extensionCount, nullptr);
+			std::vector<VkExtensionProperties> availableExtensions(extensionCount);
+			vkEnumerateDeviceExtensionProperties(m_physicalDevice, nullptr, &extensionCount, availableExtensions.data());
+
+			auto existExtension = [&](const char* name)
+			{
+				return std::any_of(availableExtensions.begin(), availableExtensions.end(), 
+					[&](const VkExtensionProperties& p) { return strcmp(p.extensionName, name) == 0; });
+			};
+
+			if (existExtension(VK_KHR_PRESENT_ID_EXTENSION_NAME) && existExtension(VK_KHR_PRESENT_WAIT_EXTENSION_NAME))
+			{
+				presentWaitFeatures.pNext = &presentIdFeatures;
+
+				VkPhysicalDeviceFeatures2 features2{ .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2, .pNext = &presentWaitFeatures };
+				vkGetPhysicalDeviceFeatures2(m_physicalDevice, &features2);
+
+				RHI::bSupportPresentWait = presentIdFeatures.presentId && presentWaitFeatures.presentWait;
+			}
+
+			if (RHI::bSupportPresentWait)
+			{
+				enableExtens.push_back(VK_KHR_PRESENT_ID_EXTENSION_NAME);
+				enableExtens.push_back(VK_KHR_PRESENT_WAIT_EXTENSION_NAME);
+
+				// Query result already set feature true, append before user chain.
+				presentIdFeatures.pNext = nextChain;
+				nextChain = &presentWaitFeatures;
+			}
+			LOG_RHI_INFO("Present wait {0}.", RHI::bSupportPresentWait ? "support" : "no support");
+		}
+
 		// Build logic device.
-		createLogicDevice(features, nextChain, requestExtens);
+		createLogicDevice(features, nextChain, enableExtens);
 
 		// Cache some support format.
 		m_cacheSupportDepthOnlyFormat = findSupportedFormat(
@@ -901,6 +1006,13 @@ namespace Flower
 	{
 		m_window = window;
 
+		// No window meaning headless mode, render offscreen without surface and swapchain.
+		m_bHeadless = (window == nullptr);
+		if (m_bHeadless)
+		{
+			LOG_RHI_INFO("Init vulkan context in headless mode.");
+		}
+
 		// Init instance.
 		{
 			std::vector<const char*> instanceExtensionNames{ };
@@ -914,7 +1026,7 @@ namespace Flower
 		}
 
 		// Init surface.
-		if (glfwCreateWindowSurface(m_instance, window, nullptr, &m_surface) != VK_SUCCESS)
+		if (!m_bHeadless && glfwCreateWindowSurface(m_instance, window, nullptr, &m_surface) != VK_SUCCESS)
 		{
 			LOG_RHI_FATAL("Window surface create error.");
 		}
@@ -936,6 +1048,21 @@ namespace Flower
 			deviceExtensionNames.push_back(VK_KHR_RAY_QUERY_EXTENSION_NAME);
 			deviceExtensionNames.push_back(VK_KHR_RAY_TRACING_PIPELINE_EXTENSION_NAME);
 			
+			// Headless mode no present, and software rasterizer don't support ray trace, remove them.
+			if (m_bHeadless)
+			{
+				const std::set<std::string> headlessUnused =
+				{
+					VK_KHR_SWAPCHAIN_EXTENSION_NAME,
+					VK_EXT_HDR_METADATA_EXTENSION_NAME,
+					VK_KHR_DEFERRED_HOST_OPERATIONS_EXTENSION_NAME,
+					VK_KHR_ACCELERATION_STRUCTURE_EXTENSION_NAME,
+					VK_KHR_RAY_QUERY_EXTENSION_NAME,
+					VK_KHR_RAY_TRACING_PIPELINE_EXTENSION_NAME,
+				};
+
+				std::erase_if(deviceExtensionNames, [&](const char* name) { return headlessUnused.contains(name); });
+			}
 
 
 			// Current only nvidia support Meshshader, so we don't use it, we simulate by compute shader.
@@ -950,6 +1077,7 @@ namespace Flower
 			enable10GpuFeatures.samplerAnisotropy = true;
 			enable10GpuFeatures.depthClamp = true;
 			enable10GpuFeatures.shaderSampledImageArrayDynamicIndexing = true;
+			enable10GpuFeatures.shaderStorageImageArrayDynamicIndexing = true;
 			enable10GpuFeatures.multiDrawIndirect = VK_TRUE;
 			enable10GpuFeatures.drawIndirectFirstInstance = VK_TRUE;
 			enable10GpuFeatures.independentBlend = VK_TRUE;
@@ -1030,11 +1158,11 @@ namespace Flower
 			};
 
 			//
-			RHI::bSupportHDR =
+			RHI::bSupportHDR = !m_bHeadless &&
 				existInstanceExtension(VK_KHR_GET_SURFACE_CAPABILITIES_2_EXTENSION_NAME) &&
 				existDeviceExtension(VK_EXT_HDR_METADATA_EXTENSION_NAME);
 
-			RHI::bSupportRayTrace =
+			RHI::bSupportRayTrace = !m_bHeadless &&
 				existDeviceExtension(VK_KHR_DEFERRED_HOST_OPERATIONS_EXTENSION_NAME) &&
 				existDeviceExtension(VK_KHR_ACCELERATION_STRUCTURE_EXTENSION_NAME) &&
 				existDeviceExtension(VK_KHR_RAY_QUERY_EXTENSION_NAME) &&
@@ -1059,12 +1187,20 @@ namespace Flower
 		m_descriptorAllocator.init();
 		m_descriptorLayoutCache.init();
 
-		// Init hdr info before swapchin build.
-		hdrInit();
+		if (m_bHeadless)
+		{
+			// No swapchain, flighting frame count same with renderer backbuffer count.
+			RHI::GMaxSwapchainCount = RHI::GHeadlessFrameCount;
+		}
+		else
+		{
+			// Init hdr info before swapchin build.
+			hdrInit();
 
-		// Init swapchain.
-		m_swapchain.init();
-		RHI::GMaxSwapchainCount = m_swapchain.getImageViews().size();
+			// Init swapchain.
+			m_swapchain.init();
+			RHI::GMaxSwapchainCount = m_swapchain.getImageViews().size();
+		}
 
 		m_presentContext.init();
 
@@ -1089,7 +1225,10 @@ namespace Flower
 		m_presentContext.release();
 
 		// release swapchain.
-		m_swapchain.release();
+		if (!m_bHeadless)
+		{
+			m_swapchain.release();
+		}
 
 		// release descriptor cache.
 		m_descriptorAllocator.release();
@@ -1106,7 +1245,10 @@ namespace Flower
 		releaseDevice();
 
 		// release surface.
-		vkDestroySurfaceKHR(m_instance, m_surface, nullptr);
+		if (m_surface != VK_NULL_HANDLE)
+		{
+			vkDestroySurfaceKHR(m_instance, m_surface, nullptr);
+		}
 
 		// release instance.
 		releaseInstance();
@@ -1118,6 +1260,10 @@ namespace Flower
 		allocatorInfo.physicalDevice = m_physicalDevice;
 		allocatorInfo.device = m_device;
 		allocatorInfo.instance = m_instance;
+
+		// Device already enable VK_EXT_memory_budget, memory budget manager query heap budget from vma.
+		allocatorInfo.vulkanApiVersion = VK_API_VERSION_1_1;
+		allocatorInfo.flags = VMA_ALLOCATOR_CREATE_EXT_MEMORY_BUDGET_BIT;
 		vmaCreateAllocator(&allocatorInfo, &m_vmaAllocator);
 	}
 
@@ -1181,10 +1327,15 @@ namespace Flower
 				index++;
 			}
 		}
+
+		// Thread command pools, one pool per flighting frame for each thread.
+		m_threadGraphicsPools.init(m_queues.graphicsFamily, uint32_t(RHI::GMaxSwapchainCount));
 	}
 
 	void VulkanContext::releaseCommandPool()
 	{
+		m_threadGraphicsPools.release();
+
 		// Destroy major command pool.
 		vkDestroyCommandPool(m_device, m_majorGraphicsPool.pool, nullptr);
 		vkDestroyCommandPool(m_device, m_majorComputePool.pool, nullptr);
@@ -1220,6 +1371,11 @@ namespace Flower
 
 	void VulkanContext::recreateSwapChain()
 	{
+		if (m_bHeadless)
+		{
+			return;
+		}
+
 		vkDeviceWaitIdle(m_device);
 
 		static int width = 0, height = 0;
@@ -1243,6 +1399,7 @@ namespace Flower
 		m_presentContext.init();
 
 		m_presentContext.imagesInFlight.resize(m_swapchain.getImageViews().size(), VK_NULL_HANDLE);
+		m_presentContext.swapchainFirstPresentId = m_presentContext.presentId + 1;
 
 		// Recreate special
 		onAfterSwapchainRecreate.broadcast();
@@ -1250,9 +1407,23 @@ namespace Flower
 
 	uint32_t VulkanContext::acquireNextPresentImage()
 	{
-		m_presentContext.bSwapchainChange |= swapchainRebuild();
+		// Wait frame submit max flighting frames ago, and self slot's fence before reuse its resources.
+		{
+			const size_t currentFrame = m_presentContext.currentFrame;
+			const size_t limitFrame = (currentFrame + RHI::GMaxSwapchainCount - getMaxFramesInFlight()) % RHI::GMaxSwapchainCount;
 
-		vkWaitForFences(m_device, 1, &m_presentContext.inFlightFences[m_presentContext.currentFrame], VK_TRUE, UINT64_MAX);
+			const VkFence fences[2] = { m_presentContext.inFlightFences[limitFrame], m_presentContext.inFlightFences[currentFrame] };
+			vkWaitForFences(m_device, limitFrame == currentFrame ? 1 : 2, fences, VK_TRUE, UINT64_MAX);
+		}
+
+		if (m_bHeadless)
+		{
+			// No swapchain image, just use frame index as image index.
+			m_presentContext.imageIndex = m_presentContext.currentFrame;
+			return m_presentContext.imageIndex;
+		}
+
+		m_presentContext.bSwapchainChange |= swapchainRebuild();
 
 		VkResult result = vkAcquireNextImageKHR(
 			m_device, 
@@ -1284,6 +1455,12 @@ namespace Flower
 
 	void VulkanContext::present()
 	{
+		if (m_bHeadless)
+		{
+			m_presentContext.currentFrame = (m_presentContext.currentFrame + 1) % RHI::GMaxSwapchainCount;
+			return;
+		}
+
 		VkPresentInfoKHR presentInfo{};
 		presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
 
@@ -1296,6 +1473,17 @@ namespace Flower
 		presentInfo.pSwapchains = swapchains;
 		presentInfo.pImageIndices = &m_presentContext.imageIndex;
 
+		// Tag each present with increase id, frame pacer wait it show on screen.
+		VkPresentIdKHR presentIdInfo{ .sType = VK_STRUCTURE_TYPE_PRESENT_ID_KHR };
+		if (RHI::bSupportPresentWait)
+		{
+			m_presentContext.presentId++;
+
+			presentIdInfo.swapchainCount = 1;
+			presentIdInfo.pPresentIds = &m_presentContext.presentId;
+			presentInfo.pNext = &presentIdInfo;
+		}
+
 		auto result = vkQueuePresentKHR(m_majorGraphicsPool.queue, &presentInfo);
 		if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR || m_presentContext.bSwapchainChange)
 		{
@@ -1311,14 +1499,54 @@ namespace Flower
 		m_presentContext.currentFrame = (m_presentContext.currentFrame + 1) % RHI::GMaxSwapchainCount;
 	}
 
+	uint32_t VulkanContext::getMaxFramesInFlight() const
+	{
+		// Default keep all swapchain frames in flight, same as before frame pacing.
+		if (cVarMaxFramesInFlight.get() <= 0)
+		{
+			return (uint32_t)RHI::GMaxSwapchainCount;
+		}
+		return (uint32_t)glm::clamp(cVarMaxFramesInFlight.get(), 1, (int32_t)RHI::GMaxSwapchainCount);
+	}
+
+	bool VulkanContext::waitForPresent(uint64_t presentId, uint64_t timeout)
+	{
+		if (m_bHeadless || !RHI::bSupportPresentWait || presentId < m_presentContext.swapchainFirstPresentId)
+		{
+			return false;
+		}
+
+		return RHI::WaitForPresentKHR(m_device, m_swapchain.get(), presentId, timeout) == VK_SUCCESS;
+	}
+
 	void VulkanContext::submit(uint32_t count, VkSubmitInfo* infos)
 	{
-		RHICheck(vkQueueSubmit(m_majorGraphicsPool.queue, count, infos, m_presentContext.inFlightFences[m_presentContext.currentFrame]));
+		RHICheck(queueSubmit(m_majorGraphicsPool.queue, count, infos, m_presentContext.inFlightFences[m_presentContext.currentFrame]));
 	}
 
 	void VulkanContext::submitNoFence(uint32_t count, VkSubmitInfo* infos)
 	{
-		RHICheck(vkQueueSubmit(m_majorGraphicsPool.queue, count, infos, nullptr));
+		RHICheck(queueSubmit(m_majorGraphicsPool.queue, count, infos, nullptr));
+	}
+
+	VkResult VulkanContext::queueSubmit(VkQueue queue, uint32_t count, const VkSubmitInfo* infos, VkFence fence)
+	{
+		if (m_bQueueAliased)
+		{
+			std::lock_guard lock(m_queueMutex);
+			return vkQueueSubmit(queue, count, infos, fence);
+		}
+		return vkQueueSubmit(queue, count, infos, fence);
+	}
+
+	VkResult VulkanContext::queueWaitIdle(VkQueue queue)
+	{
+		if (m_bQueueAliased)
+		{
+			std::lock_guard lock(m_queueMutex);
+			return vkQueueWaitIdle(queue);
+		}
+		return vkQueueWaitIdle(queue);
 	}
 
 	void VulkanContext::resetFence()
@@ -1417,8 +1645,8 @@ namespace Flower
 		submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
 		submitInfo.commandBufferCount = 1;
 		submitInfo.pCommandBuffers = &commandBuffer;
-		vkQueueSubmit(queue, 1, &submitInfo, VK_NULL_HANDLE);
-		vkQueueWaitIdle(queue);
+		RHI::get()->queueSubmit(queue, 1, &submitInfo, VK_NULL_HANDLE);
+		RHI::get()->queueWaitIdle(queue);
 		vkFreeCommandBuffers(RHI::Device, commandPool, 1, &commandBuffer);
 	}
 
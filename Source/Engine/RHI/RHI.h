@@ -18,6 +18,7 @@ namespace Flower
 		void pickupSuitableGpu(const std::vector<const char*>& requestExtens);
 		bool isPhysicalDeviceSuitable(const std::vector<const char*>& requestExtens);
 		void createLogicDevice(VkPhysicalDeviceFeatures features, void* nextChain, const std::vector<const char*>& requestExtens);
+		void aliasMissingQueues();
 
 	public:
 		SwapchainSupportDetails querySwapchainSupportDetail();
@@ -28,6 +29,13 @@ namespace Flower
 		GLFWwindow* m_window;
 		VkSurfaceKHR m_surface = VK_NULL_HANDLE;
 
+		// Headless mode: no window, no surface and no swapchain.
+		bool m_bHeadless = false;
+
+		// When device queues not enough, some queue handles alias, submit need lock.
+		bool m_bQueueAliased = false;
+		std::mutex m_queueMutex;
+
 		VkInstance m_instance = VK_NULL_HANDLE;
 		VkDebugUtilsMessengerEXT m_debugUtilsHandle = VK_NULL_HANDLE;
 		VkDebugReportCallbackEXT m_debugReportHandle = VK_NULL_HANDLE;
@@ -60,6 +68,12 @@ namespace Flower
 			std::vector<VkFence> inFlightFences;
 			std::vector<VkFence> imagesInFlight;
 
+			// Last present id tag, keep increase across swapchain rebuild.
+			uint64_t presentId = 0;
+
+			// First present id of current swapchain, older id never finish on it.
+			uint64_t swapchainFirstPresentId = 1;
+
 			void init();
 			void release();
 		} m_presentContext;
@@ -77,6 +91,9 @@ namespace Flower
 		std::vector<GPUCommandPool> m_computePools;
 		std::vector<GPUCommandPool> m_copyPools;
 
+		// Per-thread per-frame graphics command pools, used for parallel command recording.
+		ThreadCommandPools m_threadGraphicsPools;
+
 	private:
 		void initInstance(const std::vector<const char*>& requiredExtensions, const std::vector<const char*>& requiredLayers);
 		void releaseInstance();
@@ -92,6 +109,7 @@ namespace Flower
 
 	public:
 		GLFWwindow* getWindow() { return m_window; }
+		bool isHeadless() const { return m_bHeadless; }
 		VkSurfaceKHR getSurface() const { return m_surface; };
 
 		VkFormat getSupportDepthStencilFormat() const { return m_cacheSupportDepthStencilFormat; }
@@ -99,6 +117,7 @@ namespace Flower
 
 		uint32_t getMaxMemoryAllocationCount() const { return m_physicalDeviceProperties.limits.maxMemoryAllocationCount; }
 	public:
+		// Pass nullptr window to init headless context.
 		void init(GLFWwindow* window);
 		void release();
 		void recreateSwapChain();
@@ -114,10 +133,23 @@ namespace Flower
 	public:
 		uint32_t acquireNextPresentImage();
 		void present();
+
+		// Flighting frame count limit by r.Present.MaxFramesInFlight, default and max is swapchain count.
+		uint32_t getMaxFramesInFlight() const;
+
+		// Last present id, zero when present wait no support.
+		uint64_t getLastPresentId() const { return m_presentContext.presentId; }
+
+		// Wait present id show on screen, return false when no support, timeout or id invalid.
+		bool waitForPresent(uint64_t presentId, uint64_t timeout);
 		void submit(uint32_t count, VkSubmitInfo* infos);
 		void submitNoFence(uint32_t count, VkSubmitInfo* infos);
 		void resetFence();
 
+		// Thread safe queue submit, all submit should use these functions.
+		VkResult queueSubmit(VkQueue queue, uint32_t count, const VkSubmitInfo* infos, VkFence fence);
+		VkResult queueWaitIdle(VkQueue queue);
+
 		MulticastDelegate<> onBeforeSwapchainRecreate;
 		MulticastDelegate<> onAfterSwapchainRecreate;
 
@@ -136,6 +168,9 @@ namespace Flower
 		const auto& getAsyncComputeCommandPools() const { return m_computePools; }
 		const auto& getAsyncGraphicsCommandPools() const { return m_graphicsPools; }
 
+		// Graphics family command pools owned by each recording thread, submit to major graphics queue.
+		ThreadCommandPools& getThreadGraphicsCommandPools() { return m_threadGraphicsPools; }
+
 		VkInstance getInstance() const { return m_instance; }
 		VkPhysicalDeviceDescriptorIndexingPropertiesEXT getPhysicalDeviceDescriptorIndexingProperties() const { return m_descriptorIndexingProperties; }
 
@@ -169,6 +204,9 @@ namespace Flower
 	{
 		extern size_t GMaxSwapchainCount;
 
+		// Flighting frame count when headless.
+		extern const size_t GHeadlessFrameCount;
+
 		extern VkPhysicalDevice GPU;
 		extern VkDevice Device;
 		extern SamplerCache* SamplerManager;
@@ -190,6 +228,9 @@ namespace Flower
 
 		extern bool bSupportRayTrace;
 
+		// VK_KHR_present_id and VK_KHR_present_wait.
+		extern bool bSupportPresentWait;
+
 		inline constexpr auto get = []() { return Singleton<VulkanContext>::get(); };
 
 		extern void setResourceName(VkObjectType objectType, uint64_t handle, const char* name);
@@ -231,5 +272,7 @@ namespace Flower
 		extern PFN_vkGetPhysicalDeviceSurfaceFormats2KHR      GetPhysicalDeviceSurfaceFormats2KHR;
 		extern PFN_vkSetHdrMetadataEXT                        SetHdrMetadataEXT;
 
+		extern PFN_vkWaitForPresentKHR WaitForPresentKHR;
+
 	};
 }
\ No newline at end of file
@@ -4,6 +4,14 @@
 
 namespace Flower
 {
+	static AutoCVarInt32 cVarPresentMode(
+		"r.Present.Mode",
+		"Swapchain present mode, 0 is auto (mailbox, immediate then fifo), 1 is fifo (vsync), 2 is mailbox, 3 is immediate. Fallback to fifo when not support.",
+		"Present",
+		0,
+		CVarFlags::ReadAndWrite
+	);
+
 	VkSurfaceFormatKHR Swapchain::chooseSwapSurfaceFormat(const std::vector<VkSurfaceFormatKHR>& availableFormats)
 	{
 		switch (RHI::eDisplayMode)
@@ -50,25 +58,58 @@ namespace Flower
 
 	VkPresentModeKHR Swapchain::chooseSwapPresentMode(const std::vector<VkPresentModeKHR>& availablePresentModes)
 	{
-		for (const auto& availablePresentMode : availablePresentModes)
+		auto isSupport = [&](VkPresentModeKHR mode)
+		{
+			return std::find(availablePresentModes.begin(), availablePresentModes.end(), mode) != availablePresentModes.end();
+		};
+
+		switch (cVarPresentMode.get())
+		{
+		case 1:
+		{
+			// Fifo always support.
+			return VK_PRESENT_MODE_FIFO_KHR;
+		}
+		case 2:
 		{
-			if (availablePresentMode == VK_PRESENT_MODE_MAILBOX_KHR)
+			if (isSupport(VK_PRESENT_MODE_MAILBOX_KHR))
 			{
-				return availablePresentMode;
+				return VK_PRESENT_MODE_MAILBOX_KHR;
 			}
+			LOG_RHI_WARN("Mailbox present mode no support, fallback to fifo.");
+			return VK_PRESENT_MODE_FIFO_KHR;
 		}
-
-		for (const auto& availablePresentMode : availablePresentModes)
+		case 3:
 		{
-			if (availablePresentMode == VK_PRESENT_MODE_IMMEDIATE_KHR)
+			if (isSupport(VK_PRESENT_MODE_IMMEDIATE_KHR))
 			{
-				return availablePresentMode;
+				return VK_PRESENT_MODE_IMMEDIATE_KHR;
 			}
+			LOG_RHI_WARN("Immediate present mode no support, fallback to fifo.");
+			return VK_PRESENT_MODE_FIFO_KHR;
+		}
+		default:
+			break;
+		}
+
+		if (isSupport(VK_PRESENT_MODE_MAILBOX_KHR))
+		{
+			return VK_PRESENT_MODE_MAILBOX_KHR;
+		}
+
+		if (isSupport(VK_PRESENT_MODE_IMMEDIATE_KHR))
+		{
+			return VK_PRESENT_MODE_IMMEDIATE_KHR;
 		}
 
 		return VK_PRESENT_MODE_FIFO_KHR;
 	}
 
+	bool Swapchain::isPresentModeDirty() const
+	{
+		return m_presentModeGeneration != cVarPresentMode.getGeneration();
+	}
+
 	VkExtent2D Swapchain::chooseSwapchainExtent(const VkSurfaceCapabilitiesKHR& capabilities)
 	{
 		if (capabilities.currentExtent.width != UINT32_MAX)
@@ -102,6 +143,7 @@ namespace Flower
 		auto swapchain_support = RHI::get()->querySwapchainSupportDetail();
 
 		VkSurfaceFormatKHR surfaceFormat = chooseSwapSurfaceFormat(swapchain_support.formats);
+		m_presentModeGeneration = cVarPresentMode.getGeneration();
 		VkPresentModeKHR presentMode = chooseSwapPresentMode(swapchain_support.presentModes);
 		VkExtent2D extent = chooseSwapchainExtent(swapchain_support.capabilities);
 		uint32_t imageCount = swapchain_support.capabilities.minImageCount + 1;
@@ -139,6 +181,7 @@ namespace Flower
 
 		m_swapchainImageFormat = surfaceFormat.format;
 		m_swapchainExtent = extent;
+		m_presentMode = presentMode;
 
 		// create image views need for swapchain.
 		m_swapchainImageViews.resize(m_swapchainImages.size());
@@ -162,7 +205,7 @@ namespace Flower
 			RHICheck(vkCreateImageView(RHI::Device, &createInfo, nullptr, &m_swapchainImageViews[i]));
 		}
 
-		LOG_RHI_TRACE("Create vulkan swapChain succeed, backBuffer count is {0}. ", m_swapchainImageViews.size());
+		LOG_RHI_TRACE("Create vulkan swapChain succeed, backBuffer count is {0}, present mode is {1}.", m_swapchainImageViews.size(), (int32_t)m_presentMode);
 	}
 
 	void Swapchain::rebuild()
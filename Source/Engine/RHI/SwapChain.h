@@ -11,6 +11,10 @@ namespace Flower
 		VkFormat m_swapchainImageFormat = {};
 		VkExtent2D m_swapchainExtent = {};
 		VkSwapchainKHR m_swapchain = {};
+		VkPresentModeKHR m_presentMode = VK_PRESENT_MODE_FIFO_KHR;
+
+		// Present mode cvar generation when build, differ meaning need rebuild.
+		uint32_t m_presentModeGeneration = 0;
 
 	private:
 		VkSurfaceFormatKHR chooseSwapSurfaceFormat(const std::vector<VkSurfaceFormatKHR>& availableFormats);
@@ -27,6 +31,9 @@ namespace Flower
 
 		inline auto getExtent() const { return m_swapchainExtent; }
 		inline auto getImageFormat() const { return m_swapchainImageFormat; }
+		inline auto getPresentMode() const { return m_presentMode; }
+
+		bool isPresentModeDirty() const;
 
 	public:
 		void init();
@@ -81,6 +81,24 @@ namespace Flower
 		m_tickCount++;
 	}
 
+	uint64_t BufferParametersRing::BufferParametersManager::getMemorySize() const
+	{
+		// Busy pool keep stale entry in unused position, which still own buffer, so count unique buffers.
+		std::unordered_set<const BufferParameter*> buffers;
+		uint64_t size = 0;
+		for (const auto& pool : { &m_busyPool, &m_freePool, &m_unsortFreePool })
+		{
+			for (const auto& misc : *pool)
+			{
+				if (misc.buffer && buffers.insert(misc.buffer.get()).second)
+				{
+					size += misc.buffer->getBuffer()->getSize();
+				}
+			}
+		}
+		return size;
+	}
+
 	std::shared_ptr<BufferParametersRing::BufferParametersManager::BufferParamHandle> BufferParametersRing::BufferParametersManager::getParameter(const char* name, size_t bufferSize)
 	{
 		bool bShouldReuse = m_freePool.size() > 0;
@@ -219,6 +237,19 @@ namespace Flower
 		}
 	}
 
+	uint64_t BufferParametersRing::getBudgetUsage()
+	{
+		uint64_t usage = 0;
+		for (const auto& pair : m_managersMap)
+		{
+			for (const auto& manager : pair.second)
+			{
+				usage += manager->getMemorySize();
+			}
+		}
+		return usage;
+	}
+
 	BufferParamRefPointer BufferParametersRing::getParameter(
 		bool bMultiFrame,
 		const char* name, 
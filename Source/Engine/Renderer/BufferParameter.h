@@ -1,11 +1,13 @@
 #pragma once
 #include "RendererCommon.h"
+#include "../RHI/MemoryBudget.h"
 
 namespace Flower
 {
 	// Some buffer parameter need update by cpu, which need multi-buffer for 3-backbuffer swaphchain.
 
-	class BufferParametersRing : NonCopyable
+	// Ring only report memory usage to budget, free buffers release in few frames so nothing to evict.
+	class BufferParametersRing : public MemoryBudgetConsumer, NonCopyable
 	{
 	public:
 		class BufferParameter : NonCopyable
@@ -107,6 +109,9 @@ namespace Flower
 
 			void tick();
 
+			// Memory size of all buffers hold by pools.
+			uint64_t getMemorySize() const;
+
 			bool isMultiFrame() const
 			{
 				return m_bMultiFrame;
@@ -151,9 +156,23 @@ namespace Flower
 		explicit BufferParametersRing()
 			: m_index(0)
 		{
+			MemoryBudget::get()->registerConsumer(this, EMemoryBudgetCategory::Upload, 0);
+		}
+
+		virtual ~BufferParametersRing()
+		{
+			MemoryBudget::get()->unregisterConsumer(this);
+		}
+
+		virtual uint64_t getBudgetUsage() override;
 
+		virtual bool getEvictCandidate(uint64_t& outLastUseFrame, uint64_t& outSize) override
+		{
+			return false;
 		}
 
+		virtual void evictCandidate() override { }
+
 		void tick();
 		std::shared_ptr<BufferParametersManager::BufferParamHandle> getParameter(
 			bool bMultiFrame,
@@ -0,0 +1,341 @@
+#include "Pch.h"
+#include "CachedShadowCascade.h"
+
+namespace Flower
+{
+	namespace CachedShadowCascade
+	{
+		// Same with logCascadeSplit in SDSM_PrepareCascade.glsl, but return linear depth.
+		static float logCascadeSplit(float nearPlane, float farPlane, float lambda, uint32_t cascadeId, uint32_t cascadeCount)
+		{
+			const float p = float(cascadeId + 1) / float(cascadeCount);
+
+			const float logScale = nearPlane * glm::pow(farPlane / nearPlane, p);
+			const float uniformScale = nearPlane + (farPlane - nearPlane) * p;
+
+			return lambda * (logScale - uniformScale) + uniformScale;
+		}
+
+		static void buildFrustumPlanes(const glm::mat4& viewProj, glm::vec4 outPlanes[6])
+		{
+			const glm::mat4 reverseToWorld = glm::inverse(viewProj);
+
+			glm::vec3 p[8] =
+			{
+				glm::vec3(-1.0f,  1.0f, 1.0f),
+				glm::vec3( 1.0f,  1.0f, 1.0f),
+				glm::vec3( 1.0f, -1.0f, 1.0f),
+				glm::vec3(-1.0f, -1.0f, 1.0f),
+				glm::vec3(-1.0f,  1.0f, 0.0f),
+				glm::vec3( 1.0f,  1.0f, 0.0f),
+				glm::vec3( 1.0f, -1.0f, 0.0f),
+				glm::vec3(-1.0f, -1.0f, 0.0f),
+			};
+
+			for (uint32_t i = 0; i < 8; i++)
+			{
+				const glm::vec4 invCorner = reverseToWorld * glm::vec4(p[i], 1.0f);
+				p[i] = glm::vec3(invCorner) / invCorner.w;
+			}
+
+			auto buildPlane = [](const glm::vec3& a, const glm::vec3& b, const glm::vec3& origin)
+			{
+				const glm::vec3 n = glm::normalize(glm::cross(a, b));
+				return glm::vec4(n, -glm::dot(n, origin));
+			};
+
+			outPlanes[0] = buildPlane(p[4] - p[7], p[3] - p[7], p[7]); // left
+			outPlanes[1] = buildPlane(p[6] - p[2], p[3] - p[2], p[2]); // down
+			outPlanes[2] = buildPlane(p[6] - p[5], p[1] - p[5], p[5]); // right
+			outPlanes[3] = buildPlane(p[5] - p[4], p[0] - p[4], p[4]); // top
+			outPlanes[4] = buildPlane(p[1] - p[0], p[3] - p[0], p[0]); // front
+			outPlanes[5] = buildPlane(p[5] - p[6], p[7] - p[6], p[6]); // back
+		}
+
+		std::vector<CascadeFit> fitCascades(const GPUViewData& view, const GPUDirectionalLightInfo& light)
+		{
+			CHECK(light.cascadeCount > 0 && light.cascadeCount <= GMaxCascadePerDirectionalLight);
+			CHECK(light.perCascadeXYDim > 0);
+
+			const float tanHalfFovy = glm::tan(view.camInfo.x * 0.5f);
+			const float tanHalfFovx = tanHalfFovy * view.camInfo.y;
+			const float nearZ = view.camInfo.z;
+			const float farZ = glm::min(view.camInfo.w, nearZ + light.maxDrawDistance);
+
+			const glm::vec3 lightDir = glm::normalize(light.direction);
+			const glm::vec3 upDir = glm::abs(lightDir.y) > 0.999f ? glm::vec3(0.0f, 0.0f, 1.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+
+			// Light space rotation, light direction is -z.
+			const glm::mat4 lightView = glm::lookAtRH(glm::vec3(0.0f), lightDir, upDir);
+
+			std::vector<CascadeFit> cascades(light.cascadeCount);
+
+			float prevSplit = nearZ;
+			for (uint32_t cascadeId = 0; cascadeId < light.cascadeCount; cascadeId++)
+			{
+				const float splitDist = logCascadeSplit(nearZ, farZ, light.splitLambda, cascadeId, light.cascadeCount);
+
+				// View frustum slice bounding sphere, center on view axis so radius no change when camera rotate.
+				const glm::vec3 centerVS = glm::vec3(0.0f, 0.0f, -(prevSplit + splitDist) * 0.5f);
+				float radius = glm::length(glm::vec3(splitDist * tanHalfFovx, splitDist * tanHalfFovy, (splitDist - prevSplit) * 0.5f));
+				radius = glm::ceil(radius * 16.0f) / 16.0f;
+				prevSplit = splitDist;
+
+				const glm::vec3 centerWS = glm::vec3(view.camInvertView * glm::vec4(centerVS, 1.0f));
+				const glm::vec3 centerLS = glm::vec3(lightView * glm::vec4(centerWS, 1.0f));
+
+				// Snap center to texel in xy, and to depth step in z.
+				const float texelSize = 2.0f * radius / float(light.perCascadeXYDim);
+				const float depthStep = radius * kDepthSnapScale;
+
+				auto& cascade = cascades[cascadeId];
+				cascade.key.lightDirection = lightDir;
+				cascade.key.dim = light.perCascadeXYDim;
+				cascade.key.radius = radius;
+				cascade.key.shadowBiasConst = light.shadowBiasConst;
+				cascade.key.shadowBiasSlope = light.shadowBiasSlope;
+				cascade.key.staticHash = 0;
+				cascade.key.center = glm::ivec3(
+					int32_t(glm::floor(centerLS.x / texelSize)),
+					int32_t(glm::floor(centerLS.y / texelSize)),
+					int32_t(glm::round(centerLS.z / depthStep)));
+
+				const glm::vec3 snapCenter = glm::vec3(
+					float(cascade.key.center.x) * texelSize,
+					float(cascade.key.center.y) * texelSize,
+					float(cascade.key.center.z) * depthStep);
+
+				// Depth extend one step cover snap error.
+				const float depthRadius = radius + depthStep;
+
+				const glm::mat4 shadowView = glm::translate(glm::mat4(1.0f), -glm::vec3(snapCenter.x, snapCenter.y, snapCenter.z + depthRadius)) * lightView;
+				const glm::mat4 shadowProj = glm::orthoRH_ZO(-radius, radius, -radius, radius, 2.0f * depthRadius, 0.0f); // Also reverse z for shadow depth.
+
+				cascade.info.viewProj = shadowProj * shadowView;
+				buildFrustumPlanes(cascade.info.viewProj, cascade.info.frustumPlanes);
+			}
+
+			// All cascade share same rotation, so scale relative to coarse cascade is radius ratio.
+			const float coarseRadius = cascades.back().key.radius;
+			for (auto& cascade : cascades)
+			{
+				const float scale = coarseRadius / cascade.key.radius;
+				cascade.info.cascadeScale = glm::vec4(scale, scale, 0.0f, 0.0f);
+			}
+
+			return cascades;
+		}
+
+		CascadeUpdate getUpdate(const CascadeKey& cached, const CascadeKey& current)
+		{
+			const bool bSameContent =
+				cached.lightDirection == current.lightDirection &&
+				cached.dim == current.dim &&
+				cached.radius == current.radius &&
+				cached.shadowBiasConst == current.shadowBiasConst &&
+				cached.shadowBiasSlope == current.shadowBiasSlope &&
+				cached.staticHash == current.staticHash &&
+				cached.center.z == current.center.z;
+
+			if (!bSameContent)
+			{
+				return { EUpdateType::Redraw, glm::ivec2(0) };
+			}
+
+			// Light space y up, atlas row down.
+			const glm::ivec2 offset = glm::ivec2(current.center.x - cached.center.x, cached.center.y - current.center.y);
+			if (offset == glm::ivec2(0))
+			{
+				return { EUpdateType::Reuse, offset };
+			}
+
+			const int32_t maxScroll = int32_t(current.dim / 2);
+			if (glm::abs(offset.x) < maxScroll && glm::abs(offset.y) < maxScroll)
+			{
+				return { EUpdateType::Scroll, offset };
+			}
+
+			return { EUpdateType::Redraw, glm::ivec2(0) };
+		}
+
+		uint32_t getScrollExposeRects(uint32_t dim, const glm::ivec2& offset, VkRect2D outRects[2])
+		{
+			uint32_t rectCount = 0;
+			if (offset.x != 0)
+			{
+				const uint32_t width = uint32_t(glm::abs(offset.x));
+				outRects[rectCount].offset = { offset.x > 0 ? int32_t(dim - width) : 0, 0 };
+				outRects[rectCount].extent = { width, dim };
+				rectCount++;
+			}
+			if (offset.y != 0)
+			{
+				const uint32_t height = uint32_t(glm::abs(offset.y));
+				outRects[rectCount].offset = { 0, offset.y > 0 ? int32_t(dim - height) : 0 };
+				outRects[rectCount].extent = { dim, height };
+				rectCount++;
+			}
+			return rectCount;
+		}
+	
+		bool validate()
+		{
+			ValidateReport report("CachedShadowCascade");
+
+			constexpr uint32_t kDim = 2048;
+
+			GPUDirectionalLightInfo light{};
+			light.direction = glm::normalize(glm::vec3(0.3f, -1.0f, 0.2f));
+			light.cascadeCount = 4;
+			light.perCascadeXYDim = kDim;
+			light.splitLambda = 0.9f;
+			light.maxDrawDistance = 200.0f;
+			light.shadowBiasConst = -1.25f;
+			light.shadowBiasSlope = -1.75f;
+
+			auto buildView = [](const glm::vec3& position, const glm::vec3& forward)
+			{
+				GPUViewData view{};
+				view.camInfo = glm::vec4(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 10000.0f);
+				view.camInvertView = glm::inverse(glm::lookAtRH(position, position + forward, glm::vec3(0.0f, 1.0f, 0.0f)));
+				return view;
+			};
+
+			// Same projection with atlas texel, y down.
+			auto toTexel = [](const GPUCascadeInfo& info, const glm::vec3& position)
+			{
+				glm::vec4 ndc = info.viewProj * glm::vec4(position, 1.0f);
+				ndc /= ndc.w;
+				return glm::vec3((ndc.x * 0.5f + 0.5f) * float(kDim), (1.0f - ndc.y) * 0.5f * float(kDim), ndc.z);
+			};
+
+			std::mt19937 rng(1234u);
+			std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+			auto randomVec3 = [&]() { return glm::vec3(unit(rng), unit(rng), unit(rng)); };
+
+			glm::vec3 position = glm::vec3(10.0f, 5.0f, 3.0f);
+			glm::vec3 forward = glm::vec3(1.0f, 0.0f, 0.0f);
+
+			// Still camera always hit cache.
+			{
+				const auto a = fitCascades(buildView(position, forward), light);
+				const auto b = fitCascades(buildView(position, forward), light);
+				for (size_t i = 0; i < a.size(); i++)
+				{
+					report.expect(getUpdate(a[i].key, b[i].key).type == EUpdateType::Reuse, "still camera no reuse");
+				}
+			}
+
+			// Camera walk, reuse and scroll must map every world point to same cached texel and depth.
+			uint32_t reuseCount = 0;
+			uint32_t scrollCount = 0;
+			uint32_t redrawCount = 0;
+			auto cached = fitCascades(buildView(position, forward), light);
+			for (uint32_t step = 0; step < 2000; step++)
+			{
+				forward = glm::normalize(forward + randomVec3() * 0.01f);
+
+				// Rotation only must keep cascade size, bounding sphere center on view axis.
+				const auto rotated = fitCascades(buildView(position, forward), light);
+				for (size_t i = 0; i < rotated.size(); i++)
+				{
+					report.expect(rotated[i].key.radius == cached[i].key.radius, "camera rotation change cascade radius");
+				}
+
+				position += randomVec3() * 0.1f;
+				const auto current = fitCascades(buildView(position, forward), light);
+				for (size_t i = 0; i < current.size(); i++)
+				{
+					const auto update = getUpdate(cached[i].key, current[i].key);
+					switch (update.type)
+					{
+					case EUpdateType::Reuse:  reuseCount++;  break;
+					case EUpdateType::Scroll: scrollCount++; break;
+					case EUpdateType::Redraw: redrawCount++; continue;
+					}
+
+					for (uint32_t sample = 0; sample < 16; sample++)
+					{
+						const glm::vec3 point = position + randomVec3() * glm::vec3(50.0f, 5.0f, 50.0f);
+						const glm::vec3 texel = toTexel(current[i].info, point);
+						const glm::vec3 cachedTexel = toTexel(cached[i].info, point);
+
+						report.expect(glm::abs(texel.x + float(update.offset.x) - cachedTexel.x) < 0.05f
+							&& glm::abs(texel.y + float(update.offset.y) - cachedTexel.y) < 0.05f, "scroll offset reproject to wrong texel");
+						report.expect(glm::abs(texel.z - cachedTexel.z) < 1e-4f, "cached depth change without redraw");
+					}
+				}
+				cached = current;
+			}
+			report.expect(reuseCount > 0 && scrollCount > 0, "camera walk never hit cache");
+
+			// Any content change must invalidate.
+			{
+				const auto base = fitCascades(buildView(position, forward), light);
+				const CascadeKey& key = base[0].key;
+				auto expectRedraw = [&](CascadeKey changed, const char* what)
+				{
+					report.expect(getUpdate(key, changed).type == EUpdateType::Redraw, what);
+				};
+
+				CascadeKey changed = key;
+				changed.staticHash = key.staticHash + 1;
+				expectRedraw(changed, "static scene change no redraw");
+
+				GPUDirectionalLightInfo rotatedLight = light;
+				rotatedLight.direction = glm::normalize(light.direction + glm::vec3(0.001f, 0.0f, 0.0f));
+				expectRedraw(fitCascades(buildView(position, forward), rotatedLight)[0].key, "light direction change no redraw");
+
+				GPUDirectionalLightInfo biasLight = light;
+				biasLight.shadowBiasSlope = light.shadowBiasSlope * 2.0f;
+				expectRedraw(fitCascades(buildView(position, forward), biasLight)[0].key, "shadow bias change no redraw");
+
+				GPUDirectionalLightInfo dimLight = light;
+				dimLight.perCascadeXYDim = kDim / 2;
+				expectRedraw(fitCascades(buildView(position, forward), dimLight)[0].key, "cascade dim change no redraw");
+
+				changed = key;
+				changed.center.x += int32_t(kDim / 2);
+				expectRedraw(changed, "half cascade move no redraw");
+
+				changed = key;
+				changed.center.z += 1;
+				expectRedraw(changed, "depth range move no redraw");
+			}
+
+			// Expose rects cover exactly new texels no in cached cascade.
+			{
+				constexpr uint32_t kRectDim = 64;
+				for (uint32_t i = 0; i < 64; i++)
+				{
+					const glm::ivec2 offset = glm::ivec2(int32_t(rng() % kRectDim) - int32_t(kRectDim / 2), int32_t(rng() % kRectDim) - int32_t(kRectDim / 2));
+
+					VkRect2D rects[2];
+					const uint32_t rectCount = getScrollExposeRects(kRectDim, offset, rects);
+
+					bool bMatch = true;
+					for (int32_t y = 0; y < int32_t(kRectDim); y++)
+					{
+						for (int32_t x = 0; x < int32_t(kRectDim); x++)
+						{
+							const glm::ivec2 cachedTexel = glm::ivec2(x, y) + offset;
+							const bool bExpose = glm::any(glm::lessThan(cachedTexel, glm::ivec2(0))) || glm::any(glm::greaterThanEqual(cachedTexel, glm::ivec2(kRectDim)));
+
+							bool bInRect = false;
+							for (uint32_t r = 0; r < rectCount; r++)
+							{
+								bInRect |= x >= rects[r].offset.x && x < rects[r].offset.x + int32_t(rects[r].extent.width)
+									&& y >= rects[r].offset.y && y < rects[r].offset.y + int32_t(rects[r].extent.height);
+							}
+							bMatch &= (bExpose == bInRect);
+						}
+					}
+					report.expect(bMatch, "scroll expose rects mismatch");
+				}
+			}
+
+			LOG_INFO("CachedShadowCascade validate: camera walk {0} reused, {1} scrolled, {2} redrawn.", reuseCount, scrollCount, redrawCount);
+			return report.finish();
+		}
+	}
+}
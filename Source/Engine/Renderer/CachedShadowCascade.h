@@ -0,0 +1,67 @@
+#pragma once
+#include "Parameters.h"
+
+namespace Flower
+{
+	// Stable directional light cascades for cached shadow depth.
+	// Sdsm fit cascades on gpu from scene depth range, they change every frame so depth can't be reused.
+	// Here fit cascades from whole shadow draw range on cpu and snap them to light space grid,
+	// cascade only change when light, camera projection or camera position change enough.
+	//
+	// Matrix layout same with SDSM_PrepareCascade.glsl: reverse z ortho, atlas row 0 is light space top.
+	namespace CachedShadowCascade
+	{
+		// Depth snap step relative to cascade radius, depth range extend by this step on both side.
+		constexpr float kDepthSnapScale = 0.25f;
+
+		struct CascadeKey
+		{
+			glm::vec3 lightDirection;
+			uint32_t dim;
+
+			// Cascade half extent xy in light space.
+			float radius;
+			float shadowBiasConst;
+			float shadowBiasSlope;
+
+			// Static scene content hash.
+			size_t staticHash;
+
+			// Light space center, xy in texel unit, z in depth snap step unit.
+			glm::ivec3 center;
+		};
+
+		struct CascadeFit
+		{
+			CascadeKey key;
+			GPUCascadeInfo info;
+		};
+
+		// Cascade count read from light info, static hash fill by caller.
+		std::vector<CascadeFit> fitCascades(const GPUViewData& view, const GPUDirectionalLightInfo& light);
+
+		enum class EUpdateType
+		{
+			Reuse = 0,
+			Scroll,
+			Redraw,
+		};
+
+		struct CascadeUpdate
+		{
+			EUpdateType type;
+
+			// Atlas texel offset, new cascade texel (x, y) store at cached cascade texel (x + offset.x, y + offset.y).
+			glm::ivec2 offset;
+		};
+
+		// Only scroll when offset small than half cascade dim, large move redraw whole cascade.
+		CascadeUpdate getUpdate(const CascadeKey& cached, const CascadeKey& current);
+
+		// Scissor rects inside cascade which scroll expose, return rect count.
+		uint32_t getScrollExposeRects(uint32_t dim, const glm::ivec2& offset, VkRect2D outRects[2]);
+
+		// Camera walk and key change check cache hit, scroll reprojection, invalidation and expose rects on cpu.
+		bool validate();
+	}
+}
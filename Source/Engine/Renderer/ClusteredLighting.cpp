@@ -0,0 +1,158 @@
+#include "Pch.h"
+#include "ClusteredLighting.h"
+
+namespace Flower
+{
+	namespace ClusteredLighting
+	{
+		GPUClusterGrid buildGrid(uint32_t width, uint32_t height, float zNear, float zFar, float zCameraFar)
+		{
+			CHECK(width > 0 && height > 0);
+			CHECK(zNear > 0.0f);
+
+			GPUClusterGrid grid{};
+			grid.tileSize = kTileSize;
+			grid.dimX = getGroupCount(width, kTileSize);
+			grid.dimY = getGroupCount(height, kTileSize);
+			grid.dimZ = kSliceCount;
+			grid.zNear = zNear;
+			grid.zCameraFar = glm::max(zCameraFar, zNear * 1.01f);
+			grid.zFar = glm::clamp(zFar, zNear * 1.01f, grid.zCameraFar);
+			grid.maxLightsPerCluster = kMaxLightsPerCluster;
+			grid.width = width;
+			grid.height = height;
+
+			return grid;
+		}
+
+		uint32_t getSlice(const GPUClusterGrid& grid, float linearDepth)
+		{
+			const float slice = glm::log(glm::max(linearDepth, grid.zNear) / grid.zNear) / glm::log(grid.zFar / grid.zNear) * float(grid.dimZ);
+			return glm::min(uint32_t(slice), grid.dimZ - 1);
+		}
+
+		float getSliceDepth(const GPUClusterGrid& grid, uint32_t slice)
+		{
+			if (slice >= grid.dimZ)
+			{
+				return grid.zCameraFar;
+			}
+			return grid.zNear * glm::pow(grid.zFar / grid.zNear, float(slice) / float(grid.dimZ));
+		}
+
+		void getClusterAABB(
+			const GPUClusterGrid& grid,
+			const glm::mat4& invertProj,
+			uint32_t x,
+			uint32_t y,
+			uint32_t z,
+			glm::vec3& outMin,
+			glm::vec3& outMax)
+		{
+			const glm::vec2 uvMin = glm::vec2(x * grid.tileSize, y * grid.tileSize) / glm::vec2(grid.width, grid.height);
+			const glm::vec2 uvMax = glm::min(glm::vec2((x + 1) * grid.tileSize, (y + 1) * grid.tileSize) / glm::vec2(grid.width, grid.height), glm::vec2(1.0f));
+
+			const float depthBegin = getSliceDepth(grid, z);
+			const float depthEnd = getSliceDepth(grid, z + 1);
+
+			outMin = glm::vec3( std::numeric_limits<float>::max());
+			outMax = glm::vec3(-std::numeric_limits<float>::max());
+			for (uint32_t i = 0; i < 4; i++)
+			{
+				const glm::vec2 uv = glm::vec2((i & 1) ? uvMax.x : uvMin.x, (i & 2) ? uvMax.y : uvMin.y);
+
+				// Reverse z, device z 1 is near plane. Same as constructPos in Common.glsl.
+				glm::vec4 posNear = invertProj * glm::vec4(uv.x * 2.0f - 1.0f, 1.0f - uv.y * 2.0f, 1.0f, 1.0f);
+				const glm::vec3 ray = glm::vec3(posNear) / posNear.w;
+
+				// Ray scale to linear depth 1.
+				const glm::vec3 rayUnit = ray / -ray.z;
+				for (float depth : { depthBegin, depthEnd })
+				{
+					const glm::vec3 pos = rayUnit * depth;
+					outMin = glm::min(outMin, pos);
+					outMax = glm::max(outMax, pos);
+				}
+			}
+		}
+
+		bool sphereIntersectAABB(const glm::vec3& center, float radius, const glm::vec3& aabbMin, const glm::vec3& aabbMax)
+		{
+			const glm::vec3 closest = glm::clamp(center, aabbMin, aabbMax);
+			const glm::vec3 d = closest - center;
+			return glm::dot(d, d) <= radius * radius;
+		}
+
+		glm::vec4 getSpotBoundingSphere(const glm::vec3& position, const glm::vec3& direction, float range, float outerConeAngle)
+		{
+			// Wide cone bound its cap disc, narrow cone use circumscribed sphere of apex and cap.
+			const float cosAngle = glm::cos(outerConeAngle);
+			if (outerConeAngle > glm::quarter_pi<float>())
+			{
+				return glm::vec4(position + direction * (range * cosAngle), range * glm::sin(outerConeAngle));
+			}
+
+			const float radius = range / (2.0f * cosAngle);
+			return glm::vec4(position + direction * radius, radius);
+		}
+
+		LightLists assignLights(
+			const GPUClusterGrid& grid,
+			const glm::mat4& view,
+			const glm::mat4& invertProj,
+			const std::vector<GPULocalLightInfo>& lights)
+		{
+			const uint32_t clusterCount = getClusterCount(grid);
+
+			LightLists result{};
+			result.counts.resize(clusterCount, 0);
+			result.indices.resize(size_t(clusterCount) * grid.maxLightsPerCluster, 0);
+
+			std::vector<glm::vec4> viewSpheres(lights.size());
+			for (size_t i = 0; i < lights.size(); i++)
+			{
+				const glm::vec4& sphere = lights[i].boundingSphere;
+				viewSpheres[i] = glm::vec4(glm::vec3(view * glm::vec4(glm::vec3(sphere), 1.0f)), sphere.w);
+			}
+
+			for (uint32_t z = 0; z < grid.dimZ; z++)
+			{
+				for (uint32_t y = 0; y < grid.dimY; y++)
+				{
+					for (uint32_t x = 0; x < grid.dimX; x++)
+					{
+						glm::vec3 aabbMin, aabbMax;
+						getClusterAABB(grid, invertProj, x, y, z, aabbMin, aabbMax);
+
+						const uint32_t clusterIndex = getClusterIndex(grid, x, y, z);
+						uint32_t* clusterIndices = &result.indices[size_t(clusterIndex) * grid.maxLightsPerCluster];
+
+						uint32_t count = 0;
+						bool bOverflow = false;
+						for (uint32_t i = 0; i < uint32_t(viewSpheres.size()); i++)
+						{
+							if (!sphereIntersectAABB(glm::vec3(viewSpheres[i]), viewSpheres[i].w, aabbMin, aabbMax))
+							{
+								continue;
+							}
+
+							if (count < grid.maxLightsPerCluster)
+							{
+								clusterIndices[count++] = i;
+							}
+							else
+							{
+								bOverflow = true;
+							}
+						}
+
+						result.counts[clusterIndex] = count;
+						result.overflowCount += bOverflow ? 1 : 0;
+					}
+				}
+			}
+
+			return result;
+		}
+	}
+}
\ No newline at end of file
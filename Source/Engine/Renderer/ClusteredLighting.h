@@ -0,0 +1,68 @@
+#pragma once
+#include "Parameters.h"
+
+namespace Flower
+{
+	// Froxel cluster grid for local lights.
+	// Screen split into tileSize pixel tiles, linear view depth split into dimZ exponential slices in [zNear, zFar],
+	// last slice extend to camera far so pixels behind zFar still find their lights.
+	//
+	// Cpu side is reference of ClusteredLightCulling.glsl, keep math sync with ClusteredLightCommon.glsl.
+	namespace ClusteredLighting
+	{
+		constexpr uint32_t kTileSize = 64;
+		constexpr uint32_t kSliceCount = 32;
+		constexpr uint32_t kMaxLightsPerCluster = 128;
+
+		GPUClusterGrid buildGrid(uint32_t width, uint32_t height, float zNear, float zFar, float zCameraFar);
+
+		inline uint32_t getClusterCount(const GPUClusterGrid& grid)
+		{
+			return grid.dimX * grid.dimY * grid.dimZ;
+		}
+
+		inline uint32_t getClusterIndex(const GPUClusterGrid& grid, uint32_t x, uint32_t y, uint32_t z)
+		{
+			return x + grid.dimX * (y + grid.dimY * z);
+		}
+
+		// Linear depth is view space z mul -1.
+		uint32_t getSlice(const GPUClusterGrid& grid, float linearDepth);
+
+		// Linear depth where slice begin, slice dimZ return camera far.
+		float getSliceDepth(const GPUClusterGrid& grid, uint32_t slice);
+
+		// View space aabb of one cluster, tile origin at screen top left.
+		void getClusterAABB(
+			const GPUClusterGrid& grid,
+			const glm::mat4& invertProj,
+			uint32_t x,
+			uint32_t y,
+			uint32_t z,
+			glm::vec3& outMin,
+			glm::vec3& outMax);
+
+		bool sphereIntersectAABB(const glm::vec3& center, float radius, const glm::vec3& aabbMin, const glm::vec3& aabbMax);
+
+		// Tight sphere of spot light cone, .w is radius.
+		glm::vec4 getSpotBoundingSphere(const glm::vec3& position, const glm::vec3& direction, float range, float outerConeAngle);
+
+		struct LightLists
+		{
+			// Per cluster light count, clamp to max lights per cluster.
+			std::vector<uint32_t> counts;
+
+			// Max lights per cluster slots for each cluster, light index ascending.
+			std::vector<uint32_t> indices;
+
+			// Cluster count which lights more than slots.
+			uint32_t overflowCount = 0;
+		};
+
+		LightLists assignLights(
+			const GPUClusterGrid& grid,
+			const glm::mat4& view,
+			const glm::mat4& invertProj,
+			const std::vector<GPULocalLightInfo>& lights);
+	}
+}
\ No newline at end of file
@@ -20,8 +20,8 @@ namespace Flower
 		m_fsr2->onCreateWindowSizeDependentResources(
 			nullptr,
 			getDisplayOutput().getView(buildBasicImageSubresource()),
-			m_renderWidth,
-			m_renderHeight,
+			m_maxRenderWidth,
+			m_maxRenderHeight,
 			m_displayWidth,
 			m_displayHeight,
 			true);
@@ -147,6 +147,10 @@ namespace Flower
 			frame.directionalLight = importanceLights.directionalLights;
 		}
 
+		const auto& localLights = renderScene->getLocalLights();
+		frame.pointLightCount = localLights.pointLightCount;
+		frame.spotLightCount = localLights.spotLightCount;
+
 		frame.basicTextureLODBias = m_fsr2->config.lodTextureBasicBias;
 
 
@@ -175,39 +179,98 @@ namespace Flower
 
 		SceneTextures sceneTexures(this);
 
+		// Every pass scope record cpu time, push to timestamps with "CPU " prefix.
 		{
-			auto blueNoiseMisc = renderBlueNoiseMisc(graphicsCmd, renderer, &sceneTexures, renderScene, viewDataGPU, frameDataGPU, tickData);
+			BlueNoiseMisc blueNoiseMisc;
+			{
+				ScopeCPUTimeStamp cpuTimer(m_gpuTimer, "CPU BlueNoise");
+				blueNoiseMisc = renderBlueNoiseMisc(graphicsCmd, renderer, &sceneTexures, renderScene, viewDataGPU, frameDataGPU, tickData);
+			}
 
 			// Render static mesh Gbuffer.
-			renderStaticMeshGBuffer(graphicsCmd, renderer, &sceneTexures, renderScene, viewDataGPU, frameDataGPU);
+			{
+				ScopeCPUTimeStamp cpuTimer(m_gpuTimer, "CPU GBuffer");
+				renderStaticMeshGBuffer(graphicsCmd, renderer, &sceneTexures, renderScene, viewDataGPU, frameDataGPU);
+			}
+
+			// Render landscape Gbuffer after static mesh, load static mesh result.
+			{
+				ScopeCPUTimeStamp cpuTimer(m_gpuTimer, "CPU Landscape");
+				renderLandscape(graphicsCmd, renderer, &sceneTexures, renderScene, viewDataGPU, frameDataGPU);
+			}
 
 			// When set SDSM after GTAO render, the shadow will flickering, i don't know why, i check all barrier but seems normal.
 			// Current make sdsm before GTAO and hiz.
-			renderSDSM(graphicsCmd, renderer, &sceneTexures, renderScene, viewDataGPU, frameDataGPU);
-
-			auto hizTex = renderHiZ(graphicsCmd, renderer, &sceneTexures, renderScene, viewDataGPU, frameDataGPU);
-			auto GTAOTex = renderGTAO(graphicsCmd, renderer, &sceneTexures, renderScene, viewDataGPU, frameDataGPU, hizTex, blueNoiseMisc);
+			{
+				ScopeCPUTimeStamp cpuTimer(m_gpuTimer, "CPU SDSM");
+				renderSDSM(graphicsCmd, renderer, &sceneTexures, renderScene, viewDataGPU, frameDataGPU);
+			}
+
+			PoolImageSharedRef hizTex;
+			{
+				ScopeCPUTimeStamp cpuTimer(m_gpuTimer, "CPU HiZ");
+				hizTex = renderHiZ(graphicsCmd, renderer, &sceneTexures, renderScene, viewDataGPU, frameDataGPU);
+			}
+
+			PoolImageSharedRef GTAOTex;
+			{
+				ScopeCPUTimeStamp cpuTimer(m_gpuTimer, "CPU GTAO");
+				GTAOTex = renderGTAO(graphicsCmd, renderer, &sceneTexures, renderScene, viewDataGPU, frameDataGPU, hizTex, blueNoiseMisc);
+			}
 
 			// Prepare sky lut.
-			renderAtmosphere(graphicsCmd, renderer, &sceneTexures, renderScene, viewDataGPU, frameDataGPU, false);
-			renderBasicLighting(graphicsCmd, renderer, &sceneTexures, renderScene, viewDataGPU, frameDataGPU, GTAOTex);
+			{
+				ScopeCPUTimeStamp cpuTimer(m_gpuTimer, "CPU AtmosphereLut");
+				renderAtmosphere(graphicsCmd, renderer, &sceneTexures, renderScene, viewDataGPU, frameDataGPU, false);
+			}
+
+			ClusteredLightLists clusteredLights;
+			{
+				ScopeCPUTimeStamp cpuTimer(m_gpuTimer, "CPU ClusteredLightCulling");
+				clusteredLights = renderClusteredLightCulling(graphicsCmd, renderer, &sceneTexures, renderScene, viewDataGPU, frameDataGPU);
+			}
+
+			{
+				ScopeCPUTimeStamp cpuTimer(m_gpuTimer, "CPU BasicLighting");
+				renderBasicLighting(graphicsCmd, renderer, &sceneTexures, renderScene, viewDataGPU, frameDataGPU, GTAOTex, clusteredLights);
+			}
 			
-			renderSSR(graphicsCmd, renderer, &sceneTexures, renderScene, viewDataGPU, frameDataGPU, hizTex, GTAOTex, blueNoiseMisc);
+			{
+				ScopeCPUTimeStamp cpuTimer(m_gpuTimer, "CPU SSR");
+				renderSSR(graphicsCmd, renderer, &sceneTexures, renderScene, viewDataGPU, frameDataGPU, hizTex, GTAOTex, blueNoiseMisc);
+			}
 
 			// Composite sky.
-			renderAtmosphere(graphicsCmd, renderer, &sceneTexures, renderScene, viewDataGPU, frameDataGPU, true);
-
-			// renderVolumetricCloud(graphicsCmd, renderer, &sceneTexures, renderScene, viewDataGPU, frameDataGPU);
-
-			renderFSR2(graphicsCmd, renderer, &sceneTexures, renderScene, viewDataGPU, frameDataGPU, tickData);
-			
-			adaptiveExposure(graphicsCmd, renderer, &sceneTexures, renderScene, viewDataGPU, frameDataGPU, tickData);
-
-
-			auto bloomTex = renderBloom(graphicsCmd, renderer, &sceneTexures, renderScene, viewDataGPU, frameDataGPU);
-
+			{
+				ScopeCPUTimeStamp cpuTimer(m_gpuTimer, "CPU AtmosphereComposite");
+				renderAtmosphere(graphicsCmd, renderer, &sceneTexures, renderScene, viewDataGPU, frameDataGPU, true);
+			}
+
+			{
+				ScopeCPUTimeStamp cpuTimer(m_gpuTimer, "CPU VolumetricCloud");
+				renderVolumetricCloud(graphicsCmd, renderer, &sceneTexures, renderScene, viewDataGPU, frameDataGPU);
+			}
+
+			{
+				ScopeCPUTimeStamp cpuTimer(m_gpuTimer, "CPU FSR2");
+				renderFSR2(graphicsCmd, renderer, &sceneTexures, renderScene, viewDataGPU, frameDataGPU, tickData);
+			}
 			
-			renderTonemapper(graphicsCmd, renderer, &sceneTexures, renderScene, viewDataGPU, frameDataGPU, bloomTex);
+			{
+				ScopeCPUTimeStamp cpuTimer(m_gpuTimer, "CPU AdaptiveExposure");
+				adaptiveExposure(graphicsCmd, renderer, &sceneTexures, renderScene, viewDataGPU, frameDataGPU, tickData);
+			}
+
+			PoolImageSharedRef bloomTex;
+			{
+				ScopeCPUTimeStamp cpuTimer(m_gpuTimer, "CPU Bloom");
+				bloomTex = renderBloom(graphicsCmd, renderer, &sceneTexures, renderScene, viewDataGPU, frameDataGPU);
+			}
+
+			{
+				ScopeCPUTimeStamp cpuTimer(m_gpuTimer, "CPU Tonemapper");
+				renderTonemapper(graphicsCmd, renderer, &sceneTexures, renderScene, viewDataGPU, frameDataGPU, bloomTex);
+			}
 		}
 
 
@@ -229,14 +292,21 @@ namespace Flower
 		m_fsr2->onCreateWindowSizeDependentResources(
 			nullptr, 
 			getDisplayOutput().getView(buildBasicImageSubresource()),
-			m_renderWidth,
-			m_renderHeight,
+			m_maxRenderWidth,
+			m_maxRenderHeight,
 			m_displayWidth,
 			m_displayHeight,
 			true);
 	}
 
-	
+	void DeferredRenderer::dynamicRenderSizeChangedImpl()
+	{
+		// Fsr2 context create with max render size, only prev frame textures need drop.
+		m_prevDepth = nullptr;
+		m_prevGBufferB = nullptr;
+		m_cloudHistory = nullptr;
+	}
+
 	VkDescriptorSet BlueNoiseMisc::getSet()
 	{
 		if (m_set == VK_NULL_HANDLE)
@@ -7,6 +7,8 @@
 #include "../RendererTextures.h"
 #include "../RenderSceneData.h"
 #include "../SceneTextures.h"
+#include "../ClusteredLighting.h"
+#include "../CachedShadowCascade.h"
 
 namespace Flower
 {
@@ -24,6 +26,48 @@ namespace Flower
 		static VkDescriptorSetLayout s_layout;
 	};
 
+	// Per frame cluster light lists, see ClusteredLighting.h.
+	struct ClusteredLightLists
+	{
+		GPUClusterGrid grid;
+		BufferParamRefPointer lightCounts;
+		BufferParamRefPointer lightIndices;
+	};
+
+	// Screen space effect quality tier, value same with shader side.
+	enum class EScreenSpaceResolution
+	{
+		Full = 0,
+		Half,         // Evaluate at half width and height, bilateral upsample to render resolution.
+		Checkerboard, // Evaluate half pixels each frame, temporal history fill the rest.
+
+		Max,
+	};
+
+	inline EScreenSpaceResolution getScreenSpaceResolution(int32_t value)
+	{
+		return EScreenSpaceResolution(glm::clamp(value, 0, int32_t(EScreenSpaceResolution::Max) - 1));
+	}
+
+	// Directional light static shadow depth cache, see CachedShadowCascade.h.
+	struct SDSMStaticCache
+	{
+		// Static node depth only, same layout with sdsm atlas.
+		PoolImageSharedRef depth = nullptr;
+
+		// Key of cached cascades, empty when cache invalid.
+		std::vector<CachedShadowCascade::CascadeKey> cascades;
+
+		// Last frame cascade update count.
+		uint32_t reusedCount = 0;
+		uint32_t scrolledCount = 0;
+		uint32_t redrawnCount = 0;
+
+		uint64_t totalReusedCount = 0;
+		uint64_t totalScrolledCount = 0;
+		uint64_t totalRedrawnCount = 0;
+	};
+
 	class DeferredRenderer : public RendererInterface
 	{
 	public:
@@ -35,6 +79,8 @@ namespace Flower
 
 		virtual void updateRenderSizeImpl(uint32_t width, uint32_t height, float renderScale, float displayScale) override;
 
+		virtual void dynamicRenderSizeChangedImpl() override;
+
 	private:
 		std::unique_ptr<FSR2Context> m_fsr2 = nullptr;
 		GPUFrameData m_cacheFrameData;
@@ -62,6 +108,14 @@ namespace Flower
 			BufferParamRefPointer& viewData,
 			BufferParamRefPointer& frameData);
 
+		void renderLandscape(
+			VkCommandBuffer cmd,
+			Renderer* renderer,
+			SceneTextures* inTextures,
+			RenderSceneData* scene,
+			BufferParamRefPointer& viewData,
+			BufferParamRefPointer& frameData);
+
 		// return hiz cloest.
 		PoolImageSharedRef renderHiZ(
 			VkCommandBuffer cmd,
@@ -100,6 +154,14 @@ namespace Flower
 			BufferParamRefPointer& frameData
 		);
 
+		ClusteredLightLists renderClusteredLightCulling(
+			VkCommandBuffer cmd,
+			Renderer* renderer,
+			SceneTextures* inTextures,
+			RenderSceneData* scene,
+			BufferParamRefPointer& viewData,
+			BufferParamRefPointer& frameData);
+
 		void renderBasicLighting(
 			VkCommandBuffer cmd,
 			Renderer* renderer,
@@ -107,7 +169,8 @@ namespace Flower
 			RenderSceneData* scene,
 			BufferParamRefPointer& viewData,
 			BufferParamRefPointer& frameData,
-			PoolImageSharedRef inGTAO);
+			PoolImageSharedRef inGTAO,
+			const ClusteredLightLists& inClusteredLights);
 
 		void renderSSR(
 			VkCommandBuffer cmd,
@@ -167,8 +230,13 @@ namespace Flower
 	private:
 		PoolImageSharedRef m_averageLum = nullptr;
 		PoolImageSharedRef m_gtaoHistory = nullptr;
+		PoolImageSharedRef m_cloudHistory = nullptr;
+		SDSMStaticCache m_sdsmStaticCache;
 
 		PoolImageSharedRef m_prevDepth = nullptr;
 		PoolImageSharedRef m_prevGBufferB = nullptr;
+
+		// Texture streaming feedback written by gbuffer pass, read back when ring back to same slot.
+		std::array<BufferParamRefPointer, GBackBufferCount> m_textureFeedback;
 	};
 }
\ No newline at end of file
@@ -9,6 +9,7 @@ namespace Flower
 {
     struct BasicLightingPushConst
     {
+        GPUClusterGrid clusterGrid;
         uint32_t directionalLightValid;
     };
 
@@ -42,6 +43,9 @@ namespace Flower
                 .bindNoInfo(VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, VK_SHADER_STAGE_COMPUTE_BIT, 11) // inGlobalIrradiance
                 .bindNoInfo(VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, VK_SHADER_STAGE_COMPUTE_BIT, 12) // inGlobalPrefilter
                 .bindNoInfo(VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, VK_SHADER_STAGE_COMPUTE_BIT, 13) // inGTAO
+                .bindNoInfo(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT, 14) // localLights
+                .bindNoInfo(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT, 15) // clusterLightCounts
+                .bindNoInfo(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT, 16) // clusterLightIndices
                 .buildNoInfoPush(setLayout);
 
             std::vector<VkDescriptorSetLayout> setLayouts =
@@ -93,7 +97,8 @@ namespace Flower
         RenderSceneData* scene,
         BufferParamRefPointer& viewData,
         BufferParamRefPointer& frameData,
-        PoolImageSharedRef inGTAO)
+        PoolImageSharedRef inGTAO,
+        const ClusteredLightLists& inClusteredLights)
     {
         auto& hdrSceneColor = inTextures->getHdrSceneColor()->getImage();
         auto& gbufferA = inTextures->getGbufferA()->getImage();
@@ -163,6 +168,7 @@ namespace Flower
 
             BasicLightingPushConst gpuPushConstant =
             {
+                .clusterGrid = inClusteredLights.grid,
                 .directionalLightValid = bExistDirectionalLightSDSM ? 1u : 0u,
             };
             vkCmdPushConstants(cmd, pass->pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(gpuPushConstant), &gpuPushConstant);
@@ -182,6 +188,9 @@ namespace Flower
             VkDescriptorImageInfo globalIrradianceInfo = RHIDescriptorImageInfoSample(globalIrradianceView);
             VkDescriptorImageInfo globalPrefilterInfo = RHIDescriptorImageInfoSample(globalPrefilterView);
             VkDescriptorImageInfo gtaoInfo = RHIDescriptorImageInfoSample(inGTAO->getImage().getView(buildBasicImageSubresource()));
+            VkDescriptorBufferInfo localLightsInfo = scene->getLocalLightsPtr()->buffer.getBufferInfo();
+            VkDescriptorBufferInfo clusterLightCountsInfo = inClusteredLights.lightCounts->buffer.getBufferInfo();
+            VkDescriptorBufferInfo clusterLightIndicesInfo = inClusteredLights.lightIndices->buffer.getBufferInfo();
             
             std::vector<VkWriteDescriptorSet> writes
             {
@@ -199,6 +208,9 @@ namespace Flower
                 RHIPushWriteDescriptorSetImage(11, VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, &globalIrradianceInfo),
                 RHIPushWriteDescriptorSetImage(12, VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, &globalPrefilterInfo),
                 RHIPushWriteDescriptorSetImage(13, VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, &gtaoInfo),
+                RHIPushWriteDescriptorSetBuffer(14, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, &localLightsInfo),
+                RHIPushWriteDescriptorSetBuffer(15, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, &clusterLightCountsInfo),
+                RHIPushWriteDescriptorSetBuffer(16, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, &clusterLightIndicesInfo),
             };
 
             // Push owner set #0.
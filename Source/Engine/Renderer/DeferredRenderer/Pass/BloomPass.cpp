@@ -5,12 +5,26 @@
 #include "../../SceneTextures.h"
 #include "../../RenderSettingContext.h"
 
+#include "../../SinglePassDownsample.h"
+
 #include <glm/gtc/integer.hpp>
 
 namespace Flower
 {
+    static AutoCVarInt32 cVarBloomSinglePass(
+        "r.Bloom.SinglePass",
+        "Build bloom chain mip 1 and after in one dispatch with single pass downsampler, mip 0 always 13 tap and karis average, 0 is one dispatch per mip.",
+        "Rendering",
+        1,
+        CVarFlags::ReadAndWrite
+    );
+
     constexpr uint32_t GMaxDownsampleCount = 6;
 
+    // Same with SPDBloom.glsl, single pass build chain mip 1 and after from mip 0.
+    constexpr uint32_t GBloomSPDMaxMipCount = GMaxDownsampleCount - 1;
+    static_assert(GBloomSPDMaxMipCount <= SinglePassDownsample::kTileMips, "Bloom single pass downsample no use global atomic.");
+
     struct BloomDownsample
     {
         glm::vec4 prefilterFactor;
@@ -18,6 +32,11 @@ namespace Flower
         
     };
 
+    struct BloomSPDPush
+    {
+        uint32_t mips;
+    };
+
     struct BloomPushUpscale
     {
         float blurRadius;
@@ -30,6 +49,10 @@ namespace Flower
         VkPipelineLayout downsamplePipelineLayout = VK_NULL_HANDLE;
         VkDescriptorSetLayout downsampleSetLayout = VK_NULL_HANDLE;
 
+        VkPipeline spdPipeline = VK_NULL_HANDLE;
+        VkPipelineLayout spdPipelineLayout = VK_NULL_HANDLE;
+        VkDescriptorSetLayout spdSetLayout = VK_NULL_HANDLE;
+
         VkPipeline upscalePipeline = VK_NULL_HANDLE;
         VkPipelineLayout upscalePipelineLayout = VK_NULL_HANDLE;
         VkDescriptorSetLayout upscaleSetLayout = VK_NULL_HANDLE;
@@ -82,6 +105,45 @@ namespace Flower
                 RHICheck(vkCreateComputePipelines(RHI::Device, nullptr, 1, &computePipelineCreateInfo, nullptr, &downsamplePipeline));
             }
 
+            // Single pass downsample pipe init.
+            {
+                CHECK(spdPipeline == VK_NULL_HANDLE);
+                CHECK(spdPipelineLayout == VK_NULL_HANDLE);
+                CHECK(spdSetLayout == VK_NULL_HANDLE);
+
+                RHI::get()->descriptorFactoryBegin()
+                    .bindNoInfo(VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, VK_SHADER_STAGE_COMPUTE_BIT, 0) // in mip 0
+                    .bindNoInfo(VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, VK_SHADER_STAGE_COMPUTE_BIT, 1, GBloomSPDMaxMipCount) // out mips
+                    .buildNoInfoPush(spdSetLayout);
+
+                std::vector<VkDescriptorSetLayout> setLayouts =
+                {
+                    spdSetLayout, // Owner setlayout.
+                };
+                auto shaderModule = RHI::ShaderManager->getShader("SPDBloom.comp.spv", true);
+
+                VkPipelineLayoutCreateInfo plci = RHIPipelineLayoutCreateInfo();
+
+                VkPushConstantRange pushRange{ .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT, .offset = 0, .size = sizeof(BloomSPDPush) };
+                plci.pushConstantRangeCount = 1;
+                plci.pPushConstantRanges = &pushRange;
+
+                plci.setLayoutCount = (uint32_t)setLayouts.size();
+                plci.pSetLayouts = setLayouts.data();
+                spdPipelineLayout = RHI::get()->createPipelineLayout(plci);
+                VkPipelineShaderStageCreateInfo shaderStageCI{};
+                shaderStageCI.module = shaderModule;
+                shaderStageCI.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+                shaderStageCI.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+                shaderStageCI.pName = "main";
+                VkComputePipelineCreateInfo computePipelineCreateInfo{};
+                computePipelineCreateInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+                computePipelineCreateInfo.layout = spdPipelineLayout;
+                computePipelineCreateInfo.flags = 0;
+                computePipelineCreateInfo.stage = shaderStageCI;
+                RHICheck(vkCreateComputePipelines(RHI::Device, nullptr, 1, &computePipelineCreateInfo, nullptr, &spdPipeline));
+            }
+
             {
                 CHECK(upscalePipeline == VK_NULL_HANDLE);
                 CHECK(upscalePipelineLayout == VK_NULL_HANDLE);
@@ -132,6 +194,10 @@ namespace Flower
             RHISafeRelease(downsamplePipelineLayout);
             downsampleSetLayout = VK_NULL_HANDLE;
 
+            RHISafeRelease(spdPipeline);
+            RHISafeRelease(spdPipelineLayout);
+            spdSetLayout = VK_NULL_HANDLE;
+
             RHISafeRelease(upscalePipeline);
             RHISafeRelease(upscalePipelineLayout);
             upscaleSetLayout = VK_NULL_HANDLE;
@@ -183,10 +249,6 @@ namespace Flower
                 frameData->buffer.getSet(),
             };
 
-            vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pass->downsamplePipeline);
-            vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pass->downsamplePipelineLayout,
-                1, (uint32_t)passSets.size(), passSets.data(), 0, nullptr);
-
             VkDescriptorImageInfo inImageInfo{};
             VkDescriptorImageInfo outImageInfo{};
 
@@ -205,7 +267,16 @@ namespace Flower
             downsamplePush.prefilterFactor.z = 2.0f * knee;
             downsamplePush.prefilterFactor.w = 0.25f / (knee + 0.00001f);
 
-            for (uint32_t i = 0; i < downsampleMipCount; i++)
+            // Mip 0 always per mip 13 tap and karis average, single pass box average only build lower levels.
+            const uint32_t spdMips = downsampleMipCount - 1;
+            const bool bSinglePass = (cVarBloomSinglePass.get() != 0) && (spdMips > 0);
+            const uint32_t perMipCount = bSinglePass ? 1 : downsampleMipCount;
+
+            vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pass->downsamplePipeline);
+            vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pass->downsamplePipelineLayout,
+                1, (uint32_t)passSets.size(), passSets.data(), 0, nullptr);
+
+            for (uint32_t i = 0; i < perMipCount; i++)
             {
                 const bool bFirstLevel = (i == 0);
                 downsamplePush.mipLevel = i;
@@ -266,6 +337,48 @@ namespace Flower
                 workHeight = getSafeWidthDiv2(workHeight);
             }
 
+            if (bSinglePass)
+            {
+                vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pass->spdPipeline);
+
+                const auto spdInfo = SinglePassDownsample::getDispatchInfo(mipStartWidth, mipStartHeight, spdMips);
+
+                // All array element need valid descriptor, unused element point to last mip and never write.
+                std::array<VkDescriptorImageInfo, GBloomSPDMaxMipCount> outImageInfos;
+                for (uint32_t i = 0; i < GBloomSPDMaxMipCount; i++)
+                {
+                    auto outRange = VkImageSubresourceRange
+                    {
+                        .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+                        .baseMipLevel = glm::min(i + 1, downsampleMipCount - 1),
+                        .levelCount = 1,
+                        .baseArrayLayer = 0,
+                        .layerCount = 1
+                    };
+                    outImageInfos[i] = RHIDescriptorImageInfoStorage(sceneColoBlurMipChain->getImage().getView(outRange));
+                }
+
+                auto mip0Range = VkImageSubresourceRange{ .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT, .baseMipLevel = 0, .levelCount = 1, .baseArrayLayer = 0, .layerCount = 1 };
+                auto spdRange = VkImageSubresourceRange{ .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT, .baseMipLevel = 1, .levelCount = spdMips, .baseArrayLayer = 0, .layerCount = 1 };
+                inImageInfo = RHIDescriptorImageInfoSample(sceneColoBlurMipChain->getImage().getView(mip0Range));
+
+                sceneColoBlurMipChain->getImage().transitionLayout(cmd, VK_IMAGE_LAYOUT_GENERAL, spdRange);
+
+                std::vector<VkWriteDescriptorSet> writes
+                {
+                    RHIPushWriteDescriptorSetImage(0, VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, &inImageInfo),
+                    RHIPushWriteDescriptorSetImage(1, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, outImageInfos.data(), GBloomSPDMaxMipCount),
+                };
+                RHI::PushDescriptorSetKHR(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pass->spdPipelineLayout, 0, uint32_t(writes.size()), writes.data());
+
+                BloomSPDPush spdPush{ .mips = spdInfo.mips };
+                vkCmdPushConstants(cmd, pass->spdPipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(spdPush), &spdPush);
+
+                vkCmdDispatch(cmd, spdInfo.groupCountX, spdInfo.groupCountY, 1);
+
+                sceneColoBlurMipChain->getImage().transitionLayout(cmd, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, spdRange);
+            }
+
             std::vector<VkDescriptorSet> upscalePassSets =
             {
                 RHI::SamplerManager->getCommonDescriptorSet(), // samplers.
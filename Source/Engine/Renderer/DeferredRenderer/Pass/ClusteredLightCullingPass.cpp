@@ -0,0 +1,159 @@
+#include "Pch.h"
+#include "../DeferredRenderer.h"
+#include "../../Renderer.h"
+#include "../../RenderSceneData.h"
+#include "../../SceneTextures.h"
+#include "../../RenderSettingContext.h"
+
+namespace Flower
+{
+    static AutoCVarFloat cVarClusteredLightingSliceDistance(
+        "r.ClusteredLighting.SliceDistance",
+        "Exponential depth slice end distance of light cluster grid, farther pixels use last slice.",
+        "ClusteredLighting",
+        500.0f,
+        CVarFlags::ReadAndWrite);
+
+    class ClusteredLightCullingPass : public PassInterface
+    {
+    public:
+        VkPipeline pipeline = VK_NULL_HANDLE;
+        VkPipelineLayout pipelineLayout = VK_NULL_HANDLE;
+        VkDescriptorSetLayout setLayout = VK_NULL_HANDLE;
+
+    public:
+        virtual void init() override
+        {
+            CHECK(pipeline == VK_NULL_HANDLE);
+            CHECK(pipelineLayout == VK_NULL_HANDLE);
+            CHECK(setLayout == VK_NULL_HANDLE);
+
+            // Config code.
+            RHI::get()->descriptorFactoryBegin()
+                .bindNoInfo(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT, 0) // localLights
+                .bindNoInfo(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT, 1) // clusterLightCounts
+                .bindNoInfo(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT, 2) // clusterLightIndices
+                .buildNoInfoPush(setLayout);
+
+            std::vector<VkDescriptorSetLayout> setLayouts =
+            {
+                  setLayout // Owner setlayout.
+                , GetLayoutStatic(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER) // viewData
+                , GetLayoutStatic(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER) // frameData
+            };
+            auto shaderModule = RHI::ShaderManager->getShader("ClusteredLightCulling.comp.spv", true);
+
+            // Vulkan buid functions.
+            VkPipelineLayoutCreateInfo plci = RHIPipelineLayoutCreateInfo();
+            VkPushConstantRange pushConstant{};
+            pushConstant.offset = 0;
+            pushConstant.size = sizeof(GPUClusterGrid);
+            pushConstant.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+            plci.pPushConstantRanges = &pushConstant;
+            plci.pushConstantRangeCount = 1;
+
+            plci.setLayoutCount = (uint32_t)setLayouts.size();
+            plci.pSetLayouts = setLayouts.data();
+            pipelineLayout = RHI::get()->createPipelineLayout(plci);
+            VkPipelineShaderStageCreateInfo shaderStageCI{};
+            shaderStageCI.module = shaderModule;
+            shaderStageCI.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+            shaderStageCI.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+            shaderStageCI.pName = "main";
+            VkComputePipelineCreateInfo computePipelineCreateInfo{};
+            computePipelineCreateInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+            computePipelineCreateInfo.layout = pipelineLayout;
+            computePipelineCreateInfo.flags = 0;
+            computePipelineCreateInfo.stage = shaderStageCI;
+            RHICheck(vkCreateComputePipelines(RHI::Device, nullptr, 1, &computePipelineCreateInfo, nullptr, &pipeline));
+        }
+
+        virtual void release() override
+        {
+            RHISafeRelease(pipeline);
+            RHISafeRelease(pipelineLayout);
+            setLayout = VK_NULL_HANDLE;
+        }
+    };
+
+    ClusteredLightLists DeferredRenderer::renderClusteredLightCulling(
+        VkCommandBuffer cmd,
+        Renderer* renderer,
+        SceneTextures* inTextures,
+        RenderSceneData* scene,
+        BufferParamRefPointer& viewData,
+        BufferParamRefPointer& frameData)
+    {
+        const auto& localLights = scene->getLocalLights();
+        const uint32_t lightCount = localLights.pointLightCount + localLights.spotLightCount;
+
+        auto& hdrSceneColor = inTextures->getHdrSceneColor()->getImage();
+
+        ClusteredLightLists result{};
+        result.grid = ClusteredLighting::buildGrid(
+            hdrSceneColor.getExtent().width,
+            hdrSceneColor.getExtent().height,
+            m_cacheViewData.camInfo.z,
+            cVarClusteredLightingSliceDistance.get(),
+            m_cacheViewData.camInfo.w);
+
+        // Always allocate, lighting pass bind it even no local light.
+        const uint32_t clusterCount = ClusteredLighting::getClusterCount(result.grid);
+        result.lightCounts = getBuffers()->getStaticStorageGPUOnly("ClusterLightCounts", sizeof(uint32_t) * clusterCount);
+        result.lightIndices = getBuffers()->getStaticStorageGPUOnly("ClusterLightIndices",
+            sizeof(uint32_t) * clusterCount * result.grid.maxLightsPerCluster);
+
+        if (lightCount == 0)
+        {
+            return result;
+        }
+
+        {
+            RHI::ScopePerframeMarker marker(cmd, "ClusteredLightCulling", { 1.0f, 1.0f, 0.0f, 1.0f });
+
+            auto* pass = getPasses()->getPass<ClusteredLightCullingPass>();
+            auto localLightsBuffer = scene->getLocalLightsPtr();
+
+            vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pass->pipeline);
+            vkCmdPushConstants(cmd, pass->pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(result.grid), &result.grid);
+
+            VkDescriptorBufferInfo localLightsInfo = localLightsBuffer->buffer.getBufferInfo();
+            VkDescriptorBufferInfo lightCountsInfo = result.lightCounts->buffer.getBufferInfo();
+            VkDescriptorBufferInfo lightIndicesInfo = result.lightIndices->buffer.getBufferInfo();
+            std::vector<VkWriteDescriptorSet> writes
+            {
+                RHIPushWriteDescriptorSetBuffer(0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, &localLightsInfo),
+                RHIPushWriteDescriptorSetBuffer(1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, &lightCountsInfo),
+                RHIPushWriteDescriptorSetBuffer(2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, &lightIndicesInfo),
+            };
+
+            // Push owner set #0.
+            RHI::PushDescriptorSetKHR(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pass->pipelineLayout, 0, uint32_t(writes.size()), writes.data());
+
+            std::vector<VkDescriptorSet> passSets =
+            {
+                  viewData->buffer.getSet()  // viewData
+                , frameData->buffer.getSet() // frameData
+            };
+            vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pass->pipelineLayout,
+                1, (uint32_t)passSets.size(), passSets.data(), 0, nullptr);
+
+            // One thread one cluster.
+            vkCmdDispatch(cmd, getGroupCount(clusterCount, 64), 1, 1);
+            m_gpuTimer.getTimeStamp(cmd, "ClusteredLightCulling");
+
+            std::array<VkBufferMemoryBarrier2, 2> endBufferBarriers
+            {
+                RHIBufferBarrier(result.lightCounts->buffer.getBuffer()->getVkBuffer(),
+                    VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT,
+                    VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT),
+                RHIBufferBarrier(result.lightIndices->buffer.getBuffer()->getVkBuffer(),
+                    VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT,
+                    VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT),
+            };
+            RHIPipelineBarrier(cmd, 0, (uint32_t)endBufferBarriers.size(), endBufferBarriers.data(), 0, nullptr);
+        }
+
+        return result;
+    }
+}
\ No newline at end of file
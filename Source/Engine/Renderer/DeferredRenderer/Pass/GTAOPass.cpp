@@ -7,6 +7,14 @@
 
 namespace Flower
 {
+    static AutoCVarInt32 cVarGTAOResolution(
+        "r.GTAO.Resolution",
+        "GTAO resolution tier, 0 is full, 1 is half with bilateral upsample, 2 is checkerboard.",
+        "GTAO",
+        0,
+        CVarFlags::ReadAndWrite
+    );
+
     struct GTAOPush
     {
         uint32_t sliceNum;
@@ -15,6 +23,7 @@ namespace Flower
         float thickness;
         float power;
         float intensity;
+        uint32_t resolutionMode;
     };
 
     class GTAOPass : public PassInterface
@@ -23,7 +32,7 @@ namespace Flower
         VkPipeline evaluatePipeline = VK_NULL_HANDLE;
         VkPipeline filterPipeline = VK_NULL_HANDLE;
         VkPipeline tempFilter = VK_NULL_HANDLE;
-        
+        VkPipeline upsamplePipeline = VK_NULL_HANDLE;
 
         VkPipelineLayout pipelineLayout = VK_NULL_HANDLE;
         VkDescriptorSetLayout setLayout = VK_NULL_HANDLE;
@@ -52,6 +61,7 @@ namespace Flower
                 .bindNoInfo(VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, VK_SHADER_STAGE_COMPUTE_BIT, 13) // in Velocity
                 .bindNoInfo(VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, VK_SHADER_STAGE_COMPUTE_BIT, 14) // inPrevDepth
                 .bindNoInfo(VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, VK_SHADER_STAGE_COMPUTE_BIT, 15) // inPrevGBufferB
+                .bindNoInfo(VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, VK_SHADER_STAGE_COMPUTE_BIT, 16) // GTAOUpsampleImage
                 .buildNoInfoPush(setLayout);
 
             std::vector<VkDescriptorSetLayout> setLayouts =
@@ -111,6 +121,16 @@ namespace Flower
 
                 RHICheck(vkCreateComputePipelines(RHI::Device, nullptr, 1, &computePipelineCreateInfo, nullptr, &filterPipeline));
             }
+
+            {
+                CHECK(upsamplePipeline == VK_NULL_HANDLE);
+                auto shaderModule = RHI::ShaderManager->getShader("GTAOUpsample.comp.spv", true);
+
+                shaderStageCI.module = shaderModule;
+                computePipelineCreateInfo.stage = shaderStageCI;
+
+                RHICheck(vkCreateComputePipelines(RHI::Device, nullptr, 1, &computePipelineCreateInfo, nullptr, &upsamplePipeline));
+            }
         }
 
         virtual void release() override
@@ -121,6 +141,7 @@ namespace Flower
             RHISafeRelease(evaluatePipeline);
             RHISafeRelease(filterPipeline);
             RHISafeRelease(tempFilter);
+            RHISafeRelease(upsamplePipeline);
         }
     };
 
@@ -166,10 +187,18 @@ namespace Flower
         }
 
 
+        // Half tier evaluate, filter and keep history at half resolution, checkerboard tier keep full resolution.
+        const auto resolution = getScreenSpaceResolution(cVarGTAOResolution.get());
+        const bool bHalfResolution = (resolution == EScreenSpaceResolution::Half);
+        const bool bCheckerboard = (resolution == EScreenSpaceResolution::Checkerboard);
+
+        const uint32_t gtaoWidth = bHalfResolution ? divideRoundingUp(sceneDepthZ.getExtent().width, 2u) : sceneDepthZ.getExtent().width;
+        const uint32_t gtaoHeight = bHalfResolution ? divideRoundingUp(sceneDepthZ.getExtent().height, 2u) : sceneDepthZ.getExtent().height;
+
         auto imageGTAOEvaluate = m_rtPool->createPoolImage(
             "GTAOEvaluate",
-            sceneDepthZ.getExtent().width,
-            sceneDepthZ.getExtent().height,
+            gtaoWidth,
+            gtaoHeight,
             VK_FORMAT_R8_UNORM,
             VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT);
 
@@ -223,6 +252,21 @@ namespace Flower
         VkDescriptorImageInfo historyImage =  RHIDescriptorImageInfoStorage(m_gtaoHistory->getImage().getView(buildBasicImageSubresource()));
         VkDescriptorImageInfo historyImageInfo =  RHIDescriptorImageInfoSample(m_gtaoHistory->getImage().getView(buildBasicImageSubresource()));
 
+        // Upsample output only use by half tier, other tier bind temp filter image keep descriptor valid.
+        PoolImageSharedRef imageGTAOUpsample = nullptr;
+        VkDescriptorImageInfo upsampleImage = tempfilterImage;
+        if (bHalfResolution)
+        {
+            imageGTAOUpsample = m_rtPool->createPoolImage(
+                "GTAOUpsample",
+                sceneDepthZ.getExtent().width,
+                sceneDepthZ.getExtent().height,
+                VK_FORMAT_R8_UNORM,
+                VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT);
+
+            upsampleImage = RHIDescriptorImageInfoStorage(imageGTAOUpsample->getImage().getView(buildBasicImageSubresource()));
+        }
+
         std::vector<VkWriteDescriptorSet> writes
         {
             RHIPushWriteDescriptorSetImage(0, VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, &hizInfo),
@@ -241,6 +285,7 @@ namespace Flower
             RHIPushWriteDescriptorSetImage(13, VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, &gbufferVInfo),
             RHIPushWriteDescriptorSetImage(14, VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, &prevDepthInfo),
             RHIPushWriteDescriptorSetImage(15, VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, &preGBufferBInfo),
+            RHIPushWriteDescriptorSetImage(16, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, &upsampleImage),
         };
 
 
@@ -266,6 +311,7 @@ namespace Flower
             .thickness = RenderSettingManager::get()->GTAO_thickness,
             .power = RenderSettingManager::get()->GTAO_Power,
             .intensity = RenderSettingManager::get()->GTAO_Intensity,
+            .resolutionMode = (uint32_t)resolution,
         };
         vkCmdPushConstants(cmd, pass->pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(pushConst), &pushConst);
 
@@ -277,7 +323,9 @@ namespace Flower
 
             vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pass->evaluatePipeline);
 
-            vkCmdDispatch(cmd, getGroupCount(imageGTAOEvaluate->getImage().getExtent().width, 8), getGroupCount(imageGTAOEvaluate->getImage().getExtent().height, 8), 1);
+            // Checkerboard only dispatch half width, shader map to this frame pixels.
+            const uint32_t evaluateWidth = bCheckerboard ? divideRoundingUp(imageGTAOEvaluate->getImage().getExtent().width, 2u) : imageGTAOEvaluate->getImage().getExtent().width;
+            vkCmdDispatch(cmd, getGroupCount(evaluateWidth, 8), getGroupCount(imageGTAOEvaluate->getImage().getExtent().height, 8), 1);
 
             imageGTAOEvaluate->getImage().transitionLayout(cmd, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, buildBasicImageSubresource());
         }
@@ -309,8 +357,26 @@ namespace Flower
 
         m_gtaoHistory = imageGTAOTempFilter;
 
-        m_gpuTimer.getTimeStamp(cmd, "GTAO");
+        if (!bHalfResolution)
+        {
+            m_gpuTimer.getTimeStamp(cmd, bCheckerboard ? "GTAO Checkerboard" : "GTAO Full");
+            return imageGTAOTempFilter;
+        }
+
+        m_gpuTimer.getTimeStamp(cmd, "GTAO Half");
+        {
+            RHI::ScopePerframeMarker marker(cmd, "GTAO Upsample", { 1.0f, 1.0f, 0.0f, 1.0f });
+
+            imageGTAOUpsample->getImage().transitionLayout(cmd, VK_IMAGE_LAYOUT_GENERAL, buildBasicImageSubresource());
+
+            vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pass->upsamplePipeline);
+
+            vkCmdDispatch(cmd, getGroupCount(imageGTAOUpsample->getImage().getExtent().width, 8), getGroupCount(imageGTAOUpsample->getImage().getExtent().height, 8), 1);
+
+            imageGTAOUpsample->getImage().transitionLayout(cmd, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, buildBasicImageSubresource());
+        }
+        m_gpuTimer.getTimeStamp(cmd, "GTAO Upsample");
 
-        return imageGTAOTempFilter;
+        return imageGTAOUpsample;
     }
 }
\ No newline at end of file
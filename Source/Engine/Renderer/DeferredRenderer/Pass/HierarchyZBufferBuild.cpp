@@ -3,15 +3,32 @@
 #include "../../Renderer.h"
 #include "../../RenderSceneData.h"
 #include "../../SceneTextures.h"
-
+#include "../../SinglePassDownsample.h"
 
 namespace Flower
 {
+    static AutoCVarInt32 cVarHizSinglePass(
+        "r.Hiz.SinglePass",
+        "Build leading even size hiz levels in one dispatch with single pass downsampler, odd size levels after them per mip, 0 is one dispatch per mip.",
+        "Rendering",
+        1,
+        CVarFlags::ReadAndWrite
+    );
+
+    // Same with SPDHiz.glsl.
+    constexpr uint32_t GHizSPDMaxMipCount = SinglePassDownsample::kMaxMips + 1;
+
     struct HizPush
     {
         uint32_t kInputLevel;
     };
 
+    struct HizSPDPush
+    {
+        uint32_t mips;
+        uint32_t numWorkGroups;
+    };
+
     class HizBuildPass : public PassInterface
     {
     public:
@@ -19,6 +36,10 @@ namespace Flower
         VkPipelineLayout pipelineLayout = VK_NULL_HANDLE;
         VkDescriptorSetLayout setLayout = VK_NULL_HANDLE;
 
+        VkPipeline spdPipeline = VK_NULL_HANDLE;
+        VkPipelineLayout spdPipelineLayout = VK_NULL_HANDLE;
+        VkDescriptorSetLayout spdSetLayout = VK_NULL_HANDLE;
+
     public:
         virtual void init() override
         {
@@ -64,7 +85,34 @@ namespace Flower
             computePipelineCreateInfo.flags = 0;
             computePipelineCreateInfo.stage = shaderStageCI;
             RHICheck(vkCreateComputePipelines(RHI::Device, nullptr, 1, &computePipelineCreateInfo, nullptr, &pipeline));
-            
+
+            // Single pass pipe init.
+            {
+                CHECK(spdPipeline == VK_NULL_HANDLE);
+                CHECK(spdPipelineLayout == VK_NULL_HANDLE);
+                CHECK(spdSetLayout == VK_NULL_HANDLE);
+
+                RHI::get()->descriptorFactoryBegin()
+                    .bindNoInfo(VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, VK_SHADER_STAGE_COMPUTE_BIT, 0, GHizSPDMaxMipCount) // hizClosestImages
+                    .bindNoInfo(VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, VK_SHADER_STAGE_COMPUTE_BIT, 1, GHizSPDMaxMipCount) // hizFurthestImages
+                    .bindNoInfo(VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, VK_SHADER_STAGE_COMPUTE_BIT, 2) // inDepth
+                    .bindNoInfo(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT, 3) // SPDCounterSSBO
+                    .buildNoInfoPush(spdSetLayout);
+
+                VkPushConstantRange spdPushRange{ .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT, .offset = 0, .size = sizeof(HizSPDPush) };
+
+                VkPipelineLayoutCreateInfo spdPlci = RHIPipelineLayoutCreateInfo();
+                spdPlci.pushConstantRangeCount = 1;
+                spdPlci.pPushConstantRanges = &spdPushRange;
+                spdPlci.setLayoutCount = 1;
+                spdPlci.pSetLayouts = &spdSetLayout;
+                spdPipelineLayout = RHI::get()->createPipelineLayout(spdPlci);
+
+                shaderStageCI.module = RHI::ShaderManager->getShader("SPDHiz.comp.spv", true);
+                computePipelineCreateInfo.layout = spdPipelineLayout;
+                computePipelineCreateInfo.stage = shaderStageCI;
+                RHICheck(vkCreateComputePipelines(RHI::Device, nullptr, 1, &computePipelineCreateInfo, nullptr, &spdPipeline));
+            }
         }
 
         virtual void release() override
@@ -72,6 +120,10 @@ namespace Flower
             RHISafeRelease(pipeline);
             RHISafeRelease(pipelineLayout);
             setLayout = VK_NULL_HANDLE;
+
+            RHISafeRelease(spdPipeline);
+            RHISafeRelease(spdPipelineLayout);
+            spdSetLayout = VK_NULL_HANDLE;
         }
     };
 
@@ -121,11 +173,68 @@ namespace Flower
                 VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_STORAGE_BIT,
                 -1);
 
+            // Single pass only build leading levels with even input, odd size levels drop edge there.
+            // Remain levels go per mip path which sample extra row and column of odd input.
+            const uint32_t hizMipLevels = hizMipChainCloest->getImage().getInfo().mipLevels;
+            const uint32_t spdMips = (cVarHizSinglePass.get() != 0)
+                ? SinglePassDownsample::getConservativeMips(mipStartWidth, mipStartHeight, hizMipLevels - 1)
+                : 0;
+            const bool bSinglePass = (spdMips > 0) && SinglePassDownsample::isSupported(mipStartWidth, mipStartHeight, spdMips);
+            if (bSinglePass)
+            {
+                const auto spdInfo = SinglePassDownsample::getDispatchInfo(mipStartWidth, mipStartHeight, spdMips);
+
+                // Last workgroup find by counter, clear before dispatch.
+                auto ssboCounterBuffer = getBuffers()->getStaticStorage("hizSPDCounterBuffer", sizeof(uint32_t));
+                vkCmdFillBuffer(cmd, *ssboCounterBuffer->buffer.getBuffer(), 0, ssboCounterBuffer->buffer.getBuffer()->getSize(), 0u);
+                std::array<VkBufferMemoryBarrier2, 1> fillBarriers
+                {
+                    RHIBufferBarrier(ssboCounterBuffer->buffer.getBuffer()->getVkBuffer(),
+                        VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT,
+                        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT),
+                };
+                RHIPipelineBarrier(cmd, 0, (uint32_t)fillBarriers.size(), fillBarriers.data(), 0, nullptr);
+
+                hizMipChainCloest->getImage().transitionLayout(cmd, VK_IMAGE_LAYOUT_GENERAL, buildBasicImageSubresource());
+                hizMipChainFurthest->getImage().transitionLayout(cmd, VK_IMAGE_LAYOUT_GENERAL, buildBasicImageSubresource());
+
+                // All array element need valid descriptor, unused element point to last mip and never write.
+                std::array<VkDescriptorImageInfo, GHizSPDMaxMipCount> closestInfos;
+                std::array<VkDescriptorImageInfo, GHizSPDMaxMipCount> furthestInfos;
+                for (uint32_t i = 0; i < GHizSPDMaxMipCount; i++)
+                {
+                    VkImageSubresourceRange rangeMip{ .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT, .baseMipLevel = glm::min(i, hizMipLevels - 1), .levelCount = 1, .baseArrayLayer = 0, .layerCount = 1 };
+
+                    closestInfos[i] = RHIDescriptorImageInfoStorage(hizMipChainCloest->getImage().getView(rangeMip));
+                    furthestInfos[i] = RHIDescriptorImageInfoStorage(hizMipChainFurthest->getImage().getView(rangeMip));
+                }
+                VkDescriptorImageInfo inDepth = RHIDescriptorImageInfoSample(depthTex.getView(RHIDefaultImageSubresourceRange(VK_IMAGE_ASPECT_DEPTH_BIT)));
+                VkDescriptorBufferInfo counterBufferInfo = ssboCounterBuffer->buffer.getBufferInfo();
+
+                std::vector<VkWriteDescriptorSet> writes
+                {
+                    RHIPushWriteDescriptorSetImage(0, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, closestInfos.data(), GHizSPDMaxMipCount),
+                    RHIPushWriteDescriptorSetImage(1, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, furthestInfos.data(), GHizSPDMaxMipCount),
+                    RHIPushWriteDescriptorSetImage(2, VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, &inDepth),
+                    RHIPushWriteDescriptorSetBuffer(3, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, &counterBufferInfo),
+                };
+
+                HizSPDPush spdPush{ .mips = spdInfo.mips, .numWorkGroups = spdInfo.numWorkGroups };
+
+                vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pass->spdPipeline);
+                RHI::PushDescriptorSetKHR(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pass->spdPipelineLayout, 0, uint32_t(writes.size()), writes.data());
+                vkCmdPushConstants(cmd, pass->spdPipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(spdPush), &spdPush);
+                vkCmdDispatch(cmd, spdInfo.groupCountX, spdInfo.groupCountY, 1);
+
+                hizMipChainCloest->getImage().transitionLayout(cmd, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, buildBasicImageSubresource());
+                hizMipChainFurthest->getImage().transitionLayout(cmd, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, buildBasicImageSubresource());
+            }
 
             HizPush push{ .kInputLevel = 0 };
             vkCmdPushConstants(cmd, pass->pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(push), &push);
 
             // Build from src.
+            if (!bSinglePass)
             {
                 VkImageSubresourceRange rangeMip0{ .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT, .baseMipLevel = 0, .levelCount = 1, .baseArrayLayer = 0, .layerCount = 1 };
 
@@ -161,14 +270,20 @@ namespace Flower
             push.kInputLevel = 1;
             vkCmdPushConstants(cmd, pass->pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(push), &push);
 
-            // Build from hiz.
-            if(hizMipChainCloest->getImage().getInfo().mipLevels > 1)
+            // Build from hiz, continue after single pass levels.
+            const uint32_t firstLoopMip = bSinglePass ? spdMips + 1 : 1;
+            if(hizMipChainCloest->getImage().getInfo().mipLevels > firstLoopMip)
             {
                 vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pass->pipeline);
                 uint32_t loopWidth = mipStartWidth;
                 uint32_t loopHeight = mipStartHeight;
+                for (uint32_t i = 1; i < firstLoopMip; i++)
+                {
+                    loopWidth = getSafeWidthDiv2(loopWidth);
+                    loopHeight = getSafeWidthDiv2(loopHeight);
+                }
 
-                for (uint32_t i = 1; i < hizMipChainCloest->getImage().getInfo().mipLevels; i++)
+                for (uint32_t i = firstLoopMip; i < hizMipChainCloest->getImage().getInfo().mipLevels; i++)
                 {
                     VkImageSubresourceRange rangeMipN_1{ .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT, .baseMipLevel = i - 1, .levelCount = 1, .baseArrayLayer = 0, .layerCount = 1 };
                     VkImageSubresourceRange rangeMipN{ .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT, .baseMipLevel = i, .levelCount = 1, .baseArrayLayer = 0, .layerCount = 1 };
@@ -0,0 +1,289 @@
+#include "Pch.h"
+#include "../DeferredRenderer.h"
+#include "../../Renderer.h"
+#include "../../RenderSceneData.h"
+#include "../../RendererTextures.h"
+#include "../../SceneTextures.h"
+#include "../../../Scene/Component/Landscape.h"
+
+namespace Flower
+{
+    static AutoCVarInt32 cVarLandscapeEnable("r.Landscape.Enable", "Enable landscape gbuffer rendering.", "Landscape", 1, CVarFlags::ReadAndWrite);
+
+    struct GPULandscapePushConstants
+    {
+        // Grid quads per node side, full node and quarter node draw with different grid.
+        uint32_t gridDim;
+    };
+
+    class LandscapePass : public PassInterface
+    {
+    public:
+        VkPipeline pipeline = VK_NULL_HANDLE;
+        VkPipelineLayout pipelineLayout = VK_NULL_HANDLE;
+
+    protected:
+        virtual void init() override
+        {
+            CHECK(pipeline == VK_NULL_HANDLE);
+            CHECK(pipelineLayout == VK_NULL_HANDLE);
+
+            auto vertShader = RHI::ShaderManager->getShader("Landscape.vert.spv", true);
+            auto fragShader = RHI::ShaderManager->getShader("Landscape.frag.spv", true);
+
+            std::vector<VkDescriptorSetLayout> setLayouts =
+            {
+                  GetLayoutStatic(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER) // viewData
+                , GetLayoutStatic(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER) // frameData
+                , GetLayoutStatic(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER) // landscapeData
+                , GetLayoutStatic(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER) // nodes
+                , GetLayoutStatic(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER) // pageTable
+                , Bindless::Texture->getSetLayout() // texture2D array
+            };
+
+            std::vector<VkPipelineShaderStageCreateInfo> shaderStages =
+            {
+                RHIPipelineShaderStageCreateInfo(VK_SHADER_STAGE_VERTEX_BIT, vertShader),
+                RHIPipelineShaderStageCreateInfo(VK_SHADER_STAGE_FRAGMENT_BIT, fragShader),
+            };
+
+            std::vector<VkFormat> colorAttachmentFormats =
+            {
+                RTFormats::hdrSceneColor(),
+                RTFormats::gbufferA(),
+                RTFormats::gbufferB(),
+                RTFormats::gbufferS(),
+                RTFormats::gbufferV(),
+            };
+
+            std::vector<VkPipelineColorBlendAttachmentState> attachmentBlends =
+            {
+                RHIColorBlendAttachmentOpauqeState(),
+                RHIColorBlendAttachmentOpauqeState(),
+                RHIColorBlendAttachmentOpauqeState(),
+                RHIColorBlendAttachmentOpauqeState(),
+                RHIColorBlendAttachmentOpauqeState(),
+            };
+
+            const VkPipelineRenderingCreateInfo pipelineRenderingCreateInfo
+            {
+                .sType = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO,
+                .colorAttachmentCount = (uint32_t)colorAttachmentFormats.size(),
+                .pColorAttachmentFormats = colorAttachmentFormats.data(),
+                .depthAttachmentFormat = RTFormats::depth(),
+            };
+            VkPipelineColorBlendStateCreateInfo colorBlending
+            {
+                .sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO,
+                .logicOpEnable = VK_FALSE,
+                .logicOp = VK_LOGIC_OP_COPY,
+                .attachmentCount = uint32_t(attachmentBlends.size()),
+                .pAttachments = attachmentBlends.data(),
+            };
+
+            auto defaultViewport = RHIDefaultViewportState();
+            const auto& deafultDynamicState = RHIDefaultDynamicStateCreateInfo();
+            auto vertexInputState = RHIVertexInputStateCreateInfo();
+            auto assemblyCreateInfo = RHIInputAssemblyCreateInfo(VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST);
+            auto rasterState = RHIRasterizationStateCreateInfo(VK_POLYGON_MODE_FILL);
+            rasterState.cullMode = VK_CULL_MODE_FRONT_BIT;
+            auto multiSampleState = RHIMultisamplingStateCreateInfo();
+            auto depthStencilState = RHIDepthStencilCreateInfo(true, true, VK_COMPARE_OP_GREATER); // Reverse z.
+
+            VkPushConstantRange pushConstant{};
+            pushConstant.offset = 0;
+            pushConstant.size = sizeof(GPULandscapePushConstants);
+            pushConstant.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+
+            VkPipelineLayoutCreateInfo plci = RHIPipelineLayoutCreateInfo();
+            plci.pPushConstantRanges = &pushConstant;
+            plci.pushConstantRangeCount = 1;
+            plci.setLayoutCount = (uint32_t)setLayouts.size();
+            plci.pSetLayouts = setLayouts.data();
+            pipelineLayout = RHI::get()->createPipelineLayout(plci);
+            VkGraphicsPipelineCreateInfo pipelineCreateInfo
+            {
+                .sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO,
+                .pNext = &pipelineRenderingCreateInfo,
+                .stageCount = uint32_t(shaderStages.size()),
+                .pStages = shaderStages.data(),
+                .pVertexInputState = &vertexInputState,
+                .pInputAssemblyState = &assemblyCreateInfo,
+                .pViewportState = &defaultViewport,
+                .pRasterizationState = &rasterState,
+                .pMultisampleState = &multiSampleState,
+                .pDepthStencilState = &depthStencilState,
+                .pColorBlendState = &colorBlending,
+                .pDynamicState = &deafultDynamicState,
+                .layout = pipelineLayout,
+            };
+            RHICheck(vkCreateGraphicsPipelines(RHI::Device, nullptr, 1, &pipelineCreateInfo, nullptr, &pipeline));
+        }
+
+        virtual void release() override
+        {
+            RHISafeRelease(pipeline);
+            RHISafeRelease(pipelineLayout);
+        }
+    };
+
+    void DeferredRenderer::renderLandscape(
+        VkCommandBuffer cmd,
+        Renderer* renderer,
+        SceneTextures* inTextures,
+        RenderSceneData* scene,
+        BufferParamRefPointer& viewData,
+        BufferParamRefPointer& frameData)
+    {
+        const auto& landscapes = scene->getCollectLandscapes();
+        if (landscapes.empty() || cVarLandscapeEnable.get() == 0)
+        {
+            return;
+        }
+
+        // Cpu node selection and tile streaming, skip landscape which heightmap still loading.
+        struct LandscapeDraw
+        {
+            BufferParamRefPointer landscapeData;
+            BufferParamRefPointer nodes;
+            BufferParamRefPointer pageTable;
+            uint32_t fullNodeCount;
+            uint32_t quarterNodeCount;
+        };
+        std::vector<LandscapeDraw> draws;
+
+        LandscapeRenderData renderData;
+        for (const auto& landscape : landscapes)
+        {
+            if (!landscape->prepareRender(m_cacheViewData, renderData) || renderData.nodes.empty())
+            {
+                continue;
+            }
+
+            LandscapeDraw draw{};
+            draw.fullNodeCount = renderData.fullNodeCount;
+            draw.quarterNodeCount = uint32_t(renderData.nodes.size()) - renderData.fullNodeCount;
+
+            draw.landscapeData = getBuffers()->getStaticUniform("LandscapeData", sizeof(GPULandscapeData));
+            draw.landscapeData->buffer.updateData(renderData.landscape);
+
+            draw.nodes = getBuffers()->getStaticStorage("LandscapeNodes", sizeof(GPULandscapeNode) * renderData.nodes.size());
+            draw.nodes->buffer.updateDataPtr((void*)renderData.nodes.data());
+
+            draw.pageTable = getBuffers()->getStaticStorage("LandscapePageTable", sizeof(uint32_t) * renderData.pageTable->size());
+            draw.pageTable->buffer.updateDataPtr((void*)renderData.pageTable->data());
+
+            draws.push_back(std::move(draw));
+        }
+
+        if (draws.empty())
+        {
+            return;
+        }
+
+        auto& hdrSceneColor = inTextures->getHdrSceneColor()->getImage();
+        auto& gbufferA = inTextures->getGbufferA()->getImage();
+        auto& gbufferB = inTextures->getGbufferB()->getImage();
+        auto& gbufferS = inTextures->getGbufferS()->getImage();
+        auto& gbufferV = inTextures->getGbufferV()->getImage();
+        auto& sceneDepthZ = inTextures->getDepth()->getImage();
+
+        hdrSceneColor.transitionLayout(cmd, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, RHIDefaultImageSubresourceRange(VK_IMAGE_ASPECT_COLOR_BIT));
+        gbufferA.transitionLayout(cmd, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, RHIDefaultImageSubresourceRange(VK_IMAGE_ASPECT_COLOR_BIT));
+        gbufferB.transitionLayout(cmd, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, RHIDefaultImageSubresourceRange(VK_IMAGE_ASPECT_COLOR_BIT));
+        gbufferS.transitionLayout(cmd, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, RHIDefaultImageSubresourceRange(VK_IMAGE_ASPECT_COLOR_BIT));
+        gbufferV.transitionLayout(cmd, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, RHIDefaultImageSubresourceRange(VK_IMAGE_ASPECT_COLOR_BIT));
+        sceneDepthZ.transitionLayout(cmd, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL, RHIDefaultImageSubresourceRange(VK_IMAGE_ASPECT_DEPTH_BIT));
+
+        // Draw after static mesh gbuffer, keep its result.
+        std::vector<VkRenderingAttachmentInfo> colorAttachments =
+        {
+            RHIRenderingAttachmentInfo(hdrSceneColor.getView(buildBasicImageSubresource()),
+                VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, VK_ATTACHMENT_LOAD_OP_LOAD, VK_ATTACHMENT_STORE_OP_STORE, VkClearValue{ }),
+            RHIRenderingAttachmentInfo(gbufferA.getView(buildBasicImageSubresource()),
+                VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, VK_ATTACHMENT_LOAD_OP_LOAD, VK_ATTACHMENT_STORE_OP_STORE, VkClearValue{ }),
+            RHIRenderingAttachmentInfo(gbufferB.getView(buildBasicImageSubresource()),
+                VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, VK_ATTACHMENT_LOAD_OP_LOAD, VK_ATTACHMENT_STORE_OP_STORE, VkClearValue{ }),
+            RHIRenderingAttachmentInfo(gbufferS.getView(buildBasicImageSubresource()),
+                VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, VK_ATTACHMENT_LOAD_OP_LOAD, VK_ATTACHMENT_STORE_OP_STORE, VkClearValue{ }),
+            RHIRenderingAttachmentInfo(gbufferV.getView(buildBasicImageSubresource()),
+                VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, VK_ATTACHMENT_LOAD_OP_LOAD, VK_ATTACHMENT_STORE_OP_STORE, VkClearValue{ }),
+        };
+
+        VkRenderingAttachmentInfo depthAttachment = RHIRenderingAttachmentInfo(
+            sceneDepthZ.getView(RHIDefaultImageSubresourceRange(VK_IMAGE_ASPECT_DEPTH_BIT)),
+            VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+            VK_ATTACHMENT_LOAD_OP_LOAD,
+            VK_ATTACHMENT_STORE_OP_STORE,
+            VkClearValue{ }
+        );
+
+        uint32_t renderWidth = hdrSceneColor.getExtent().width;
+        uint32_t renderHeight = hdrSceneColor.getExtent().height;
+
+        const VkRenderingInfo renderInfo
+        {
+            .sType = VK_STRUCTURE_TYPE_RENDERING_INFO_KHR,
+            .renderArea = VkRect2D{.offset {0,0}, .extent {renderWidth, renderHeight}},
+            .layerCount = 1,
+            .colorAttachmentCount = uint32_t(colorAttachments.size()),
+            .pColorAttachments = colorAttachments.data(),
+            .pDepthAttachment = &depthAttachment,
+        };
+
+        VkRect2D scissor{ .offset{ 0,0 }, .extent {renderWidth, renderHeight} };
+        VkViewport viewport
+        {
+            .x = 0.0f, .y = (float)m_renderHeight,
+            .width = (float)renderWidth, .height = -(float)renderHeight,
+            .minDepth = 0.0f, .maxDepth = 1.0f,
+        };
+
+        auto* pass = getPasses()->getPass<LandscapePass>();
+
+        RHI::ScopePerframeMarker landscapeMarker(cmd, "Landscape", { 1.0f, 0.0f, 0.0f, 1.0f });
+        vkCmdBeginRendering(cmd, &renderInfo);
+        {
+            vkCmdSetScissor(cmd, 0, 1, &scissor);
+            vkCmdSetViewport(cmd, 0, 1, &viewport);
+            vkCmdSetDepthBias(cmd, 0, 0, 0);
+
+            vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, pass->pipeline);
+
+            for (const auto& draw : draws)
+            {
+                std::vector<VkDescriptorSet> passSets =
+                {
+                      viewData->buffer.getSet()           // viewData
+                    , frameData->buffer.getSet()          // frameData
+                    , draw.landscapeData->buffer.getSet() // landscapeData
+                    , draw.nodes->buffer.getSet()         // nodes
+                    , draw.pageTable->buffer.getSet()     // pageTable
+                    , Bindless::Texture->getSet()
+                };
+
+                vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, pass->pipelineLayout,
+                    0, (uint32_t)passSets.size(), passSets.data(), 0, nullptr);
+
+                // Node grid build from gl_VertexIndex, node index is gl_InstanceIndex.
+                auto drawNodes = [&](uint32_t gridDim, uint32_t nodeCount, uint32_t firstNode)
+                {
+                    if (nodeCount == 0)
+                    {
+                        return;
+                    }
+
+                    GPULandscapePushConstants pushConstant = { .gridDim = gridDim };
+                    vkCmdPushConstants(cmd, pass->pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(GPULandscapePushConstants), &pushConstant);
+                    vkCmdDraw(cmd, gridDim * gridDim * 6, nodeCount, 0, firstNode);
+                };
+
+                drawNodes(LandscapeQuadtree::kGridDim, draw.fullNodeCount, 0);
+                drawNodes(LandscapeQuadtree::kGridDim / 2, draw.quarterNodeCount, draw.fullNodeCount);
+            }
+
+            m_gpuTimer.getTimeStamp(cmd, "Landscape Rendering");
+        }
+        vkCmdEndRendering(cmd);
+    }
+}
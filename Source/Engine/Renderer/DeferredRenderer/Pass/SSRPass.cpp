@@ -7,7 +7,13 @@
 
 namespace Flower
 {
-
+    static AutoCVarInt32 cVarSSRResolution(
+        "r.SSR.Resolution",
+        "SSR resolution tier, 0 is full, 1 is half, 2 is checkerboard, non full tier bilateral upsample when apply.",
+        "SSR",
+        0,
+        CVarFlags::ReadAndWrite
+    );
 
     struct SSRPush
     {
@@ -16,6 +22,7 @@ namespace Flower
         uint32_t mostDetailedMip = 0;
         float roughnessThreshold; // Max roughness stop to reflection sample.
         float temporalVarianceThreshold;
+        uint32_t resolutionMode;
     };
 
     struct SSRRayCounterSSBO
@@ -446,7 +453,12 @@ namespace Flower
 
         auto* pass = getPasses()->getPass<SSRPass>();
 
-        pass->updateRTsBeforeRender(sceneDepthZ.getExtent().width, sceneDepthZ.getExtent().height, m_rtPool.get(), cmd);
+        // Ssr work images follow resolution tier, history rebuild when tier change.
+        const auto resolution = getScreenSpaceResolution(cVarSSRResolution.get());
+        const uint32_t ssrWidth = (resolution == EScreenSpaceResolution::Full) ? sceneDepthZ.getExtent().width : divideRoundingUp(sceneDepthZ.getExtent().width, 2u);
+        const uint32_t ssrHeight = (resolution == EScreenSpaceResolution::Half) ? divideRoundingUp(sceneDepthZ.getExtent().height, 2u) : sceneDepthZ.getExtent().height;
+
+        pass->updateRTsBeforeRender(ssrWidth, ssrHeight, m_rtPool.get(), cmd);
 
         
         VkDescriptorImageInfo ssrReprojectImageInfo = RHIDescriptorImageInfoStorage(pass->rt_ssrReproject->getImage().getView(buildBasicImageSubresource()));
@@ -489,7 +501,7 @@ namespace Flower
 
 
 
-        const uint32_t maxRayCount = sceneDepthZ.getExtent().width* sceneDepthZ.getExtent().height; // Max case is one pixel one ray.
+        const uint32_t maxRayCount = sceneDepthZ.getExtent().width* sceneDepthZ.getExtent().height; // Max case is one pixel one ray, keep render size so buffer no realloc when tier change.
         const uint32_t maxDenoiseListCount = maxRayCount / (8 * 8) + 1; // Tile run in 8x8.
 
         auto ssboCounterBuffer = getBuffers()->getStaticStorage("ssrCounterBuffer", sizeof(SSRRayCounterSSBO));
@@ -602,6 +614,7 @@ namespace Flower
             .mostDetailedMip = 0,
             .roughnessThreshold = 0.2f,
             .temporalVarianceThreshold = 0.0f,
+            .resolutionMode = (uint32_t)resolution,
         };
         vkCmdPushConstants(cmd, pass->pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(pushConst), &pushConst);
 
@@ -728,6 +741,8 @@ namespace Flower
 
         pass->swapRTAfterRender();
 
-        m_gpuTimer.getTimeStamp(cmd, "SSR");
+        constexpr const char* kTimeStampNames[] = { "SSR Full", "SSR Half", "SSR Checkerboard" };
+        static_assert(std::size(kTimeStampNames) == size_t(EScreenSpaceResolution::Max));
+        m_gpuTimer.getTimeStamp(cmd, kTimeStampNames[size_t(resolution)]);
     }
 }
\ No newline at end of file
@@ -11,6 +11,12 @@ namespace Flower
 {
 	// Sample distribution shadow map implement here.
 
+	// Static cache fit cascades on cpu from shadow draw distance, not scene depth range.
+	static AutoCVarInt32 cVarSDSMStaticCache("r.SDSM.StaticCache", "Cache static node shadow depth per cascade.", "SDSM", 0, CVarFlags::ReadAndWrite);
+
+	static AutoCVarCmd cVarSDSMCacheStat("cmd.SDSM.CacheStat", "Print sdsm static cache cascades reused, scrolled and redrawn count.");
+	static AutoCVarCmd cVarSDSMCacheValidate("cmd.SDSMCache.Validate", "Check sdsm static cache reuse, scroll reprojection and invalidation on cpu.");
+
 	struct GPUDepthRange
 	{
 		uint32_t minDepth;
@@ -21,6 +27,9 @@ namespace Flower
 	{
 		uint32_t cullCountPercascade;
 		uint32_t cascadeCount;
+
+		// First culling object id, objects of static scene node cull separately when static cache enable.
+		uint32_t objectOffset;
 	};
 
 	struct DepthDrawPushConst
@@ -307,11 +316,23 @@ namespace Flower
 		BufferParamRefPointer& viewData,
 		BufferParamRefPointer& frameData)
 	{
+		CVarCmdHandle(cVarSDSMCacheValidate, []()
+		{
+			CachedShadowCascade::validate();
+		});
+
 		if (m_cacheFrameData.bSdsmDraw <= 0)
 		{
 			return;
 		}
 
+		CVarCmdHandle(cVarSDSMCacheStat, [&]()
+		{
+			LOG_INFO("SDSM static cache last frame: {0} cascades reused, {1} scrolled, {2} redrawn. Total: {3} reused, {4} scrolled, {5} redrawn.",
+				m_sdsmStaticCache.reusedCount, m_sdsmStaticCache.scrolledCount, m_sdsmStaticCache.redrawnCount,
+				m_sdsmStaticCache.totalReusedCount, m_sdsmStaticCache.totalScrolledCount, m_sdsmStaticCache.totalRedrawnCount);
+		});
+
 		uint32_t staticMeshCount = m_cacheFrameData.staticMeshCount;
 		const auto& importantLights = scene->getImportanceLights();
 
@@ -355,216 +376,448 @@ namespace Flower
 			RHIPushWriteDescriptorSetImage(7, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, &imageShadowMask),
 		};
 
-		// Compute depth range.
+		struct CascadeIndirectDraw
 		{
-			RHI::ScopePerframeMarker depthRangeComputeMarker(cmd, "DepthRangeCompute", { 1.0f, 0.0f, 0.0f, 1.0f });
+			BufferParamRefPointer commands;
+			BufferParamRefPointer counts;
+			uint32_t objectCount;
+		};
 
-			GPUDepthRange clearRangeValue = { .minDepth = ~0u, .maxDepth = 0u };
-			vkCmdUpdateBuffer(cmd, *rangeBuffer->buffer.getBuffer(), 0, rangeBuffer->buffer.getBuffer()->getSize(), &clearRangeValue);
-			std::array<VkBufferMemoryBarrier2, 1> fillBarriers
+		// Culling objects [objectOffset, objectOffset + objectCount) for all cascades.
+		auto cullObjects = [&](const char* commandName, const char* countName, uint32_t objectOffset, uint32_t objectCount)
+		{
+			const auto cullingCount = lightInfo.cascadeCount * objectCount;
+
+			CascadeIndirectDraw result { };
+			result.objectCount = objectCount;
+			result.commands = getBuffers()->getIndirectStorage(commandName, cullingCount * sizeof(GPUDrawIndirectCommand));
+			result.counts = getBuffers()->getIndirectStorage(countName, sizeof(GPUDrawIndirectCount) * lightInfo.cascadeCount);
+
+			RHI::ScopePerframeMarker staticMeshGBufferCullingMarker(cmd, "SDSMCulling", { 1.0f, 0.0f, 0.0f, 1.0f });
+
+			vkCmdFillBuffer(cmd, *result.counts->buffer.getBuffer(), 0, result.counts->buffer.getBuffer()->getSize(), 0u);
+			vkCmdFillBuffer(cmd, *result.commands->buffer.getBuffer(), 0, result.commands->buffer.getBuffer()->getSize(), 0u);
+			std::array<VkBufferMemoryBarrier2, 2> fillBarriers
 			{
-				RHIBufferBarrier(rangeBuffer->buffer.getBuffer()->getVkBuffer(),
+				RHIBufferBarrier(result.commands->buffer.getBuffer()->getVkBuffer(),
+					VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT,
+					VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT),
+
+				RHIBufferBarrier(result.counts->buffer.getBuffer()->getVkBuffer(),
 					VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT,
 					VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT),
 			};
 			RHIPipelineBarrier(cmd, 0, (uint32_t)fillBarriers.size(), fillBarriers.data(), 0, nullptr);
 
-			vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pass->depthRangePipeline);
-
-			// Push owner set #0.
-			RHI::PushDescriptorSetKHR(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pass->depthRangePipelineLayout, 0, uint32_t(writes.size()), writes.data());
-
-			// Block dim is 3x3.
-			vkCmdDispatch(cmd, 
-				getGroupCount(sceneDepthZ.getExtent().width / 3 + 1, 8), 
-				getGroupCount(sceneDepthZ.getExtent().height / 3 + 1, 8), 1);
-			m_gpuTimer.getTimeStamp(cmd, "DepthRangeCompute");
-
-			VkBufferMemoryBarrier2 endBufferBarrier = RHIBufferBarrier(rangeBuffer->buffer.getBuffer()->getVkBuffer(),
-				VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_MEMORY_WRITE_BIT,
-				VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT);
-			RHIPipelineBarrier(cmd, 0, 1, &endBufferBarrier, 0, nullptr);
-		}
-
-		// Prepare cascade.
-		{
-			RHI::ScopePerframeMarker buildCascadeMarker(cmd, "PrepareCascadeInfo", { 1.0f, 0.0f, 0.0f, 1.0f });
-			vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pass->cascadeBuildPipeline);
-
-			RHI::PushDescriptorSetKHR(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pass->cascadeBuildPipelineLayout, 0, uint32_t(writes.size()), writes.data());
+			CascadeCullingPushConst gpuPushConstant =
+			{
+				.cullCountPercascade = objectCount,
+				.cascadeCount = lightInfo.cascadeCount,
+				.objectOffset = objectOffset,
+			};
+			vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pass->cullingPipeline);
+			vkCmdPushConstants(cmd, pass->cullingPipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(CascadeCullingPushConst), &gpuPushConstant);
 
+			// Set #0.
+			RHI::PushDescriptorSetKHR(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pass->cullingPipelineLayout, 0, uint32_t(writes.size()), writes.data());
+			
 			std::vector<VkDescriptorSet> compPassSets =
 			{
-				  viewData->buffer.getSet() 
-				, frameData->buffer.getSet()       
+				  scene->getStaticMeshesObjectsPtr()->buffer.getSet() // objectDatas
+				, result.commands->buffer.getSet()                    // indirectCommands
+				, result.counts->buffer.getSet()                      // drawCount
 			};
 
-			// Set #1..2
+			// Set #1..3
 			vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE,
-				pass->cascadeBuildPipelineLayout, 1,
+				pass->cullingPipelineLayout, 1,
 				(uint32_t)compPassSets.size(), compPassSets.data(),
 				0, nullptr
 			);
+			vkCmdDispatch(cmd, getGroupCount(cullingCount, 64), 1, 1);
 
-			vkCmdDispatch(cmd, getGroupCount(GMaxCascadePerDirectionalLight, 32), 1, 1);
-			m_gpuTimer.getTimeStamp(cmd, "PrepareCascade");
+			m_gpuTimer.getTimeStamp(cmd, "SDSM Culling");
 
-			VkBufferMemoryBarrier2 endBufferBarrier = RHIBufferBarrier(cascadeInfoBuffer->buffer.getBuffer()->getVkBuffer(),
-				VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_MEMORY_WRITE_BIT,
-				VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT);
-			RHIPipelineBarrier(cmd, 0, 1, &endBufferBarrier, 0, nullptr);
-		}
+			// End buffer barrier.
+			std::array<VkBufferMemoryBarrier2, 2> endBufferBarriers
+			{
+				RHIBufferBarrier(result.commands->buffer.getBuffer()->getVkBuffer(),
+					VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_MEMORY_WRITE_BIT,
+					VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_SHADER_READ_BIT),
+
+				RHIBufferBarrier(result.counts->buffer.getBuffer()->getVkBuffer(),
+					VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_MEMORY_WRITE_BIT,
+					VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT, VK_ACCESS_INDIRECT_COMMAND_READ_BIT),
+			};
+			RHIPipelineBarrier(cmd, 0, (uint32_t)endBufferBarriers.size(), endBufferBarriers.data(), 0, nullptr);
+
+			return result;
+		};
+
+		struct CascadeDrawRect
+		{
+			uint32_t cascadeId;
+
+			// Scissor in cascade texel space.
+			VkRect2D scissor;
+		};
 
-		// Draw SDSM for directional lights.
+		// Draw culled objects into atlas, every rect draw its cascade objects with scissor.
+		auto renderDepth = [&](const CascadeIndirectDraw& draw, const std::vector<CascadeDrawRect>& rects, VkAttachmentLoadOp loadOp)
 		{
-			const auto cullingCount = lightInfo.cascadeCount * staticMeshCount;
+			SDSMDepth->getImage().transitionLayout(cmd, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL, RHIDefaultImageSubresourceRange(VK_IMAGE_ASPECT_DEPTH_BIT));
 
-			auto indirectDrawCommandBuffer = getBuffers()->getIndirectStorage("SDSMMeshIndirectCommand",
-				cullingCount * sizeof(GPUDrawIndirectCommand));
+			RHI::ScopePerframeMarker staticMeshGBufferMarker(cmd, "SDSMShadowDepth", { 1.0f, 0.0f, 0.0f, 1.0f });
 
-			auto indirectDrawCountBuffer = getBuffers()->getIndirectStorage("SDSMMeshIndirectCount",
-				sizeof(GPUDrawIndirectCount) * lightInfo.cascadeCount);
+			VkRenderingAttachmentInfo depthAttachment = RHIRenderingAttachmentInfo(
+				SDSMDepth->getImage().getView(RHIDefaultImageSubresourceRange(VK_IMAGE_ASPECT_DEPTH_BIT)),
+				VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+				loadOp,
+				VK_ATTACHMENT_STORE_OP_STORE,
+				VkClearValue{ .depthStencil = {0.0f, 1} }
+			);
 
-			// Culling.
+			const VkRenderingInfo renderInfo
 			{
-				RHI::ScopePerframeMarker staticMeshGBufferCullingMarker(cmd, "SDSMCulling", { 1.0f, 0.0f, 0.0f, 1.0f });
+				.sType = VK_STRUCTURE_TYPE_RENDERING_INFO_KHR,
+				.renderArea = VkRect2D{.offset {0,0}, .extent {.width = SDSMDepth->getImage().getExtent().width, .height = SDSMDepth->getImage().getExtent().height }},
+				.layerCount = 1,
+				.colorAttachmentCount = 0,
+				.pColorAttachments = nullptr,
+				.pDepthAttachment = &depthAttachment,
+			};
+
+			vkCmdBeginRendering(cmd, &renderInfo);
+			{
+				vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, pass->depthRenderPipeline);
+
+				// Set #0.
+				RHI::PushDescriptorSetKHR(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, pass->depthRenderPipelineLayout, 0, uint32_t(writes.size()), writes.data());
 
-				vkCmdFillBuffer(cmd, *indirectDrawCountBuffer->buffer.getBuffer(), 0, indirectDrawCountBuffer->buffer.getBuffer()->getSize(), 0u);
-				vkCmdFillBuffer(cmd, *indirectDrawCommandBuffer->buffer.getBuffer(), 0, indirectDrawCommandBuffer->buffer.getBuffer()->getSize(), 0u);
-				std::array<VkBufferMemoryBarrier2, 2> fillBarriers
+				std::vector<VkDescriptorSet> meshPassSets =
 				{
-					RHIBufferBarrier(indirectDrawCommandBuffer->buffer.getBuffer()->getVkBuffer(),
-						VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT,
-						VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT),
+					  MeshManager::get()->getBindlessVertexBuffers()->getSet() // verticesArray
+					, MeshManager::get()->getBindlessIndexBuffers()->getSet() // indicesArray
+					, Bindless::Texture->getSet()
+					, Bindless::Sampler->getSet()
+					, scene->getStaticMeshesObjectsPtr()->buffer.getSet() // objectDatas
+					, draw.commands->buffer.getSet() // indirectCommands
+				};
+				// Set #1...#6
+				vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, pass->depthRenderPipelineLayout,
+					1, (uint32_t)meshPassSets.size(), meshPassSets.data(), 0, nullptr);
+
+				// Set depth bias for shadow depth rendering to avoid shadow artifact.
+				vkCmdSetDepthBias(cmd, lightInfo.shadowBiasConst, 0, lightInfo.shadowBiasSlope);
+
+				for (const auto& rect : rects)
+				{
+					const uint32_t cascadeIndex = rect.cascadeId;
+
+					VkRect2D scissor = rect.scissor;
+					scissor.offset.x += int32_t(lightInfo.perCascadeXYDim * cascadeIndex);
+
+					VkViewport viewport{};
+					viewport.minDepth = 0.0f;
+					viewport.maxDepth = 1.0f;
+					viewport.y = (float)lightInfo.perCascadeXYDim;
+					viewport.height = -(float)lightInfo.perCascadeXYDim;
+					viewport.x = (float)lightInfo.perCascadeXYDim * (float)cascadeIndex;
+					viewport.width = (float)lightInfo.perCascadeXYDim;
+
+					vkCmdSetScissor(cmd, 0, 1, &scissor);
+					vkCmdSetViewport(cmd, 0, 1, &viewport);
+
+					DepthDrawPushConst pushConst{ .cascadeId = cascadeIndex, .perCascadeMaxCount = draw.objectCount };
+					vkCmdPushConstants(cmd, pass->depthRenderPipelineLayout, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(DepthDrawPushConst), &pushConst);
+
+					vkCmdDrawIndirectCount(cmd,
+						draw.commands->buffer.getBuffer()->getVkBuffer(), 
+						cascadeIndex * sizeof(GPUDrawIndirectCommand) * draw.objectCount,
+						draw.counts->buffer.getBuffer()->getVkBuffer(),
+						cascadeIndex * sizeof(GPUDrawIndirectCount),
+						draw.objectCount,
+						sizeof(GPUDrawIndirectCommand)
+					);
+				}
+				m_gpuTimer.getTimeStamp(cmd, "SDSMDepthRendering");
+
+			}
+			vkCmdEndRendering(cmd);
+		};
+
+		const VkRect2D cascadeRect = { .offset = { 0, 0 }, .extent = { lightInfo.perCascadeXYDim, lightInfo.perCascadeXYDim } };
+
+		if (cVarSDSMStaticCache.get() == 0)
+		{
+			// Release cache when disable.
+			m_sdsmStaticCache = { };
 
-					RHIBufferBarrier(indirectDrawCountBuffer->buffer.getBuffer()->getVkBuffer(),
+			// Compute depth range.
+			{
+				RHI::ScopePerframeMarker depthRangeComputeMarker(cmd, "DepthRangeCompute", { 1.0f, 0.0f, 0.0f, 1.0f });
+
+				GPUDepthRange clearRangeValue = { .minDepth = ~0u, .maxDepth = 0u };
+				vkCmdUpdateBuffer(cmd, *rangeBuffer->buffer.getBuffer(), 0, rangeBuffer->buffer.getBuffer()->getSize(), &clearRangeValue);
+				std::array<VkBufferMemoryBarrier2, 1> fillBarriers
+				{
+					RHIBufferBarrier(rangeBuffer->buffer.getBuffer()->getVkBuffer(),
 						VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT,
 						VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT),
 				};
 				RHIPipelineBarrier(cmd, 0, (uint32_t)fillBarriers.size(), fillBarriers.data(), 0, nullptr);
 
-				CascadeCullingPushConst gpuPushConstant =
-				{
-					.cullCountPercascade = staticMeshCount,
-					.cascadeCount = lightInfo.cascadeCount,
-				};
-				vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pass->cullingPipeline);
-				vkCmdPushConstants(cmd, pass->cullingPipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(CascadeCullingPushConst), &gpuPushConstant);
+				vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pass->depthRangePipeline);
+
+				// Push owner set #0.
+				RHI::PushDescriptorSetKHR(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pass->depthRangePipelineLayout, 0, uint32_t(writes.size()), writes.data());
+
+				// Block dim is 3x3.
+				vkCmdDispatch(cmd, 
+					getGroupCount(sceneDepthZ.getExtent().width / 3 + 1, 8), 
+					getGroupCount(sceneDepthZ.getExtent().height / 3 + 1, 8), 1);
+				m_gpuTimer.getTimeStamp(cmd, "DepthRangeCompute");
+
+				VkBufferMemoryBarrier2 endBufferBarrier = RHIBufferBarrier(rangeBuffer->buffer.getBuffer()->getVkBuffer(),
+					VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_MEMORY_WRITE_BIT,
+					VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT);
+				RHIPipelineBarrier(cmd, 0, 1, &endBufferBarrier, 0, nullptr);
+			}
+
+			// Prepare cascade.
+			{
+				RHI::ScopePerframeMarker buildCascadeMarker(cmd, "PrepareCascadeInfo", { 1.0f, 0.0f, 0.0f, 1.0f });
+				vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pass->cascadeBuildPipeline);
+
+				RHI::PushDescriptorSetKHR(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pass->cascadeBuildPipelineLayout, 0, uint32_t(writes.size()), writes.data());
 
-				// Set #0.
-				RHI::PushDescriptorSetKHR(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pass->cullingPipelineLayout, 0, uint32_t(writes.size()), writes.data());
-				
 				std::vector<VkDescriptorSet> compPassSets =
 				{
-					  scene->getStaticMeshesObjectsPtr()->buffer.getSet() // objectDatas
-					, indirectDrawCommandBuffer->buffer.getSet()          // indirectCommands
-					, indirectDrawCountBuffer->buffer.getSet()            // drawCount
+					  viewData->buffer.getSet() 
+					, frameData->buffer.getSet()       
 				};
 
-				// Set #1..3
+				// Set #1..2
 				vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE,
-					pass->cullingPipelineLayout, 1,
+					pass->cascadeBuildPipelineLayout, 1,
 					(uint32_t)compPassSets.size(), compPassSets.data(),
 					0, nullptr
 				);
-				vkCmdDispatch(cmd, getGroupCount(cullingCount, 64), 1, 1);
 
-				m_gpuTimer.getTimeStamp(cmd, "SDSM Culling");
+				vkCmdDispatch(cmd, getGroupCount(GMaxCascadePerDirectionalLight, 32), 1, 1);
+				m_gpuTimer.getTimeStamp(cmd, "PrepareCascade");
 
-				// End buffer barrier.
-				std::array<VkBufferMemoryBarrier2, 2> endBufferBarriers
+				VkBufferMemoryBarrier2 endBufferBarrier = RHIBufferBarrier(cascadeInfoBuffer->buffer.getBuffer()->getVkBuffer(),
+					VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_MEMORY_WRITE_BIT,
+					VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT);
+				RHIPipelineBarrier(cmd, 0, 1, &endBufferBarrier, 0, nullptr);
+			}
+
+			// Draw SDSM for directional lights.
+			{
+				const auto draw = cullObjects("SDSMMeshIndirectCommand", "SDSMMeshIndirectCount", 0, staticMeshCount);
+
+				std::vector<CascadeDrawRect> rects(lightInfo.cascadeCount);
+				for (uint32_t cascadeIndex = 0; cascadeIndex < lightInfo.cascadeCount; cascadeIndex++)
 				{
-					RHIBufferBarrier(indirectDrawCommandBuffer->buffer.getBuffer()->getVkBuffer(),
-						VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_MEMORY_WRITE_BIT,
-						VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_SHADER_READ_BIT),
+					rects[cascadeIndex] = { cascadeIndex, cascadeRect };
+				}
+				renderDepth(draw, rects, VK_ATTACHMENT_LOAD_OP_CLEAR);
+			}
+		}
+		else
+		{
+			auto& cache = m_sdsmStaticCache;
+			const uint32_t staticObjectCount = scene->getStaticObjectCount();
+			const uint32_t movableObjectCount = staticMeshCount - staticObjectCount;
+
+			// Stable cascades fit on cpu, scene depth range no use here.
+			auto cascades = CachedShadowCascade::fitCascades(m_cacheViewData, lightInfo);
+			std::vector<GPUCascadeInfo> cascadeInfos(cascades.size());
+			for (size_t i = 0; i < cascades.size(); i++)
+			{
+				cascades[i].key.staticHash = scene->getStaticObjectHash();
+				cascadeInfos[i] = cascades[i].info;
+			}
 
-					RHIBufferBarrier(indirectDrawCountBuffer->buffer.getBuffer()->getVkBuffer(),
-						VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_MEMORY_WRITE_BIT,
-						VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT, VK_ACCESS_INDIRECT_COMMAND_READ_BIT),
-				};
-				RHIPipelineBarrier(cmd, 0, (uint32_t)endBufferBarriers.size(), endBufferBarriers.data(), 0, nullptr);
+			{
+				vkCmdUpdateBuffer(cmd, *cascadeInfoBuffer->buffer.getBuffer(), 0, sizeof(GPUCascadeInfo) * cascadeInfos.size(), cascadeInfos.data());
+
+				VkBufferMemoryBarrier2 endBufferBarrier = RHIBufferBarrier(cascadeInfoBuffer->buffer.getBuffer()->getVkBuffer(),
+					VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT,
+					VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT);
+				RHIPipelineBarrier(cmd, 0, 1, &endBufferBarrier, 0, nullptr);
 			}
 
-			// Render Depth.
-			SDSMDepth->getImage().transitionLayout(cmd, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL, RHIDefaultImageSubresourceRange(VK_IMAGE_ASPECT_DEPTH_BIT));
+			// Cache image same layout with atlas, all cascades invalid when recreate.
+			auto& atlas = SDSMDepth->getImage();
+			if (!cache.depth || 
+				cache.depth->getImage().getExtent().width != atlas.getExtent().width || 
+				cache.depth->getImage().getExtent().height != atlas.getExtent().height)
 			{
-				RHI::ScopePerframeMarker staticMeshGBufferMarker(cmd, "SDSMShadowDepth", { 1.0f, 0.0f, 0.0f, 1.0f });
-
-				VkRenderingAttachmentInfo depthAttachment = RHIRenderingAttachmentInfo(
-					SDSMDepth->getImage().getView(RHIDefaultImageSubresourceRange(VK_IMAGE_ASPECT_DEPTH_BIT)),
-					VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
-					VK_ATTACHMENT_LOAD_OP_CLEAR,
-					VK_ATTACHMENT_STORE_OP_STORE,
-					VkClearValue{ .depthStencil = {0.0f, 1} }
-				);
+				cache.depth = m_rtPool->createPoolImage(
+					"SDSMStaticCache",
+					atlas.getExtent().width,
+					atlas.getExtent().height,
+					RTFormats::depth(),
+					VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT);
+
+				cache.cascades.clear();
+			}
+			if (cache.cascades.size() != cascades.size())
+			{
+				cache.cascades.clear();
+			}
+			auto& cacheImage = cache.depth->getImage();
 
+			cache.reusedCount = 0;
+			cache.scrolledCount = 0;
+			cache.redrawnCount = 0;
+			std::vector<CachedShadowCascade::CascadeUpdate> updates(cascades.size());
+			for (size_t i = 0; i < cascades.size(); i++)
+			{
+				updates[i] = cache.cascades.empty()
+					? CachedShadowCascade::CascadeUpdate{ CachedShadowCascade::EUpdateType::Redraw, glm::ivec2(0) }
+					: CachedShadowCascade::getUpdate(cache.cascades[i], cascades[i].key);
 
-				const VkRenderingInfo renderInfo
+				switch (updates[i].type)
 				{
-					.sType = VK_STRUCTURE_TYPE_RENDERING_INFO_KHR,
-					.renderArea = VkRect2D{.offset {0,0}, .extent {.width = SDSMDepth->getImage().getExtent().width, .height = SDSMDepth->getImage().getExtent().height }},
-					.layerCount = 1,
-					.colorAttachmentCount = 0,
-					.pColorAttachments = nullptr,
-					.pDepthAttachment = &depthAttachment,
-				};
+				case CachedShadowCascade::EUpdateType::Reuse:  cache.reusedCount++;   break;
+				case CachedShadowCascade::EUpdateType::Scroll: cache.scrolledCount++; break;
+				case CachedShadowCascade::EUpdateType::Redraw: cache.redrawnCount++;  break;
+				}
+			}
+			cache.totalReusedCount += cache.reusedCount;
+			cache.totalScrolledCount += cache.scrolledCount;
+			cache.totalRedrawnCount += cache.redrawnCount;
 
-				vkCmdBeginRendering(cmd, &renderInfo);
+			const uint32_t dim = lightInfo.perCascadeXYDim;
+			const VkImageSubresourceRange depthRange = RHIDefaultImageSubresourceRange(VK_IMAGE_ASPECT_DEPTH_BIT);
+			const VkImageSubresourceLayers depthLayers = { .aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT, .mipLevel = 0, .baseArrayLayer = 0, .layerCount = 1 };
+
+			// Restore cached static depth, redraw part keep clear value.
+			{
+				RHI::ScopePerframeMarker marker(cmd, "SDSMStaticCacheRestore", { 1.0f, 0.0f, 0.0f, 1.0f });
+
+				atlas.transitionLayout(cmd, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, depthRange);
+				cacheImage.transitionLayout(cmd, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, depthRange);
+
+				VkClearDepthStencilValue clearValue = { .depth = 0.0f, .stencil = 0 };
+				vkCmdClearDepthStencilImage(cmd, atlas.getImage(), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, &clearValue, 1, &depthRange);
+
+				VkImageMemoryBarrier2 clearBarrier = RHIImageBarrier(atlas.getImage(),
+					VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+					VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+					VK_IMAGE_ASPECT_DEPTH_BIT, 0, 1);
+				RHIPipelineBarrier(cmd, 0, 0, nullptr, 1, &clearBarrier);
+
+				std::vector<VkImageCopy> regions;
+				for (uint32_t cascadeIndex = 0; cascadeIndex < cascades.size(); cascadeIndex++)
 				{
-					vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, pass->depthRenderPipeline);
+					if (updates[cascadeIndex].type == CachedShadowCascade::EUpdateType::Redraw)
+					{
+						continue;
+					}
 
-					// Set #0.
-					RHI::PushDescriptorSetKHR(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, pass->depthRenderPipelineLayout, 0, uint32_t(writes.size()), writes.data());
+					// Scroll copy overlap part only, reuse offset is zero.
+					const glm::ivec2 offset = updates[cascadeIndex].offset;
+					regions.push_back(VkImageCopy
+					{
+						.srcSubresource = depthLayers,
+						.srcOffset = { int32_t(dim * cascadeIndex) + glm::max(offset.x, 0), glm::max(offset.y, 0), 0 },
+						.dstSubresource = depthLayers,
+						.dstOffset = { int32_t(dim * cascadeIndex) + glm::max(-offset.x, 0), glm::max(-offset.y, 0), 0 },
+						.extent = { dim - uint32_t(glm::abs(offset.x)), dim - uint32_t(glm::abs(offset.y)), 1 },
+					});
+				}
 
-					std::vector<VkDescriptorSet> meshPassSets =
+				if (!regions.empty())
+				{
+					vkCmdCopyImage(cmd, 
+						cacheImage.getImage(), VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, 
+						atlas.getImage(), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 
+						uint32_t(regions.size()), regions.data());
+				}
+				m_gpuTimer.getTimeStamp(cmd, "SDSMStaticCacheRestore");
+			}
+
+			// Draw static objects on redraw cascades and scroll expose strips.
+			std::vector<CascadeDrawRect> staticRects;
+			for (uint32_t cascadeIndex = 0; cascadeIndex < cascades.size(); cascadeIndex++)
+			{
+				if (updates[cascadeIndex].type == CachedShadowCascade::EUpdateType::Redraw)
+				{
+					staticRects.push_back({ cascadeIndex, cascadeRect });
+				}
+				else if (updates[cascadeIndex].type == CachedShadowCascade::EUpdateType::Scroll)
+				{
+					VkRect2D exposeRects[2];
+					const uint32_t rectCount = CachedShadowCascade::getScrollExposeRects(dim, updates[cascadeIndex].offset, exposeRects);
+					for (uint32_t i = 0; i < rectCount; i++)
 					{
-						  MeshManager::get()->getBindlessVertexBuffers()->getSet() // verticesArray
-						, MeshManager::get()->getBindlessIndexBuffers()->getSet() // indicesArray
-						, Bindless::Texture->getSet()
-						, Bindless::Sampler->getSet()
-						, scene->getStaticMeshesObjectsPtr()->buffer.getSet() // objectDatas
-						, indirectDrawCommandBuffer->buffer.getSet() // indirectCommands
-					};
-					// Set #1...#6
-					vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, pass->depthRenderPipelineLayout,
-						1, (uint32_t)meshPassSets.size(), meshPassSets.data(), 0, nullptr);
-
-					// Set depth bias for shadow depth rendering to avoid shadow artifact.
-					vkCmdSetDepthBias(cmd, lightInfo.shadowBiasConst, 0, lightInfo.shadowBiasSlope);
-
-					for (uint32_t cascadeIndex = 0; cascadeIndex < lightInfo.cascadeCount; cascadeIndex++)
+						staticRects.push_back({ cascadeIndex, exposeRects[i] });
+					}
+				}
+			}
+			if (!staticRects.empty() && staticObjectCount > 0)
+			{
+				const auto staticDraw = cullObjects("SDSMStaticMeshIndirectCommand", "SDSMStaticMeshIndirectCount", 0, staticObjectCount);
+				renderDepth(staticDraw, staticRects, VK_ATTACHMENT_LOAD_OP_LOAD);
+			}
+
+			// Store changed cascades back to cache before movable objects draw.
+			{
+				std::vector<VkImageCopy> regions;
+				for (uint32_t cascadeIndex = 0; cascadeIndex < cascades.size(); cascadeIndex++)
+				{
+					if (updates[cascadeIndex].type == CachedShadowCascade::EUpdateType::Reuse)
 					{
-						VkRect2D scissor{};
-						scissor.extent = { lightInfo.perCascadeXYDim, lightInfo.perCascadeXYDim };
-						scissor.offset = { int32_t(lightInfo.perCascadeXYDim * cascadeIndex), 0 };
-
-						VkViewport viewport{};
-						viewport.minDepth = 0.0f;
-						viewport.maxDepth = 1.0f;
-						viewport.y = (float)lightInfo.perCascadeXYDim;
-						viewport.height = -(float)lightInfo.perCascadeXYDim;
-						viewport.x = (float)lightInfo.perCascadeXYDim * (float)cascadeIndex;
-						viewport.width = (float)lightInfo.perCascadeXYDim;
-
-						vkCmdSetScissor(cmd, 0, 1, &scissor);
-						vkCmdSetViewport(cmd, 0, 1, &viewport);
-
-						DepthDrawPushConst pushConst{ .cascadeId = cascadeIndex, .perCascadeMaxCount = staticMeshCount };
-						vkCmdPushConstants(cmd, pass->depthRenderPipelineLayout, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(DepthDrawPushConst), &pushConst);
-
-						vkCmdDrawIndirectCount(cmd,
-							indirectDrawCommandBuffer->buffer.getBuffer()->getVkBuffer(), 
-							cascadeIndex * sizeof(GPUDrawIndirectCommand) * staticMeshCount,
-							indirectDrawCountBuffer->buffer.getBuffer()->getVkBuffer(),
-							cascadeIndex * sizeof(GPUDrawIndirectCount),
-							staticMeshCount,
-							sizeof(GPUDrawIndirectCommand)
-						);
+						continue;
 					}
-					m_gpuTimer.getTimeStamp(cmd, "SDSMDepthRendering");
 
+					regions.push_back(VkImageCopy
+					{
+						.srcSubresource = depthLayers,
+						.srcOffset = { int32_t(dim * cascadeIndex), 0, 0 },
+						.dstSubresource = depthLayers,
+						.dstOffset = { int32_t(dim * cascadeIndex), 0, 0 },
+						.extent = { dim, dim, 1 },
+					});
+				}
+
+				if (!regions.empty())
+				{
+					RHI::ScopePerframeMarker marker(cmd, "SDSMStaticCacheStore", { 1.0f, 0.0f, 0.0f, 1.0f });
+
+					atlas.transitionLayout(cmd, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, depthRange);
+					cacheImage.transitionLayout(cmd, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, depthRange);
+
+					vkCmdCopyImage(cmd,
+						atlas.getImage(), VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+						cacheImage.getImage(), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+						uint32_t(regions.size()), regions.data());
+
+					m_gpuTimer.getTimeStamp(cmd, "SDSMStaticCacheStore");
+				}
+
+				cache.cascades.resize(cascades.size());
+				for (size_t i = 0; i < cascades.size(); i++)
+				{
+					cache.cascades[i] = cascades[i].key;
+				}
+			}
+
+			// Movable objects composite on top every frame.
+			if (movableObjectCount > 0)
+			{
+				const auto movableDraw = cullObjects("SDSMMeshIndirectCommand", "SDSMMeshIndirectCount", staticObjectCount, movableObjectCount);
+
+				std::vector<CascadeDrawRect> rects(lightInfo.cascadeCount);
+				for (uint32_t cascadeIndex = 0; cascadeIndex < lightInfo.cascadeCount; cascadeIndex++)
+				{
+					rects[cascadeIndex] = { cascadeIndex, cascadeRect };
 				}
-				vkCmdEndRendering(cmd);
+				renderDepth(movableDraw, rects, VK_ATTACHMENT_LOAD_OP_LOAD);
 			}
 		}
 
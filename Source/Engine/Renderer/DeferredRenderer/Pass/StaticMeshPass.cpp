@@ -9,9 +9,15 @@
 
 namespace Flower
 {
+    static AutoCVarInt32 cVarMeshLodEnable("r.MeshLOD.Enable", "Enable static mesh lod select in gbuffer culling.", "MeshLOD", 1, CVarFlags::ReadAndWrite);
+    static AutoCVarFloat cVarMeshLodPixelError("r.MeshLOD.PixelError", "Max lod screen space error in pixel.", "MeshLOD", 1.0f, CVarFlags::ReadAndWrite);
+
     struct GPUCullingPushConstants
     {
         uint32_t cullCount;
+
+        // Object space error to pixel error scale at unit distance, zero disable lod.
+        float lodErrorScale;
     };
 
     class StaticMeshPass : public PassInterface
@@ -22,37 +28,53 @@ namespace Flower
         VkPipeline gbufferPipeline = VK_NULL_HANDLE;
         VkPipelineLayout gbufferPipelineLayout = VK_NULL_HANDLE;
 
+        // Instance batch path, see StaticMeshInstancing.h.
+        VkPipeline instanceCullingPipeline = VK_NULL_HANDLE;
+        VkPipelineLayout instanceCullingPipelineLayout = VK_NULL_HANDLE;
+        VkPipeline gbufferInstancedPipeline = VK_NULL_HANDLE;
+        VkPipelineLayout gbufferInstancedPipelineLayout = VK_NULL_HANDLE;
+
     protected:
         virtual void init() override
         {
-            initCulling();
-            initGBuffer();
+            initCulling(false, cullingPipeline, cullingPipelineLayout);
+            initCulling(true, instanceCullingPipeline, instanceCullingPipelineLayout);
+            initGBuffer(false, gbufferPipeline, gbufferPipelineLayout);
+            initGBuffer(true, gbufferInstancedPipeline, gbufferInstancedPipelineLayout);
         }
 
         virtual void release() override
         {
             RHISafeRelease(cullingPipeline);
             RHISafeRelease(cullingPipelineLayout);
+            RHISafeRelease(instanceCullingPipeline);
+            RHISafeRelease(instanceCullingPipelineLayout);
 
             RHISafeRelease(gbufferPipeline);
             RHISafeRelease(gbufferPipelineLayout);
+            RHISafeRelease(gbufferInstancedPipeline);
+            RHISafeRelease(gbufferInstancedPipelineLayout);
         }
 
     private:
-        void initCulling()
+        void initCulling(bool bInstanced, VkPipeline& outPipeline, VkPipelineLayout& outPipelineLayout)
         {
-            CHECK(cullingPipeline == VK_NULL_HANDLE);
-            CHECK(cullingPipelineLayout == VK_NULL_HANDLE);
+            CHECK(outPipeline == VK_NULL_HANDLE);
+            CHECK(outPipelineLayout == VK_NULL_HANDLE);
 
             // Config.
-            auto shaderModule = RHI::ShaderManager->getShader("StaticMeshCulling.comp.spv", true);
+            auto shaderModule = RHI::ShaderManager->getShader(bInstanced ? "StaticMeshInstanceCulling.comp.spv" : "StaticMeshCulling.comp.spv", true);
             std::vector<VkDescriptorSetLayout> setLayouts =
             {
                   GetLayoutStatic(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER) // objectDatas
                 , GetLayoutStatic(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER) // indirectCommands
-                , GetLayoutStatic(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER) // drawCount
+                , GetLayoutStatic(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER) // drawCount or visibleInstances
                 , GetLayoutStatic(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER) // viewData
             };
+            if (bInstanced)
+            {
+                setLayouts.push_back(GetLayoutStatic(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER)); // instances
+            }
 
             // Vulkan build functions.
             VkPipelineLayoutCreateInfo plci = RHIPipelineLayoutCreateInfo();
@@ -64,7 +86,7 @@ namespace Flower
             plci.pushConstantRangeCount = 1;
             plci.setLayoutCount = (uint32_t)setLayouts.size();
             plci.pSetLayouts = setLayouts.data();
-            cullingPipelineLayout = RHI::get()->createPipelineLayout(plci);
+            outPipelineLayout = RHI::get()->createPipelineLayout(plci);
             VkPipelineShaderStageCreateInfo shaderStageCI{};
             shaderStageCI.module = shaderModule;
             shaderStageCI.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
@@ -72,18 +94,18 @@ namespace Flower
             shaderStageCI.pName = "main";
             VkComputePipelineCreateInfo computePipelineCreateInfo{};
             computePipelineCreateInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
-            computePipelineCreateInfo.layout = cullingPipelineLayout;
+            computePipelineCreateInfo.layout = outPipelineLayout;
             computePipelineCreateInfo.flags = 0;
             computePipelineCreateInfo.stage = shaderStageCI;
-            RHICheck(vkCreateComputePipelines(RHI::Device, nullptr, 1, &computePipelineCreateInfo, nullptr, &cullingPipeline));
+            RHICheck(vkCreateComputePipelines(RHI::Device, nullptr, 1, &computePipelineCreateInfo, nullptr, &outPipeline));
         }
 
-        void initGBuffer()
+        void initGBuffer(bool bInstanced, VkPipeline& outPipeline, VkPipelineLayout& outPipelineLayout)
         {
-            CHECK(gbufferPipeline == VK_NULL_HANDLE);
-            CHECK(gbufferPipelineLayout == VK_NULL_HANDLE);
+            CHECK(outPipeline == VK_NULL_HANDLE);
+            CHECK(outPipelineLayout == VK_NULL_HANDLE);
 
-            auto vertShader = RHI::ShaderManager->getShader("StaticMeshGBuffer.vert.spv", true);
+            auto vertShader = RHI::ShaderManager->getShader(bInstanced ? "StaticMeshGBufferInstanced.vert.spv" : "StaticMeshGBuffer.vert.spv", true);
             auto fragShader = RHI::ShaderManager->getShader("StaticMeshGBuffer.frag.spv", true);
 
             std::vector<VkDescriptorSetLayout> setLayouts =
@@ -95,7 +117,8 @@ namespace Flower
                 , Bindless::Texture->getSetLayout() // texture2D array
                 , Bindless::Sampler->getSetLayout() // sampler2D array
                 , GetLayoutStatic(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER) // objectDatas
-                , GetLayoutStatic(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER) // indirectCommands
+                , GetLayoutStatic(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER) // indirectCommands or visibleInstances
+                , GetLayoutStatic(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER) // textureFeedback
             };
 
             std::vector<VkPipelineShaderStageCreateInfo> shaderStages =
@@ -150,7 +173,7 @@ namespace Flower
             VkPipelineLayoutCreateInfo plci = RHIPipelineLayoutCreateInfo();
             plci.setLayoutCount = (uint32_t)setLayouts.size();
             plci.pSetLayouts = setLayouts.data();
-            gbufferPipelineLayout = RHI::get()->createPipelineLayout(plci);
+            outPipelineLayout = RHI::get()->createPipelineLayout(plci);
             VkGraphicsPipelineCreateInfo pipelineCreateInfo
             {
                 .sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO,
@@ -165,9 +188,9 @@ namespace Flower
                 .pDepthStencilState = &depthStencilState,
                 .pColorBlendState = &colorBlending,
                 .pDynamicState = &deafultDynamicState,
-                .layout = gbufferPipelineLayout,
+                .layout = outPipelineLayout,
             };
-            RHICheck(vkCreateGraphicsPipelines(RHI::Device, nullptr, 1, &pipelineCreateInfo, nullptr, &gbufferPipeline));
+            RHICheck(vkCreateGraphicsPipelines(RHI::Device, nullptr, 1, &pipelineCreateInfo, nullptr, &outPipeline));
         }
     };
 
@@ -182,6 +205,34 @@ namespace Flower
     {
         uint32_t staticMeshCount = (uint32_t)scene->getCollectStaticMeshes().size();
 
+        // Texture streaming feedback, slot last written GBackBufferCount frames ago and already finish on gpu.
+        auto& textureFeedback = m_textureFeedback[m_renderIndex];
+        if (textureFeedback)
+        {
+            auto feedbackBuffer = textureFeedback->buffer.getBuffer();
+            feedbackBuffer->map();
+            TextureManager::get()->consumeFeedback((const uint32_t*)feedbackBuffer->mapped, MAX_BINDLESS_COUNT);
+            feedbackBuffer->unmap();
+        }
+        else
+        {
+            textureFeedback = getBuffers()->getStaticStorage("TextureStreamingFeedback", sizeof(uint32_t) * MAX_BINDLESS_COUNT);
+        }
+        {
+            vkCmdFillBuffer(cmd, *textureFeedback->buffer.getBuffer(), 0, textureFeedback->buffer.getBuffer()->getSize(), ~0u);
+            VkBufferMemoryBarrier2 fillBarrier = RHIBufferBarrier(textureFeedback->buffer.getBuffer()->getVkBuffer(),
+                VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT,
+                VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT);
+            RHIPipelineBarrier(cmd, 0, 1, &fillBarrier, 0, nullptr);
+        }
+        auto textureFeedbackToHost = [&]()
+        {
+            VkBufferMemoryBarrier2 hostBarrier = RHIBufferBarrier(textureFeedback->buffer.getBuffer()->getVkBuffer(),
+                VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT | VK_ACCESS_SHADER_WRITE_BIT,
+                VK_PIPELINE_STAGE_HOST_BIT, VK_ACCESS_HOST_READ_BIT);
+            RHIPipelineBarrier(cmd, 0, 1, &hostBarrier, 0, nullptr);
+        };
+
         auto& hdrSceneColor = inTextures->getHdrSceneColor()->getImage();
         auto& gbufferA = inTextures->getGbufferA()->getImage();
         auto& gbufferB = inTextures->getGbufferB()->getImage();
@@ -275,12 +326,23 @@ namespace Flower
                 vkCmdSetDepthBias(cmd, 0, 0, 0);
             }
             vkCmdEndRendering(cmd);
+            textureFeedbackToHost();
+
             // Pre-return if no static mesh can use.
             return;
         }
 
-        auto indirectDrawCommandBuffer = getBuffers()->getIndirectStorage("StaticMeshIndirectCommand", sizeof(GPUDrawIndirectCommand) * staticMeshCount);
-        auto indirectDrawCountBuffer = getBuffers()->getIndirectStorage("StaticMeshIndirectCount", sizeof(GPUDrawIndirectCount));
+        // Instanced path draw one command per instance batch lod, see StaticMeshInstancing.h.
+        const bool bInstancing = scene->isInstancingEnable();
+        const auto& instanceBatches = scene->getInstanceBatches();
+        const uint32_t maxDrawCount = bInstancing ? instanceBatches.getDrawCommandCount() : staticMeshCount;
+
+        auto indirectDrawCommandBuffer = getBuffers()->getIndirectStorage("StaticMeshIndirectCommand", sizeof(GPUDrawIndirectCommand) * maxDrawCount);
+
+        // Draw count for per object path, visible instance object ids for instanced path.
+        auto indirectDrawCountBuffer = bInstancing ?
+            getBuffers()->getStaticStorageGPUOnly("StaticMeshVisibleInstances", sizeof(uint32_t) * instanceBatches.getVisibleInstanceCapacity()) :
+            getBuffers()->getIndirectStorage("StaticMeshIndirectCount", sizeof(GPUDrawIndirectCount));
 
         auto* pass = getPasses()->getPass<StaticMeshPass>();
 
@@ -288,39 +350,70 @@ namespace Flower
         {
             RHI::ScopePerframeMarker staticMeshGBufferCullingMarker(cmd, "StaticMeshGBufferCulling", { 1.0f, 0.0f, 0.0f, 1.0f });
 
-            vkCmdFillBuffer(cmd, *indirectDrawCountBuffer->buffer.getBuffer(), 0, indirectDrawCountBuffer->buffer.getBuffer()->getSize(), 0u);
-            vkCmdFillBuffer(cmd, *indirectDrawCommandBuffer->buffer.getBuffer(), 0, indirectDrawCommandBuffer->buffer.getBuffer()->getSize(), 0u);
-            std::array<VkBufferMemoryBarrier2, 2> fillBarriers
+            if (bInstancing)
             {
-                RHIBufferBarrier(indirectDrawCommandBuffer->buffer.getBuffer()->getVkBuffer(),
+                // Command template carry batch lod draw range, culling only increase instance count.
+                VkBufferCopy copyRegion{ .srcOffset = 0, .dstOffset = 0, .size = sizeof(GPUDrawIndirectCommand) * maxDrawCount };
+                vkCmdCopyBuffer(cmd, 
+                    scene->getInstanceCommandsPtr()->buffer.getBuffer()->getVkBuffer(), 
+                    indirectDrawCommandBuffer->buffer.getBuffer()->getVkBuffer(), 
+                    1, &copyRegion);
+
+                VkBufferMemoryBarrier2 copyBarrier = RHIBufferBarrier(indirectDrawCommandBuffer->buffer.getBuffer()->getVkBuffer(),
                     VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT,
-                    VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT),
+                    VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT);
+                RHIPipelineBarrier(cmd, 0, 1, &copyBarrier, 0, nullptr);
+            }
+            else
+            {
+                vkCmdFillBuffer(cmd, *indirectDrawCountBuffer->buffer.getBuffer(), 0, indirectDrawCountBuffer->buffer.getBuffer()->getSize(), 0u);
+                vkCmdFillBuffer(cmd, *indirectDrawCommandBuffer->buffer.getBuffer(), 0, indirectDrawCommandBuffer->buffer.getBuffer()->getSize(), 0u);
+                std::array<VkBufferMemoryBarrier2, 2> fillBarriers
+                {
+                    RHIBufferBarrier(indirectDrawCommandBuffer->buffer.getBuffer()->getVkBuffer(),
+                        VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT,
+                        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT),
 
-                RHIBufferBarrier(indirectDrawCountBuffer->buffer.getBuffer()->getVkBuffer(),
-                    VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT,
-                    VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT),
-            };
-            RHIPipelineBarrier(cmd, 0, (uint32_t)fillBarriers.size(), fillBarriers.data(), 0, nullptr);
+                    RHIBufferBarrier(indirectDrawCountBuffer->buffer.getBuffer()->getVkBuffer(),
+                        VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT,
+                        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT),
+                };
+                RHIPipelineBarrier(cmd, 0, (uint32_t)fillBarriers.size(), fillBarriers.data(), 0, nullptr);
+            }
 
 
+            // Pixel per object space unit at unit distance, divide by pixel error so lod pass when projected error <= 1.
+            float lodErrorScale = 0.0f;
+            if (cVarMeshLodEnable.get() != 0)
+            {
+                const float pixelError = glm::max(cVarMeshLodPixelError.get(), 0.01f);
+                lodErrorScale = float(renderHeight) / (2.0f * glm::tan(m_cacheViewData.camInfo.x * 0.5f)) / pixelError;
+            }
+
             GPUCullingPushConstants gpuPushConstant =
             {
                 .cullCount = staticMeshCount,
+                .lodErrorScale = lodErrorScale,
             };
 
-            vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pass->cullingPipeline);
-            vkCmdPushConstants(cmd, pass->cullingPipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(GPUCullingPushConstants), &gpuPushConstant);
+            const VkPipelineLayout cullingPipelineLayout = bInstancing ? pass->instanceCullingPipelineLayout : pass->cullingPipelineLayout;
+            vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, bInstancing ? pass->instanceCullingPipeline : pass->cullingPipeline);
+            vkCmdPushConstants(cmd, cullingPipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(GPUCullingPushConstants), &gpuPushConstant);
 
             std::vector<VkDescriptorSet> compPassSets =
             {
                   scene->getStaticMeshesObjectsPtr()->buffer.getSet() // objectDatas
                 , indirectDrawCommandBuffer->buffer.getSet()          // indirectCommands
-                , indirectDrawCountBuffer->buffer.getSet()            // drawCount
+                , indirectDrawCountBuffer->buffer.getSet()            // drawCount or visibleInstances
                 , viewData->buffer.getSet()                           // viewData
             };
+            if (bInstancing)
+            {
+                compPassSets.push_back(scene->getInstancesPtr()->buffer.getSet()); // instances
+            }
 
             vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE,
-                pass->cullingPipelineLayout, 0,
+                cullingPipelineLayout, 0,
                 (uint32_t)compPassSets.size(), compPassSets.data(),
                 0, nullptr
             );
@@ -337,7 +430,7 @@ namespace Flower
 
                 RHIBufferBarrier(indirectDrawCountBuffer->buffer.getBuffer()->getVkBuffer(),
                     VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_MEMORY_WRITE_BIT,
-                    VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT, VK_ACCESS_INDIRECT_COMMAND_READ_BIT),
+                    VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT, VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_SHADER_READ_BIT),
             };
             RHIPipelineBarrier(cmd, 0, (uint32_t)endBufferBarriers.size(), endBufferBarriers.data(), 0, nullptr);
         }
@@ -352,7 +445,8 @@ namespace Flower
                 vkCmdSetViewport(cmd, 0, 1, &viewport);
                 vkCmdSetDepthBias(cmd, 0, 0, 0);
 
-                vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, pass->gbufferPipeline);
+                const VkPipelineLayout gbufferPipelineLayout = bInstancing ? pass->gbufferInstancedPipelineLayout : pass->gbufferPipelineLayout;
+                vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, bInstancing ? pass->gbufferInstancedPipeline : pass->gbufferPipeline);
 
                 std::vector<VkDescriptorSet> meshPassSets =
                 {
@@ -363,23 +457,38 @@ namespace Flower
                     , Bindless::Texture->getSet()
                     , Bindless::Sampler->getSet()
                     , scene->getStaticMeshesObjectsPtr()->buffer.getSet() // objectDatas
-                    , indirectDrawCommandBuffer->buffer.getSet() // indirectCommands
+                    , (bInstancing ? indirectDrawCountBuffer : indirectDrawCommandBuffer)->buffer.getSet() // indirectCommands or visibleInstances
+                    , textureFeedback->buffer.getSet() // textureFeedback
                 };
 
-                vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, pass->gbufferPipelineLayout,
+                vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, gbufferPipelineLayout,
                     0, (uint32_t)meshPassSets.size(), meshPassSets.data(), 0, nullptr);
 
-                vkCmdDrawIndirectCount(cmd,
-                    indirectDrawCommandBuffer->buffer.getBuffer()->getVkBuffer(), 0,
-                    indirectDrawCountBuffer->buffer.getBuffer()->getVkBuffer(),
-                    0,
-                    staticMeshCount,
-                    sizeof(GPUDrawIndirectCommand)
-                );
+                if (bInstancing)
+                {
+                    // Empty batch lod command has zero instance count.
+                    vkCmdDrawIndirect(cmd,
+                        indirectDrawCommandBuffer->buffer.getBuffer()->getVkBuffer(), 0,
+                        maxDrawCount,
+                        sizeof(GPUDrawIndirectCommand)
+                    );
+                }
+                else
+                {
+                    vkCmdDrawIndirectCount(cmd,
+                        indirectDrawCommandBuffer->buffer.getBuffer()->getVkBuffer(), 0,
+                        indirectDrawCountBuffer->buffer.getBuffer()->getVkBuffer(),
+                        0,
+                        staticMeshCount,
+                        sizeof(GPUDrawIndirectCommand)
+                    );
+                }
 
                 m_gpuTimer.getTimeStamp(cmd, "StaticMesh Rendering");
             }
             vkCmdEndRendering(cmd);
         }
+
+        textureFeedbackToHost();
     }
 }
\ No newline at end of file
@@ -9,21 +9,52 @@ namespace Flower
 {
     static AutoCVarCmd cVarUpdateCloudNoise("cmd.Cloud.NoiseUpdate", "Update cloud noise lut.");
 
+    static AutoCVarInt32 cVarCloudEnable(
+        "r.Cloud.Enable",
+        "Enable volumetric cloud, 0 is off, 1 is on. Off by default until gpu cost is measured.",
+        "Cloud",
+        0,
+        CVarFlags::ReadAndWrite
+    );
+
+    static AutoCVarInt32 cVarCloudMaxStepCount(
+        "r.Cloud.MaxStepCount",
+        "Max ray march step count of quarter resolution cloud trace.",
+        "Cloud",
+        64,
+        CVarFlags::ReadAndWrite
+    );
+
+    static AutoCVarInt32 cVarCloudShadowStepCount(
+        "r.Cloud.ShadowStepCount",
+        "Light direction self shadow step count of each cloud sample.",
+        "Cloud",
+        10,
+        CVarFlags::ReadAndWrite
+    );
+
+    struct CloudPush
+    {
+        uint32_t maxStepCount;
+        uint32_t shadowStepCount;
+        uint32_t bHistoryValid;
+    };
+
     class VolumetricCloudPass : public PassInterface
     {
     public:
         VkDescriptorSetLayout setLayout = VK_NULL_HANDLE;
+        VkPipelineLayout pipelineLayout = VK_NULL_HANDLE;
 
-        VkPipeline computeCloudPipeline = VK_NULL_HANDLE;
-        VkPipelineLayout computeCloudPipelineLayout = VK_NULL_HANDLE;
-
-        VkPipeline compositeCloudPipeline = VK_NULL_HANDLE;
-        VkPipelineLayout compositeCloudPipelineLayout = VK_NULL_HANDLE;
-        
+        VkPipeline tracePipeline = VK_NULL_HANDLE;
+        VkPipeline reconstructPipeline = VK_NULL_HANDLE;
 
     public:
         virtual void init() override
         {
+            CHECK(setLayout == VK_NULL_HANDLE);
+            CHECK(pipelineLayout == VK_NULL_HANDLE);
+
             RHI::get()->descriptorFactoryBegin()
                 .bindNoInfo(VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, GCommonShaderStage, 0) // imageHdrSceneColor
                 .bindNoInfo(VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, GCommonShaderStage, 1) // inHdrSceneColor
@@ -35,6 +66,11 @@ namespace Flower
                 .bindNoInfo(VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, GCommonShaderStage, 7) // inDetailNoise
                 .bindNoInfo(VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, GCommonShaderStage, 8) // inCloudWeather
                 .bindNoInfo(VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, GCommonShaderStage, 9) // inCloudGradient
+                .bindNoInfo(VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, GCommonShaderStage, 10) // imageCloudDistance
+                .bindNoInfo(VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, GCommonShaderStage, 11) // inCloudDistance
+                .bindNoInfo(VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, GCommonShaderStage, 12) // imageCloudReconstruct
+                .bindNoInfo(VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, GCommonShaderStage, 13) // inCloudHistory
+                .bindNoInfo(VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, GCommonShaderStage, 14) // inPrevDepth
                 .buildNoInfoPush(setLayout);
 
             std::vector<VkDescriptorSetLayout> setLayouts =
@@ -45,44 +81,20 @@ namespace Flower
                 , RHI::SamplerManager->getCommonDescriptorSetLayout() // Common samplers
             };
 
-            // Cloud compute.
-            {
-                CHECK(computeCloudPipeline == VK_NULL_HANDLE);
-                CHECK(computeCloudPipelineLayout == VK_NULL_HANDLE);
-
-                auto shaderModule = RHI::ShaderManager->getShader("VolumetricCloudRayMarching.comp.spv", true);
+            VkPushConstantRange pushRange{ .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT, .offset = 0, .size = sizeof(CloudPush) };
 
-                // Vulkan build functions.
-                VkPipelineLayoutCreateInfo plci = RHIPipelineLayoutCreateInfo();
-                plci.setLayoutCount = (uint32_t)setLayouts.size();
-                plci.pSetLayouts = setLayouts.data();
-                computeCloudPipelineLayout = RHI::get()->createPipelineLayout(plci);
+            VkPipelineLayoutCreateInfo plci = RHIPipelineLayoutCreateInfo();
+            plci.pushConstantRangeCount = 1;
+            plci.pPushConstantRanges = &pushRange;
+            plci.setLayoutCount = (uint32_t)setLayouts.size();
+            plci.pSetLayouts = setLayouts.data();
+            pipelineLayout = RHI::get()->createPipelineLayout(plci);
 
-                VkPipelineShaderStageCreateInfo shaderStageCI{};
-                shaderStageCI.module = shaderModule;
-                shaderStageCI.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
-                shaderStageCI.stage = VK_SHADER_STAGE_COMPUTE_BIT;
-                shaderStageCI.pName = "main";
-                VkComputePipelineCreateInfo computePipelineCreateInfo{};
-                computePipelineCreateInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
-                computePipelineCreateInfo.layout = computeCloudPipelineLayout;
-                computePipelineCreateInfo.flags = 0;
-                computePipelineCreateInfo.stage = shaderStageCI;
-                RHICheck(vkCreateComputePipelines(RHI::Device, nullptr, 1, &computePipelineCreateInfo, nullptr, &computeCloudPipeline));
-            }
-
-            // Cloud composition compute.
+            auto buildPipeline = [&](const char* shaderName, VkPipeline& pipeline)
             {
-                CHECK(compositeCloudPipeline == VK_NULL_HANDLE);
-                CHECK(compositeCloudPipelineLayout == VK_NULL_HANDLE);
+                CHECK(pipeline == VK_NULL_HANDLE);
 
-                auto shaderModule = RHI::ShaderManager->getShader("VolumetricCompositeWithScreen.comp.spv", true);
-
-                // Vulkan build functions.
-                VkPipelineLayoutCreateInfo plci = RHIPipelineLayoutCreateInfo();
-                plci.setLayoutCount = (uint32_t)setLayouts.size();
-                plci.pSetLayouts = setLayouts.data();
-                compositeCloudPipelineLayout = RHI::get()->createPipelineLayout(plci);
+                auto shaderModule = RHI::ShaderManager->getShader(shaderName, true);
 
                 VkPipelineShaderStageCreateInfo shaderStageCI{};
                 shaderStageCI.module = shaderModule;
@@ -91,20 +103,24 @@ namespace Flower
                 shaderStageCI.pName = "main";
                 VkComputePipelineCreateInfo computePipelineCreateInfo{};
                 computePipelineCreateInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
-                computePipelineCreateInfo.layout = compositeCloudPipelineLayout;
+                computePipelineCreateInfo.layout = pipelineLayout;
                 computePipelineCreateInfo.flags = 0;
                 computePipelineCreateInfo.stage = shaderStageCI;
-                RHICheck(vkCreateComputePipelines(RHI::Device, nullptr, 1, &computePipelineCreateInfo, nullptr, &compositeCloudPipeline));
-            }
+                RHICheck(vkCreateComputePipelines(RHI::Device, nullptr, 1, &computePipelineCreateInfo, nullptr, &pipeline));
+            };
+
+            // Quarter resolution trace.
+            buildPipeline("VolumetricCloudRayMarching.comp.spv", tracePipeline);
+
+            // Full resolution temporal reconstruct and composite.
+            buildPipeline("VolumetricCloudReconstruct.comp.spv", reconstructPipeline);
         }
 
         virtual void release() override
         {
-            RHISafeRelease(computeCloudPipeline);
-            RHISafeRelease(computeCloudPipelineLayout);
-
-            RHISafeRelease(compositeCloudPipeline);
-            RHISafeRelease(compositeCloudPipelineLayout);
+            RHISafeRelease(tracePipeline);
+            RHISafeRelease(reconstructPipeline);
+            RHISafeRelease(pipelineLayout);
 
             setLayout = VK_NULL_HANDLE;
         }
@@ -118,9 +134,10 @@ namespace Flower
         BufferParamRefPointer& viewData,
         BufferParamRefPointer& frameData)
     {
-        // Skip if no directional light.
-        if (scene->getImportanceLights().directionalLightCount <= 0)
+        // Skip if no directional light or disable, history also drop.
+        if (scene->getImportanceLights().directionalLightCount <= 0 || cVarCloudEnable.get() == 0)
         {
+            m_cloudHistory = nullptr;
             return;
         }
 
@@ -130,7 +147,6 @@ namespace Flower
         });
 
         auto& sceneColorHdr = inTextures->getHdrSceneColor()->getImage();
-        auto& computeCloud = inTextures->getCloudImage()->getImage();
         auto& sceneDepthZ = inTextures->getDepth()->getImage();
         auto& gbufferA = inTextures->getGbufferA()->getImage();
 
@@ -142,10 +158,38 @@ namespace Flower
 
         auto* pass = getPasses()->getPass<VolumetricCloudPass>();
 
+        gbufferA.transitionLayout(cmd, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, buildBasicImageSubresource());
+        sceneDepthZ.transitionLayout(cmd, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, RHIDefaultImageSubresourceRange(VK_IMAGE_ASPECT_DEPTH_BIT));
+
+        // Trace one pixel of each 4x4 block per frame, reconstruct at full resolution.
+        const uint32_t traceWidth = divideRoundingUp(sceneDepthZ.getExtent().width, 4u);
+        const uint32_t traceHeight = divideRoundingUp(sceneDepthZ.getExtent().height, 4u);
+
+        auto cloudTrace = m_rtPool->createPoolImage(
+            "CloudTrace",
+            traceWidth,
+            traceHeight,
+            VK_FORMAT_R16G16B16A16_SFLOAT,
+            VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT);
+
+        auto cloudDistance = m_rtPool->createPoolImage(
+            "CloudDistance",
+            traceWidth,
+            traceHeight,
+            VK_FORMAT_R32_SFLOAT,
+            VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT);
+
+        auto cloudReconstruct = inTextures->getCloudImage();
+
+        // History only valid when size match, otherwise bind trace image keep descriptor valid.
+        const bool bHistoryValid = m_cloudHistory &&
+            m_cloudHistory->getImage().getExtent().width == cloudReconstruct->getImage().getExtent().width &&
+            m_cloudHistory->getImage().getExtent().height == cloudReconstruct->getImage().getExtent().height;
+
         VkDescriptorImageInfo hdrSceneColorImageInfo = RHIDescriptorImageInfoStorage(sceneColorHdr.getView(buildBasicImageSubresource()));
         VkDescriptorImageInfo hdrSceneColorInfo = RHIDescriptorImageInfoSample(sceneColorHdr.getView(buildBasicImageSubresource()));
-        VkDescriptorImageInfo computeCloudImageInfo = RHIDescriptorImageInfoStorage(computeCloud.getView(buildBasicImageSubresource()));
-        VkDescriptorImageInfo computeCloudInfo = RHIDescriptorImageInfoSample(computeCloud.getView(buildBasicImageSubresource()));
+        VkDescriptorImageInfo cloudTraceImageInfo = RHIDescriptorImageInfoStorage(cloudTrace->getImage().getView(buildBasicImageSubresource()));
+        VkDescriptorImageInfo cloudTraceInfo = RHIDescriptorImageInfoSample(cloudTrace->getImage().getView(buildBasicImageSubresource()));
         VkDescriptorImageInfo sceneDepthZInfo = RHIDescriptorImageInfoSample(sceneDepthZ.getView(RHIDefaultImageSubresourceRange(VK_IMAGE_ASPECT_DEPTH_BIT)));
         VkDescriptorImageInfo gbufferAInfo = RHIDescriptorImageInfoSample(gbufferA.getView(buildBasicImageSubresource()));
 
@@ -155,18 +199,39 @@ namespace Flower
         VkDescriptorImageInfo weatherInfo = RHIDescriptorImageInfoSample(weatherTexture->getImage().getView(buildBasicImageSubresource()));
         VkDescriptorImageInfo gradientInfo = RHIDescriptorImageInfoSample(gradientTexture->getImage().getView(buildBasicImageSubresource()));
 
+        VkDescriptorImageInfo cloudDistanceImageInfo = RHIDescriptorImageInfoStorage(cloudDistance->getImage().getView(buildBasicImageSubresource()));
+        VkDescriptorImageInfo cloudDistanceInfo = RHIDescriptorImageInfoSample(cloudDistance->getImage().getView(buildBasicImageSubresource()));
+        VkDescriptorImageInfo cloudReconstructImageInfo = RHIDescriptorImageInfoStorage(cloudReconstruct->getImage().getView(buildBasicImageSubresource()));
+
+        VkDescriptorImageInfo cloudHistoryInfo = cloudTraceInfo;
+        if (bHistoryValid)
+        {
+            cloudHistoryInfo = RHIDescriptorImageInfoSample(m_cloudHistory->getImage().getView(buildBasicImageSubresource()));
+        }
+
+        VkDescriptorImageInfo prevDepthInfo = sceneDepthZInfo;
+        if (m_prevDepth)
+        {
+            prevDepthInfo = RHIDescriptorImageInfoSample(m_prevDepth->getImage().getView(RHIDefaultImageSubresourceRange(VK_IMAGE_ASPECT_DEPTH_BIT)));
+        }
+
         std::vector<VkWriteDescriptorSet> writes
         {
             RHIPushWriteDescriptorSetImage(0,  VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, &hdrSceneColorImageInfo),
             RHIPushWriteDescriptorSetImage(1,  VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, &hdrSceneColorInfo),
-            RHIPushWriteDescriptorSetImage(2,  VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, &computeCloudImageInfo),
-            RHIPushWriteDescriptorSetImage(3,  VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, &computeCloudInfo),
+            RHIPushWriteDescriptorSetImage(2,  VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, &cloudTraceImageInfo),
+            RHIPushWriteDescriptorSetImage(3,  VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, &cloudTraceInfo),
             RHIPushWriteDescriptorSetImage(4,  VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, &sceneDepthZInfo),
             RHIPushWriteDescriptorSetImage(5,  VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, &gbufferAInfo),
             RHIPushWriteDescriptorSetImage(6,  VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, &basicNoiseInfo),
             RHIPushWriteDescriptorSetImage(7,  VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, &detailNoiseInfo),
             RHIPushWriteDescriptorSetImage(8,  VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, &weatherInfo),
             RHIPushWriteDescriptorSetImage(9,  VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, &gradientInfo),
+            RHIPushWriteDescriptorSetImage(10, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, &cloudDistanceImageInfo),
+            RHIPushWriteDescriptorSetImage(11, VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, &cloudDistanceInfo),
+            RHIPushWriteDescriptorSetImage(12, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, &cloudReconstructImageInfo),
+            RHIPushWriteDescriptorSetImage(13, VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, &cloudHistoryInfo),
+            RHIPushWriteDescriptorSetImage(14, VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, &prevDepthInfo),
         };
 
         std::vector<VkDescriptorSet> compPassSets =
@@ -175,46 +240,61 @@ namespace Flower
             , frameData->buffer.getSet()
             , RHI::SamplerManager->getCommonDescriptorSet()
         };
+
+        CloudPush pushConst
         {
-            RHI::ScopePerframeMarker marker(cmd, "CloudCompute", { 1.0f, 1.0f, 0.0f, 1.0f });
+            .maxStepCount = (uint32_t)glm::max(cVarCloudMaxStepCount.get(), 1),
+            .shadowStepCount = (uint32_t)glm::max(cVarCloudShadowStepCount.get(), 1),
+            .bHistoryValid = bHistoryValid ? 1u : 0u,
+        };
 
-            computeCloud.transitionLayout(cmd, VK_IMAGE_LAYOUT_GENERAL, buildBasicImageSubresource());
-            vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pass->computeCloudPipeline);
+        // Push owner set #0.
+        RHI::PushDescriptorSetKHR(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pass->pipelineLayout, 0, uint32_t(writes.size()), writes.data());
 
-            // Push owner set #0.
-            RHI::PushDescriptorSetKHR(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pass->computeCloudPipelineLayout, 0, uint32_t(writes.size()), writes.data());
+        // Set #1..3
+        vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE,
+            pass->pipelineLayout, 1,
+            (uint32_t)compPassSets.size(), compPassSets.data(),
+            0, nullptr
+        );
 
-            // Set #1..3
-            vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE,
-                pass->computeCloudPipelineLayout, 1,
-                (uint32_t)compPassSets.size(), compPassSets.data(),
-                0, nullptr
-            );
+        vkCmdPushConstants(cmd, pass->pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(pushConst), &pushConst);
 
-            vkCmdDispatch(cmd, getGroupCount(computeCloud.getExtent().width, 8), getGroupCount(computeCloud.getExtent().height, 8), 1);
-            computeCloud.transitionLayout(cmd, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, buildBasicImageSubresource());
-        }
         {
-            RHI::ScopePerframeMarker marker(cmd, "CloudComposite", { 1.0f, 1.0f, 0.0f, 1.0f });
+            RHI::ScopePerframeMarker marker(cmd, "CloudTrace", { 1.0f, 1.0f, 0.0f, 1.0f });
 
-            sceneColorHdr.transitionLayout(cmd, VK_IMAGE_LAYOUT_GENERAL, buildBasicImageSubresource());
-            vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pass->compositeCloudPipeline);
+            cloudTrace->getImage().transitionLayout(cmd, VK_IMAGE_LAYOUT_GENERAL, buildBasicImageSubresource());
+            cloudDistance->getImage().transitionLayout(cmd, VK_IMAGE_LAYOUT_GENERAL, buildBasicImageSubresource());
 
-            // Push owner set #0.
-            RHI::PushDescriptorSetKHR(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pass->compositeCloudPipelineLayout, 0, uint32_t(writes.size()), writes.data());
+            vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pass->tracePipeline);
+            vkCmdDispatch(cmd, getGroupCount(traceWidth, 8), getGroupCount(traceHeight, 8), 1);
+
+            cloudTrace->getImage().transitionLayout(cmd, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, buildBasicImageSubresource());
+            cloudDistance->getImage().transitionLayout(cmd, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, buildBasicImageSubresource());
+        }
 
-            // Set #1..3
-            vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE,
-                pass->compositeCloudPipelineLayout, 1,
-                (uint32_t)compPassSets.size(), compPassSets.data(),
-                0, nullptr
-            );
+        m_gpuTimer.getTimeStamp(cmd, "Cloud Trace");
 
+        {
+            RHI::ScopePerframeMarker marker(cmd, "CloudReconstruct", { 1.0f, 1.0f, 0.0f, 1.0f });
+
+            if (bHistoryValid)
+            {
+                m_cloudHistory->getImage().transitionLayout(cmd, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, buildBasicImageSubresource());
+            }
+            cloudReconstruct->getImage().transitionLayout(cmd, VK_IMAGE_LAYOUT_GENERAL, buildBasicImageSubresource());
+            sceneColorHdr.transitionLayout(cmd, VK_IMAGE_LAYOUT_GENERAL, buildBasicImageSubresource());
+
+            vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pass->reconstructPipeline);
             vkCmdDispatch(cmd, getGroupCount(sceneColorHdr.getExtent().width, 8), getGroupCount(sceneColorHdr.getExtent().height, 8), 1);
+
+            cloudReconstruct->getImage().transitionLayout(cmd, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, buildBasicImageSubresource());
             sceneColorHdr.transitionLayout(cmd, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, buildBasicImageSubresource());
         }
 
-        m_gpuTimer.getTimeStamp(cmd, "Volumetric Cloud");
+        m_gpuTimer.getTimeStamp(cmd, "Cloud Reconstruct");
+
+        m_cloudHistory = cloudReconstruct;
     }
 
 
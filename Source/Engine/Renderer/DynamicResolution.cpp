@@ -0,0 +1,256 @@
+#include "Pch.h"
+#include "DynamicResolution.h"
+
+namespace Flower
+{
+	// Avoid integral wind up when scale clamp at bound for long time.
+	constexpr float kIntegralLimit = 4.0f;
+
+	float DynamicResolutionController::quantize(float scale) const
+	{
+		const float step = glm::max(m_config.scaleStep, 1e-3f);
+
+		// Floor to step, prefer lower scale when between two steps.
+		const float quantized = m_config.minScale + glm::floor((scale - m_config.minScale) / step + 1e-3f) * step;
+		return glm::clamp(quantized, m_config.minScale, m_config.maxScale);
+	}
+
+	void DynamicResolutionController::applyScale(float scale)
+	{
+		if (scale != m_scale)
+		{
+			m_scale = scale;
+			m_settleCounter = m_config.settleFrames;
+		}
+		m_raiseCounter = 0;
+	}
+
+	void DynamicResolutionController::reset(float scale)
+	{
+		m_scale = glm::clamp(scale, m_config.minScale, m_config.maxScale);
+		m_continuousScale = m_scale;
+		m_integral = 0.0f;
+		m_prevError = 0.0f;
+		m_settleCounter = 0;
+		m_raiseCounter = 0;
+	}
+
+	float DynamicResolutionController::update(float gpuFrameTimeMs)
+	{
+		// Config may change at runtime.
+		m_scale = glm::clamp(m_scale, m_config.minScale, m_config.maxScale);
+		m_continuousScale = glm::clamp(m_continuousScale, m_config.minScale, m_config.maxScale);
+
+		if (gpuFrameTimeMs <= 0.0f || m_config.targetFrameTimeMs <= 0.0f)
+		{
+			return m_scale;
+		}
+
+		// Sample still measure frame before last scale change.
+		if (m_settleCounter > 0)
+		{
+			m_settleCounter--;
+			return m_scale;
+		}
+
+		const float budget = m_config.targetFrameTimeMs * (1.0f - glm::clamp(m_config.headroom, 0.0f, 0.9f));
+
+		// Panic when spike, estimate scale from pixel count model and drop now.
+		if (gpuFrameTimeMs > m_config.targetFrameTimeMs * m_config.panicRatio)
+		{
+			m_continuousScale = glm::clamp(m_scale * glm::sqrt(budget / gpuFrameTimeMs), m_config.minScale, m_config.maxScale);
+			m_integral = 0.0f;
+			m_prevError = 0.0f;
+
+			applyScale(quantize(m_continuousScale));
+			return m_scale;
+		}
+
+		// Positive when under budget.
+		const float error = glm::clamp((budget - gpuFrameTimeMs) / budget, -1.0f, 1.0f);
+		const float derivative = error - m_prevError;
+		m_prevError = error;
+
+		// Next step must still fit budget by pixel count model, otherwise two steps oscillate.
+		const float nextScale = quantize(m_scale + m_config.scaleStep + 1e-4f);
+		const float nextRatio = nextScale / m_scale;
+		const bool bCanRaise = nextScale > m_scale && gpuFrameTimeMs * nextRatio * nextRatio < budget;
+
+		// Only integrate when scale can still move to error direction.
+		const bool bSaturated =
+			   (error > 0.0f && !bCanRaise)
+			|| (error < 0.0f && m_continuousScale <= m_config.minScale);
+		if (!bSaturated)
+		{
+			m_integral = glm::clamp(m_integral + error, -kIntegralLimit, kIntegralLimit);
+		}
+
+		// Gpu cost scale with pixel count, so half pixel ratio change for scale.
+		const float output = m_config.kp * error + m_config.ki * m_integral + m_config.kd * derivative;
+		m_continuousScale = glm::clamp(m_continuousScale * glm::sqrt(glm::max(1.0f + output, 0.25f)), m_config.minScale, m_config.maxScale);
+		if (!bCanRaise)
+		{
+			m_continuousScale = glm::min(m_continuousScale, m_scale);
+		}
+
+		const float desireScale = quantize(m_continuousScale);
+		if (desireScale < m_scale)
+		{
+			// Over budget, drop immediately.
+			if (error < 0.0f)
+			{
+				applyScale(desireScale);
+			}
+		}
+		else if (desireScale > m_scale)
+		{
+			// Raise one step after controller keep want higher scale for a while, avoid oscillation.
+			m_raiseCounter++;
+			if (m_raiseCounter >= m_config.raiseFrames)
+			{
+				applyScale(glm::min(desireScale, quantize(m_scale + m_config.scaleStep)));
+			}
+		}
+		else
+		{
+			m_raiseCounter = 0;
+		}
+
+		return m_scale;
+	}
+
+	void DynamicResolutionController::validate()
+	{
+		// Gpu time model: fixed cost plus cost scale with pixel count, few frames latency and some noise.
+		struct Trace
+		{
+			const char* name;
+
+			// Pixel cost at scale one per frame range.
+			std::vector<std::pair<uint32_t, float>> pixelCostMs;
+			float fixedCostMs;
+		};
+
+		constexpr uint32_t kLatencyFrames = 3;
+		constexpr float kNoise = 0.03f;
+
+		auto runTrace = [](const DynamicResolutionConfig& config, const Trace& trace, uint32_t frameCount, std::vector<float>& outScales, std::vector<float>& outTimes)
+		{
+			DynamicResolutionController controller;
+			controller.setConfig(config);
+			controller.reset(config.maxScale);
+
+			std::mt19937 random(39);
+			std::uniform_real_distribution<float> noise(-kNoise, kNoise);
+
+			std::deque<float> inflight;
+			outScales.clear();
+			outTimes.clear();
+
+			float scale = controller.getScale();
+			for (uint32_t frame = 0; frame < frameCount; frame++)
+			{
+				float pixelCost = trace.pixelCostMs.front().second;
+				for (const auto& [startFrame, cost] : trace.pixelCostMs)
+				{
+					if (frame >= startFrame)
+					{
+						pixelCost = cost;
+					}
+				}
+
+				const float gpuTime = (trace.fixedCostMs + pixelCost * scale * scale) * (1.0f + noise(random));
+				outScales.push_back(scale);
+				outTimes.push_back(gpuTime);
+
+				inflight.push_back(gpuTime);
+				float sample = 0.0f;
+				if (inflight.size() > kLatencyFrames)
+				{
+					sample = inflight.front();
+					inflight.pop_front();
+				}
+
+				scale = controller.update(sample);
+			}
+		};
+
+		auto countChanges = [](const std::vector<float>& scales, uint32_t begin, uint32_t end)
+		{
+			uint32_t changes = 0;
+			for (uint32_t i = begin + 1; i < end; i++)
+			{
+				changes += (scales[i] != scales[i - 1]) ? 1 : 0;
+			}
+			return changes;
+		};
+
+		// Frames over target in range.
+		auto countOver = [](const std::vector<float>& times, float target, uint32_t begin, uint32_t end)
+		{
+			uint32_t count = 0;
+			for (uint32_t i = begin; i < end; i++)
+			{
+				count += (times[i] > target) ? 1 : 0;
+			}
+			return count;
+		};
+
+		const DynamicResolutionConfig config{};
+		const float target = config.targetFrameTimeMs;
+
+		ValidateReport report("Dynamic resolution");
+		auto expect = [&](bool bCondition, const char* trace, const char* info)
+		{
+			report.expect(bCondition, std::string(trace) + " " + info);
+		};
+
+		std::vector<float> scales;
+		std::vector<float> times;
+
+		// Heavy view, need lower scale and stay stable.
+		{
+			const Trace trace{ "Heavy", { { 0, 24.0f } }, 2.0f };
+			runTrace(config, trace, 600, scales, times);
+
+			expect(scales.back() < config.maxScale, trace.name, "scale should drop");
+			expect(countOver(times, target, 60, 600) <= 5, trace.name, "frames over target after converge");
+			expect(countChanges(scales, 200, 600) <= 4, trace.name, "scale oscillate after converge");
+			LOG_INFO("Dynamic resolution validate {0}: final scale {1:.2f}, final gpu time {2:.2f} ms, {3} changes.",
+				trace.name, scales.back(), times.back(), countChanges(scales, 0, 600));
+		}
+
+		// Light view, keep max scale.
+		{
+			const Trace trace{ "Light", { { 0, 6.0f } }, 2.0f };
+			runTrace(config, trace, 300, scales, times);
+
+			expect(countChanges(scales, 0, 300) == 0 && scales.back() == config.maxScale, trace.name, "scale should keep max");
+			LOG_INFO("Dynamic resolution validate {0}: final scale {1:.2f}.", trace.name, scales.back());
+		}
+
+		// Spike, drop fast and recover after.
+		{
+			const Trace trace{ "Spike", { { 0, 10.0f }, { 100, 30.0f }, { 200, 10.0f } }, 2.0f };
+			runTrace(config, trace, 800, scales, times);
+
+			expect(countOver(times, target, 110, 200) == 0, trace.name, "frames over target after spike react");
+			expect(scales[199] < config.maxScale, trace.name, "scale should drop in spike");
+			expect(scales.back() == config.maxScale, trace.name, "scale should recover after spike");
+			LOG_INFO("Dynamic resolution validate {0}: spike scale {1:.2f}, {2} spike frames over target, final scale {3:.2f}.",
+				trace.name, scales[199], countOver(times, target, 100, 200), scales.back());
+		}
+
+		// Too heavy even at min scale, clamp to bound.
+		{
+			const Trace trace{ "Bound", { { 0, 200.0f } }, 2.0f };
+			runTrace(config, trace, 300, scales, times);
+
+			const bool bInBound = std::all_of(scales.begin(), scales.end(), [&](float s) { return s >= config.minScale && s <= config.maxScale; });
+			expect(bInBound && scales.back() == config.minScale, trace.name, "scale should clamp to min");
+			LOG_INFO("Dynamic resolution validate {0}: final scale {1:.2f}.", trace.name, scales.back());
+		}
+
+		report.finish();
+	}
+}
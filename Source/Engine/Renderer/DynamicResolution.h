@@ -0,0 +1,71 @@
+#pragma once
+#include "../Core/Core.h"
+
+namespace Flower
+{
+	struct DynamicResolutionConfig
+	{
+		float targetFrameTimeMs = 16.6f;
+
+		// Render scale bound, relative to max render size.
+		float minScale = 0.5f;
+		float maxScale = 1.0f;
+
+		// Output scale quantize to step, render texture pool can reuse targets of few sizes.
+		float scaleStep = 0.05f;
+
+		// Aim gpu time under target * (1 - headroom), leave space for noise.
+		float headroom = 0.1f;
+
+		// PID gains on normalized frame time error.
+		float kp = 0.5f;
+		float ki = 0.05f;
+		float kd = 0.1f;
+
+		// Gpu time over target * panicRatio, jump to estimated scale immediately.
+		float panicRatio = 1.3f;
+
+		// Gpu timestamps read back few frames late, ignore samples after scale change.
+		uint32_t settleFrames = 4;
+
+		// Scale drop apply immediately, raise only when controller want higher scale this many frames.
+		uint32_t raiseFrames = 30;
+	};
+
+	// Pick render scale from gpu frame time, no gpu dependency so synthetic timing traces can drive it.
+	// Gpu cost roughly scale with pixel count, PID adjust scale multiplicative, output quantize with hysteresis.
+	class DynamicResolutionController
+	{
+	private:
+		DynamicResolutionConfig m_config;
+
+		// Quantized scale in use.
+		float m_scale = 1.0f;
+
+		// PID continuous scale before quantize.
+		float m_continuousScale = 1.0f;
+
+		float m_integral = 0.0f;
+		float m_prevError = 0.0f;
+
+		uint32_t m_settleCounter = 0;
+		uint32_t m_raiseCounter = 0;
+
+		float quantize(float scale) const;
+		void applyScale(float scale);
+
+	public:
+		void setConfig(const DynamicResolutionConfig& config) { m_config = config; }
+		const DynamicResolutionConfig& getConfig() const { return m_config; }
+
+		void reset(float scale);
+
+		// Feed gpu time of one frame, non positive time meaning no valid sample. Return render scale.
+		float update(float gpuFrameTimeMs);
+
+		float getScale() const { return m_scale; }
+
+		// Drive controller with synthetic gpu timing traces (steady heavy, light, spike, over bound), log result.
+		static void validate();
+	};
+}
@@ -0,0 +1,343 @@
+#include "Pch.h"
+#include "HeadlessBenchmark.h"
+#include "Renderer.h"
+#include "DeferredRenderer/DeferredRenderer.h"
+#include "../WindowData.h"
+
+#include <glm/gtc/packing.hpp>
+#include <stb/stb_image_write.h>
+
+namespace Flower
+{
+	BenchmarkCamera::BenchmarkCamera(std::vector<KeyFrame>&& keyFrames, float fovy, uint32_t width, uint32_t height)
+		: m_keyFrames(std::move(keyFrames))
+	{
+		if (m_keyFrames.empty())
+		{
+			m_keyFrames.push_back({});
+		}
+
+		m_fovy = glm::radians(fovy);
+		m_width = width;
+		m_height = height;
+
+		update(0.0f);
+	}
+
+	void BenchmarkCamera::update(float alpha)
+	{
+		// Find segment and local lerp factor.
+		const float segmentPos = glm::clamp(alpha, 0.0f, 1.0f) * float(m_keyFrames.size() - 1);
+		const size_t segmentId = std::min(size_t(segmentPos), m_keyFrames.size() - 1);
+		const size_t nextId = std::min(segmentId + 1, m_keyFrames.size() - 1);
+		const float localAlpha = segmentPos - float(segmentId);
+
+		const auto& a = m_keyFrames[segmentId];
+		const auto& b = m_keyFrames[nextId];
+
+		m_position = glm::mix(a.position, b.position, localAlpha);
+		const float yaw = glm::mix(a.yaw, b.yaw, localAlpha);
+		const float pitch = glm::clamp(glm::mix(a.pitch, b.pitch, localAlpha), -89.0f, 89.0f);
+
+		// Same with viewport camera.
+		glm::vec3 front;
+		front.x = cos(glm::radians(yaw)) * cos(glm::radians(pitch));
+		front.y = sin(glm::radians(pitch));
+		front.z = sin(glm::radians(yaw)) * cos(glm::radians(pitch));
+		m_front = glm::normalize(front);
+
+		m_right = glm::normalize(glm::cross(m_front, m_worldUp));
+		m_up = glm::normalize(glm::cross(m_right, m_front));
+
+		m_viewMatrix = glm::lookAt(m_position, m_position + m_front, m_up);
+
+		// reverse z.
+		m_projectMatrix = glm::perspective(m_fovy, getAspect(), m_zFar, m_zNear);
+	}
+
+	bool HeadlessBenchmark::Config::load(const std::filesystem::path& path, Config& out)
+	{
+		std::ifstream is(path);
+		if (!is.is_open())
+		{
+			LOG_ERROR("Can't open benchmark config {0}.", path.string());
+			return false;
+		}
+
+		const nlohmann::json json = nlohmann::json::parse(is, nullptr, false);
+		if (json.is_discarded())
+		{
+			LOG_ERROR("Benchmark config {0} is not a valid json.", path.string());
+			return false;
+		}
+
+		out.width = json.value("width", out.width);
+		out.height = json.value("height", out.height);
+		out.frames = std::max(1u, json.value("frames", out.frames));
+		out.warmupFrames = json.value("warmup", out.warmupFrames);
+		out.fovy = json.value("fovy", out.fovy);
+		out.projectPath = json.value("project", out.projectPath);
+		out.scenePath = json.value("scene", out.scenePath);
+		out.outputPath = json.value("output", out.outputPath);
+		out.imagePath = json.value("image", out.imagePath);
+		out.captureFrame = json.value("captureFrame", out.captureFrame);
+
+		if (json.contains("camera"))
+		{
+			for (const auto& key : json["camera"])
+			{
+				BenchmarkCamera::KeyFrame keyFrame{};
+				if (key.contains("position") && key["position"].size() == 3)
+				{
+					keyFrame.position = { key["position"][0].get<float>(), key["position"][1].get<float>(), key["position"][2].get<float>() };
+				}
+				keyFrame.yaw = key.value("yaw", keyFrame.yaw);
+				keyFrame.pitch = key.value("pitch", keyFrame.pitch);
+
+				out.cameraPath.push_back(keyFrame);
+			}
+		}
+
+		return true;
+	}
+
+	void HeadlessBenchmark::init(const Config& config)
+	{
+		m_config = config;
+		m_config.width = glm::clamp(m_config.width, (uint32_t)GMinRenderDim, (uint32_t)GMaxRenderDim);
+		m_config.height = glm::clamp(m_config.height, (uint32_t)GMinRenderDim, (uint32_t)GMaxRenderDim);
+
+		m_renderer = GEngine->getRuntimeModule<Renderer>();
+		CHECK(m_renderer->isHeadless() && "Benchmark should run in headless mode.");
+
+		auto cameraPath = m_config.cameraPath;
+		m_camera = std::make_unique<BenchmarkCamera>(std::move(cameraPath), m_config.fovy, m_config.width, m_config.height);
+
+		m_deferredRenderer = std::make_unique<DeferredRenderer>("BenchmarkRenderer", m_camera.get());
+		m_deferredRenderer->init();
+		m_deferredRenderer->updateRenderSize(m_config.width, m_config.height, 1.0f, 1.0f);
+
+		if (!m_config.imagePath.empty())
+		{
+			const VkDeviceSize size = VkDeviceSize(m_deferredRenderer->getDisplayWidth()) * m_deferredRenderer->getDisplayHeight() * sizeof(uint16_t) * 4;
+			m_readbackBuffer = VulkanBuffer::create(
+				"BenchmarkReadback",
+				VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+				VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_CACHED_BIT,
+				EVMAUsageFlags::Readback,
+				size
+			);
+		}
+
+		m_rendererDelegate = m_renderer->rendererTickHooks.addRaw(this, &HeadlessBenchmark::onRendererTick);
+		m_rendererPostDelegate = m_renderer->rendererPostTickHooks.addRaw(this, &HeadlessBenchmark::onRendererPostTick);
+
+		LOG_INFO("Headless benchmark start: {0}x{1}, {2} warmup frames, {3} frames.",
+			m_config.width, m_config.height, m_config.warmupFrames, m_config.frames);
+	}
+
+	void HeadlessBenchmark::release()
+	{
+		m_renderer->rendererTickHooks.remove(m_rendererDelegate);
+		m_renderer->rendererPostTickHooks.remove(m_rendererPostDelegate);
+
+		writeReport();
+		writeImage();
+
+		m_readbackBuffer = nullptr;
+		m_deferredRenderer->release();
+		m_deferredRenderer.reset();
+		m_camera.reset();
+	}
+
+	void HeadlessBenchmark::onRendererTick(const RuntimeModuleTickData& tickData, VkCommandBuffer graphicsCmd)
+	{
+		if (m_bFinish)
+		{
+			return;
+		}
+
+		const uint32_t totalFrames = m_config.warmupFrames + m_config.frames;
+
+		// Warmup frames stay on first key frame, then walk whole path.
+		const uint32_t pathFrame = m_frameIndex > m_config.warmupFrames ? m_frameIndex - m_config.warmupFrames : 0;
+		m_camera->update(m_config.frames > 1 ? float(pathFrame) / float(m_config.frames - 1) : 0.0f);
+
+		m_deferredRenderer->tick(tickData, graphicsCmd);
+
+		m_bCollectRecordTiming = (m_frameIndex >= m_config.warmupFrames);
+		if (m_bCollectRecordTiming)
+		{
+			collectTimings(tickData);
+		}
+
+		const uint32_t captureFrame = m_config.captureFrame >= 0 ? uint32_t(m_config.captureFrame) : totalFrames - 1;
+		if (m_readbackBuffer && m_frameIndex == std::min(captureFrame, totalFrames - 1))
+		{
+			recordCapture(graphicsCmd);
+		}
+
+		m_frameIndex++;
+		if (m_frameIndex >= totalFrames)
+		{
+			m_bFinish = true;
+			GLFWWindowData::get()->setShouldRun(false);
+		}
+	}
+
+	void HeadlessBenchmark::onRendererPostTick(const RuntimeModuleTickData& tickData)
+	{
+		if (m_bCollectRecordTiming)
+		{
+			m_recordTimings.microseconds.push_back(m_renderer->getRecordTimings().worldMicroseconds);
+			m_bCollectRecordTiming = false;
+		}
+	}
+
+	void HeadlessBenchmark::collectTimings(const RuntimeModuleTickData& tickData)
+	{
+		// Gpu timings resolve late some frames, just merge all values we get.
+		for (const auto& timeStamp : m_deferredRenderer->getTimingValues())
+		{
+			auto it = m_passTimings.find(timeStamp.label);
+			if (it == m_passTimings.end())
+			{
+				m_labelOrder.push_back(timeStamp.label);
+				it = m_passTimings.emplace(timeStamp.label, TimingSamples{}).first;
+			}
+			it->second.microseconds.push_back(timeStamp.microseconds);
+		}
+
+		m_frameTimings.microseconds.push_back(tickData.deltaTime * 1e6f);
+	}
+
+	void HeadlessBenchmark::recordCapture(VkCommandBuffer graphicsCmd)
+	{
+		auto& image = m_deferredRenderer->getDisplayOutput();
+		const auto range = buildBasicImageSubresource();
+		const VkImageLayout srcLayout = image.getCurrentLayout(0);
+
+		image.transitionLayout(graphicsCmd, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, range);
+
+		VkBufferImageCopy region{};
+		region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		region.imageSubresource.mipLevel = 0;
+		region.imageSubresource.baseArrayLayer = 0;
+		region.imageSubresource.layerCount = 1;
+		region.imageExtent = image.getExtent();
+
+		vkCmdCopyImageToBuffer(graphicsCmd, image.getImage(), VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, *m_readbackBuffer, 1, &region);
+
+		image.transitionLayout(graphicsCmd, srcLayout, range);
+		m_bImageCaptured = true;
+	}
+
+	void HeadlessBenchmark::writeReport() const
+	{
+		auto buildStat = [](const TimingSamples& samples)
+		{
+			nlohmann::json stat = nlohmann::json::object();
+			if (samples.microseconds.empty())
+			{
+				return stat;
+			}
+
+			std::vector<float> sorted = samples.microseconds;
+			std::sort(sorted.begin(), sorted.end());
+
+			auto percentile = [&](float p)
+			{
+				return sorted[std::min(sorted.size() - 1, size_t(p * float(sorted.size() - 1) + 0.5f))];
+			};
+
+			double sum = 0.0;
+			for (float v : sorted)
+			{
+				sum += v;
+			}
+
+			stat["samples"] = sorted.size();
+			stat["avgUs"] = sum / double(sorted.size());
+			stat["minUs"] = sorted.front();
+			stat["maxUs"] = sorted.back();
+			stat["p50Us"] = percentile(0.50f);
+			stat["p95Us"] = percentile(0.95f);
+			stat["p99Us"] = percentile(0.99f);
+			return stat;
+		};
+
+		nlohmann::json report;
+		report["device"] = std::string(RHI::get()->getPhysicalDeviceProperties().deviceName);
+		report["width"] = m_config.width;
+		report["height"] = m_config.height;
+		report["frames"] = m_config.frames;
+		report["warmup"] = m_config.warmupFrames;
+		report["frameTime"] = buildStat(m_frameTimings);
+		report["cpuRecord"] = buildStat(m_recordTimings);
+
+		// Labels start with "CPU " are cpu record scopes, others are gpu timestamps.
+		nlohmann::json gpuPasses = nlohmann::json::array();
+		nlohmann::json cpuPasses = nlohmann::json::array();
+		for (const auto& label : m_labelOrder)
+		{
+			nlohmann::json pass = buildStat(m_passTimings.at(label));
+			pass["name"] = label;
+
+			if (label.starts_with("CPU "))
+			{
+				cpuPasses.push_back(pass);
+			}
+			else
+			{
+				gpuPasses.push_back(pass);
+			}
+		}
+		report["gpuPasses"] = gpuPasses;
+		report["cpuPasses"] = cpuPasses;
+
+		std::ofstream os(m_config.outputPath);
+		if (!os.is_open())
+		{
+			LOG_ERROR("Can't write benchmark report {0}.", m_config.outputPath);
+			return;
+		}
+		os << report.dump(4);
+
+		LOG_INFO("Benchmark report write to {0}.", m_config.outputPath);
+	}
+
+	void HeadlessBenchmark::writeImage()
+	{
+		if (!m_readbackBuffer || !m_bImageCaptured)
+		{
+			return;
+		}
+
+		const uint32_t width = m_deferredRenderer->getDisplayWidth();
+		const uint32_t height = m_deferredRenderer->getDisplayHeight();
+
+		// Display output is half float rgba, tonemapper already map it to display range.
+		std::vector<uint8_t> pixels(size_t(width) * height * 4);
+
+		RHICheck(m_readbackBuffer->map());
+		m_readbackBuffer->invalidate();
+		{
+			const uint16_t* halfs = (const uint16_t*)m_readbackBuffer->mapped;
+			for (size_t i = 0; i < pixels.size(); i++)
+			{
+				const float v = (i % 4 == 3) ? 1.0f : glm::unpackHalf1x16(halfs[i]);
+				pixels[i] = uint8_t(glm::clamp(v, 0.0f, 1.0f) * 255.0f + 0.5f);
+			}
+		}
+		m_readbackBuffer->unmap();
+
+		if (stbi_write_png(m_config.imagePath.c_str(), width, height, 4, pixels.data(), width * 4))
+		{
+			LOG_INFO("Benchmark image write to {0}.", m_config.imagePath);
+		}
+		else
+		{
+			LOG_ERROR("Can't write benchmark image {0}.", m_config.imagePath);
+		}
+	}
+}
@@ -0,0 +1,130 @@
+#pragma once
+
+#include "RendererCommon.h"
+#include "../Scene/CameraInterface.h"
+
+namespace Flower
+{
+	class Renderer;
+	class DeferredRenderer;
+
+	// Scripted camera, lerp between key frames by frame index, so every run see same views.
+	class BenchmarkCamera : public CameraInterface
+	{
+	public:
+		struct KeyFrame
+		{
+			glm::vec3 position = { 0.0f, 10.0f, 0.0f };
+
+			// In degree, same with viewport camera.
+			float yaw = -90.0f;
+			float pitch = 0.0f;
+		};
+
+	private:
+		std::vector<KeyFrame> m_keyFrames;
+
+		glm::vec3 m_worldUp = { 0.0f, 1.0f, 0.0f };
+
+		glm::mat4 m_viewMatrix{ 1.0f };
+		glm::mat4 m_projectMatrix{ 1.0f };
+
+	public:
+		BenchmarkCamera(std::vector<KeyFrame>&& keyFrames, float fovy, uint32_t width, uint32_t height);
+
+		// Alpha in [0, 1] of whole camera path.
+		void update(float alpha);
+
+		virtual glm::mat4 getViewMatrix() const override
+		{
+			return m_viewMatrix;
+		}
+
+		virtual glm::mat4 getProjectMatrix() const override
+		{
+			return m_projectMatrix;
+		}
+	};
+
+	// Run deferred renderer offscreen for fixed frames, dump per pass timings and optional final image.
+	class HeadlessBenchmark : NonCopyable
+	{
+	public:
+		struct Config
+		{
+			uint32_t width = 1280;
+			uint32_t height = 720;
+
+			// Frames to record timings, warmup frames not record.
+			uint32_t frames = 300;
+			uint32_t warmupFrames = 30;
+
+			float fovy = 45.0f;
+			std::vector<BenchmarkCamera::KeyFrame> cameraPath;
+
+			// Optional project to load before run, .flower file.
+			std::string projectPath;
+
+			// Optional binary scene to load after project, .scene file.
+			std::string scenePath;
+
+			// Timing report json path.
+			std::string outputPath = "benchmark.json";
+
+			// Optional png output for golden image compare, capture at last frame if no set.
+			std::string imagePath;
+			int32_t captureFrame = -1;
+
+			static bool load(const std::filesystem::path& path, Config& out);
+		};
+
+	private:
+		struct TimingSamples
+		{
+			std::vector<float> microseconds;
+		};
+
+		Config m_config;
+		Renderer* m_renderer = nullptr;
+
+		std::unique_ptr<BenchmarkCamera> m_camera = nullptr;
+		std::unique_ptr<DeferredRenderer> m_deferredRenderer = nullptr;
+		DelegateHandle m_rendererDelegate;
+		DelegateHandle m_rendererPostDelegate;
+
+		uint32_t m_frameIndex = 0;
+		bool m_bFinish = false;
+
+		// Renderer write record timings after tick hooks, sample it in post tick of same frame.
+		bool m_bCollectRecordTiming = false;
+
+		// Keep label first appear order.
+		std::vector<std::string> m_labelOrder;
+		std::unordered_map<std::string, TimingSamples> m_passTimings;
+
+		TimingSamples m_frameTimings;
+		TimingSamples m_recordTimings;
+
+		// Display output readback.
+		std::shared_ptr<VulkanBuffer> m_readbackBuffer = nullptr;
+		bool m_bImageCaptured = false;
+
+	private:
+		void onRendererTick(const RuntimeModuleTickData& tickData, VkCommandBuffer graphicsCmd);
+		void onRendererPostTick(const RuntimeModuleTickData& tickData);
+
+		void collectTimings(const RuntimeModuleTickData& tickData);
+		void recordCapture(VkCommandBuffer graphicsCmd);
+
+		void writeReport() const;
+		void writeImage();
+
+	public:
+		void init(const Config& config);
+
+		// Call after device idle.
+		void release();
+
+		bool isFinish() const { return m_bFinish; }
+	};
+}
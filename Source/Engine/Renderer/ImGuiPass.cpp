@@ -90,7 +90,7 @@ namespace Flower
 			m_drawUIImages = VulkanImage::create("DrawUIImage", info, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
 		}
 
-		// Create Framebuffer & CommandBuffer
+		// Create Framebuffer
 		{
 			VkImageView attachment[1];
 			VkFramebufferCreateInfo info = {};
@@ -104,36 +104,12 @@ namespace Flower
 
 			auto backBufferSize = RHI::get()->getSwapchainImageViews().size();
 			m_renderResource.framebuffers.resize(backBufferSize);
-			m_renderResource.commandPools.resize(backBufferSize);
-			m_renderResource.commandBuffers.resize(backBufferSize);
 
 			for (uint32_t i = 0; i < backBufferSize; i++)
 			{
 				attachment[0] = m_drawUIImages->getView(buildBasicImageSubresource());
 				RHICheck(vkCreateFramebuffer(RHI::Device, &info, nullptr, &m_renderResource.framebuffers[i]));
 			}
-
-			for (uint32_t i = 0; i < backBufferSize; i++)
-			{
-				// Command pool
-				{
-					VkCommandPoolCreateInfo info = {};
-					info.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
-					info.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
-					info.queueFamilyIndex = RHI::get()->getGraphiscFamily();
-					RHICheck(vkCreateCommandPool(RHI::Device, &info, nullptr, &m_renderResource.commandPools[i]));
-				}
-
-				// Command buffer
-				{
-					VkCommandBufferAllocateInfo info = {};
-					info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-					info.commandPool = m_renderResource.commandPools[i];
-					info.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-					info.commandBufferCount = 1;
-					RHICheck(vkAllocateCommandBuffers(RHI::Device, &info, &m_renderResource.commandBuffers[i]));
-				}
-			}
 		}
 	}
 
@@ -150,14 +126,10 @@ namespace Flower
 		auto backBufferSize = m_renderResource.framebuffers.size();
 		for (uint32_t i = 0; i < backBufferSize; i++)
 		{
-			vkFreeCommandBuffers(RHI::Device, m_renderResource.commandPools[i], 1, &m_renderResource.commandBuffers[i]);
-			vkDestroyCommandPool(RHI::Device, m_renderResource.commandPools[i], nullptr);
 			vkDestroyFramebuffer(RHI::Device, m_renderResource.framebuffers[i], nullptr);
 		}
 
 		m_renderResource.framebuffers.resize(0);
-		m_renderResource.commandPools.resize(0);
-		m_renderResource.commandBuffers.resize(0);
 	}
 
 	void ImguiPass::init()
@@ -202,36 +174,25 @@ namespace Flower
 		ImGui_ImplVulkan_Init(&vkInitInfo, m_renderResource.renderPass);
 
 		// upload font texture to gpu.
+		RHI::executeImmediatelyMajorGraphics([](VkCommandBuffer cmd)
 		{
-			VkCommandPool command_pool = m_renderResource.commandPools[0];
-			VkCommandBuffer command_buffer = m_renderResource.commandBuffers[0];
-			RHICheck(vkResetCommandPool(RHI::Device, command_pool, 0));
-			VkCommandBufferBeginInfo begin_info = {};
-			begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-			begin_info.flags |= VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
-			RHICheck(vkBeginCommandBuffer(command_buffer, &begin_info));
-			ImGui_ImplVulkan_CreateFontsTexture(command_buffer);
-			VkSubmitInfo end_info = {};
-			end_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-			end_info.commandBufferCount = 1;
-			end_info.pCommandBuffers = &command_buffer;
-			RHICheck(vkEndCommandBuffer(command_buffer));
-			RHICheck(vkQueueSubmit(vkInitInfo.Queue, 1, &end_info, VK_NULL_HANDLE));
-			RHICheck(vkDeviceWaitIdle(vkInitInfo.Device));
-			ImGui_ImplVulkan_DestroyFontUploadObjects();
-		}
+			ImGui_ImplVulkan_CreateFontsTexture(cmd);
+		});
+		ImGui_ImplVulkan_DestroyFontUploadObjects();
 	}
 
-	void ImguiPass::renderFrame(uint32_t backBufferIndex)
+	VkCommandBuffer ImguiPass::renderFrame(uint32_t backBufferIndex)
 	{
 		ImDrawData* main_draw_data = ImGui::GetDrawData();
+
+		// Pool of this frame already reset by renderer when frame begin.
+		VkCommandBuffer cmd = RHI::get()->getThreadGraphicsCommandPools().allocate();
 		{
-			RHICheck(vkResetCommandPool(RHI::Device, m_renderResource.commandPools[backBufferIndex], 0));
 			VkCommandBufferBeginInfo info = {};
 			info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
 			info.flags |= VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
-			RHICheck(vkBeginCommandBuffer(m_renderResource.commandBuffers[backBufferIndex], &info));
-			RHI::setPerfMarkerBegin(m_renderResource.commandBuffers[backBufferIndex], "ImGUI", { 1.0f, 1.0f, 0.0f, 1.0f });
+			RHICheck(vkBeginCommandBuffer(cmd, &info));
+			RHI::setPerfMarkerBegin(cmd, "ImGUI", { 1.0f, 1.0f, 0.0f, 1.0f });
 		}
 		{
 			VkRenderPassBeginInfo info = {};
@@ -248,13 +209,13 @@ namespace Flower
 			clearColor.color.float32[2] = m_clearColor.z * m_clearColor.w;
 			clearColor.color.float32[3] = m_clearColor.w;
 			info.pClearValues = &clearColor;
-			vkCmdBeginRenderPass(m_renderResource.commandBuffers[backBufferIndex], &info, VK_SUBPASS_CONTENTS_INLINE);
+			vkCmdBeginRenderPass(cmd, &info, VK_SUBPASS_CONTENTS_INLINE);
 		}
 
-		ImGui_ImplVulkan_RenderDrawData(main_draw_data, m_renderResource.commandBuffers[backBufferIndex]);
+		ImGui_ImplVulkan_RenderDrawData(main_draw_data, cmd);
 
-		vkCmdEndRenderPass(m_renderResource.commandBuffers[backBufferIndex]);
-		RHI::setPerfMarkerEnd(m_renderResource.commandBuffers[backBufferIndex]);
+		vkCmdEndRenderPass(cmd);
+		RHI::setPerfMarkerEnd(cmd);
 
 		VkImageMemoryBarrier barrier{};
 		barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
@@ -267,7 +228,7 @@ namespace Flower
 		barrier.srcAccessMask = 0;
 		barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
 		vkCmdPipelineBarrier(
-			m_renderResource.commandBuffers[backBufferIndex],
+			cmd,
 			VK_PIPELINE_STAGE_ALL_GRAPHICS_BIT,
 			VK_PIPELINE_STAGE_TRANSFER_BIT,
 			{},
@@ -299,7 +260,7 @@ namespace Flower
 		copyRegion.srcOffsets[1] = { (int)m_drawUIImages.get()->getExtent().width, (int)m_drawUIImages.get()->getExtent().height, 1};
 		copyRegion.dstOffsets[1] = copyRegion.srcOffsets[1];
 
-		vkCmdBlitImage(m_renderResource.commandBuffers[backBufferIndex], 
+		vkCmdBlitImage(cmd, 
 			m_drawUIImages->getImage(), VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
 			RHI::get()->getSwapchainImages().at(backBufferIndex), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &copyRegion, VK_FILTER_NEAREST);
 
@@ -310,7 +271,7 @@ namespace Flower
 		barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
 		barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
 		vkCmdPipelineBarrier(
-			m_renderResource.commandBuffers[backBufferIndex],
+			cmd,
 			VK_PIPELINE_STAGE_TRANSFER_BIT,
 			VK_PIPELINE_STAGE_TRANSFER_BIT,
 			{},
@@ -326,7 +287,8 @@ namespace Flower
 
 		// VK_IMAGE_LAYOUT_PRESENT_SRC_KHR
 
-		RHICheck(vkEndCommandBuffer(m_renderResource.commandBuffers[backBufferIndex]));
+		RHICheck(vkEndCommandBuffer(cmd));
+		return cmd;
 	}
 
 	void ImguiPass::release()
@@ -16,8 +16,6 @@ namespace Flower
 			VkRenderPass renderPass = VK_NULL_HANDLE;
 
 			std::vector<VkFramebuffer>   framebuffers;
-			std::vector<VkCommandPool>   commandPools;
-			std::vector<VkCommandBuffer> commandBuffers;
 		} m_renderResource;
 
 		glm::vec4 m_clearColor{ 0.45f, 0.55f, 0.60f, 1.00f };
@@ -29,18 +27,13 @@ namespace Flower
 		void renderpassBuild();
 		void renderpassRelease(bool bFullRelease);
 
-	public:
-		VkCommandBuffer getCommandBuffer(uint32_t index)
-		{
-			return m_renderResource.commandBuffers[index];
-		}
-
 	public:
 		~ImguiPass() = default;
 
 		void init();
 		void release();
 
-		void renderFrame(uint32_t backBufferIndex);
+		// Record ui into one command buffer allocate from calling thread's frame command pool.
+		VkCommandBuffer renderFrame(uint32_t backBufferIndex);
 	};
 }
\ No newline at end of file
@@ -0,0 +1,596 @@
+#include "Pch.h"
+#include "LandscapeQuadtree.h"
+
+#include <random>
+#include <tuple>
+
+namespace Flower
+{
+	void LandscapeQuadtree::buildChunkMinMax(
+		const uint16_t* samples,
+		uint32_t width,
+		uint32_t height,
+		uint32_t chunkSize,
+		std::vector<uint16_t>& outMinMax)
+	{
+		CHECK(width >= 2 && height >= 2 && chunkSize > 0);
+
+		const uint32_t chunkCountX = getChunkCount(width, chunkSize);
+		const uint32_t chunkCountY = getChunkCount(height, chunkSize);
+		outMinMax.resize(size_t(chunkCountX) * chunkCountY * 2);
+
+		GThreadPool::get()->parallelFor(0, chunkCountY, [&](size_t begin, size_t end)
+		{
+			for (uint32_t chunkY = uint32_t(begin); chunkY < uint32_t(end); chunkY++)
+			{
+				const uint32_t y0 = chunkY * chunkSize;
+				const uint32_t y1 = std::min(y0 + chunkSize, height - 1);
+				for (uint32_t chunkX = 0; chunkX < chunkCountX; chunkX++)
+				{
+					const uint32_t x0 = chunkX * chunkSize;
+					const uint32_t x1 = std::min(x0 + chunkSize, width - 1);
+
+					uint16_t minValue = std::numeric_limits<uint16_t>::max();
+					uint16_t maxValue = 0;
+					for (uint32_t y = y0; y <= y1; y++)
+					{
+						const uint16_t* row = samples + size_t(y) * width;
+						for (uint32_t x = x0; x <= x1; x++)
+						{
+							minValue = std::min(minValue, row[x]);
+							maxValue = std::max(maxValue, row[x]);
+						}
+					}
+
+					const size_t chunkId = size_t(chunkY) * chunkCountX + chunkX;
+					outMinMax[chunkId * 2 + 0] = minValue;
+					outMinMax[chunkId * 2 + 1] = maxValue;
+				}
+			}
+		});
+	}
+
+	void LandscapeQuadtree::build(uint32_t width, uint32_t height, const std::vector<uint16_t>& chunkMinMax)
+	{
+		CHECK(width >= 2 && height >= 2);
+
+		m_width = width;
+		m_height = height;
+		m_levels.clear();
+
+		Level leaf{};
+		leaf.dimX = getChunkCount(width, kGridDim);
+		leaf.dimY = getChunkCount(height, kGridDim);
+		CHECK(chunkMinMax.size() == size_t(leaf.dimX) * leaf.dimY * 2);
+		leaf.minMax = chunkMinMax;
+		m_levels.push_back(std::move(leaf));
+
+		// Merge children until one root node.
+		while (m_levels.back().dimX > 1 || m_levels.back().dimY > 1)
+		{
+			const Level& child = m_levels.back();
+
+			Level parent{};
+			parent.dimX = divideRoundingUp(child.dimX, 2u);
+			parent.dimY = divideRoundingUp(child.dimY, 2u);
+			parent.minMax.resize(size_t(parent.dimX) * parent.dimY * 2);
+
+			for (uint32_t y = 0; y < parent.dimY; y++)
+			{
+				for (uint32_t x = 0; x < parent.dimX; x++)
+				{
+					uint16_t minValue = std::numeric_limits<uint16_t>::max();
+					uint16_t maxValue = 0;
+					for (uint32_t i = 0; i < 4; i++)
+					{
+						const uint32_t childX = x * 2 + (i & 1);
+						const uint32_t childY = y * 2 + (i >> 1);
+						if (childX < child.dimX && childY < child.dimY)
+						{
+							const size_t childId = size_t(childY) * child.dimX + childX;
+							minValue = std::min(minValue, child.minMax[childId * 2 + 0]);
+							maxValue = std::max(maxValue, child.minMax[childId * 2 + 1]);
+						}
+					}
+
+					const size_t nodeId = size_t(y) * parent.dimX + x;
+					parent.minMax[nodeId * 2 + 0] = minValue;
+					parent.minMax[nodeId * 2 + 1] = maxValue;
+				}
+			}
+
+			m_levels.push_back(std::move(parent));
+		}
+
+		updateLodRanges();
+	}
+
+	void LandscapeQuadtree::setConfig(const Config& config)
+	{
+		m_config = config;
+		updateLodRanges();
+	}
+
+	void LandscapeQuadtree::updateLodRanges()
+	{
+		float range = m_config.lod0Range > 0.0f ? m_config.lod0Range : 4.0f * kGridDim * m_config.sampleSpacing;
+
+		m_lodRanges.resize(m_levels.size());
+		for (auto& lodRange : m_lodRanges)
+		{
+			lodRange = range;
+			range *= 2.0f;
+		}
+	}
+
+	glm::vec2 LandscapeQuadtree::getMorphRange(uint32_t lod) const
+	{
+		const float prevRange = lod > 0 ? m_lodRanges.at(lod - 1) : 0.0f;
+		const float range = m_lodRanges.at(lod);
+		return glm::vec2(prevRange + (range - prevRange) * m_config.morphStartRatio, range);
+	}
+
+	LandscapeQuadtree::Bounds LandscapeQuadtree::getNodeBounds(uint32_t level, uint32_t x, uint32_t y) const
+	{
+		const Level& nodeLevel = m_levels.at(level);
+		const size_t nodeId = size_t(y) * nodeLevel.dimX + x;
+
+		const uint32_t nodeQuads = kGridDim << level;
+		const float heightUnit = m_config.heightScale / float(std::numeric_limits<uint16_t>::max());
+
+		Bounds bounds{};
+		bounds.min.x = float(x * nodeQuads) * m_config.sampleSpacing;
+		bounds.min.z = float(y * nodeQuads) * m_config.sampleSpacing;
+		bounds.max.x = float(std::min((x + 1) * nodeQuads, m_width - 1)) * m_config.sampleSpacing;
+		bounds.max.z = float(std::min((y + 1) * nodeQuads, m_height - 1)) * m_config.sampleSpacing;
+		bounds.min.y = float(nodeLevel.minMax[nodeId * 2 + 0]) * heightUnit;
+		bounds.max.y = float(nodeLevel.minMax[nodeId * 2 + 1]) * heightUnit;
+
+		bounds.min += m_config.origin;
+		bounds.max += m_config.origin;
+		return bounds;
+	}
+
+	float LandscapeQuadtree::getHeightDistance(const glm::vec3& camPos) const
+	{
+		if (!isValid())
+		{
+			return 0.0f;
+		}
+
+		const Bounds rootBounds = getNodeBounds(getLodCount() - 1, 0, 0);
+		return std::max({ rootBounds.min.y - camPos.y, camPos.y - rootBounds.max.y, 0.0f });
+	}
+
+	float LandscapeQuadtree::getViewDistance(const glm::vec3& camPos, float heightDistance, const Bounds& bounds)
+	{
+		const float dx = std::max({ bounds.min.x - camPos.x, camPos.x - bounds.max.x, 0.0f });
+		const float dz = std::max({ bounds.min.z - camPos.z, camPos.z - bounds.max.z, 0.0f });
+		return glm::sqrt(dx * dx + dz * dz + heightDistance * heightDistance);
+	}
+
+	float LandscapeQuadtree::getMaxViewDistance(const glm::vec3& camPos, float heightDistance, const Bounds& bounds)
+	{
+		const float dx = std::max(glm::abs(bounds.min.x - camPos.x), glm::abs(camPos.x - bounds.max.x));
+		const float dz = std::max(glm::abs(bounds.min.z - camPos.z), glm::abs(camPos.z - bounds.max.z));
+		return glm::sqrt(dx * dx + dz * dz + heightDistance * heightDistance);
+	}
+
+	bool LandscapeQuadtree::frustumIntersectBounds(const glm::vec4* frustumPlanes, const Bounds& bounds)
+	{
+		const glm::vec3 center = (bounds.min + bounds.max) * 0.5f;
+		const glm::vec3 extents = (bounds.max - bounds.min) * 0.5f;
+		for (uint32_t i = 0; i < 6; i++)
+		{
+			const glm::vec3 normal = glm::vec3(frustumPlanes[i]);
+			if (glm::dot(normal, center) + glm::dot(glm::abs(normal), extents) + frustumPlanes[i].w < 0.0f)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	LandscapeQuadtree::SelectedNode LandscapeQuadtree::buildSelectedNode(uint32_t level, uint32_t x, uint32_t y, uint32_t lod, uint32_t gridDim) const
+	{
+		const float nodeSize = float(kGridDim << level) * m_config.sampleSpacing;
+
+		SelectedNode node{};
+		node.origin = glm::vec2(m_config.origin.x + float(x) * nodeSize, m_config.origin.z + float(y) * nodeSize);
+		node.size = nodeSize;
+		node.lod = lod;
+		node.gridDim = gridDim;
+		node.bounds = getNodeBounds(level, x, y);
+		return node;
+	}
+
+	bool LandscapeQuadtree::selectNode(
+		uint32_t level,
+		uint32_t x,
+		uint32_t y,
+		const glm::vec3& camPos,
+		float heightDistance,
+		const glm::vec4* frustumPlanes,
+		std::vector<SelectedNode>& outNodes) const
+	{
+		const Bounds bounds = getNodeBounds(level, x, y);
+		const float distance = getViewDistance(camPos, heightDistance, bounds);
+		if (distance > m_lodRanges[level])
+		{
+			return false;
+		}
+
+		// Culled node also handled, parent no need draw it.
+		if (frustumPlanes && !frustumIntersectBounds(frustumPlanes, bounds))
+		{
+			return true;
+		}
+
+		if (level == 0 || distance > m_lodRanges[level - 1])
+		{
+			outNodes.push_back(buildSelectedNode(level, x, y, level, kGridDim));
+			return true;
+		}
+
+		const Level& childLevel = m_levels[level - 1];
+		for (uint32_t i = 0; i < 4; i++)
+		{
+			const uint32_t childX = x * 2 + (i & 1);
+			const uint32_t childY = y * 2 + (i >> 1);
+			if (childX >= childLevel.dimX || childY >= childLevel.dimY)
+			{
+				continue;
+			}
+
+			if (!selectNode(level - 1, childX, childY, camPos, heightDistance, frustumPlanes, outNodes))
+			{
+				// Child out of finer range, draw child area with this lod.
+				SelectedNode quarter = buildSelectedNode(level - 1, childX, childY, level, kGridDim / 2);
+				if (!frustumPlanes || frustumIntersectBounds(frustumPlanes, quarter.bounds))
+				{
+					outNodes.push_back(quarter);
+				}
+			}
+		}
+
+		return true;
+	}
+
+	void LandscapeQuadtree::select(const glm::vec3& camPos, const glm::vec4* frustumPlanes, std::vector<SelectedNode>& outNodes) const
+	{
+		outNodes.clear();
+		if (!isValid())
+		{
+			return;
+		}
+
+		selectNode(getLodCount() - 1, 0, 0, camPos, getHeightDistance(camPos), frustumPlanes, outNodes);
+	}
+
+	// Frustum planes point inside, extract from vulkan zero to one depth view projection.
+	static void buildFrustumPlanes(const glm::mat4& viewProj, glm::vec4 outPlanes[6])
+	{
+		const glm::mat4 m = glm::transpose(viewProj);
+		outPlanes[0] = m[3] + m[0]; // Left.
+		outPlanes[1] = m[3] - m[0]; // Right.
+		outPlanes[2] = m[3] + m[1]; // Bottom.
+		outPlanes[3] = m[3] - m[1]; // Top.
+		outPlanes[4] = m[2];        // Near.
+		outPlanes[5] = m[3] - m[2]; // Far.
+
+		for (uint32_t i = 0; i < 6; i++)
+		{
+			outPlanes[i] /= glm::length(glm::vec3(outPlanes[i]));
+		}
+	}
+
+	void LandscapeQuadtree::validate()
+	{
+		ValidateReport report("Landscape quadtree");
+
+		std::mt19937 random(31);
+		std::uniform_real_distribution<float> unitDist(0.0f, 1.0f);
+		auto range = [&](float minValue, float maxValue) { return minValue + (maxValue - minValue) * unitDist(random); };
+
+		uint64_t totalSelections = 0;
+		uint64_t totalNodes = 0;
+		uint64_t totalCulledNodes = 0;
+		uint32_t maxLodCount = 0;
+		for (uint32_t testCase = 0; testCase < 24; testCase++)
+		{
+			// Power of two plus one and odd size both.
+			const uint32_t width = (testCase % 3 == 0) ? (kGridDim << (testCase % 5)) + 1 : 2 + random() % 700;
+			const uint32_t height = (testCase % 3 == 0) ? width : 2 + random() % 700;
+
+			const float frequency = range(0.005f, 0.05f);
+			const float noise = range(0.0f, 0.2f);
+			std::vector<uint16_t> samples(size_t(width) * height);
+			for (uint32_t y = 0; y < height; y++)
+			{
+				for (uint32_t x = 0; x < width; x++)
+				{
+					const float wave = 0.5f + 0.25f * (glm::sin(float(x) * frequency) + glm::cos(float(y) * frequency * 1.3f));
+					const float value = glm::clamp(wave * (1.0f - noise) + unitDist(random) * noise, 0.0f, 1.0f);
+					samples[size_t(y) * width + x] = uint16_t(value * 65535.0f);
+				}
+			}
+
+			std::vector<uint16_t> chunkMinMax;
+			buildChunkMinMax(samples.data(), width, height, kGridDim, chunkMinMax);
+
+			// Brute force, sample on chunk edge belong to both chunks.
+			const uint32_t chunkCountX = getChunkCount(width, kGridDim);
+			const uint32_t chunkCountY = getChunkCount(height, kGridDim);
+			std::vector<uint16_t> referenceMinMax(size_t(chunkCountX) * chunkCountY * 2);
+			for (size_t i = 0; i < referenceMinMax.size(); i += 2)
+			{
+				referenceMinMax[i + 0] = std::numeric_limits<uint16_t>::max();
+				referenceMinMax[i + 1] = 0;
+			}
+			for (uint32_t y = 0; y < height; y++)
+			{
+				const uint32_t chunkY0 = (y == 0) ? 0 : std::min((y - 1) / kGridDim, chunkCountY - 1);
+				const uint32_t chunkY1 = std::min(y / kGridDim, chunkCountY - 1);
+				for (uint32_t x = 0; x < width; x++)
+				{
+					const uint32_t chunkX0 = (x == 0) ? 0 : std::min((x - 1) / kGridDim, chunkCountX - 1);
+					const uint32_t chunkX1 = std::min(x / kGridDim, chunkCountX - 1);
+					const uint16_t value = samples[size_t(y) * width + x];
+					for (uint32_t chunkY = chunkY0; chunkY <= chunkY1; chunkY++)
+					{
+						for (uint32_t chunkX = chunkX0; chunkX <= chunkX1; chunkX++)
+						{
+							const size_t chunkId = size_t(chunkY) * chunkCountX + chunkX;
+							referenceMinMax[chunkId * 2 + 0] = std::min(referenceMinMax[chunkId * 2 + 0], value);
+							referenceMinMax[chunkId * 2 + 1] = std::max(referenceMinMax[chunkId * 2 + 1], value);
+						}
+					}
+				}
+			}
+			report.expect(chunkMinMax == referenceMinMax, "chunk min max match brute force");
+
+			LandscapeQuadtree tree;
+			Config config{};
+			config.origin = glm::vec3(range(-500.0f, 500.0f), range(-50.0f, 50.0f), range(-500.0f, 500.0f));
+			config.sampleSpacing = range(0.5f, 4.0f);
+			config.heightScale = range(10.0f, 200.0f);
+			tree.setConfig(config);
+			tree.build(width, height, chunkMinMax);
+			maxLodCount = std::max(maxLodCount, tree.getLodCount());
+
+			const uint32_t rootLevel = tree.getLodCount() - 1;
+			report.expect(tree.getNodeCountX(rootLevel) == 1 && tree.getNodeCountY(rootLevel) == 1, "one root node");
+			report.expect((kGridDim << rootLevel) >= std::max(width, height) - 1, "root cover heightfield");
+
+			// Parent bounds contain children.
+			auto containBounds = [](const Bounds& outer, const Bounds& inner)
+			{
+				return glm::all(glm::lessThanEqual(outer.min, inner.min)) && glm::all(glm::greaterThanEqual(outer.max, inner.max));
+			};
+			for (uint32_t level = 1; level < tree.getLodCount(); level++)
+			{
+				for (uint32_t y = 0; y < tree.getNodeCountY(level); y++)
+				{
+					for (uint32_t x = 0; x < tree.getNodeCountX(level); x++)
+					{
+						const Bounds bounds = tree.getNodeBounds(level, x, y);
+						for (uint32_t i = 0; i < 4; i++)
+						{
+							const uint32_t childX = x * 2 + (i & 1);
+							const uint32_t childY = y * 2 + (i >> 1);
+							if (childX < tree.getNodeCountX(level - 1) && childY < tree.getNodeCountY(level - 1))
+							{
+								report.expect(containBounds(bounds, tree.getNodeBounds(level - 1, childX, childY)), "parent bounds contain child");
+							}
+						}
+					}
+				}
+			}
+
+			const uint32_t quadCountX = width - 1;
+			const uint32_t quadCountY = height - 1;
+			const Bounds rootBounds = tree.getNodeBounds(rootLevel, 0, 0);
+			for (uint32_t cameraCase = 0; cameraCase < 8; cameraCase++)
+			{
+				const glm::vec3 camPos = glm::vec3(
+					range(rootBounds.min.x, rootBounds.max.x),
+					rootBounds.max.y + range(0.5f, config.heightScale),
+					range(rootBounds.min.z, rootBounds.max.z));
+
+				std::vector<SelectedNode> nodes;
+				tree.select(camPos, nullptr, nodes);
+				totalSelections++;
+				totalNodes += nodes.size();
+
+				const float heightDistance = tree.getHeightDistance(camPos);
+
+				// Rasterize selection to quads, check no overlap, cover and lod neighbour.
+				std::vector<uint32_t> quadLods(size_t(quadCountX) * quadCountY, ~0u);
+				for (const auto& node : nodes)
+				{
+					report.expect(node.lod < tree.getLodCount(), "node lod valid");
+					report.expect(glm::abs(node.size - float(node.gridDim << node.lod) * config.sampleSpacing) < 1e-3f * node.size, "node grid spacing match lod");
+					report.expect(node.gridDim != kGridDim || getViewDistance(camPos, heightDistance, node.bounds) <= tree.getLodRange(node.lod), "full node inside lod range");
+					report.expect(node.lod == 0 || getViewDistance(camPos, heightDistance, node.bounds) > tree.getLodRange(node.lod - 1), "node out of finer lod range");
+
+					// Node edge full morph before coarser neighbour start morph.
+					if (node.lod + 1 < tree.getLodCount())
+					{
+						report.expect(getMaxViewDistance(camPos, heightDistance, node.bounds) <= tree.getMorphRange(node.lod + 1).x, "node inside coarser lod morph start");
+					}
+
+					const uint32_t quadX0 = uint32_t(std::round((node.origin.x - config.origin.x) / config.sampleSpacing));
+					const uint32_t quadY0 = uint32_t(std::round((node.origin.y - config.origin.z) / config.sampleSpacing));
+					const uint32_t nodeQuads = node.gridDim << node.lod;
+					for (uint32_t y = quadY0; y < std::min(quadY0 + nodeQuads, quadCountY); y++)
+					{
+						for (uint32_t x = quadX0; x < std::min(quadX0 + nodeQuads, quadCountX); x++)
+						{
+							auto& quadLod = quadLods[size_t(y) * quadCountX + x];
+							report.expect(quadLod == ~0u, "selected nodes no overlap");
+							quadLod = node.lod;
+						}
+					}
+				}
+
+				// Whole heightfield inside root range must full cover.
+				const bool bFullCover = getMaxViewDistance(camPos, heightDistance, rootBounds) <= tree.getLodRange(rootLevel);
+
+				for (uint32_t y = 0; y < quadCountY; y++)
+				{
+					for (uint32_t x = 0; x < quadCountX; x++)
+					{
+						const uint32_t lod = quadLods[size_t(y) * quadCountX + x];
+						if (bFullCover)
+						{
+							report.expect(lod != ~0u, "selected nodes cover heightfield");
+						}
+
+						// Morph only reach next lod, neighbour lod difference must be one at most.
+						if (lod != ~0u && x + 1 < quadCountX && quadLods[size_t(y) * quadCountX + x + 1] != ~0u)
+						{
+							const uint32_t right = quadLods[size_t(y) * quadCountX + x + 1];
+							report.expect(std::max(lod, right) - std::min(lod, right) <= 1, "neighbour lod difference");
+						}
+						if (lod != ~0u && y + 1 < quadCountY && quadLods[size_t(y + 1) * quadCountX + x] != ~0u)
+						{
+							const uint32_t up = quadLods[size_t(y + 1) * quadCountX + x];
+							report.expect(std::max(lod, up) - std::min(lod, up) <= 1, "neighbour lod difference");
+						}
+					}
+				}
+
+				// Frustum culled selection equal to selection filter by frustum.
+				const glm::vec3 forward = glm::normalize(glm::vec3(range(-1.0f, 1.0f), range(-1.0f, 0.2f), range(-1.0f, 1.0f)));
+				const glm::mat4 view = glm::lookAt(camPos, camPos + forward, glm::vec3(0.0f, 1.0f, 0.0f));
+				const glm::mat4 proj = glm::perspective(glm::radians(range(30.0f, 90.0f)), range(1.0f, 2.0f), 0.1f, range(50.0f, 5000.0f));
+				glm::vec4 planes[6];
+				buildFrustumPlanes(proj * view, planes);
+
+				std::vector<SelectedNode> culledNodes;
+				tree.select(camPos, planes, culledNodes);
+
+				std::vector<SelectedNode> referenceNodes;
+				for (const auto& node : nodes)
+				{
+					if (frustumIntersectBounds(planes, node.bounds))
+					{
+						referenceNodes.push_back(node);
+					}
+				}
+				totalCulledNodes += nodes.size() - culledNodes.size();
+
+				auto nodeLess = [](const SelectedNode& a, const SelectedNode& b)
+				{
+					return std::tie(a.origin.x, a.origin.y, a.size, a.lod) < std::tie(b.origin.x, b.origin.y, b.size, b.lod);
+				};
+				std::sort(culledNodes.begin(), culledNodes.end(), nodeLess);
+				std::sort(referenceNodes.begin(), referenceNodes.end(), nodeLess);
+
+				bool bSame = culledNodes.size() == referenceNodes.size();
+				for (size_t i = 0; bSame && i < culledNodes.size(); i++)
+				{
+					bSame = !nodeLess(culledNodes[i], referenceNodes[i]) && !nodeLess(referenceNodes[i], culledNodes[i]) && culledNodes[i].gridDim == referenceNodes[i].gridDim;
+				}
+				report.expect(bSame, "frustum culled selection match filtered selection");
+			}
+		}
+
+		LOG_INFO("Landscape quadtree validate: {0} selections, avg {1:.1f} nodes, {2} nodes frustum culled, max {3} lods.",
+			totalSelections, double(totalNodes) / double(std::max<uint64_t>(totalSelections, 1)), totalCulledNodes, maxLodCount);
+
+		report.finish();
+	}
+
+	void LandscapeQuadtree::benchmark(uint32_t sampleDim)
+	{
+		using Clock = std::chrono::high_resolution_clock;
+		auto elapsedMs = [](Clock::time_point start)
+		{
+			return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+		};
+
+		const uint32_t width = sampleDim + 1;
+		const float sampleSpacing = 1.0f;
+		const float heightScale = 1000.0f;
+
+		// Few octaves of waves, fixed so every run same heightfield.
+		std::vector<uint16_t> samples(size_t(width) * width);
+		GThreadPool::get()->parallelFor(0, width, [&](size_t begin, size_t end)
+		{
+			for (uint32_t y = uint32_t(begin); y < uint32_t(end); y++)
+			{
+				for (uint32_t x = 0; x < width; x++)
+				{
+					float value = 0.0f;
+					float amplitude = 0.5f;
+					float frequency = 0.002f;
+					for (uint32_t octave = 0; octave < 5; octave++)
+					{
+						value += amplitude * glm::sin(float(x) * frequency + float(octave)) * glm::cos(float(y) * frequency * 1.1f + float(octave) * 0.7f);
+						amplitude *= 0.5f;
+						frequency *= 2.1f;
+					}
+					samples[size_t(y) * width + x] = uint16_t(glm::clamp(value + 0.5f, 0.0f, 1.0f) * 65535.0f);
+				}
+			}
+		}, 16);
+
+		auto boundsStart = Clock::now();
+		std::vector<uint16_t> chunkMinMax;
+		buildChunkMinMax(samples.data(), width, width, kGridDim, chunkMinMax);
+		const double boundsMs = elapsedMs(boundsStart);
+
+		LandscapeQuadtree tree;
+		Config config{};
+		config.sampleSpacing = sampleSpacing;
+		config.heightScale = heightScale;
+		tree.setConfig(config);
+
+		auto buildStart = Clock::now();
+		tree.build(width, width, chunkMinMax);
+		const double buildMs = elapsedMs(buildStart);
+
+		std::mt19937 rng(1234u);
+		std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+		const float worldSize = float(sampleDim) * sampleSpacing;
+		const glm::mat4 proj = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 20000.0f);
+
+		const uint32_t selectionCount = 1000;
+		std::vector<SelectedNode> nodes;
+		double totalSelectMs = 0.0;
+		double maxSelectMs = 0.0;
+		uint64_t totalNodes = 0;
+		size_t maxNodes = 0;
+		uint64_t totalVertices = 0;
+		for (uint32_t i = 0; i < selectionCount; i++)
+		{
+			const glm::vec3 camPos = glm::vec3(unit(rng) * worldSize, heightScale * 0.5f + 2.0f + unit(rng) * 300.0f, unit(rng) * worldSize);
+			const float yaw = unit(rng) * glm::two_pi<float>();
+			const glm::vec3 forward = glm::normalize(glm::vec3(glm::cos(yaw), -0.2f, glm::sin(yaw)));
+			glm::vec4 planes[6];
+			buildFrustumPlanes(proj * glm::lookAt(camPos, camPos + forward, glm::vec3(0.0f, 1.0f, 0.0f)), planes);
+
+			auto selectStart = Clock::now();
+			tree.select(camPos, planes, nodes);
+			const double selectMs = elapsedMs(selectStart);
+
+			totalSelectMs += selectMs;
+			maxSelectMs = std::max(maxSelectMs, selectMs);
+			totalNodes += nodes.size();
+			maxNodes = std::max(maxNodes, nodes.size());
+			for (const auto& node : nodes)
+			{
+				totalVertices += node.gridDim * node.gridDim * 6;
+			}
+		}
+
+		const double areaKm2 = double(worldSize) * double(worldSize) / 1e6;
+		LOG_INFO("Landscape quadtree benchmark: {0}x{0} samples, {1:.2f} km2 at {2} m, {3} lods, {4} leaf chunks.",
+			width, areaKm2, sampleSpacing, tree.getLodCount(), chunkMinMax.size() / 2);
+		LOG_INFO("Landscape quadtree benchmark: chunk bounds {0:.2f} ms, quadtree build {1:.2f} ms.", boundsMs, buildMs);
+		LOG_INFO("Landscape quadtree benchmark: {0} selections, avg {1:.4f} ms, max {2:.4f} ms, avg {3:.1f} nodes, max {4} nodes, avg {5:.0f} vertices.",
+			selectionCount, totalSelectMs / selectionCount, maxSelectMs, double(totalNodes) / selectionCount, maxNodes, double(totalVertices) / selectionCount);
+	}
+}
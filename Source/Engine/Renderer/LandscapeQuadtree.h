@@ -0,0 +1,150 @@
+#pragma once
+#include "Parameters.h"
+
+namespace Flower
+{
+	// CDLOD quadtree of one heightfield, see Landscape.glsl.
+	// Leaf node cover kGridDim quads, each level up double node size and lod, root level is one node.
+	// All selected nodes draw same shared grid, so lod L vertex spacing is 2^L samples. Node at lod L select inside lod range L,
+	// vertex morph to lod L + 1 grid when close to range L, so edge keep match with coarser neighbour.
+	//
+	// View distance is xz distance with camera height out of heightfield range, not full 3d distance, so adjacent nodes distance
+	// differ at most their xz size even on cliffs, which keep neighbour lod difference at most one.
+	//
+	// Cpu only, no vulkan object inside.
+	class LandscapeQuadtree
+	{
+	public:
+		static constexpr uint32_t kGridDim = 32;
+
+		struct Config
+		{
+			// World position of sample (0, 0) with zero height.
+			glm::vec3 origin = glm::vec3(0.0f);
+
+			// World size of one quad.
+			float sampleSpacing = 1.0f;
+
+			// World height of max sample value.
+			float heightScale = 1.0f;
+
+			// Lod 0 view range, lod L range is lod0Range * 2^L. Zero use four leaf node size.
+			float lod0Range = 0.0f;
+
+			// Fraction between prev lod range and lod range where morph start.
+			float morphStartRatio = 0.7f;
+		};
+
+		struct Bounds
+		{
+			glm::vec3 min;
+			glm::vec3 max;
+		};
+
+		struct SelectedNode
+		{
+			// World xz of node min corner and node world size, may out of heightfield on edge nodes.
+			glm::vec2 origin;
+			float size;
+
+			uint32_t lod;
+
+			// Grid quads per side, kGridDim for full node, kGridDim / 2 for quarter draw with parent lod.
+			uint32_t gridDim;
+
+			// Xz clamp to heightfield.
+			Bounds bounds;
+		};
+
+	private:
+		struct Level
+		{
+			uint32_t dimX = 0;
+			uint32_t dimY = 0;
+
+			// Min and max sample of node, row major.
+			std::vector<uint16_t> minMax;
+		};
+
+		Config m_config { };
+
+		// Heightfield sample count.
+		uint32_t m_width = 0;
+		uint32_t m_height = 0;
+
+		// Level 0 is leaf.
+		std::vector<Level> m_levels;
+		std::vector<float> m_lodRanges;
+
+	private:
+		void updateLodRanges();
+
+		// Return false when node out of its lod range, parent draw that area.
+		bool selectNode(
+			uint32_t level,
+			uint32_t x,
+			uint32_t y,
+			const glm::vec3& camPos,
+			float heightDistance,
+			const glm::vec4* frustumPlanes,
+			std::vector<SelectedNode>& outNodes) const;
+
+		SelectedNode buildSelectedNode(uint32_t level, uint32_t x, uint32_t y, uint32_t lod, uint32_t gridDim) const;
+
+	public:
+		static uint32_t getChunkCount(uint32_t sampleCount, uint32_t chunkSize)
+		{
+			return divideRoundingUp(std::max(sampleCount, 2u) - 1u, chunkSize);
+		}
+
+		// Chunk (x, y) cover samples [x * chunkSize, (x + 1) * chunkSize] include shared edge, two values per chunk.
+		static void buildChunkMinMax(
+			const uint16_t* samples,
+			uint32_t width,
+			uint32_t height,
+			uint32_t chunkSize,
+			std::vector<uint16_t>& outMinMax);
+
+		// Chunk min max build with kGridDim.
+		void build(uint32_t width, uint32_t height, const std::vector<uint16_t>& chunkMinMax);
+
+		void setConfig(const Config& config);
+		const Config& getConfig() const { return m_config; }
+
+		bool isValid() const { return !m_levels.empty(); }
+		uint32_t getLodCount() const { return uint32_t(m_levels.size()); }
+		uint32_t getWidth() const { return m_width; }
+		uint32_t getHeight() const { return m_height; }
+
+		uint32_t getNodeCountX(uint32_t level) const { return m_levels.at(level).dimX; }
+		uint32_t getNodeCountY(uint32_t level) const { return m_levels.at(level).dimY; }
+
+		float getLodRange(uint32_t lod) const { return m_lodRanges.at(lod); }
+
+		// .x morph start distance, .y morph end distance.
+		glm::vec2 getMorphRange(uint32_t lod) const;
+
+		// Node world bounds, xz clamp to heightfield.
+		Bounds getNodeBounds(uint32_t level, uint32_t x, uint32_t y) const;
+
+		// Camera distance out of heightfield height range, zero when camera height inside.
+		float getHeightDistance(const glm::vec3& camPos) const;
+
+		// Frustum planes point inside, same with GPUViewData::frustumPlanes, nullptr skip frustum culling.
+		void select(const glm::vec3& camPos, const glm::vec4* frustumPlanes, std::vector<SelectedNode>& outNodes) const;
+
+		// Lod view distance of closest point, see getHeightDistance.
+		static float getViewDistance(const glm::vec3& camPos, float heightDistance, const Bounds& bounds);
+
+		// Lod view distance of farthest point.
+		static float getMaxViewDistance(const glm::vec3& camPos, float heightDistance, const Bounds& bounds);
+
+		static bool frustumIntersectBounds(const glm::vec4* frustumPlanes, const Bounds& bounds);
+
+		// Random heightfields check chunk bounds and selection cover, lod neighbour and frustum culling, log result.
+		static void validate();
+
+		// Synthetic heightfield with sampleDim quads per side, log bounds build and selection time.
+		static void benchmark(uint32_t sampleDim);
+	};
+}
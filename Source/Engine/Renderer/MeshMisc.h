@@ -66,6 +66,25 @@ namespace Flower
 
 	};
 
+	// Max lod count of submesh, include lod0.
+	constexpr uint32_t GMaxStaticMeshLodCount = 4;
+
+	// Simplified index range of submesh, share vertices with lod0.
+	struct StaticMeshSubMeshLod
+	{
+		uint32_t indexStartPosition = 0;
+		uint32_t indexCount = 0;
+
+		// Object space error relative to lod0.
+		float error = 0.0f;
+
+		template<class Archive>
+		void serialize(Archive& archive)
+		{
+			archive(indexStartPosition, indexCount, error);
+		}
+	};
+
 	struct StaticMeshSubMesh
 	{
 		StaticMeshRenderBounds renderBounds = {};
@@ -73,10 +92,21 @@ namespace Flower
 		uint32_t indexCount = 0;
 		UUID material = {};
 
+		// Lod1 to lodN, error increase.
+		std::vector<StaticMeshSubMeshLod> lods = {};
+
 		template<class Archive>
-		void serialize(Archive& archive)
+		void serialize(Archive& archive, std::uint32_t const version)
 		{
 			archive(renderBounds, indexStartPosition, indexCount, material);
+
+			// Version 0 asset no lods.
+			if (version > 0)
+			{
+				archive(lods);
+			}
 		}
 	};
-}
\ No newline at end of file
+}
+
+CEREAL_CLASS_VERSION(Flower::StaticMeshSubMesh, 1);
\ No newline at end of file
@@ -47,21 +47,21 @@ namespace Flower
 	bool CPUStaticMeshStandardPBRMaterial::buildWithMaterialUUID(UUID materialId)
 	{
 		// Unvalid materials.
-		if (!AssetRegistryManager::get()->getHeaderMap().contains(materialId))
+		if (!AssetRegistryManager::get()->containsAsset(materialId))
 		{
 			return true; // always fallback.
 		}
 
 		bool bAllAssetReady = true;
 
-		auto header = std::dynamic_pointer_cast<StandardPBRMaterialHeader>(AssetRegistryManager::get()->getHeaderMap().at(materialId));
+		auto header = AssetRegistryManager::get()->getHeader<StandardPBRMaterialHeader>(materialId);
 
 		auto loadTex = [&](const UUID& in, std::shared_ptr<GPUImageAsset>& outId)
 		{
 			auto tex = TextureManager::get()->getImage(in);
 			if (tex == nullptr)
 			{
-				auto assetHeader = std::dynamic_pointer_cast<ImageAssetHeader>(AssetRegistryManager::get()->getHeaderMap().at(in));
+				auto assetHeader = AssetRegistryManager::get()->getHeader<ImageAssetHeader>(in);
 				tex = TextureManager::get()->getOrCreateImage(assetHeader);
 			}
 
@@ -64,6 +64,54 @@ namespace Flower
 		float pad2;
 	};
 
+	enum class ELocalLightType : uint32_t
+	{
+		Point = 0,
+		Spot,
+	};
+
+	// See LocalLightInfo struct in Common.glsl
+	struct GPULocalLightInfo
+	{
+		glm::vec3 color;
+		float intensity; // x4
+
+		glm::vec3 position;
+		float range; // x4
+
+		glm::vec3 direction; // Spot light forward.
+		uint32_t type; // x4
+
+		// Spot cone attenuation is saturate(dot(-L, direction) * spotScale + spotOffset).
+		// Point light use scale 0 and offset 1.
+		float spotScale;
+		float spotOffset;
+		float pad0;
+		float pad1; // x4
+
+		// World space bounding sphere for cluster culling, .w is radius.
+		glm::vec4 boundingSphere;
+	};
+
+	// See ClusterGrid struct in ClusteredLightCommon.glsl
+	struct GPUClusterGrid
+	{
+		uint32_t dimX;
+		uint32_t dimY;
+		uint32_t dimZ;
+		uint32_t tileSize; // x4
+
+		float zNear;  // First slice begin linear depth.
+		float zFar;   // Exponential slice end linear depth.
+		float zCameraFar; // Last slice extend to camera far.
+		uint32_t maxLightsPerCluster; // x4
+
+		uint32_t width;
+		uint32_t height;
+		uint32_t pad0;
+		uint32_t pad1; // x4
+	};
+
 	struct TonemapperParam
 	{
 		float tonemapper_P = 500.0f;  // Max brightness.
@@ -242,6 +290,13 @@ namespace Flower
 		glm::vec3 extents;
 		uint32_t bObjectMove;
 
+		// Lod index ranges, .x is lod0, zero index count lod no exist.
+		alignas(16) glm::uvec4 lodIndexStart;
+		glm::uvec4 lodIndexCount;
+
+		// Lod object space error, .x is lod0 always zero.
+		glm::vec4 lodError;
+
 		// Material.
 		GPUStaticMeshStandardPBRMaterial material;
 	};
@@ -278,4 +333,53 @@ namespace Flower
 		uint32_t z;
 		uint32_t pad;
 	};
+
+	constexpr uint32_t GMaxLandscapeLodCount = 16;
+
+	// See LandscapeNode in Landscape.glsl
+	struct GPULandscapeNode
+	{
+		// World xz of node min corner.
+		glm::vec2 origin;
+
+		// Node world size.
+		float size;
+		uint32_t lod;
+	};
+
+	// See LandscapeData in Landscape.glsl
+	struct GPULandscapeData
+	{
+		// World position of sample (0, 0) with zero height.
+		alignas(16) glm::vec3 origin;
+		float sampleSpacing;
+
+		alignas(16) glm::vec3 originPrev;
+		float heightScale;
+
+		// Heightfield sample count.
+		uint32_t width;
+		uint32_t height;
+
+		// Quads per tile side, tile texture store tileSize + 1 samples per side.
+		uint32_t tileSize;
+		uint32_t tileCountX;
+
+		uint32_t tileCountY;
+
+		// Coarse heightfield always resident, point sample every coarseStep samples.
+		uint32_t coarseTextureId;
+		uint32_t coarseStep;
+		uint32_t coarseWidth;
+
+		uint32_t coarseHeight;
+
+		// Camera distance out of heightfield height range, see LandscapeQuadtree.
+		float heightDistance;
+		uint32_t pad0;
+		uint32_t pad1;
+
+		// .x morph start distance, .y morph end distance.
+		glm::vec4 morphRanges[GMaxLandscapeLodCount];
+	};
 }
\ No newline at end of file
@@ -5,26 +5,125 @@
 #include "../Scene/Component/DirectionalLight.h"
 #include "../Scene/SceneManager.h"
 #include "../Scene/Component/DirectionalLight.h"
+#include "../Scene/Component/SpotLight.h"
+#include "../Scene/Component/PointLight.h"
+#include "../Scene/Component/Landscape.h"
 #include "RenderSettingContext.h"
+#include "ClusteredLighting.h"
 
 namespace Flower
 {
+	static AutoCVarInt32 cVarStaticMeshInstancing(
+		"r.StaticMesh.Instancing",
+		"Draw static meshes share same mesh, submesh and material with one instanced indirect draw per lod.",
+		"Render",
+		1,
+		CVarFlags::ReadAndWrite
+	);
+
+	static AutoCVarCmd cVarStaticMeshInstancingValidate("cmd.StaticMeshInstancing.Validate", "Check static mesh instance batching and culling compaction with cpu reference, log draw counts.");
+
 	// Loop all static mesh.
-	// This function is slow when static mesh is a lot.
+	// This function is slow when static mesh is a lot, so skip when scene object set and transforms keep same.
 	void RenderSceneData::staticMeshCollect(Scene* scene)
 	{
-		// TODO: Don't collect every tick, add some cache method.
+		// Node add, remove, static toggle or mesh and material change.
+		const bool bObjectSetChange =
+			scene != m_collectScene ||
+			scene->getComponentGeneration() != m_collectComponentGeneration ||
+			scene->getEditGeneration() != m_collectEditGeneration;
+
+		const bool bStaticTransformChange = scene->getStaticTransformGeneration() != m_collectStaticTransformGeneration;
+		const bool bTransformChange = scene->getTransformGeneration() != m_collectTransformGeneration;
+		const bool bInstancingChange = (cVarStaticMeshInstancing.get() != 0) != m_bInstancingEnable;
+
+		if (!bObjectSetChange && !bTransformChange && !m_bCollectObjectMove)
+		{
+			if (bInstancingChange)
+			{
+				instanceBatchBuild();
+			}
+			return;
+		}
+
+		m_collectScene = scene;
+		m_collectComponentGeneration = scene->getComponentGeneration();
+		m_collectEditGeneration = scene->getEditGeneration();
+		m_collectTransformGeneration = scene->getTransformGeneration();
+		m_collectStaticTransformGeneration = scene->getStaticTransformGeneration();
+
 		m_collectStaticMeshes.clear();
+
+		// Static node objects first, then movable objects.
+		std::vector<GPUPerObjectData> movableObjects;
 		scene->loopComponents<StaticMeshComponent>([&](std::shared_ptr<StaticMeshComponent> comp) 
 		{
-			comp->renderObjectCollect(m_collectStaticMeshes);
+			comp->renderObjectCollect(comp->getNode()->getStatic() ? m_collectStaticMeshes : movableObjects);
 		});
+		m_staticObjectCount = uint32_t(m_collectStaticMeshes.size());
+
+		if (bObjectSetChange || bStaticTransformChange)
+		{
+			m_staticObjectHash = 0;
+			for (uint32_t i = 0; i < m_staticObjectCount; i++)
+			{
+				// Prev frame data no affect static content.
+				GPUPerObjectData object = m_collectStaticMeshes[i];
+				object.modelMatrixPrev = glm::mat4(1.0f);
+				object.bObjectMove = 0;
+
+				m_staticObjectHash = hashCombine(m_staticObjectHash, CRCHash(object));
+			}
+		}
+
+		m_collectStaticMeshes.insert(m_collectStaticMeshes.end(), movableObjects.begin(), movableObjects.end());
+
+		m_bCollectObjectMove = false;
+		for (const auto& object : m_collectStaticMeshes)
+		{
+			m_bCollectObjectMove |= (object.bObjectMove != 0);
+		}
 
 		if (!m_collectStaticMeshes.empty())
 		{
 			m_staticMeshesObjectsPtr = m_bufferParametersRing->getStaticStorage("StaticMeshObjects", sizeof(GPUPerObjectData) * m_collectStaticMeshes.size());
 			m_staticMeshesObjectsPtr->buffer.updateDataPtr((void*)m_collectStaticMeshes.data());
 		}
+
+		// Batches only depend on object order, mesh and material, transform no affect.
+		if (bObjectSetChange || bInstancingChange)
+		{
+			instanceBatchBuild();
+		}
+	}
+
+	void RenderSceneData::instanceBatchBuild()
+	{
+		m_bInstancingEnable = cVarStaticMeshInstancing.get() != 0;
+		if (!m_bInstancingEnable || m_collectStaticMeshes.empty())
+		{
+			m_instanceBatches = { };
+			m_instancesPtr = nullptr;
+			m_instanceCommandsPtr = nullptr;
+			return;
+		}
+
+		m_instanceBatches = StaticMeshInstancing::buildBatches(m_collectStaticMeshes);
+		const auto commands = StaticMeshInstancing::buildDrawCommands(m_instanceBatches, m_collectStaticMeshes);
+
+		m_instancesPtr = m_bufferParametersRing->getStaticStorage("StaticMeshInstances", sizeof(GPUInstanceData) * m_instanceBatches.instances.size());
+		m_instancesPtr->buffer.updateDataPtr((void*)m_instanceBatches.instances.data());
+
+		// Copy to gpu indirect buffer every frame, culling only increase instance count.
+		m_instanceCommandsPtr = m_bufferParametersRing->getParameter(
+			true,
+			"StaticMeshInstanceCommandTemplate",
+			sizeof(GPUDrawIndirectCommand) * commands.size(),
+			VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+			VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+			EVMAUsageFlags::StageCopyForUpload,
+			VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+		m_instanceCommandsPtr->buffer.updateDataPtr((void*)commands.data());
 	}
 
 	void RenderSceneData::lightCollect(Scene* scene)
@@ -83,7 +182,54 @@ namespace Flower
 				sizeof(GPUCascadeInfo)* cascadeCount);
 		}
 
-		// TODO: Other light type gather.
+		// Gather local lights, point light first then spot light.
+		{
+			m_localLights.lights.clear();
+
+			scene->loopComponents<PointLightComponent>([&](std::shared_ptr<PointLightComponent> comp)
+			{
+				GPULocalLightInfo newLight{};
+				newLight.color = colorspace::srgb_2_rec2020(comp->getColor());
+				newLight.intensity = comp->getIntensity();
+				newLight.position = comp->getPosition();
+				newLight.range = comp->getRange();
+				newLight.direction = glm::vec3(0.0f, -1.0f, 0.0f);
+				newLight.type = uint32_t(ELocalLightType::Point);
+				newLight.spotScale = 0.0f;
+				newLight.spotOffset = 1.0f;
+				newLight.boundingSphere = glm::vec4(newLight.position, newLight.range);
+				m_localLights.lights.push_back(newLight);
+			});
+			m_localLights.pointLightCount = uint32_t(m_localLights.lights.size());
+
+			scene->loopComponents<SpotLightComponent>([&](std::shared_ptr<SpotLightComponent> comp)
+			{
+				const float cosInner = glm::cos(comp->getInnerConeAngle());
+				const float cosOuter = glm::cos(comp->getOuterConeAngle());
+
+				GPULocalLightInfo newLight{};
+				newLight.color = colorspace::srgb_2_rec2020(comp->getColor());
+				newLight.intensity = comp->getIntensity();
+				newLight.position = comp->getPosition();
+				newLight.range = comp->getRange();
+				newLight.direction = glm::vec3(comp->getDirection());
+				newLight.type = uint32_t(ELocalLightType::Spot);
+				newLight.spotScale = 1.0f / glm::max(cosInner - cosOuter, 1e-4f);
+				newLight.spotOffset = -cosOuter * newLight.spotScale;
+				newLight.boundingSphere = ClusteredLighting::getSpotBoundingSphere(
+					newLight.position, newLight.direction, newLight.range, comp->getOuterConeAngle());
+				m_localLights.lights.push_back(newLight);
+			});
+			m_localLights.spotLightCount = uint32_t(m_localLights.lights.size()) - m_localLights.pointLightCount;
+
+			// At least one element for descriptor.
+			m_localLightsPtr = m_bufferParametersRing->getStaticStorage("LocalLights",
+				sizeof(GPULocalLightInfo) * std::max(size_t(1), m_localLights.lights.size()));
+			if (!m_localLights.lights.empty())
+			{
+				m_localLightsPtr->buffer.updateDataPtr((void*)m_localLights.lights.data());
+			}
+		}
 	}
 
 	RenderSceneData::RenderSceneData()
@@ -91,8 +237,25 @@ namespace Flower
 		m_bufferParametersRing = std::make_unique<BufferParametersRing>();
 	}
 
+	void RenderSceneData::landscapeCollect(Scene* scene)
+	{
+		m_collectLandscapes.clear();
+		scene->loopComponents<LandscapeComponent>([&](std::shared_ptr<LandscapeComponent> comp)
+		{
+			if (comp->getNode()->getVisibility() && comp->isHeightmapAlreadySet())
+			{
+				m_collectLandscapes.push_back(comp);
+			}
+		});
+	}
+
 	void RenderSceneData::tick(const RuntimeModuleTickData& tickData)
 	{
+		CVarCmdHandle(cVarStaticMeshInstancingValidate, []()
+		{
+			StaticMeshInstancing::validate();
+		});
+
 		// Update buffer ring.
 		m_bufferParametersRing->tick();
 
@@ -104,6 +267,8 @@ namespace Flower
 
 		// Collect light.
 		lightCollect(activeScene);
+
+		landscapeCollect(activeScene);
 	}
 }
 
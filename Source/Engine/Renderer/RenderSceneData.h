@@ -2,9 +2,10 @@
 #include "RendererCommon.h"
 #include "Parameters.h"
 #include "BufferParameter.h"
+#include "StaticMeshInstancing.h"
 
 // Cross multi renderer scene data.
-// Update every frame.
+// Update every frame, static mesh objects only collect again when scene change.
 namespace Flower
 {
 	struct SceneImportLightInfos
@@ -13,16 +14,49 @@ namespace Flower
 		GPUDirectionalLightInfo directionalLights;
 	};
 
+	// Point and spot lights, point lights store first.
+	struct SceneLocalLightInfos
+	{
+		uint32_t pointLightCount = 0;
+		uint32_t spotLightCount = 0;
+		std::vector<GPULocalLightInfo> lights;
+	};
+
 	class Scene;
+	class LandscapeComponent;
 	class RenderSceneData : NonCopyable
 	{
 	private:
-		// Scene static mesh collect data.
+		// Scene static mesh collect data, objects of static node store first.
 		std::vector<GPUPerObjectData> m_collectStaticMeshes;
+		uint32_t m_staticObjectCount = 0;
+
+		// Hash of static node objects, change when static content change.
+		size_t m_staticObjectHash = 0;
+
+		// Instance batches of collect static meshes, empty when instancing disable.
+		StaticMeshInstancing::BatchList m_instanceBatches;
+		bool m_bInstancingEnable = false;
+
+		// Scene state of last collect, collect and upload again only when object set or transform change.
+		Scene* m_collectScene = nullptr;
+		uint64_t m_collectComponentGeneration = 0;
+		uint64_t m_collectEditGeneration = 0;
+		uint64_t m_collectTransformGeneration = 0;
+		uint64_t m_collectStaticTransformGeneration = 0;
+
+		// Last collect has moving objects, prev matrix still change next frame.
+		bool m_bCollectObjectMove = false;
+
+		// Landscapes, node selection and tile streaming run in landscape pass with view data.
+		std::vector<std::shared_ptr<LandscapeComponent>> m_collectLandscapes;
 
 		// Importance light infos.
 		SceneImportLightInfos m_importanceLights;
 
+		// Local lights for clustered lighting.
+		SceneLocalLightInfos m_localLights;
+
 		// Earth atmosphere info.
 		EarthAtmosphere m_earthAtmosphereInfo;
 
@@ -30,12 +64,20 @@ namespace Flower
 
 		BufferParamRefPointer m_cascsadeBufferInfos;
 		BufferParamRefPointer m_staticMeshesObjectsPtr;
+		BufferParamRefPointer m_localLightsPtr;
+		BufferParamRefPointer m_instancesPtr;
+		BufferParamRefPointer m_instanceCommandsPtr;
 
 	private:
 		// Collect scne static mesh.
 		void staticMeshCollect(Scene* scene);
 
+		// Group collect static meshes to instance batches and upload, only call when object set change.
+		void instanceBatchBuild();
+
 		void lightCollect(Scene* scene);
+
+		void landscapeCollect(Scene* scene);
 		
 
 	public:
@@ -45,6 +87,9 @@ namespace Flower
 		{
 			m_cascsadeBufferInfos = nullptr;
 			m_staticMeshesObjectsPtr = nullptr;
+			m_localLightsPtr = nullptr;
+			m_instancesPtr = nullptr;
+			m_instanceCommandsPtr = nullptr;
 		}
 
 		// Get collect static meshes infos.
@@ -53,21 +98,71 @@ namespace Flower
 			return m_collectStaticMeshes;
 		}
 
+		// Objects [0, count) come from static scene node.
+		uint32_t getStaticObjectCount() const
+		{
+			return m_staticObjectCount;
+		}
+
+		size_t getStaticObjectHash() const
+		{
+			return m_staticObjectHash;
+		}
+
 		BufferParamRefPointer getStaticMeshesObjectsPtr() const
 		{
 			return m_staticMeshesObjectsPtr;
 		}
 
+		// Static mesh draw with instance batches?
+		bool isInstancingEnable() const
+		{
+			return !m_instanceBatches.batches.empty();
+		}
+
+		const StaticMeshInstancing::BatchList& getInstanceBatches() const
+		{
+			return m_instanceBatches;
+		}
+
+		// GPUInstanceData array sort by batch.
+		BufferParamRefPointer getInstancesPtr() const
+		{
+			return m_instancesPtr;
+		}
+
+		// Draw command template with zero instance count, copy source of indirect buffer.
+		BufferParamRefPointer getInstanceCommandsPtr() const
+		{
+			return m_instanceCommandsPtr;
+		}
+
 		BufferParamRefPointer getCascadeInfoPtr() const
 		{
 			return m_cascsadeBufferInfos;
 		}
 
+		const auto& getCollectLandscapes() const
+		{
+			return m_collectLandscapes;
+		}
+
 		const auto& getImportanceLights() const
 		{
 			return m_importanceLights;
 		}
 
+		const auto& getLocalLights() const
+		{
+			return m_localLights;
+		}
+
+		// At least one element, check light count before use.
+		BufferParamRefPointer getLocalLightsPtr() const
+		{
+			return m_localLightsPtr;
+		}
+
 		const auto& getEarthAtmosphere() const
 		{
 			return m_earthAtmosphereInfo;
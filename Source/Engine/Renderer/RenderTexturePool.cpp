@@ -3,6 +3,17 @@
 
 namespace Flower
 {
+	RenderTexturePool::RenderTexturePool()
+	{
+		// Free render texture evict before any cached asset.
+		MemoryBudget::get()->registerConsumer(this, EMemoryBudgetCategory::RenderTarget, 0);
+	}
+
+	RenderTexturePool::~RenderTexturePool()
+	{
+		MemoryBudget::get()->unregisterConsumer(this);
+	}
+
 	bool RenderTexturePool::PoolImage::isValid()
 	{
 		return
@@ -154,12 +165,72 @@ namespace Flower
 
 		// Update free counter.
 		storage.poolInfo.m_freeCounter = m_innerCounter;
+		storage.freeBudgetFrame = MemoryBudget::get()->getFrame();
 		m_freeImages[in.m_hashId].push_back(storage);
 
 		// Mark tick state active so we can release free rt immediately.
 		m_bRecentRelease = true;
 	}
 
+	uint64_t RenderTexturePool::getBudgetUsage()
+	{
+		uint64_t usage = 0;
+		for (const auto& pools : { &m_freeImages, &m_busyImages })
+		{
+			for (const auto& pair : *pools)
+			{
+				for (const auto& storage : pair.second)
+				{
+					usage += storage.image->getMemorySize();
+				}
+			}
+		}
+		return usage;
+	}
+
+	RenderTexturePool::PoolImageStorage* RenderTexturePool::findEvictCandidate(size_t* outHashId)
+	{
+		PoolImageStorage* result = nullptr;
+		for (auto& pair : m_freeImages)
+		{
+			for (auto& storage : pair.second)
+			{
+				if (!result || storage.freeBudgetFrame < result->freeBudgetFrame)
+				{
+					result = &storage;
+					if (outHashId)
+					{
+						*outHashId = pair.first;
+					}
+				}
+			}
+		}
+		return result;
+	}
+
+	bool RenderTexturePool::getEvictCandidate(uint64_t& outLastUseFrame, uint64_t& outSize)
+	{
+		const auto* storage = findEvictCandidate();
+		if (!storage)
+		{
+			return false;
+		}
+
+		outLastUseFrame = storage->freeBudgetFrame;
+		outSize = storage->image->getMemorySize();
+		return true;
+	}
+
+	void RenderTexturePool::evictCandidate()
+	{
+		size_t hashId;
+		if (auto* storage = findEvictCandidate(&hashId))
+		{
+			auto& freeArray = m_freeImages[hashId];
+			freeArray.erase(freeArray.begin() + (storage - freeArray.data()));
+		}
+	}
+
 	void RenderTexturePool::tick()
 	{
 		poolSizeSafeCheck(m_freeImages.size());
@@ -4,10 +4,11 @@
 #include "RendererCommon.h"
 
 #include "../RHI/RHI.h"
+#include "../RHI/MemoryBudget.h"
 
 namespace Flower
 {
-	class RenderTexturePool : NonCopyable
+	class RenderTexturePool : public MemoryBudgetConsumer, NonCopyable
 	{
 	public:
 		class PoolImage
@@ -71,6 +72,9 @@ namespace Flower
 			std::shared_ptr<VulkanImage> image = nullptr;
 			PoolImage poolInfo;
 
+			// Memory budget frame when push to free pool.
+			uint64_t freeBudgetFrame = 0;
+
 			explicit PoolImageStorage(RenderTexturePool* inPool)
 				: poolInfo(PoolImage(inPool))
 			{
@@ -97,7 +101,17 @@ namespace Flower
 
 		void releasePoolImage(const PoolImage& in);
 
+		// Oldest free image, nullptr if free pool empty.
+		PoolImageStorage* findEvictCandidate(size_t* outHashId = nullptr);
+
 	public:
+		RenderTexturePool();
+		virtual ~RenderTexturePool();
+
+		virtual uint64_t getBudgetUsage() override;
+		virtual bool getEvictCandidate(uint64_t& outLastUseFrame, uint64_t& outSize) override;
+		virtual void evictCandidate() override;
+
 		std::shared_ptr<PoolImageRef> createPoolImage(
 			const char* name, 
 			uint32_t width, 
@@ -10,12 +10,20 @@ namespace Flower
 {
 	static AutoCVarFloat cVarRequireUIFPS(
 		"r.Render.UIFps",
-		"Require ui fps, if world renderer is slow, will skip some frame to keep a smooth fps.",
+		"Ui rebuild fps when r.ImGui.IdleThrottle on and no input, other frames reuse last draw data.",
 		"Render",
 		60,
 		CVarFlags::ReadAndWrite
 	);
 
+	static AutoCVarInt32 cVarParallelRecord(
+		"r.Render.ParallelRecord",
+		"Record ui command buffer on thread pool parallel with world renderer record, 0 is off, 1 is on.",
+		"Render",
+		1,
+		CVarFlags::ReadAndWrite
+	);
+
 	Renderer::Renderer(ModuleManager* in, std::string name)
 		: IRuntimeModule(in, name)
 	{
@@ -26,18 +34,21 @@ namespace Flower
 	{
 		RenderSettingManager::get()->reset();
 
-		UIManager::get()->init();
-		m_uiPass.init();
+		m_bHeadless = RHI::get()->isHeadless();
+		if (!m_bHeadless)
+		{
+			UIManager::get()->init();
+			m_uiPass.init();
+		}
 		m_sceneData = std::make_unique<RenderSceneData>();
 
-		// prepare common cmdbuffer and semaphore.
+		// prepare common semaphore, command buffer allocate from thread command pools per frame.
 		{
 			VkSemaphoreCreateInfo semaphoreInfo{};
 			semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
 
 			for (size_t i = 0; i < GBackBufferCount; i++)
 			{
-				m_dynamicGraphicsCommandBuffers[i] = RHI::get()->createMajorGraphicsCommandBuffer();
 				RHICheck(vkCreateSemaphore(RHI::Device, &semaphoreInfo, nullptr, &m_dynamicGraphicsCommandExecuteSemaphores[i]));
 			}
 		}
@@ -46,36 +57,149 @@ namespace Flower
 		return true;
 	}
 
+	void Renderer::tickHeadless(const RuntimeModuleTickData& tickData)
+	{
+		// Update scene data.
+		{
+			PROFILE_SCOPE("Scene Collect");
+			m_sceneData->tick(tickData);
+		}
+
+		// Just wait frame fence, no swapchain image acquire.
+		uint32_t backBufferIndex = RHI::get()->acquireNextPresentImage();
+		CHECK(backBufferIndex < GBackBufferCount && "Headless flighting count should equal to backbuffer count.");
+
+		StaticTexturesManager::get()->tick();
+
+		auto& threadPools = RHI::get()->getThreadGraphicsCommandPools();
+		threadPools.beginFrame(backBufferIndex);
+
+		const auto worldRecordStartPoint = std::chrono::high_resolution_clock::now();
+
+		VkCommandBuffer graphicsCmd = threadPools.allocate();
+		VkCommandBufferBeginInfo cmdBeginInfo = RHICommandbufferBeginInfo(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+		RHICheck(vkBeginCommandBuffer(graphicsCmd, &cmdBeginInfo));
+		{
+			if (RenderSettingManager::get()->ibl.needRebuild())
+			{
+				StaticTexturesManager::get()->rebuildIBL(graphicsCmd, false);
+			}
+
+			rendererTickHooks.broadcast(tickData, graphicsCmd);
+		}
+		RHICheck(vkEndCommandBuffer(graphicsCmd));
+
+		m_recordTimings.worldMicroseconds =
+			std::chrono::duration<float, std::micro>(std::chrono::high_resolution_clock::now() - worldRecordStartPoint).count();
+		m_recordTimings.uiMicroseconds = 0.0f;
+		m_recordTimings.bParallel = false;
+
+		// No present semaphores, frame fence is enough to sync.
+		RHISubmitInfo graphicsCmdSubmitInfo{};
+		graphicsCmdSubmitInfo.setCommandBuffer(&graphicsCmd, 1);
+
+		VkSubmitInfo submitInfo = graphicsCmdSubmitInfo;
+		RHI::get()->resetFence();
+		RHI::get()->submit(1, &submitInfo);
+
+		RHI::get()->present();
+
+		rendererPostTickHooks.broadcast(tickData);
+	}
+
 	void Renderer::tick(const RuntimeModuleTickData& tickData)
 	{
+		// No need gpu, also work in headless mode.
+		UIManager::get()->tick();
+
+		// Update budget and evict before any frame allocation.
+		MemoryBudget::get()->setConfig(MemoryBudgetManager::buildRuntimeConfig());
+		MemoryBudget::get()->tick();
+
+		if (m_bHeadless)
+		{
+			tickHeadless(tickData);
+			return;
+		}
+
 		if (RenderSettingManager::get()->displayMode != RHI::eDisplayMode)
 		{
 			RHI::eDisplayMode = RenderSettingManager::get()->displayMode;
 			RHI::get()->recreateSwapChain();
 		}
+		else if (RHI::get()->getSwapchain().isPresentModeDirty())
+		{
+			// r.Present.Mode change.
+			RHI::get()->recreateSwapChain();
+		}
 
 		// Update scene data.
-		m_sceneData->tick(tickData);
+		{
+			PROFILE_SCOPE("Scene Collect");
+			m_sceneData->tick(tickData);
+		}
+
+		{
+			PROFILE_SCOPE("ImGui Tick");
+			const auto buildStartPoint = std::chrono::high_resolution_clock::now();
 
-		UIManager::get()->newFrame();
+			// When idle throttle skip build, last draw data still valid and render again.
+			m_recordTimings.bUIBuilt = UIManager::get()->shouldBuildFrame(cVarRequireUIFPS.get());
+			if (m_recordTimings.bUIBuilt)
+			{
+				UIManager::get()->newFrame();
+
+				imguiTickFunctions.broadcast(tickData);
+				ImGui::Render();
+			}
 
-		imguiTickFunctions.broadcast(tickData);
-		ImGui::Render();
+			m_recordTimings.uiBuildMicroseconds = 
+				std::chrono::duration<float, std::micro>(std::chrono::high_resolution_clock::now() - buildStartPoint).count();
+		}
 
 		ImDrawData* mainDrawData = ImGui::GetDrawData();
 		const bool bMainMinimized = (mainDrawData->DisplaySize.x <= 0.0f || mainDrawData->DisplaySize.y <= 0.0f);
 		if (!bMainMinimized)
 		{
-			uint32_t backBufferIndex = RHI::get()->acquireNextPresentImage();
+			uint32_t backBufferIndex;
+			{
+				// Wait flighting frame fence and swapchain image.
+				PROFILE_SCOPE("Acquire");
+				backBufferIndex = RHI::get()->acquireNextPresentImage();
+			}
 			CHECK(backBufferIndex < GBackBufferCount && "Swapchain backbuffer count should equal to flighting count.");
 
 			StaticTexturesManager::get()->tick();
 
-			VkCommandBuffer graphicsCmd = m_dynamicGraphicsCommandBuffers[backBufferIndex];
-			RHICheck(vkResetCommandBuffer(graphicsCmd, 0));
+			// Backbuffer's fence already signaled, safe to reset all thread pools of this frame.
+			auto& threadPools = RHI::get()->getThreadGraphicsCommandPools();
+			threadPools.beginFrame(backBufferIndex);
+
+			// Ui record only touch imgui draw data and ui pass owned resources, it can record parallel with world.
+			// Each recording thread allocate its command buffer from own frame command pool.
+			std::future<float> uiRecordFuture;
+			VkCommandBuffer uiCmdBuffer = VK_NULL_HANDLE;
+			const bool bParallelRecord = cVarParallelRecord.get() > 0;
+			auto recordUI = [this, backBufferIndex, &uiCmdBuffer]()
+			{
+				PROFILE_SCOPE("UI Record");
+				const auto startPoint = std::chrono::high_resolution_clock::now();
+				uiCmdBuffer = m_uiPass.renderFrame(backBufferIndex);
+				return std::chrono::duration<float, std::micro>(std::chrono::high_resolution_clock::now() - startPoint).count();
+			};
+			if (bParallelRecord)
+			{
+				uiRecordFuture = GThreadPool::get()->submit(recordUI);
+			}
+
+			const auto worldRecordStartPoint = std::chrono::high_resolution_clock::now();
+
+			VkCommandBuffer graphicsCmd = threadPools.allocate();
 			VkCommandBufferBeginInfo cmdBeginInfo = RHICommandbufferBeginInfo(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
 			RHICheck(vkBeginCommandBuffer(graphicsCmd, &cmdBeginInfo));
 			{
+				PROFILE_SCOPE("World Record");
+
 				// Rebuild some global assset.
 				if (RenderSettingManager::get()->ibl.needRebuild())
 				{
@@ -87,8 +211,12 @@ namespace Flower
 			}
 			RHICheck(vkEndCommandBuffer(graphicsCmd));
 
-			// Record ui render.
-			m_uiPass.renderFrame(backBufferIndex);
+			m_recordTimings.worldMicroseconds = 
+				std::chrono::duration<float, std::micro>(std::chrono::high_resolution_clock::now() - worldRecordStartPoint).count();
+
+			// Wait ui record finish, submit keep world -> ui order.
+			m_recordTimings.uiMicroseconds = bParallelRecord ? uiRecordFuture.get() : recordUI();
+			m_recordTimings.bParallel = bParallelRecord;
 
 			auto frameStartSemaphore = RHI::get()->getCurrentFrameWaitSemaphore();
 			auto* graphicsCmdEndSemaphore = &m_dynamicGraphicsCommandExecuteSemaphores[backBufferIndex];
@@ -105,7 +233,6 @@ namespace Flower
 				.setCommandBuffer(&graphicsCmd, 1);
 
 			RHISubmitInfo uiCmdSubmitInfo{};
-			VkCommandBuffer uiCmdBuffer = m_uiPass.getCommandBuffer(backBufferIndex);
 			uiCmdSubmitInfo.setWaitStage(&waitFlags)
 				.setWaitSemaphore(graphicsCmdEndSemaphore, 1)
 				.setSignalSemaphore(&frameEndSemaphore, 1)
@@ -113,6 +240,7 @@ namespace Flower
 
 			std::vector<VkSubmitInfo> infosRawSubmit{ graphicsCmdSubmitInfo, uiCmdSubmitInfo };
 
+			PROFILE_SCOPE("Submit");
 			RHI::get()->resetFence();
 			RHI::get()->submit((uint32_t)infosRawSubmit.size(), infosRawSubmit.data());
 		}
@@ -121,8 +249,11 @@ namespace Flower
 
 		if (!bMainMinimized)
 		{
+			PROFILE_SCOPE("Present");
 			RHI::get()->present();
 		}
+
+		rendererPostTickHooks.broadcast(tickData);
 	}
 
 	void Renderer::release()
@@ -133,8 +264,11 @@ namespace Flower
 			vkDestroySemaphore(RHI::Device, m_dynamicGraphicsCommandExecuteSemaphores[i], nullptr);
 		}
 		StaticTexturesManager::get()->release();
-		m_uiPass.release();
-		UIManager::get()->release();
+		if (!m_bHeadless)
+		{
+			m_uiPass.release();
+			UIManager::get()->release();
+		}
 
 		RenderSettingManager::get()->release();
 	}
@@ -16,19 +16,53 @@ namespace Flower
 		ImguiPass m_uiPass;
 		std::unique_ptr<RenderSceneData> m_sceneData;
 
-		// Major graphics queue's command and semaphores.
-		std::array<VkCommandBuffer, GBackBufferCount> m_dynamicGraphicsCommandBuffers;
+		// Major graphics queue's semaphores, command buffer allocate from RHI thread command pools.
 		std::array<VkSemaphore, GBackBufferCount> m_dynamicGraphicsCommandExecuteSemaphores;
 
+	public:
+		// Cpu record time of last frame.
+		struct RecordTimings
+		{
+			float worldMicroseconds = 0.0f;
+			float uiMicroseconds = 0.0f;
+			bool bParallel = false;
+
+			// Cpu time of imgui widget build, and whether build this frame.
+			float uiBuildMicroseconds = 0.0f;
+			bool bUIBuilt = true;
+		};
+
+	private:
+		RecordTimings m_recordTimings;
+
+		// Headless mode no ui and no present, only render world into offscreen targets.
+		bool m_bHeadless = false;
+
+	private:
+		void tickHeadless(const RuntimeModuleTickData& tickData);
+
 	public:
 		MulticastDelegate<const RuntimeModuleTickData&> imguiTickFunctions;
 		MulticastDelegate<const RuntimeModuleTickData&, VkCommandBuffer> rendererTickHooks;
 
+		// Broadcast at tick end after submit, record timings of this frame already valid.
+		MulticastDelegate<const RuntimeModuleTickData&> rendererPostTickHooks;
+
 		RenderSceneData* getRenderScene() const
 		{
 			return m_sceneData.get();
 		}
 
+		const RecordTimings& getRecordTimings() const
+		{
+			return m_recordTimings;
+		}
+
+		bool isHeadless() const
+		{
+			return m_bHeadless;
+		}
+
 	public:
 		Renderer(ModuleManager* in, std::string name = "Renderer");
 
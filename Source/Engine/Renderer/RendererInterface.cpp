@@ -3,11 +3,56 @@
 #include "Parameters.h"
 #include "../Scene/CameraInterface.h"
 #include "Renderer.h"
+#include "SinglePassDownsample.h"
 
 namespace Flower
 {
 	static AutoCVarCmd cVarUpdatePasses("cmd.updatePasses", "Update passes shader and pipeline info.");
 
+	static AutoCVarInt32 cVarDynamicResolutionEnable(
+		"r.DynamicResolution.Enable",
+		"Enable dynamic resolution, pick render scale from gpu frame time.",
+		"DynamicResolution",
+		0,
+		CVarFlags::ReadAndWrite
+	);
+
+	static AutoCVarFloat cVarDynamicResolutionTargetFrameTime(
+		"r.DynamicResolution.TargetFrameTime",
+		"Dynamic resolution target gpu frame time in ms.",
+		"DynamicResolution",
+		16.6f,
+		CVarFlags::ReadAndWrite
+	);
+
+	static AutoCVarFloat cVarDynamicResolutionMinScale(
+		"r.DynamicResolution.MinScale",
+		"Dynamic resolution min render scale.",
+		"DynamicResolution",
+		0.5f,
+		CVarFlags::ReadAndWrite
+	);
+
+	static AutoCVarFloat cVarDynamicResolutionMaxScale(
+		"r.DynamicResolution.MaxScale",
+		"Dynamic resolution max render scale.",
+		"DynamicResolution",
+		1.0f,
+		CVarFlags::ReadAndWrite
+	);
+
+	static AutoCVarFloat cVarDynamicResolutionScaleStep(
+		"r.DynamicResolution.ScaleStep",
+		"Dynamic resolution render scale quantize step, fewer steps fewer render target sizes in pool.",
+		"DynamicResolution",
+		0.05f,
+		CVarFlags::ReadAndWrite
+	);
+
+	static AutoCVarCmd cVarDynamicResolutionValidate("cmd.DynamicResolution.Validate", "Drive dynamic resolution controller with synthetic gpu timing traces and log result.");
+
+	static AutoCVarCmd cVarSinglePassDownsampleValidate("cmd.SinglePassDownsample.Validate", "Emulate single pass downsampler schedule on cpu and compare with reference reduction.");
+
 	BufferParametersRing* RendererInterface::getBuffers()
 	{
 		if (!m_bufferParameters)
@@ -22,7 +67,7 @@ namespace Flower
 	{
 		m_rtPool = std::make_unique<RenderTexturePool>();
 		m_passCollector = std::make_unique<PassCollector>();
-		m_gpuTimer.init(uint32_t(RHI::GMaxSwapchainCount));
+		m_gpuTimer.init(uint32_t(RHI::GMaxSwapchainCount), m_name);
 		initImpl();
 	}
 
@@ -42,7 +87,19 @@ namespace Flower
 			m_bufferParameters->tick();
 		}
 
+		CVarCmdHandle(cVarDynamicResolutionValidate, []()
+		{
+			DynamicResolutionController::validate();
+		});
+
+		CVarCmdHandle(cVarSinglePassDownsampleValidate, []()
+		{
+			SinglePassDownsample::validate();
+		});
+
 		m_gpuTimer.onBeginFrame(graphicsCmd, &m_timeStamps);
+		updateDynamicResolution();
+
 		tickImpl(tickData, graphicsCmd);
 		m_gpuTimer.onEndFrame();
 
@@ -87,8 +144,9 @@ namespace Flower
 		m_renderScale = validRenderScale;
 		m_displayScale = validDisplayScale;
 
-		m_renderWidth = glm::clamp(uint32_t(width * validRenderScale), (uint32_t)GMinRenderDim, (uint32_t)GMaxRenderDim);
-		m_renderHeight = glm::clamp(uint32_t(height * validRenderScale), (uint32_t)GMinRenderDim, (uint32_t)GMaxRenderDim);		
+		m_maxRenderWidth = glm::clamp(uint32_t(width * validRenderScale), (uint32_t)GMinRenderDim, (uint32_t)GMaxRenderDim);
+		m_maxRenderHeight = glm::clamp(uint32_t(height * validRenderScale), (uint32_t)GMinRenderDim, (uint32_t)GMaxRenderDim);
+		updateDynamicRenderDim();
 		m_displayWidth = glm::clamp(uint32_t(width * validDisplayScale), (uint32_t)GMinRenderDim, (uint32_t)GMaxRenderDim);
 		m_displayHeight = glm::clamp(uint32_t(height * validDisplayScale), (uint32_t)GMinRenderDim, (uint32_t)GMaxRenderDim);
 
@@ -103,6 +161,47 @@ namespace Flower
 		updateRenderSizeImpl(width, height, renderScale, displayScale);
 	}
 
+	bool RendererInterface::updateDynamicRenderDim()
+	{
+		const uint32_t width = glm::clamp(uint32_t(m_maxRenderWidth * m_dynamicScale), (uint32_t)GMinRenderDim, m_maxRenderWidth);
+		const uint32_t height = glm::clamp(uint32_t(m_maxRenderHeight * m_dynamicScale), (uint32_t)GMinRenderDim, m_maxRenderHeight);
+
+		const bool bChange = (width != m_renderWidth) || (height != m_renderHeight);
+		m_renderWidth = width;
+		m_renderHeight = height;
+		return bChange;
+	}
+
+	void RendererInterface::updateDynamicResolution()
+	{
+		float scale = 1.0f;
+		if (cVarDynamicResolutionEnable.get() > 0)
+		{
+			DynamicResolutionConfig config{};
+			config.targetFrameTimeMs = cVarDynamicResolutionTargetFrameTime.get();
+			config.minScale = glm::clamp(cVarDynamicResolutionMinScale.get(), 0.1f, 1.0f);
+			config.maxScale = glm::clamp(cVarDynamicResolutionMaxScale.get(), config.minScale, 1.0f);
+			config.scaleStep = cVarDynamicResolutionScaleStep.get();
+			config.settleFrames = uint32_t(RHI::GMaxSwapchainCount) + 1;
+			m_dynamicResolution.setConfig(config);
+
+			scale = m_dynamicResolution.update(m_gpuTimer.getFrameTotalMicroseconds() * 1e-3f);
+		}
+		else
+		{
+			m_dynamicResolution.reset(1.0f);
+		}
+
+		if (scale != m_dynamicScale)
+		{
+			m_dynamicScale = scale;
+			if (updateDynamicRenderDim())
+			{
+				dynamicRenderSizeChangedImpl();
+			}
+		}
+	}
+
 	VulkanImage& RendererInterface::getDisplayOutput()
 	{
 		if (!m_displayOutput)
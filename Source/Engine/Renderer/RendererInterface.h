@@ -4,6 +4,7 @@
 #include "RendererTextures.h"
 #include "BufferParameter.h"
 #include "PassCollector.h"
+#include "DynamicResolution.h"
 
 namespace Flower
 {
@@ -30,10 +31,18 @@ namespace Flower
 		float m_renderScale = 1.0f;
 		float m_displayScale = 1.0f;
 
-		// Render dim before upscaling.
+		// Render dim before upscaling, max render dim scale by dynamic resolution.
 		uint32_t m_renderWidth = GMinRenderDim;
 		uint32_t m_renderHeight = GMinRenderDim;
 
+		// Render dim when dynamic scale is one, upscaler context create with it.
+		uint32_t m_maxRenderWidth = GMinRenderDim;
+		uint32_t m_maxRenderHeight = GMinRenderDim;
+
+		// Dynamic resolution change render dim only, no device wait and upscaler context recreate.
+		DynamicResolutionController m_dynamicResolution;
+		float m_dynamicScale = 1.0f;
+
 		// Display dim after upscaling.
 		uint32_t m_displayWidth = GMinRenderDim;
 		uint32_t m_displayHeight = GMinRenderDim;
@@ -61,6 +70,13 @@ namespace Flower
 
 		virtual void updateRenderSizeImpl(uint32_t width, uint32_t height, float renderScale, float displayScale) {};
 
+		// Render dim change by dynamic resolution, drop history which can't reproject across size.
+		virtual void dynamicRenderSizeChangedImpl() {};
+
+	private:
+		void updateDynamicResolution();
+		bool updateDynamicRenderDim();
+
 	public:
 		RendererInterface(const char* name, CameraInterface* inCam)
 			: m_name(name), m_camera(inCam)
@@ -89,6 +105,7 @@ namespace Flower
 
 		uint32_t getRenderWidth() const { return m_renderWidth; }
 		uint32_t getRenderHeight() const { return m_renderHeight; }
+		float getDynamicScale() const { return m_dynamicScale; }
 
 		uint32_t getDisplayWidth() const { return m_displayWidth; }
 		uint32_t getDisplayHeight() const { return m_displayHeight; }
@@ -94,10 +94,12 @@ namespace Flower
 
 		inline VkImageUsageFlags displayOutput()
 		{ 
+			// Transfer src for headless readback.
 			return 
 				VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | 
 				VK_IMAGE_USAGE_STORAGE_BIT | 
-				VK_IMAGE_USAGE_SAMPLED_BIT; 
+				VK_IMAGE_USAGE_SAMPLED_BIT |
+				VK_IMAGE_USAGE_TRANSFER_SRC_BIT; 
 		}
 
 		inline VkImageUsageFlags sdsmMask()
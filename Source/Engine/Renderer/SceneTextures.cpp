@@ -191,7 +191,7 @@ namespace Flower
 			dimXY * cascadeCount,
 			dimXY,
 			RTFormats::depth(),
-			RTUsages::depth()
+			RTUsages::depth() | VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT // Copy with sdsm static cache.
 		);
 
 
@@ -0,0 +1,275 @@
+#include "Pch.h"
+#include "SinglePassDownsample.h"
+
+namespace Flower
+{
+	bool SinglePassDownsample::isSupported(uint32_t srcWidth, uint32_t srcHeight, uint32_t mips)
+	{
+		if (mips == 0 || mips > kMaxMips)
+		{
+			return false;
+		}
+
+		return mips <= kTileMips || glm::max(srcWidth, srcHeight) <= (kTileSize << kTileMips);
+	}
+
+	SinglePassDownsample::DispatchInfo SinglePassDownsample::getDispatchInfo(uint32_t srcWidth, uint32_t srcHeight, uint32_t mips)
+	{
+		CHECK(isSupported(srcWidth, srcHeight, mips));
+
+		DispatchInfo info{};
+		info.mips = mips;
+		info.groupCountX = divideRoundingUp(srcWidth, kTileSize);
+		info.groupCountY = divideRoundingUp(srcHeight, kTileSize);
+		info.numWorkGroups = info.groupCountX * info.groupCountY;
+
+		return info;
+	}
+
+	uint32_t SinglePassDownsample::getConservativeMips(uint32_t srcWidth, uint32_t srcHeight, uint32_t mips)
+	{
+		uint32_t conservativeMips = 0;
+		while (conservativeMips < mips && (srcWidth % 2) == 0 && (srcHeight % 2) == 0)
+		{
+			srcWidth /= 2;
+			srcHeight /= 2;
+			conservativeMips++;
+		}
+		return conservativeMips;
+	}
+
+	namespace
+	{
+		// x is closest (max), y is furthest (min), same as hiz.
+		using SPDValue = glm::vec2;
+
+		inline SPDValue reduce4(SPDValue v0, SPDValue v1, SPDValue v2, SPDValue v3)
+		{
+			return SPDValue(
+				glm::max(glm::max(v0.x, v1.x), glm::max(v2.x, v3.x)),
+				glm::min(glm::min(v0.y, v1.y), glm::min(v2.y, v3.y)));
+		}
+
+		// Cpu mirror of SPDCommon.glsl, one loop over 256 threads for each barrier interval.
+		class SPDEmulator
+		{
+		public:
+			std::vector<glm::uvec2> sizes;
+			std::vector<std::vector<SPDValue>> levels;
+			uint32_t mips;
+
+			SPDEmulator(const std::vector<SPDValue>& src, uint32_t width, uint32_t height, uint32_t inMips)
+				: mips(inMips)
+			{
+				for (uint32_t i = 0; i <= mips; i++)
+				{
+					sizes.push_back({ glm::max(1u, width >> i), glm::max(1u, height >> i) });
+					levels.push_back(std::vector<SPDValue>(sizes.back().x * sizes.back().y, SPDValue(-1.0f)));
+				}
+				levels[0] = src;
+			}
+
+			SPDValue load(glm::ivec2 pos, uint32_t level) const
+			{
+				const glm::ivec2 size = glm::ivec2(sizes[level]);
+				pos = glm::min(pos, size - 1);
+				return levels[level][pos.y * size.x + pos.x];
+			}
+
+			void store(glm::ivec2 pos, SPDValue v, uint32_t level)
+			{
+				const glm::ivec2 size = glm::ivec2(sizes[level]);
+				if (pos.x < size.x && pos.y < size.y)
+				{
+					levels[level][pos.y * size.x + pos.x] = v;
+				}
+			}
+
+			void downsampleTile(glm::uvec2 tileId, uint32_t baseLevel)
+			{
+				const uint32_t levelCount = glm::min(mips - baseLevel, SinglePassDownsample::kTileMips);
+
+				SPDValue intermediate[16][16];
+				std::vector<std::array<SPDValue, 4>> v(256);
+
+				auto threadPos = [](uint32_t localIndex) { return glm::uvec2(localIndex % 16, localIndex / 16); };
+				auto reduceIntermediate = [&](glm::uvec2 pos)
+				{
+					return reduce4(
+						intermediate[pos.x * 2 + 0][pos.y * 2 + 0],
+						intermediate[pos.x * 2 + 1][pos.y * 2 + 0],
+						intermediate[pos.x * 2 + 0][pos.y * 2 + 1],
+						intermediate[pos.x * 2 + 1][pos.y * 2 + 1]);
+				};
+
+				for (uint32_t localIndex = 0; localIndex < 256; localIndex++)
+				{
+					for (uint32_t i = 0; i < 4; i++)
+					{
+						const glm::uvec2 pos = threadPos(localIndex) + glm::uvec2(16 * (i & 1), 16 * (i >> 1));
+						const glm::ivec2 srcPos = glm::ivec2(tileId * 64u + pos * 2u);
+
+						v[localIndex][i] = reduce4(
+							load(srcPos + glm::ivec2(0, 0), baseLevel),
+							load(srcPos + glm::ivec2(1, 0), baseLevel),
+							load(srcPos + glm::ivec2(0, 1), baseLevel),
+							load(srcPos + glm::ivec2(1, 1), baseLevel));
+						store(glm::ivec2(tileId * 32u + pos), v[localIndex][i], baseLevel + 1);
+					}
+				}
+
+				if (levelCount <= 1)
+				{
+					return;
+				}
+
+				auto isQuarter = [&](uint32_t localIndex) { return glm::all(glm::lessThan(threadPos(localIndex), glm::uvec2(8))); };
+				for (uint32_t i = 0; i < 4; i++)
+				{
+					for (uint32_t localIndex = 0; localIndex < 256; localIndex++)
+					{
+						intermediate[threadPos(localIndex).x][threadPos(localIndex).y] = v[localIndex][i];
+					}
+
+					for (uint32_t localIndex = 0; localIndex < 256; localIndex++)
+					{
+						if (isQuarter(localIndex))
+						{
+							v[localIndex][i] = reduceIntermediate(threadPos(localIndex));
+							store(glm::ivec2(tileId * 16u + threadPos(localIndex) + glm::uvec2(8 * (i & 1), 8 * (i >> 1))), v[localIndex][i], baseLevel + 2);
+						}
+					}
+				}
+
+				for (uint32_t localIndex = 0; localIndex < 256; localIndex++)
+				{
+					if (isQuarter(localIndex))
+					{
+						for (uint32_t i = 0; i < 4; i++)
+						{
+							intermediate[threadPos(localIndex).x + 8 * (i & 1)][threadPos(localIndex).y + 8 * (i >> 1)] = v[localIndex][i];
+						}
+					}
+				}
+
+				for (uint32_t level = 3; level <= levelCount; level++)
+				{
+					const uint32_t levelSize = 64 >> level;
+
+					std::vector<SPDValue> results(levelSize * levelSize);
+					for (uint32_t localIndex = 0; localIndex < levelSize * levelSize; localIndex++)
+					{
+						results[localIndex] = reduceIntermediate(glm::uvec2(localIndex % levelSize, localIndex / levelSize));
+					}
+
+					for (uint32_t localIndex = 0; localIndex < levelSize * levelSize; localIndex++)
+					{
+						const glm::uvec2 pos = glm::uvec2(localIndex % levelSize, localIndex / levelSize);
+						intermediate[pos.x][pos.y] = results[localIndex];
+						store(glm::ivec2(tileId * levelSize + pos), results[localIndex], baseLevel + level);
+					}
+				}
+			}
+
+			void downsample(const SinglePassDownsample::DispatchInfo& info)
+			{
+				for (uint32_t y = 0; y < info.groupCountY; y++)
+				{
+					for (uint32_t x = 0; x < info.groupCountX; x++)
+					{
+						downsampleTile({ x, y }, 0);
+					}
+				}
+
+				// Last workgroup after all level 6 tile finish.
+				if (mips > SinglePassDownsample::kTileMips)
+				{
+					downsampleTile({ 0, 0 }, SinglePassDownsample::kTileMips);
+				}
+			}
+		};
+	}
+
+	void SinglePassDownsample::validate()
+	{
+		struct Case
+		{
+			uint32_t width;
+			uint32_t height;
+		};
+
+		// Power of two, odd size, long thin and bigger than one level 6 tile.
+		const std::vector<Case> cases =
+		{
+			{ 1, 1 }, { 5, 3 }, { 64, 64 }, { 257, 33 }, { 1283, 719 }, { 1920, 1080 }, { 2048, 1024 }, { 4096, 16 },
+		};
+
+		std::mt19937 random(43);
+		std::uniform_real_distribution<float> depth(0.0f, 1.0f);
+
+		ValidateReport report("Single pass downsample");
+		for (const auto& c : cases)
+		{
+			const uint32_t mipLevels = uint32_t(std::floor(std::log2(float(glm::max(c.width, c.height))))) + 1;
+			const uint32_t mips = glm::min(mipLevels - 1, kMaxMips);
+			if (mips == 0 || !isSupported(c.width, c.height, mips))
+			{
+				continue;
+			}
+
+			std::vector<SPDValue> src(c.width * c.height);
+			for (auto& v : src)
+			{
+				v = SPDValue(depth(random));
+			}
+
+			SPDEmulator emulator(src, c.width, c.height, mips);
+			emulator.downsample(getDispatchInfo(c.width, c.height, mips));
+
+			// Brute force reference, level k texel cover source block of 2^k.
+			// Level size floor to zero clamp to one texel, that texel only cover part of block and skip.
+			// Levels within conservative mips must never skip, dropped edge there break hiz.
+			const uint32_t conservativeMips = getConservativeMips(c.width, c.height, mips);
+			uint32_t mismatch = 0;
+			uint32_t conservativeSkip = 0;
+			for (uint32_t level = 1; level <= mips; level++)
+			{
+				const glm::uvec2 size = emulator.sizes[level];
+				const uint32_t block = 1u << level;
+
+				for (uint32_t y = 0; y < size.y; y++)
+				{
+					for (uint32_t x = 0; x < size.x; x++)
+					{
+						if ((x + 1) * block > c.width || (y + 1) * block > c.height)
+						{
+							conservativeSkip += (level <= conservativeMips) ? 1 : 0;
+							continue;
+						}
+
+						SPDValue reference(0.0f, 1.0f);
+						for (uint32_t j = 0; j < block; j++)
+						{
+							for (uint32_t i = 0; i < block; i++)
+							{
+								const SPDValue v = emulator.load(glm::ivec2(x * block + i, y * block + j), 0);
+								reference = SPDValue(glm::max(reference.x, v.x), glm::min(reference.y, v.y));
+							}
+						}
+
+						mismatch += (reference != emulator.levels[level][y * size.x + x]) ? 1 : 0;
+					}
+				}
+			}
+
+			const std::string caseName = std::to_string(c.width) + "x" + std::to_string(c.height);
+			report.expect(conservativeSkip == 0, caseName + " " + std::to_string(conservativeSkip) + " texels partial cover within conservative mips");
+			if (report.expect(mismatch == 0, caseName + " " + std::to_string(mismatch) + " texels mismatch"))
+			{
+				LOG_INFO("Single pass downsample validate {0}: {1} mips match, {2} conservative.", caseName, mips, conservativeMips);
+			}
+		}
+
+		report.finish();
+	}
+}
@@ -0,0 +1,38 @@
+#pragma once
+#include "../Core/Core.h"
+
+namespace Flower
+{
+	// Single pass downsampler, one dispatch build 2x2 reduction chain up to kMaxMips levels.
+	// One workgroup per 64x64 source tile reduce 6 levels in shared memory, last finish workgroup reduce remain levels.
+	// Shader side see SPDCommon.glsl.
+	class SinglePassDownsample
+	{
+	public:
+		static constexpr uint32_t kTileSize = 64;
+		static constexpr uint32_t kTileMips = 6;
+		static constexpr uint32_t kMaxMips = 12;
+
+		struct DispatchInfo
+		{
+			// Output levels, not include source level.
+			uint32_t mips;
+
+			uint32_t groupCountX;
+			uint32_t groupCountY;
+			uint32_t numWorkGroups;
+		};
+
+		// Last workgroup only reduce one tile of level 6, so source no bigger than 4096 when need more than 6 levels.
+		static bool isSupported(uint32_t srcWidth, uint32_t srcHeight, uint32_t mips);
+
+		static DispatchInfo getDispatchInfo(uint32_t srcWidth, uint32_t srcHeight, uint32_t mips);
+
+		// 2x2 reduction drop last row or column of odd size level, so only leading levels with even input keep conservative.
+		// Caller build remain levels with odd edge aware per mip path.
+		static uint32_t getConservativeMips(uint32_t srcWidth, uint32_t srcHeight, uint32_t mips);
+
+		// Emulate shader workgroup schedule on cpu with hiz min max reduction, compare with brute force block reduction, log result.
+		static void validate();
+	};
+}
@@ -0,0 +1,342 @@
+#include "Pch.h"
+#include "StaticMeshInstancing.h"
+
+#include <random>
+
+namespace Flower
+{
+	namespace StaticMeshInstancing
+	{
+		// Objects with same key can draw with one instanced draw.
+		// Lod ranges start from submesh index start, so they also identify submesh.
+		struct BatchKey
+		{
+			uint32_t verticesArrayId;
+			uint32_t indicesArrayId;
+			glm::uvec4 lodIndexStart;
+			glm::uvec4 lodIndexCount;
+			GPUStaticMeshStandardPBRMaterial material;
+
+			bool operator==(const BatchKey& rhs) const
+			{
+				return std::memcmp(this, &rhs, sizeof(BatchKey)) == 0;
+			}
+		};
+
+		static BatchKey buildKey(const GPUPerObjectData& object)
+		{
+			// Key hash and compare by bytes, clear padding first.
+			BatchKey key;
+			std::memset(&key, 0, sizeof(BatchKey));
+
+			key.verticesArrayId = object.verticesArrayId;
+			key.indicesArrayId = object.indicesArrayId;
+			key.lodIndexStart = object.lodIndexStart;
+			key.lodIndexCount = object.lodIndexCount;
+			key.material = object.material;
+
+			return key;
+		}
+
+		BatchList buildBatches(const std::vector<GPUPerObjectData>& objects)
+		{
+			BatchList result{};
+
+			std::unordered_map<BatchKey, uint32_t, CRCHasher<BatchKey>> batchMap;
+			std::vector<uint32_t> objectBatches(objects.size());
+			for (size_t i = 0; i < objects.size(); i++)
+			{
+				const auto [iter, bNew] = batchMap.try_emplace(buildKey(objects[i]), uint32_t(result.batches.size()));
+				if (bNew)
+				{
+					result.batches.push_back({ 0, 0 });
+				}
+
+				result.batches[iter->second].instanceCount++;
+				objectBatches[i] = iter->second;
+			}
+
+			uint32_t offset = 0;
+			for (auto& batch : result.batches)
+			{
+				batch.instanceOffset = offset;
+				offset += batch.instanceCount;
+			}
+
+			result.instances.resize(objects.size());
+			std::vector<uint32_t> batchCursors(result.batches.size(), 0);
+			for (size_t i = 0; i < objects.size(); i++)
+			{
+				const uint32_t batchId = objectBatches[i];
+				const uint32_t pos = result.batches[batchId].instanceOffset + batchCursors[batchId]++;
+
+				result.instances[pos] = { uint32_t(i), batchId };
+			}
+
+			return result;
+		}
+
+		std::vector<GPUDrawIndirectCommand> buildDrawCommands(const BatchList& list, const std::vector<GPUPerObjectData>& objects)
+		{
+			std::vector<GPUDrawIndirectCommand> commands(list.getDrawCommandCount());
+			for (uint32_t batchId = 0; batchId < list.batches.size(); batchId++)
+			{
+				const auto& batch = list.batches[batchId];
+				const auto& object = objects[list.instances[batch.instanceOffset].objectId];
+
+				for (uint32_t lod = 0; lod < kLodCount; lod++)
+				{
+					auto& command = commands[batchId * kLodCount + lod];
+
+					// We fetech vertex by index, so vertex count is index count.
+					command.vertexCount = object.lodIndexCount[lod];
+					command.firstVertex = object.lodIndexStart[lod];
+					command.instanceCount = 0;
+					command.firstInstance = batch.instanceOffset * kLodCount + lod * batch.instanceCount;
+					command.objectId = batchId;
+				}
+			}
+			return commands;
+		}
+
+		// Same with selectLod in StaticMeshCulling.glsl.
+		static uint32_t selectLod(const GPUPerObjectData& object, const glm::vec3& worldCenter, const GPUViewData& view, float lodErrorScale)
+		{
+			if (lodErrorScale <= 0.0f)
+			{
+				return 0;
+			}
+
+			const float maxScale = glm::sqrt(glm::max(glm::max(
+				glm::dot(glm::vec3(object.modelMatrix[0]), glm::vec3(object.modelMatrix[0])),
+				glm::dot(glm::vec3(object.modelMatrix[1]), glm::vec3(object.modelMatrix[1]))),
+				glm::dot(glm::vec3(object.modelMatrix[2]), glm::vec3(object.modelMatrix[2]))));
+
+			const float radius = object.sphereBounds.w * maxScale;
+			const float dist = glm::max(glm::distance(worldCenter, glm::vec3(view.camWorldPos)) - radius, view.camInfo.z);
+			const float errorScale = maxScale * lodErrorScale / dist;
+
+			uint32_t lod = 0;
+			for (uint32_t i = 1; i < kLodCount; i++)
+			{
+				if (object.lodIndexCount[i] == 0 || object.lodError[i] * errorScale > 1.0f)
+				{
+					break;
+				}
+				lod = i;
+			}
+			return lod;
+		}
+
+		uint32_t cullObject(const GPUPerObjectData& object, const GPUViewData& view, float lodErrorScale)
+		{
+			const glm::vec3 worldPos = glm::vec3(object.modelMatrix * glm::vec4(glm::vec3(object.sphereBounds), 1.0f));
+
+			const glm::mat3 normalMatrix = glm::transpose(glm::inverse(glm::mat3(object.modelMatrix)));
+			const glm::mat3 world2Local = glm::inverse(normalMatrix);
+
+			for (uint32_t i = 0; i < 6; i++)
+			{
+				const glm::vec3 worldSpaceN = glm::vec3(view.frustumPlanes[i]);
+				const float castDistance = glm::dot(worldPos, worldSpaceN);
+
+				const glm::vec3 localNormal = world2Local * worldSpaceN;
+				const float absDiff = glm::dot(glm::abs(localNormal), object.extents);
+				if (castDistance + absDiff + view.frustumPlanes[i].w < 0.0f)
+				{
+					return ~0u;
+				}
+			}
+
+			return selectLod(object, worldPos, view, lodErrorScale);
+		}
+
+		void cullInstances(
+			const BatchList& list,
+			const std::vector<GPUPerObjectData>& objects,
+			const GPUViewData& view,
+			float lodErrorScale,
+			std::vector<GPUDrawIndirectCommand>& inoutCommands,
+			std::vector<uint32_t>& outVisibleInstances)
+		{
+			outVisibleInstances.assign(list.getVisibleInstanceCapacity(), ~0u);
+			for (const auto& instance : list.instances)
+			{
+				const uint32_t lod = cullObject(objects[instance.objectId], view, lodErrorScale);
+				if (lod == ~0u)
+				{
+					continue;
+				}
+
+				// Gpu append with atomic, slot order inside command no stable.
+				auto& command = inoutCommands[instance.batchId * kLodCount + lod];
+				outVisibleInstances[command.firstInstance + command.instanceCount] = instance.objectId;
+				command.instanceCount++;
+			}
+		}
+
+		void validate()
+		{
+			ValidateReport report("Static mesh instancing");
+
+			std::mt19937 random(27);
+			std::uniform_real_distribution<float> unitDist(0.0f, 1.0f);
+			auto range = [&](float minValue, float maxValue) { return minValue + (maxValue - minValue) * unitDist(random); };
+
+			uint64_t totalObjects = 0;
+			uint64_t totalVisible = 0;
+			uint64_t totalPerObjectDraws = 0;
+			uint64_t totalInstancedDraws = 0;
+			for (uint32_t testCase = 0; testCase < 32; testCase++)
+			{
+				// Prototype submeshes, one mesh own one vertices and indices buffer.
+				std::vector<GPUPerObjectData> prototypes;
+				const uint32_t meshCount = 1 + random() % 8;
+				for (uint32_t meshId = 0; meshId < meshCount; meshId++)
+				{
+					const uint32_t submeshCount = 1 + random() % 3;
+					uint32_t indexStart = 0;
+					for (uint32_t submeshId = 0; submeshId < submeshCount; submeshId++)
+					{
+						GPUPerObjectData object{};
+						object.verticesArrayId = meshId;
+						object.indicesArrayId = meshId;
+						object.indexCount = 3 * (1 + random() % 1000);
+						object.indexStartPosition = indexStart;
+						object.lodIndexStart = glm::uvec4(indexStart, 0, 0, 0);
+						object.lodIndexCount = glm::uvec4(object.indexCount, 0, 0, 0);
+						object.lodError = glm::vec4(0.0f);
+						indexStart += object.indexCount;
+
+						const uint32_t lodCount = random() % kLodCount;
+						for (uint32_t lod = 1; lod <= lodCount; lod++)
+						{
+							object.lodIndexStart[lod] = indexStart;
+							object.lodIndexCount[lod] = object.indexCount >> lod;
+							object.lodError[lod] = 0.01f * float(1 << lod);
+							indexStart += object.lodIndexCount[lod];
+						}
+
+						object.sphereBounds = glm::vec4(range(-1.0f, 1.0f), range(-1.0f, 1.0f), range(-1.0f, 1.0f), range(0.5f, 4.0f));
+						object.extents = glm::vec3(object.sphereBounds.w * 0.7f);
+						prototypes.push_back(object);
+					}
+				}
+
+				const uint32_t materialCount = 1 + random() % 4;
+				const uint32_t objectCount = 1 + random() % 2000;
+
+				std::vector<GPUPerObjectData> objects(objectCount);
+				for (auto& object : objects)
+				{
+					object = prototypes[random() % prototypes.size()];
+					object.material = GPUStaticMeshStandardPBRMaterial::buildDeafult();
+					object.material.baseColorId = random() % materialCount;
+
+					const glm::vec3 axis = glm::normalize(glm::vec3(range(-1.0f, 1.0f), range(-1.0f, 1.0f), 1.0f));
+					object.modelMatrix = glm::translate(glm::mat4(1.0f), glm::vec3(range(-120.0f, 120.0f), range(-120.0f, 120.0f), range(-120.0f, 120.0f)));
+					object.modelMatrix = glm::rotate(object.modelMatrix, range(0.0f, glm::two_pi<float>()), axis);
+					object.modelMatrix = glm::scale(object.modelMatrix, glm::vec3(range(0.5f, 2.0f)));
+					object.modelMatrixPrev = object.modelMatrix;
+				}
+
+				// Box view volume around origin, inside when dot(n, p) + w >= 0.
+				GPUViewData view{};
+				view.camWorldPos = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+				view.camInfo = glm::vec4(glm::radians(60.0f), 1.0f, 0.1f, 1000.0f);
+				for (uint32_t i = 0; i < 6; i++)
+				{
+					glm::vec3 normal = glm::vec3(0.0f);
+					normal[i / 2] = (i % 2 == 0) ? 1.0f : -1.0f;
+					view.frustumPlanes[i] = glm::vec4(normal, 60.0f);
+				}
+				const float lodErrorScale = (testCase % 2 == 0) ? 0.0f : 200.0f;
+
+				const BatchList list = buildBatches(objects);
+
+				// Every object in exactly one batch, batch members share key, batches have different keys.
+				report.expect(list.instances.size() == objects.size(), "instance count");
+				std::vector<uint32_t> objectBatches(objects.size(), ~0u);
+				std::unordered_set<size_t> batchKeyHashes;
+				for (uint32_t batchId = 0; batchId < list.batches.size(); batchId++)
+				{
+					const auto& batch = list.batches[batchId];
+					report.expect(batch.instanceCount > 0, "no empty batch");
+
+					const BatchKey batchKey = buildKey(objects[list.instances[batch.instanceOffset].objectId]);
+					batchKeyHashes.insert(CRCHash(batchKey));
+					for (uint32_t i = 0; i < batch.instanceCount; i++)
+					{
+						const auto& instance = list.instances[batch.instanceOffset + i];
+						report.expect(instance.batchId == batchId, "instance batch id");
+						report.expect(objectBatches[instance.objectId] == ~0u, "object in one batch");
+						report.expect(buildKey(objects[instance.objectId]) == batchKey, "batch member share key");
+
+						objectBatches[instance.objectId] = batchId;
+					}
+				}
+				report.expect(batchKeyHashes.size() == list.batches.size(), "batch key unique");
+
+				// Per object reference.
+				std::vector<uint32_t> objectLods(objects.size());
+				uint32_t visibleCount = 0;
+				for (size_t i = 0; i < objects.size(); i++)
+				{
+					objectLods[i] = cullObject(objects[i], view, lodErrorScale);
+					visibleCount += (objectLods[i] != ~0u) ? 1 : 0;
+				}
+
+				std::vector<GPUDrawIndirectCommand> commands = buildDrawCommands(list, objects);
+				std::vector<uint32_t> visibleInstances;
+				cullInstances(list, objects, view, lodErrorScale, commands, visibleInstances);
+
+				// Compacted instances match per object culling and lod, no overlap between command regions.
+				std::vector<uint32_t> visibleSeen(objects.size(), 0);
+				uint32_t instancedVisibleCount = 0;
+				uint32_t instancedDrawCount = 0;
+				for (uint32_t commandId = 0; commandId < commands.size(); commandId++)
+				{
+					const auto& command = commands[commandId];
+					const uint32_t batchId = commandId / kLodCount;
+					const uint32_t lod = commandId % kLodCount;
+
+					report.expect(command.objectId == batchId, "command batch id");
+					report.expect(command.instanceCount <= list.batches[batchId].instanceCount, "command instance capacity");
+
+					for (uint32_t i = 0; i < command.instanceCount; i++)
+					{
+						const uint32_t objectId = visibleInstances[command.firstInstance + i];
+						report.expect(objectId < objects.size(), "visible instance valid");
+						if (objectId >= objects.size())
+						{
+							continue;
+						}
+
+						report.expect(objectBatches[objectId] == batchId && objectLods[objectId] == lod, "visible instance in batch lod");
+						visibleSeen[objectId]++;
+					}
+
+					instancedVisibleCount += command.instanceCount;
+					instancedDrawCount += (command.instanceCount > 0) ? 1 : 0;
+				}
+
+				report.expect(instancedVisibleCount == visibleCount, "visible count match per object culling");
+				for (size_t i = 0; i < objects.size(); i++)
+				{
+					report.expect(visibleSeen[i] == ((objectLods[i] != ~0u) ? 1u : 0u), "visible object draw once");
+				}
+				report.expect(instancedDrawCount <= visibleCount, "instanced draw count no more than per object draws");
+
+				totalObjects += objects.size();
+				totalVisible += visibleCount;
+				totalPerObjectDraws += visibleCount;
+				totalInstancedDraws += instancedDrawCount;
+			}
+
+			LOG_INFO("Static mesh instancing validate: {0} objects, {1} visible, {2} per object draws, {3} instanced draws.",
+				totalObjects, totalVisible, totalPerObjectDraws, totalInstancedDraws);
+
+			report.finish();
+		}
+	}
+}
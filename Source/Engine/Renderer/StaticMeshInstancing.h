@@ -0,0 +1,71 @@
+#pragma once
+#include "Parameters.h"
+#include "MeshMisc.h"
+
+namespace Flower
+{
+	// See InstanceData in StaticMeshCommon.glsl
+	struct GPUInstanceData
+	{
+		// Object id for GPUPerObjectData array indexing.
+		uint32_t objectId;
+		uint32_t batchId;
+	};
+
+	// Automatic instancing of repeated static meshes.
+	// Objects share same mesh, submesh and material group to one batch. Each batch own one draw command per lod,
+	// culling append visible object id to command of selected lod and increase instanceCount,
+	// so all visible copies of one batch lod draw with one indirect command.
+	//
+	// Command (batch, lod) visible instances store at [firstInstance, firstInstance + batch.instanceCount) of visible array,
+	// vertex shader index it with gl_InstanceIndex.
+	namespace StaticMeshInstancing
+	{
+		constexpr uint32_t kLodCount = GMaxStaticMeshLodCount;
+
+		struct Batch
+		{
+			// Range in instance array.
+			uint32_t instanceOffset;
+			uint32_t instanceCount;
+		};
+
+		struct BatchList
+		{
+			std::vector<Batch> batches;
+
+			// Sort by batch, object order keep inside batch.
+			std::vector<GPUInstanceData> instances;
+
+			uint32_t getDrawCommandCount() const
+			{
+				return uint32_t(batches.size()) * kLodCount;
+			}
+
+			uint32_t getVisibleInstanceCapacity() const
+			{
+				return uint32_t(instances.size()) * kLodCount;
+			}
+		};
+
+		BatchList buildBatches(const std::vector<GPUPerObjectData>& objects);
+
+		// Draw command template with zero instance count, copy to indirect buffer before culling.
+		std::vector<GPUDrawIndirectCommand> buildDrawCommands(const BatchList& list, const std::vector<GPUPerObjectData>& objects);
+
+		// Cpu reference of StaticMeshCulling.glsl, return selected lod, ~0u when culled.
+		uint32_t cullObject(const GPUPerObjectData& object, const GPUViewData& view, float lodErrorScale);
+
+		// Cpu reference of instanced culling, increase instanceCount of commands and write visible instance object ids.
+		void cullInstances(
+			const BatchList& list,
+			const std::vector<GPUPerObjectData>& objects,
+			const GPUViewData& view,
+			float lodErrorScale,
+			std::vector<GPUDrawIndirectCommand>& inoutCommands,
+			std::vector<uint32_t>& outVisibleInstances);
+
+		// Random scenes check batching and instance compaction against per object culling, log result.
+		void validate();
+	}
+}
@@ -34,6 +34,7 @@ namespace Flower
 
 		for (const auto& runtimeModule : m_runtimeModules)
 		{
+			PROFILE_SCOPE(runtimeModule->getName().c_str());
 			runtimeModule->tick(tickData);
 		}
 	}
@@ -32,6 +32,15 @@ namespace Flower
 		uint64_t tickCount = 0;
 
 		bool bSmoothFpsUpdate = false;
+
+		// Recent frame time percentiles, ms.
+		float frameTimeP50 = 0.0f;
+		float frameTimeP95 = 0.0f;
+		float frameTimeP99 = 0.0f;
+
+		// Smooth input to present latency, ms.
+		float latency = 0.0f;
+		bool bLatencyToDisplay = false;
 	};
 
 	class IRuntimeModule : private NonCopyable
@@ -49,6 +58,8 @@ namespace Flower
 
 		virtual ~IRuntimeModule() = default;
 
+		const std::string& getName() const { return m_moduleName; }
+
 		virtual bool canInitCorrectly(size_t moduleIndex) { return true; }
 
 		virtual bool init() { return true; }
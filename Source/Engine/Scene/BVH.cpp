@@ -0,0 +1,588 @@
+#include "Pch.h"
+#include "BVH.h"
+
+#include <numeric>
+
+namespace Flower
+{
+	// Depth limit keep traverse stack safe, node over this depth force leaf.
+	constexpr uint32_t kMaxBuildDepth = BVH::kStackSize - 16;
+
+	// Sah leaf can hold more primitives than kMaxLeafSize when split no worth.
+	constexpr uint32_t kMaxSahLeafSize = 16;
+
+	BVHBounds BVHBounds::transform(const glm::vec3& center, const glm::vec3& extents, const glm::mat4& matrix)
+	{
+		const glm::vec3 worldCenter = glm::vec3(matrix * glm::vec4(center, 1.0f));
+
+		// Project extents on world axis.
+		const glm::vec3 worldExtents =
+			glm::abs(glm::vec3(matrix[0])) * extents.x +
+			glm::abs(glm::vec3(matrix[1])) * extents.y +
+			glm::abs(glm::vec3(matrix[2])) * extents.z;
+
+		BVHBounds result;
+		result.min = worldCenter - worldExtents;
+		result.max = worldCenter + worldExtents;
+		return result;
+	}
+
+	void BVH::clear()
+	{
+		m_nodes.clear();
+		m_primitiveIndices.clear();
+		m_primitiveBounds.clear();
+		m_nodeParents.clear();
+		m_primitiveLeafs.clear();
+		m_bNodeDirty.clear();
+		m_bRefitPending = false;
+		m_buildCost = 0.0f;
+	}
+
+	void BVH::build(std::vector<BVHBounds>&& primitiveBounds)
+	{
+		clear();
+
+		m_primitiveBounds = std::move(primitiveBounds);
+		const uint32_t primitiveCount = uint32_t(m_primitiveBounds.size());
+		if (primitiveCount == 0)
+		{
+			return;
+		}
+
+		for (auto& bounds : m_primitiveBounds)
+		{
+			if (!bounds.isValid())
+			{
+				// Invalid bounds keep as point, caller's intersect reject it.
+				bounds.min = glm::vec3(0.0f);
+				bounds.max = glm::vec3(0.0f);
+			}
+		}
+
+		m_primitiveIndices.resize(primitiveCount);
+		std::iota(m_primitiveIndices.begin(), m_primitiveIndices.end(), 0u);
+
+		m_buildCentroids.resize(primitiveCount);
+		for (uint32_t i = 0; i < primitiveCount; i++)
+		{
+			m_buildCentroids[i] = m_primitiveBounds[i].getCenter();
+		}
+
+		m_nodes.reserve(size_t(primitiveCount) * 2);
+		m_nodeParents.reserve(size_t(primitiveCount) * 2);
+
+		m_nodes.push_back({});
+		m_nodeParents.push_back(GBVHInvalidIndex);
+		buildRecursive(0, 0, primitiveCount, 0);
+		m_buildCentroids = {};
+
+		m_primitiveLeafs.resize(primitiveCount);
+		for (uint32_t nodeId = 0; nodeId < m_nodes.size(); nodeId++)
+		{
+			const Node& node = m_nodes[nodeId];
+			for (uint32_t i = 0; i < node.primitiveCount; i++)
+			{
+				m_primitiveLeafs[m_primitiveIndices[node.leftOrFirst + i]] = nodeId;
+			}
+		}
+		m_bNodeDirty.resize(m_nodes.size(), 0);
+
+		m_buildCost = computeCost();
+	}
+
+	void BVH::buildRecursive(uint32_t nodeId, uint32_t first, uint32_t count, uint32_t depth)
+	{
+		BVHBounds nodeBounds;
+		BVHBounds centroidBounds;
+		for (uint32_t i = first; i < first + count; i++)
+		{
+			nodeBounds.expand(m_primitiveBounds[m_primitiveIndices[i]]);
+			centroidBounds.expand(m_buildCentroids[m_primitiveIndices[i]]);
+		}
+
+		m_nodes[nodeId].boundsMin = nodeBounds.min;
+		m_nodes[nodeId].boundsMax = nodeBounds.max;
+
+		auto makeLeaf = [&]()
+		{
+			m_nodes[nodeId].leftOrFirst = first;
+			m_nodes[nodeId].primitiveCount = count;
+		};
+
+		if (count <= kMaxLeafSize || depth >= kMaxBuildDepth)
+		{
+			makeLeaf();
+			return;
+		}
+
+		// Binned sah, cost in surface area unit: leaf cost is count * area, split cost is area + left + right.
+		struct Bin
+		{
+			BVHBounds bounds;
+			uint32_t count = 0;
+		};
+
+		const float nodeArea = nodeBounds.getSurfaceArea();
+		const float leafCost = float(count) * nodeArea;
+
+		float bestCost = std::numeric_limits<float>::max();
+		uint32_t bestAxis = 0;
+		uint32_t bestSplit = 0;
+
+		for (uint32_t axis = 0; axis < 3; axis++)
+		{
+			const float axisMin = centroidBounds.min[axis];
+			const float axisExtent = centroidBounds.max[axis] - axisMin;
+			if (axisExtent <= 0.0f)
+			{
+				continue;
+			}
+
+			const float binScale = float(kBinCount) / axisExtent;
+			Bin bins[kBinCount];
+			for (uint32_t i = first; i < first + count; i++)
+			{
+				const uint32_t primitive = m_primitiveIndices[i];
+				const uint32_t binId = glm::min(kBinCount - 1, uint32_t((m_buildCentroids[primitive][axis] - axisMin) * binScale));
+				bins[binId].bounds.expand(m_primitiveBounds[primitive]);
+				bins[binId].count++;
+			}
+
+			// Sweep from right, then from left evaluate each split plane.
+			float rightArea[kBinCount - 1];
+			uint32_t rightCount[kBinCount - 1];
+			{
+				BVHBounds bounds;
+				uint32_t sum = 0;
+				for (uint32_t i = kBinCount - 1; i > 0; i--)
+				{
+					bounds.expand(bins[i].bounds);
+					sum += bins[i].count;
+					rightArea[i - 1] = bounds.getSurfaceArea();
+					rightCount[i - 1] = sum;
+				}
+			}
+
+			BVHBounds leftBounds;
+			uint32_t leftSum = 0;
+			for (uint32_t i = 0; i < kBinCount - 1; i++)
+			{
+				leftBounds.expand(bins[i].bounds);
+				leftSum += bins[i].count;
+				if (leftSum == 0 || rightCount[i] == 0)
+				{
+					continue;
+				}
+
+				const float cost = nodeArea + leftBounds.getSurfaceArea() * float(leftSum) + rightArea[i] * float(rightCount[i]);
+				if (cost < bestCost)
+				{
+					bestCost = cost;
+					bestAxis = axis;
+					bestSplit = i;
+				}
+			}
+		}
+
+		uint32_t leftCount = 0;
+		if (bestCost < std::numeric_limits<float>::max())
+		{
+			if (bestCost >= leafCost && count <= kMaxSahLeafSize)
+			{
+				makeLeaf();
+				return;
+			}
+
+			const float axisMin = centroidBounds.min[bestAxis];
+			const float binScale = float(kBinCount) / (centroidBounds.max[bestAxis] - axisMin);
+			auto middle = std::partition(m_primitiveIndices.begin() + first, m_primitiveIndices.begin() + first + count, [&](uint32_t primitive)
+			{
+				const float center = m_buildCentroids[primitive][bestAxis];
+				return glm::min(kBinCount - 1, uint32_t((center - axisMin) * binScale)) <= bestSplit;
+			});
+			leftCount = uint32_t(middle - (m_primitiveIndices.begin() + first));
+		}
+
+		// All centroids overlap or float error, split by half.
+		if (leftCount == 0 || leftCount == count)
+		{
+			leftCount = count / 2;
+		}
+
+		const uint32_t leftId = uint32_t(m_nodes.size());
+		m_nodes.push_back({});
+		m_nodes.push_back({});
+		m_nodeParents.push_back(nodeId);
+		m_nodeParents.push_back(nodeId);
+
+		m_nodes[nodeId].leftOrFirst = leftId;
+		m_nodes[nodeId].primitiveCount = 0;
+
+		buildRecursive(leftId + 0, first, leftCount, depth + 1);
+		buildRecursive(leftId + 1, first + leftCount, count - leftCount, depth + 1);
+	}
+
+	void BVH::updateNodeBounds(uint32_t nodeId)
+	{
+		Node& node = m_nodes[nodeId];
+
+		BVHBounds bounds;
+		if (node.isLeaf())
+		{
+			for (uint32_t i = 0; i < node.primitiveCount; i++)
+			{
+				bounds.expand(m_primitiveBounds[m_primitiveIndices[node.leftOrFirst + i]]);
+			}
+		}
+		else
+		{
+			for (uint32_t childId = node.leftOrFirst; childId < node.leftOrFirst + 2; childId++)
+			{
+				bounds.min = glm::min(bounds.min, m_nodes[childId].boundsMin);
+				bounds.max = glm::max(bounds.max, m_nodes[childId].boundsMax);
+			}
+		}
+
+		node.boundsMin = bounds.min;
+		node.boundsMax = bounds.max;
+	}
+
+	void BVH::setPrimitiveBounds(uint32_t primitive, const BVHBounds& bounds)
+	{
+		CHECK(primitive < m_primitiveBounds.size());
+		m_primitiveBounds[primitive] = bounds.isValid() ? bounds : BVHBounds{ glm::vec3(0.0f), glm::vec3(0.0f) };
+
+		// Mark path to root, stop at node which already dirty.
+		uint32_t nodeId = m_primitiveLeafs[primitive];
+		while (nodeId != GBVHInvalidIndex && !m_bNodeDirty[nodeId])
+		{
+			m_bNodeDirty[nodeId] = 1;
+			nodeId = m_nodeParents[nodeId];
+		}
+		m_bRefitPending = true;
+	}
+
+	void BVH::refit()
+	{
+		if (!m_bRefitPending)
+		{
+			return;
+		}
+
+		// Children always allocate after parent, so reverse order is bottom up.
+		for (uint32_t nodeId = uint32_t(m_nodes.size()); nodeId-- > 0;)
+		{
+			if (m_bNodeDirty[nodeId])
+			{
+				updateNodeBounds(nodeId);
+				m_bNodeDirty[nodeId] = 0;
+			}
+		}
+		m_bRefitPending = false;
+	}
+
+	float BVH::computeCost() const
+	{
+		if (m_nodes.empty())
+		{
+			return 0.0f;
+		}
+
+		auto nodeArea = [](const Node& node)
+		{
+			return BVHBounds{ node.boundsMin, node.boundsMax }.getSurfaceArea();
+		};
+
+		double cost = 0.0;
+		for (const auto& node : m_nodes)
+		{
+			cost += double(nodeArea(node)) * (node.isLeaf() ? double(node.primitiveCount) : 1.0);
+		}
+
+		const float rootArea = nodeArea(m_nodes[0]);
+		return rootArea > 0.0f ? float(cost / double(rootArea)) : 0.0f;
+	}
+
+	void BVH::queryFrustum(const glm::vec4 planes[6], std::vector<uint32_t>& outPrimitives) const
+	{
+		if (m_nodes.empty())
+		{
+			return;
+		}
+
+		enum class ETestResult
+		{
+			Outside,
+			Intersect,
+			Inside,
+		};
+
+		auto testBounds = [&](const glm::vec3& bmin, const glm::vec3& bmax)
+		{
+			ETestResult result = ETestResult::Inside;
+			for (uint32_t i = 0; i < 6; i++)
+			{
+				const glm::vec3 n = glm::vec3(planes[i]);
+
+				// Farthest and nearest corner along plane normal.
+				const glm::vec3 positive = glm::mix(bmin, bmax, glm::greaterThanEqual(n, glm::vec3(0.0f)));
+				const glm::vec3 negative = glm::mix(bmax, bmin, glm::greaterThanEqual(n, glm::vec3(0.0f)));
+
+				if (glm::dot(n, positive) + planes[i].w < 0.0f)
+				{
+					return ETestResult::Outside;
+				}
+				if (glm::dot(n, negative) + planes[i].w < 0.0f)
+				{
+					result = ETestResult::Intersect;
+				}
+			}
+			return result;
+		};
+
+		// Node fully inside push all primitives without test.
+		std::pair<uint32_t, bool> stack[kStackSize];
+		uint32_t stackSize = 0;
+		stack[stackSize++] = { 0, false };
+
+		while (stackSize > 0)
+		{
+			const auto [nodeId, bParentInside] = stack[--stackSize];
+			const Node& node = m_nodes[nodeId];
+
+			bool bInside = bParentInside;
+			if (!bInside)
+			{
+				const ETestResult result = testBounds(node.boundsMin, node.boundsMax);
+				if (result == ETestResult::Outside)
+				{
+					continue;
+				}
+				bInside = (result == ETestResult::Inside);
+			}
+
+			if (node.isLeaf())
+			{
+				for (uint32_t i = 0; i < node.primitiveCount; i++)
+				{
+					const uint32_t primitive = m_primitiveIndices[node.leftOrFirst + i];
+					const auto& bounds = m_primitiveBounds[primitive];
+					if (bInside || testBounds(bounds.min, bounds.max) != ETestResult::Outside)
+					{
+						outPrimitives.push_back(primitive);
+					}
+				}
+				continue;
+			}
+
+			CHECK(stackSize + 2 <= kStackSize);
+			stack[stackSize++] = { node.leftOrFirst + 1, bInside };
+			stack[stackSize++] = { node.leftOrFirst + 0, bInside };
+		}
+	}
+
+	void BVH::querySphere(const glm::vec3& center, float radius, std::vector<uint32_t>& outPrimitives) const
+	{
+		if (m_nodes.empty())
+		{
+			return;
+		}
+
+		const float radiusSquare = radius * radius;
+		auto overlap = [&](const glm::vec3& bmin, const glm::vec3& bmax)
+		{
+			const glm::vec3 closest = glm::clamp(center, bmin, bmax);
+			const glm::vec3 d = closest - center;
+			return glm::dot(d, d) <= radiusSquare;
+		};
+
+		uint32_t stack[kStackSize];
+		uint32_t stackSize = 0;
+		stack[stackSize++] = 0;
+
+		while (stackSize > 0)
+		{
+			const Node& node = m_nodes[stack[--stackSize]];
+			if (!overlap(node.boundsMin, node.boundsMax))
+			{
+				continue;
+			}
+
+			if (node.isLeaf())
+			{
+				for (uint32_t i = 0; i < node.primitiveCount; i++)
+				{
+					const uint32_t primitive = m_primitiveIndices[node.leftOrFirst + i];
+					if (overlap(m_primitiveBounds[primitive].min, m_primitiveBounds[primitive].max))
+					{
+						outPrimitives.push_back(primitive);
+					}
+				}
+				continue;
+			}
+
+			CHECK(stackSize + 2 <= kStackSize);
+			stack[stackSize++] = node.leftOrFirst + 1;
+			stack[stackSize++] = node.leftOrFirst + 0;
+		}
+	}
+
+	void TriangleBVH::build(const std::vector<StaticMeshVertex>& vertices, const VertexIndexType* indices, size_t indexCount)
+	{
+		CHECK(indexCount % 3 == 0);
+
+		m_positions.resize(indexCount);
+		std::vector<BVHBounds> triangleBounds(indexCount / 3);
+		for (size_t triangle = 0; triangle < triangleBounds.size(); triangle++)
+		{
+			for (size_t k = 0; k < 3; k++)
+			{
+				const glm::vec3& position = vertices[indices[triangle * 3 + k]].position;
+				m_positions[triangle * 3 + k] = position;
+				triangleBounds[triangle].expand(position);
+			}
+		}
+
+		m_bvh.build(std::move(triangleBounds));
+	}
+
+	bool TriangleBVH::intersectTriangle(uint32_t triangle, const BVHRay& ray, float& inoutT) const
+	{
+		// Moller trumbore.
+		const glm::vec3& a = m_positions[triangle * 3 + 0];
+		const glm::vec3 e1 = m_positions[triangle * 3 + 1] - a;
+		const glm::vec3 e2 = m_positions[triangle * 3 + 2] - a;
+
+		const glm::vec3 p = glm::cross(ray.direction, e2);
+		const float det = glm::dot(e1, p);
+		if (glm::abs(det) < 1e-12f)
+		{
+			return false;
+		}
+		const float invDet = 1.0f / det;
+
+		const glm::vec3 s = ray.origin - a;
+		const float u = glm::dot(s, p) * invDet;
+		if (u < 0.0f || u > 1.0f)
+		{
+			return false;
+		}
+
+		const glm::vec3 q = glm::cross(s, e1);
+		const float v = glm::dot(ray.direction, q) * invDet;
+		if (v < 0.0f || u + v > 1.0f)
+		{
+			return false;
+		}
+
+		const float t = glm::dot(e2, q) * invDet;
+		if (t < ray.tMin || t >= inoutT)
+		{
+			return false;
+		}
+
+		inoutT = t;
+		return true;
+	}
+
+	uint32_t TriangleBVH::trace(const BVHRay& ray, float& outT) const
+	{
+		outT = ray.tMax;
+		return m_bvh.traceClosest(ray, [&](uint32_t triangle, const BVHRay& r, float& tMax)
+		{
+			if (intersectTriangle(triangle, r, tMax))
+			{
+				outT = tMax;
+				return true;
+			}
+			return false;
+		});
+	}
+
+	uint32_t TriangleBVH::countHits(const BVHRay& ray) const
+	{
+		// Intersect never shrink tMax, so traverse visit all hit triangles.
+		uint32_t count = 0;
+		m_bvh.traceClosest(ray, [&](uint32_t triangle, const BVHRay& r, float& tMax)
+		{
+			float t = tMax;
+			if (intersectTriangle(triangle, r, t))
+			{
+				count++;
+			}
+			return false;
+		});
+		return count;
+	}
+
+	glm::vec3 TriangleBVH::closestPointOnTriangle(uint32_t triangle, const glm::vec3& p) const
+	{
+		// Voronoi region test, from real-time collision detection 5.1.5.
+		const glm::vec3& a = m_positions[triangle * 3 + 0];
+		const glm::vec3& b = m_positions[triangle * 3 + 1];
+		const glm::vec3& c = m_positions[triangle * 3 + 2];
+
+		const glm::vec3 ab = b - a;
+		const glm::vec3 ac = c - a;
+		const glm::vec3 ap = p - a;
+		const float d1 = glm::dot(ab, ap);
+		const float d2 = glm::dot(ac, ap);
+		if (d1 <= 0.0f && d2 <= 0.0f)
+		{
+			return a;
+		}
+
+		const glm::vec3 bp = p - b;
+		const float d3 = glm::dot(ab, bp);
+		const float d4 = glm::dot(ac, bp);
+		if (d3 >= 0.0f && d4 <= d3)
+		{
+			return b;
+		}
+
+		const float vc = d1 * d4 - d3 * d2;
+		if (vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f)
+		{
+			return a + ab * (d1 / (d1 - d3));
+		}
+
+		const glm::vec3 cp = p - c;
+		const float d5 = glm::dot(ab, cp);
+		const float d6 = glm::dot(ac, cp);
+		if (d6 >= 0.0f && d5 <= d6)
+		{
+			return c;
+		}
+
+		const float vb = d5 * d2 - d1 * d6;
+		if (vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f)
+		{
+			return a + ac * (d2 / (d2 - d6));
+		}
+
+		const float va = d3 * d6 - d5 * d4;
+		if (va <= 0.0f && (d4 - d3) >= 0.0f && (d5 - d6) >= 0.0f)
+		{
+			return b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)));
+		}
+
+		const float denom = 1.0f / (va + vb + vc);
+		return a + ab * (vb * denom) + ac * (vc * denom);
+	}
+
+	uint32_t TriangleBVH::queryClosest(const glm::vec3& point, float& inoutDistanceSquare) const
+	{
+		return m_bvh.queryClosest(point, inoutDistanceSquare, [&](uint32_t triangle, const glm::vec3& p, float& distanceSquare)
+		{
+			const glm::vec3 d = closestPointOnTriangle(triangle, p) - p;
+			const float dd = glm::dot(d, d);
+			if (dd < distanceSquare)
+			{
+				distanceSquare = dd;
+				return true;
+			}
+			return false;
+		});
+	}
+}
@@ -0,0 +1,447 @@
+#pragma once
+#include "../Core/Core.h"
+#include "../Renderer/MeshMisc.h"
+
+#include <xmmintrin.h>
+
+namespace Flower
+{
+	struct BVHBounds
+	{
+		glm::vec3 min = glm::vec3( std::numeric_limits<float>::max());
+		glm::vec3 max = glm::vec3(-std::numeric_limits<float>::max());
+
+		bool isValid() const
+		{
+			return min.x <= max.x && min.y <= max.y && min.z <= max.z;
+		}
+
+		void expand(const glm::vec3& p)
+		{
+			min = glm::min(min, p);
+			max = glm::max(max, p);
+		}
+
+		void expand(const BVHBounds& b)
+		{
+			min = glm::min(min, b.min);
+			max = glm::max(max, b.max);
+		}
+
+		glm::vec3 getCenter() const
+		{
+			return (min + max) * 0.5f;
+		}
+
+		float getSurfaceArea() const
+		{
+			if (!isValid())
+			{
+				return 0.0f;
+			}
+
+			const glm::vec3 d = max - min;
+			return 2.0f * (d.x * d.y + d.y * d.z + d.z * d.x);
+		}
+
+		// Local box transform to world aabb.
+		static BVHBounds transform(const glm::vec3& center, const glm::vec3& extents, const glm::mat4& matrix);
+	};
+
+	struct BVHRay
+	{
+		glm::vec3 origin = glm::vec3(0.0f);
+		glm::vec3 direction = glm::vec3(0.0f, 0.0f, -1.0f);
+		float tMin = 0.0f;
+		float tMax = std::numeric_limits<float>::max();
+	};
+
+	constexpr uint32_t GBVHInvalidIndex = ~0u;
+	constexpr uint32_t GBVHPacketSize = 4;
+
+	// Binary bvh over primitive aabbs, build with binned sah, support refit when primitive bounds change.
+	// Primitive intersect is caller's work, bvh only cull by bounds.
+	class BVH
+	{
+	public:
+		struct Node
+		{
+			glm::vec3 boundsMin;
+
+			// Inner node: left child index, right child is left + 1. Leaf: first index in primitive indices.
+			uint32_t leftOrFirst;
+
+			glm::vec3 boundsMax;
+
+			// Zero when inner node.
+			uint32_t primitiveCount;
+
+			bool isLeaf() const { return primitiveCount > 0; }
+		};
+		static_assert(sizeof(Node) == 32);
+
+		static constexpr uint32_t kMaxLeafSize = 4;
+		static constexpr uint32_t kBinCount = 16;
+		static constexpr uint32_t kStackSize = 64;
+
+	private:
+		std::vector<Node> m_nodes;
+		std::vector<uint32_t> m_primitiveIndices;
+		std::vector<BVHBounds> m_primitiveBounds;
+
+		// Refit state.
+		std::vector<uint32_t> m_nodeParents;
+		std::vector<uint32_t> m_primitiveLeafs;
+		std::vector<uint8_t> m_bNodeDirty;
+		bool m_bRefitPending = false;
+
+		float m_buildCost = 0.0f;
+
+		// Only valid when build.
+		std::vector<glm::vec3> m_buildCentroids;
+
+	private:
+		void buildRecursive(uint32_t nodeId, uint32_t first, uint32_t count, uint32_t depth);
+		void updateNodeBounds(uint32_t nodeId);
+
+		static bool intersectBounds(const glm::vec3& bmin, const glm::vec3& bmax, const glm::vec3& origin, const glm::vec3& invDir, float tMin, float tMax, float& outNear)
+		{
+			const glm::vec3 t0 = (bmin - origin) * invDir;
+			const glm::vec3 t1 = (bmax - origin) * invDir;
+			const glm::vec3 tNear = glm::min(t0, t1);
+			const glm::vec3 tFar = glm::max(t0, t1);
+
+			outNear = glm::max(glm::max(tNear.x, tNear.y), glm::max(tNear.z, tMin));
+			const float farDist = glm::min(glm::min(tFar.x, tFar.y), glm::min(tFar.z, tMax));
+			return outNear <= farDist;
+		}
+
+		static glm::vec3 safeInverse(const glm::vec3& d)
+		{
+			auto inv = [](float v)
+			{
+				return 1.0f / (glm::abs(v) > 1e-20f ? v : (v >= 0.0f ? 1e-20f : -1e-20f));
+			};
+			return glm::vec3(inv(d.x), inv(d.y), inv(d.z));
+		}
+
+	public:
+		// Ray box enter distance, clamp by ray tMin and input tMax.
+		static bool intersectRay(const BVHBounds& bounds, const BVHRay& ray, float tMax, float& outNear)
+		{
+			return intersectBounds(bounds.min, bounds.max, ray.origin, safeInverse(ray.direction), ray.tMin, tMax, outNear);
+		}
+
+		void build(std::vector<BVHBounds>&& primitiveBounds);
+		void clear();
+
+		bool empty() const { return m_nodes.empty(); }
+		uint32_t getPrimitiveCount() const { return uint32_t(m_primitiveBounds.size()); }
+		uint32_t getNodeCount() const { return uint32_t(m_nodes.size()); }
+		const BVHBounds& getPrimitiveBounds(uint32_t primitive) const { return m_primitiveBounds[primitive]; }
+
+		// Update primitive bounds, take effect after refit.
+		void setPrimitiveBounds(uint32_t primitive, const BVHBounds& bounds);
+
+		// Only refit nodes whose primitive bounds change.
+		void refit();
+
+		// Sah cost relative to root area, refit tree degrade when primitive move far, caller can compare with build cost to decide rebuild.
+		float computeCost() const;
+		float getBuildCost() const { return m_buildCost; }
+
+		// Closest hit traverse, intersect(primitive, ray, inoutTMax) return true and shrink tMax when hit.
+		// Return hit primitive or GBVHInvalidIndex.
+		template<typename F>
+		uint32_t traceClosest(const BVHRay& ray, F&& intersect) const;
+
+		// Four rays packet traverse with sse, intersect(primitive, rayIndex, ray, inoutTMax).
+		// Rays in packet better be coherent, node visit when any ray active.
+		template<typename F>
+		void tracePacket(const BVHRay rays[GBVHPacketSize], uint32_t outHits[GBVHPacketSize], F&& intersect) const;
+
+		// Frustum planes point inside, same with GPUViewData::frustumPlanes.
+		void queryFrustum(const glm::vec4 planes[6], std::vector<uint32_t>& outPrimitives) const;
+
+		void querySphere(const glm::vec3& center, float radius, std::vector<uint32_t>& outPrimitives) const;
+
+		// Closest primitive to point within sqrt(inoutDistanceSquare), distance(primitive, point, inoutDistanceSquare)
+		// return true and shrink distance when closer. Return closest primitive or GBVHInvalidIndex.
+		template<typename F>
+		uint32_t queryClosest(const glm::vec3& point, float& inoutDistanceSquare, F&& distance) const;
+	};
+
+	template<typename F>
+	inline uint32_t BVH::traceClosest(const BVHRay& ray, F&& intersect) const
+	{
+		uint32_t hitPrimitive = GBVHInvalidIndex;
+		if (m_nodes.empty())
+		{
+			return hitPrimitive;
+		}
+
+		const glm::vec3 invDir = safeInverse(ray.direction);
+		float tMax = ray.tMax;
+
+		uint32_t stack[kStackSize];
+		uint32_t stackSize = 0;
+
+		float rootNear;
+		if (!intersectBounds(m_nodes[0].boundsMin, m_nodes[0].boundsMax, ray.origin, invDir, ray.tMin, tMax, rootNear))
+		{
+			return hitPrimitive;
+		}
+		stack[stackSize++] = 0;
+
+		while (stackSize > 0)
+		{
+			const Node& node = m_nodes[stack[--stackSize]];
+			if (node.isLeaf())
+			{
+				for (uint32_t i = 0; i < node.primitiveCount; i++)
+				{
+					const uint32_t primitive = m_primitiveIndices[node.leftOrFirst + i];
+					if (intersect(primitive, ray, tMax))
+					{
+						hitPrimitive = primitive;
+					}
+				}
+				continue;
+			}
+
+			// Push far child first, so near child pop first.
+			const uint32_t left = node.leftOrFirst;
+			const uint32_t right = left + 1;
+
+			float leftNear, rightNear;
+			const bool bLeft = intersectBounds(m_nodes[left].boundsMin, m_nodes[left].boundsMax, ray.origin, invDir, ray.tMin, tMax, leftNear);
+			const bool bRight = intersectBounds(m_nodes[right].boundsMin, m_nodes[right].boundsMax, ray.origin, invDir, ray.tMin, tMax, rightNear);
+
+			if (bLeft && bRight)
+			{
+				CHECK(stackSize + 2 <= kStackSize);
+				stack[stackSize++] = leftNear < rightNear ? right : left;
+				stack[stackSize++] = leftNear < rightNear ? left : right;
+			}
+			else if (bLeft || bRight)
+			{
+				CHECK(stackSize + 1 <= kStackSize);
+				stack[stackSize++] = bLeft ? left : right;
+			}
+		}
+
+		return hitPrimitive;
+	}
+
+	template<typename F>
+	inline void BVH::tracePacket(const BVHRay rays[GBVHPacketSize], uint32_t outHits[GBVHPacketSize], F&& intersect) const
+	{
+		static_assert(GBVHPacketSize == 4);
+
+		for (uint32_t i = 0; i < GBVHPacketSize; i++)
+		{
+			outHits[i] = GBVHInvalidIndex;
+		}
+
+		if (m_nodes.empty())
+		{
+			return;
+		}
+
+		// Soa packet.
+		alignas(16) float ox[4], oy[4], oz[4], ix[4], iy[4], iz[4], tMin[4], tMax[4];
+		for (uint32_t i = 0; i < GBVHPacketSize; i++)
+		{
+			const glm::vec3 invDir = safeInverse(rays[i].direction);
+			ox[i] = rays[i].origin.x; oy[i] = rays[i].origin.y; oz[i] = rays[i].origin.z;
+			ix[i] = invDir.x; iy[i] = invDir.y; iz[i] = invDir.z;
+			tMin[i] = rays[i].tMin;
+			tMax[i] = rays[i].tMax;
+		}
+
+		const __m128 originX = _mm_load_ps(ox), originY = _mm_load_ps(oy), originZ = _mm_load_ps(oz);
+		const __m128 invDirX = _mm_load_ps(ix), invDirY = _mm_load_ps(iy), invDirZ = _mm_load_ps(iz);
+		const __m128 rayTMin = _mm_load_ps(tMin);
+		__m128 rayTMax = _mm_load_ps(tMax);
+
+		// Return active ray mask, and nearest enter distance of active rays.
+		auto intersectNode = [&](const Node& node, float& outNear) -> int
+		{
+			const __m128 t0x = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(node.boundsMin.x), originX), invDirX);
+			const __m128 t1x = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(node.boundsMax.x), originX), invDirX);
+			const __m128 t0y = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(node.boundsMin.y), originY), invDirY);
+			const __m128 t1y = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(node.boundsMax.y), originY), invDirY);
+			const __m128 t0z = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(node.boundsMin.z), originZ), invDirZ);
+			const __m128 t1z = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(node.boundsMax.z), originZ), invDirZ);
+
+			const __m128 tNear = _mm_max_ps(_mm_max_ps(_mm_min_ps(t0x, t1x), _mm_min_ps(t0y, t1y)), _mm_max_ps(_mm_min_ps(t0z, t1z), rayTMin));
+			const __m128 tFar = _mm_min_ps(_mm_min_ps(_mm_max_ps(t0x, t1x), _mm_max_ps(t0y, t1y)), _mm_min_ps(_mm_max_ps(t0z, t1z), rayTMax));
+			const int mask = _mm_movemask_ps(_mm_cmple_ps(tNear, tFar));
+
+			alignas(16) float nearDist[4];
+			_mm_store_ps(nearDist, tNear);
+
+			outNear = std::numeric_limits<float>::max();
+			for (uint32_t i = 0; i < GBVHPacketSize; i++)
+			{
+				if (mask & (1 << i))
+				{
+					outNear = glm::min(outNear, nearDist[i]);
+				}
+			}
+			return mask;
+		};
+
+		uint32_t stack[kStackSize];
+		uint32_t stackSize = 0;
+
+		float rootNear;
+		if (intersectNode(m_nodes[0], rootNear) == 0)
+		{
+			return;
+		}
+		stack[stackSize++] = 0;
+
+		while (stackSize > 0)
+		{
+			const Node& node = m_nodes[stack[--stackSize]];
+			if (node.isLeaf())
+			{
+				// Node may pass when push but all ray already hit closer.
+				float nodeNear;
+				const int mask = intersectNode(node, nodeNear);
+				if (mask == 0)
+				{
+					continue;
+				}
+
+				for (uint32_t i = 0; i < node.primitiveCount; i++)
+				{
+					const uint32_t primitive = m_primitiveIndices[node.leftOrFirst + i];
+					for (uint32_t rayId = 0; rayId < GBVHPacketSize; rayId++)
+					{
+						if ((mask & (1 << rayId)) && intersect(primitive, rayId, rays[rayId], tMax[rayId]))
+						{
+							outHits[rayId] = primitive;
+						}
+					}
+				}
+				rayTMax = _mm_load_ps(tMax);
+				continue;
+			}
+
+			const uint32_t left = node.leftOrFirst;
+			const uint32_t right = left + 1;
+
+			float leftNear, rightNear;
+			const bool bLeft = intersectNode(m_nodes[left], leftNear) != 0;
+			const bool bRight = intersectNode(m_nodes[right], rightNear) != 0;
+
+			if (bLeft && bRight)
+			{
+				CHECK(stackSize + 2 <= kStackSize);
+				stack[stackSize++] = leftNear < rightNear ? right : left;
+				stack[stackSize++] = leftNear < rightNear ? left : right;
+			}
+			else if (bLeft || bRight)
+			{
+				CHECK(stackSize + 1 <= kStackSize);
+				stack[stackSize++] = bLeft ? left : right;
+			}
+		}
+	}
+
+	template<typename F>
+	inline uint32_t BVH::queryClosest(const glm::vec3& point, float& inoutDistanceSquare, F&& distance) const
+	{
+		uint32_t closestPrimitive = GBVHInvalidIndex;
+		if (m_nodes.empty())
+		{
+			return closestPrimitive;
+		}
+
+		auto boundsDistanceSquare = [&](const glm::vec3& bmin, const glm::vec3& bmax)
+		{
+			const glm::vec3 d = glm::max(glm::max(bmin - point, glm::vec3(0.0f)), point - bmax);
+			return glm::dot(d, d);
+		};
+
+		uint32_t stack[kStackSize];
+		uint32_t stackSize = 0;
+		stack[stackSize++] = 0;
+
+		while (stackSize > 0)
+		{
+			const Node& node = m_nodes[stack[--stackSize]];
+			if (boundsDistanceSquare(node.boundsMin, node.boundsMax) > inoutDistanceSquare)
+			{
+				continue;
+			}
+
+			if (node.isLeaf())
+			{
+				for (uint32_t i = 0; i < node.primitiveCount; i++)
+				{
+					const uint32_t primitive = m_primitiveIndices[node.leftOrFirst + i];
+					if (distance(primitive, point, inoutDistanceSquare))
+					{
+						closestPrimitive = primitive;
+					}
+				}
+				continue;
+			}
+
+			// Near child pop first, shrink distance early.
+			const uint32_t left = node.leftOrFirst;
+			const uint32_t right = left + 1;
+			const float leftDistance = boundsDistanceSquare(m_nodes[left].boundsMin, m_nodes[left].boundsMax);
+			const float rightDistance = boundsDistanceSquare(m_nodes[right].boundsMin, m_nodes[right].boundsMax);
+
+			const bool bLeft = leftDistance <= inoutDistanceSquare;
+			const bool bRight = rightDistance <= inoutDistanceSquare;
+			if (bLeft && bRight)
+			{
+				CHECK(stackSize + 2 <= kStackSize);
+				stack[stackSize++] = leftDistance < rightDistance ? right : left;
+				stack[stackSize++] = leftDistance < rightDistance ? left : right;
+			}
+			else if (bLeft || bRight)
+			{
+				CHECK(stackSize + 1 <= kStackSize);
+				stack[stackSize++] = bLeft ? left : right;
+			}
+		}
+
+		return closestPrimitive;
+	}
+
+	// Triangle bvh of one submesh, for exact ray hit.
+	class TriangleBVH
+	{
+	private:
+		BVH m_bvh;
+
+		// Three position per triangle, copy from mesh so bin data can free.
+		std::vector<glm::vec3> m_positions;
+
+	public:
+		void build(const std::vector<StaticMeshVertex>& vertices, const VertexIndexType* indices, size_t indexCount);
+
+		uint32_t getTriangleCount() const { return uint32_t(m_positions.size() / 3); }
+
+		// Double side triangle hit, return true and update inoutT when hit closer than inoutT.
+		bool intersectTriangle(uint32_t triangle, const BVHRay& ray, float& inoutT) const;
+
+		// Return hit triangle or GBVHInvalidIndex.
+		uint32_t trace(const BVHRay& ray, float& outT) const;
+
+		// All hits count along ray, hit on shared edge may count twice.
+		uint32_t countHits(const BVHRay& ray) const;
+
+		// Closest point on triangle.
+		glm::vec3 closestPointOnTriangle(uint32_t triangle, const glm::vec3& point) const;
+
+		// Return closest triangle within sqrt(inoutDistanceSquare) or GBVHInvalidIndex.
+		uint32_t queryClosest(const glm::vec3& point, float& inoutDistanceSquare) const;
+	};
+}
@@ -6,6 +6,8 @@ namespace Flower
 {
 	class DirectionalLightComponent : public LightComponent
 	{
+		friend class SceneArchive;
+
 	public:
 		DirectionalLightComponent() {}
 		virtual ~DirectionalLightComponent() = default;
@@ -1,11 +1,300 @@
 #include "Pch.h"
 #include "Landscape.h"
+#include "Scene/SceneNode.h"
+#include "Scene/Scene.h"
+#include "../../AssetSystem/AssetRegistry.h"
+#include "../../AssetSystem/LandscapeManager.h"
 
 namespace Flower
 {
+	static AutoCVarFloat cVarLandscapeStreamingRadius(
+		"r.Landscape.StreamingRadius",
+		"Height tiles inside this camera xz distance stream in, tiles out of 1.25x radius stream out.",
+		"Landscape",
+		2048.0f,
+		CVarFlags::ReadAndWrite
+	);
+
+	static AutoCVarInt32 cVarLandscapeMaxResidentTiles(
+		"r.Landscape.MaxResidentTiles",
+		"Max resident height tiles per landscape, farthest tile evict first.",
+		"Landscape",
+		256,
+		CVarFlags::ReadAndWrite
+	);
+
+	static AutoCVarInt32 cVarLandscapeTileUploadPerFrame(
+		"r.Landscape.TileUploadPerFrame",
+		"Max new height tile upload request per landscape per frame.",
+		"Landscape",
+		4,
+		CVarFlags::ReadAndWrite
+	);
+
+	void LandscapeGPUProxy::updateStreaming(const glm::vec3& camPos)
+	{
+		const auto& config = m_quadtree.getConfig();
+		const uint32_t tileSize = m_cacheHeader->getTileSize();
+		const uint32_t tileCountX = m_cacheHeader->getTileCountX();
+		const float radius = glm::max(cVarLandscapeStreamingRadius.get(), 0.0f);
+		const uint32_t maxResident = uint32_t(glm::max(cVarLandscapeMaxResidentTiles.get(), 0));
+
+		uint32_t residentCount = 0;
+		std::vector<uint32_t> candidates;
+		for (uint32_t tileId = 0; tileId < uint32_t(m_tiles.size()); tileId++)
+		{
+			auto& tile = m_tiles[tileId];
+
+			// Tile xz distance, tile cover [tileSize * x, tileSize * (x + 1)] samples.
+			const glm::vec2 tileMin = glm::vec2(config.origin.x, config.origin.z) + config.sampleSpacing * glm::vec2(
+				float((tileId % tileCountX) * tileSize),
+				float((tileId / tileCountX) * tileSize));
+			const glm::vec2 tileMax = glm::min(
+				tileMin + config.sampleSpacing * float(tileSize),
+				glm::vec2(config.origin.x, config.origin.z) + config.sampleSpacing * glm::vec2(float(m_quadtree.getWidth() - 1), float(m_quadtree.getHeight() - 1)));
+			const glm::vec2 camXZ = glm::vec2(camPos.x, camPos.z);
+			tile.distance = glm::length(glm::max(glm::max(tileMin - camXZ, camXZ - tileMax), glm::vec2(0.0f)));
+
+			if (tile.texture == nullptr)
+			{
+				if (tile.distance <= radius)
+				{
+					candidates.push_back(tileId);
+				}
+				continue;
+			}
+
+			// Loading tile keep until ready, only ready tile can evict.
+			if (tile.texture->isReady() && tile.distance > radius * 1.25f)
+			{
+				tile.texture = nullptr;
+				m_pageTable[tileId] = ~0;
+				continue;
+			}
+
+			if (tile.texture->isReady())
+			{
+				m_pageTable[tileId] = tile.texture->getBindlessIndex();
+			}
+			residentCount++;
+		}
+
+		// Closest tile first.
+		std::sort(candidates.begin(), candidates.end(), [&](uint32_t a, uint32_t b)
+		{
+			return m_tiles[a].distance < m_tiles[b].distance;
+		});
+
+		const uint32_t uploadCount = std::min(uint32_t(candidates.size()), uint32_t(glm::max(cVarLandscapeTileUploadPerFrame.get(), 0)));
+		for (uint32_t i = 0; i < uploadCount; i++)
+		{
+			const uint32_t tileId = candidates[i];
+			if (residentCount >= maxResident)
+			{
+				// Evict farthest ready tile when it farther than request one.
+				uint32_t evictId = ~0;
+				for (uint32_t j = 0; j < uint32_t(m_tiles.size()); j++)
+				{
+					if (m_tiles[j].texture && m_tiles[j].texture->isReady() && (evictId == ~0 || m_tiles[j].distance > m_tiles[evictId].distance))
+					{
+						evictId = j;
+					}
+				}
+
+				if (evictId == ~0 || m_tiles[evictId].distance <= m_tiles[tileId].distance)
+				{
+					break;
+				}
+
+				m_tiles[evictId].texture = nullptr;
+				m_pageTable[evictId] = ~0;
+				residentCount--;
+			}
+
+			auto task = HeightmapTextureLoadTask::buildTile(m_cacheHeader, m_cacheBin, tileId);
+			m_tiles[tileId].texture = task->texture;
+			GpuUploader::get()->addTask(task);
+			residentCount++;
+		}
+	}
+
+	bool LandscapeGPUProxy::setUUID(const UUID& in)
+	{
+		if (in == m_heightmapUUID)
+		{
+			return false;
+		}
+
+		m_heightmapUUID = in;
+
+		// Old textures retire when destroy.
+		m_tiles.clear();
+		m_pageTable.clear();
+		m_coarseTexture = nullptr;
+		m_cacheBin = nullptr;
+		m_quadtree = { };
+
+		m_cacheHeader = AssetRegistryManager::get()->getHeader<HeightmapAssetHeader>(m_heightmapUUID);
+		if (m_cacheHeader == nullptr)
+		{
+			if (!m_heightmapUUID.empty())
+			{
+				LOG_WARN("Heightmap asset {0} no exist, landscape skip render.", m_heightmapUUID);
+			}
+			return true;
+		}
+
+		m_cacheBin = std::dynamic_pointer_cast<HeightmapAssetBin>(m_cacheHeader->loadBinData());
+		CHECK(m_cacheBin != nullptr);
+
+		m_quadtree.build(m_cacheHeader->getWidth(), m_cacheHeader->getHeight(), m_cacheHeader->getChunkMinMax());
+		CHECK(m_quadtree.getLodCount() <= GMaxLandscapeLodCount);
+
+		m_tiles.resize(m_cacheHeader->getTileCount());
+		m_pageTable.resize(m_cacheHeader->getTileCount(), ~0);
+
+		auto coarseTask = HeightmapTextureLoadTask::buildCoarse(m_cacheHeader, m_cacheBin);
+		m_coarseTexture = coarseTask->texture;
+		GpuUploader::get()->addTask(coarseTask);
+
+		return true;
+	}
+
+	bool LandscapeGPUProxy::prepareRender(const GPUViewData& view, LandscapeRenderData& outData)
+	{
+		if (m_cacheHeader == nullptr || !m_coarseTexture->isReady())
+		{
+			return false;
+		}
+
+		auto transform = m_landscapeComp->getNode()->getTransform();
+		const glm::vec3 origin = glm::vec3(transform->getWorldMatrix()[3]);
+		const glm::vec3 originPrev = glm::vec3(transform->getPrevWorldMatrix()[3]);
+
+		LandscapeQuadtree::Config config = m_quadtree.getConfig();
+		config.origin = origin;
+		config.sampleSpacing = m_landscapeComp->m_sampleSpacing;
+		config.heightScale = m_landscapeComp->m_heightScale;
+		m_quadtree.setConfig(config);
+
+		const glm::vec3 camPos = glm::vec3(view.camWorldPos);
+		updateStreaming(camPos);
+
+		std::vector<LandscapeQuadtree::SelectedNode> selectedNodes;
+		m_quadtree.select(camPos, view.frustumPlanes, selectedNodes);
+
+		// Full nodes first, two draws with different grid.
+		std::stable_partition(selectedNodes.begin(), selectedNodes.end(), [](const auto& node)
+		{
+			return node.gridDim == LandscapeQuadtree::kGridDim;
+		});
+
+		outData.nodes.clear();
+		outData.nodes.reserve(selectedNodes.size());
+		outData.fullNodeCount = 0;
+		for (const auto& node : selectedNodes)
+		{
+			outData.nodes.push_back({ node.origin, node.size, node.lod });
+			outData.fullNodeCount += (node.gridDim == LandscapeQuadtree::kGridDim) ? 1 : 0;
+		}
+
+		auto& landscape = outData.landscape;
+		landscape = { };
+		landscape.origin = origin;
+		landscape.originPrev = originPrev;
+		landscape.sampleSpacing = config.sampleSpacing;
+		landscape.heightScale = config.heightScale;
+		landscape.width = m_cacheHeader->getWidth();
+		landscape.height = m_cacheHeader->getHeight();
+		landscape.tileSize = m_cacheHeader->getTileSize();
+		landscape.tileCountX = m_cacheHeader->getTileCountX();
+		landscape.tileCountY = m_cacheHeader->getTileCountY();
+		landscape.coarseTextureId = m_coarseTexture->getBindlessIndex();
+		landscape.coarseStep = m_cacheHeader->getCoarseStep();
+		landscape.coarseWidth = m_cacheHeader->getCoarseWidth();
+		landscape.coarseHeight = m_cacheHeader->getCoarseHeight();
+		landscape.heightDistance = m_quadtree.getHeightDistance(camPos);
+		for (uint32_t lod = 0; lod < m_quadtree.getLodCount(); lod++)
+		{
+			landscape.morphRanges[lod] = glm::vec4(m_quadtree.getMorphRange(lod), 0.0f, 0.0f);
+		}
+
+		outData.pageTable = &m_pageTable;
+		return true;
+	}
+
+	uint32_t LandscapeGPUProxy::getResidentTileCount() const
+	{
+		uint32_t count = 0;
+		for (const auto& tile : m_tiles)
+		{
+			count += (tile.texture && tile.texture->isReady()) ? 1 : 0;
+		}
+		return count;
+	}
+
+	LandscapeComponent::LandscapeComponent()
+	{
+		m_gpuProxy = std::make_unique<LandscapeGPUProxy>(this);
+	}
+
+	LandscapeComponent::LandscapeComponent(std::shared_ptr<SceneNode> sceneNode)
+		: Component(sceneNode)
+	{
+		m_gpuProxy = std::make_unique<LandscapeGPUProxy>(this);
+	}
+
+	LandscapeComponent::~LandscapeComponent()
+	{
+	}
+
+	void LandscapeComponent::setHeightmapUUID(const UUID& in)
+	{
+		if (m_gpuProxy->setUUID(in))
+		{
+			markDirty();
+		}
+	}
+
+	const std::string& LandscapeComponent::getHeightmapAssetName() const
+	{
+		static const std::string emptyName = "";
+		if (m_gpuProxy->m_cacheHeader)
+		{
+			return m_gpuProxy->m_cacheHeader->getName();
+		}
+
+		return emptyName;
+	}
+
+	bool LandscapeComponent::setSampleSpacing(float in)
+	{
+		in = glm::max(in, 0.01f);
+		if (m_sampleSpacing != in)
+		{
+			m_sampleSpacing = in;
+			markDirty();
+			return true;
+		}
+
+		return false;
+	}
+
+	bool LandscapeComponent::setHeightScale(float in)
+	{
+		in = glm::max(in, 0.0f);
+		if (m_heightScale != in)
+		{
+			m_heightScale = in;
+			markDirty();
+			return true;
+		}
+
+		return false;
+	}
+
 	void LandscapeComponent::tick(const RuntimeModuleTickData& tickData)
 	{
 
 	}
 }
-
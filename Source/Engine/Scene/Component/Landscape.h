@@ -1,22 +1,131 @@
 #pragma once
 #include "../Component.h"
+#include "../../Renderer/Parameters.h"
+#include "../../Renderer/LandscapeQuadtree.h"
 
 namespace Flower
 {
 	class SceneNode;
+	class LandscapeComponent;
+	class HeightmapAssetHeader;
+	class HeightmapAssetBin;
+	class GPUHeightmapTexture;
+
+	// Landscape draw data of one frame, see LandscapePass.
+	struct LandscapeRenderData
+	{
+		GPULandscapeData landscape;
+
+		// Full nodes store first, then quarter nodes.
+		std::vector<GPULandscapeNode> nodes;
+		uint32_t fullNodeCount = 0;
+
+		// Bindless index per tile, ~0 when tile no resident and use coarse heightfield.
+		const std::vector<uint32_t>* pageTable = nullptr;
+	};
+
+	// Landscape quadtree and streamed height tiles.
+	// Coarse heightfield always resident, tiles stream in and out by camera distance.
+	class LandscapeGPUProxy
+	{
+		friend LandscapeComponent;
+
+	public:
+		LandscapeGPUProxy(LandscapeComponent* in)
+			: m_landscapeComp(in)
+		{
+
+		}
+
+		~LandscapeGPUProxy() = default;
+
+	private:
+		struct Tile
+		{
+			std::shared_ptr<GPUHeightmapTexture> texture = nullptr;
+
+			// Camera distance of last update.
+			float distance = 0.0f;
+		};
+
+		LandscapeComponent* m_landscapeComp;
+
+		// Asset uuid.
+		UUID m_heightmapUUID = {};
+
+		std::shared_ptr<HeightmapAssetHeader> m_cacheHeader = nullptr;
+
+		// Tile upload source, keep while landscape alive.
+		std::shared_ptr<HeightmapAssetBin> m_cacheBin = nullptr;
+
+		LandscapeQuadtree m_quadtree;
+
+		std::shared_ptr<GPUHeightmapTexture> m_coarseTexture = nullptr;
+		std::vector<Tile> m_tiles;
+		std::vector<uint32_t> m_pageTable;
+
+	private:
+		void updateStreaming(const glm::vec3& camPos);
+
+	public:
+		bool setUUID(const UUID& in);
+
+		// Select nodes and update tile streaming, return false when no heightmap ready.
+		bool prepareRender(const GPUViewData& view, LandscapeRenderData& outData);
+
+		uint32_t getResidentTileCount() const;
+	};
+
 	class LandscapeComponent : public Component
 	{
+		friend LandscapeGPUProxy;
+		friend class SceneArchive;
+
+	private:
+		std::unique_ptr<LandscapeGPUProxy> m_gpuProxy = nullptr;
+
+		// World size of one quad.
+		float m_sampleSpacing = 1.0f;
+
+		// World height of max sample value.
+		float m_heightScale = 512.0f;
+
 	public:
-		LandscapeComponent() = default;
-		virtual ~LandscapeComponent() = default;
+		LandscapeComponent();
+		virtual ~LandscapeComponent();
 
-		LandscapeComponent(std::shared_ptr<SceneNode> sceneNode)
-			: Component(sceneNode)
+		LandscapeComponent(std::shared_ptr<SceneNode> sceneNode);
+
+		void setHeightmapUUID(const UUID& in);
+		const UUID& getHeightmapUUID() const
 		{
+			return m_gpuProxy->m_heightmapUUID;
+		}
+
+		bool isHeightmapAlreadySet() const
+		{
+			return !m_gpuProxy->m_heightmapUUID.empty();
+		}
 
+		// Empty when no heightmap set.
+		const std::string& getHeightmapAssetName() const;
+
+		float getSampleSpacing() const { return m_sampleSpacing; }
+		bool setSampleSpacing(float in);
+
+		float getHeightScale() const { return m_heightScale; }
+		bool setHeightScale(float in);
+
+		uint32_t getLodCount() const { return m_gpuProxy->m_quadtree.getLodCount(); }
+		uint32_t getTileCount() const { return uint32_t(m_gpuProxy->m_tiles.size()); }
+		uint32_t getResidentTileCount() const { return m_gpuProxy->getResidentTileCount(); }
+
+		bool prepareRender(const GPUViewData& view, LandscapeRenderData& outData)
+		{
+			return m_gpuProxy->prepareRender(view, outData);
 		}
 
 	public:
 		virtual void tick(const RuntimeModuleTickData& tickData) override;
 	};
-}
\ No newline at end of file
+}
@@ -53,4 +53,14 @@ namespace Flower
 
 		return glm::vec4(0.0f, -1.0f, 0.0f, 0.0f);
 	}
+
+	glm::vec3 LightComponent::getPosition() const
+	{
+		if (auto node = m_node.lock())
+		{
+			return glm::vec3(node->getTransform()->getWorldMatrix()[3]);
+		}
+
+		return glm::vec3(0.0f);
+	}
 }
\ No newline at end of file
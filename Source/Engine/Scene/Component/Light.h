@@ -5,6 +5,8 @@ namespace Flower
 {
 	class LightComponent : public Component
 	{
+		friend class SceneArchive;
+
 	public:
 		LightComponent() = default;
 		virtual ~LightComponent() = default;
@@ -35,5 +37,8 @@ namespace Flower
 		bool setColor(const glm::vec3& in);
 		bool setIntensity(float in);
 		glm::vec4 getDirection() const;
+
+		// Owner node world position.
+		glm::vec3 getPosition() const;
 	};
 }
\ No newline at end of file
@@ -0,0 +1,18 @@
+#include "Pch.h"
+#include "PointLight.h"
+
+namespace Flower
+{
+	bool PointLightComponent::setRange(float in)
+	{
+		in = glm::max(in, 0.01f);
+		if (m_range != in)
+		{
+			m_range = in;
+			markDirty();
+			return true;
+		}
+
+		return false;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,27 @@
+#pragma once
+#include "Light.h"
+
+namespace Flower
+{
+	class PointLightComponent : public LightComponent
+	{
+		friend class SceneArchive;
+
+	public:
+		PointLightComponent() = default;
+		virtual ~PointLightComponent() = default;
+
+		PointLightComponent(std::shared_ptr<SceneNode> sceneNode)
+			: LightComponent(sceneNode)
+		{
+
+		}
+
+		float getRange() const { return m_range; }
+		bool setRange(float in);
+
+	protected:
+		// Light influence distance, attenuation reach zero at range.
+		float m_range = 10.0f;
+	};
+}
\ No newline at end of file
@@ -1,7 +1,45 @@
 #include "Pch.h"
-#include "DirectionalLight.h"
+#include "SpotLight.h"
 
 namespace Flower
 {
+	bool SpotLightComponent::setRange(float in)
+	{
+		in = glm::max(in, 0.01f);
+		if (m_range != in)
+		{
+			m_range = in;
+			markDirty();
+			return true;
+		}
 
+		return false;
+	}
+
+	bool SpotLightComponent::setInnerConeAngle(float in)
+	{
+		in = glm::clamp(in, 0.0f, m_outerConeAngle);
+		if (m_innerConeAngle != in)
+		{
+			m_innerConeAngle = in;
+			markDirty();
+			return true;
+		}
+
+		return false;
+	}
+
+	bool SpotLightComponent::setOuterConeAngle(float in)
+	{
+		in = glm::clamp(in, glm::radians(1.0f), glm::radians(89.0f));
+		if (m_outerConeAngle != in)
+		{
+			m_outerConeAngle = in;
+			m_innerConeAngle = glm::min(m_innerConeAngle, m_outerConeAngle);
+			markDirty();
+			return true;
+		}
+
+		return false;
+	}
 }
\ No newline at end of file
@@ -5,6 +5,8 @@ namespace Flower
 {
 	class SpotLightComponent : public LightComponent
 	{
+		friend class SceneArchive;
+
 	public:
 		SpotLightComponent() = default;
 		virtual ~SpotLightComponent() = default;
@@ -15,7 +17,22 @@ namespace Flower
 
 		}
 
+		float getRange() const { return m_range; }
+		bool setRange(float in);
+
+		// Cone half angle in radians.
+		float getInnerConeAngle() const { return m_innerConeAngle; }
+		bool setInnerConeAngle(float in);
+
+		float getOuterConeAngle() const { return m_outerConeAngle; }
+		bool setOuterConeAngle(float in);
+
 	protected:
+		// Light influence distance, attenuation reach zero at range.
+		float m_range = 10.0f;
 
+		// Full intensity inside inner cone, fade to zero at outer cone.
+		float m_innerConeAngle = glm::radians(20.0f);
+		float m_outerConeAngle = glm::radians(30.0f);
 	};
 }
\ No newline at end of file
@@ -4,78 +4,160 @@
 #include "Scene/Scene.h"
 #include "../../MeshTool/MeshToolCommon.h"
 #include "../../AssetSystem/MeshManager.h"
+#include "../../AssetSystem/MaterialManager.h"
 
 namespace Flower
 {
-	void StaticMeshGPUProxy::updateObjectCollectInfo()
+	StaticMeshGPUProxy::~StaticMeshGPUProxy()
 	{
-		if (m_staticMeshUUID.empty())
+		releaseMaterials();
+	}
+
+	void StaticMeshGPUProxy::acquireMaterials()
+	{
+		releaseMaterials();
+		if (!m_cacheStaticAssetHeader)
 		{
-			// No set mesh, return.
 			return;
 		}
 
-		// Pre-return if no mesh replace and no mesh loading state change.
-		if (!m_bMeshReplace && m_bMeshReady)
+		const auto& submeshes = m_cacheStaticAssetHeader->getSubMeshes();
+		m_cachePerObjectMaterials.reserve(submeshes.size());
+		for (const auto& submesh : submeshes)
 		{
-			return;
+			auto material = MaterialManager::get()->getOrCreateStandardPBR(submesh.material);
+
+			// Submeshes may share material, only subscribe once.
+			const bool bSubscribed = std::any_of(m_materialSubscriptions.begin(), m_materialSubscriptions.end(),
+				[&](const auto& subscription) { return subscription.first == material; });
+			if (!bSubscribed)
+			{
+				DelegateHandle handle = material->onChanged.addLambda([this]() { m_bMaterialDirty = true; });
+				m_materialSubscriptions.push_back({ material, handle });
+			}
+
+			m_cachePerObjectMaterials.push_back(std::move(material));
 		}
+	}
 
-		// Update mesh loading state.
-		// If mesh replace, update proxys.
-		// If mesh loading state change, upadte proxy.
-		m_bMeshReady = m_cacheGPUMeshAsset->isAssetReady();
-		if (m_bMeshReplace || m_bMeshReady)
+	void StaticMeshGPUProxy::releaseMaterials()
+	{
+		for (auto& subscription : m_materialSubscriptions)
 		{
-			GPUMeshAsset* asset = m_cacheGPUMeshAsset->getReadyAsset();
-			m_cachePerObjectData.clear();
+			subscription.first->onChanged.remove(subscription.second);
+		}
+		m_materialSubscriptions.clear();
+		m_cachePerObjectMaterials.clear();
+		m_bMaterialDirty = false;
+	}
 
-			GPUPerObjectData object{};
-			object.verticesArrayId = asset->getVerticesBindlessIndex();
-			object.indicesArrayId = asset->getIndicesBindlessIndex();
-			object.material = GPUStaticMeshStandardPBRMaterial::buildDeafult();
+	void StaticMeshGPUProxy::updateMaterials()
+	{
+		if (m_cachePerObjectMaterials.size() == m_cachePerObjectData.size())
+		{
+			for (size_t i = 0; i < m_cachePerObjectData.size(); i++)
+			{
+				m_cachePerObjectData[i].material = m_cachePerObjectMaterials[i]->getGPUMaterial();
+			}
+		}
+		m_bMaterialDirty = false;
 
-			if (m_cacheStaticAssetHeader)
+		// Material is part of instance batch key.
+		if (m_staticMeshComp->isValid())
+		{
+			if (auto scene = m_staticMeshComp->getNode()->getScene())
 			{
-				const auto& submeshes = m_cacheStaticAssetHeader->getSubMeshes();
-				std::vector<std::shared_ptr<CPUStaticMeshStandardPBRMaterial>> tempCacheMaterials;
-				for (const auto& submesh : submeshes)
-				{
-					object.indexStartPosition = submesh.indexStartPosition;
-					object.indexCount = submesh.indexCount;
-					object.sphereBounds = glm::vec4(submesh.renderBounds.origin, submesh.renderBounds.radius);
-					object.extents = glm::vec4(submesh.renderBounds.extents, 1.0f);
+				scene->markComponentChange();
+			}
+		}
+	}
 
-					std::shared_ptr<CPUStaticMeshStandardPBRMaterial> cpuMaterials = 
-						std::make_shared<CPUStaticMeshStandardPBRMaterial>();
+	void StaticMeshGPUProxy::updateObjectCollectInfo()
+	{
+		if (m_staticMeshUUID.empty())
+		{
+			// No set mesh, return.
+			return;
+		}
 
-					m_bMeshReady &= cpuMaterials->buildWithMaterialUUID(submesh.material);
+		// Mesh loading state still poll, it is just one atomic load.
+		// Materials no poll, they mark dirty when texture ready event come.
+		if (m_bMeshReplace || !m_bMeshReady)
+		{
+			const bool bMeshReady = m_cacheGPUMeshAsset->isAssetReady();
+			const bool bMeshReadyChange = (bMeshReady != m_bMeshReady);
+			m_bMeshReady = bMeshReady;
 
-					object.material = cpuMaterials->buildGPU();
+			if (m_bMeshReplace || bMeshReadyChange)
+			{
+				GPUMeshAsset* asset = m_cacheGPUMeshAsset->getReadyAsset();
+				m_cachePerObjectData.clear();
 
-					m_cachePerObjectData.push_back(object);
-					tempCacheMaterials.push_back(cpuMaterials);
-				}
+				GPUPerObjectData object{};
+				object.verticesArrayId = asset->getVerticesBindlessIndex();
+				object.indicesArrayId = asset->getIndicesBindlessIndex();
 
-				if (m_bMeshReady)
+				if (m_cacheStaticAssetHeader)
 				{
-					m_cachePerObjectMaterials = tempCacheMaterials;
+					const auto& submeshes = m_cacheStaticAssetHeader->getSubMeshes();
+					m_cachePerObjectData.reserve(submeshes.size());
+					for (size_t i = 0; i < submeshes.size(); i++)
+					{
+						const auto& submesh = submeshes[i];
+
+						object.indexStartPosition = submesh.indexStartPosition;
+						object.indexCount = submesh.indexCount;
+
+						object.lodIndexStart = glm::uvec4(submesh.indexStartPosition, 0, 0, 0);
+						object.lodIndexCount = glm::uvec4(submesh.indexCount, 0, 0, 0);
+						object.lodError = glm::vec4(0.0f);
+						for (uint32_t lodId = 1; lodId <= submesh.lods.size() && lodId < GMaxStaticMeshLodCount; lodId++)
+						{
+							const auto& lod = submesh.lods[lodId - 1];
+							object.lodIndexStart[lodId] = lod.indexStartPosition;
+							object.lodIndexCount[lodId] = lod.indexCount;
+							object.lodError[lodId] = lod.error;
+						}
+
+						object.sphereBounds = glm::vec4(submesh.renderBounds.origin, submesh.renderBounds.radius);
+						object.extents = glm::vec4(submesh.renderBounds.extents, 1.0f);
+						object.material = m_cachePerObjectMaterials[i]->getGPUMaterial();
+
+						m_cachePerObjectData.push_back(object);
+					}
 				}
 				else
 				{
-					m_cachePerObjectMaterials.insert(m_cachePerObjectMaterials.end(), tempCacheMaterials.begin(), tempCacheMaterials.end());
+					object.material = GPUStaticMeshStandardPBRMaterial::buildDeafult();
+					object.indexStartPosition = 0;
+					object.indexCount = asset->getIndicesCount();
+					object.lodIndexStart = glm::uvec4(0);
+					object.lodIndexCount = glm::uvec4(object.indexCount, 0, 0, 0);
+					object.lodError = glm::vec4(0.0f);
+					object.sphereBounds = BuildInSphereBounds;
+					object.extents = BuildInExtent;
+					m_cachePerObjectData.push_back(object);
+				}
+
+				// Materials already newest.
+				m_bMaterialDirty = false;
+
+				// Submesh count or bounds change, scene bvh need rebuild.
+				if (m_staticMeshComp->isValid())
+				{
+					if (auto scene = m_staticMeshComp->getNode()->getScene())
+					{
+						scene->markComponentChange();
+					}
 				}
 			}
-			else
-			{
-				object.indexStartPosition = 0;
-				object.indexCount = asset->getIndicesCount();
-				object.sphereBounds = BuildInSphereBounds;
-				object.extents = BuildInExtent;
-				m_cachePerObjectData.push_back(object);
-			}
+			m_bMeshReplace = false;
+		}
+
+		if (m_bMaterialDirty)
+		{
+			updateMaterials();
 		}
-		m_bMeshReplace = false;
 	}
 
 	void StaticMeshGPUProxy::renderObjectCollect(std::vector<GPUPerObjectData>& collector)
@@ -101,11 +183,12 @@ namespace Flower
 
 			
 			// Asset header is optional.
-			m_cacheStaticAssetHeader = AssetRegistryManager::get()->getHeaderMap().contains(m_staticMeshUUID) ?
-				std::dynamic_pointer_cast<StaticMeshAssetHeader>(AssetRegistryManager::get()->getHeaderMap().at(m_staticMeshUUID)) :
-				nullptr;
+			m_cacheStaticAssetHeader = AssetRegistryManager::get()->getHeader<StaticMeshAssetHeader>(m_staticMeshUUID);
 		
 	
+			// Shared material instances, registry lookup only happen when material first create.
+			acquireMaterials();
+
 			// Get gpu asset.
 			m_cacheGPUMeshAsset = MeshManager::get()->getOrCreateLRUMesh(m_staticMeshUUID);
 			m_bMeshReplace = true;
@@ -162,6 +245,13 @@ namespace Flower
 		return uint32_t(m_gpuProxy->m_cachePerObjectData.size());
 	}
 
+	void StaticMeshComponent::getSubmeshBounds(uint32_t submesh, glm::vec3& outCenter, glm::vec3& outExtents) const
+	{
+		const auto& object = m_gpuProxy->m_cachePerObjectData.at(submesh);
+		outCenter = glm::vec3(object.sphereBounds);
+		outExtents = glm::vec3(object.extents);
+	}
+
 	const std::string& StaticMeshComponent::getMeshAssetName() const
 	{
 		static const std::string engineName = "EngineMesh";
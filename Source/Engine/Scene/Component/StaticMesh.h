@@ -10,6 +10,7 @@ namespace Flower
 	class GPUMeshAsset;
 	class StaticMeshGPUProxy;
 	class StaticMeshAssetHeader;
+	class StandardPBRMaterialInstance;
 
 	class StaticMeshGPUProxy
 	{
@@ -22,6 +23,8 @@ namespace Flower
 
 		}
 
+		~StaticMeshGPUProxy();
+
 	private:
 		StaticMeshComponent* m_staticMeshComp;
 
@@ -37,7 +40,15 @@ namespace Flower
 		std::shared_ptr<StaticMeshAssetHeader> m_cacheStaticAssetHeader = nullptr;
 		std::vector<GPUPerObjectData> m_cachePerObjectData;
 
-		std::vector<std::shared_ptr<CPUStaticMeshStandardPBRMaterial>> m_cachePerObjectMaterials;
+		// Shared material per submesh, set when material texture ready event come.
+		bool m_bMaterialDirty = false;
+		std::vector<std::shared_ptr<StandardPBRMaterialInstance>> m_cachePerObjectMaterials;
+		std::vector<std::pair<std::shared_ptr<StandardPBRMaterialInstance>, DelegateHandle>> m_materialSubscriptions;
+
+	private:
+		void acquireMaterials();
+		void releaseMaterials();
+		void updateMaterials();
 
 	public:
 		void updateObjectCollectInfo();
@@ -75,6 +86,15 @@ namespace Flower
 		uint32_t getIndicesCount() const;
 		uint32_t getSubmeshCount() const;
 
+		// Submesh local space box, sphere center and box extents.
+		void getSubmeshBounds(uint32_t submesh, glm::vec3& outCenter, glm::vec3& outExtents) const;
+
+		// Engine mesh no asset header, return nullptr.
+		std::shared_ptr<StaticMeshAssetHeader> getAssetHeader() const
+		{
+			return m_gpuProxy->m_cacheStaticAssetHeader;
+		}
+
 		const std::string& getMeshAssetName() const;
 
 	public:
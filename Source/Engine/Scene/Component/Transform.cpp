@@ -1,6 +1,7 @@
 #include "Pch.h"
 #include "Transform.h"
 #include "../SceneNode.h"
+#include "../Scene.h"
 #include "../Component.h"
 #include <glm/gtx/matrix_decompose.hpp>
 #include <glm/gtx/transform.hpp>
@@ -117,6 +118,13 @@ namespace Flower
 				m_worldMatrix = transform->getWorldMatrix() * m_worldMatrix;
 			}
 
+			// Scene bvh refit moved nodes only.
+			auto node = getNode();
+			if (auto scene = node->getScene())
+			{
+				scene->onWorldMatrixUpdate(node);
+			}
+
 			m_bUpdateFlag = !m_bUpdateFlag;
 		}
 	}
@@ -7,6 +7,8 @@ namespace Flower
 
 	class Transform : public Component
 	{
+		friend class SceneArchive;
+
 	public:
 		Transform() = default;
 		virtual ~Transform() = default;
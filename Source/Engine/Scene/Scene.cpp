@@ -1,10 +1,16 @@
 #include "Pch.h"
 #include "Scene.h"
 #include "SceneManager.h"
+#include "SceneBVH.h"
+#include "SceneArchive.h"
 #include "../Engine.h"
 
 namespace Flower
 {
+	static AutoCVarCmd cVarSceneBVHBenchmark("cmd.SceneBVH.Benchmark", "Build, refit and trace scene bvh on 100k synthetic instances, log timings.");
+	static AutoCVarCmd cVarSceneArchiveValidate("cmd.SceneArchive.Validate", "Save and load synthetic scene, check hierarchy, transform and component fields match.");
+	static AutoCVarCmd cVarSceneArchiveBenchmark("cmd.SceneArchive.Benchmark", "Save and load 100k nodes synthetic scene, log timings.");
+
 	size_t Scene::requireId()
 	{
 		CHECK(m_currentId < SIZE_MAX && "GUID max than size_t's max value.");
@@ -38,11 +44,48 @@ namespace Flower
 	bool Scene::init()
 	{
 		m_root = SceneNode::create(ROOT_ID, m_initName, shared_from_this());
+		m_bvh = std::make_unique<SceneBVH>();
 		return true;
 	}
 
+	SceneBVH* Scene::getBVH()
+	{
+		m_bvh->update(this, m_movedNodes, m_bMovedNodesOverflow);
+		m_movedNodes.clear();
+		m_bMovedNodesOverflow = false;
+		return m_bvh.get();
+	}
+
+	void Scene::onWorldMatrixUpdate(std::shared_ptr<SceneNode> node)
+	{
+		m_transformGeneration++;
+		if (node->getStatic())
+		{
+			m_staticTransformGeneration++;
+		}
+
+		if (m_bMovedNodesOverflow)
+		{
+			return;
+		}
+
+		// Keep list bounded when no one pick for long time.
+		if (m_movedNodes.size() >= m_nodeCount)
+		{
+			m_movedNodes.clear();
+			m_bMovedNodesOverflow = true;
+			return;
+		}
+		m_movedNodes.push_back(node);
+	}
+
 	bool Scene::setDirty(bool bDirty)
 	{
+		if (bDirty)
+		{
+			m_editGeneration++;
+		}
+
 		if (m_bDirty != bDirty)
 		{
 			m_bDirty = bDirty;
@@ -75,6 +118,21 @@ namespace Flower
 	{
 		m_lazyDestroyComponents.tick();
 
+		CVarCmdHandle(cVarSceneBVHBenchmark, []()
+		{
+			SceneBVH::benchmark(100000);
+		});
+
+		CVarCmdHandle(cVarSceneArchiveValidate, []()
+		{
+			SceneArchive::validate();
+		});
+
+		CVarCmdHandle(cVarSceneArchiveBenchmark, []()
+		{
+			SceneArchive::benchmark(100000);
+		});
+
 		// update all transforms.
 		loopNodeTopToDown([tickData](std::shared_ptr<SceneNode> node)
 		{
@@ -90,6 +148,7 @@ namespace Flower
 	void Scene::deleteNode(std::shared_ptr<SceneNode> node)
 	{
 		node->selfDelete();
+		markComponentChange();
 	}
 
 	std::shared_ptr<SceneNode> Scene::createNode(const std::string& name, std::shared_ptr<SceneNode> parent)
@@ -5,6 +5,7 @@
 #include "../Renderer/RendererCommon.h"
 #include "Component.h"
 #include "SceneNode.h"
+#include "SceneBVH.h"
 
 namespace Flower
 {
@@ -13,6 +14,7 @@ namespace Flower
 	class Scene : public std::enable_shared_from_this<Scene>
 	{
 		friend SceneNode;
+		friend class SceneArchive;
 	private:
 		SceneManager* m_manager = nullptr;
 
@@ -31,6 +33,9 @@ namespace Flower
 		// Is scene dirty?
 		bool m_bDirty = false;
 
+		// Increase when mark dirty, editor use it to know scene edit.
+		uint64_t m_editGeneration = 0;
+
 		// Cache scene components, no include transform.
 		std::unordered_map<const char*, std::vector<std::weak_ptr<Component>>> m_cacheSceneComponents;
 		std::unordered_map<const char*, bool> m_cacheSceneComponentsShrinkAlready;
@@ -39,6 +44,21 @@ namespace Flower
 
 		size_t m_nodeCount = 0;
 
+		// Static mesh bvh, sync when get.
+		std::unique_ptr<SceneBVH> m_bvh;
+
+		// Increase when component add, remove or component render data change, bvh rebuild on it.
+		uint64_t m_componentGeneration = 0;
+
+		// Increase when any node or static node world matrix update, render scene data re-collect on it.
+		uint64_t m_transformGeneration = 0;
+		uint64_t m_staticTransformGeneration = 0;
+
+		// Nodes world matrix update since last bvh sync, bvh only refit them.
+		// Overflow when more moves than nodes, bvh refit all instead.
+		std::vector<std::weak_ptr<SceneNode>> m_movedNodes;
+		bool m_bMovedNodesOverflow = false;
+
 	private:
 		// require guid of scene node in this scene.
 		size_t requireId();
@@ -62,6 +82,12 @@ namespace Flower
 		static std::shared_ptr<Scene> create(std::string name = "Untitled");
 
 		bool isDirty() const { return m_bDirty; }
+		uint64_t getEditGeneration() const { return m_editGeneration; }
+		uint64_t getComponentGeneration() const { return m_componentGeneration; }
+		void markComponentChange() { m_componentGeneration++; }
+		uint64_t getTransformGeneration() const { return m_transformGeneration; }
+		uint64_t getStaticTransformGeneration() const { return m_staticTransformGeneration; }
+		void onWorldMatrixUpdate(std::shared_ptr<SceneNode> node);
 		auto getptr() { return shared_from_this(); }
 		size_t getCurrentGUID() const { return m_currentId; }
 		size_t getNodeCount() const { return m_nodeCount; }
@@ -128,6 +154,9 @@ namespace Flower
 		// update whole graph's transform.
 		void flushSceneNodeTransform();
 
+		// Sync static mesh bvh with scene and return it, rebuild on component change, otherwise refit moved nodes.
+		SceneBVH* getBVH();
+
 		template<typename T>
 		void addComponent(std::shared_ptr<T> component, std::shared_ptr<SceneNode> node)
 		{
@@ -137,7 +166,8 @@ namespace Flower
 			{
 				node->setComponent(component);
 				m_cacheSceneComponents[typeid(T).name()].push_back(component);
-				m_bDirty = true;
+				markComponentChange();
+				setDirty();
 			}
 		}
 
@@ -162,6 +192,7 @@ namespace Flower
 				setDirty();
 				node->removeComponent(type);
 				m_cacheSceneComponentsShrinkAlready[type] = false;
+				markComponentChange();
 				return true;
 			}
 
@@ -0,0 +1,910 @@
+#include "Pch.h"
+#include "SceneArchive.h"
+#include "Scene.h"
+#include "SceneNode.h"
+#include "Component/StaticMesh.h"
+#include "Component/DirectionalLight.h"
+#include "Component/SpotLight.h"
+#include "Component/PointLight.h"
+#include "Component/Landscape.h"
+#include "Component/PMXComponent.h"
+#include "../Core/MappedFile.h"
+
+namespace Flower
+{
+	using namespace SceneFile;
+
+	namespace
+	{
+		constexpr uint64_t kSectionAlignment = 16;
+		constexpr uint32_t kParallelGrain = 256;
+
+		// Stride of current version record, save use it.
+		constexpr uint32_t kRecordStride[size_t(EComponentType::Max)] =
+		{
+			sizeof(StaticMeshRecord),
+			sizeof(DirectionalLightRecord),
+			sizeof(SpotLightRecord),
+			sizeof(LandscapeRecord),
+			sizeof(EmptyRecord),
+			sizeof(PointLightRecord),
+		};
+
+		// Smallest stride of all versions, load accept old record.
+		constexpr uint32_t kMinRecordStride[size_t(EComponentType::Max)] =
+		{
+			sizeof(StaticMeshRecord),
+			sizeof(DirectionalLightRecord),
+			sizeof(LightRecord), // Spot light, see SpotLightRecord.
+			sizeof(EmptyRecord), // Landscape, see LandscapeRecord.
+			sizeof(EmptyRecord),
+			sizeof(PointLightRecord),
+		};
+
+		inline uint64_t alignSection(uint64_t offset)
+		{
+			return (offset + kSectionAlignment - 1) & ~(kSectionAlignment - 1);
+		}
+
+		// Record may no align in file, copy out.
+		template<typename T>
+		inline T readRecord(const uint8_t* base, uint64_t stride, uint64_t index)
+		{
+			T result;
+			std::memcpy(&result, base + stride * index, sizeof(T));
+			return result;
+		}
+
+		inline void writeVec3(float* dest, const glm::vec3& v) { dest[0] = v.x; dest[1] = v.y; dest[2] = v.z; }
+		inline glm::vec3 readVec3(const float* src) { return glm::vec3(src[0], src[1], src[2]); }
+
+		inline std::vector<std::shared_ptr<SceneNode>> collectNodesPreOrder(Scene* scene)
+		{
+			std::vector<std::shared_ptr<SceneNode>> result;
+			result.reserve(scene->getNodeCount() + 1);
+
+			std::vector<std::shared_ptr<SceneNode>> stack = { scene->getRootNode() };
+			while (!stack.empty())
+			{
+				result.push_back(std::move(stack.back()));
+				stack.pop_back();
+
+				const auto& children = result.back()->getChildren();
+				for (auto it = children.rbegin(); it != children.rend(); ++it)
+				{
+					stack.push_back(*it);
+				}
+			}
+			return result;
+		}
+	}
+
+	template<typename T, typename Record, typename F>
+	std::vector<std::shared_ptr<T>> SceneArchive::loadComponentBlock(
+		Scene* scene,
+		const std::vector<std::shared_ptr<SceneNode>>& nodes,
+		const uint8_t* blockData,
+		const ComponentBlock& block,
+		F&& fill)
+	{
+		// Filter invalid and duplicate records first, so parallel build never touch same node twice.
+		std::vector<uint32_t> records;
+		records.reserve(block.count);
+		{
+			std::vector<uint8_t> bNodeUsed(nodes.size(), 0);
+			for (uint32_t i = 0; i < block.count; i++)
+			{
+				// All records start with owner node index.
+				const uint32_t node = readRecord<uint32_t>(blockData, block.stride, i);
+				if (node < nodes.size() && !bNodeUsed[node])
+				{
+					bNodeUsed[node] = 1;
+					records.push_back(i);
+				}
+			}
+		}
+
+		if (records.size() != block.count)
+		{
+			LOG_WARN("Scene component block {0} skip {1} invalid records.", block.type, block.count - records.size());
+		}
+
+		std::vector<std::shared_ptr<T>> components(records.size());
+		GThreadPool::get()->parallelFor(0, records.size(), [&](size_t begin, size_t end)
+		{
+			for (size_t i = begin; i < end; i++)
+			{
+				const Record record = readRecord<Record>(blockData, block.stride, records[i]);
+				const uint32_t node = readRecord<uint32_t>(blockData, block.stride, records[i]);
+
+				auto component = std::make_shared<T>();
+				fill(*component, record, i);
+
+				nodes[node]->setComponent(component);
+				components[i] = std::move(component);
+			}
+		}, kParallelGrain);
+
+		auto& cache = scene->m_cacheSceneComponents[typeid(T).name()];
+		cache.reserve(cache.size() + components.size());
+		cache.insert(cache.end(), components.begin(), components.end());
+		scene->markComponentChange();
+
+		return components;
+	}
+
+	bool SceneArchive::save(Scene* scene, const std::filesystem::path& path)
+	{
+		PROFILE_SCOPE("Scene Save");
+		CHECK(scene);
+
+		std::vector<Node> nodes;
+		std::vector<char> strings;
+		std::array<std::vector<uint8_t>, size_t(EComponentType::Max)> blockDatas;
+		std::array<uint32_t, size_t(EComponentType::Max)> blockCounts{};
+
+		nodes.reserve(scene->getNodeCount() + 1);
+
+		auto addString = [&](const std::string& str)
+		{
+			StringRef ref{ uint32_t(strings.size()), uint32_t(str.size()) };
+			strings.insert(strings.end(), str.begin(), str.end());
+			return ref;
+		};
+
+		auto addRecord = [&](EComponentType type, const auto& record)
+		{
+			// Block stride write from table, must match real record size.
+			CHECK(sizeof(record) == kRecordStride[size_t(type)]);
+
+			auto& data = blockDatas[size_t(type)];
+			const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&record);
+			data.insert(data.end(), bytes, bytes + sizeof(record));
+			blockCounts[size_t(type)]++;
+		};
+
+		auto fillLight = [](LightRecord& record, const LightComponent& light, uint32_t node)
+		{
+			record.node = node;
+			writeVec3(record.color, light.m_color);
+			record.intensity = light.m_intensity;
+			writeVec3(record.forward, light.m_forward);
+		};
+
+		std::unordered_map<const SceneNode*, uint32_t> nodeIndexMap;
+		nodeIndexMap.reserve(scene->getNodeCount() + 1);
+
+		// Iterative pre-order, deep hierarchy no stack overflow.
+		std::vector<std::shared_ptr<SceneNode>> stack = { scene->getRootNode() };
+		while (!stack.empty())
+		{
+			std::shared_ptr<SceneNode> node = std::move(stack.back());
+			stack.pop_back();
+
+			const uint32_t index = uint32_t(nodes.size());
+			nodeIndexMap[node.get()] = index;
+
+			Node record{};
+			{
+				auto parent = node->getParent();
+				record.parent = parent ? nodeIndexMap.at(parent.get()) : kInvalidIndex;
+				record.flags = (node->getVisibility() ? ENodeFlags_Visible : 0) | (node->getStatic() ? ENodeFlags_Static : 0);
+				record.name = addString(node->getName());
+
+				auto transform = node->getTransform();
+				writeVec3(record.translation, transform->m_translation);
+				record.rotation[0] = transform->m_rotation.x;
+				record.rotation[1] = transform->m_rotation.y;
+				record.rotation[2] = transform->m_rotation.z;
+				record.rotation[3] = transform->m_rotation.w;
+				writeVec3(record.scale, transform->m_scale);
+			}
+			nodes.push_back(record);
+
+			if (auto mesh = node->getComponent<StaticMeshComponent>(); mesh && mesh->isMeshAlreadySet())
+			{
+				addRecord(EComponentType::StaticMesh, StaticMeshRecord{ index, addString(mesh->getUUID()) });
+			}
+
+			if (auto light = node->getComponent<DirectionalLightComponent>())
+			{
+				DirectionalLightRecord lightRecord{};
+				fillLight(lightRecord.light, *light, index);
+				lightRecord.perCascadeDimXY = light->m_percascadeDimXY;
+				lightRecord.cascadeCount = light->m_cascadeCount;
+				lightRecord.shadowFilterSize = light->m_shadowFilterSize;
+				lightRecord.maxFilterSize = light->m_maxFilterSize;
+				lightRecord.cascadeSplitLambda = light->m_cascadeSplitLambda;
+				lightRecord.shadowBiasConst = light->m_shadowBiasConst;
+				lightRecord.shadowBiasSlope = light->m_shadowBiasSlope;
+				lightRecord.cascadeBorderAdopt = light->m_cascadeBorderAdopt;
+				lightRecord.cascadeEdgeLerpThreshold = light->m_cascadeEdgeLerpThreshold;
+				lightRecord.maxDrawDepthDistance = light->m_maxDrawDepthDistance;
+				addRecord(EComponentType::DirectionalLight, lightRecord);
+			}
+
+			if (auto light = node->getComponent<SpotLightComponent>())
+			{
+				SpotLightRecord lightRecord{};
+				fillLight(lightRecord.light, *light, index);
+				lightRecord.range = light->m_range;
+				lightRecord.innerConeAngle = light->m_innerConeAngle;
+				lightRecord.outerConeAngle = light->m_outerConeAngle;
+				addRecord(EComponentType::SpotLight, lightRecord);
+			}
+
+			if (auto light = node->getComponent<PointLightComponent>())
+			{
+				PointLightRecord lightRecord{};
+				fillLight(lightRecord.light, *light, index);
+				lightRecord.range = light->m_range;
+				addRecord(EComponentType::PointLight, lightRecord);
+			}
+
+			if (auto landscape = node->getComponent<LandscapeComponent>())
+			{
+				LandscapeRecord landscapeRecord{};
+				landscapeRecord.node = index;
+				landscapeRecord.heightmapUUID = addString(landscape->getHeightmapUUID());
+				landscapeRecord.sampleSpacing = landscape->m_sampleSpacing;
+				landscapeRecord.heightScale = landscape->m_heightScale;
+				addRecord(EComponentType::Landscape, landscapeRecord);
+			}
+
+			if (node->hasComponent<PMXComponent>())
+			{
+				addRecord(EComponentType::PMX, EmptyRecord{ index });
+			}
+
+			// Reverse push keep children order.
+			const auto& children = node->getChildren();
+			for (auto it = children.rbegin(); it != children.rend(); ++it)
+			{
+				stack.push_back(*it);
+			}
+		}
+
+		std::vector<ComponentBlock> blocks;
+		for (uint32_t type = 0; type < uint32_t(EComponentType::Max); type++)
+		{
+			if (blockCounts[type] > 0)
+			{
+				blocks.push_back({ type, blockCounts[type], kRecordStride[type], 0, 0 });
+			}
+		}
+
+		// Layout: header | nodes | block table | block datas | strings.
+		Header header{};
+		header.magic = kMagic;
+		header.version = kVersion;
+		header.nodeCount = uint32_t(nodes.size());
+		header.componentBlockCount = uint32_t(blocks.size());
+		header.nodeOffset = alignSection(sizeof(Header));
+		header.componentBlockOffset = alignSection(header.nodeOffset + nodes.size() * sizeof(Node));
+
+		uint64_t offset = alignSection(header.componentBlockOffset + blocks.size() * sizeof(ComponentBlock));
+		for (auto& block : blocks)
+		{
+			block.offset = offset;
+			offset = alignSection(offset + blockDatas[block.type].size());
+		}
+		header.stringOffset = offset;
+		header.stringSize = strings.size();
+
+		std::vector<uint8_t> fileData(header.stringOffset + header.stringSize, 0);
+		auto writeBytes = [&](uint64_t dest, const void* src, size_t size)
+		{
+			if (size > 0)
+			{
+				std::memcpy(fileData.data() + dest, src, size);
+			}
+		};
+
+		writeBytes(0, &header, sizeof(Header));
+		writeBytes(header.nodeOffset, nodes.data(), nodes.size() * sizeof(Node));
+		writeBytes(header.componentBlockOffset, blocks.data(), blocks.size() * sizeof(ComponentBlock));
+		for (const auto& block : blocks)
+		{
+			writeBytes(block.offset, blockDatas[block.type].data(), blockDatas[block.type].size());
+		}
+		writeBytes(header.stringOffset, strings.data(), strings.size());
+
+		std::ofstream os(path, std::ios::binary | std::ios::trunc);
+		if (!os.is_open())
+		{
+			LOG_ERROR("Can't open scene file {0} to save.", path.string());
+			return false;
+		}
+		os.write(reinterpret_cast<const char*>(fileData.data()), std::streamsize(fileData.size()));
+		if (!os)
+		{
+			LOG_ERROR("Write scene file {0} fail.", path.string());
+			return false;
+		}
+
+		LOG_INFO("Save scene {0} with {1} nodes to {2}.", scene->getName(), nodes.size(), path.string());
+		return true;
+	}
+
+	std::shared_ptr<Scene> SceneArchive::load(const std::filesystem::path& path)
+	{
+		PROFILE_SCOPE("Scene Load");
+
+		MappedFile file;
+		if (!file.open(path))
+		{
+			return nullptr;
+		}
+
+		const uint8_t* data = file.data();
+		const uint64_t fileSize = file.size();
+
+		auto inRange = [&](uint64_t offset, uint64_t size)
+		{
+			return offset <= fileSize && size <= fileSize - offset;
+		};
+
+		if (!inRange(0, sizeof(Header)))
+		{
+			LOG_ERROR("Scene file {0} too small.", path.string());
+			return nullptr;
+		}
+
+		const Header header = readRecord<Header>(data, 0, 0);
+		if (header.magic != kMagic)
+		{
+			LOG_ERROR("Scene file {0} magic number invalid.", path.string());
+			return nullptr;
+		}
+		if (header.version > kVersion)
+		{
+			LOG_ERROR("Scene file {0} version {1} is newer than engine support version {2}.", path.string(), header.version, kVersion);
+			return nullptr;
+		}
+		if (header.nodeCount == 0
+			|| !inRange(header.nodeOffset, uint64_t(header.nodeCount) * sizeof(Node))
+			|| !inRange(header.componentBlockOffset, uint64_t(header.componentBlockCount) * sizeof(ComponentBlock))
+			|| !inRange(header.stringOffset, header.stringSize))
+		{
+			LOG_ERROR("Scene file {0} section out of range, file maybe broken.", path.string());
+			return nullptr;
+		}
+
+		const uint8_t* nodeData = data + header.nodeOffset;
+		const char* stringData = reinterpret_cast<const char*>(data + header.stringOffset);
+		auto getString = [&](const StringRef& ref)
+		{
+			if (uint64_t(ref.offset) + ref.size > header.stringSize)
+			{
+				return std::string();
+			}
+			return std::string(stringData + ref.offset, ref.size);
+		};
+
+		// Validate hierarchy: root first, parent always before child.
+		const uint32_t nodeCount = header.nodeCount;
+		std::vector<uint32_t> parents(nodeCount);
+		std::vector<uint32_t> childCounts(nodeCount, 0);
+		for (uint32_t i = 0; i < nodeCount; i++)
+		{
+			parents[i] = readRecord<Node>(nodeData, sizeof(Node), i).parent;
+
+			const bool bValid = (i == 0) ? (parents[i] == kInvalidIndex) : (parents[i] < i);
+			if (!bValid)
+			{
+				LOG_ERROR("Scene file {0} node {1} has invalid parent, file maybe broken.", path.string(), i);
+				return nullptr;
+			}
+
+			if (i > 0)
+			{
+				childCounts[parents[i]]++;
+			}
+		}
+
+		auto scene = Scene::create(getString(readRecord<Node>(nodeData, sizeof(Node), 0).name));
+		scene->init();
+
+		std::vector<std::shared_ptr<SceneNode>> sceneNodes(nodeCount);
+		sceneNodes[0] = scene->m_root;
+
+		// Reserve guid range once.
+		const size_t idBase = scene->m_currentId;
+		scene->m_currentId += nodeCount - 1;
+		scene->m_nodeCount += nodeCount - 1;
+
+		auto applyNode = [&](SceneNode& node, const Node& record)
+		{
+			node.m_bVisibility = (record.flags & ENodeFlags_Visible) != 0;
+			node.m_bStatic = (record.flags & ENodeFlags_Static) != 0;
+
+			auto transform = node.getTransform();
+			transform->m_translation = readVec3(record.translation);
+			transform->m_rotation = glm::quat(record.rotation[3], record.rotation[0], record.rotation[1], record.rotation[2]);
+			transform->m_scale = readVec3(record.scale);
+		};
+
+		// Nodes are independent before link, construct in parallel.
+		applyNode(*sceneNodes[0], readRecord<Node>(nodeData, sizeof(Node), 0));
+		GThreadPool::get()->parallelFor(1, nodeCount, [&](size_t begin, size_t end)
+		{
+			for (size_t i = begin; i < end; i++)
+			{
+				const Node record = readRecord<Node>(nodeData, sizeof(Node), i);
+
+				auto node = SceneNode::create(idBase + i, getString(record.name), scene, true);
+				applyNode(*node, record);
+				sceneNodes[i] = std::move(node);
+			}
+		}, kParallelGrain);
+
+		// Link hierarchy, parent already linked because of pre-order.
+		for (uint32_t i = 0; i < nodeCount; i++)
+		{
+			sceneNodes[i]->m_children.reserve(childCounts[i]);
+		}
+		for (uint32_t i = 1; i < nodeCount; i++)
+		{
+			auto& node = sceneNodes[i];
+			auto& parent = sceneNodes[parents[i]];
+
+			node->m_parent = parent;
+			node->m_depth = parent->m_depth + 1;
+			parent->m_children.push_back(node);
+		}
+
+		// Components.
+		auto readLight = [](LightComponent& light, const LightRecord& record)
+		{
+			light.m_color = readVec3(record.color);
+			light.m_intensity = record.intensity;
+			light.m_forward = readVec3(record.forward);
+		};
+
+		std::vector<std::shared_ptr<StaticMeshComponent>> meshComponents;
+		std::vector<UUID> meshUUIDs;
+
+		std::vector<std::shared_ptr<LandscapeComponent>> landscapeComponents;
+		std::vector<UUID> heightmapUUIDs;
+
+		const uint8_t* blockTable = data + header.componentBlockOffset;
+		for (uint32_t blockIndex = 0; blockIndex < header.componentBlockCount; blockIndex++)
+		{
+			const ComponentBlock block = readRecord<ComponentBlock>(blockTable, sizeof(ComponentBlock), blockIndex);
+			if (block.type >= uint32_t(EComponentType::Max))
+			{
+				LOG_WARN("Scene file {0} has unknown component type {1}, skip.", path.string(), block.type);
+				continue;
+			}
+
+			// Larger stride mean newer file append fields, read known prefix only.
+			if (block.stride < kMinRecordStride[block.type] || !inRange(block.offset, uint64_t(block.count) * block.stride))
+			{
+				LOG_WARN("Scene file {0} component block {1} invalid, skip.", path.string(), blockIndex);
+				continue;
+			}
+
+			const uint8_t* blockData = data + block.offset;
+			switch (EComponentType(block.type))
+			{
+			case EComponentType::StaticMesh:
+			{
+				meshUUIDs.resize(meshUUIDs.size() + block.count);
+				const size_t uuidBase = meshComponents.size();
+				auto components = loadComponentBlock<StaticMeshComponent, StaticMeshRecord>(scene.get(), sceneNodes, blockData, block,
+					[&](StaticMeshComponent&, const StaticMeshRecord& record, size_t i)
+					{
+						meshUUIDs[uuidBase + i] = getString(record.meshUUID);
+					});
+				meshComponents.insert(meshComponents.end(), components.begin(), components.end());
+				meshUUIDs.resize(meshComponents.size());
+			}
+			break;
+			case EComponentType::DirectionalLight:
+			{
+				loadComponentBlock<DirectionalLightComponent, DirectionalLightRecord>(scene.get(), sceneNodes, blockData, block,
+					[&](DirectionalLightComponent& light, const DirectionalLightRecord& record, size_t)
+					{
+						readLight(light, record.light);
+						light.m_percascadeDimXY = record.perCascadeDimXY;
+						light.m_cascadeCount = record.cascadeCount;
+						light.m_shadowFilterSize = record.shadowFilterSize;
+						light.m_maxFilterSize = record.maxFilterSize;
+						light.m_cascadeSplitLambda = record.cascadeSplitLambda;
+						light.m_shadowBiasConst = record.shadowBiasConst;
+						light.m_shadowBiasSlope = record.shadowBiasSlope;
+						light.m_cascadeBorderAdopt = record.cascadeBorderAdopt;
+						light.m_cascadeEdgeLerpThreshold = record.cascadeEdgeLerpThreshold;
+						light.m_maxDrawDepthDistance = record.maxDrawDepthDistance;
+					});
+			}
+			break;
+			case EComponentType::SpotLight:
+			{
+				if (block.stride >= sizeof(SpotLightRecord))
+				{
+					loadComponentBlock<SpotLightComponent, SpotLightRecord>(scene.get(), sceneNodes, blockData, block,
+						[&](SpotLightComponent& light, const SpotLightRecord& record, size_t)
+						{
+							readLight(light, record.light);
+							light.m_range = record.range;
+							light.m_innerConeAngle = record.innerConeAngle;
+							light.m_outerConeAngle = record.outerConeAngle;
+						});
+				}
+				else
+				{
+					loadComponentBlock<SpotLightComponent, LightRecord>(scene.get(), sceneNodes, blockData, block,
+						[&](SpotLightComponent& light, const LightRecord& record, size_t)
+						{
+							readLight(light, record);
+						});
+				}
+			}
+			break;
+			case EComponentType::PointLight:
+			{
+				loadComponentBlock<PointLightComponent, PointLightRecord>(scene.get(), sceneNodes, blockData, block,
+					[&](PointLightComponent& light, const PointLightRecord& record, size_t)
+					{
+						readLight(light, record.light);
+						light.m_range = record.range;
+					});
+			}
+			break;
+			case EComponentType::Landscape:
+			{
+				if (block.stride >= sizeof(LandscapeRecord))
+				{
+					heightmapUUIDs.resize(heightmapUUIDs.size() + block.count);
+					const size_t uuidBase = landscapeComponents.size();
+					auto components = loadComponentBlock<LandscapeComponent, LandscapeRecord>(scene.get(), sceneNodes, blockData, block,
+						[&](LandscapeComponent& landscape, const LandscapeRecord& record, size_t i)
+						{
+							heightmapUUIDs[uuidBase + i] = getString(record.heightmapUUID);
+							landscape.m_sampleSpacing = record.sampleSpacing;
+							landscape.m_heightScale = record.heightScale;
+						});
+					landscapeComponents.insert(landscapeComponents.end(), components.begin(), components.end());
+					heightmapUUIDs.resize(landscapeComponents.size());
+				}
+				else
+				{
+					loadComponentBlock<LandscapeComponent, EmptyRecord>(scene.get(), sceneNodes, blockData, block,
+						[](LandscapeComponent&, const EmptyRecord&, size_t) { });
+				}
+			}
+			break;
+			case EComponentType::PMX:
+			{
+				loadComponentBlock<PMXComponent, EmptyRecord>(scene.get(), sceneNodes, blockData, block,
+					[](PMXComponent&, const EmptyRecord&, size_t) { });
+			}
+			break;
+			default: CHECK_ENTRY();
+			}
+		}
+
+		// Mesh asset request touch asset managers, keep on calling thread.
+		for (size_t i = 0; i < meshComponents.size(); i++)
+		{
+			if (!meshUUIDs[i].empty())
+			{
+				meshComponents[i]->setMeshUUID(meshUUIDs[i]);
+			}
+		}
+		for (size_t i = 0; i < landscapeComponents.size(); i++)
+		{
+			if (!heightmapUUIDs[i].empty())
+			{
+				landscapeComponents[i]->setHeightmapUUID(heightmapUUIDs[i]);
+			}
+		}
+
+		// Pre-order, parent world matrix always ready before child.
+		for (auto& node : sceneNodes)
+		{
+			node->getTransform()->updateWorldTransform();
+		}
+
+		scene->setDirty(false);
+
+		LOG_INFO("Load scene {0} with {1} nodes from {2}.", scene->getName(), nodeCount, path.string());
+		return scene;
+	}
+
+	std::shared_ptr<Scene> SceneArchive::buildSyntheticScene(uint32_t nodeCount, uint32_t seed)
+	{
+		std::mt19937 rng(seed);
+		std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+		auto randomVec3 = [&](float scale) { return (glm::vec3(unit(rng), unit(rng), unit(rng)) - 0.5f) * scale; };
+
+		auto scene = Scene::create("SyntheticScene");
+		scene->init();
+
+		std::vector<std::shared_ptr<SceneNode>> nodes = { scene->getRootNode() };
+		nodes.reserve(nodeCount);
+		for (uint32_t i = 1; i < nodeCount; i++)
+		{
+			// Mostly random parent, some recent parent make deeper chain.
+			const uint32_t parentRange = std::min(i, 8u);
+			auto parent = (rng() % 4 == 0) ? nodes[i - 1 - rng() % parentRange] : nodes[rng() % i];
+
+			auto node = scene->createNode("Node_" + std::to_string(i), parent);
+			node->m_bVisibility = (rng() % 8) != 0;
+			node->m_bStatic = (rng() % 2) != 0;
+
+			auto transform = node->getTransform();
+			transform->setTranslation(randomVec3(200.0f));
+			transform->setRotation(glm::normalize(glm::quat(unit(rng), unit(rng) - 0.5f, unit(rng) - 0.5f, unit(rng) - 0.5f)));
+			transform->setScale(glm::vec3(0.5f) + glm::vec3(unit(rng), unit(rng), unit(rng)));
+
+			auto fillLight = [&](LightComponent& light)
+			{
+				light.m_color = glm::vec3(unit(rng), unit(rng), unit(rng));
+				light.m_intensity = unit(rng) * 100.0f;
+				light.m_forward = glm::normalize(randomVec3(2.0f) + glm::vec3(0.0f, -1.0f, 0.0f));
+			};
+
+			switch (rng() % 8)
+			{
+			case 0:
+			{
+				auto light = std::make_shared<SpotLightComponent>();
+				fillLight(*light);
+				light->m_range = 1.0f + unit(rng) * 50.0f;
+				light->m_innerConeAngle = glm::radians(5.0f + unit(rng) * 20.0f);
+				light->m_outerConeAngle = light->m_innerConeAngle + glm::radians(unit(rng) * 20.0f);
+				scene->addComponent(light, node);
+			}
+			break;
+			case 1:
+			{
+				auto light = std::make_shared<PointLightComponent>();
+				fillLight(*light);
+				light->m_range = 1.0f + unit(rng) * 50.0f;
+				scene->addComponent(light, node);
+			}
+			break;
+			case 2:
+			{
+				auto landscape = std::make_shared<LandscapeComponent>();
+				landscape->m_sampleSpacing = 0.5f + unit(rng) * 4.0f;
+				landscape->m_heightScale = 64.0f + unit(rng) * 1024.0f;
+				scene->addComponent(landscape, node);
+			}
+			break;
+			case 3:
+			{
+				scene->addComponent(std::make_shared<PMXComponent>(), node);
+			}
+			break;
+			default: break;
+			}
+
+			nodes.push_back(std::move(node));
+		}
+
+		// One sun.
+		{
+			auto light = std::make_shared<DirectionalLightComponent>();
+			light->m_forward = glm::normalize(glm::vec3(0.3f, -1.0f, 0.2f));
+			light->m_percascadeDimXY = 1024;
+			light->m_cascadeCount = 3;
+			light->m_shadowFilterSize = 0.75f;
+			light->m_maxFilterSize = 2.0f;
+			light->m_cascadeSplitLambda = 0.9f;
+			light->m_shadowBiasConst = -1.5f;
+			light->m_shadowBiasSlope = -2.0f;
+			light->m_cascadeBorderAdopt = 0.01f;
+			light->m_cascadeEdgeLerpThreshold = 0.7f;
+			light->m_maxDrawDepthDistance = 300.0f;
+			scene->addComponent(light, scene->createNode("Sun"));
+		}
+
+		scene->flushSceneNodeTransform();
+		return scene;
+	}
+
+	bool SceneArchive::validate()
+	{
+		const auto path = std::filesystem::temp_directory_path() / (std::string("FlowerSceneArchiveValidate") + kFileExtension);
+
+		auto source = buildSyntheticScene(4096, 1234u);
+		std::shared_ptr<Scene> loaded = save(source.get(), path) ? load(path) : nullptr;
+
+		// Truncated file must reject, no crash.
+		bool bRejectTruncated = false;
+		if (loaded)
+		{
+			const auto fileSize = std::filesystem::file_size(path);
+			std::filesystem::resize_file(path, fileSize / 2);
+			bRejectTruncated = (load(path) == nullptr);
+		}
+
+		std::error_code ec;
+		std::filesystem::remove(path, ec);
+
+		if (!loaded)
+		{
+			LOG_ERROR("SceneArchive validate: round trip save or load fail.");
+			return false;
+		}
+
+		ValidateReport report("SceneArchive");
+		auto check = [&](bool bCondition, const char* what, size_t node)
+		{
+			report.expect(bCondition, "node " + std::to_string(node) + " " + what + " mismatch");
+		};
+
+		check(bRejectTruncated, "truncated file accept", 0);
+		check(!loaded->isDirty(), "dirty flag", 0);
+		check(loaded->getNodeCount() == source->getNodeCount(), "scene node count", 0);
+
+		const auto sourceNodes = collectNodesPreOrder(source.get());
+		const auto loadedNodes = collectNodesPreOrder(loaded.get());
+		if (sourceNodes.size() != loadedNodes.size())
+		{
+			LOG_ERROR("SceneArchive validate: node count {0} after load, expect {1}.", loadedNodes.size(), sourceNodes.size());
+			return false;
+		}
+
+		std::unordered_map<const SceneNode*, size_t> sourceIndices;
+		std::unordered_map<const SceneNode*, size_t> loadedIndices;
+		for (size_t i = 0; i < sourceNodes.size(); i++)
+		{
+			sourceIndices[sourceNodes[i].get()] = i;
+			loadedIndices[loadedNodes[i].get()] = i;
+		}
+
+		auto parentIndex = [](const auto& indices, const std::shared_ptr<SceneNode>& node)
+		{
+			auto parent = node->getParent();
+			return parent ? indices.at(parent.get()) : size_t(kInvalidIndex);
+		};
+
+		auto sameLight = [](const LightComponent& a, const LightComponent& b)
+		{
+			return a.m_color == b.m_color && a.m_intensity == b.m_intensity && a.m_forward == b.m_forward;
+		};
+
+		size_t componentCount = 0;
+		for (size_t i = 0; i < sourceNodes.size(); i++)
+		{
+			const auto& a = sourceNodes[i];
+			const auto& b = loadedNodes[i];
+
+			check(a->getName() == b->getName(), "name", i);
+			check(parentIndex(sourceIndices, a) == parentIndex(loadedIndices, b), "parent", i);
+			check(a->getChildren().size() == b->getChildren().size(), "child count", i);
+			check(a->getDepth() == b->getDepth(), "depth", i);
+			check(a->getVisibility() == b->getVisibility() && a->getStatic() == b->getStatic(), "flags", i);
+
+			auto ta = a->getTransform();
+			auto tb = b->getTransform();
+			check(ta->m_translation == tb->m_translation && ta->m_rotation == tb->m_rotation && ta->m_scale == tb->m_scale, "transform", i);
+			check(ta->getWorldMatrix() == tb->getWorldMatrix(), "world matrix", i);
+
+			{
+				auto la = a->getComponent<SpotLightComponent>();
+				auto lb = b->getComponent<SpotLightComponent>();
+				check(bool(la) == bool(lb), "spot light", i);
+				if (la && lb)
+				{
+					check(sameLight(*la, *lb) && la->m_range == lb->m_range
+						&& la->m_innerConeAngle == lb->m_innerConeAngle && la->m_outerConeAngle == lb->m_outerConeAngle, "spot light field", i);
+					componentCount++;
+				}
+			}
+			{
+				auto la = a->getComponent<PointLightComponent>();
+				auto lb = b->getComponent<PointLightComponent>();
+				check(bool(la) == bool(lb), "point light", i);
+				if (la && lb)
+				{
+					check(sameLight(*la, *lb) && la->m_range == lb->m_range, "point light field", i);
+					componentCount++;
+				}
+			}
+			{
+				auto la = a->getComponent<DirectionalLightComponent>();
+				auto lb = b->getComponent<DirectionalLightComponent>();
+				check(bool(la) == bool(lb), "directional light", i);
+				if (la && lb)
+				{
+					check(sameLight(*la, *lb)
+						&& la->m_percascadeDimXY == lb->m_percascadeDimXY
+						&& la->m_cascadeCount == lb->m_cascadeCount
+						&& la->m_shadowFilterSize == lb->m_shadowFilterSize
+						&& la->m_maxFilterSize == lb->m_maxFilterSize
+						&& la->m_cascadeSplitLambda == lb->m_cascadeSplitLambda
+						&& la->m_shadowBiasConst == lb->m_shadowBiasConst
+						&& la->m_shadowBiasSlope == lb->m_shadowBiasSlope
+						&& la->m_cascadeBorderAdopt == lb->m_cascadeBorderAdopt
+						&& la->m_cascadeEdgeLerpThreshold == lb->m_cascadeEdgeLerpThreshold
+						&& la->m_maxDrawDepthDistance == lb->m_maxDrawDepthDistance, "directional light field", i);
+					componentCount++;
+				}
+			}
+			{
+				auto la = a->getComponent<LandscapeComponent>();
+				auto lb = b->getComponent<LandscapeComponent>();
+				check(bool(la) == bool(lb), "landscape", i);
+				if (la && lb)
+				{
+					check(la->m_sampleSpacing == lb->m_sampleSpacing && la->m_heightScale == lb->m_heightScale
+						&& la->getHeightmapUUID() == lb->getHeightmapUUID(), "landscape field", i);
+					componentCount++;
+				}
+			}
+			{
+				check(a->hasComponent<PMXComponent>() == b->hasComponent<PMXComponent>(), "pmx", i);
+				componentCount += b->hasComponent<PMXComponent>() ? 1 : 0;
+			}
+		}
+
+		// Scene component cache feed renderer collect, must match node components.
+		check(loaded->getComponents<SpotLightComponent>().size() == source->getComponents<SpotLightComponent>().size(), "spot light cache", 0);
+		check(loaded->getComponents<PointLightComponent>().size() == source->getComponents<PointLightComponent>().size(), "point light cache", 0);
+		check(loaded->getComponents<LandscapeComponent>().size() == source->getComponents<LandscapeComponent>().size(), "landscape cache", 0);
+		check(loaded->getComponents<PMXComponent>().size() == source->getComponents<PMXComponent>().size(), "pmx cache", 0);
+
+		LOG_INFO("SceneArchive validate: {0} nodes and {1} components round trip, {2} mismatch.", sourceNodes.size(), componentCount, report.getErrorCount());
+		return report.finish();
+	}
+
+	void SceneArchive::benchmark(uint32_t nodeCount)
+	{
+		using Clock = std::chrono::high_resolution_clock;
+		auto elapsedMs = [](Clock::time_point start)
+		{
+			return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+		};
+
+		const auto path = std::filesystem::temp_directory_path() / (std::string("FlowerSceneArchiveBenchmark") + kFileExtension);
+
+		auto buildStart = Clock::now();
+		auto source = buildSyntheticScene(nodeCount, 5678u);
+		const double buildMs = elapsedMs(buildStart);
+
+		auto saveStart = Clock::now();
+		const bool bSaved = save(source.get(), path);
+		const double saveMs = elapsedMs(saveStart);
+		if (!bSaved)
+		{
+			LOG_ERROR("SceneArchive benchmark: save fail.");
+			return;
+		}
+		const auto fileSize = std::filesystem::file_size(path);
+		source = nullptr;
+
+		// First load warm file cache, keep best of rest.
+		constexpr uint32_t kLoadCount = 4;
+		double bestLoadMs = std::numeric_limits<double>::max();
+		size_t loadedNodeCount = 0;
+		for (uint32_t i = 0; i < kLoadCount; i++)
+		{
+			auto loadStart = Clock::now();
+			auto loaded = load(path);
+			const double loadMs = elapsedMs(loadStart);
+
+			if (!loaded)
+			{
+				LOG_ERROR("SceneArchive benchmark: load fail.");
+				break;
+			}
+			loadedNodeCount = loaded->getNodeCount() + 1;
+
+			if (i > 0)
+			{
+				bestLoadMs = std::min(bestLoadMs, loadMs);
+			}
+		}
+
+		std::error_code ec;
+		std::filesystem::remove(path, ec);
+
+		LOG_INFO("SceneArchive benchmark: {0} nodes, {1:.2f} MB, build {2:.2f} ms, save {3:.2f} ms, load {4:.2f} ms ({5:.3f} us per node).",
+			loadedNodeCount, double(fileSize) / (1024.0 * 1024.0), buildMs, saveMs, bestLoadMs, bestLoadMs * 1000.0 / double(std::max<size_t>(loadedNodeCount, 1)));
+	}
+}
@@ -0,0 +1,174 @@
+#pragma once
+
+#include "../Core/Core.h"
+
+namespace Flower
+{
+	class Scene;
+	class SceneNode;
+
+	// Binary scene file layout, all section offsets relate to file begin.
+	// Nodes store in pre-order so parent index always smaller than child index, root node is index 0.
+	// Components group by type into blocks, record start with owner node index.
+	namespace SceneFile
+	{
+		constexpr uint32_t kMagic = 0x4E435346; // "FSCN"
+		constexpr uint32_t kVersion = 3;
+		constexpr uint32_t kInvalidIndex = ~0u;
+
+		enum class EComponentType : uint32_t
+		{
+			StaticMesh = 0,
+			DirectionalLight,
+			SpotLight,
+			Landscape,
+			PMX,
+			PointLight,
+
+			Max
+		};
+
+		enum ENodeFlags : uint32_t
+		{
+			ENodeFlags_Visible = 0x01,
+			ENodeFlags_Static  = 0x02,
+		};
+
+		struct Header
+		{
+			uint32_t magic;
+			uint32_t version;
+			uint32_t nodeCount;
+			uint32_t componentBlockCount;
+
+			uint64_t nodeOffset;
+			uint64_t componentBlockOffset;
+			uint64_t stringOffset;
+			uint64_t stringSize;
+		};
+		static_assert(sizeof(Header) == 48);
+
+		// String in string table, no null terminate.
+		struct StringRef
+		{
+			uint32_t offset;
+			uint32_t size;
+		};
+
+		struct Node
+		{
+			uint32_t parent;
+			uint32_t flags;
+			StringRef name;
+
+			float translation[3];
+			float rotation[4]; // x, y, z, w.
+			float scale[3];
+		};
+		static_assert(sizeof(Node) == 56);
+
+		struct ComponentBlock
+		{
+			uint32_t type;
+			uint32_t count;
+			uint32_t stride;
+			uint32_t pad;
+			uint64_t offset;
+		};
+		static_assert(sizeof(ComponentBlock) == 24);
+
+		struct EmptyRecord
+		{
+			uint32_t node;
+		};
+
+		struct StaticMeshRecord
+		{
+			uint32_t node;
+			StringRef meshUUID;
+		};
+
+		struct LightRecord
+		{
+			uint32_t node;
+			float color[3];
+			float intensity;
+			float forward[3];
+		};
+
+		// Version 1 spot light block only store LightRecord, range and cone use default value.
+		struct SpotLightRecord
+		{
+			LightRecord light;
+
+			float range;
+			float innerConeAngle;
+			float outerConeAngle;
+		};
+
+		// Version 2 landscape block only store EmptyRecord, no heightmap set.
+		struct LandscapeRecord
+		{
+			uint32_t node;
+			StringRef heightmapUUID;
+
+			float sampleSpacing;
+			float heightScale;
+		};
+
+		struct PointLightRecord
+		{
+			LightRecord light;
+
+			float range;
+		};
+
+		struct DirectionalLightRecord
+		{
+			LightRecord light;
+
+			uint32_t perCascadeDimXY;
+			uint32_t cascadeCount;
+			float shadowFilterSize;
+			float maxFilterSize;
+			float cascadeSplitLambda;
+			float shadowBiasConst;
+			float shadowBiasSlope;
+			float cascadeBorderAdopt;
+			float cascadeEdgeLerpThreshold;
+			float maxDrawDepthDistance;
+		};
+	}
+
+	// Scene binary save and load.
+	// Load path build node tree and component caches in bulk, no per node createNode/setParent.
+	class SceneArchive
+	{
+	private:
+		// Build one component block, records filter then construct in parallel.
+		template<typename T, typename Record, typename F>
+		static std::vector<std::shared_ptr<T>> loadComponentBlock(
+			Scene* scene,
+			const std::vector<std::shared_ptr<SceneNode>>& nodes,
+			const uint8_t* blockData,
+			const SceneFile::ComponentBlock& block,
+			F&& fill);
+
+		// Random hierarchy with light, landscape and pmx components, fixed seed.
+		static std::shared_ptr<Scene> buildSyntheticScene(uint32_t nodeCount, uint32_t seed);
+
+	public:
+		static constexpr const char* kFileExtension = ".scene";
+
+		static bool save(Scene* scene, const std::filesystem::path& path);
+
+		// Return nullptr if file invalid.
+		static std::shared_ptr<Scene> load(const std::filesystem::path& path);
+
+		// Save then load synthetic scene, check hierarchy, transform and component fields match.
+		static bool validate();
+
+		// Save then load synthetic scene with nodeCount nodes, log timings.
+		static void benchmark(uint32_t nodeCount);
+	};
+}
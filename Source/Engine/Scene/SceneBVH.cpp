@@ -0,0 +1,439 @@
+#include "Pch.h"
+#include "SceneBVH.h"
+#include "Scene.h"
+#include "Component/StaticMesh.h"
+#include "../AssetSystem/MeshManager.h"
+
+#include <random>
+
+namespace Flower
+{
+	void SceneBVH::clear()
+	{
+		m_bvh.clear();
+		m_entries.clear();
+		m_instances.clear();
+		m_instanceEntries.clear();
+		m_nodeEntries.clear();
+	}
+
+	void SceneBVH::rebuild(Scene* scene)
+	{
+		clear();
+
+		std::vector<BVHBounds> instanceBounds;
+		scene->loopComponents<StaticMeshComponent>([&](std::shared_ptr<StaticMeshComponent> component)
+		{
+			auto node = component->getNode();
+
+			Entry entry{};
+			entry.component = component;
+			entry.firstInstance = uint32_t(m_instances.size());
+			entry.submeshCount = component->getSubmeshCount();
+			entry.worldMatrix = node->getTransform()->getWorldMatrix();
+
+			for (uint32_t submesh = 0; submesh < entry.submeshCount; submesh++)
+			{
+				Instance instance{};
+				instance.component = component;
+				instance.submesh = submesh;
+				component->getSubmeshBounds(submesh, instance.localCenter, instance.localExtents);
+
+				instanceBounds.push_back(BVHBounds::transform(instance.localCenter, instance.localExtents, entry.worldMatrix));
+				m_instances.push_back(instance);
+				m_instanceEntries.push_back(uint32_t(m_entries.size()));
+			}
+
+			m_nodeEntries[node.get()] = uint32_t(m_entries.size());
+			m_entries.push_back(std::move(entry));
+		});
+
+		m_bvh.build(std::move(instanceBounds));
+		m_componentGeneration = scene->getComponentGeneration();
+		m_rebuildCount++;
+	}
+
+	bool SceneBVH::refitEntry(uint32_t entryIndex)
+	{
+		auto& entry = m_entries[entryIndex];
+		auto component = entry.component.lock();
+		if (component == nullptr)
+		{
+			return false;
+		}
+
+		const glm::mat4 worldMatrix = component->getNode()->getTransform()->getWorldMatrix();
+		if (worldMatrix == entry.worldMatrix)
+		{
+			return false;
+		}
+		entry.worldMatrix = worldMatrix;
+
+		for (uint32_t submesh = 0; submesh < entry.submeshCount; submesh++)
+		{
+			const auto& instance = m_instances[entry.firstInstance + submesh];
+			m_bvh.setPrimitiveBounds(entry.firstInstance + submesh, BVHBounds::transform(instance.localCenter, instance.localExtents, worldMatrix));
+		}
+		return true;
+	}
+
+	void SceneBVH::update(Scene* scene, const std::vector<std::weak_ptr<SceneNode>>& movedNodes, bool bAllMoved)
+	{
+		// Component set, mesh or submesh bounds change need rebuild.
+		if (scene->getComponentGeneration() != m_componentGeneration)
+		{
+			rebuild(scene);
+			return;
+		}
+
+		bool bRefit = false;
+		if (bAllMoved)
+		{
+			for (uint32_t i = 0; i < uint32_t(m_entries.size()); i++)
+			{
+				bRefit |= refitEntry(i);
+			}
+		}
+		else
+		{
+			for (const auto& movedNode : movedNodes)
+			{
+				auto node = movedNode.lock();
+				if (node == nullptr)
+				{
+					continue;
+				}
+
+				if (auto it = m_nodeEntries.find(node.get()); it != m_nodeEntries.end())
+				{
+					bRefit |= refitEntry(it->second);
+				}
+			}
+		}
+
+		if (bRefit)
+		{
+			m_bvh.refit();
+			m_refitCount++;
+
+			if (m_bvh.computeCost() > m_bvh.getBuildCost() * kRebuildCostRatio)
+			{
+				rebuild(scene);
+			}
+		}
+	}
+
+	std::shared_ptr<const SceneBVH::MeshBLAS> SceneBVH::getOrBuildBLAS(const StaticMeshComponent* component)
+	{
+		const UUID& meshUUID = component->getUUID();
+		if (auto it = m_meshBLAS.find(meshUUID); it != m_meshBLAS.end())
+		{
+			m_blasLRU.splice(m_blasLRU.begin(), m_blasLRU, it->second.lruNode);
+			return it->second.blas->bReady.load() ? it->second.blas : nullptr;
+		}
+
+		// Engine mesh no header, hit test fallback to bounds.
+		auto header = component->getAssetHeader();
+		if (header == nullptr)
+		{
+			return nullptr;
+		}
+
+		auto blas = std::make_shared<MeshBLAS>();
+		for (const auto& submesh : header->getSubMeshes())
+		{
+			blas->triangleCount += submesh.indexCount / 3;
+		}
+
+		// Bin load and build off main thread, task own blas so eviction before finish is safe.
+		GThreadPool::get()->pushTask([blas, header]()
+		{
+			auto meshBin = std::dynamic_pointer_cast<StaticMeshAssetBin>(header->loadBinData());
+			if (meshBin == nullptr)
+			{
+				LOG_WARN("Static mesh {0} bin data load fail, ray hit use bounds.", header->getName());
+				return;
+			}
+
+			const auto& submeshes = header->getSubMeshes();
+			blas->submeshes.resize(submeshes.size());
+			GThreadPool::get()->parallelFor(0, submeshes.size(), [&](size_t begin, size_t end)
+			{
+				for (size_t i = begin; i < end; i++)
+				{
+					blas->submeshes[i] = std::make_shared<TriangleBVH>();
+					blas->submeshes[i]->build(meshBin->getVertices(), meshBin->getIndices().data() + submeshes[i].indexStartPosition, submeshes[i].indexCount);
+				}
+			});
+			blas->bReady.store(true);
+		});
+
+		m_blasLRU.push_front(meshUUID);
+		m_meshBLAS[meshUUID] = { blas, m_blasLRU.begin() };
+		m_blasTriangleCount += blas->triangleCount;
+
+		// Keep newest one even it over budget alone.
+		while (m_blasTriangleCount > kMaxBLASTriangleCount && m_blasLRU.size() > 1)
+		{
+			auto evict = m_meshBLAS.find(m_blasLRU.back());
+			m_blasTriangleCount -= evict->second.blas->triangleCount;
+			m_meshBLAS.erase(evict);
+			m_blasLRU.pop_back();
+		}
+
+		return nullptr;
+	}
+
+	bool SceneBVH::raycast(const BVHRay& ray, RayHit& outHit, bool bExact)
+	{
+		bool bTriangleHit = false;
+		std::shared_ptr<const MeshBLAS> hitBLAS = nullptr;
+		const uint32_t hitInstance = m_bvh.traceClosest(ray, [&](uint32_t instanceId, const BVHRay& r, float& tMax)
+		{
+			float boundsNear;
+			if (!BVH::intersectRay(m_bvh.getPrimitiveBounds(instanceId), r, tMax, boundsNear))
+			{
+				return false;
+			}
+
+			const Instance& instance = m_instances[instanceId];
+			const Entry& entry = m_entries[m_instanceEntries[instanceId]];
+
+			auto component = instance.component.lock();
+			if (component == nullptr)
+			{
+				return false;
+			}
+
+			auto blas = bExact ? getOrBuildBLAS(component.get()) : nullptr;
+			if (blas == nullptr || instance.submesh >= blas->submeshes.size())
+			{
+				tMax = boundsNear;
+				bTriangleHit = false;
+				return true;
+			}
+
+			// Affine transform keep ray parameter, so local hit distance is world hit distance.
+			const glm::mat4 worldToLocal = glm::inverse(entry.worldMatrix);
+
+			BVHRay localRay;
+			localRay.origin = glm::vec3(worldToLocal * glm::vec4(r.origin, 1.0f));
+			localRay.direction = glm::mat3(worldToLocal) * r.direction;
+			localRay.tMin = r.tMin;
+			localRay.tMax = tMax;
+
+			float hitT;
+			if (blas->submeshes[instance.submesh]->trace(localRay, hitT) != GBVHInvalidIndex)
+			{
+				tMax = hitT;
+				bTriangleHit = true;
+				hitBLAS = blas;
+				return true;
+			}
+			return false;
+		});
+
+		if (hitInstance == GBVHInvalidIndex)
+		{
+			return false;
+		}
+
+		const Instance& instance = m_instances[hitInstance];
+		auto component = instance.component.lock();
+		if (component == nullptr)
+		{
+			return false;
+		}
+
+		// Recompute hit distance, trace only return primitive.
+		float hitT = ray.tMax;
+		if (bTriangleHit)
+		{
+			const glm::mat4 worldToLocal = glm::inverse(m_entries[m_instanceEntries[hitInstance]].worldMatrix);
+
+			BVHRay localRay = ray;
+			localRay.origin = glm::vec3(worldToLocal * glm::vec4(ray.origin, 1.0f));
+			localRay.direction = glm::mat3(worldToLocal) * ray.direction;
+			hitBLAS->submeshes[instance.submesh]->trace(localRay, hitT);
+		}
+		else
+		{
+			BVH::intersectRay(m_bvh.getPrimitiveBounds(hitInstance), ray, ray.tMax, hitT);
+		}
+
+		outHit.node = component->getNode();
+		outHit.instance = hitInstance;
+		outHit.submesh = instance.submesh;
+		outHit.t = hitT;
+		outHit.bTriangleHit = bTriangleHit;
+		return true;
+	}
+
+	void SceneBVH::raycastPacket(const BVHRay rays[GBVHPacketSize], uint32_t outInstances[GBVHPacketSize], float outT[GBVHPacketSize]) const
+	{
+		for (uint32_t i = 0; i < GBVHPacketSize; i++)
+		{
+			outT[i] = rays[i].tMax;
+		}
+
+		m_bvh.tracePacket(rays, outInstances, [&](uint32_t instanceId, uint32_t rayId, const BVHRay& r, float& tMax)
+		{
+			float boundsNear;
+			if (BVH::intersectRay(m_bvh.getPrimitiveBounds(instanceId), r, tMax, boundsNear))
+			{
+				tMax = boundsNear;
+				outT[rayId] = boundsNear;
+				return true;
+			}
+			return false;
+		});
+	}
+
+	void SceneBVH::queryFrustum(const glm::vec4 planes[6], std::vector<uint32_t>& outInstances) const
+	{
+		m_bvh.queryFrustum(planes, outInstances);
+	}
+
+	void SceneBVH::querySphere(const glm::vec3& center, float radius, std::vector<uint32_t>& outInstances) const
+	{
+		m_bvh.querySphere(center, radius, outInstances);
+	}
+
+	void SceneBVH::benchmark(uint32_t instanceCount)
+	{
+		using Clock = std::chrono::high_resolution_clock;
+		auto elapsedMs = [](Clock::time_point start)
+		{
+			return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+		};
+
+		// Fixed seed so every run same scene.
+		std::mt19937 rng(1234u);
+		std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+		const float sceneSize = 2000.0f;
+		const float sceneHeight = 50.0f;
+		auto randomBounds = [&]()
+		{
+			const glm::vec3 center = glm::vec3((unit(rng) - 0.5f) * sceneSize, unit(rng) * sceneHeight, (unit(rng) - 0.5f) * sceneSize);
+			const glm::vec3 extents = glm::vec3(0.5f) + glm::vec3(unit(rng), unit(rng), unit(rng)) * 4.5f;
+			return BVHBounds{ center - extents, center + extents };
+		};
+
+		std::vector<BVHBounds> bounds(instanceCount);
+		for (auto& b : bounds)
+		{
+			b = randomBounds();
+		}
+
+		BVH bvh;
+
+		auto buildStart = Clock::now();
+		bvh.build(std::vector<BVHBounds>(bounds));
+		const double buildMs = elapsedMs(buildStart);
+
+		// Ten percent instances move a little.
+		auto moveInstance = [&](uint32_t id)
+		{
+			const glm::vec3 offset = (glm::vec3(unit(rng), unit(rng), unit(rng)) - 0.5f) * 2.0f;
+			bounds[id].min += offset;
+			bounds[id].max += offset;
+			bvh.setPrimitiveBounds(id, bounds[id]);
+		};
+
+		std::vector<uint32_t> moveIds(instanceCount / 10);
+		for (auto& id : moveIds)
+		{
+			id = uint32_t(rng() % instanceCount);
+		}
+
+		auto partialRefitStart = Clock::now();
+		for (uint32_t id : moveIds)
+		{
+			moveInstance(id);
+		}
+		bvh.refit();
+		const double partialRefitMs = elapsedMs(partialRefitStart);
+
+		auto fullRefitStart = Clock::now();
+		for (uint32_t id = 0; id < instanceCount; id++)
+		{
+			moveInstance(id);
+		}
+		bvh.refit();
+		const double fullRefitMs = elapsedMs(fullRefitStart);
+		const float refitCostRatio = bvh.computeCost() / glm::max(bvh.getBuildCost(), 1e-6f);
+
+		// Coherent packets, four rays of one packet share origin and jitter direction like pixel quad.
+		const uint32_t packetCount = 1u << 16;
+		std::vector<BVHRay> rays(size_t(packetCount) * GBVHPacketSize);
+		for (uint32_t packet = 0; packet < packetCount; packet++)
+		{
+			const glm::vec3 origin = glm::vec3((unit(rng) - 0.5f) * sceneSize, sceneHeight * 0.5f, (unit(rng) - 0.5f) * sceneSize);
+			const glm::vec3 direction = glm::normalize(glm::vec3(unit(rng) - 0.5f, (unit(rng) - 0.5f) * 0.2f, unit(rng) - 0.5f) + glm::vec3(1e-4f));
+			for (uint32_t i = 0; i < GBVHPacketSize; i++)
+			{
+				auto& ray = rays[packet * GBVHPacketSize + i];
+				ray.origin = origin;
+				ray.direction = glm::normalize(direction + glm::vec3(float(i & 1), 0.0f, float(i >> 1)) * 1e-3f);
+				ray.tMax = sceneSize;
+			}
+		}
+
+		auto intersectBox = [&](uint32_t primitive, const BVHRay& r, float& tMax)
+		{
+			float boundsNear;
+			if (BVH::intersectRay(bvh.getPrimitiveBounds(primitive), r, tMax, boundsNear))
+			{
+				tMax = boundsNear;
+				return true;
+			}
+			return false;
+		};
+
+		uint32_t singleHitCount = 0;
+		auto singleStart = Clock::now();
+		for (const auto& ray : rays)
+		{
+			singleHitCount += (bvh.traceClosest(ray, intersectBox) != GBVHInvalidIndex) ? 1 : 0;
+		}
+		const double singleMs = elapsedMs(singleStart);
+
+		uint32_t packetHitCount = 0;
+		auto packetStart = Clock::now();
+		for (uint32_t packet = 0; packet < packetCount; packet++)
+		{
+			uint32_t hits[GBVHPacketSize];
+			bvh.tracePacket(&rays[packet * GBVHPacketSize], hits, [&](uint32_t primitive, uint32_t, const BVHRay& r, float& tMax)
+			{
+				return intersectBox(primitive, r, tMax);
+			});
+
+			for (uint32_t i = 0; i < GBVHPacketSize; i++)
+			{
+				packetHitCount += (hits[i] != GBVHInvalidIndex) ? 1 : 0;
+			}
+		}
+		const double packetMs = elapsedMs(packetStart);
+
+		std::atomic<uint32_t> parallelHitCount = 0;
+		auto parallelStart = Clock::now();
+		GThreadPool::get()->parallelFor(0, rays.size(), [&](size_t begin, size_t end)
+		{
+			uint32_t localHitCount = 0;
+			for (size_t i = begin; i < end; i++)
+			{
+				localHitCount += (bvh.traceClosest(rays[i], intersectBox) != GBVHInvalidIndex) ? 1 : 0;
+			}
+			parallelHitCount += localHitCount;
+		}, 1024);
+		const double parallelMs = elapsedMs(parallelStart);
+
+		auto raysPerSecond = [&](double ms) { return double(rays.size()) / (ms * 0.001) / 1e6; };
+
+		LOG_INFO("SceneBVH benchmark: {0} instances, {1} nodes, build {2:.2f} ms.", instanceCount, bvh.getNodeCount(), buildMs);
+		LOG_INFO("SceneBVH benchmark: refit {0} moved {1:.3f} ms, refit all {2:.3f} ms, sah cost after refit {3:.2f}x build.", moveIds.size(), partialRefitMs, fullRefitMs, refitCostRatio);
+		LOG_INFO("SceneBVH benchmark: {0} rays, single {1:.2f} Mrays/s, packet {2:.2f} Mrays/s, parallel {3:.2f} Mrays/s, hits {4}/{5}/{6}.",
+			rays.size(), raysPerSecond(singleMs), raysPerSecond(packetMs), raysPerSecond(parallelMs), singleHitCount, packetHitCount, parallelHitCount.load());
+	}
+}
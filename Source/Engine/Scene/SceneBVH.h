@@ -0,0 +1,119 @@
+#pragma once
+#include "BVH.h"
+
+namespace Flower
+{
+	class Scene;
+	class SceneNode;
+	class StaticMeshComponent;
+	class StaticMeshAssetHeader;
+
+	// Cpu bvh over static mesh submesh world bounds, one primitive per submesh.
+	// Sync when update: scene component generation change rebuild, moved nodes refit, and rebuild again when refit tree degrade.
+	// Exact ray hit use per submesh triangle bvh, build async from mesh bin data on first hit test, hit bounds until ready.
+	class SceneBVH : NonCopyable
+	{
+	public:
+		struct Instance
+		{
+			std::weak_ptr<StaticMeshComponent> component;
+			uint32_t submesh = 0;
+
+			// Local box, mesh ready change bump scene component generation.
+			glm::vec3 localCenter = glm::vec3(0.0f);
+			glm::vec3 localExtents = glm::vec3(0.0f);
+		};
+
+		struct RayHit
+		{
+			std::shared_ptr<SceneNode> node = nullptr;
+			uint32_t instance = GBVHInvalidIndex;
+			uint32_t submesh = 0;
+			float t = 0.0f;
+
+			// False when mesh no cpu triangles (engine mesh), t is world bounds hit.
+			bool bTriangleHit = false;
+		};
+
+		// Refit sah cost over build cost ratio which trigger rebuild.
+		static constexpr float kRebuildCostRatio = 1.5f;
+
+		// Cached triangle bvh budget, least recent used mesh evict over it.
+		static constexpr size_t kMaxBLASTriangleCount = 4 * 1024 * 1024;
+
+	private:
+		struct Entry
+		{
+			std::weak_ptr<StaticMeshComponent> component;
+			uint32_t firstInstance = 0;
+			uint32_t submeshCount = 0;
+			glm::mat4 worldMatrix = glm::mat4(1.0f);
+		};
+
+		BVH m_bvh;
+		std::vector<Entry> m_entries;
+
+		// Index is bvh primitive.
+		std::vector<Instance> m_instances;
+		std::vector<uint32_t> m_instanceEntries;
+
+		// Moved node to entry lookup.
+		std::unordered_map<const SceneNode*, uint32_t> m_nodeEntries;
+
+		// Scene component generation of last rebuild.
+		uint64_t m_componentGeneration = ~0ull;
+
+		struct MeshBLAS
+		{
+			// Triangle bvh per submesh, write by build task before ready set.
+			std::vector<std::shared_ptr<TriangleBVH>> submeshes;
+			std::atomic<bool> bReady = false;
+
+			size_t triangleCount = 0;
+		};
+
+		struct BLASCacheEntry
+		{
+			std::shared_ptr<MeshBLAS> blas;
+			std::list<UUID>::iterator lruNode;
+		};
+
+		// Triangle bvh per mesh asset, front of lru list is most recent hit.
+		std::unordered_map<UUID, BLASCacheEntry> m_meshBLAS;
+		std::list<UUID> m_blasLRU;
+		size_t m_blasTriangleCount = 0;
+
+		uint32_t m_rebuildCount = 0;
+		uint32_t m_refitCount = 0;
+
+	private:
+		void rebuild(Scene* scene);
+		bool refitEntry(uint32_t entryIndex);
+
+		// Return nullptr when mesh no bin data or triangle bvh still building.
+		std::shared_ptr<const MeshBLAS> getOrBuildBLAS(const StaticMeshComponent* component);
+
+	public:
+		// Moved nodes collect by scene since last update, bAllMoved when scene stop track.
+		void update(Scene* scene, const std::vector<std::weak_ptr<SceneNode>>& movedNodes, bool bAllMoved);
+		void clear();
+
+		const BVH& getBVH() const { return m_bvh; }
+		const Instance& getInstance(uint32_t instance) const { return m_instances[instance]; }
+
+		uint32_t getRebuildCount() const { return m_rebuildCount; }
+		uint32_t getRefitCount() const { return m_refitCount; }
+
+		// Closest hit, exact use triangle bvh, otherwise only world bounds.
+		bool raycast(const BVHRay& ray, RayHit& outHit, bool bExact = true);
+
+		// Four rays bounds hit, miss ray instance is GBVHInvalidIndex.
+		void raycastPacket(const BVHRay rays[GBVHPacketSize], uint32_t outInstances[GBVHPacketSize], float outT[GBVHPacketSize]) const;
+
+		void queryFrustum(const glm::vec4 planes[6], std::vector<uint32_t>& outInstances) const;
+		void querySphere(const glm::vec3& center, float radius, std::vector<uint32_t>& outInstances) const;
+
+		// Synthetic instance scene, log build time, refit time and rays per second.
+		static void benchmark(uint32_t instanceCount);
+	};
+}
@@ -2,6 +2,7 @@
 #include "SceneManager.h"
 #include "SceneNode.h"
 #include "Scene.h"
+#include "SceneArchive.h"
 
 namespace Flower
 {
@@ -18,6 +19,11 @@ namespace Flower
 
 	void SceneManager::tick(const RuntimeModuleTickData& tickData)
 	{
+		if (m_pendingScene)
+		{
+			m_scene = std::move(m_pendingScene);
+		}
+
 		if (auto* scene = m_scene.get())
 		{
 			scene->tick(tickData);
@@ -32,6 +38,32 @@ namespace Flower
 	void SceneManager::releaseScene()
 	{
 		m_scene = nullptr;
+		m_pendingScene = nullptr;
+	}
+
+	bool SceneManager::saveScene(const std::filesystem::path& path)
+	{
+		return SceneArchive::save(getScenes(), path);
+	}
+
+	bool SceneManager::loadScene(const std::filesystem::path& path)
+	{
+		auto scene = SceneArchive::load(path);
+		if (!scene)
+		{
+			return false;
+		}
+
+		// No scene active yet, use directly.
+		if (m_scene == nullptr)
+		{
+			m_scene = std::move(scene);
+		}
+		else
+		{
+			m_pendingScene = std::move(scene);
+		}
+		return true;
 	}
 
 	Scene* SceneManager::getScenes()
@@ -20,8 +20,15 @@ namespace Flower
 
 		void releaseScene();
 
+		// Save active scene as binary scene file.
+		bool saveScene(const std::filesystem::path& path);
+
+		// Load binary scene file, loaded scene replace active scene at next tick begin.
+		bool loadScene(const std::filesystem::path& path);
+
 	private:
 		std::shared_ptr<Scene> m_scene = nullptr;
+		std::shared_ptr<Scene> m_pendingScene = nullptr;
 
 	private:
 		Scene* createEmptyScene();
@@ -23,24 +23,31 @@ namespace Flower
         m_components.erase(type);
     }
 
-    std::shared_ptr<SceneNode> SceneNode::create(const size_t id, const std::string& name, std::shared_ptr<Scene> scene)
+    std::shared_ptr<SceneNode> SceneNode::create(const size_t id, const std::string& name, std::shared_ptr<Scene> scene, bool bBulkLoad)
     {
         auto res = std::shared_ptr<SceneNode>(new SceneNode());
 
         res->m_id = id;
         res->m_name = name;
         res->m_runTimeIdName = std::to_string(id);
+        res->m_bBulkLoad = bBulkLoad;
 
         res->setComponent(std::make_shared<Transform>(res));
         res->m_scene = scene;
 
-        LOG_TRACE("SceneNode {0} with GUID {1} construct.", res->m_name.c_str(), res->m_id);
+        if (!bBulkLoad)
+        {
+            LOG_TRACE("SceneNode {0} with GUID {1} construct.", res->m_name.c_str(), res->m_id);
+        }
         return res;
     }
 
     SceneNode::~SceneNode()
     {
-        LOG_TRACE("SceneNode {0} with GUID {1} destroy.", m_name.c_str(), m_id);
+        if (!m_bBulkLoad)
+        {
+            LOG_TRACE("SceneNode {0} with GUID {1} destroy.", m_name.c_str(), m_id);
+        }
         if (auto scene = m_scene.lock())
         {
             scene->m_nodeCount--;
@@ -82,6 +89,8 @@ namespace Flower
             {
                 child->setVisibilityImpl(bState, true);
             }
+
+            markDirty();
         }
     }
 
@@ -103,6 +112,8 @@ namespace Flower
             {
                 child->setStaticImpl(bState, true);
             }
+
+            markDirty();
         }
     }
 
@@ -9,6 +9,7 @@ namespace Flower
     class SceneNode : public std::enable_shared_from_this<SceneNode>
     {
         friend Scene;
+        friend class SceneArchive;
     private:
         SceneNode() = default;
 
@@ -16,6 +17,9 @@ namespace Flower
         bool m_bVisibility = true;
         bool m_bStatic = true;
 
+        // Created by bulk load, skip per node lifetime trace, loader log one summary line.
+        bool m_bBulkLoad = false;
+
         // Id of scene node.
         size_t m_id;
 
@@ -58,7 +62,7 @@ namespace Flower
 
         void tick(const RuntimeModuleTickData& tickData);
 
-        static std::shared_ptr<SceneNode> create(const size_t id, const std::string& name, std::shared_ptr<Scene> scene);
+        static std::shared_ptr<SceneNode> create(const size_t id, const std::string& name, std::shared_ptr<Scene> scene, bool bBulkLoad = false);
 
         virtual ~SceneNode();
 
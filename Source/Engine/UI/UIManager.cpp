@@ -1,6 +1,8 @@
 #include "Pch.h"
 #include "UIManager.h"
 #include "../RHI/RHI.h"
+#include "UIRetain.h"
+#include <ImGui/ImGuiInternal.h>
 
 namespace Flower
 {
@@ -29,6 +31,22 @@ namespace Flower
 		CVarFlags::ReadOnly | CVarFlags::InitOnce
 	);
 
+	static AutoCVarInt32 cVarUIIdleThrottle(
+		"r.ImGui.IdleThrottle",
+		"Throttle ui rebuild to r.Render.UIFps when no input, 0 is off, 1 is on.",
+		"ImGui",
+		0,
+		CVarFlags::ReadAndWrite
+	);
+
+	static AutoCVarFloat cVarUIIdleSeconds(
+		"r.ImGui.IdleSeconds",
+		"No input seconds before ui idle throttle start.",
+		"ImGui",
+		1.0f,
+		CVarFlags::ReadAndWrite
+	);
+
 	static AutoCVarString cVarFontFolderPath(
 		"r.ImGui.FontFolderPath",
 		"ImGui font folder path.",
@@ -37,6 +55,8 @@ namespace Flower
 		CVarFlags::ReadOnly | CVarFlags::InitOnce
 	);
 
+	static AutoCVarCmd cVarUIBenchmark("cmd.ImGui.Benchmark", "Build 10k items content browser in private imgui context, log full, clipped and retained ui cpu time.");
+
 	void setupStyle()
 	{
 		ImGui::StyleColorsDark();
@@ -211,6 +231,37 @@ namespace Flower
 		ImGui_ImplVulkan_NewFrame();
 		ImGui_ImplGlfw_NewFrame();
 		ImGui::NewFrame();
+
+		RetainedWindow::resetFrameStats();
+	}
+
+	bool ImGuiContext::shouldBuildFrame(float idleFps)
+	{
+		const auto now = std::chrono::steady_clock::now();
+
+		// Glfw callback push input event to queue until next new frame, window resize no push event so check size too.
+		int width, height;
+		glfwGetWindowSize(RHI::get()->getWindow(), &width, &height);
+		const ImVec2 displaySize = ImGui::GetIO().DisplaySize;
+		if (ImGui::GetCurrentContext()->InputEventsQueue.Size > 0 || width != int(displaySize.x) || height != int(displaySize.y))
+		{
+			m_lastInputPoint = now;
+		}
+
+		bool bBuild = (cVarUIIdleThrottle.get() == 0) || (idleFps <= 0.0f) || (ImGui::GetDrawData() == nullptr);
+		if (!bBuild)
+		{
+			const float idleSeconds = std::chrono::duration<float>(now - m_lastInputPoint).count();
+			const float buildInterval = std::chrono::duration<float>(now - m_lastBuildPoint).count();
+
+			bBuild = (idleSeconds < cVarUIIdleSeconds.get()) || (buildInterval >= 1.0f / idleFps);
+		}
+
+		if (bBuild)
+		{
+			m_lastBuildPoint = now;
+		}
+		return bBuild;
 	}
 
 	void ImGuiContext::updateAfterSubmit()
@@ -227,4 +278,12 @@ namespace Flower
 			ImGui::RenderPlatformWindowsDefault();
 		}
 	}
-}
\ No newline at end of file
+
+	void ImGuiContext::tick()
+	{
+		CVarCmdHandle(cVarUIBenchmark, []()
+		{
+			RetainedWindow::benchmark(10000);
+		});
+	}
+}
@@ -9,6 +9,16 @@ namespace Flower
 		void release();
 		void newFrame();
 		void updateAfterSubmit();
+
+		// Per frame cmd handle, no ui context need so also call in headless mode.
+		void tick();
+
+		// False when r.ImGui.IdleThrottle on, no input for a while and last build newer than idle fps interval.
+		bool shouldBuildFrame(float idleFps);
+
+	private:
+		std::chrono::steady_clock::time_point m_lastInputPoint = std::chrono::steady_clock::now();
+		std::chrono::steady_clock::time_point m_lastBuildPoint = std::chrono::steady_clock::now();
 	};
 
 	// UI manager host on renderer, lifetime same with renderer.
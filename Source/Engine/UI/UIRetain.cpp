@@ -0,0 +1,422 @@
+#include "Pch.h"
+#include "UIRetain.h"
+#include <ImGui/ImGuiInternal.h>
+
+namespace Flower
+{
+	static AutoCVarInt32 cVarUIRetain(
+		"r.ImGui.Retain",
+		"Replay cached draw output of idle window instead of rebuild widgets, 0 is off, 1 is on.",
+		"ImGui",
+		1,
+		CVarFlags::ReadAndWrite
+	);
+
+	static AutoCVarInt32 cVarUIRetainRefreshFrames(
+		"r.ImGui.RetainRefreshFrames",
+		"Retained window force rebuild after this frame count, catch content change which generation no track, 0 is never.",
+		"ImGui",
+		60,
+		CVarFlags::ReadAndWrite
+	);
+
+	static RetainedWindow::Stats GRetainStats{ };
+
+	// Scroll target apply on next window begin, replay skip begin of child windows so must wait it settle.
+	static inline bool isScrollSettled(const ImGuiWindow* window)
+	{
+		return window->ScrollTarget.x == FLT_MAX && window->ScrollTarget.y == FLT_MAX;
+	}
+
+	bool RetainedWindow::Key::operator==(const Key& rhs) const
+	{
+		return
+			pos.x == rhs.pos.x && pos.y == rhs.pos.y &&
+			size.x == rhs.size.x && size.y == rhs.size.y &&
+			scroll.x == rhs.scroll.x && scroll.y == rhs.scroll.y &&
+			fontSize == rhs.fontSize &&
+			contentGeneration == rhs.contentGeneration;
+	}
+
+	const RetainedWindow::Stats& RetainedWindow::getFrameStats()
+	{
+		return GRetainStats;
+	}
+
+	void RetainedWindow::resetFrameStats()
+	{
+		GRetainStats = { };
+	}
+
+	bool RetainedWindow::isCurrentWindowIdle()
+	{
+		const ::ImGuiContext& g = *GImGui;
+		const ImGuiWindow* window = g.CurrentWindow;
+
+		if (g.DragDropActive || g.OpenPopupStack.Size > 0)
+		{
+			return false;
+		}
+
+		if (g.ActiveId != 0 && g.ActiveIdWindow && g.ActiveIdWindow->RootWindow == window->RootWindow)
+		{
+			return false;
+		}
+
+		// Keyboard navigation enable, focused window still receive key input without mouse.
+		if (g.NavWindow && g.NavWindow->RootWindow == window->RootWindow)
+		{
+			return false;
+		}
+
+		return !ImGui::IsMouseHoveringRect(window->Rect().Min, window->Rect().Max, false);
+	}
+
+	RetainedWindow::Key RetainedWindow::buildKey(uint64_t contentGeneration)
+	{
+		const ImGuiWindow* window = ImGui::GetCurrentWindowRead();
+
+		Key key{ };
+		key.pos = window->Pos;
+		key.size = window->Size;
+		key.scroll = window->Scroll;
+		key.fontSize = ImGui::GetFontSize();
+		key.contentGeneration = contentGeneration;
+
+		return key;
+	}
+
+	bool RetainedWindow::tryReplay(uint64_t contentGeneration)
+	{
+		if (!m_bValid || cVarUIRetain.get() == 0)
+		{
+			return false;
+		}
+
+		const int refreshFrames = cVarUIRetainRefreshFrames.get();
+		if (refreshFrames > 0 && ImGui::GetFrameCount() - m_captureFrame >= refreshFrames)
+		{
+			return false;
+		}
+
+		if (!(buildKey(contentGeneration) == m_key) || !isCurrentWindowIdle())
+		{
+			return false;
+		}
+
+		ImGuiWindow* window = ImGui::GetCurrentWindow();
+		ImDrawList* drawList = window->DrawList;
+
+		for (const auto& cmd : m_cmds)
+		{
+			drawList->PushClipRect(ImVec2(cmd.clipRect.x, cmd.clipRect.y), ImVec2(cmd.clipRect.z, cmd.clipRect.w), false);
+			drawList->PushTextureID(cmd.textureId);
+
+			// Reserve may start new vertex offset when current over 64k, so get base after it.
+			drawList->PrimReserve(int(cmd.idxCount), int(cmd.vtxCount));
+			const uint32_t baseIndex = drawList->_VtxCurrentIdx;
+
+			memcpy(drawList->_VtxWritePtr, &m_vertices[cmd.vtxOffset], cmd.vtxCount * sizeof(ImDrawVert));
+			for (uint32_t i = 0; i < cmd.idxCount; i++)
+			{
+				drawList->_IdxWritePtr[i] = ImDrawIdx(baseIndex + m_indices[cmd.idxOffset + i]);
+			}
+
+			drawList->_VtxWritePtr += cmd.vtxCount;
+			drawList->_IdxWritePtr += cmd.idxCount;
+			drawList->_VtxCurrentIdx += cmd.vtxCount;
+
+			drawList->PopTextureID();
+			drawList->PopClipRect();
+		}
+
+		window->DC.CursorMaxPos = ImMax(window->DC.CursorMaxPos, m_cursorMaxPos);
+		window->DC.IdealMaxPos = ImMax(window->DC.IdealMaxPos, m_idealMaxPos);
+
+		GRetainStats.replayCount++;
+		return true;
+	}
+
+	void RetainedWindow::beginCapture(bool bRetainable, uint64_t contentGeneration)
+	{
+		GRetainStats.buildCount++;
+
+		m_bValid = false;
+		m_bCapturing = bRetainable && (cVarUIRetain.get() != 0) && isCurrentWindowIdle();
+		if (!m_bCapturing)
+		{
+			return;
+		}
+
+		const ImDrawList* drawList = ImGui::GetWindowDrawList();
+
+		m_pendingKey = buildKey(contentGeneration);
+		m_cmdBegin = glm::max(drawList->CmdBuffer.Size - 1, 0);
+		m_idxBegin = drawList->IdxBuffer.Size;
+	}
+
+	void RetainedWindow::endCapture()
+	{
+		if (!m_bCapturing)
+		{
+			return;
+		}
+		m_bCapturing = false;
+
+		// Widget build may active some item, this frame output no stable.
+		if (!isCurrentWindowIdle())
+		{
+			return;
+		}
+
+		// Layout depend on content size of last frame, only retain when two build in a row get same key.
+		const int frameCount = ImGui::GetFrameCount();
+		const bool bStable = (m_lastBuildFrame == frameCount - 1) && (m_lastBuildKey == m_pendingKey);
+		m_lastBuildKey = m_pendingKey;
+		m_lastBuildFrame = frameCount;
+
+		const ImGuiWindow* window = ImGui::GetCurrentWindowRead();
+		if (!bStable || !isScrollSettled(window))
+		{
+			return;
+		}
+
+		m_cmds.clear();
+		m_vertices.clear();
+		m_indices.clear();
+
+		if (!captureDrawList(window->DrawList, m_cmdBegin, m_idxBegin) || !captureChildWindows(window))
+		{
+			return;
+		}
+
+		m_cursorMaxPos = window->DC.CursorMaxPos;
+		m_idealMaxPos = window->DC.IdealMaxPos;
+
+		m_key = m_pendingKey;
+		m_captureFrame = frameCount;
+		m_bValid = true;
+	}
+
+	bool RetainedWindow::captureDrawList(const ImDrawList* drawList, int cmdBegin, int idxBegin)
+	{
+		for (int i = cmdBegin; i < drawList->CmdBuffer.Size; i++)
+		{
+			const ImDrawCmd& cmd = drawList->CmdBuffer[i];
+
+			// First command may start before capture begin, clip to capture range.
+			const uint32_t idxStart = glm::max(cmd.IdxOffset, uint32_t(idxBegin));
+			const uint32_t idxEnd = cmd.IdxOffset + cmd.ElemCount;
+			if (idxEnd <= idxStart)
+			{
+				continue;
+			}
+
+			// Callback command can't replay.
+			if (cmd.UserCallback != nullptr)
+			{
+				return false;
+			}
+
+			uint32_t minIndex = ~0u;
+			uint32_t maxIndex = 0;
+			for (uint32_t j = idxStart; j < idxEnd; j++)
+			{
+				minIndex = glm::min(minIndex, uint32_t(drawList->IdxBuffer[j]));
+				maxIndex = glm::max(maxIndex, uint32_t(drawList->IdxBuffer[j]));
+			}
+
+			RetainedCmd retained{ };
+			retained.clipRect = cmd.ClipRect;
+			retained.textureId = cmd.GetTexID();
+			retained.vtxOffset = uint32_t(m_vertices.size());
+			retained.vtxCount = maxIndex - minIndex + 1;
+			retained.idxOffset = uint32_t(m_indices.size());
+			retained.idxCount = idxEnd - idxStart;
+
+			const ImDrawVert* srcVertices = drawList->VtxBuffer.Data + cmd.VtxOffset + minIndex;
+			m_vertices.insert(m_vertices.end(), srcVertices, srcVertices + retained.vtxCount);
+			for (uint32_t j = idxStart; j < idxEnd; j++)
+			{
+				m_indices.push_back(ImDrawIdx(drawList->IdxBuffer[j] - minIndex));
+			}
+
+			m_cmds.push_back(retained);
+		}
+
+		return true;
+	}
+
+	bool RetainedWindow::captureChildWindows(const ImGuiWindow* window)
+	{
+		// Same order with imgui add window to draw data, parent first then active children.
+		for (int i = 0; i < window->DC.ChildWindows.Size; i++)
+		{
+			const ImGuiWindow* child = window->DC.ChildWindows[i];
+			if (!child->Active || child->Hidden)
+			{
+				continue;
+			}
+
+			if (!isScrollSettled(child))
+			{
+				return false;
+			}
+
+			if (!captureDrawList(child->DrawList, 0, 0) || !captureChildWindows(child))
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	void RetainedWindow::benchmark(uint32_t itemCount)
+	{
+		constexpr int kWarmFrames = 8;
+		constexpr int kFrames = 240;
+
+		// Private context, no platform and renderer backend need.
+		::ImGuiContext* prevContext = ImGui::GetCurrentContext();
+		::ImGuiContext* context = ImGui::CreateContext();
+		ImGui::SetCurrentContext(context);
+
+		ImGuiIO& io = ImGui::GetIO();
+		io.IniFilename = nullptr;
+		io.DisplaySize = ImVec2(1920.0f, 1080.0f);
+		io.DeltaTime = 1.0f / 60.0f;
+		io.BackendFlags |= ImGuiBackendFlags_RendererHasVtxOffset;
+
+		unsigned char* fontPixels;
+		int fontWidth, fontHeight;
+		io.Fonts->GetTexDataAsRGBA32(&fontPixels, &fontWidth, &fontHeight);
+		io.Fonts->SetTexID((ImTextureID)(intptr_t)1);
+		const ImTextureID snapshotTexture = (ImTextureID)(intptr_t)2;
+
+		std::vector<std::string> names(itemCount);
+		for (uint32_t i = 0; i < itemCount; i++)
+		{
+			names[i] = "Asset_" + std::to_string(i) + ".texture";
+		}
+
+		// Same shape with editor content viewer snapshot.
+		const auto drawItem = [&](uint32_t i, float dimSize)
+		{
+			ImDrawList* drawList = ImGui::GetWindowDrawList();
+			const ImVec2 pos = ImGui::GetCursorScreenPos();
+
+			ImGui::BeginGroup();
+			drawList->AddRectFilled(pos, ImVec2(pos.x + dimSize, pos.y + dimSize), IM_COL32(51, 51, 51, 190));
+			drawList->AddRect(pos, ImVec2(pos.x + dimSize, pos.y + dimSize), IM_COL32(255, 255, 255, 80));
+			ImGui::Image(snapshotTexture, ImVec2(dimSize, dimSize));
+			ImGui::TextUnformatted(names[i].c_str());
+			ImGui::EndGroup();
+		};
+
+		const auto drawBrowser = [&](bool bClip)
+		{
+			ImGui::BeginChild("Snapshots");
+
+			const float dimSize = ImGui::GetTextLineHeightWithSpacing() * 5.0f;
+			const uint32_t itemPerRow = uint32_t(glm::max(1.0f, glm::floor(ImGui::GetContentRegionAvail().x / (dimSize + ImGui::GetStyle().ItemSpacing.x))));
+			const uint32_t rowCount = (itemCount + itemPerRow - 1) / itemPerRow;
+
+			const auto drawRow = [&](uint32_t row)
+			{
+				for (uint32_t i = row * itemPerRow; i < glm::min(itemCount, (row + 1) * itemPerRow); i++)
+				{
+					if (i != row * itemPerRow)
+					{
+						ImGui::SameLine();
+					}
+					drawItem(i, dimSize);
+				}
+			};
+
+			if (bClip)
+			{
+				ImGuiListClipper clipper;
+				clipper.Begin(int(rowCount));
+				while (clipper.Step())
+				{
+					for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; row++)
+					{
+						drawRow(uint32_t(row));
+					}
+				}
+			}
+			else
+			{
+				for (uint32_t row = 0; row < rowCount; row++)
+				{
+					drawRow(row);
+				}
+			}
+
+			ImGui::EndChild();
+		};
+
+		struct Result
+		{
+			float microseconds = 0.0f;
+			int vertexCount = 0;
+			uint32_t replayCount = 0;
+		};
+
+		// Mode 0 full build, 1 clipped build, 2 clipped build with retain.
+		const auto runFrames = [&](int mode)
+		{
+			RetainedWindow retained;
+			Result result{ };
+
+			for (int frame = 0; frame < kWarmFrames + kFrames; frame++)
+			{
+				const auto startPoint = std::chrono::high_resolution_clock::now();
+
+				ImGui::NewFrame();
+				resetFrameStats();
+
+				ImGui::SetNextWindowPos(ImVec2(0.0f, 0.0f));
+				ImGui::SetNextWindowSize(ImVec2(1280.0f, 900.0f));
+				if (ImGui::Begin("Content", nullptr, ImGuiWindowFlags_NoFocusOnAppearing | ImGuiWindowFlags_NoSavedSettings))
+				{
+					const bool bRetain = (mode == 2);
+					if (!bRetain || !retained.tryReplay(0))
+					{
+						retained.beginCapture(bRetain, 0);
+						drawBrowser(mode != 0);
+						retained.endCapture();
+					}
+				}
+				ImGui::End();
+				ImGui::Render();
+
+				if (frame >= kWarmFrames)
+				{
+					result.microseconds += std::chrono::duration<float, std::micro>(std::chrono::high_resolution_clock::now() - startPoint).count();
+					result.replayCount += getFrameStats().replayCount;
+				}
+			}
+
+			result.microseconds /= float(kFrames);
+			result.vertexCount = ImGui::GetDrawData()->TotalVtxCount;
+			return result;
+		};
+
+		// Mouse outside of window, window keep idle.
+		io.AddMousePosEvent(-FLT_MAX, -FLT_MAX);
+
+		const Result fullResult = runFrames(0);
+		const Result clipResult = runFrames(1);
+		const Result retainResult = runFrames(2);
+
+		resetFrameStats();
+		ImGui::DestroyContext(context);
+		ImGui::SetCurrentContext(prevContext);
+
+		LOG_INFO("UI benchmark: {0} items, full build {1:.1f} us/frame with {2} vertices.", itemCount, fullResult.microseconds, fullResult.vertexCount);
+		LOG_INFO("UI benchmark: clipped build {0:.1f} us/frame with {1} vertices.", clipResult.microseconds, clipResult.vertexCount);
+		LOG_INFO("UI benchmark: retained {0:.1f} us/frame, {1}/{2} frames replay.", retainResult.microseconds, retainResult.replayCount, kFrames);
+	}
+}
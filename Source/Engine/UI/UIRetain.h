@@ -0,0 +1,89 @@
+#pragma once
+#include "UICommon.h"
+
+struct ImGuiWindow;
+
+namespace Flower
+{
+	// Retain draw output of one imgui window content, include its child windows.
+	// When window is idle and content generation no change, replay cached vertices into window draw list and skip widget build.
+	// Window decoration still draw by ImGui::Begin every frame, only content between begin and end cache.
+	class RetainedWindow
+	{
+	public:
+		struct Stats
+		{
+			uint32_t replayCount = 0;
+			uint32_t buildCount = 0;
+		};
+
+		// Call after ImGui::Begin return true, return true if replay cache, then skip widget content build.
+		bool tryReplay(uint64_t contentGeneration);
+
+		// Call before and after widget content build when not replay, still before ImGui::End.
+		void beginCapture(bool bRetainable, uint64_t contentGeneration);
+		void endCapture();
+
+		void invalidate() { m_bValid = false; }
+
+		static const Stats& getFrameStats();
+		static void resetFrameStats();
+
+		// Idle window no hover, no focus, no active item, no popup and no drag drop, widget content can't change by input.
+		static bool isCurrentWindowIdle();
+
+		// Build synthetic content browser in private imgui context without gpu, log cpu time of full build, clipped build and retained replay.
+		static void benchmark(uint32_t itemCount);
+
+	private:
+		struct Key
+		{
+			ImVec2 pos;
+			ImVec2 size;
+			ImVec2 scroll;
+			float fontSize;
+			uint64_t contentGeneration;
+
+			bool operator==(const Key& rhs) const;
+		};
+
+		struct RetainedCmd
+		{
+			ImVec4 clipRect;
+			ImTextureID textureId;
+			uint32_t vtxOffset;
+			uint32_t vtxCount;
+			uint32_t idxOffset;
+			uint32_t idxCount;
+		};
+
+		static Key buildKey(uint64_t contentGeneration);
+		bool captureDrawList(const ImDrawList* drawList, int cmdBegin, int idxBegin);
+		bool captureChildWindows(const ImGuiWindow* window);
+
+	private:
+		bool m_bValid = false;
+		Key m_key;
+		int m_captureFrame = 0;
+
+		// Key of last build frame, used to check layout stable.
+		Key m_lastBuildKey;
+		int m_lastBuildFrame = -1;
+
+		// Capture state between begin and end.
+		bool m_bCapturing = false;
+		Key m_pendingKey;
+		int m_cmdBegin = 0;
+		int m_idxBegin = 0;
+
+		// Content extent, restore to window cursor when replay, keep scroll range.
+		ImVec2 m_cursorMaxPos;
+		ImVec2 m_idealMaxPos;
+
+		std::vector<RetainedCmd> m_cmds;
+		std::vector<ImDrawVert> m_vertices;
+
+		// Index relative to command first vertex.
+		std::vector<ImDrawIdx> m_indices;
+	};
+}